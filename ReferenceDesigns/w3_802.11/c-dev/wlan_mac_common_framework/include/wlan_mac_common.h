@@ -42,16 +42,42 @@ struct station_info_t;
 //-----------------------------------------------
 // Level Print function defines
 //
-#define PRINT_LEVEL                                        PL_ERROR
-
+//     PRINT_LEVEL is a build-time threshold (it can be overridden with -DPRINT_LEVEL=<level>).
+//     Messages above the threshold are removed by the preprocessor, ie their arguments are
+//     not evaluated.  The severity must be one of the PL_* tokens below (not a variable).
+//
+//     See wlan_mac_dprint.h for wlan_dprintf(), which defers the output to the main loop.
+//
 #define PL_NONE                                            0
 #define PL_ERROR                                           1
 #define PL_WARNING                                         2
 #define PL_VERBOSE                                         3
 
+#ifndef PRINT_LEVEL
+#define PRINT_LEVEL                                        PL_ERROR
+#endif
+
+#if PRINT_LEVEL >= PL_ERROR
+#define WLAN_PRINT_EN_PL_ERROR(statement)                  statement
+#else
+#define WLAN_PRINT_EN_PL_ERROR(statement)
+#endif
+
+#if PRINT_LEVEL >= PL_WARNING
+#define WLAN_PRINT_EN_PL_WARNING(statement)                statement
+#else
+#define WLAN_PRINT_EN_PL_WARNING(statement)
+#endif
+
+#if PRINT_LEVEL >= PL_VERBOSE
+#define WLAN_PRINT_EN_PL_VERBOSE(statement)                statement
+#else
+#define WLAN_PRINT_EN_PL_VERBOSE(statement)
+#endif
+
 #define wlan_printf(severity, format, args...) \
     do { \
-        if (PRINT_LEVEL >= severity){ xil_printf(format, ##args); } \
+        WLAN_PRINT_EN_##severity(xil_printf(format, ##args);) \
     } while(0)
 
 
@@ -0,0 +1,78 @@
+/** @file wlan_mac_dprint.h
+ *  @brief Deferred Print
+ *
+ *  This contains code for deferring console output from time-critical code
+ *  to the main loop.
+ *
+ *  @copyright Copyright 2014-2017, Mango Communications. All rights reserved.
+ *          Distributed under the Mango Communications Reference Design License
+ *              See LICENSE.txt included in the design archive or
+ *              at http://mangocomm.com/802.11/license
+ *
+ *  This file is part of the Mango 802.11 Reference Design (https://mangocomm.com/802.11)
+ */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "wlan_mac_common.h"
+
+
+/*************************** Constant Definitions ****************************/
+#ifndef WLAN_MAC_DPRINT_H_
+#define WLAN_MAC_DPRINT_H_
+
+
+//-----------------------------------------------
+// Deferred print
+//
+//     wlan_dprintf() stores the format string and the arguments of a message as a
+//     record in a ring instead of writing the message to the UART.  The main loop
+//     prints one record per call of wlan_mac_dprint_poll().  If the ring is full, the
+//     message is dropped and counted.  The number of dropped messages is printed once
+//     the ring is empty.
+//
+//     Printing a record blocks on the UART for milliseconds, so CPU Low only calls
+//     wlan_mac_dprint_poll() in passes of its main loop that found no other work.
+//
+//     Like wlan_printf(), messages above PRINT_LEVEL are removed at compile time.
+//
+//     NOTE:  Messages followed by a call that does not return to the main loop (e.g.
+//         wlan_mac_low_send_exception()) must use xil_printf(), otherwise they are
+//         never printed.
+//
+//     NOTE:  The format string and any string (%s) arguments must remain valid until
+//         the message is printed (e.g. string literals).  Arguments are stored as u32,
+//         so a message can not have 64-bit arguments or more than DPRINT_MAX_ARGS
+//         arguments.
+//
+#define DPRINT_RING_LEN                                    32   // Must be a power of 2
+#define DPRINT_MAX_ARGS                                    10
+
+#define DPRINT_NUM_ARGS(args...)                           DPRINT_NUM_ARGS_(0, ##args, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DPRINT_NUM_ARGS_(a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, n, ...)    n
+
+#define wlan_dprintf(severity, format, args...) \
+    do { \
+        WLAN_PRINT_EN_##severity(wlan_mac_dprint_record(format, DPRINT_NUM_ARGS(args), ##args);) \
+    } while(0)
+
+
+/*********************** Global Structure Definitions ************************/
+
+typedef struct dprint_record_t{
+    const char*   format;                  ///< Format string (its address identifies the message)
+    u32           args[DPRINT_MAX_ARGS];
+} dprint_record_t;
+
+
+/*************************** Function Prototypes *****************************/
+
+void               wlan_mac_dprint_init();
+
+void               wlan_mac_dprint_record(const char* format, u32 num_args, ...);
+int                wlan_mac_dprint_poll();
+
+u32                wlan_mac_dprint_get_num_dropped();
+
+#endif /* WLAN_MAC_DPRINT_H_ */
@@ -4,6 +4,11 @@
  *  This contains code common to both CPU_LOW and CPU_HIGH that allows them
  *  to pass messages to one another through the mailbox.
  *
+ *  Messages are passed through a lock-free, single-producer / single-consumer
+ *  ring of u32 words in shared packet buffer memory (one ring per direction).
+ *  The mailbox only carries a one word doorbell that tells the other CPU
+ *  that its receive ring went from empty to non-empty.
+ *
  *  @copyright Copyright 2013-2017, Mango Communications. All rights reserved.
  *          Distributed under the Mango Communications Reference Design License
  *              See LICENSE.txt included in the design archive or
@@ -16,6 +21,8 @@
 
 #include "xil_types.h"
 #include "xmbox.h"
+#include "wlan_common_types.h"
+#include "wlan_mac_pkt_buf_util.h"
 
 //-----------------------------------------------
 // Hardware defines
@@ -67,6 +74,8 @@
 #define IPC_MBOX_LOW_RANDOM_SEED                           17
 #define IPC_MBOX_SET_RADIO_TX_POWER	   				       18
 
+#define IPC_MBOX_DOORBELL                                  0xFFF     ///< Mailbox doorbell (never in a ring)
+
 
 //-----------------------------------------------
 // Macros to Add / Remove delimiter to message ID
@@ -83,6 +92,17 @@
 #define IPC_MBOX_NO_MSG_AVAIL                             -2
 
 
+//-----------------------------------------------
+// IPC message rings
+//     - Each ring occupies one Tx packet buffer that is not used for packets
+//       (TX_PKT_BUF_IPC_RING_HIGH_TO_LOW / TX_PKT_BUF_IPC_RING_LOW_TO_HIGH)
+//     - The ring holds the same words that were written to the mailbox:  one
+//       header word (the first word of wlan_ipc_msg_t) followed by the payload
+//
+#define IPC_RING_MAGIC                                     0x49504352    // "IPCR"
+#define IPC_RING_NUM_WORDS                                 1016
+
+
 //-----------------------------------------------
 // IPC_MBOX_MEM_READ_WRITE arg0 defines
 //
@@ -118,6 +138,26 @@ typedef struct ipc_reg_read_write_t{
 } ipc_reg_read_write_t;
 
 
+//-----------------------------------------------
+// IPC message ring
+//     - head and the counters are only written by the producer, tail is only written
+//       by the consumer, so neither side needs a lock
+//     - One word is always left empty to tell a full ring from an empty one
+//
+typedef struct ipc_ring_t{
+    volatile u32       head;                       ///< Index of the next word the producer writes
+    volatile u32       tail;                       ///< Index of the next word the consumer reads
+    volatile u32       magic;                      ///< IPC_RING_MAGIC once the producer has initialized the ring
+    volatile u32       num_msgs;                   ///< Number of messages posted
+    volatile u32       num_doorbells;              ///< Number of doorbells sent
+    volatile u32       num_full;                   ///< Number of messages that had to wait for free space
+    u32                reserved[2];
+    volatile u32       data[IPC_RING_NUM_WORDS];
+} ipc_ring_t;
+
+ASSERT_TYPE_SIZE(ipc_ring_t, PKT_BUF_SIZE);
+
+
 /*************************** Function Prototypes *****************************/
 
 XMbox*        init_mailbox();
@@ -126,4 +166,9 @@ int           read_mailbox_msg(wlan_ipc_msg_t* msg);
 int           write_mailbox_msg(wlan_ipc_msg_t* msg);
 int           send_msg(u16 msg_id, u8 arg, u8 num_words, u32* payload);
 
+void          ipc_batch_start();
+void          ipc_batch_end();
+
+u32           ipc_rx_num_pending_words();
+
 #endif /* WLAN_MAC_MAILBOX_UTIL_H_ */
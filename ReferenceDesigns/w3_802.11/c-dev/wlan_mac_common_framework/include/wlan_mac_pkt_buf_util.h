@@ -39,7 +39,21 @@
 // Packet buffer defines
 //
 #define NUM_TX_PKT_BUFS                                    16
+
+// Number of Rx packet buffers
+//     - CPU Low hands the Rx packet buffers to CPU High in ring order (see
+//       wlan_mac_low_lock_empty_rx_pkt_buf())
+//     - Can be overridden at compile time (e.g. -DNUM_RX_PKT_BUFS=16).  The PHY
+//       and the packet buffer mutex support up to 16 Rx packet buffers; the Rx
+//       packet buffer BRAM must hold NUM_RX_PKT_BUFS * PKT_BUF_SIZE bytes
+//       (checked by the platform code)
+#ifndef NUM_RX_PKT_BUFS
 #define NUM_RX_PKT_BUFS                                    8
+#endif
+
+#if (NUM_RX_PKT_BUFS < 2) || (NUM_RX_PKT_BUFS > 16)
+#error "NUM_RX_PKT_BUFS must be between 2 and 16"
+#endif
 
 
 // Packet buffer size (in bytes)
@@ -65,6 +79,9 @@
 // Packet Buffers owned by CPU_LOW at boot
 #define TX_PKT_BUF_RTS                                     7
 #define TX_PKT_BUF_ACK_CTS                                 8
+// Packet Buffers used for the IPC message rings (never locked or transmitted)
+#define TX_PKT_BUF_IPC_RING_HIGH_TO_LOW                    14
+#define TX_PKT_BUF_IPC_RING_LOW_TO_HIGH                    15
 
 //#define TX_PKT_BUF_DTIM_MCAST							   0x80
 
@@ -212,6 +229,11 @@ typedef struct tx_frame_info_t{
     u16                      	length;                       ///< Number of bytes in MAC packet, including MAC header and FCS
     u16                      	reserved1;
     //----- 8-byte boundary ------
+    u32                      	trace_id;                     ///< Latency trace ID of the packet (0 if the packet is not traced)
+    u32                      	delay_ingress;                ///< Time in microseconds between MAC ingress and enqueue (traced packets only)
+    //----- 8-byte boundary ------
+    u32                      	delay_dequeue;                ///< Time in microseconds between enqueue and dequeue (traced packets only)
+    u32                      	reserved2;
 
     //
     // Place additional fields here.  Make sure the new fields keep the structure 8-byte aligned
@@ -225,7 +247,7 @@ typedef struct tx_frame_info_t{
 // Therefore, the code will check the size of the structure using a compile-time assertion.  This check
 // will need to be updated if fields are added to the structure
 //
-ASSERT_TYPE_SIZE(tx_frame_info_t, 56);
+ASSERT_TYPE_SIZE(tx_frame_info_t, 72);
 
 
 // Defines for power field in phy_tx_params_t in tx_params_t
@@ -0,0 +1,126 @@
+/** @file wlan_mac_prof.h
+ *  @brief Profiling Probes
+ *
+ *  This contains code for timing the hot paths of CPU High and CPU Low with
+ *  named probes.
+ *
+ *  @copyright Copyright 2014-2017, Mango Communications. All rights reserved.
+ *          Distributed under the Mango Communications Reference Design License
+ *              See LICENSE.txt included in the design archive or
+ *              at http://mangocomm.com/802.11/license
+ *
+ *  This file is part of the Mango 802.11 Reference Design (https://mangocomm.com/802.11)
+ */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+#if defined(__MICROBLAZE__)
+#include "wlan_platform_prof.h"
+#else
+#include <time.h>
+#endif
+
+
+/*************************** Constant Definitions ****************************/
+#ifndef WLAN_MAC_PROF_H_
+#define WLAN_MAC_PROF_H_
+
+
+//-----------------------------------------------
+// Profiling
+//
+//     A probe measures the time between WLAN_PROF_START() and WLAN_PROF_END() and
+//     adds it to the statistics of the probe: number of samples, min / max / total
+//     ticks and a histogram with log2 bins.  Each CPU has its own table of probes;
+//     probes that are not used by a CPU stay empty.
+//
+//     WLAN_PROF_ENABLE is a build-time switch (it can be overridden with
+//     -DWLAN_PROF_ENABLE=1).  If it is 0, the probe macros are empty and the table
+//     of probes is not compiled, ie profiling has no overhead.
+//
+//     On MicroBlaze, the timestamps come from the platform (see wlan_platform_prof.h).
+//     On other targets (e.g. a host build of the framework), they come from
+//     clock_gettime(CLOCK_MONOTONIC) with 1 tick per nanosecond.
+//
+#ifndef WLAN_PROF_ENABLE
+#define WLAN_PROF_ENABLE                                   0
+#endif
+
+// Probe IDs
+#define PROF_PROBE_FRAME_RECEIVE                           0    ///< CPU Low:   frame_receive() (Rx callback of the low application)
+#define PROF_PROBE_FRAME_TRANSMIT_GENERAL                  1    ///< CPU Low:   frame_transmit_general()
+#define PROF_PROBE_MPDU_TRANSMIT                           2    ///< CPU High:  wlan_mac_high_mpdu_transmit()
+#define PROF_PROBE_POLL_TX_QUEUES                          3    ///< CPU High:  poll_tx_queues()
+#define PROF_PROBE_ETH_RX                                  4    ///< CPU High:  wlan_process_eth_rx()
+#define PROF_PROBE_EVENT_LOG_GET_ADDR                      5    ///< CPU High:  event_log_get_next_empty_address()
+#define PROF_PROBE_SCHEDULE_HANDLER                        6    ///< CPU High:  schedule_handler()
+
+#define NUM_PROF_PROBES                                    7
+
+// Histogram
+//     Bin 0 counts samples of 0 ticks.  Bin N (N > 0) counts samples of [2^(N-1), 2^N)
+//     ticks.  The last bin also counts all longer samples.
+#define PROF_NUM_BINS                                      20
+
+// Timestamps
+#if defined(__MICROBLAZE__)
+#define PROF_TICKS_PER_USEC                                PLATFORM_PROF_TICKS_PER_USEC
+#define wlan_prof_timestamp()                              wlan_platform_prof_timestamp()
+#else
+#define PROF_TICKS_PER_USEC                                1000
+#define wlan_prof_timestamp()                              wlan_mac_prof_host_timestamp()
+#endif
+
+// Probe macros
+//     WLAN_PROF_START() declares the start timestamp of the probe, so it must be in the
+//     same scope as the matching WLAN_PROF_END().
+#if WLAN_PROF_ENABLE
+#define WLAN_PROF_START(probe)                             u32 prof_start_##probe = wlan_prof_timestamp()
+#define WLAN_PROF_END(probe)                               wlan_mac_prof_record((probe), (wlan_prof_timestamp() - prof_start_##probe))
+#else
+#define WLAN_PROF_START(probe)
+#define WLAN_PROF_END(probe)
+#endif
+
+
+/*********************** Global Structure Definitions ************************/
+
+//-----------------------------------------------
+// Probe statistics
+//
+//     NOTE:  CPU High reads the probes of CPU Low word by word, so the struct must only
+//         contain u32 fields.
+//
+typedef struct prof_probe_t{
+    u32       num_samples;
+    u32       min_ticks;                   ///< Shortest sample (0xFFFFFFFF if there are no samples)
+    u32       max_ticks;                   ///< Longest sample
+    u32       total_ticks_msb;             ///< Sum of all samples (64 bits)
+    u32       total_ticks_lsb;
+    u32       bins[PROF_NUM_BINS];         ///< Histogram (see PROF_NUM_BINS)
+} prof_probe_t;
+
+
+/*************************** Function Prototypes *****************************/
+
+void               wlan_mac_prof_init();
+void               wlan_mac_prof_reset();
+
+void               wlan_mac_prof_record(u32 probe_id, u32 ticks);
+
+int                wlan_mac_prof_get_probe(u32 probe_id, prof_probe_t* probe);
+prof_probe_t*      wlan_mac_prof_get_table();
+
+#if !defined(__MICROBLAZE__)
+static inline u32 wlan_mac_prof_host_timestamp(){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (u32)((((u64)ts.tv_sec) * 1000000000ULL) + ts.tv_nsec);
+}
+#endif
+
+#endif /* WLAN_MAC_PROF_H_ */
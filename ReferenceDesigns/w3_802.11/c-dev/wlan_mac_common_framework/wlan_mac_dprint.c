@@ -0,0 +1,171 @@
+/** @file wlan_mac_dprint.c
+ *  @brief Deferred Print
+ *
+ *  This contains code for deferring console output from time-critical code
+ *  to the main loop.
+ *
+ *  @copyright Copyright 2014-2017, Mango Communications. All rights reserved.
+ *          Distributed under the Mango Communications Reference Design License
+ *              See LICENSE.txt included in the design archive or
+ *              at http://mangocomm.com/802.11/license
+ *
+ *  This file is part of the Mango 802.11 Reference Design (https://mangocomm.com/802.11)
+ */
+
+/***************************** Include Files *********************************/
+
+#include "stdarg.h"
+#include "string.h"
+
+#include "xil_types.h"
+#include "xil_printf.h"
+#include "mb_interface.h"
+
+#include "wlan_mac_common.h"
+#include "wlan_mac_dprint.h"
+
+
+/*************************** Constant Definitions ****************************/
+
+#define DPRINT_NEXT(idx)                                   (((idx) + 1) & (DPRINT_RING_LEN - 1))
+
+
+/*************************** Variable Definitions ****************************/
+
+static dprint_record_t  dprint_ring[DPRINT_RING_LEN];
+
+static volatile u32     dprint_head;             ///< Index of the next empty record
+static volatile u32     dprint_tail;             ///< Index of the oldest record
+static volatile u32     dprint_num_dropped;      ///< Number of messages dropped because the ring was full
+static u32              dprint_num_dropped_printed;
+
+
+/******************************** Functions **********************************/
+
+/*****************************************************************************/
+/**
+ * Initialize the deferred print ring
+ *
+ * The ring is in the .bss section, which the C runtime zeroes at startup.  The
+ * indexes are still reset here so that the ring is empty whenever the
+ * framework is initialized, independent of how the CPU was started.
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_dprint_init(){
+    dprint_head                = 0;
+    dprint_tail                = 0;
+    dprint_num_dropped         = 0;
+    dprint_num_dropped_printed = 0;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Store a message in the deferred print ring
+ *
+ * This function does not block and can be called from interrupt context.  Use
+ * the wlan_dprintf() macro instead of calling this function directly.
+ *
+ * @param   format           - Format string of the message (see xil_printf())
+ * @param   num_args         - Number of arguments that follow
+ * @param   ...              - Arguments of the message
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_dprint_record(const char* format, u32 num_args, ...){
+    va_list           args;
+    dprint_record_t*  record;
+    u32               msr;
+    u32               i;
+
+    // The ring is shared between the main context and interrupt handlers
+    msr = mfmsr();
+    microblaze_disable_interrupts();
+
+    if (DPRINT_NEXT(dprint_head) == dprint_tail) {
+        dprint_num_dropped++;
+        mtmsr(msr);
+        return;
+    }
+
+    record         = &(dprint_ring[dprint_head]);
+    record->format = format;
+
+    va_start(args, num_args);
+    for (i = 0; (i < num_args) && (i < DPRINT_MAX_ARGS); i++) {
+        record->args[i] = va_arg(args, u32);
+    }
+    va_end(args);
+
+    dprint_head = DPRINT_NEXT(dprint_head);
+
+    mtmsr(msr);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Print the oldest message of the deferred print ring
+ *
+ * This function must only be called from the main loop.  It prints at most one
+ * message per call so that the main loop is not blocked by the UART for long.
+ *
+ * @param   None
+ *
+ * @return  int              - 1 if a message was printed
+ *                             0 if the ring is empty
+ *
+ *****************************************************************************/
+int wlan_mac_dprint_poll(){
+    dprint_record_t   record;
+    u32               num_dropped;
+    u8                ring_empty;
+    u32               msr;
+
+    if (dprint_tail == dprint_head) {
+        return 0;
+    }
+
+    msr = mfmsr();
+    microblaze_disable_interrupts();
+
+    memcpy(&record, &(dprint_ring[dprint_tail]), sizeof(dprint_record_t));
+
+    dprint_tail = DPRINT_NEXT(dprint_tail);
+    ring_empty  = (dprint_tail == dprint_head);
+    num_dropped = dprint_num_dropped;
+
+    mtmsr(msr);
+
+    xil_printf(record.format, record.args[0], record.args[1], record.args[2], record.args[3], record.args[4],
+                              record.args[5], record.args[6], record.args[7], record.args[8], record.args[9]);
+
+    if (ring_empty && (num_dropped != dprint_num_dropped_printed)) {
+        xil_printf("WARNING: %d messages dropped (deferred print ring full)\n", (num_dropped - dprint_num_dropped_printed));
+        dprint_num_dropped_printed = num_dropped;
+    }
+
+    return 1;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Get the number of messages dropped because the deferred print ring was full
+ *
+ * @param   None
+ *
+ * @return  u32              - Number of dropped messages since boot
+ *
+ *****************************************************************************/
+u32 wlan_mac_dprint_get_num_dropped(){
+    return dprint_num_dropped;
+}
@@ -4,6 +4,13 @@
  *  This contains code common to both CPU_LOW and CPU_HIGH that allows them
  *  to pass messages to one another.
  *
+ *  Each CPU writes messages into its own ipc_ring_t (single producer) and
+ *  reads messages from the ring of the other CPU (single consumer).  The
+ *  mailbox FIFO only carries a doorbell word when a ring goes from empty to
+ *  non-empty, which raises the mailbox interrupt on CPU_HIGH.  Messages
+ *  written between ipc_batch_start() and ipc_batch_end() are published to the
+ *  other CPU together and share a single doorbell.
+ *
  *  @copyright Copyright 2013-2017, Mango Communications. All rights reserved.
  *          Distributed under the Mango Communications Reference Design License
  *              See LICENSE.txt included in the design archive or
@@ -24,6 +31,7 @@
 #include "wlan_platform_common.h"
 #include "wlan_mac_common.h"
 #include "wlan_mac_mailbox_util.h"
+#include "wlan_mac_pkt_buf_util.h"
 #include "wlan_cpu_id.h"
 
 /*********************** Global Variable Definitions *************************/
@@ -35,12 +43,45 @@ static XMbox ipc_mailbox;
 
 static platform_common_dev_info_t platform_common_dev_info;
 
+static ipc_ring_t*  ipc_tx_ring;                         // Ring written by this CPU
+static ipc_ring_t*  ipc_rx_ring;                         // Ring read by this CPU
+
+static u32          ipc_batch_depth;                     // Nesting depth of ipc_batch_start()
+static u32          ipc_batch_head;                      // Unpublished head of ipc_tx_ring during a batch
+
 
 /*************************** Functions Prototypes ****************************/
 
+static void _ipc_ring_publish(u32 new_head);
+
 
 /******************************** Functions **********************************/
 
+// Order all previous memory accesses before all following memory accesses.  The ring
+// indices are the only synchronization between the CPUs, so the ring data must be
+// written / read before the index that hands it over to the other CPU.
+static inline void _ipc_ring_barrier(){
+#ifdef __MICROBLAZE__
+    __asm__ volatile ("mbar 1" ::: "memory");
+#else
+    __asm__ volatile ("" ::: "memory");
+#endif
+}
+
+// Number of words in the ring between tail and head
+static inline u32 _ipc_ring_used(u32 head, u32 tail){
+    return (head >= tail) ? (head - tail) : (head + IPC_RING_NUM_WORDS - tail);
+}
+
+// Number of words that can be written to the ring (one word is always left empty)
+static inline u32 _ipc_ring_free(u32 head, u32 tail){
+    return (IPC_RING_NUM_WORDS - 1) - _ipc_ring_used(head, tail);
+}
+
+static inline u32 _ipc_ring_next(u32 idx){
+    return ((idx + 1) == IPC_RING_NUM_WORDS) ? 0 : (idx + 1);
+}
+
 
 /*****************************************************************************/
 /**
@@ -62,6 +103,39 @@ XMbox* init_mailbox() {
     mbox_config_ptr = XMbox_LookupConfig(platform_common_dev_info.mailbox_dev_id);
     XMbox_CfgInitialize(&ipc_mailbox, mbox_config_ptr, mbox_config_ptr->BaseAddress);
 
+    // Locate the IPC rings
+#if WLAN_COMPILE_FOR_CPU_HIGH
+    ipc_tx_ring = (ipc_ring_t*)CALC_PKT_BUF_ADDR(platform_common_dev_info.tx_pkt_buf_baseaddr, TX_PKT_BUF_IPC_RING_HIGH_TO_LOW);
+    ipc_rx_ring = (ipc_ring_t*)CALC_PKT_BUF_ADDR(platform_common_dev_info.tx_pkt_buf_baseaddr, TX_PKT_BUF_IPC_RING_LOW_TO_HIGH);
+#else
+    ipc_tx_ring = (ipc_ring_t*)CALC_PKT_BUF_ADDR(platform_common_dev_info.tx_pkt_buf_baseaddr, TX_PKT_BUF_IPC_RING_LOW_TO_HIGH);
+    ipc_rx_ring = (ipc_ring_t*)CALC_PKT_BUF_ADDR(platform_common_dev_info.tx_pkt_buf_baseaddr, TX_PKT_BUF_IPC_RING_HIGH_TO_LOW);
+#endif
+
+    ipc_batch_depth = 0;
+
+    // Initialize the ring this CPU writes
+    //     - The ring is only reset if it has not been initialized.  If only one CPU is
+    //       rebooted, messages already in the ring are kept, just like the messages in
+    //       the mailbox FIFO.
+    //     - The receive ring is initialized by the other CPU.  Until then, its magic
+    //       number is invalid and read_mailbox_msg() treats it as empty.
+    if ((ipc_tx_ring->magic != IPC_RING_MAGIC) ||
+        (ipc_tx_ring->head >= IPC_RING_NUM_WORDS) ||
+        (ipc_tx_ring->tail >= IPC_RING_NUM_WORDS)) {
+        ipc_tx_ring->magic         = 0;
+        _ipc_ring_barrier();
+
+        ipc_tx_ring->head          = 0;
+        ipc_tx_ring->tail          = 0;
+        ipc_tx_ring->num_msgs      = 0;
+        ipc_tx_ring->num_doorbells = 0;
+        ipc_tx_ring->num_full      = 0;
+        _ipc_ring_barrier();
+
+        ipc_tx_ring->magic         = IPC_RING_MAGIC;
+    }
+
     return &ipc_mailbox;
 }
 
@@ -74,9 +148,13 @@ XMbox* init_mailbox() {
 /**
  * Write IPC message
  *
- * This function will write an IPC message to the mailbox for the other CPU.
+ * This function will write an IPC message to the IPC ring for the other CPU.
  * This function is blocking and each message write is atomic in the sense that
- * it will not be interrupted.
+ * it will not be interrupted.  If the ring is full, this function waits for the
+ * other CPU to read messages from the ring.
+ *
+ * Outside of a batch, the message is published to the other CPU immediately.
+ * Inside of a batch (see ipc_batch_start()), it is published by ipc_batch_end().
  *
  * @param   msg              - Pointer to IPC message structure to write
  *
@@ -95,16 +173,43 @@ int write_mailbox_msg(wlan_ipc_msg_t* msg) {
         return IPC_MBOX_INVALID_MSG;
     }
 
+    u32                   num_words = 1 + (msg->num_payload_words);
+    u32                   head;
+    u32                   i;
+
 #if WLAN_COMPILE_FOR_CPU_HIGH
     interrupt_state_t     prev_interrupt_state;
     prev_interrupt_state = wlan_mac_high_interrupt_stop();
 #endif
+
+    head = (ipc_batch_depth > 0) ? ipc_batch_head : ipc_tx_ring->head;
+
+    // Wait for space in the ring
+    //     - Messages of an open batch are published first so the other CPU can read them
+    if (_ipc_ring_free(head, ipc_tx_ring->tail) < num_words) {
+        ipc_tx_ring->num_full++;
+
+        _ipc_ring_publish(head);
+
+        while (_ipc_ring_free(head, ipc_tx_ring->tail) < num_words) {}
+    }
+
     // Write msg header (first 32b word)
-    XMbox_WriteBlocking(&ipc_mailbox, (u32*)msg, 4);
+    ipc_tx_ring->data[head] = *((u32*)msg);
+    head = _ipc_ring_next(head);
 
     // Write msg payload
-    if ((msg->num_payload_words) > 0) {
-        XMbox_WriteBlocking(&ipc_mailbox, (u32*)(msg->payload_ptr), (u32)(4 * (msg->num_payload_words)));
+    for (i = 0; i < (msg->num_payload_words); i++) {
+        ipc_tx_ring->data[head] = msg->payload_ptr[i];
+        head = _ipc_ring_next(head);
+    }
+
+    ipc_tx_ring->num_msgs++;
+
+    if (ipc_batch_depth > 0) {
+        ipc_batch_head = head;
+    } else {
+        _ipc_ring_publish(head);
     }
 
 #if WLAN_COMPILE_FOR_CPU_HIGH
@@ -115,6 +220,93 @@ int write_mailbox_msg(wlan_ipc_msg_t* msg) {
 
 
 
+/*****************************************************************************/
+/**
+ * Publish IPC ring messages
+ *
+ * Hand the words up to new_head over to the other CPU.  If the other CPU had
+ * already read all of the previous messages, a doorbell is written to the
+ * mailbox.  Otherwise, the other CPU is still reading the ring and will find
+ * the new messages without a doorbell.
+ *
+ * @param   new_head         - New head index of the ring
+ *****************************************************************************/
+static void _ipc_ring_publish(u32 new_head) {
+    wlan_ipc_msg_t        doorbell;
+    u32                   old_head = ipc_tx_ring->head;
+    u32                   bytes_sent;
+
+    if (new_head == old_head) {
+        return;
+    }
+
+    // Make the message words visible before the head index
+    _ipc_ring_barrier();
+
+    ipc_tx_ring->head = new_head;
+
+    // Read the tail index after the head is visible to the other CPU
+    _ipc_ring_barrier();
+
+    if (ipc_tx_ring->tail == old_head) {
+        doorbell.msg_id            = IPC_MBOX_MSG_ID(IPC_MBOX_DOORBELL);
+        doorbell.num_payload_words = 0;
+        doorbell.arg0              = 0;
+
+        // If the mailbox FIFO is full, there are doorbells the other CPU has not read
+        if (XMbox_Write(&ipc_mailbox, (u32*)&doorbell, 4, &bytes_sent) == XST_SUCCESS) {
+            ipc_tx_ring->num_doorbells++;
+        }
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Start / end IPC message batch
+ *
+ * Messages written between ipc_batch_start() and ipc_batch_end() are published
+ * to the other CPU together by ipc_batch_end() with at most one doorbell.
+ * Batches can be nested; the messages are published by the outermost
+ * ipc_batch_end().  A batch is also published if the ring fills up.
+ *****************************************************************************/
+void ipc_batch_start() {
+#if WLAN_COMPILE_FOR_CPU_HIGH
+    interrupt_state_t     prev_interrupt_state;
+    prev_interrupt_state = wlan_mac_high_interrupt_stop();
+#endif
+
+    if ((ipc_batch_depth++) == 0) {
+        ipc_batch_head = ipc_tx_ring->head;
+    }
+
+#if WLAN_COMPILE_FOR_CPU_HIGH
+    wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+#endif
+}
+
+
+
+void ipc_batch_end() {
+#if WLAN_COMPILE_FOR_CPU_HIGH
+    interrupt_state_t     prev_interrupt_state;
+    prev_interrupt_state = wlan_mac_high_interrupt_stop();
+#endif
+
+    if (ipc_batch_depth > 0) {
+        if ((--ipc_batch_depth) == 0) {
+            _ipc_ring_publish(ipc_batch_head);
+        }
+    }
+
+#if WLAN_COMPILE_FOR_CPU_HIGH
+    wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+#endif
+}
+
+
+
 /*****************************************************************************/
 /**
  * Send IPC message
@@ -150,8 +342,9 @@ int send_msg(u16 msg_id, u8 arg, u8 num_words, u32* payload) {
 /**
  * Read IPC message
  *
- * This function will read an IPC message from the mailbox from the other CPU.
- * This function is blocking and will block until entire message is read.
+ * This function will read an IPC message from the IPC ring of the other CPU.
+ * Any doorbells in the mailbox are discarded first; they only signal that
+ * there are messages in the ring.
  *
  * In the current 802.11 framework, mailbox messages are only read in polling
  * mode on a single threaded CPU or in an interrupt service routine.  In both
@@ -167,46 +360,113 @@ int send_msg(u16 msg_id, u8 arg, u8 num_words, u32* payload) {
  *                                 IPC_MBOX_INVALID_MSG  - Message invalid
  *****************************************************************************/
 int read_mailbox_msg(wlan_ipc_msg_t* msg) {
+    wlan_ipc_msg_t doorbell;
     u32 bytes_read;
+    u32 head;
+    u32 tail;
     u32 i;
-    u32 trash_bin;
     int status;
 
+    // Discard doorbells
+    //     - Reading the mailbox clears the mailbox interrupt condition on CPU_HIGH
+    while (!XMbox_IsEmpty(&ipc_mailbox)) {
+        status = XMbox_Read(&ipc_mailbox, (u32*)&doorbell, 4, &bytes_read);
+
+        if ((status != XST_SUCCESS) || (bytes_read != 4)) {
+            break;
+        }
+
+        if (doorbell.msg_id != IPC_MBOX_MSG_ID(IPC_MBOX_DOORBELL)) {
+            // Flush the mailbox to hopefully get back to a known state
+            XMbox_Flush(&ipc_mailbox);
+            break;
+        }
+    }
+
     // Check if there is a message to read
-    if (XMbox_IsEmpty(&ipc_mailbox)) {
-        return IPC_MBOX_INVALID_MSG;
+    if (ipc_rx_ring->magic != IPC_RING_MAGIC) {
+        return IPC_MBOX_NO_MSG_AVAIL;
     }
 
-    // Attempt to read one 32b word from the mailbox into the user-supplied msg
-    status = XMbox_Read(&ipc_mailbox, (u32*)msg, 4, &bytes_read);
+    head = ipc_rx_ring->head;
+    tail = ipc_rx_ring->tail;
 
-    if ((status != XST_SUCCESS) || (bytes_read != 4)) {
+    if ((head == tail) || (head >= IPC_RING_NUM_WORDS) || (tail >= IPC_RING_NUM_WORDS)) {
         return IPC_MBOX_NO_MSG_AVAIL;
     }
 
+    // Read the message words after the head index
+    _ipc_ring_barrier();
+
+    // Read msg header (first 32b word) into the user-supplied msg
+    *((u32*)msg) = ipc_rx_ring->data[tail];
+    tail         = _ipc_ring_next(tail);
+
     // Check if the received word is a valid msg
-    if (((msg->msg_id) & IPC_MBOX_MSG_ID_DELIM) != IPC_MBOX_MSG_ID_DELIM) {
-        // Flush the mailbox to hopefully get back to a known state
-        XMbox_Flush(&ipc_mailbox);
+    //     - If the header or the message length is invalid, skip everything in the
+    //       ring to hopefully get back to a known state
+    if ((((msg->msg_id) & IPC_MBOX_MSG_ID_DELIM) != IPC_MBOX_MSG_ID_DELIM) ||
+        ((msg->num_payload_words) > _ipc_ring_used(head, tail))) {
+        _ipc_ring_barrier();
+        ipc_rx_ring->tail = head;
         return IPC_MBOX_INVALID_MSG;
     }
 
     // Check that msg isn't too long
     if ((msg->num_payload_words) > MAILBOX_MSG_MAX_NUM_WORDS) {
-        for (i = 0; i < (msg->num_payload_words); i++) {
-            // Read out message into trash since there is not enough space available to hold it
-            XMbox_ReadBlocking(&ipc_mailbox, &trash_bin, 4);
+        // Skip the message since there is not enough space available to hold it
+        tail += (msg->num_payload_words);
+
+        if (tail >= IPC_RING_NUM_WORDS) {
+            tail -= IPC_RING_NUM_WORDS;
         }
 
+        _ipc_ring_barrier();
+        ipc_rx_ring->tail = tail;
         return IPC_MBOX_INVALID_MSG;
     }
 
     // Read message payload
-    if ((msg->num_payload_words) > 0) {
-        XMbox_ReadBlocking(&ipc_mailbox, (u32*)(msg->payload_ptr), 4 * (msg->num_payload_words));
+    for (i = 0; i < (msg->num_payload_words); i++) {
+        msg->payload_ptr[i] = ipc_rx_ring->data[tail];
+        tail                = _ipc_ring_next(tail);
     }
 
+    // Release the message words to the other CPU
+    _ipc_ring_barrier();
+    ipc_rx_ring->tail = tail;
+
     return IPC_MBOX_SUCCESS;
 }
 
 
+
+/*****************************************************************************/
+/**
+ * Get number of pending IPC words
+ *
+ * Returns the number of words the other CPU has published to the IPC ring that
+ * have not been read yet.  This allows the reader to prepare for a batch of
+ * messages (e.g. reserve log space) before it processes them.
+ *
+ * @return  u32              - Number of unread words in the ring
+ *****************************************************************************/
+u32 ipc_rx_num_pending_words() {
+    u32 head;
+    u32 tail;
+
+    if (ipc_rx_ring->magic != IPC_RING_MAGIC) {
+        return 0;
+    }
+
+    head = ipc_rx_ring->head;
+    tail = ipc_rx_ring->tail;
+
+    if ((head >= IPC_RING_NUM_WORDS) || (tail >= IPC_RING_NUM_WORDS)) {
+        return 0;
+    }
+
+    return _ipc_ring_used(head, tail);
+}
+
+
@@ -0,0 +1,203 @@
+/** @file wlan_mac_prof.c
+ *  @brief Profiling Probes
+ *
+ *  This contains code for timing the hot paths of CPU High and CPU Low with
+ *  named probes.
+ *
+ *  @copyright Copyright 2014-2017, Mango Communications. All rights reserved.
+ *          Distributed under the Mango Communications Reference Design License
+ *              See LICENSE.txt included in the design archive or
+ *              at http://mangocomm.com/802.11/license
+ *
+ *  This file is part of the Mango 802.11 Reference Design (https://mangocomm.com/802.11)
+ */
+
+/***************************** Include Files *********************************/
+
+#include "string.h"
+
+#include "xil_types.h"
+
+#if defined(__MICROBLAZE__)
+#include "mb_interface.h"
+#endif
+
+#include "wlan_mac_prof.h"
+
+
+/*************************** Variable Definitions ****************************/
+
+#if WLAN_PROF_ENABLE
+static prof_probe_t     prof_probes[NUM_PROF_PROBES];
+#endif
+
+
+/******************************** Functions **********************************/
+
+/*****************************************************************************/
+/**
+ * Initialize the profiling probes
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_prof_init(){
+    wlan_mac_prof_reset();
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Reset the statistics of all probes
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_prof_reset(){
+#if WLAN_PROF_ENABLE
+    u32               probe_id;
+#if defined(__MICROBLAZE__)
+    u32               msr;
+
+    msr = mfmsr();
+    microblaze_disable_interrupts();
+#endif
+
+    bzero(prof_probes, sizeof(prof_probes));
+
+    for (probe_id = 0; probe_id < NUM_PROF_PROBES; probe_id++) {
+        prof_probes[probe_id].min_ticks = 0xFFFFFFFF;
+    }
+
+#if defined(__MICROBLAZE__)
+    mtmsr(msr);
+#endif
+#endif
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Add a sample to a probe
+ *
+ * This function can be called from interrupt context.  Use the WLAN_PROF_START()
+ * and WLAN_PROF_END() macros instead of calling this function directly.
+ *
+ * @param   probe_id         - Probe ID (PROF_PROBE_*)
+ * @param   ticks            - Duration of the sample
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_prof_record(u32 probe_id, u32 ticks){
+#if WLAN_PROF_ENABLE
+    prof_probe_t*     probe;
+    u32               bin;
+    u32               total_lsb;
+#if defined(__MICROBLAZE__)
+    u32               msr;
+#endif
+
+    if (probe_id >= NUM_PROF_PROBES) {
+        return;
+    }
+
+    probe = &(prof_probes[probe_id]);
+
+    // Bin N holds [2^(N-1), 2^N) ticks
+    bin = (ticks == 0) ? 0 : (32 - __builtin_clz(ticks));
+
+    if (bin >= PROF_NUM_BINS) {
+        bin = PROF_NUM_BINS - 1;
+    }
+
+    // Probes in interrupt handlers can update the same probe
+#if defined(__MICROBLAZE__)
+    msr = mfmsr();
+    microblaze_disable_interrupts();
+#endif
+
+    probe->num_samples++;
+    probe->bins[bin]++;
+
+    if (ticks < probe->min_ticks) { probe->min_ticks = ticks; }
+    if (ticks > probe->max_ticks) { probe->max_ticks = ticks; }
+
+    total_lsb              = probe->total_ticks_lsb + ticks;
+    probe->total_ticks_msb += (total_lsb < ticks);
+    probe->total_ticks_lsb = total_lsb;
+
+#if defined(__MICROBLAZE__)
+    mtmsr(msr);
+#endif
+#endif
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Get a copy of the statistics of a probe
+ *
+ * @param   probe_id         - Probe ID (PROF_PROBE_*)
+ * @param   probe            - Pointer to the statistics to fill in
+ *
+ * @return  int              - Status:  0 = Success; -1 = Failure (invalid ID or
+ *                             profiling is not compiled)
+ *
+ *****************************************************************************/
+int wlan_mac_prof_get_probe(u32 probe_id, prof_probe_t* probe){
+#if WLAN_PROF_ENABLE
+#if defined(__MICROBLAZE__)
+    u32               msr;
+#endif
+
+    if (probe_id >= NUM_PROF_PROBES) {
+        return -1;
+    }
+
+#if defined(__MICROBLAZE__)
+    msr = mfmsr();
+    microblaze_disable_interrupts();
+#endif
+
+    memcpy(probe, &(prof_probes[probe_id]), sizeof(prof_probe_t));
+
+#if defined(__MICROBLAZE__)
+    mtmsr(msr);
+#endif
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Get the table of probes
+ *
+ * CPU Low passes the address of its table to CPU High (in the CPU status
+ * message), so that CPU High can read the probes of CPU Low.
+ *
+ * @param   None
+ *
+ * @return  prof_probe_t*    - Pointer to NUM_PROF_PROBES probes (NULL if profiling
+ *                             is not compiled)
+ *
+ *****************************************************************************/
+prof_probe_t* wlan_mac_prof_get_table(){
+#if WLAN_PROF_ENABLE
+    return prof_probes;
+#else
+    return NULL;
+#endif
+}
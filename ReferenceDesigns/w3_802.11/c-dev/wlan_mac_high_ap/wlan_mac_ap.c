@@ -23,6 +23,9 @@
 #include "wlan_platform_high.h"
 
 #include "wlan_mac_high.h"
+#include "wlan_mac_cdma.h"
+#include "wlan_mac_dprint.h"
+#include "wlan_mac_prof.h"
 #include "wlan_mac_ap.h"
 #include "wlan_mac_addr_filter.h"
 #include "wlan_mac_ltg.h"
@@ -307,6 +310,12 @@ int main(){
 		//     scheduled events, user interaction, etc) are handled via interrupt service routines
 		transport_poll(WLAN_EXP_ETH);
 #endif
+
+		// Start queued CDMA jobs and call their main context callbacks
+		wlan_mac_cdma_poll();
+
+		// Print deferred messages
+		wlan_mac_dprint_poll();
 	}
 
 	// Unreachable, but non-void return keeps the compiler happy
@@ -681,6 +690,8 @@ void poll_tx_queues(){
 	// Don't dequeue anything if the active BSS is NULL
 	if( active_network_info == NULL ) return;
 
+	WLAN_PROF_START(PROF_PROBE_POLL_TX_QUEUES);
+
 	// Stop interrupts for all processing below - this avoids many possible race conditions,
 	//  like new packets being enqueued or stations joining/leaving the BSS
 	curr_interrupt_state = wlan_mac_high_interrupt_stop();
@@ -801,6 +812,8 @@ void poll_tx_queues(){
 	}
 
 	wlan_mac_high_interrupt_restore_state(curr_interrupt_state);
+
+	WLAN_PROF_END(PROF_PROBE_POLL_TX_QUEUES);
 }
 
 
@@ -929,9 +942,10 @@ void ltg_event(u32 id, void* callback_arg){
 		do{
 			continue_loop = 0;
 
-			if(queue_num_queued(queue_sel) < max_queue_size){
+			if(queue_admit(queue_sel, max_queue_size)){
 				// Checkout 1 element from the queue;
-				curr_tx_queue_element = queue_checkout();
+				//     NOTE:  The LTG frame is at least as long as its ltg_packet_id_t
+				curr_tx_queue_element = queue_checkout_len(max(payload_length, sizeof(ltg_packet_id_t)) + sizeof(mac_header_80211) + WLAN_PHY_FCS_NBYTES);
 				if(curr_tx_queue_element != NULL){
 					// Create LTG packet
 					curr_tx_queue_buffer = ((tx_queue_buffer_t*)(curr_tx_queue_element->data));
@@ -947,6 +961,11 @@ void ltg_event(u32 id, void* callback_arg){
 					curr_tx_queue_buffer->length = payload_length;
 					curr_tx_queue_buffer->station_info = station_info;
 
+#if WLAN_SW_CONFIG_ENABLE_LOGGING
+					// Start the latency trace of the packet (if enabled)
+					wlan_exp_log_start_tx_trace(curr_tx_queue_buffer);
+#endif //WLAN_SW_CONFIG_ENABLE_LOGGING
+
 					// Submit the new packet to the appropriate queue
 					enqueue_after_tail(queue_sel, curr_tx_queue_element);
 
@@ -1007,7 +1026,7 @@ int ethernet_receive(dl_entry* curr_tx_queue_element, u8* eth_dest, u8* eth_src,
 	// Determine how to send the packet
 	if( wlan_addr_mcast(eth_dest) ) {
 		// Send the multicast packet
-		if(queue_num_queued(MCAST_QID) < max_queue_size){
+		if(queue_admit(MCAST_QID, max_queue_size)){
 
 			// Send the pre-encapsulated Ethernet frame over the wireless interface
 			//     NOTE:  The queue element has already been provided, so we do not need to check if it is NULL
@@ -1047,7 +1066,7 @@ int ethernet_receive(dl_entry* curr_tx_queue_element, u8* eth_dest, u8* eth_src,
 			station_info = (station_info_t*)(entry->data);
 
 			// Send the unicast packet
-			if(queue_num_queued(STATION_ID_TO_QUEUE_ID(entry->id)) < max_queue_size){
+			if(queue_admit(STATION_ID_TO_QUEUE_ID(entry->id), max_queue_size)){
 
 				// Send the pre-encapsulated Ethernet frame over the wireless interface
 				//     NOTE:  The queue element has already been provided, so we do not need to check if it is NULL
@@ -1290,7 +1309,7 @@ u32 mpdu_rx_process(void* pkt_buf_addr, station_info_t* station_info, rx_common_
 							// Check if this is a multicast packet
 							if(wlan_addr_mcast(rx_80211_header->address_3)){
 								// Send the data packet over the wireless
-								curr_tx_queue_element = queue_checkout();
+								curr_tx_queue_element = queue_checkout_len(length);
 
 								if(curr_tx_queue_element != NULL){
 									curr_tx_queue_buffer = (tx_queue_buffer_t*)(curr_tx_queue_element->data);
@@ -1328,7 +1347,7 @@ u32 mpdu_rx_process(void* pkt_buf_addr, station_info_t* station_info, rx_common_
 									associated_station = (station_info_t*)(associated_station_entry->data);
 
 									// Send the data packet over the wireless to our station
-									curr_tx_queue_element = queue_checkout();
+									curr_tx_queue_element = queue_checkout_len(length);
 
 									if(curr_tx_queue_element != NULL){
 										curr_tx_queue_buffer = (tx_queue_buffer_t*)(curr_tx_queue_element->data);
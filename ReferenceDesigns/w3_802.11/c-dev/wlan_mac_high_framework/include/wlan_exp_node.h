@@ -63,6 +63,10 @@
 #define CMDID_NODE_RANDOM_SEED                             0x001017
 #define CMDID_NODE_WLAN_MAC_ADDR                           0x001018
 #define CMDID_NODE_LOW_PARAM                               0x001020
+#define CMDID_NODE_GET_MEM_POOL_INFO                       0x001030
+#define CMDID_NODE_PROFILE                                 0x001031
+#define CMDID_NODE_QUEUE_STATS                             0x001032
+#define CMDID_NODE_QUEUE_AQM                               0x001033
 
 #define CMD_PARAM_WRITE_VAL                                0x00000000
 #define CMD_PARAM_READ_VAL                                 0x00000001
@@ -111,6 +115,18 @@
 #define CMD_PARAM_RANDOM_SEED_VALID                        0x00000001
 #define CMD_PARAM_RANDOM_SEED_RSVD                         0xFFFFFFFF
 
+#define CMD_PARAM_NODE_PROFILE_RESET                       0x00000002
+
+#define CMD_PARAM_NODE_PROFILE_CPU_HIGH                    0x00000000
+#define CMD_PARAM_NODE_PROFILE_CPU_LOW                     0x00000001
+
+#define CMD_PARAM_NODE_QUEUE_STATS_RESET                   0x00000002
+
+#define CMD_PARAM_NODE_QUEUE_STATS_QUEUE                   0x00000000
+#define CMD_PARAM_NODE_QUEUE_STATS_STATION                 0x00000001
+
+#define CMD_PARAM_NODE_QUEUE_AQM_RESET_COUNTS              0x00000002
+
 
 //-----------------------------------------------
 // LTG Commands
@@ -149,21 +165,30 @@
 #define CMD_PARAM_LOG_CONFIG_FLAG_PAYLOADS                 0x00000004
 #define CMD_PARAM_LOG_CONFIG_FLAG_TXRX_MPDU                0x00000008
 #define CMD_PARAM_LOG_CONFIG_FLAG_TXRX_CTRL                0x00000010
+#define CMD_PARAM_LOG_CONFIG_FLAG_TXRX_TRACE               0x00000020
 
 
 //-----------------------------------------------
 // Counts Commands
 //
 #define CMDID_COUNTS_GET_TXRX                              0x004001
+#define CMDID_COUNTS_GET_TXRX_DELTA                        0x004002
+#define CMDID_COUNTS_GET_RX_PKT_BUF                        0x004003
 
 #define CMD_PARAM_COUNTS_CONFIG_FLAG_PROMISC               0x00000001
 #define CMD_PARAM_COUNTS_RETURN_ZEROED_IF_NONE             0x80000000
 
+#define CMD_PARAM_COUNTS_DELTA_GEN_ALL                     0x00000000
+
+#define CMD_PARAM_COUNTS_DELTA_FLAG_DATA                   0x01
+#define CMD_PARAM_COUNTS_DELTA_FLAG_MGMT                   0x02
+
 
 //-----------------------------------------------
 // Queue Commands
 //
 #define CMDID_QUEUE_TX_DATA_PURGE_ALL                      0x005000
+#define CMDID_QUEUE_GET_BUFFER_INFO                        0x005001
 
 
 //-----------------------------------------------
@@ -290,7 +315,7 @@ typedef struct wlan_exp_node_info{
     //
     // ADD NEW TAG PARAMETERS HERE
     //
-    //     NOTE:  The #defines above, both the field name and the field length, must be adjusted in order
+    //     NOTE:  The #defines above, both the field name and the field length, must be adjusted in order
     //         for the new Tag Parameter to be populated.    //
     //
 
@@ -38,6 +38,17 @@
 #define CMDID_TRANSPORT_PAYLOAD_SIZE_TEST                  0x002
 #define CMDID_TRANSPORT_NODE_GROUP_ID_ADD                  0x100
 #define CMDID_TRANSPORT_NODE_GROUP_ID_CLEAR                0x101
+#define CMDID_TRANSPORT_BATCH                              0x200
+
+// Batch command
+//     NOTE:  A batch command carries a number of complete command records (cmd_resp_hdr + args)
+//         that are processed sequentially by the node.  The response carries the matching number
+//         of response records.  Processing stops before a command whose largest response does not
+//         fit in the space left in the response; the host must resend any commands without a
+//         response.  Commands that are not listed in batch_cmd_max_resp_len() (wlan_exp_node.c)
+//         respond with at most CMD_PARAM_TRANSPORT_BATCH_DEFAULT_RESP_WORDS words.
+//
+#define CMD_PARAM_TRANSPORT_BATCH_DEFAULT_RESP_WORDS       32
 
 
 // ****************************************************************************
@@ -0,0 +1,79 @@
+/** @file wlan_mac_cdma.h
+ *  @brief Central DMA Job Queue
+ *
+ *  This contains code for the queue of memory copies that CPU High passes to
+ *  the central DMA (CDMA) core.
+ *
+ *  @copyright Copyright 2014-2017, Mango Communications. All rights reserved.
+ *          Distributed under the Mango Communications Reference Design License
+ *              See LICENSE.txt included in the design archive or
+ *              at http://mangocomm.com/802.11/license
+ *
+ *  This file is part of the Mango 802.11 Reference Design (https://mangocomm.com/802.11)
+ */
+
+/***************************** Include Files *********************************/
+
+#include "wlan_mac_high_sw_config.h"
+#include "xil_types.h"
+#include "xintc.h"
+#include "wlan_common_types.h"
+
+
+/*************************** Constant Definitions ****************************/
+#ifndef WLAN_MAC_CDMA_H_
+#define WLAN_MAC_CDMA_H_
+
+
+//-----------------------------------------------
+// CDMA job queue
+//
+//     Callers submit copies (dest, src, size, callback) to the queue and continue with
+//     other work while the CDMA core executes them in order.  The CDMA core is used in
+//     simple mode, so the queue starts the next job whenever the previous one has
+//     finished.  The queue advances:
+//         - When a job is submitted or waited on
+//         - In the CDMA interrupt (if the platform connects the CDMA interrupt)
+//         - In wlan_mac_cdma_poll() (called from the main loop of each application)
+//
+//     NOTE:  The number of jobs must be a power of 2.  One job of the queue is always
+//         empty, ie the queue holds (CDMA_JOB_QUEUE_LEN - 1) jobs.
+//
+#define CDMA_JOB_QUEUE_LEN                                 32
+
+#define CDMA_JOB_ID_INVALID                                0
+
+// Job flags
+#define CDMA_JOB_FLAGS_CALLBACK_MAIN                       0x00000001   ///< Run the callback in main context (wlan_mac_cdma_poll()) instead
+                                                                         ///<   of the context that finishes the job (interrupt or caller)
+
+
+/*********************** Global Structure Definitions ************************/
+
+//-----------------------------------------------
+// CDMA job
+//
+//     The callback is called as callback(callback_arg) once the copy is complete.
+//
+typedef struct cdma_job_t{
+    void*           dest;
+    void*           src;
+    u32             size;
+    u32             id;                    ///< Job ID (CDMA_JOB_ID_INVALID is never used)
+    u32             flags;
+    function_ptr_t  callback;              ///< Completion callback (NULL if none or already called)
+    void*           callback_arg;
+} cdma_job_t;
+
+
+/*************************** Function Prototypes *****************************/
+
+int                wlan_mac_cdma_init(u32 dev_id);
+int                wlan_mac_cdma_setup_interrupt(XIntc* intc, u32 int_id);
+
+u32                wlan_mac_cdma_submit(void* dest, void* src, u32 size, function_ptr_t callback, void* callback_arg, u32 flags);
+void               wlan_mac_cdma_wait(u32 job_id);
+void               wlan_mac_cdma_wait_all();
+void               wlan_mac_cdma_poll();
+
+#endif /* WLAN_MAC_CDMA_H_ */
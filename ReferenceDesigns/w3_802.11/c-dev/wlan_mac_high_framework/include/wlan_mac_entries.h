@@ -42,6 +42,7 @@
 
 #define ENTRY_EN_MASK_TXRX_CTRL                            0x01
 #define ENTRY_EN_MASK_TXRX_MPDU                            0x02
+#define ENTRY_EN_MASK_TXRX_TRACE                           0x04
 
 //------------------------------------------------------------------------
 // Entry Types
@@ -76,6 +77,17 @@
 #define ENTRY_TYPE_TX_LOW                                  25
 #define ENTRY_TYPE_TX_LOW_LTG                              26
 
+//-----------------------------------------------
+// Latency Trace Entries
+
+#define ENTRY_TYPE_TX_TRACE                                30
+#define ENTRY_TYPE_RX_TRACE                                31
+
+//-----------------------------------------------
+// Tx Queue Entries
+
+#define ENTRY_TYPE_TX_DROP                                 35
+
 
 
 
@@ -105,6 +117,7 @@
 struct tx_frame_info_t;
 struct rx_frame_info_t;
 struct wlan_mac_low_tx_details_t;
+struct tx_queue_buffer_t;
 
 //-----------------------------------------------
 // Node Info Entry
@@ -295,7 +308,7 @@ typedef struct tx_high_entry{
     u32                 delay_accept;            // Delay from timestamp_create to when accepted by CPU Low
     u32                 delay_done;              // Delay from delay_accept to when CPU Low was done
     u64                 unique_seq;              // Unique packet sequence number
-    u32					padding0;
+    u32                 trace_id;                // Latency trace ID (0 if the packet was not traced)
     u16                 num_tx;                  // Number of Transmissions that it took to send the packet
     u16                 length;                  // Length of the packet
     u8                  padding1;
@@ -346,6 +359,79 @@ typedef struct tx_low_entry{
 
 
 
+//-----------------------------------------------
+// Transmit Latency Trace Entry
+//   - Created with the TX_HIGH entry of a traced packet (see wlan_exp_log_start_tx_trace())
+//   - The delays add up to the time between timestamp_ingress and when CPU Low
+//     was done with the packet.  The TX_LOW entries of the packet have the same
+//     unique_seq.
+//
+// Example request for a new transmit latency trace entry:
+//
+//     (tx_trace_entry *) wlan_exp_log_create_entry(ENTRY_TYPE_TX_TRACE, sizeof(tx_trace_entry))
+//
+typedef struct tx_trace_entry{
+    u64                 timestamp_ingress;       // Timestamp of when the packet entered the MAC (Ethernet Rx or LTG event)
+    u64                 unique_seq;              // Unique packet sequence number
+    u32                 trace_id;                // Latency trace ID
+    u32                 delay_enqueue;           // Delay from timestamp_ingress to when the packet was enqueued
+    u32                 delay_dequeue;           // Delay from enqueue to when the packet was dequeued
+    u32                 delay_accept;            // Delay from dequeue to when accepted by CPU Low
+    u32                 delay_done;              // Delay from accept to when CPU Low was done
+    u16                 num_tx;                  // Number of Transmissions that it took to send the packet
+    u8                  tx_result;               // Result of the transmission (see tx_frame_info_t)
+    u8                  reserved0;
+} tx_trace_entry;
+
+
+
+//-----------------------------------------------
+// Receive Latency Trace Entry
+//   - Created with the RX_OFDM / RX_DSSS entry of each data packet received with
+//     a good FCS while tracing is enabled
+//   - (addr2, mac_seq, timestamp) match the TX_LOW entry of the transmitting node
+//
+// Example request for a new receive latency trace entry:
+//
+//     (rx_trace_entry *) wlan_exp_log_create_entry(ENTRY_TYPE_RX_TRACE, sizeof(rx_trace_entry))
+//
+typedef struct rx_trace_entry{
+    u64                 timestamp;               // Timestamp of the reception (same as the RX entry)
+    u32                 delay_rx_process;        // Delay from timestamp to when CPU High processed the reception
+    u16                 mac_seq;                 // 802.11 MAC sequence number of the packet
+    u16                 length;                  // Length of the received packet
+    u8                  addr2[MAC_ADDR_LEN];     // Transmitter address
+    u16                 reserved0;
+} rx_trace_entry;
+
+
+
+//-----------------------------------------------
+// Transmit Drop Entry
+//   - Created when the AQM policy of a Tx queue drops a packet (see wlan_mac_queue.h)
+//   - Packets that were rejected by queue_admit() (tail drop) are not logged
+//
+// Example request for a new transmit drop entry:
+//
+//     (tx_drop_entry *) wlan_exp_log_create_entry(ENTRY_TYPE_TX_DROP, sizeof(tx_drop_entry))
+//
+typedef struct tx_drop_entry{
+    u64                 timestamp;               // Timestamp of the drop
+    u32                 delay_drop;              // Delay from enqueue to the drop
+    u32                 trace_id;                // Latency trace ID (0 if the packet was not traced)
+    u32                 num_dropped;             // Number of packets the queue has dropped for this reason (including this one)
+    u16                 queue_id;                // ID of the queue
+    u16                 queue_occupancy;         // Number of packets in the queue after the drop
+    u16                 length;                  // Length of the dropped packet
+    u8                  reason;                  // Reason of the drop (QUEUE_DROP_REASON_*)
+    u8                  reserved0;
+    u8                  addr1[MAC_ADDR_LEN];     // Receiver address
+    u16                 reserved1;
+    u32                 reserved2;
+} tx_drop_entry;
+
+
+
 
 
 /*************************** Function Prototypes *****************************/
@@ -374,7 +460,17 @@ void* wlan_exp_log_create_entry(u16 entry_type_id, u16 entry_size);
 tx_high_entry* wlan_exp_log_create_tx_high_entry(struct tx_frame_info_t* tx_frame_info);
 tx_low_entry* wlan_exp_log_create_tx_low_entry(struct tx_frame_info_t* tx_frame_info, struct wlan_mac_low_tx_details_t* tx_low_details);
 
-rx_common_entry* wlan_exp_log_create_rx_entry(struct rx_frame_info_t* rx_frame_info);
+rx_common_entry* wlan_exp_log_create_rx_entry(struct rx_frame_info_t* rx_frame_info, u32* cdma_job_id);
+
+void wlan_exp_log_start_tx_trace(struct tx_queue_buffer_t* tx_queue_buffer);
+
+tx_drop_entry* wlan_exp_log_create_tx_drop_entry(struct tx_queue_buffer_t* tx_queue_buffer, u8 reason, u16 queue_occupancy, u32 num_dropped);
+
+//-----------------------------------------------
+// Methods to reserve log space for a batch of Tx reports
+//
+void wlan_exp_log_reserve_tx_entries(u32 num_tx_reports);
+void wlan_exp_log_release_tx_entries();
 
 //-----------------------------------------------
 // Print function for all entries
@@ -110,6 +110,9 @@ u32       event_log_get_num_wraps( void );
 u32       event_log_get_flags( void );
 void*     event_log_get_next_empty_entry( u16 entry_type, u16 entry_size );
 
+int       event_log_reserve( u32 size );
+void      event_log_release_reservation();
+
 void      print_event_log( u32 num_events );
 void      print_event_log_size();
 
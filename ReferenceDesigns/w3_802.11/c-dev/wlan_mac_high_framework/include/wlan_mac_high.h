@@ -28,6 +28,8 @@ struct beacon_txrx_configure_t;
 struct network_info_t;
 enum userio_input_mask_t;
 struct station_info_t;
+struct mem_pool_info_t;
+struct prof_probe_t;
 
 /********************************************************************
  * Auxiliary (AUX) BRAM and DRAM (DDR) Memory Maps
@@ -43,7 +45,7 @@ struct station_info_t;
  * benefit from the low-latency access of the BRAM block.
  *
  * For example, the doubly-linked list of Tx Queue entries is stored in the
- * AUX BRAM. Each list entry points to a dedicated 4KB buffer in DRAM. The C code
+ * AUX BRAM. Each list entry points to a dedicated buffer in DRAM. The C code
  * can manage a queue with quick list operations in BRAM while the queued packets
  * themselves are stored in the slower but *much* larger DRAM.
  *
@@ -59,17 +61,18 @@ struct station_info_t;
  * -------------------------------------------------------------------------------------------------
  *
  * DRAM is mapped into the address space of CPU High.
- * This memory space is used as follows:
+ * This memory space is used as follows (1 GB DRAM; station_info_t is 488 B with
+ * WLAN_SW_CONFIG_ENABLE_TXRX_COUNTS and WLAN_SW_CONFIG_ENABLE_QUEUE_STATS):
  *
  * ******************************* DRAM Map *********************************************************
- * Description                      | Size
+ * Description                      | Offset      | Size
  * --------------------------------------------------------------------------------------------------
- * wlan_exp Eth buffers             |    1024 KB (WLAN_EXP_ETH_BUFFERS_SECTION_SIZE)
- * Tx queue buffers	                |    1400 KB (TX_QUEUE_BUFFER_SIZE)
- * BSS Info buffers	                |      27 KB (BSS_INFO_BUFFER_SIZE)
- * Station Info buffers             |      69 KB (STATION_INFO_BUFFER_SIZE)
- * User scratch space               |   10000 KB (USER_SCRATCH_SIZE)
- * Event log                        | 1036056 KB (EVENT_LOG_SIZE)
+ * wlan_exp Eth buffers             |        0 KB |    1024 KB (WLAN_EXP_ETH_BUFFERS_SECTION_SIZE)
+ * Tx queue buffers                 |     1024 KB |   14000 KB (TX_QUEUE_BUFFER_SIZE)
+ * BSS Info buffers                 |    15024 KB |      17 KB (BSS_INFO_BUFFER_SIZE)
+ * Station Info buffers             |   ~15041 KB |     264 KB (STATION_INFO_BUFFER_SIZE)
+ * User scratch space               |   ~15305 KB |   10000 KB (USER_SCRATCH_SIZE)
+ * Event log                        |   ~25305 KB | 1023271 KB (EVENT_LOG_SIZE)
  * --------------------------------------------------------------------------------------------------
  *
  * Platform must define:
@@ -120,9 +123,10 @@ struct station_info_t;
  * size of 12 bytes, this space allows for a potential of 3413 dl_entry structs describing
  * Tx queue elements.
  *
- * As far as the actual payload space in DRAM, 14000 kB was chosen because this is enough
- * to store each of the 3413 Tx queue elements. Each queue element points to a unique 4KB-sized
- * buffer.
+ * As far as the actual payload space in DRAM, 14000 kB was chosen. The buffers are split
+ * into size classes (see wlan_mac_queue.h): 256 4KB-sized buffers and 3157 2KB-sized
+ * buffers use the dl_entry structs in the AUX BRAM. The rest of the payload space holds
+ * ~13000 512B-sized buffers whose dl_entry structs are stored in DRAM after the buffers.
  *
  ********************************************************************/
 
@@ -187,7 +191,7 @@ struct station_info_t;
  *
  * The remaining space in DRAM is used for the WLAN Experiment Framework event log. The above
  * sections in DRAM are much smaller than the space set aside for the event log. In the current
- * implementation, the event log is ~995 MB.
+ * implementation, the event log is ~999 MB.
  *
  ********************************************************************/
 #define EVENT_LOG_BASE                     (USER_SCRATCH_HIGH + 1)
@@ -217,6 +221,21 @@ typedef enum interrupt_state_t{
 
 /******************** Global Structure/Enum Definitions **********************/
 
+//-----------------------------------------------
+// Rx packet buffer counts
+//     - Receptions that CPU Low had to drop because CPU High still owned all of
+//       the other Rx packet buffers are reported to CPU High with the next
+//       IPC_MBOX_RX_PKT_BUF_READY message
+//
+typedef struct rx_pkt_buf_info_t{
+    u32       num_rx_pkt_bufs;             ///< Number of Rx packet buffers (NUM_RX_PKT_BUFS)
+    u32       num_rx;                      ///< Number of receptions passed to CPU High
+    u32       num_overrun;                 ///< Number of receptions dropped by CPU Low (no empty Rx packet buffer)
+    u32       num_batches;                 ///< Number of IPC drains that processed at least one reception
+    u32       max_batch;                   ///< Largest number of receptions processed in one IPC drain
+} rx_pkt_buf_info_t;
+
+
 /***************************** Global Constants ******************************/
 
 extern const  u8 bcast_addr[MAC_ADDR_LEN];
@@ -253,12 +272,14 @@ void*              wlan_mac_high_malloc(u32 size);
 void*              wlan_mac_high_calloc(u32 size);
 void*              wlan_mac_high_realloc(void* addr, u32 size);
 void               wlan_mac_high_free(void* addr);
+void               wlan_mac_high_get_heap_info(struct mem_pool_info_t* info);
 void               wlan_mac_high_display_mallinfo();
 
 int                wlan_mac_high_memory_test();
 int                wlan_mac_high_right_shift_test();
 
 int                wlan_mac_high_cdma_start_transfer(void* dest, void* src, u32 size);
+u32                wlan_mac_high_cdma_submit_transfer(void* dest, void* src, u32 size);
 void               wlan_mac_high_cdma_finish_transfer();
 
 void               wlan_mac_high_mpdu_transmit(dl_entry* packet, int tx_pkt_buf);
@@ -266,6 +287,10 @@ void               wlan_mac_high_mpdu_transmit(dl_entry* packet, int tx_pkt_buf)
 void               wlan_mac_high_setup_tx_header(struct mac_header_80211_common* header, u8* addr_1, u8* addr_3);
 
 void 			   wlan_mac_high_process_ipc_msg(struct wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_payload);
+void               wlan_mac_high_rx_batch_done(u32 num_rx);
+void               wlan_mac_high_tx_report_batch_start(u32 num_pending_words);
+void               wlan_mac_high_tx_report_batch_done();
+void               wlan_mac_high_get_rx_pkt_buf_info(rx_pkt_buf_info_t* info);
 
 void               wlan_mac_high_set_srand(u32 seed);
 u8                 wlan_mac_high_bss_channel_spec_to_radio_chan(chan_spec_t chan_spec);
@@ -281,6 +306,7 @@ void               wlan_mac_high_set_dsss(u32 dsss_value);
 
 int                wlan_mac_high_write_low_mem(u32 num_words, u32* payload);
 int                wlan_mac_high_read_low_mem(u32 num_words, u32 baseaddr, u32* payload);
+int                wlan_mac_high_read_low_prof_probe(u32 probe_id, struct prof_probe_t* probe);
 int                wlan_mac_high_write_low_param(u32 num_words, u32* payload);
 
 void               wlan_mac_high_request_low_state();
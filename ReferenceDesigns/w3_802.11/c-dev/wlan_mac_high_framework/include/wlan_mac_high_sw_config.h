@@ -40,4 +40,9 @@
 
 #define WLAN_SW_CONFIG_ENABLE_ETH_BRIDGE	1		//Top-level switch for compiling Ethernet bridging functionality.
 
+#define WLAN_SW_CONFIG_ENABLE_QUEUE_STATS   1       //Top-level switch for compiling Tx queue statistics (latency and occupancy
+                                                    // histograms per queue and per station). Setting to 0 removes the histograms
+                                                    // from the station_info_t struct definition and disables their retrieval via
+                                                    // wlan_exp.
+
 #endif /* WLAN_MAC_HIGH_SW_CONFIG_H_ */
@@ -0,0 +1,121 @@
+/** @file wlan_mac_pool.h
+ *  @brief Memory Pools
+ *
+ *  This contains code for the fixed-size object pools and the command arena
+ *  that CPU High uses for its runtime objects instead of the heap.
+ *
+ *  @copyright Copyright 2014-2017, Mango Communications. All rights reserved.
+ *          Distributed under the Mango Communications Reference Design License
+ *              See LICENSE.txt included in the design archive or
+ *              at http://mangocomm.com/802.11/license
+ *
+ *  This file is part of the Mango 802.11 Reference Design (https://mangocomm.com/802.11)
+ */
+
+/***************************** Include Files *********************************/
+
+#include "wlan_mac_high_sw_config.h"
+#include "xil_types.h"
+
+
+/*************************** Constant Definitions ****************************/
+#ifndef WLAN_MAC_POOL_H_
+#define WLAN_MAC_POOL_H_
+
+
+//-----------------------------------------------
+// Memory pools
+//
+//     Objects that are created and destroyed while the node runs are taken from
+//     fixed-size pools in the DLMB instead of the (8 kB) heap, so that they can not
+//     fragment the heap.  If a pool is empty, the object is allocated with
+//     wlan_mac_high_malloc() instead (counted as a fallback).
+//
+//     NOTE:  wlan_mac_high_free() returns pool objects to their pool, so objects can
+//         be freed with wlan_mac_high_free() regardless of where they were allocated.
+//
+#define MEM_POOL_DL_ENTRY                                  0    ///< dl_entry of schedules, LTGs and address filter ranges
+#define MEM_POOL_SCHEDULE                                  1    ///< wlan_sched
+#define MEM_POOL_LTG                                       2    ///< tg_schedule
+#define MEM_POOL_LTG_PARAMS                                3    ///< LTG schedule parameters and state
+#define MEM_POOL_LTG_PAYLOAD                               4    ///< LTG payload parameters
+#define MEM_POOL_ADDR_RANGE                                5    ///< whitelist_range
+#define MEM_POOL_STATION_ENTRY                             6    ///< station_info_entry_t
+#define MEM_POOL_NETWORK_ENTRY                             7    ///< network_info_entry_t
+
+#define NUM_MEM_POOLS                                      8
+
+// Number of objects in each pool
+#define MEM_POOL_NUM_DL_ENTRY                              64
+#define MEM_POOL_NUM_SCHEDULE                              32
+#define MEM_POOL_NUM_ADDR_RANGE                            8
+#define MEM_POOL_NUM_STATION_ENTRY                         64
+#define MEM_POOL_NUM_NETWORK_ENTRY                         32
+
+#if WLAN_SW_CONFIG_ENABLE_LTG
+#define MEM_POOL_NUM_LTG                                   16
+#define MEM_POOL_NUM_LTG_PARAMS                            40   // Parameters + state of each LTG + wlan_exp command
+#define MEM_POOL_NUM_LTG_PAYLOAD                           16
+#else
+#define MEM_POOL_NUM_LTG                                   0
+#define MEM_POOL_NUM_LTG_PARAMS                            0
+#define MEM_POOL_NUM_LTG_PAYLOAD                           0
+#endif
+
+
+//-----------------------------------------------
+// Command arena
+//
+//     Scratch memory for the processing of a single wlan_exp command.  The arena is
+//     reset after each command, so its allocations do not need to be freed.  Freeing
+//     the most recent allocation returns its space immediately.
+//
+#define MEM_ARENA_SIZE                                     1024
+
+
+//-----------------------------------------------
+// Allocation statistics
+//
+//     The statistics of the pools are followed by the statistics of the command
+//     arena and of the heap (wlan_mac_high_malloc()).
+//
+#define MEM_POOL_INFO_ARENA                                (NUM_MEM_POOLS + 0)
+#define MEM_POOL_INFO_HEAP                                 (NUM_MEM_POOLS + 1)
+
+#define NUM_MEM_POOL_INFO                                  (NUM_MEM_POOLS + 2)
+
+
+/*********************** Global Structure Definitions ************************/
+
+//-----------------------------------------------
+// Allocation statistics
+//     - Pools:  Units are objects
+//     - Arena:  Units are bytes (obj_size is 1)
+//     - Heap:   Units are allocations (obj_size is 0); num_total is the number of bytes
+//               the heap has taken from the system
+//
+typedef struct mem_pool_info_t{
+    u32       obj_size;                    ///< Size of each object (bytes)
+    u32       num_total;                   ///< Number of objects in the pool
+    u32       num_live;                    ///< Number of objects in use
+    u32       max_live;                    ///< Largest number of objects in use since the node booted
+    u32       num_alloc;                   ///< Number of allocations
+    u32       num_fallback;                ///< Number of allocations passed to the heap because the pool was empty
+    u32       num_failed;                  ///< Number of allocations that failed
+} mem_pool_info_t;
+
+
+/*************************** Function Prototypes *****************************/
+
+void               wlan_mac_pool_init();
+
+void*              wlan_mac_pool_alloc(u32 pool_id);
+int                wlan_mac_pool_free(void* addr);
+
+void*              wlan_mac_arena_alloc(u32 size);
+void               wlan_mac_arena_reset();
+
+void               wlan_mac_pool_get_info(u32 info_id, mem_pool_info_t* info);
+void               wlan_mac_pool_display_info();
+
+#endif /* WLAN_MAC_POOL_H_ */
@@ -23,11 +23,37 @@
 
 //Forward declarations
 struct station_info_t;
+struct tx_frame_info_t;
 
 //-----------------------------------------------
 // Queue defines
 //
-#define QUEUE_BUFFER_SIZE                                  0x1000    // 4KB
+//     Tx queue buffers are split into size classes, each with its own free pool.
+//     queue_checkout_len() returns a buffer from the smallest class that can hold
+//     the requested frame. Only the LARGE class can hold a full MAX_PKT_SIZE_B frame;
+//     the smaller classes hold a truncated tx_queue_buffer_t (see queue_class_max_frame_len()).
+//
+#define QUEUE_BUFFER_CLASS_SMALL                           0
+#define QUEUE_BUFFER_CLASS_MEDIUM                          1
+#define QUEUE_BUFFER_CLASS_LARGE                           2
+#define NUM_QUEUE_BUFFER_CLASSES                           3
+
+#define QUEUE_BUFFER_SIZE_SMALL                            0x200     // 512B
+#define QUEUE_BUFFER_SIZE_MEDIUM                           0x800     // 2KB
+#define QUEUE_BUFFER_SIZE_LARGE                            0x1000    // 4KB
+
+#define QUEUE_BUFFER_SIZE                                  QUEUE_BUFFER_SIZE_LARGE
+
+// Number of LARGE buffers
+//     LARGE buffers are only needed for frames that do not fit in a MEDIUM buffer and for
+//     callers that do not know the frame length before checkout (ie queue_checkout())
+#define QUEUE_NUM_LARGE_BUFFERS                            256
+
+// Number of LARGE buffers reserved for queue_checkout()
+//     queue_checkout_len() does not take the last QUEUE_NUM_RESERVED_LARGE_BUFFERS free LARGE
+//     buffers, so data frames that fall back from the SMALL / MEDIUM classes cannot starve the
+//     management frames (beacons, probe / association responses, join, IBSS and sniffer paths)
+#define QUEUE_NUM_RESERVED_LARGE_BUFFERS                   32
 
 typedef struct tx_queue_buffer_t{
 	struct station_info_t*	station_info;
@@ -35,14 +61,119 @@ typedef struct tx_queue_buffer_t{
 	u16						length;
 	u16						flags;
 	dl_entry*			  	tx_queue_entry;
+	u64						timestamp_ingress;		// Time the packet entered the MAC (Ethernet Rx or LTG event)
+	u64						timestamp_enqueue;		// System time the packet was enqueued (queue_info.enqueue_timestamp
+													//   is the MAC time, which can jump, e.g. on an IBSS beacon)
+	u32						trace_id;				// Latency trace ID (0 if the packet is not traced)
+	u32						reserved0;
 	u8                    	frame[MAX_PKT_SIZE_B];
 } tx_queue_buffer_t;
 
+// Per-class occupancy of the Tx queue buffers
+typedef struct queue_buffer_class_info_t{
+	u32                     buffer_size;            // Size of each buffer (in bytes)
+	u32                     max_frame_len;          // Max frame length that fits in a buffer
+	u32                     num_total;              // Total number of buffers
+	u32                     num_free;               // Number of buffers in the free pool
+	u32                     min_free;               // Smallest num_free since boot (ie high watermark of occupancy)
+	u32                     num_fallback;           // Number of checkouts that fell back to this class from a smaller one
+	u32                     num_failed;             // Number of checkouts of this class that failed (no free buffer in this or larger classes)
+} queue_buffer_class_info_t;
+
 #define TX_QUEUE_BUFFER_FLAGS_FILL_TIMESTAMP	0x0001
 #define TX_QUEUE_BUFFER_FLAGS_FILL_DURATION		0x0002
 #define TX_QUEUE_BUFFER_FLAGS_FILL_UNIQ_SEQ		0x0004
 
 
+//-----------------------------------------------
+// Queue statistics
+//
+//     Histograms of the time each packet spends between enqueue and dequeue (sojourn),
+//     between enqueue and the end of its transmission (Tx done) and of the occupancy of
+//     the queue when the packet is enqueued.  They are kept per queue ID and per station
+//     (station_info_t) when WLAN_SW_CONFIG_ENABLE_QUEUE_STATS is set.  Packets dropped
+//     from the queue (AQM policy, purge_queue()) are not added to the sojourn histograms.
+//
+//     The bins are log2-scaled:  bin 0 counts samples of 0;  bin N (N > 0) counts samples
+//     of [2^(N-1), 2^N).  The last bin also counts all larger samples (ie >= 2^21 usec,
+//     ~2.1 seconds).  Times are in microseconds.
+//
+#define QUEUE_STATS_NUM_BINS                               23
+
+typedef struct queue_hist_t{
+	u32                     max;                    // Largest sample
+	u32                     bins[QUEUE_STATS_NUM_BINS];
+} queue_hist_t;
+
+typedef struct queue_stats_t{
+	queue_hist_t            sojourn;                // Time between enqueue and dequeue (usec) of dequeued packets
+	queue_hist_t            tx_done;                // Time between enqueue and Tx done (usec)
+	queue_hist_t            occupancy;              // Number of packets in the queue at enqueue (including itself)
+} queue_stats_t;
+ASSERT_TYPE_SIZE(queue_stats_t, 288);
+
+
+//-----------------------------------------------
+// Active queue management (AQM)
+//
+//     Each queue ID has its own AQM policy, which is a combination of the flags below.  The
+//     default policy (no flags) is the tail drop of the MAC applications:  queue_admit() rejects
+//     new packets while the queue holds max_length packets.
+//
+//     HEAD_DROP     - queue_admit() drops the oldest packets of a full queue instead of
+//                     rejecting the new packet (e.g. for broadcast safety messages, where
+//                     the newest message supersedes the older ones)
+//     LIFETIME      - dequeue_from_head() drops packets that were enqueued more than
+//                     lifetime_usec ago
+//     CODEL         - dequeue_from_head() drops packets with CoDel (RFC 8289):  once the
+//                     sojourn time of the dequeued packets has been above codel_target_usec
+//                     for codel_interval_usec, packets are dropped at a rate that grows with
+//                     the square root of the number of drops until the sojourn time is below
+//                     codel_target_usec again
+//
+//     Packets dropped by the AQM policy are counted per reason and logged as TX_DROP entries
+//     (see wlan_mac_entries.h).  Packets rejected by queue_admit() are only counted.
+//
+#define QUEUE_AQM_FLAG_HEAD_DROP                           0x00000001
+#define QUEUE_AQM_FLAG_LIFETIME                            0x00000002
+#define QUEUE_AQM_FLAG_CODEL                               0x00000004
+#define QUEUE_AQM_FLAGS_ALL                                (QUEUE_AQM_FLAG_HEAD_DROP | QUEUE_AQM_FLAG_LIFETIME | QUEUE_AQM_FLAG_CODEL)
+
+// Default CoDel parameters (RFC 8289)
+#define QUEUE_AQM_CODEL_TARGET_USEC_DEFAULT                5000
+#define QUEUE_AQM_CODEL_INTERVAL_USEC_DEFAULT              100000
+
+// Drop reasons
+//     NOTE:  These values must match the definitions in the Python WLAN Exp framework (TX_DROP entry).
+//
+#define QUEUE_DROP_REASON_TAIL                             0
+#define QUEUE_DROP_REASON_HEAD                             1
+#define QUEUE_DROP_REASON_LIFETIME                         2
+#define QUEUE_DROP_REASON_CODEL                            3
+#define NUM_QUEUE_DROP_REASONS                             4
+
+typedef struct queue_aqm_config_t{
+	u32                     flags;                  // QUEUE_AQM_FLAG_*
+	u32                     max_length;             // Max number of packets in the queue (0 = limit of the MAC application)
+	u32                     lifetime_usec;          // Max time between enqueue and dequeue (LIFETIME)
+	u32                     codel_target_usec;      // Target sojourn time (CODEL)
+	u32                     codel_interval_usec;    // Time the sojourn time can be above target before packets are dropped (CODEL)
+} queue_aqm_config_t;
+
+typedef struct queue_aqm_t{
+	queue_aqm_config_t      config;
+	u32                     num_dropped[NUM_QUEUE_DROP_REASONS];   // Number of packets dropped per QUEUE_DROP_REASON_*
+
+	// CoDel state (system time, usec)
+	u64                     codel_first_above_time;
+	u64                     codel_drop_next;
+	u32                     codel_count;
+	u32                     codel_last_count;
+	u8                      codel_dropping;
+	u8                      reserved0[7];
+} queue_aqm_t;
+
+
 /*************************** Function Prototypes *****************************/
 
 void                queue_init();
@@ -53,15 +184,35 @@ void 				transmit_checkin(dl_entry* tx_queue_buffer_entry);
 void 	    		queue_set_state_change_callback(function_ptr_t callback);
 
 dl_entry* 			queue_checkout();
+dl_entry* 			queue_checkout_len(u32 frame_length);
+dl_entry* 			queue_checkout_class(u8 buffer_class);
 void                queue_checkin(dl_entry* tqe);
 
-int                 queue_checkout_list(dl_list* new_list, u16 num_tqe);
+int                 queue_checkout_list(dl_list* new_list, u16 num_tqe, u8 buffer_class);
 int                 queue_checkin_list(dl_list * list);
 
+u8                  queue_buffer_class(u32 frame_length);
+u8                  queue_entry_class(dl_entry* tqe);
+u32                 queue_class_max_frame_len(u8 buffer_class);
+int                 queue_get_class_info(u8 buffer_class, queue_buffer_class_info_t* info);
+
 u32          		queue_num_free();
+u32          		queue_num_free_class(u8 buffer_class);
 u32          		queue_num_queued(u16 queue_sel);
 u32                 queue_total_size();
 
 void                purge_queue(u16 queue_sel);
 
+u8                  queue_admit(u16 queue_sel, u32 max_length);
+int                 queue_set_aqm_config(u16 queue_sel, queue_aqm_config_t* config);
+int                 queue_get_aqm(u16 queue_sel, queue_aqm_t* aqm);
+void                queue_reset_aqm_counts(u16 queue_sel);
+
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+void                queue_stats_mpdu_tx_done(struct tx_frame_info_t* tx_frame_info, struct station_info_t* station_info);
+int                 queue_get_stats(u16 queue_sel, queue_stats_t* stats);
+int                 queue_get_station_stats(struct station_info_t* station_info, queue_stats_t* stats);
+void                queue_stats_reset_all();
+#endif
+
 #endif /* WLAN_MAC_QUEUE_H_ */
@@ -20,6 +20,7 @@
 #include "xil_types.h"
 #include "wlan_common_types.h"
 #include "wlan_high_types.h"
+#include "wlan_mac_queue.h"
 
 
 /*************************** Constant Definitions ****************************/
@@ -116,15 +117,35 @@ typedef struct station_info_t{
     tx_params_t        tx_params_mgmt;	 		 				   /* Transmission Parameters Structure for Management */
 #if WLAN_SW_CONFIG_ENABLE_TXRX_COUNTS
     station_txrx_counts_t		txrx_counts;                        			/* Tx/Rx Counts */
+    u32                         txrx_counts_data_gen;                           /* Counts generation of the most recent update to txrx_counts.data */
+    u32                         txrx_counts_mgmt_gen;                           /* Counts generation of the most recent update to txrx_counts.mgmt */
 #endif
     rate_selection_info_t		rate_info;
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+    queue_stats_t               queue_stats;                                    /* Tx queue latency / occupancy histograms */
+#endif
 } station_info_t;
+
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+#define STATION_INFO_QUEUE_STATS_SIZE                      sizeof(queue_stats_t)
+#else
+#define STATION_INFO_QUEUE_STATS_SIZE                      0
+#endif
+
 #if WLAN_SW_CONFIG_ENABLE_TXRX_COUNTS
-ASSERT_TYPE_SIZE(station_info_t, 192);
-#define STATION_INFO_T_PORTABLE_SIZE (sizeof(station_info_t) - sizeof(station_txrx_counts_t) - sizeof(rate_selection_info_t) )
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+ASSERT_TYPE_SIZE(station_info_t, 488);
+#else
+ASSERT_TYPE_SIZE(station_info_t, 200);
+#endif
+#define STATION_INFO_T_PORTABLE_SIZE (sizeof(station_info_t) - sizeof(station_txrx_counts_t) - (2 * sizeof(u32)) - sizeof(rate_selection_info_t) - STATION_INFO_QUEUE_STATS_SIZE )
+#else
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+ASSERT_TYPE_SIZE(station_info_t, 368);
 #else
 ASSERT_TYPE_SIZE(station_info_t, 80);
-#define STATION_INFO_T_PORTABLE_SIZE (sizeof(station_info_t) - sizeof(rate_selection_info_t) )
+#endif
+#define STATION_INFO_T_PORTABLE_SIZE (sizeof(station_info_t) - sizeof(rate_selection_info_t) - STATION_INFO_QUEUE_STATS_SIZE )
 #endif
 
 
@@ -186,6 +207,7 @@ void             station_info_print(struct dl_list* list, u32 option_flags);
 #if WLAN_SW_CONFIG_ENABLE_TXRX_COUNTS
 void             txrx_counts_zero_all();
 void 			 station_info_clear_txrx_counts(station_txrx_counts_t* txrx_counts);
+u32              station_info_get_txrx_counts_gen();
 #endif
 
 void             station_info_timestamp_check();
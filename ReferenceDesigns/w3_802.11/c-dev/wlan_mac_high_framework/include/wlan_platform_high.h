@@ -18,6 +18,9 @@
 #include "wlan_common_types.h"
 #include "wlan_high_types.h"
 
+// Interrupt ID of a core whose interrupt is not connected
+#define PLATFORM_INT_ID_NONE                 0xFFFFFFFF
+
 //---------------------------------------
 // Platform information struct
 typedef struct platform_high_dev_info_t{
@@ -34,6 +37,7 @@ typedef struct platform_high_dev_info_t{
 	u32		timer_int_id;
 	u32		timer_freq;
 	u32		cdma_dev_id;
+	u32		cdma_int_id;
 	u32 	mailbox_int_id;
 	u32		wlan_exp_eth_mac_dev_id;
 	u32		wlan_exp_eth_dma_dev_id;
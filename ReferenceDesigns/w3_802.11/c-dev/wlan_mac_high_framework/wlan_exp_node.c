@@ -38,6 +38,9 @@
 #include "wlan_mac_high.h"
 #include "wlan_mac_common.h"
 #include "wlan_mac_dl_list.h"
+#include "wlan_mac_queue.h"
+#include "wlan_mac_pool.h"
+#include "wlan_mac_prof.h"
 
 // WLAN Exp includes
 #include "wlan_exp.h"
@@ -134,6 +137,29 @@ typedef struct wlan_exp_station_txrx_counts_t{
 } wlan_exp_station_txrx_counts_t;
 ASSERT_TYPE_SIZE(wlan_exp_station_txrx_counts_t, 128);
 
+//-----------------------------------------------
+// wlan_exp Tx/Rx Counts Delta
+//
+//     Only used to communicate with WLAN Exp Host.  A delta buffer is one
+//     wlan_exp_txrx_counts_delta_hdr_t followed by one wlan_exp_txrx_counts_delta_entry_t
+//     per changed station.  Each entry is followed by the txrx_counts_sub_t structs
+//     selected by its flags (data first, then mgmt).  Entries with no flags set are
+//     padding and should be ignored by the host.
+//
+typedef struct __attribute__((__packed__)){
+    u64                                 timestamp;                 // System time when the delta was taken
+    u32                                 generation;                // Counts generation of this delta
+    u32                                 num_entries;               // Number of changed stations when the delta was taken
+} wlan_exp_txrx_counts_delta_hdr_t;
+ASSERT_TYPE_SIZE(wlan_exp_txrx_counts_delta_hdr_t, 16);
+
+typedef struct __attribute__((__packed__)){
+    u8                                  addr[MAC_ADDR_LEN];        // MAC address associated with these counts
+    u8                                  flags;                     // CMD_PARAM_COUNTS_DELTA_FLAG_* of the counts that follow
+    u8                                  reserved;
+} wlan_exp_txrx_counts_delta_entry_t;
+ASSERT_TYPE_SIZE(wlan_exp_txrx_counts_delta_entry_t, 8);
+
 /*************************** Functions Prototypes ****************************/
 
 typedef dl_entry* (*list_search_func_ptr)(u8 *);
@@ -141,6 +167,9 @@ int node_init_parameters(u32 *info);
 int process_hton_msg(int socket_index, struct sockaddr* from, wlan_exp_ip_udp_buffer* recv_buffer, u32 recv_flags, wlan_exp_ip_udp_buffer* send_buffer);
 void send_early_resp(int socket_index, void* to, cmd_resp_hdr* resp_hdr, void* buffer);
 int process_node_cmd(int socket_index, void* from, cmd_resp* command, cmd_resp* response, u32 max_resp_len);
+int process_cmd_group(int socket_index, void* from, cmd_resp* command, cmd_resp* response, u32 max_resp_len);
+int process_batch_cmd(int socket_index, void* from, cmd_resp* command, cmd_resp* response, u32 max_resp_len);
+u32 batch_cmd_max_resp_len(u32 cmd, u32 max_resp_len);
 
 void ltg_cleanup(u32 id, void* callback_arg);
 
@@ -159,6 +188,12 @@ u32           process_buffer_cmds(int socket_index, void* from, cmd_resp* comman
                                   void (*copy_source_to_dest)(void*, void*, u8*),
                                   void (*zero_dest)(void*));
 
+#if WLAN_SW_CONFIG_ENABLE_TXRX_COUNTS
+u32           process_counts_txrx_delta(int socket_index, void* from, cmd_resp* response,
+                                        u32* cmd_args_32, cmd_resp_hdr* resp_hdr, u32* resp_args_32,
+                                        u32 max_resp_len);
+#endif
+
 dl_entry*     find_station_info(u8* mac_addr);
 void          zero_station_info(void* dest);
 void          copy_station_info_to_dest(void* source, void* dest, u8* mac_addr);
@@ -490,7 +525,6 @@ int null_process_cmd_callback(u32 cmd_id, void* param){
  *****************************************************************************/
 int  process_hton_msg(int socket_index, struct sockaddr * from, wlan_exp_ip_udp_buffer * recv_buffer, u32 recv_flags, wlan_exp_ip_udp_buffer * send_buffer) {
 
-    u8 cmd_group;
     u32 resp_sent = NO_RESP_SENT;
     u32 resp_length;
     u32 max_resp_len = node_info.eth_dev->max_pkt_words;
@@ -519,21 +553,13 @@ int  process_hton_msg(int socket_index, struct sockaddr * from, wlan_exp_ip_udp_
     cmd_hdr->num_args = Xil_Ntohs(cmd_hdr->num_args);
 
     // Send command to appropriate processing sub-system
-    cmd_group = CMD_TO_GROUP(cmd_hdr->cmd);
-
-    switch(cmd_group){
-        case GROUP_NODE:
-            resp_sent = process_node_cmd(socket_index, from, &command, &response, max_resp_len);
-        break;
-        case GROUP_TRANSPORT:
-            resp_sent = process_transport_cmd(socket_index, from, &command, &response, max_resp_len);
-        break;
-        case GROUP_USER:
-            resp_sent = process_user_cmd(socket_index, from, &command, &response, max_resp_len);
-        break;
-        default:
-            wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_node, "Unknown command group: %d\n", cmd_group);
-        break;
+    //     NOTE:  Batch commands are unpacked here since each command in the batch may belong
+    //         to a different command group.
+    //
+    if ((CMD_TO_GROUP(cmd_hdr->cmd) == GROUP_TRANSPORT) && (CMD_TO_CMDID(cmd_hdr->cmd) == CMDID_TRANSPORT_BATCH)) {
+        resp_sent = process_batch_cmd(socket_index, from, &command, &response, max_resp_len);
+    } else {
+        resp_sent = process_cmd_group(socket_index, from, &command, &response, max_resp_len);
     }
 
     // Adjust the length of the response to include the response data from the sub-system and the
@@ -558,6 +584,270 @@ int  process_hton_msg(int socket_index, struct sockaddr * from, wlan_exp_ip_udp_
 
 
 
+/*****************************************************************************/
+/**
+ * Process Command Group
+ *
+ * Sends a single command to the processing sub-system of its command group.
+ *
+ * @param   socket_index     - Index of the socket on which to send message
+ * @param   from             - Pointer to socket address structure (struct sockaddr *) where command is from
+ * @param   command          - Pointer to Command (header already endian swapped)
+ * @param   response         - Pointer to Response
+ * @param   max_resp_len     - Maximum number of u32 words allowed in response
+ *
+ * @return  int              - Status of the command:
+ *                                 NO_RESP_SENT - No response has been sent
+ *                                 RESP_SENT    - A response has been sent
+ *
+ *****************************************************************************/
+int process_cmd_group(int socket_index, void* from, cmd_resp* command, cmd_resp* response, u32 max_resp_len) {
+
+    u32 resp_sent = NO_RESP_SENT;
+    u8 cmd_group = CMD_TO_GROUP(command->header->cmd);
+
+    switch(cmd_group){
+        case GROUP_NODE:
+            resp_sent = process_node_cmd(socket_index, from, command, response, max_resp_len);
+        break;
+        case GROUP_TRANSPORT:
+            resp_sent = process_transport_cmd(socket_index, from, command, response, max_resp_len);
+        break;
+        case GROUP_USER:
+            resp_sent = process_user_cmd(socket_index, from, command, response, max_resp_len);
+        break;
+        default:
+            wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_node, "Unknown command group: %d\n", cmd_group);
+        break;
+    }
+
+    // Return the scratch memory of the command
+    wlan_mac_arena_reset();
+
+    return resp_sent;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Process Batch Command
+ *
+ * Processes a batch of commands carried in a single host to node message and
+ * collects all of the responses into a single node to host message.
+ *
+ * Command args:
+ *     Word[0]     - Number of commands in the batch
+ *     Word[1 - N] - Command records (cmd_resp_hdr followed by args, network byte order)
+ *
+ * Response args:
+ *     Word[0]     - Number of commands processed
+ *     Word[1 - N] - Response records (cmd_resp_hdr followed by args, network byte order)
+ *
+ * @param   socket_index     - Index of the socket on which to send message
+ * @param   from             - Pointer to socket address structure (struct sockaddr *) where command is from
+ * @param   command          - Pointer to Command
+ * @param   response         - Pointer to Response
+ * @param   max_resp_len     - Maximum number of u32 words allowed in response
+ *
+ * @return  int              - Status of the command:
+ *                                 NO_RESP_SENT - No response has been sent
+ *                                 RESP_SENT    - A response has been sent
+ *
+ * @note    A command cannot be undone once it has run, so a command is only run if the space
+ *          left in the response can hold its largest response (see batch_cmd_max_resp_len()).
+ *          Otherwise, processing stops before the command.  The host uses the number of
+ *          commands processed to resend the remainder of the batch; a command that does not
+ *          fit in an empty batch (ie buffer commands, which send their own responses) is sent
+ *          on its own.
+ *
+ *****************************************************************************/
+int process_batch_cmd(int socket_index, void* from, cmd_resp* command, cmd_resp* response, u32 max_resp_len) {
+
+    u32 i;
+    u32 num_cmds;
+    u32 num_processed = 0;
+    u32 resp_sent = NO_RESP_SENT;
+    u32 resp_index = 1;                                    // Word[0] is the number of commands processed
+    u32 resp_space;
+    u32 sub_length;
+
+    cmd_resp_hdr* cmd_hdr = command->header;
+    u32* cmd_args_32 = command->args;
+    u8* cmd_ptr;
+    u8* cmd_end;
+
+    cmd_resp_hdr* resp_hdr = response->header;
+    u32* resp_args_32 = response->args;
+
+    cmd_resp sub_command;
+    cmd_resp sub_response;
+
+    // Set up the response header
+    resp_hdr->cmd      = cmd_hdr->cmd;
+    resp_hdr->length   = 0;
+    resp_hdr->num_args = 0;
+
+    if (cmd_hdr->length < sizeof(u32)) {
+        wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_transport, "Batch command too short: %d bytes\n", cmd_hdr->length);
+        return resp_sent;
+    }
+
+    num_cmds = Xil_Ntohl(cmd_args_32[0]);
+    cmd_ptr  = (u8*)(&cmd_args_32[1]);
+    cmd_end  = ((u8*)cmd_args_32) + cmd_hdr->length;
+
+    for (i = 0; i < num_cmds; i++) {
+
+        // Check that the command header and args are contained in the batch
+        if ((cmd_ptr + sizeof(cmd_resp_hdr)) > cmd_end) {
+            wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_transport, "Batch command %d truncated\n", i);
+            break;
+        }
+
+        sub_command.header = (cmd_resp_hdr*)cmd_ptr;
+        sub_length         = Xil_Ntohs(sub_command.header->length);
+
+        if ((cmd_ptr + sizeof(cmd_resp_hdr) + sub_length) > cmd_end) {
+            wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_transport, "Batch command %d truncated\n", i);
+            break;
+        }
+
+        // Endian swap the command header so future processing can understand it
+        sub_command.header->cmd      = Xil_Ntohl(sub_command.header->cmd);
+        sub_command.header->length   = sub_length;
+        sub_command.header->num_args = Xil_Ntohs(sub_command.header->num_args);
+
+        // Batches cannot be nested
+        if ((CMD_TO_GROUP(sub_command.header->cmd) == GROUP_TRANSPORT) &&
+            (CMD_TO_CMDID(sub_command.header->cmd) == CMDID_TRANSPORT_BATCH)) {
+            wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_transport, "Nested batch command not supported\n");
+            break;
+        }
+
+        // Stop before the command if its largest response does not fit in the remaining space
+        if ((resp_index + (sizeof(cmd_resp_hdr) / sizeof(u32))) < max_resp_len) {
+            resp_space = max_resp_len - resp_index - (sizeof(cmd_resp_hdr) / sizeof(u32));
+        } else {
+            resp_space = 0;
+        }
+
+        if (batch_cmd_max_resp_len(sub_command.header->cmd, max_resp_len) > resp_space) {
+            break;
+        }
+
+        sub_command.flags  = command->flags;
+        sub_command.args   = (u32*)(cmd_ptr + sizeof(cmd_resp_hdr));
+        sub_command.buffer = command->buffer;
+
+        sub_response.flags  = 0;
+        sub_response.header = (cmd_resp_hdr*)(&resp_args_32[resp_index]);
+        sub_response.args   = &resp_args_32[resp_index + (sizeof(cmd_resp_hdr) / sizeof(u32))];
+        sub_response.buffer = response->buffer;
+
+        // Set up the response header so commands that do not fill in a response (ie unknown
+        // command groups) return an empty record
+        sub_response.header->cmd      = sub_command.header->cmd;
+        sub_response.header->length   = 0;
+        sub_response.header->num_args = 0;
+
+        resp_sent = process_cmd_group(socket_index, from, &sub_command, &sub_response, resp_space);
+
+        if (resp_sent == RESP_SENT) {
+            wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_transport, "Command 0x%08x sent its own response; batch aborted\n", sub_command.header->cmd);
+            return resp_sent;
+        }
+
+        // The command has run, so it is counted even if its response is larger than
+        // batch_cmd_max_resp_len() (a bug in that table); the response is replaced by an
+        // empty record so the host does not run the command again.
+        //
+        if (sub_response.header->length > (resp_space * sizeof(u32))) {
+            wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_transport, "Command 0x%08x response longer than %d words; response dropped\n",
+                            sub_response.header->cmd, resp_space);
+            sub_response.header->length   = 0;
+            sub_response.header->num_args = 0;
+        }
+
+        // Advance past the response record
+        resp_index += (sizeof(cmd_resp_hdr) + sub_response.header->length) / sizeof(u32);
+
+        // Endian swap the response header
+        sub_response.header->cmd      = Xil_Ntohl(sub_response.header->cmd);
+        sub_response.header->length   = Xil_Ntohs(sub_response.header->length);
+        sub_response.header->num_args = Xil_Ntohs(sub_response.header->num_args);
+
+        cmd_ptr += sizeof(cmd_resp_hdr) + sub_length;
+        num_processed++;
+    }
+
+    resp_args_32[0] = Xil_Htonl(num_processed);
+
+    resp_hdr->length   = (resp_index * sizeof(u32));
+    resp_hdr->num_args = resp_index;
+
+    return resp_sent;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Batch Command Maximum Response Length
+ *
+ * Returns the largest response that a command can write.  process_batch_cmd() only runs
+ * a command if this much space is left in the batch response.
+ *
+ * @param   cmd              - Command (header already endian swapped)
+ * @param   max_resp_len     - Maximum number of u32 words allowed in a response
+ *
+ * @return  u32              - Maximum number of u32 words in the response (not including
+ *                                 the response header).  Commands that can fill a whole
+ *                                 response, and commands that send their own responses,
+ *                                 return max_resp_len so they are never part of a batch.
+ *
+ * @note    Commands that are not listed respond with at most
+ *          CMD_PARAM_TRANSPORT_BATCH_DEFAULT_RESP_WORDS words.  A command that can respond
+ *          with more must be added here.
+ *
+ *****************************************************************************/
+u32 batch_cmd_max_resp_len(u32 cmd, u32 max_resp_len) {
+
+    if (CMD_TO_GROUP(cmd) != GROUP_NODE) {
+        return CMD_PARAM_TRANSPORT_BATCH_DEFAULT_RESP_WORDS;
+    }
+
+    switch (CMD_TO_CMDID(cmd)) {
+        // Responses sized by the space left in the packet or by the command args
+        case CMDID_NODE_INFO:
+        case CMDID_DEV_MEM_HIGH:
+        case CMDID_DEV_MEM_LOW:
+        case CMDID_DEV_EEPROM:
+        // Buffer commands
+        case CMDID_LOG_GET_ENTRIES:
+        case CMDID_COUNTS_GET_TXRX:
+        case CMDID_COUNTS_GET_TXRX_DELTA:
+        case CMDID_NODE_GET_BSS_MEMBERS:
+        case CMDID_NODE_GET_STATION_INFO_LIST:
+        case CMDID_NODE_GET_BSS_INFO:
+            return max_resp_len;
+
+        case CMDID_NODE_GET_MEM_POOL_INFO:
+            return (1 + (7 * NUM_MEM_POOL_INFO));
+
+        case CMDID_NODE_PROFILE:
+            return (4 + (NUM_PROF_PROBES * (5 + PROF_NUM_BINS)));
+
+        case CMDID_NODE_QUEUE_STATS:
+            return (2 + (3 * (1 + QUEUE_STATS_NUM_BINS)));
+
+        default:
+            return CMD_PARAM_TRANSPORT_BATCH_DEFAULT_RESP_WORDS;
+    }
+}
+
+
+
 /*****************************************************************************/
 /**
  * Node Send Early Response
@@ -949,6 +1239,7 @@ int process_node_cmd(int socket_index, void* from, cmd_resp* command, cmd_resp*
             //                     [ 1] - Wrap = 1; No Wrap = 0;
             //                     [ 2] - Full Payloads Enabled = 1; Full Payloads Disabled = 0;
             //                     [ 3] - Log WN Cmds Enabled = 1; Log WN Cmds Disabled = 0;
+            //                     [ 5] - Latency Traces Enabled = 1; Latency Traces Disabled = 0;
             //   - cmd_args_32[1]  - mask for flags
             //
             //   - resp_args_32[0] - CMD_PARAM_SUCCESS
@@ -1002,6 +1293,14 @@ int process_node_cmd(int socket_index, void* from, cmd_resp* command, cmd_resp*
                 }
             }
 
+            if (mask & CMD_PARAM_LOG_CONFIG_FLAG_TXRX_TRACE) {
+                if (flags & CMD_PARAM_LOG_CONFIG_FLAG_TXRX_TRACE) {
+                    entry_mask |= ENTRY_EN_MASK_TXRX_TRACE;
+                } else {
+                    entry_mask &= ~ENTRY_EN_MASK_TXRX_TRACE;
+                }
+            }
+
             wlan_exp_log_set_entry_en_mask(entry_mask);
 
             // Send response of status
@@ -1027,6 +1326,7 @@ int process_node_cmd(int socket_index, void* from, cmd_resp* command, cmd_resp*
             //                         [2] - Log full payloads enabled
             //                         [3] - Log Tx / Rx MPDU frames enabled
             //                         [4] - Log Tx / Rx CTRL frames enabled
+            //                         [5] - Log Tx / Rx latency traces enabled
             //
             u32 flags         = event_log_get_flags();
             u32 log_length    = wlan_exp_log_get_mac_payload_len();
@@ -1044,6 +1344,10 @@ int process_node_cmd(int socket_index, void* from, cmd_resp* command, cmd_resp*
                 flags |= CMD_PARAM_LOG_CONFIG_FLAG_TXRX_CTRL;
             }
 
+            if (entry_en_mask & ENTRY_EN_MASK_TXRX_TRACE) {
+                flags |= CMD_PARAM_LOG_CONFIG_FLAG_TXRX_TRACE;
+            }
+
             // Set response
             resp_args_32[resp_index++] = Xil_Htonl(event_log_get_next_entry_index());
             resp_args_32[resp_index++] = Xil_Htonl(event_log_get_oldest_entry_index());
@@ -1223,6 +1527,64 @@ int process_node_cmd(int socket_index, void* from, cmd_resp* command, cmd_resp*
         break;
 
 
+        //---------------------------------------------------------------------
+        case CMDID_COUNTS_GET_TXRX_DELTA: {
+            // NODE_GET_COUNTS_DELTA Packet Format:
+            //   - cmd_args_32[0]   - buffer id
+            //   - cmd_args_32[1]   - flags
+            //   - cmd_args_32[2]   - start_address of transfer (ignored; delta is always sent in full)
+            //   - cmd_args_32[3]   - size of transfer (ignored)
+            //   - cmd_args_32[4]   - Counts generation of the host's last delta
+            //                        CMD_PARAM_COUNTS_DELTA_GEN_ALL  -> Return all counts
+            //
+            // Always returns a valid WLAN Exp Buffer (either 1 or more packets)
+            //   - buffer_id       - uint32  - buffer_id
+            //   - flags           - uint32  - flags
+            //   - bytes_remaining - uint32  - Number of bytes remaining in the transfer
+            //   - start_byte      - uint32  - Byte index of the first byte in this packet
+            //   - size            - uint32  - Number of payload bytes in this packet
+            //   - byte[]          - uint8[] - Delta buffer (see wlan_exp_txrx_counts_delta_hdr_t)
+            //
+#if WLAN_SW_CONFIG_ENABLE_TXRX_COUNTS
+            resp_sent = process_counts_txrx_delta(socket_index, from, response,
+                                                  cmd_args_32, resp_hdr, resp_args_32, max_resp_len);
+#else
+            wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_counts, "Tx/Rx counts not supported\n");
+#endif
+        }
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_COUNTS_GET_RX_PKT_BUF: {
+            // Get the Rx packet buffer counts
+            //
+            // Message format:
+            //     cmd_args_32[0]      Reserved
+            //
+            // Response format (see rx_pkt_buf_info_t):
+            //     resp_args_32[0]     Number of Rx packet buffers
+            //     resp_args_32[1]     Number of receptions passed to CPU High
+            //     resp_args_32[2]     Number of receptions dropped by CPU Low (Rx overrun)
+            //     resp_args_32[3]     Number of IPC drains that processed at least one reception
+            //     resp_args_32[4]     Largest number of receptions processed in one IPC drain
+            //
+            rx_pkt_buf_info_t          rx_info;
+
+            wlan_mac_high_get_rx_pkt_buf_info(&rx_info);
+
+            resp_args_32[resp_index++] = Xil_Htonl(rx_info.num_rx_pkt_bufs);
+            resp_args_32[resp_index++] = Xil_Htonl(rx_info.num_rx);
+            resp_args_32[resp_index++] = Xil_Htonl(rx_info.num_overrun);
+            resp_args_32[resp_index++] = Xil_Htonl(rx_info.num_batches);
+            resp_args_32[resp_index++] = Xil_Htonl(rx_info.max_batch);
+
+            resp_hdr->length  += (resp_index * sizeof(u32));
+            resp_hdr->num_args = resp_index;
+        }
+        break;
+
+
 //-----------------------------------------------------------------------------
 // Local Traffic Generator (LTG) Commands
 //-----------------------------------------------------------------------------
@@ -2257,6 +2619,331 @@ int process_node_cmd(int socket_index, void* from, cmd_resp* command, cmd_resp*
         break;
 
 
+        //---------------------------------------------------------------------
+        case CMDID_NODE_GET_MEM_POOL_INFO: {
+            // Get the allocation statistics of the memory pools
+            //
+            // Message format:
+            //     cmd_args_32[0]      Reserved
+            //
+            // Response format:
+            //     resp_args_32[0]     Number of entries (N):  NUM_MEM_POOLS pools, the command arena
+            //                         and the heap (see wlan_mac_pool.h)
+            //     resp_args_32[1:7N]  Per entry (see mem_pool_info_t):
+            //                             obj_size, num_total, num_live, max_live,
+            //                             num_alloc, num_fallback, num_failed
+            //
+            u32                        info_id;
+            mem_pool_info_t            pool_info;
+
+            resp_args_32[resp_index++] = Xil_Htonl(NUM_MEM_POOL_INFO);
+
+            for (info_id = 0; info_id < NUM_MEM_POOL_INFO; info_id++) {
+                wlan_mac_pool_get_info(info_id, &pool_info);
+
+                resp_args_32[resp_index++] = Xil_Htonl(pool_info.obj_size);
+                resp_args_32[resp_index++] = Xil_Htonl(pool_info.num_total);
+                resp_args_32[resp_index++] = Xil_Htonl(pool_info.num_live);
+                resp_args_32[resp_index++] = Xil_Htonl(pool_info.max_live);
+                resp_args_32[resp_index++] = Xil_Htonl(pool_info.num_alloc);
+                resp_args_32[resp_index++] = Xil_Htonl(pool_info.num_fallback);
+                resp_args_32[resp_index++] = Xil_Htonl(pool_info.num_failed);
+            }
+
+            resp_hdr->length  += (resp_index * sizeof(u32));
+            resp_hdr->num_args = resp_index;
+        }
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_NODE_PROFILE: {
+            // Read or reset the profiling probes of CPU High or CPU Low
+            //
+            // Message format:
+            //     cmd_args_32[0]      Command:  CMD_PARAM_READ_VAL or CMD_PARAM_NODE_PROFILE_RESET
+            //     cmd_args_32[1]      CPU:  CMD_PARAM_NODE_PROFILE_CPU_HIGH or CMD_PARAM_NODE_PROFILE_CPU_LOW
+            //
+            // Response format:
+            //     resp_args_32[0]     Status
+            //     resp_args_32[1]     Ticks per microsecond
+            //     resp_args_32[2]     Number of probes (N; 0 if the CPU was not compiled with profiling)
+            //     resp_args_32[3]     Number of histogram bins (B)
+            //     resp_args_32[4:]    Per probe (see prof_probe_t):
+            //                             num_samples, min_ticks, max_ticks, total_ticks_msb,
+            //                             total_ticks_lsb, bins[B]
+            //
+            // NOTE:  The probes of CPU Low are reset with the LOW_PARAM_PROF_RESET low parameter
+            //     (CMDID_NODE_LOW_PARAM), since CPU Low does not answer parameter reads.
+            //
+            u32                        probe_id;
+            u32                        bin;
+            int                        prof_status;
+            prof_probe_t               probe;
+            u32                        status   = CMD_PARAM_SUCCESS;
+            u32                        msg_cmd  = Xil_Ntohl(cmd_args_32[0]);
+            u32                        cpu      = Xil_Ntohl(cmd_args_32[1]);
+
+            // Skip the status argument (filled in below)
+            resp_index++;
+
+            resp_args_32[resp_index++] = Xil_Htonl(PROF_TICKS_PER_USEC);
+            resp_args_32[resp_index++] = Xil_Htonl(0);
+            resp_args_32[resp_index++] = Xil_Htonl(PROF_NUM_BINS);
+
+            switch (msg_cmd) {
+                case CMD_PARAM_READ_VAL:
+                    for (probe_id = 0; probe_id < NUM_PROF_PROBES; probe_id++) {
+                        if (cpu == CMD_PARAM_NODE_PROFILE_CPU_LOW) {
+                            prof_status = wlan_mac_high_read_low_prof_probe(probe_id, &probe);
+                        } else {
+                            prof_status = wlan_mac_prof_get_probe(probe_id, &probe);
+                        }
+
+                        if (prof_status != 0) {
+                            wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_node, "Could not read profiling probes of CPU %s\n",
+                                            (cpu == CMD_PARAM_NODE_PROFILE_CPU_LOW) ? "Low" : "High");
+                            status     = CMD_PARAM_ERROR;
+                            resp_index = 4;
+                            break;
+                        }
+
+                        resp_args_32[resp_index++] = Xil_Htonl(probe.num_samples);
+                        resp_args_32[resp_index++] = Xil_Htonl(probe.min_ticks);
+                        resp_args_32[resp_index++] = Xil_Htonl(probe.max_ticks);
+                        resp_args_32[resp_index++] = Xil_Htonl(probe.total_ticks_msb);
+                        resp_args_32[resp_index++] = Xil_Htonl(probe.total_ticks_lsb);
+
+                        for (bin = 0; bin < PROF_NUM_BINS; bin++) {
+                            resp_args_32[resp_index++] = Xil_Htonl(probe.bins[bin]);
+                        }
+                    }
+
+                    if (status == CMD_PARAM_SUCCESS) {
+                        resp_args_32[2] = Xil_Htonl(NUM_PROF_PROBES);
+                    }
+                break;
+
+                case CMD_PARAM_NODE_PROFILE_RESET:
+                    if (cpu == CMD_PARAM_NODE_PROFILE_CPU_HIGH) {
+                        wlan_mac_prof_reset();
+                    } else {
+                        wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_node, "Use LOW_PARAM_PROF_RESET to reset the profiling probes of CPU Low\n");
+                        status = CMD_PARAM_ERROR;
+                    }
+                break;
+
+                default:
+                    wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_node, "Unknown command for 0x%6x: %d\n", cmd_id, msg_cmd);
+                    status = CMD_PARAM_ERROR;
+                break;
+            }
+
+            resp_args_32[0]    = Xil_Htonl(status);
+
+            resp_hdr->length  += (resp_index * sizeof(u32));
+            resp_hdr->num_args = resp_index;
+        }
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_NODE_QUEUE_STATS: {
+            // Read the Tx queue statistics of a queue or a station, or reset all Tx queue statistics
+            //
+            // Message format:
+            //     cmd_args_32[0]      Command:  CMD_PARAM_READ_VAL or CMD_PARAM_NODE_QUEUE_STATS_RESET
+            //     cmd_args_32[1]      Select:  CMD_PARAM_NODE_QUEUE_STATS_QUEUE or CMD_PARAM_NODE_QUEUE_STATS_STATION
+            //     cmd_args_32[2]      Queue ID (CMD_PARAM_NODE_QUEUE_STATS_QUEUE)
+            //     cmd_args_32[3:4]    MAC Address (CMD_PARAM_NODE_QUEUE_STATS_STATION)
+            //
+            // Response format:
+            //     resp_args_32[0]     Status
+            //     resp_args_32[1]     Number of histogram bins (B; 0 if no statistics are returned)
+            //     resp_args_32[2:]    Histograms (see queue_stats_t):  sojourn, tx_done, occupancy
+            //                             Each histogram is:  max, bins[B]
+            //
+            u32                        status   = CMD_PARAM_SUCCESS;
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+            u32                        bin;
+            u32                        hist_idx;
+            int                        stats_status;
+            u8                         mac_addr[MAC_ADDR_LEN];
+            station_info_entry_t*      station_info_entry;
+            queue_hist_t*              hist;
+            queue_stats_t              stats;
+            queue_hist_t*              hists[3] = { &(stats.sojourn), &(stats.tx_done), &(stats.occupancy) };
+            u32                        msg_cmd  = Xil_Ntohl(cmd_args_32[0]);
+            u32                        select   = Xil_Ntohl(cmd_args_32[1]);
+            u32                        queue_id = Xil_Ntohl(cmd_args_32[2]);
+
+            // Skip the status argument (filled in below)
+            resp_index++;
+
+            resp_args_32[resp_index++] = Xil_Htonl(0);
+
+            switch (msg_cmd) {
+                case CMD_PARAM_READ_VAL:
+                    if (select == CMD_PARAM_NODE_QUEUE_STATS_STATION) {
+                        wlan_exp_get_mac_addr(&((u32 *)cmd_args_32)[3], &mac_addr[0]);
+
+                        station_info_entry = station_info_find_by_addr(&mac_addr[0], NULL);
+
+                        if (station_info_entry != NULL) {
+                            stats_status = queue_get_station_stats(station_info_entry->data, &stats);
+                        } else {
+                            stats_status = -1;
+                        }
+                    } else {
+                        stats_status = (queue_id <= 0xFFFF) ? queue_get_stats(queue_id, &stats) : -1;
+                    }
+
+                    if (stats_status != 0) {
+                        // The station or the queue has not been seen yet; this is not an error
+                        status = CMD_PARAM_WARNING;
+                        break;
+                    }
+
+                    resp_args_32[1] = Xil_Htonl(QUEUE_STATS_NUM_BINS);
+
+                    for (hist_idx = 0; hist_idx < 3; hist_idx++) {
+                        hist = hists[hist_idx];
+
+                        resp_args_32[resp_index++] = Xil_Htonl(hist->max);
+
+                        for (bin = 0; bin < QUEUE_STATS_NUM_BINS; bin++) {
+                            resp_args_32[resp_index++] = Xil_Htonl(hist->bins[bin]);
+                        }
+                    }
+                break;
+
+                case CMD_PARAM_NODE_QUEUE_STATS_RESET:
+                    queue_stats_reset_all();
+                break;
+
+                default:
+                    wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_node, "Unknown command for 0x%6x: %d\n", cmd_id, msg_cmd);
+                    status = CMD_PARAM_ERROR;
+                break;
+            }
+#else
+            wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_node, "Tx queue statistics not compiled (WLAN_SW_CONFIG_ENABLE_QUEUE_STATS)\n");
+
+            // Skip the status argument (filled in below)
+            resp_index++;
+
+            resp_args_32[resp_index++] = Xil_Htonl(0);
+
+            status = CMD_PARAM_ERROR;
+#endif
+
+            resp_args_32[0]    = Xil_Htonl(status);
+
+            resp_hdr->length  += (resp_index * sizeof(u32));
+            resp_hdr->num_args = resp_index;
+        }
+        break;
+
+
+        //---------------------------------------------------------------------
+        case CMDID_NODE_QUEUE_AQM: {
+            // Set / Get the AQM policy of a Tx queue, or reset its drop counters
+            //
+            // Message format:
+            //     cmd_args_32[0]      Command:  CMD_PARAM_WRITE_VAL, CMD_PARAM_READ_VAL or
+            //                             CMD_PARAM_NODE_QUEUE_AQM_RESET_COUNTS
+            //     cmd_args_32[1]      Queue ID
+            //     cmd_args_32[2]      Flags (QUEUE_AQM_FLAG_*)                  (CMD_PARAM_WRITE_VAL)
+            //     cmd_args_32[3]      Max length (packets; 0 = MAC application)  (CMD_PARAM_WRITE_VAL)
+            //     cmd_args_32[4]      Lifetime (usec)                            (CMD_PARAM_WRITE_VAL)
+            //     cmd_args_32[5]      CoDel target (usec; 0 = default)           (CMD_PARAM_WRITE_VAL)
+            //     cmd_args_32[6]      CoDel interval (usec; 0 = default)         (CMD_PARAM_WRITE_VAL)
+            //
+            // Response format:
+            //     resp_args_32[0]     Status
+            //     resp_args_32[1:5]   AQM policy of the queue (same order as cmd_args_32[2:6])
+            //     resp_args_32[6:9]   Number of dropped packets per reason (QUEUE_DROP_REASON_*)
+            //     resp_args_32[10]    CoDel dropping state
+            //     resp_args_32[11]    CoDel drop count
+            //
+            u32                        status   = CMD_PARAM_SUCCESS;
+            u32                        reason;
+            queue_aqm_config_t         config;
+            queue_aqm_t                aqm;
+            u32                        msg_cmd  = Xil_Ntohl(cmd_args_32[0]);
+            u32                        queue_id = Xil_Ntohl(cmd_args_32[1]);
+
+            // Skip the status argument (filled in below)
+            resp_index++;
+
+            // Queue IDs are u16 (see wlan_mac_queue.h)
+            if (queue_id > 0xFFFF) {
+                wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_node, "Invalid queue ID: %d\n", queue_id);
+                msg_cmd = CMD_PARAM_RSVD;
+                status  = CMD_PARAM_ERROR;
+            }
+
+            switch (msg_cmd) {
+                case CMD_PARAM_RSVD:
+                break;
+
+                case CMD_PARAM_WRITE_VAL:
+                    config.flags               = Xil_Ntohl(cmd_args_32[2]);
+                    config.max_length          = Xil_Ntohl(cmd_args_32[3]);
+                    config.lifetime_usec       = Xil_Ntohl(cmd_args_32[4]);
+                    config.codel_target_usec   = Xil_Ntohl(cmd_args_32[5]);
+                    config.codel_interval_usec = Xil_Ntohl(cmd_args_32[6]);
+
+                    if (queue_set_aqm_config(queue_id, &config) != 0) {
+                        wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_node, "Could not set the AQM policy of queue %d (flags = 0x%08x)\n", queue_id, config.flags);
+                        status = CMD_PARAM_ERROR;
+                    }
+                break;
+
+                case CMD_PARAM_READ_VAL:
+                break;
+
+                case CMD_PARAM_NODE_QUEUE_AQM_RESET_COUNTS:
+                    queue_reset_aqm_counts(queue_id);
+                break;
+
+                default:
+                    wlan_exp_printf(WLAN_EXP_PRINT_ERROR, print_type_node, "Unknown command for 0x%6x: %d\n", cmd_id, msg_cmd);
+                    status = CMD_PARAM_ERROR;
+                break;
+            }
+
+            // Return the AQM state of the queue
+            //     NOTE:  A queue that has not been used or configured has the default policy
+            //
+            if ((queue_id > 0xFFFF) || (queue_get_aqm(queue_id, &aqm) != 0)) {
+                bzero(&aqm, sizeof(queue_aqm_t));
+
+                aqm.config.codel_target_usec   = QUEUE_AQM_CODEL_TARGET_USEC_DEFAULT;
+                aqm.config.codel_interval_usec = QUEUE_AQM_CODEL_INTERVAL_USEC_DEFAULT;
+            }
+
+            resp_args_32[resp_index++] = Xil_Htonl(aqm.config.flags);
+            resp_args_32[resp_index++] = Xil_Htonl(aqm.config.max_length);
+            resp_args_32[resp_index++] = Xil_Htonl(aqm.config.lifetime_usec);
+            resp_args_32[resp_index++] = Xil_Htonl(aqm.config.codel_target_usec);
+            resp_args_32[resp_index++] = Xil_Htonl(aqm.config.codel_interval_usec);
+
+            for (reason = 0; reason < NUM_QUEUE_DROP_REASONS; reason++) {
+                resp_args_32[resp_index++] = Xil_Htonl(aqm.num_dropped[reason]);
+            }
+
+            resp_args_32[resp_index++] = Xil_Htonl(aqm.codel_dropping);
+            resp_args_32[resp_index++] = Xil_Htonl(aqm.codel_count);
+
+            resp_args_32[0]    = Xil_Htonl(status);
+
+            resp_hdr->length  += (resp_index * sizeof(u32));
+            resp_hdr->num_args = resp_index;
+        }
+        break;
+
+
 //-----------------------------------------------------------------------------
 // Scan Commands
 //-----------------------------------------------------------------------------
@@ -2640,6 +3327,46 @@ int process_node_cmd(int socket_index, void* from, cmd_resp* command, cmd_resp*
         break;
 
 
+        //---------------------------------------------------------------------
+        case CMDID_QUEUE_GET_BUFFER_INFO: {
+            // Get the occupancy of each Tx queue buffer size class
+            //
+            // Message format:
+            //     cmd_args_32[0]      Reserved
+            //
+            // Response format:
+            //     resp_args_32[0]     Number of buffer size classes (N)
+            //     resp_args_32[1:7N]  Per class (see queue_buffer_class_info_t):
+            //                             buffer_size, max_frame_len, num_total, num_free,
+            //                             min_free, num_fallback, num_failed
+            //
+            u32                        buffer_class;
+            queue_buffer_class_info_t  class_info;
+            interrupt_state_t          curr_interrupt_state;
+
+            resp_args_32[resp_index++] = Xil_Htonl(NUM_QUEUE_BUFFER_CLASSES);
+
+            for (buffer_class = 0; buffer_class < NUM_QUEUE_BUFFER_CLASSES; buffer_class++) {
+                // Get a consistent snapshot of the class
+                curr_interrupt_state = wlan_mac_high_interrupt_stop();
+                queue_get_class_info(buffer_class, &class_info);
+                wlan_mac_high_interrupt_restore_state(curr_interrupt_state);
+
+                resp_args_32[resp_index++] = Xil_Htonl(class_info.buffer_size);
+                resp_args_32[resp_index++] = Xil_Htonl(class_info.max_frame_len);
+                resp_args_32[resp_index++] = Xil_Htonl(class_info.num_total);
+                resp_args_32[resp_index++] = Xil_Htonl(class_info.num_free);
+                resp_args_32[resp_index++] = Xil_Htonl(class_info.min_free);
+                resp_args_32[resp_index++] = Xil_Htonl(class_info.num_fallback);
+                resp_args_32[resp_index++] = Xil_Htonl(class_info.num_failed);
+            }
+
+            resp_hdr->length  += (resp_index * sizeof(u32));
+            resp_hdr->num_args = resp_index;
+        }
+        break;
+
+
 //-----------------------------------------------------------------------------
 // Memory Access Commands - For developer use only
 //-----------------------------------------------------------------------------
@@ -3411,7 +4138,7 @@ void copy_station_info_to_dest(void* source, void* dest, u8* mac_addr) {
 
     // Fill in zeroed entry if source is NULL
     if (source == NULL) {
-        curr_source = wlan_mac_high_malloc(sizeof(station_info_t));
+        curr_source = wlan_mac_arena_alloc(sizeof(station_info_t));
 
         if (curr_source != NULL) {
             bzero(curr_source, sizeof(station_info_t));
@@ -3428,7 +4155,7 @@ void copy_station_info_to_dest(void* source, void* dest, u8* mac_addr) {
         wlan_exp_printf(WLAN_EXP_PRINT_WARNING, print_type_node, "Could not copy station_info to entry\n");
     }
 
-    // Free curr_source if source was NULL
+    // Return curr_source to the command arena if source was NULL
     if (source == NULL) {
         wlan_mac_high_free(curr_source);
     }
@@ -3463,7 +4190,7 @@ void copy_counts_txrx_to_dest(void* source, void* dest, u8* mac_addr) {
     // Fill in zeroed entry if source is NULL
     //   - All fields are zero except last_txrx_timestamp which is CMD_PARAM_NODE_TIME_RSVD_VAL_64
     if (source == NULL) {
-        curr_source = wlan_mac_high_malloc(sizeof(station_info_t));
+        curr_source = wlan_mac_arena_alloc(sizeof(station_info_t));
 
         if (curr_source != NULL) {
             bzero(curr_source, sizeof(station_info_t));
@@ -3490,7 +4217,7 @@ void copy_counts_txrx_to_dest(void* source, void* dest, u8* mac_addr) {
         wlan_exp_printf(WLAN_EXP_PRINT_WARNING, print_type_counts, "Could not copy counts_txrx to entry\n");
     }
 
-    // Free curr_source if source was NULL
+    // Return curr_source to the command arena if source was NULL
     if (source == NULL) {
         wlan_mac_high_free(curr_source);
     }
@@ -3498,6 +4225,207 @@ void copy_counts_txrx_to_dest(void* source, void* dest, u8* mac_addr) {
 
 
 
+#if WLAN_SW_CONFIG_ENABLE_TXRX_COUNTS
+//
+// Tx/Rx Counts Delta helpers
+//     - counts_txrx_delta_flags()      - Which of a station's counts are in the delta
+//     - counts_txrx_delta_entry_size() - Size of a delta entry with the given flags
+//
+u32 counts_txrx_delta_flags(station_info_t* station_info, u32 since_gen, u32 snapshot_gen) {
+    u32 flags = 0;
+
+    if (since_gen == CMD_PARAM_COUNTS_DELTA_GEN_ALL) {
+        return (CMD_PARAM_COUNTS_DELTA_FLAG_DATA | CMD_PARAM_COUNTS_DELTA_FLAG_MGMT);
+    }
+
+    // Select generations in (since_gen, snapshot_gen] using serial number arithmetic
+    if (((s32)(station_info->txrx_counts_data_gen - since_gen) > 0) &&
+        ((s32)(station_info->txrx_counts_data_gen - snapshot_gen) <= 0)) {
+        flags |= CMD_PARAM_COUNTS_DELTA_FLAG_DATA;
+    }
+
+    if (((s32)(station_info->txrx_counts_mgmt_gen - since_gen) > 0) &&
+        ((s32)(station_info->txrx_counts_mgmt_gen - snapshot_gen) <= 0)) {
+        flags |= CMD_PARAM_COUNTS_DELTA_FLAG_MGMT;
+    }
+
+    return flags;
+}
+
+
+u32 counts_txrx_delta_entry_size(u32 flags) {
+    u32 size = sizeof(wlan_exp_txrx_counts_delta_entry_t);
+
+    if (flags & CMD_PARAM_COUNTS_DELTA_FLAG_DATA) { size += sizeof(txrx_counts_sub_t); }
+    if (flags & CMD_PARAM_COUNTS_DELTA_FLAG_MGMT) { size += sizeof(txrx_counts_sub_t); }
+
+    return size;
+}
+
+
+/*****************************************************************************/
+/**
+ * Tx/Rx Counts Delta
+ *
+ * Returns the Tx/Rx counts that changed since the counts generation given by the
+ * host.  Only the data / mgmt sub-structures that changed are sent for each station.
+ *
+ * The delta is built in two passes over the station list so that the total size is
+ * known when the first packet is sent.  The generation is sampled before the first
+ * pass and only counts updated at or before that generation are sent, so any update
+ * that occurs while the delta is being sent is picked up by the next delta.  Because
+ * the set of selected counts can only shrink between the two passes, the second
+ * pass pads the buffer with empty entries if needed.
+ *
+ * @param   socket_index     -- Index of socket to send data
+ * @param   from             -- Socket address structure of host from which command was received
+ * @param   response         -- Pointer to Response
+ * @param   cmd_args_32      -- Command arguments (network byte order)
+ * @param   resp_hdr         -- Response header
+ * @param   resp_args_32     -- Response arguments
+ * @param   max_resp_len     -- Maximum number of u32 words allowed in response
+ *
+ * @return  u32              -- RESP_SENT
+ *
+ *****************************************************************************/
+u32 process_counts_txrx_delta(int socket_index, void* from, cmd_resp* response,
+                              u32* cmd_args_32, cmd_resp_hdr* resp_hdr, u32* resp_args_32,
+                              u32 max_resp_len) {
+
+    u32 since_gen = Xil_Ntohl(cmd_args_32[4]);
+    u32 snapshot_gen;
+
+    dl_list* source_list = station_info_get_list();
+    dl_entry* curr_entry;
+    station_info_t* curr_station_info;
+    int iter;
+
+    u32 flags;
+    u32 entry_size;
+    u32 num_entries;
+    u32 size;
+    u32 bytes_per_pkt;
+    u32 curr_index;
+    u32 pkt_bytes;
+
+    u8* pkt_data = (u8*)(&resp_args_32[WLAN_EXP_BUFFER_NUM_ARGS]);
+    wlan_exp_txrx_counts_delta_hdr_t* delta_hdr;
+    wlan_exp_txrx_counts_delta_entry_t* delta_entry;
+
+    bytes_per_pkt = (max_resp_len * sizeof(u32)) - WLAN_EXP_BUFFER_HEADER_SIZE;
+
+    // Pass 1: Size the delta
+    snapshot_gen = station_info_get_txrx_counts_gen();
+    num_entries = 0;
+    size = sizeof(wlan_exp_txrx_counts_delta_hdr_t);
+
+    iter = source_list->length;
+    curr_entry = source_list->first;
+
+    while ((curr_entry != NULL) && (iter-- > 0)) {
+        flags = counts_txrx_delta_flags((station_info_t*)(curr_entry->data), since_gen, snapshot_gen);
+
+        if (flags) {
+            num_entries++;
+            size += counts_txrx_delta_entry_size(flags);
+        }
+        curr_entry = dl_entry_next(curr_entry);
+    }
+
+    wlan_exp_printf(WLAN_EXP_PRINT_INFO, print_type_counts, "Getting counts delta %d -> %d: %d entries (%d bytes)\n",
+                    since_gen, snapshot_gen, num_entries, size);
+
+    // Set response args that do not change per packet
+    resp_args_32[0] = cmd_args_32[0];
+    resp_args_32[1] = cmd_args_32[1];
+    resp_hdr->num_args = WLAN_EXP_BUFFER_NUM_ARGS;
+
+    // The delta header always starts the first packet
+    delta_hdr = (wlan_exp_txrx_counts_delta_hdr_t*)(pkt_data);
+    delta_hdr->timestamp = get_system_time_usec();
+    delta_hdr->generation = snapshot_gen;
+    delta_hdr->num_entries = num_entries;
+
+    curr_index = 0;
+    pkt_bytes = sizeof(wlan_exp_txrx_counts_delta_hdr_t);
+
+    // Pass 2: Fill and send packets; entries are never split across packets
+    iter = source_list->length;
+    curr_entry = source_list->first;
+
+    while ((curr_entry != NULL) && (iter-- > 0)) {
+        curr_station_info = (station_info_t*)(curr_entry->data);
+        curr_entry = dl_entry_next(curr_entry);
+
+        flags = counts_txrx_delta_flags(curr_station_info, since_gen, snapshot_gen);
+        if (flags == 0) { continue; }
+
+        entry_size = counts_txrx_delta_entry_size(flags);
+
+        // Station list changed since pass 1; skipped counts will be in the next delta
+        if ((curr_index + pkt_bytes + entry_size) > size) { continue; }
+
+        if ((pkt_bytes + entry_size) > bytes_per_pkt) {
+            resp_args_32[2] = Xil_Htonl(size - curr_index);
+            resp_args_32[3] = Xil_Htonl(curr_index);
+            resp_args_32[4] = Xil_Htonl(pkt_bytes);
+            resp_hdr->length = WLAN_EXP_BUFFER_HEADER_SIZE + pkt_bytes;
+
+            send_early_resp(socket_index, from, response->header, response->buffer);
+
+            curr_index += pkt_bytes;
+            pkt_bytes = 0;
+        }
+
+        delta_entry = (wlan_exp_txrx_counts_delta_entry_t*)(&pkt_data[pkt_bytes]);
+        memcpy(delta_entry->addr, curr_station_info->addr, MAC_ADDR_LEN);
+        delta_entry->flags = flags;
+        delta_entry->reserved = 0;
+        pkt_bytes += sizeof(wlan_exp_txrx_counts_delta_entry_t);
+
+        if (flags & CMD_PARAM_COUNTS_DELTA_FLAG_DATA) {
+            memcpy(&pkt_data[pkt_bytes], &(curr_station_info->txrx_counts.data), sizeof(txrx_counts_sub_t));
+            pkt_bytes += sizeof(txrx_counts_sub_t);
+        }
+
+        if (flags & CMD_PARAM_COUNTS_DELTA_FLAG_MGMT) {
+            memcpy(&pkt_data[pkt_bytes], &(curr_station_info->txrx_counts.mgmt), sizeof(txrx_counts_sub_t));
+            pkt_bytes += sizeof(txrx_counts_sub_t);
+        }
+    }
+
+    // Pad with empty entries to the size advertised in the first packet
+    while ((curr_index + pkt_bytes) < size) {
+        if ((pkt_bytes + sizeof(wlan_exp_txrx_counts_delta_entry_t)) > bytes_per_pkt) {
+            resp_args_32[2] = Xil_Htonl(size - curr_index);
+            resp_args_32[3] = Xil_Htonl(curr_index);
+            resp_args_32[4] = Xil_Htonl(pkt_bytes);
+            resp_hdr->length = WLAN_EXP_BUFFER_HEADER_SIZE + pkt_bytes;
+
+            send_early_resp(socket_index, from, response->header, response->buffer);
+
+            curr_index += pkt_bytes;
+            pkt_bytes = 0;
+        }
+
+        bzero(&pkt_data[pkt_bytes], sizeof(wlan_exp_txrx_counts_delta_entry_t));
+        pkt_bytes += sizeof(wlan_exp_txrx_counts_delta_entry_t);
+    }
+
+    // Send the last packet
+    resp_args_32[2] = Xil_Htonl(size - curr_index);
+    resp_args_32[3] = Xil_Htonl(curr_index);
+    resp_args_32[4] = Xil_Htonl(pkt_bytes);
+    resp_hdr->length = WLAN_EXP_BUFFER_HEADER_SIZE + pkt_bytes;
+
+    send_early_resp(socket_index, from, response->header, response->buffer);
+
+    return RESP_SENT;
+}
+#endif //WLAN_SW_CONFIG_ENABLE_TXRX_COUNTS
+
+
+
 //
 // Do not need separate find_bss_info function.  Currently exists in wlan_mac_bss_info.c
 //
@@ -3517,7 +4445,7 @@ void copy_bss_info_to_dest(void* source, void* dest, u8* mac_addr) {
 
     // Fill in zeroed entry if source is NULL
     if (source == NULL) {
-        curr_source = wlan_mac_high_malloc(sizeof(network_info_t));
+        curr_source = wlan_mac_arena_alloc(sizeof(network_info_t));
 
         if (curr_source != NULL) {
             bzero(curr_source, sizeof(network_info_t));
@@ -3536,7 +4464,7 @@ void copy_bss_info_to_dest(void* source, void* dest, u8* mac_addr) {
         wlan_exp_printf(WLAN_EXP_PRINT_INFO, print_type_node, "Could not copy network_info to entry\n");
     }
 
-    // Free curr_source if source was NULL
+    // Return curr_source to the command arena if source was NULL
     if (source == NULL) {
         wlan_mac_high_free(curr_source);
     }
@@ -26,6 +26,7 @@
 
 // WLAN includes
 #include "wlan_mac_high.h"
+#include "wlan_mac_cdma.h"
 #include "wlan_platform_high.h"
 #include "wlan_platform_common.h"
 
@@ -522,6 +523,7 @@ void transport_send_async(u32 eth_dev_num, u8* payload, u32 length) {
 
     u32 initial_length;
     u32 packet_length;
+    u32 copy_job_id;
 
     // Get variables from the async command / response structure
     wlan_exp_ip_udp_buffer* buffer = (wlan_exp_ip_udp_buffer *) eth_devices[eth_dev_num].async_cmd_resp.buffer;
@@ -536,6 +538,10 @@ void transport_send_async(u32 eth_dev_num, u8* payload, u32 length) {
     // Makes sure packet stays under the maximum packet size
     if (packet_length < WLAN_EXP_TX_ASYNC_PACKET_BUFFER_SIZE) {
 
+        // Populate the buffer with the payload
+        //     The copy runs while the headers are updated
+        copy_job_id = wlan_mac_high_cdma_submit_transfer(payload_dest, (void *) payload, length);
+
         // Update the command header size
         cmd_header->length = length;
 
@@ -543,8 +549,8 @@ void transport_send_async(u32 eth_dev_num, u8* payload, u32 length) {
         buffer->length    += length;
         buffer->size      += length;
 
-        // Populate the buffer with the payload
-        wlan_mac_high_cdma_start_transfer((void *) payload, payload_dest, length);
+        // Wait for the payload before the buffer is sent
+        wlan_mac_cdma_wait(copy_job_id);
 
         // Send the command
         transport_send(eth_devices[eth_dev_num].socket_async, &eth_devices[eth_dev_num].async_sockaddr, &buffer, 0x1);
@@ -23,6 +23,7 @@
 #include "wlan_mac_dl_list.h"
 #include "wlan_mac_high.h"
 #include "wlan_mac_network_info.h"
+#include "wlan_mac_pool.h"
 
 
 /*************************** Constant Definitions ****************************/
@@ -129,13 +130,13 @@ int wlan_mac_addr_filter_add(u8* mask, u8* compare) {
     dl_entry* entry;
 
     // Allocate memory for the entry and the white-list range
-    entry = wlan_mac_high_malloc(sizeof(dl_entry));
+    entry = wlan_mac_pool_alloc(MEM_POOL_DL_ENTRY);
 
     if (entry == NULL) {
         return -1;
     }
 
-    range = wlan_mac_high_malloc(sizeof(whitelist_range));
+    range = wlan_mac_pool_alloc(MEM_POOL_ADDR_RANGE);
 
     if (range == NULL) {
         wlan_mac_high_free(entry);
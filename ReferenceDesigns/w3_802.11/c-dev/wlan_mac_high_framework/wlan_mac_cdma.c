@@ -0,0 +1,439 @@
+/** @file wlan_mac_cdma.c
+ *  @brief Central DMA Job Queue
+ *
+ *  This contains code for the queue of memory copies that CPU High passes to
+ *  the central DMA (CDMA) core.
+ *
+ *  @copyright Copyright 2014-2017, Mango Communications. All rights reserved.
+ *          Distributed under the Mango Communications Reference Design License
+ *              See LICENSE.txt included in the design archive or
+ *              at http://mangocomm.com/802.11/license
+ *
+ *  This file is part of the Mango 802.11 Reference Design (https://mangocomm.com/802.11)
+ */
+
+/***************************** Include Files *********************************/
+
+#include "wlan_mac_high_sw_config.h"
+
+#include "stdio.h"
+#include "string.h"
+#include "xil_types.h"
+#include "xintc.h"
+#include "xaxicdma.h"
+
+#include "wlan_mac_common.h"
+#include "wlan_platform_high.h"
+#include "wlan_mac_high.h"
+#include "wlan_mac_cdma.h"
+#include "wlan_mac_dprint.h"
+
+
+/*************************** Constant Definitions ****************************/
+
+#define CDMA_JOB_NEXT(idx)                                 (((idx) + 1) & (CDMA_JOB_QUEUE_LEN - 1))
+
+// Internal job flags
+#define CDMA_JOB_FLAGS_MEMCPY                              0x80000000   ///< Copy with memcpy() (address in the DLMB)
+
+
+/*************************** Variable Definitions ****************************/
+
+extern platform_high_dev_info_t platform_high_dev_info;
+
+XAxiCdma                cdma_inst;               ///< Central DMA instance
+
+static cdma_job_t       cdma_job_queue[CDMA_JOB_QUEUE_LEN];
+
+//
+// The jobs between the tail and the head of the queue are in use:
+//     - [tail, active):  Finished jobs waiting for their callback in main context
+//     - [active, head):  Jobs waiting for the CDMA core (the job at active is running
+//                        if cdma_job_running is set)
+//
+static volatile u32     cdma_job_head;           ///< Index of the next empty job
+static volatile u32     cdma_job_active;         ///< Index of the oldest job that is not finished
+static volatile u32     cdma_job_tail;           ///< Index of the oldest job that is not released
+static volatile u8      cdma_job_running;        ///< Has the job at cdma_job_active been started?
+
+static volatile u32     cdma_last_id;            ///< ID of the most recently submitted job
+static volatile u32     cdma_done_id;            ///< ID of the most recently finished job
+
+
+/*************************** Functions Prototypes ****************************/
+
+void cdma_service();
+void cdma_job_finish();
+int  cdma_addr_in_dlmb(void* addr);
+void cdma_interrupt_handler(void* callback_ref);
+
+
+/******************************** Functions **********************************/
+
+/*****************************************************************************/
+/**
+ * Initialize the CDMA core and the job queue
+ *
+ * The CDMA interrupt is disabled until wlan_mac_cdma_setup_interrupt() is called.
+ *
+ * @param   dev_id           - Device ID of the CDMA core
+ *
+ * @return  int              - XST_SUCCESS or XST_FAILURE
+ *
+ *****************************************************************************/
+int wlan_mac_cdma_init(u32 dev_id){
+    int               status;
+    XAxiCdma_Config*  cdma_cfg_ptr;
+
+    cdma_job_head    = 0;
+    cdma_job_active  = 0;
+    cdma_job_tail    = 0;
+    cdma_job_running = 0;
+    cdma_last_id     = CDMA_JOB_ID_INVALID;
+    cdma_done_id     = CDMA_JOB_ID_INVALID;
+
+    cdma_cfg_ptr = XAxiCdma_LookupConfig(dev_id);
+    status       = XAxiCdma_CfgInitialize(&cdma_inst, cdma_cfg_ptr, cdma_cfg_ptr->BaseAddress);
+
+    if (status != XST_SUCCESS) {
+        wlan_printf(PL_ERROR, "ERROR: Could not initialize CDMA: %d\n", status);
+    }
+
+    XAxiCdma_IntrDisable(&cdma_inst, XAXICDMA_XR_IRQ_ALL_MASK);
+
+    return status;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Set up the CDMA interrupt
+ *
+ * If the platform does not connect the CDMA interrupt (PLATFORM_INT_ID_NONE), the
+ * queue only advances when jobs are submitted or waited on and in wlan_mac_cdma_poll().
+ *
+ * @param   intc             - Pointer to instance of interrupt controller
+ * @param   int_id           - Interrupt ID of the CDMA core
+ *
+ * @return  int              - Status of the attempt to connect the interrupt
+ *
+ *****************************************************************************/
+int wlan_mac_cdma_setup_interrupt(XIntc* intc, u32 int_id){
+    int status;
+
+    if (int_id == PLATFORM_INT_ID_NONE) {
+        return XST_SUCCESS;
+    }
+
+    status = XIntc_Connect(intc, int_id, (XInterruptHandler)cdma_interrupt_handler, &cdma_inst);
+
+    if (status == XST_SUCCESS) {
+        XIntc_Enable(intc, int_id);
+        XAxiCdma_IntrEnable(&cdma_inst, (XAXICDMA_XR_IRQ_IOC_MASK | XAXICDMA_XR_IRQ_ERROR_MASK));
+    }
+
+    return status;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Submit a copy to the CDMA job queue
+ *
+ * The copy starts as soon as the jobs submitted before it are finished.  This
+ * function only blocks if the queue is full.
+ *
+ * @param   dest             - Pointer to destination address where bytes should be copied
+ * @param   src              - Pointer to source address from where bytes should be copied
+ * @param   size             - Number of bytes that should be copied
+ * @param   callback         - Function called as callback(callback_arg) once the copy is
+ *                             finished (NULL for none)
+ * @param   callback_arg     - Argument of the callback
+ * @param   flags            - CDMA_JOB_FLAGS_* (CDMA_JOB_FLAGS_CALLBACK_MAIN to call the
+ *                             callback in main context)
+ *
+ * @return  u32              - ID of the job for wlan_mac_cdma_wait()
+ *                             CDMA_JOB_ID_INVALID if the job could not be submitted
+ *
+ * @note    Addresses in the DLMB are not accessible to the CDMA core.  These jobs are
+ *          copied with memcpy() in queue order.
+ *
+ *****************************************************************************/
+u32 wlan_mac_cdma_submit(void* dest, void* src, u32 size, function_ptr_t callback, void* callback_arg, u32 flags){
+    interrupt_state_t  prev_interrupt_state;
+    cdma_job_t*        job;
+    u32                job_id;
+
+    if (size == 0) {
+        xil_printf("CDMA Error: size argument must be > 0\n");
+        return CDMA_JOB_ID_INVALID;
+    }
+
+    flags &= ~CDMA_JOB_FLAGS_MEMCPY;
+
+    if (cdma_addr_in_dlmb(src) || cdma_addr_in_dlmb(dest)) {
+        wlan_dprintf(PL_ERROR, "CDMA Error: source and destination addresses must not located in the DLMB. Using memcpy instead. memcpy(0x%08x,0x%08x,%d)\n", dest, src, size);
+        flags |= CDMA_JOB_FLAGS_MEMCPY;
+    }
+
+    // Wait for an empty job
+    //     Interrupts are only stopped while the queue is checked, so they are not held off
+    //     for the whole wait
+    while (1) {
+        prev_interrupt_state = wlan_mac_high_interrupt_stop();
+
+        cdma_service();
+
+        if (CDMA_JOB_NEXT(cdma_job_head) != cdma_job_tail) {
+            break;
+        }
+
+        if (cdma_job_active != cdma_job_tail) {
+            // The queue is full of finished jobs waiting for wlan_mac_cdma_poll()
+            wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+            wlan_dprintf(PL_ERROR, "CDMA Error: job queue full\n");
+            return CDMA_JOB_ID_INVALID;
+        }
+
+        wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+    }
+
+    // Job IDs skip CDMA_JOB_ID_INVALID when they wrap
+    job_id = cdma_last_id + 1;
+    if (job_id == CDMA_JOB_ID_INVALID) {
+        job_id++;
+    }
+
+    job               = &(cdma_job_queue[cdma_job_head]);
+    job->dest         = dest;
+    job->src          = src;
+    job->size         = size;
+    job->id           = job_id;
+    job->flags        = flags;
+    job->callback     = callback;
+    job->callback_arg = callback_arg;
+
+    cdma_last_id      = job_id;
+    cdma_job_head     = CDMA_JOB_NEXT(cdma_job_head);
+
+    cdma_service();
+
+    wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+
+    return job_id;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Wait for a CDMA job
+ *
+ * Blocks until the job and all jobs submitted before it are finished.  Callbacks
+ * in main context are not called (see wlan_mac_cdma_poll()).
+ *
+ * @param   job_id           - ID returned by wlan_mac_cdma_submit()
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_cdma_wait(u32 job_id){
+    interrupt_state_t prev_interrupt_state;
+
+    if (job_id == CDMA_JOB_ID_INVALID) {
+        return;
+    }
+
+    // Interrupts are only stopped while the queue is advanced, so they are not held off
+    // for the whole wait
+    while ((s32)(job_id - cdma_done_id) > 0) {
+        prev_interrupt_state = wlan_mac_high_interrupt_stop();
+        cdma_service();
+        wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Wait for all CDMA jobs
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_cdma_wait_all(){
+    wlan_mac_cdma_wait(cdma_last_id);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Poll the CDMA job queue
+ *
+ * Starts the next job if the CDMA core is idle and calls the callbacks of the
+ * finished jobs that requested main context.  This function must only be called
+ * from the main loop.
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_cdma_poll(){
+    interrupt_state_t  prev_interrupt_state;
+    cdma_job_t*        job;
+    function_ptr_t     callback;
+    void*              callback_arg;
+
+    prev_interrupt_state = wlan_mac_high_interrupt_stop();
+
+    cdma_service();
+
+    while (cdma_job_tail != cdma_job_active) {
+        job          = &(cdma_job_queue[cdma_job_tail]);
+        callback     = job->callback;
+        callback_arg = job->callback_arg;
+
+        job->callback = NULL;
+        cdma_job_tail = CDMA_JOB_NEXT(cdma_job_tail);
+
+        if (callback != NULL) {
+            wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+            callback(callback_arg);
+            prev_interrupt_state = wlan_mac_high_interrupt_stop();
+        }
+    }
+
+    wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Advance the CDMA job queue
+ *
+ * Finishes the running job if the CDMA core is idle and starts the next job.
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ * @note    Must be called with interrupts stopped (or from the CDMA interrupt).
+ *
+ *****************************************************************************/
+void cdma_service(){
+    cdma_job_t* job;
+    int         status;
+
+    while (1) {
+        if (cdma_job_running) {
+            if (XAxiCdma_IsBusy(&cdma_inst)) {
+                return;
+            }
+            cdma_job_finish();
+        }
+
+        if (cdma_job_active == cdma_job_head) {
+            return;
+        }
+
+        job = &(cdma_job_queue[cdma_job_active]);
+
+        if (job->flags & CDMA_JOB_FLAGS_MEMCPY) {
+            memcpy(job->dest, job->src, job->size);
+            cdma_job_finish();
+
+        } else {
+            status = XAxiCdma_SimpleTransfer(&cdma_inst, (u32)job->src, (u32)job->dest, job->size, NULL, NULL);
+
+            if (status == XST_SUCCESS) {
+                cdma_job_running = 1;
+            } else {
+                wlan_dprintf(PL_ERROR, "CDMA Error: code %d, (0x%08x,0x%08x,%d)\n", status, job->dest, job->src, job->size);
+                cdma_job_finish();
+            }
+        }
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Finish the oldest job of the CDMA job queue
+ *
+ * Calls the callback of the job unless it requested main context and releases
+ * the finished jobs that do not wait for wlan_mac_cdma_poll().
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void cdma_job_finish(){
+    cdma_job_t*     job          = &(cdma_job_queue[cdma_job_active]);
+    function_ptr_t  callback     = NULL;
+    void*           callback_arg = job->callback_arg;
+
+    cdma_job_running = 0;
+    cdma_done_id     = job->id;
+    cdma_job_active  = CDMA_JOB_NEXT(cdma_job_active);
+
+    if ((job->callback != NULL) && ((job->flags & CDMA_JOB_FLAGS_CALLBACK_MAIN) == 0)) {
+        callback      = job->callback;
+        job->callback = NULL;
+    }
+
+    // Release finished jobs
+    while ((cdma_job_tail != cdma_job_active) && (cdma_job_queue[cdma_job_tail].callback == NULL)) {
+        cdma_job_tail = CDMA_JOB_NEXT(cdma_job_tail);
+    }
+
+    // Call the callback after the queue is consistent, so it can submit new jobs
+    if (callback != NULL) {
+        callback(callback_arg);
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ * CDMA interrupt handler
+ *
+ * @param   callback_ref     - Pointer to CDMA instance
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void cdma_interrupt_handler(void* callback_ref){
+    XAxiCdma*  cdma_ptr = (XAxiCdma*)callback_ref;
+    u32        irq_mask = XAxiCdma_IntrGetIrq(cdma_ptr);
+
+    XAxiCdma_IntrAckIrq(cdma_ptr, irq_mask);
+
+    if (irq_mask & XAXICDMA_XR_IRQ_ERROR_MASK) {
+        wlan_dprintf(PL_ERROR, "CDMA Error: interrupt status 0x%08x\n", irq_mask);
+    }
+
+    cdma_service();
+}
+
+
+
+int cdma_addr_in_dlmb(void* addr){
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wtype-limits"
+    // The -Wtype-limits flag catches the below check when the base address is 0 since the
+    // evaluation will always be true. Nevertheless, this check is useful if the memory map changes.
+    return (((u32)addr >= platform_high_dev_info.dlmb_baseaddr) &&
+            ((u32)addr <= CALC_HIGH_ADDR(platform_high_dev_info.dlmb_baseaddr, platform_high_dev_info.dlmb_size)));
+#pragma GCC diagnostic pop
+}
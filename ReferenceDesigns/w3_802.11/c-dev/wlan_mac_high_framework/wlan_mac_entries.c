@@ -38,6 +38,8 @@
 #include "wlan_mac_802_11_defs.h"
 #include "wlan_platform_common.h"
 #include "wlan_mac_packet_types.h"
+#include "wlan_mac_queue.h"
+#include "wlan_mac_cdma.h"
 
 // WLAN Exp includes
 #include "wlan_exp_common.h"
@@ -60,6 +62,7 @@
 
 static u8 log_entry_en_mask;
 static u32 system_time_id;
+static u32 tx_trace_id;
 
 extern volatile s8  low_param_tx_ctrl_pow;
 
@@ -89,6 +92,9 @@ u32 mac_payload_log_len;
 
 void wlan_exp_log_get_txrx_entry_sizes( u32 type, u16 packet_payload_size, u32* min_log_len, u32* entry_size, u32* payload_size );
 
+tx_trace_entry* wlan_exp_log_create_tx_trace_entry(tx_frame_info_t* tx_frame_info);
+rx_trace_entry* wlan_exp_log_create_rx_trace_entry(rx_frame_info_t* rx_frame_info);
+
 
 
 /******************************** Functions **********************************/
@@ -100,6 +106,7 @@ void wlan_exp_log_get_txrx_entry_sizes( u32 type, u16 packet_payload_size, u32*
  * @param   mask             - Enable Mask.  Bitwise OR of:
  *                             - ENTRY_EN_MASK_TXRX_CTRL
  *                             - ENTRY_EN_MASK_TXRX_MPDU
+ *                             - ENTRY_EN_MASK_TXRX_TRACE
  *
  * @return  None
  *
@@ -199,6 +206,191 @@ void* wlan_exp_log_create_entry(u16 entry_type_id, u16 entry_size){
 
 
 
+/*****************************************************************************/
+/**
+ * Reserve / release log space for a batch of Tx reports
+ *
+ * Reserves enough space for the entries created while processing num_tx_reports
+ * Tx reports from CPU Low:  up to two TX_LOW entries (RTS and MPDU) per report
+ * plus the TX_HIGH and TX_TRACE entries of the MPDUs that are done.  The entries
+ * are then taken from the reserved space without the full allocation procedure.
+ * The space that is not used is returned to the log by
+ * wlan_exp_log_release_tx_entries().
+ *
+ * @param   num_tx_reports   - Number of Tx reports in the batch
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_exp_log_reserve_tx_entries(u32 num_tx_reports){
+    u32 report_size;
+
+    report_size  = 2 * (sizeof(entry_header) + sizeof(tx_low_entry) + sizeof(ltg_packet_id_t));
+    report_size += sizeof(entry_header) + sizeof(tx_high_entry) + mac_payload_log_len;
+
+    if(log_entry_en_mask & ENTRY_EN_MASK_TXRX_TRACE){
+        report_size += sizeof(entry_header) + sizeof(tx_trace_entry);
+    }
+
+    event_log_reserve(num_tx_reports * report_size);
+}
+
+void wlan_exp_log_release_tx_entries(){
+    event_log_release_reservation();
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Start the latency trace of a packet
+ *
+ * Called when a packet enters the MAC (Ethernet reception or LTG event), before
+ * it is enqueued.  If latency tracing is enabled, the packet is given a new trace
+ * ID and the current time is recorded as its ingress time.  The trace ID is
+ * carried through the Tx packet buffer and logged in the TX_HIGH and TX_TRACE
+ * entries of the packet.
+ *
+ * @param   tx_queue_buffer  - Pointer to the queue buffer of the packet
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_exp_log_start_tx_trace(tx_queue_buffer_t* tx_queue_buffer){
+
+    if(log_entry_en_mask & ENTRY_EN_MASK_TXRX_TRACE){
+        // Trace ID 0 means "not traced"
+        if(++tx_trace_id == 0){
+            tx_trace_id = 1;
+        }
+
+        tx_queue_buffer->trace_id          = tx_trace_id;
+        tx_queue_buffer->timestamp_ingress = get_mac_time_usec();
+    } else {
+        tx_queue_buffer->trace_id          = 0;
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Create a TX Trace Log entry
+ *
+ * @param   tx_frame_info    - Pointer to frame info of the traced packet
+ *
+ * @return  tx_trace_entry * - Pointer to the tx_trace_entry log entry
+ *                               NOTE: This can be NULL if an entry was not allocated
+ *
+ *****************************************************************************/
+tx_trace_entry* wlan_exp_log_create_tx_trace_entry(tx_frame_info_t* tx_frame_info){
+
+    tx_trace_entry* tx_trace_event_log_entry;
+    u64 timestamp_enqueue = tx_frame_info->queue_info.enqueue_timestamp;
+    u64 timestamp_dequeue = timestamp_enqueue + tx_frame_info->delay_dequeue;
+
+    tx_trace_event_log_entry = (tx_trace_entry *)wlan_exp_log_create_entry(ENTRY_TYPE_TX_TRACE, sizeof(tx_trace_entry));
+
+    if(tx_trace_event_log_entry != NULL){
+        tx_trace_event_log_entry->timestamp_ingress = timestamp_enqueue - tx_frame_info->delay_ingress;
+        tx_trace_event_log_entry->unique_seq        = tx_frame_info->unique_seq;
+        tx_trace_event_log_entry->trace_id          = tx_frame_info->trace_id;
+        tx_trace_event_log_entry->delay_enqueue     = tx_frame_info->delay_ingress;
+        tx_trace_event_log_entry->delay_dequeue     = tx_frame_info->delay_dequeue;
+        tx_trace_event_log_entry->delay_accept      = (u32)(tx_frame_info->timestamp_accept - timestamp_dequeue);
+        tx_trace_event_log_entry->delay_done        = (u32)(tx_frame_info->timestamp_done - tx_frame_info->timestamp_accept);
+        tx_trace_event_log_entry->num_tx            = tx_frame_info->num_tx_attempts;
+        tx_trace_event_log_entry->tx_result         = tx_frame_info->tx_result;
+        tx_trace_event_log_entry->reserved0         = 0;
+    }
+
+    return tx_trace_event_log_entry;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Create a RX Trace Log entry
+ *
+ * @param   rx_frame_info    - Pointer to frame info of the received data packet
+ *
+ * @return  rx_trace_entry * - Pointer to the rx_trace_entry log entry
+ *                               NOTE: This can be NULL if an entry was not allocated
+ *
+ *****************************************************************************/
+rx_trace_entry* wlan_exp_log_create_rx_trace_entry(rx_frame_info_t* rx_frame_info){
+
+    rx_trace_entry* rx_trace_event_log_entry;
+    mac_header_80211* rx_80211_header = (mac_header_80211*)((u8*)rx_frame_info + PHY_RX_PKT_BUF_MPDU_OFFSET);
+
+    rx_trace_event_log_entry = (rx_trace_entry *)wlan_exp_log_create_entry(ENTRY_TYPE_RX_TRACE, sizeof(rx_trace_entry));
+
+    if(rx_trace_event_log_entry != NULL){
+        rx_trace_event_log_entry->timestamp        = rx_frame_info->timestamp;
+        rx_trace_event_log_entry->delay_rx_process = (u32)(get_mac_time_usec() - rx_frame_info->timestamp);
+        rx_trace_event_log_entry->mac_seq          = ((rx_80211_header->sequence_control) >> 4) & 0xFFF;
+        rx_trace_event_log_entry->length           = rx_frame_info->phy_details.length;
+        rx_trace_event_log_entry->reserved0        = 0;
+
+        memcpy(rx_trace_event_log_entry->addr2, rx_80211_header->address_2, MAC_ADDR_LEN);
+    }
+
+    return rx_trace_event_log_entry;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Create a TX Drop Log entry
+ *
+ * @param   tx_queue_buffer  - Pointer to the Tx queue buffer of the dropped packet
+ * @param   reason           - Reason of the drop (QUEUE_DROP_REASON_*)
+ * @param   queue_occupancy  - Number of packets in the queue after the drop
+ * @param   num_dropped      - Number of packets the queue has dropped for this reason
+ *
+ * @return  tx_drop_entry *  - Pointer to the tx_drop_entry log entry
+ *                               NOTE: This can be NULL if an entry was not allocated
+ *
+ *****************************************************************************/
+tx_drop_entry* wlan_exp_log_create_tx_drop_entry(tx_queue_buffer_t* tx_queue_buffer, u8 reason, u16 queue_occupancy, u32 num_dropped){
+
+    tx_drop_entry* tx_drop_event_log_entry = NULL;
+    mac_header_80211* tx_80211_header = (mac_header_80211*)(tx_queue_buffer->frame);
+    u64 timestamp;
+
+    // Drops are logged with the MPDUs
+    if((log_entry_en_mask & ENTRY_EN_MASK_TXRX_MPDU) == 0){
+        return NULL;
+    }
+
+    tx_drop_event_log_entry = (tx_drop_entry *)wlan_exp_log_create_entry(ENTRY_TYPE_TX_DROP, sizeof(tx_drop_entry));
+
+    if(tx_drop_event_log_entry != NULL){
+        timestamp = get_mac_time_usec();
+
+        tx_drop_event_log_entry->timestamp         = timestamp;
+        tx_drop_event_log_entry->delay_drop        = (timestamp > tx_queue_buffer->queue_info.enqueue_timestamp) ?
+                                                         (u32)(timestamp - tx_queue_buffer->queue_info.enqueue_timestamp) : 0;
+        tx_drop_event_log_entry->trace_id          = tx_queue_buffer->trace_id;
+        tx_drop_event_log_entry->num_dropped       = num_dropped;
+        tx_drop_event_log_entry->queue_id          = tx_queue_buffer->queue_info.id;
+        tx_drop_event_log_entry->queue_occupancy   = queue_occupancy;
+        tx_drop_event_log_entry->length            = tx_queue_buffer->length;
+        tx_drop_event_log_entry->reason            = reason;
+        tx_drop_event_log_entry->reserved0         = 0;
+        tx_drop_event_log_entry->reserved1         = 0;
+        tx_drop_event_log_entry->reserved2         = 0;
+
+        memcpy(tx_drop_event_log_entry->addr1, tx_80211_header->address_1, MAC_ADDR_LEN);
+    }
+
+    return tx_drop_event_log_entry;
+}
+
+
+
 /*****************************************************************************/
 /**
  * Create a TX Low Log entry
@@ -417,6 +609,13 @@ tx_high_entry* wlan_exp_log_create_tx_high_entry(tx_frame_info_t* tx_frame_info)
     u32 transfer_len;
     u8 is_ltg;
 
+    // Log the latency trace of the packet
+    //     This is independent of MPDU logging so that traces can be captured
+    //     without the overhead of logging the MPDU payloads
+    if((tx_frame_info->trace_id != 0) && (log_entry_en_mask & ENTRY_EN_MASK_TXRX_TRACE)){
+        wlan_exp_log_create_tx_trace_entry(tx_frame_info);
+    }
+
     // MPDU logging is disabled
     if((log_entry_en_mask & ENTRY_EN_MASK_TXRX_MPDU) == 0){
         return NULL;
@@ -468,6 +667,7 @@ tx_high_entry* wlan_exp_log_create_tx_high_entry(tx_frame_info_t* tx_frame_info)
         tx_high_event_log_entry->delay_accept     = (u32)(tx_frame_info->timestamp_accept - tx_frame_info->queue_info.enqueue_timestamp);
         tx_high_event_log_entry->delay_done       = (u32)(tx_frame_info->timestamp_done - tx_frame_info->timestamp_accept);
         tx_high_event_log_entry->unique_seq       = tx_frame_info->unique_seq;
+        tx_high_event_log_entry->trace_id         = tx_frame_info->trace_id;
         tx_high_event_log_entry->num_tx           = tx_frame_info->num_tx_attempts;              // TODO: Add long/short distinction to event log
         tx_high_event_log_entry->length           = tx_frame_info->length;
         tx_high_event_log_entry->flags            = 0;
@@ -504,13 +704,16 @@ tx_high_entry* wlan_exp_log_create_tx_high_entry(tx_frame_info_t* tx_frame_info)
  * Create a RX Log entry
  *
  * @param   rx_mpdu          - Pointer to RX MPDU of the associated RX entry
- * @param   rate             - Indicates the rate at which the reception occurred
+ * @param   cdma_job_id      - Set to the ID of the last CDMA job that copies into the log entry
+ *                             (CDMA_JOB_ID_INVALID if none).  The caller must call
+ *                             wlan_mac_cdma_wait() with this ID before the Rx packet buffer
+ *                             is released.
  *
  * @return  rx_common_entry *     - Pointer to the rx_common_entry log entry
  *                                    NOTE: This can be NULL if an entry was not allocated
  *
  *****************************************************************************/
-rx_common_entry* wlan_exp_log_create_rx_entry(rx_frame_info_t* rx_frame_info){
+rx_common_entry* wlan_exp_log_create_rx_entry(rx_frame_info_t* rx_frame_info, u32* cdma_job_id){
 
     rx_common_entry* rx_event_log_entry = NULL;
     tx_low_entry* tx_low_event_log_entry = NULL; //This is for any inferred CTRL transmissions
@@ -526,6 +729,7 @@ rx_common_entry* wlan_exp_log_create_rx_entry(rx_frame_info_t* rx_frame_info){
     u32 entry_payload_size;
     u32 min_entry_payload_size;
     u32 transfer_len;
+    u8* mac_payload_log;
 
     pkt_id = (ltg_packet_id_t*)(mac_payload_ptr_u8 + sizeof(mac_header_80211));
 
@@ -535,6 +739,17 @@ rx_common_entry* wlan_exp_log_create_rx_entry(rx_frame_info_t* rx_frame_info){
     } copy_order_t;
     copy_order_t      copy_order;
 
+    *cdma_job_id = CDMA_JOB_ID_INVALID;
+
+    // Log the latency trace of data receptions
+    //     Only packets with a good FCS are traced since the MAC header is needed
+    //     to match the reception to the transmission
+    if ((log_entry_en_mask & ENTRY_EN_MASK_TXRX_TRACE) &&
+        ((rx_80211_header->frame_control_1 & 0xF) == MAC_FRAME_CTRL1_TYPE_DATA) &&
+        (rx_frame_info->flags & RX_FRAME_INFO_FLAGS_FCS_GOOD)) {
+        wlan_exp_log_create_rx_trace_entry(rx_frame_info);
+    }
+
     if ((((rx_80211_header->frame_control_1 & 0xF) == MAC_FRAME_CTRL1_TYPE_DATA) && (log_entry_en_mask & ENTRY_EN_MASK_TXRX_MPDU)) ||
         (((rx_80211_header->frame_control_1 & 0xF) == MAC_FRAME_CTRL1_TYPE_CTRL) && (log_entry_en_mask & ENTRY_EN_MASK_TXRX_CTRL)) ||
         ( (rx_80211_header->frame_control_1 & 0xF) == MAC_FRAME_CTRL1_TYPE_MGMT) ||
@@ -568,9 +783,10 @@ rx_common_entry* wlan_exp_log_create_rx_entry(rx_frame_info_t* rx_frame_info){
         if (rx_event_log_entry != NULL) {
 
             // For maximum pipelining, we'll break up the two major log copy operations (packet payload + [optional] channel estimates)
-            // We will start the CDMA operation for whichever of those copies is shorter, then fill in the rest of the log entry
-            // while that copy is under way, and then start the CDMA operation for the larger (which will first block on the shorter if
-            // it is still going).
+            // We will submit the CDMA job for whichever of those copies is shorter, so it starts right away, then fill in the rest
+            // of the log entry while that copy is under way, and then submit the CDMA job for the larger (which starts once the
+            // shorter is finished). Neither copy is waited on here; the caller waits for the last job before the Rx packet buffer
+            // is released.
 
             if (phy_mode == PHY_MODE_DSSS) {
                 // This is a DSSS packet that has no channel estimates
@@ -601,31 +817,28 @@ rx_common_entry* wlan_exp_log_create_rx_entry(rx_frame_info_t* rx_frame_info){
             //
             transfer_len = min(entry_payload_size, packet_payload_size);
 
+            if (phy_mode != PHY_MODE_DSSS) {
+                ((rx_ofdm_entry*)rx_event_log_entry)->mac_payload_log_len = entry_payload_size;
+                mac_payload_log = (u8*)(((rx_ofdm_entry*)rx_event_log_entry)->mac_payload);
+            } else {
+                ((rx_dsss_entry*)rx_event_log_entry)->mac_payload_log_len = entry_payload_size;
+                mac_payload_log = (u8*)(((rx_dsss_entry*)rx_event_log_entry)->mac_payload);
+            }
+
+            // Zero pad log entry if transfer_len was less than the allocated space in the log (ie entry_payload_size)
+            if (transfer_len < entry_payload_size) {
+                bzero(mac_payload_log + transfer_len, (entry_payload_size - transfer_len));
+            }
+
             // Start copy based on the copy order
             switch (copy_order) {
                 case PAYLOAD_FIRST:
-                    if (phy_mode != PHY_MODE_DSSS) {
-                        ((rx_ofdm_entry*)rx_event_log_entry)->mac_payload_log_len = entry_payload_size;
-                        wlan_mac_high_cdma_start_transfer((((rx_ofdm_entry*)rx_event_log_entry)->mac_payload), rx_80211_header, transfer_len);
-
-                        // Zero pad log entry if transfer_len was less than the allocated space in the log (ie entry_payload_size)
-                        if (transfer_len < entry_payload_size) {
-                            bzero((u8*)(((u32)((rx_ofdm_entry*)rx_event_log_entry)->mac_payload) + transfer_len), (entry_payload_size - transfer_len));
-                        }
-                    } else {
-                        ((rx_dsss_entry*)rx_event_log_entry)->mac_payload_log_len = entry_payload_size;
-                        wlan_mac_high_cdma_start_transfer((((rx_dsss_entry*)rx_event_log_entry)->mac_payload), rx_80211_header, transfer_len);
-
-                        // Zero pad log entry if transfer_len was less than the allocated space in the log (ie entry_payload_size)
-                        if (transfer_len < entry_payload_size) {
-                            bzero((u8*)(((u32)((rx_dsss_entry*)rx_event_log_entry)->mac_payload) + transfer_len), (entry_payload_size - transfer_len));
-                        }
-                    }
+                    *cdma_job_id = wlan_mac_high_cdma_submit_transfer(mac_payload_log, rx_80211_header, transfer_len);
                 break;
 
                 case CHAN_EST_FIRST:
     #ifdef WLAN_MAC_ENTRIES_LOG_CHAN_EST
-                    if (phy_mode != PHY_MODE_DSSS) wlan_mac_high_cdma_start_transfer(((rx_ofdm_entry*)rx_event_log_entry)->channel_est, rx_frame_info->channel_est, sizeof(rx_frame_info->channel_est));
+                    *cdma_job_id = wlan_mac_high_cdma_submit_transfer(((rx_ofdm_entry*)rx_event_log_entry)->channel_est, rx_frame_info->channel_est, sizeof(rx_frame_info->channel_est));
     #endif
                 break;
             }
@@ -670,28 +883,12 @@ rx_common_entry* wlan_exp_log_create_rx_entry(rx_frame_info_t* rx_frame_info){
             switch(copy_order){
                 case PAYLOAD_FIRST:
     #ifdef WLAN_MAC_ENTRIES_LOG_CHAN_EST
-                    if(phy_mode != PHY_MODE_DSSS) wlan_mac_high_cdma_start_transfer(((rx_ofdm_entry*)rx_event_log_entry)->channel_est, rx_frame_info->channel_est, sizeof(rx_frame_info->channel_est));
+                    if(phy_mode != PHY_MODE_DSSS) *cdma_job_id = wlan_mac_high_cdma_submit_transfer(((rx_ofdm_entry*)rx_event_log_entry)->channel_est, rx_frame_info->channel_est, sizeof(rx_frame_info->channel_est));
     #endif
                 break;
 
                 case CHAN_EST_FIRST:
-                    if (phy_mode != PHY_MODE_DSSS) {
-                        ((rx_ofdm_entry*)rx_event_log_entry)->mac_payload_log_len = entry_payload_size;
-                        wlan_mac_high_cdma_start_transfer((((rx_ofdm_entry*)rx_event_log_entry)->mac_payload), rx_80211_header, transfer_len);
-
-                        // Zero pad log entry if transfer_len was less than the allocated space in the log (ie entry_payload_size)
-                        if (transfer_len < entry_payload_size) {
-                            bzero((u8*)(((u32)((rx_ofdm_entry*)rx_event_log_entry)->mac_payload) + transfer_len), (entry_payload_size - transfer_len));
-                        }
-                    } else {
-                        ((rx_dsss_entry*)rx_event_log_entry)->mac_payload_log_len = entry_payload_size;
-                        wlan_mac_high_cdma_start_transfer((((rx_dsss_entry*)rx_event_log_entry)->mac_payload), rx_80211_header, transfer_len);
-
-                        // Zero pad log entry if transfer_len was less than the allocated space in the log (ie entry_payload_size)
-                        if (transfer_len < entry_payload_size) {
-                            bzero((u8*)(((u32)((rx_dsss_entry*)rx_event_log_entry)->mac_payload) + transfer_len), (entry_payload_size - transfer_len));
-                        }
-                    }
+                    *cdma_job_id = wlan_mac_high_cdma_submit_transfer(mac_payload_log, rx_80211_header, transfer_len);
                 break;
             }
 
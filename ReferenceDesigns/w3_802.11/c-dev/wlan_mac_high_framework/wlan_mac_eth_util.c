@@ -35,6 +35,9 @@
 #include "wlan_mac_eth_util.h"
 #include "wlan_mac_802_11_defs.h"
 #include "wlan_mac_pkt_buf_util.h"
+#include "wlan_mac_entries.h"
+#include "wlan_mac_dprint.h"
+#include "wlan_mac_prof.h"
 
 
 
@@ -165,9 +168,11 @@ u32 wlan_process_eth_rx(void* eth_rx_buf, u32 eth_rx_len) {
     wlan_mac_set_dbg_hdr_out(0x4);
 #endif
 
+    WLAN_PROF_START(PROF_PROBE_ETH_RX);
+
     // Check arguments
     if ((eth_rx_buf == NULL) || (eth_rx_len == 0)) {
-        xil_printf("ERROR:  Tried to process NULL Ethernet packet\n");
+        wlan_dprintf(PL_ERROR, "ERROR:  Tried to process NULL Ethernet packet\n");
         return return_value;
     }
 
@@ -182,6 +187,15 @@ u32 wlan_process_eth_rx(void* eth_rx_buf, u32 eth_rx_len) {
 	tx_queue_buffer = (tx_queue_buffer_t*)( (u8*)mpdu_start_ptr - offsetof(tx_queue_buffer_t,frame));
 	curr_tx_queue_element = tx_queue_buffer->tx_queue_entry;
 
+#if WLAN_SW_CONFIG_ENABLE_LOGGING
+	// Start the latency trace of the packet (if enabled)
+	//     The Ethernet DMA buffers are not checked out per packet, so this
+	//     must also clear the trace ID of untraced packets
+	wlan_exp_log_start_tx_trace(tx_queue_buffer);
+#else
+	tx_queue_buffer->trace_id = 0;
+#endif //WLAN_SW_CONFIG_ENABLE_LOGGING
+
 	eth_start_ptr  = (u8*)eth_rx_buf;
 
 		// Encapsulate the Ethernet packet
@@ -205,6 +219,8 @@ u32 wlan_process_eth_rx(void* eth_rx_buf, u32 eth_rx_len) {
     wlan_mac_clear_dbg_hdr_out(0x4);
 #endif
 
+    WLAN_PROF_END(PROF_PROBE_ETH_RX);
+
     return return_value;
 }
 
@@ -427,7 +443,7 @@ int wlan_mpdu_eth_send(void* mpdu, u16 length, u8 pre_llc_offset) {
     if(gl_portal_en == 0) return 0;
 
     if(length < (min_pkt_len + pre_llc_offset + WLAN_PHY_FCS_NBYTES)){
-        xil_printf("Error in wlan_mpdu_eth_send: length of %d is too small... must be at least %d\n", length, min_pkt_len + pre_llc_offset + WLAN_PHY_FCS_NBYTES);
+        wlan_dprintf(PL_ERROR, "Error in wlan_mpdu_eth_send: length of %d is too small... must be at least %d\n", length, min_pkt_len + pre_llc_offset + WLAN_PHY_FCS_NBYTES);
         return -1;
     }
 
@@ -622,7 +638,7 @@ int wlan_mpdu_eth_send(void* mpdu, u16 length, u8 pre_llc_offset) {
     }
 
     status = wlan_platform_ethernet_send((u8*)eth_hdr, len_to_send);
-    if (status != 0) { xil_printf("Error in wlan_platform_ethernet_send! Err = %d\n", status); return -1; }
+    if (status != 0) { wlan_dprintf(PL_ERROR, "Error in wlan_platform_ethernet_send! Err = %d\n", status); return -1; }
 
     return 0;
 }
@@ -58,6 +58,8 @@
 #include "wlan_mac_entries.h"
 #include "wlan_mac_high.h"
 #include "wlan_platform_common.h"
+#include "wlan_mac_dprint.h"
+#include "wlan_mac_prof.h"
 
 // WLAN Exp includes
 #include "wlan_exp_node.h"
@@ -101,6 +103,10 @@ static volatile u16 log_count; // Monotonic counter for log entry sequence numbe
 // Mutex for critical allocation loop
 static volatile u8 allocation_mutex;
 
+// Log reservation variables (see event_log_reserve())
+static volatile u32 log_reserve_address;     // Address of the next entry in the reserved space
+static volatile u32 log_reserve_end_address; // End address of the reserved space (0 = no reservation)
+
 
 /*************************** Functions Prototypes ****************************/
 
@@ -219,6 +225,9 @@ void event_log_reset(){
 
     allocation_mutex     = 0;
 
+    log_reserve_address     = 0;
+    log_reserve_end_address = 0;
+
     // Add a node info entry to the log
     //
     // NOTE:  A node_info_entry is guaranteed to be present as the first entry in the log
@@ -634,6 +643,8 @@ int  event_log_get_next_empty_address( u32 size, u32* address ) {
     u64 end_address;
     node_info_entry* entry;
 
+    WLAN_PROF_START(PROF_PROBE_EVENT_LOG_GET_ADDR);
+
     // If the log is empty, then set the flag to zero to indicate the log is not empty
     if (log_empty) { log_empty = 0; }
 
@@ -659,7 +670,7 @@ int  event_log_get_next_empty_address( u32 size, u32* address ) {
                 // Check to see if wrapping is enabled
                 if ( log_wrap_enabled ) {
 
-                    xil_printf("EVENT LOG: LOG WRAP: Has wrapped %d times\n", log_num_wraps);
+                    wlan_dprintf(PL_WARNING, "EVENT LOG: LOG WRAP: Has wrapped %d times\n", log_num_wraps);
 
                     // Compute new end address
                     end_address = log_start_address + sizeof(node_info_entry) + sizeof(entry_header) + size;
@@ -787,11 +798,98 @@ int  event_log_get_next_empty_address( u32 size, u32* address ) {
     // Set return parameter
     *address = return_address;
 
+    WLAN_PROF_END(PROF_PROBE_EVENT_LOG_GET_ADDR);
+
+    return status;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Reserve space for a batch of entries
+ *
+ * Allocates size bytes at the end of the log in one step.  Until the reservation
+ * is released, event_log_get_next_empty_entry() takes entries from the reserved
+ * space, which avoids the full allocation procedure for each entry of a batch
+ * (e.g. the TX_LOW entries of a batch of Tx reports).  Entries are still added to
+ * the log in order, so the reserved space never contains gaps.
+ *
+ * Space is only reserved if it is free, ie if the reservation does not wrap the
+ * log or discard old entries.  Otherwise, the entries are allocated one by one.
+ *
+ * @param   size             - Size (in bytes) to reserve
+ *
+ * @return  int              - Status of command
+ *                               - 0 = Success
+ *                               - 1 = Failure
+ *
+ * @note    The reservation must be released with event_log_release_reservation()
+ *          before the log is read
+ *
+ *****************************************************************************/
+int  event_log_reserve( u32 size ) {
+
+    u64 end_address;
+    int status = 1;
+
+    if (!event_logging_enabled || log_full || allocation_mutex || log_reserve_end_address) {
+        return status;
+    }
+
+    allocation_mutex = 1;
+
+    end_address = (u64)(log_next_address) + (u64)(size);
+
+    if ((log_next_address > log_oldest_address) ||
+        ((log_next_address == log_start_address) && (log_oldest_address == log_start_address))) {
+        // The log has not wrapped:  the reservation must end before the soft end of the log
+        if (end_address <= log_soft_end_address) { status = 0; }
+    } else {
+        // The log has wrapped:  the reservation must end before the oldest entry
+        if (end_address <= log_oldest_address) { status = 0; }
+    }
+
+    if (status == 0) {
+        log_reserve_address     = log_next_address;
+        log_reserve_end_address = (u32)end_address;
+        log_next_address        = (u32)end_address;
+    }
+
+    allocation_mutex = 0;
+
     return status;
 }
 
 
 
+/*****************************************************************************/
+/**
+ * Release the reserved space
+ *
+ * Returns the unused part of the reserved space to the log.
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void event_log_release_reservation() {
+
+    if (log_reserve_end_address) {
+        // All entries are taken from the reserved space while it exists, so the
+        // unused part is always at the end of the log
+        if (log_next_address == log_reserve_end_address) {
+            log_next_address = log_reserve_address;
+        }
+
+        log_reserve_address     = 0;
+        log_reserve_end_address = 0;
+    }
+}
+
+
+
 /*****************************************************************************/
 /**
  * Get the next empty entry
@@ -809,6 +907,7 @@ void* event_log_get_next_empty_entry(u16 entry_type, u16 entry_size) {
     entry_header* header = NULL;
     u32 header_size = sizeof( entry_header );
     void* return_entry = NULL;
+    int status = 1;
 
     // If Event Logging is enabled, then allocate entry
     if (event_logging_enabled) {
@@ -822,8 +921,26 @@ void* event_log_get_next_empty_entry(u16 entry_type, u16 entry_size) {
 
         total_size = entry_size + header_size;
 
+        // Take the entry from the reserved space
+        //     - If the entry does not fit, return the rest of the reserved space to the
+        //       log and allocate the entry normally
+        if (log_reserve_end_address && !allocation_mutex) {
+            if ((log_reserve_address + total_size) <= log_reserve_end_address) {
+                log_address          = log_reserve_address;
+                log_reserve_address += total_size;
+                log_empty            = 0;
+                status               = 0;
+            } else {
+                event_log_release_reservation();
+            }
+        }
+
         // Try to allocate the next entry
-        if (!event_log_get_next_empty_address(total_size, &log_address)) {
+        if (status) {
+            status = event_log_get_next_empty_address(total_size, &log_address);
+        }
+
+        if (!status) {
 
             // Use successfully allocated address for the entry
             header = (entry_header*) log_address;
@@ -19,7 +19,6 @@
 #include "malloc.h"
 #include "xil_exception.h"
 #include "xintc.h"
-#include "xaxicdma.h"
 
 // WLAN Includes
 #include "wlan_mac_common.h"
@@ -44,6 +43,10 @@
 #include "wlan_exp_node.h"
 #include "wlan_mac_scan.h"
 #include "wlan_mac_high_mailbox_util.h"
+#include "wlan_mac_pool.h"
+#include "wlan_mac_cdma.h"
+#include "wlan_mac_dprint.h"
+#include "wlan_mac_prof.h"
 
 /*********************** Global Variable Definitions *************************/
 
@@ -65,7 +68,6 @@ platform_high_dev_info_t platform_high_dev_info;
 platform_common_dev_info_t platform_common_dev_info;
 
 XIntc InterruptController; ///< Interrupt Controller instance
-XAxiCdma cdma_inst; ///< Central DMA instance
 
 // Callback function pointers
 volatile function_ptr_t press_pb_0_callback;   ///< User callback for pressing pushbutton 0
@@ -101,6 +103,9 @@ volatile u8 dram_present;                 ///< Indication variable for whether D
 wlan_mac_hw_info_t* hw_info;
 static volatile u32 cpu_low_status;               ///< Tracking variable for lower-level CPU status
 
+// Address of the profiling probes of CPU Low (0 if CPU Low was not compiled with profiling)
+static volatile u32 cpu_low_prof_table;
+
 // CPU Low Register Read Buffer
 static volatile u32* cpu_low_reg_read_buffer;
 static volatile u8 cpu_low_reg_read_buffer_status;
@@ -115,6 +120,11 @@ static volatile interrupt_state_t interrupt_state;
 static volatile u32 num_malloc;                   ///< Tracking variable for number of times malloc has been called
 static volatile u32 num_free;                     ///< Tracking variable for number of times free has been called
 static volatile u32 num_realloc;                  ///< Tracking variable for number of times realloc has been called
+static volatile u32 num_malloc_failed;            ///< Tracking variable for number of times malloc / realloc has failed
+static volatile u32 max_malloc_live;              ///< Largest value of num_malloc - num_free
+
+// Rx packet buffer counts
+static rx_pkt_buf_info_t rx_pkt_buf_info;
 
 /*************************** Functions Prototypes ****************************/
 
@@ -142,7 +152,6 @@ void wlan_mac_high_init(){
 #if WLAN_SW_CONFIG_ENABLE_LOGGING
 	u32 log_size;
 #endif //WLAN_SW_CONFIG_ENABLE_LOGGING
-	XAxiCdma_Config* cdma_cfg_ptr;
 
 	platform_high_dev_info   = wlan_platform_high_get_dev_info();
 	platform_common_dev_info = wlan_platform_common_get_dev_info();
@@ -256,9 +265,14 @@ void wlan_mac_high_init(){
 
 	interrupt_state = INTERRUPTS_DISABLED;
 
-	num_malloc  = 0;
-	num_realloc = 0;
-	num_free    = 0;
+	num_malloc        = 0;
+	num_realloc       = 0;
+	num_free          = 0;
+	num_malloc_failed = 0;
+	max_malloc_live   = 0;
+
+	bzero(&rx_pkt_buf_info, sizeof(rx_pkt_buf_info_t));
+	rx_pkt_buf_info.num_rx_pkt_bufs = NUM_RX_PKT_BUFS;
 
 	low_param_channel 		= 0xFFFFFFFF;
 	low_param_dsss_en 		= 0xFFFFFFFF;
@@ -269,6 +283,7 @@ void wlan_mac_high_init(){
 	low_param_random_seed	= 0xFFFFFFFF;
 
 	cpu_low_reg_read_buffer        = NULL;
+	cpu_low_prof_table             = 0;
 
 	// ***************************************************
 	// Initialize Transmit Packet Buffers
@@ -351,13 +366,8 @@ void wlan_mac_high_init(){
 	// Initialize CDMA, GPIO, and UART drivers
 	// ***************************************************
 
-	// Initialize the central DMA (CDMA) driver
-	cdma_cfg_ptr = XAxiCdma_LookupConfig(platform_high_dev_info.cdma_dev_id);
-	Status = XAxiCdma_CfgInitialize(&cdma_inst, cdma_cfg_ptr, cdma_cfg_ptr->BaseAddress);
-	if (Status != XST_SUCCESS) {
-		wlan_printf(PL_ERROR, "ERROR: Could not initialize CDMA: %d\n", Status);
-	}
-	XAxiCdma_IntrDisable(&cdma_inst, XAXICDMA_XR_IRQ_ALL_MASK);
+	// Initialize the central DMA (CDMA) driver and job queue
+	wlan_mac_cdma_init(platform_high_dev_info.cdma_dev_id);
 
 	xil_printf("Testing DRAM...\n");
 
@@ -373,6 +383,9 @@ void wlan_mac_high_init(){
 	// ***************************************************
 	// Initialize various subsystems in the MAC High Framework
 	// ***************************************************
+	wlan_mac_dprint_init();
+	wlan_mac_prof_init();
+	wlan_mac_pool_init();
 	queue_init();
 
 #if WLAN_SW_CONFIG_ENABLE_LOGGING
@@ -446,6 +459,12 @@ int wlan_mac_high_interrupt_init(){
 		return -1;
 	}
 
+	Result = wlan_mac_cdma_setup_interrupt(&InterruptController, platform_high_dev_info.cdma_int_id);
+	if (Result != XST_SUCCESS) {
+		wlan_printf(PL_ERROR, "Failed to set up CDMA interrupt\n");
+		return -1;
+	}
+
 	Result = wlan_platform_high_init(&InterruptController);
 	if (Result != XST_SUCCESS) {
 		wlan_printf(PL_ERROR,"Failed to set up Ethernet interrupt\n");
@@ -729,6 +748,7 @@ void wlan_mac_high_display_mallinfo(){
 	xil_printf("   System:                  %d bytes\n", mi.arena);
 	xil_printf("   Total Allocated Space:   %d bytes\n", mi.uordblks);
 	xil_printf("   Total Free Space:        %d bytes\n", mi.fordblks);
+	wlan_mac_pool_display_info();
 #ifdef _DEBUG_
 	xil_printf("Details:\n");
 	xil_printf("   arena:                   %d\n", mi.arena);
@@ -769,6 +789,7 @@ void* wlan_mac_high_malloc(u32 size){
 	return_value = malloc(size);
 
 	if(return_value == NULL){
+		num_malloc_failed++;
 		xil_printf("malloc error. Try increasing heap size in linker script.\n");
 		wlan_mac_high_display_mallinfo();
 	} else {
@@ -776,6 +797,10 @@ void* wlan_mac_high_malloc(u32 size){
 		xil_printf("MALLOC - 0x%08x    %d\n", return_value, size);
 #endif
 		num_malloc++;
+
+		if((num_malloc - num_free) > max_malloc_live){
+			max_malloc_live = num_malloc - num_free;
+		}
 	}
 	return return_value;
 }
@@ -836,6 +861,7 @@ void* wlan_mac_high_realloc(void* addr, u32 size){
 	return_value = realloc(addr, size);
 
 	if(return_value == NULL){
+		num_malloc_failed++;
 		xil_printf("realloc error. Try increasing heap size in linker script.\n");
 		wlan_mac_high_display_mallinfo();
 	} else {
@@ -863,17 +889,51 @@ void* wlan_mac_high_realloc(void* addr, u32 size){
  * code to enable easier debugging of memory leaks when they occur. This function also updates
  * a variable maintained by the framework to track the number of memory frees.
  *
+ * @note Objects of the memory pools (see wlan_mac_pool_alloc()) are returned to their pool
+ * instead of the heap.
+ *
  */
 void wlan_mac_high_free(void* addr){
 #ifdef _DEBUG_
 	xil_printf("FREE - 0x%08x\n", addr);
 #endif
+	if(wlan_mac_pool_free(addr) == 0){
+		return;
+	}
+
 	free(addr);
 	num_free++;
 }
 
 
 
+/**
+ * @brief Get Heap Allocation Statistics
+ *
+ * This function returns the statistics of the allocations made with wlan_mac_high_malloc()
+ * and wlan_mac_high_calloc() in the format of the memory pool statistics.
+ *
+ * @param mem_pool_info_t* info
+ *  - Pointer to statistics to fill in. The units are allocations, except for num_total
+ *    which is the number of bytes the heap has taken from the system.
+ * @return None
+ *
+ */
+void wlan_mac_high_get_heap_info(mem_pool_info_t* info){
+	struct mallinfo mi;
+	mi = mallinfo();
+
+	info->obj_size     = 0;
+	info->num_total    = mi.arena;
+	info->num_live     = num_malloc - num_free;
+	info->max_live     = max_malloc_live;
+	info->num_alloc    = num_malloc;
+	info->num_fallback = 0;
+	info->num_failed   = num_malloc_failed;
+}
+
+
+
 /**
  * @brief Test DDR3 SODIMM Memory Module
  *
@@ -990,8 +1050,10 @@ int wlan_mac_high_right_shift_test(){
 /**
  * @brief Start Central DMA Transfer
  *
- * This function wraps the XAxiCdma call for a CDMA memory transfer and mimics the well-known
- * API of memcpy(). This function does not block once the transfer is started.
+ * This function submits a CDMA memory transfer to the CDMA job queue (see wlan_mac_cdma.h) and
+ * mimics the well-known API of memcpy(). This function blocks until all previously submitted
+ * transfers are finished, so the CDMA is idle and starts this transfer before the function
+ * returns. It does not block once the transfer is started.
  *
  * @param void* dest
  *  - Pointer to destination address where bytes should be copied
@@ -1006,46 +1068,71 @@ int wlan_mac_high_right_shift_test(){
  *	 Length out of valid range [1:8M]
  *	 Or, address not aligned when DRE is not built in
  *
- *	 @note This function will block until any existing CDMA transfer is complete. It is therefore
- *	 safe to call this function successively as each call will wait on the preceeding call.
+ *	 @note Transfers are executed in the order they are submitted. It is therefore safe to call
+ *	 this function successively as each transfer will start after the preceeding one.
+ *
+ *	 @note The transfer runs without CPU involvement, even when the CDMA interrupt is not
+ *	 connected and nothing else advances the job queue. Callers must still call
+ *	 wlan_mac_high_cdma_finish_transfer() before the source is released or the destination
+ *	 is used.
  *
  */
 int wlan_mac_high_cdma_start_transfer(void* dest, void* src, u32 size){
-	//This is a wrapper function around the central DMA simple transfer call. It's arguments
-	//are intended to be similar to memcpy. Note: This function does not block on the transfer.
-	int return_value = XST_SUCCESS;
-	u8 out_of_range  = 0;
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wtype-limits"
-	// The -Wtype-limits flag catches the below checks when any of the base addresses are 0 since the
-	// evaluation will always be true. Nevertheless, these checks are useful if the memory map changes.
-	// So, we can explicitly disable the warning around these sets of lines.
-
-	if((u32)src >= platform_high_dev_info.dlmb_baseaddr && (u32)src <= CALC_HIGH_ADDR(platform_high_dev_info.dlmb_baseaddr, platform_high_dev_info.dlmb_size)){
-		out_of_range = 1;
-	} else if((u32)dest >= platform_high_dev_info.dlmb_baseaddr && (u32)dest <= CALC_HIGH_ADDR(platform_high_dev_info.dlmb_baseaddr, platform_high_dev_info.dlmb_size)){
-		out_of_range = 1;
-	}
-#pragma GCC diagnostic pop
 	if( size == 0 ){
 		xil_printf("CDMA Error: size argument must be > 0\n");
 		return XST_FAILURE;
 	}
 
-	if(out_of_range == 0){
-		wlan_mac_high_cdma_finish_transfer();
-		return_value = XAxiCdma_SimpleTransfer(&cdma_inst, (u32)src, (u32)dest, size, NULL, NULL);
+	// Wait for the previous transfers so that this one starts on the idle CDMA
+	wlan_mac_cdma_wait_all();
 
-		if(return_value != 0){
-			xil_printf("CDMA Error: code %d, (0x%08x,0x%08x,%d)\n", return_value, dest,src,size);
-		}
-	} else {
-		xil_printf("CDMA Error: source and destination addresses must not located in the DLMB. Using memcpy instead. memcpy(0x%08x,0x%08x,%d)\n",dest,src,size);
-		memcpy(dest,src,size);
+	wlan_mac_high_cdma_submit_transfer(dest, src, size);
+
+	return XST_SUCCESS;
+}
+
+
+
+/**
+ * @brief Submit Central DMA Transfer
+ *
+ * This function submits a CDMA memory transfer to the CDMA job queue without waiting for the
+ * previous transfers. The transfer starts once the transfers submitted before it are finished;
+ * when the CDMA interrupt is not connected, that is the next time CPU High submits, waits or
+ * polls the job queue.
+ *
+ * @param void* dest
+ *  - Pointer to destination address where bytes should be copied
+ * @param void* src
+ *  - Pointer to source address from where bytes should be copied
+ * @param u32 size
+ *  - Number of bytes that should be copied
+ * @return u32
+ *	- ID of the job for wlan_mac_cdma_wait()
+ *	- CDMA_JOB_ID_INVALID if there is nothing to wait for (the bytes were copied with memcpy()
+ *	 because the job queue could not take the transfer)
+ *
+ *	 @note Callers must call wlan_mac_cdma_wait() with the returned ID before the source is
+ *	 released or the destination is used.
+ *
+ */
+u32 wlan_mac_high_cdma_submit_transfer(void* dest, void* src, u32 size){
+	u32 job_id;
+
+	if( size == 0 ){
+		xil_printf("CDMA Error: size argument must be > 0\n");
+		return CDMA_JOB_ID_INVALID;
 	}
 
-	return return_value;
+	job_id = wlan_mac_cdma_submit(dest, src, size, NULL, NULL, 0);
+
+	if(job_id == CDMA_JOB_ID_INVALID){
+		// The job queue is full of jobs waiting for main context - copy after the queued jobs
+		wlan_mac_cdma_wait_all();
+		memcpy(dest, src, size);
+	}
+
+	return job_id;
 }
 
 
@@ -1053,7 +1140,7 @@ int wlan_mac_high_cdma_start_transfer(void* dest, void* src, u32 size){
 /**
  * @brief Finish Central DMA Transfer
  *
- * This function will block until an ongoing CDMA transfer is complete.
+ * This function will block until all submitted CDMA transfers are complete.
  * If there is no CDMA transfer underway when this function is called, it
  * returns immediately.
  *
@@ -1062,7 +1149,7 @@ int wlan_mac_high_cdma_start_transfer(void* dest, void* src, u32 size){
  *
  */
 void wlan_mac_high_cdma_finish_transfer(){
-	while(XAxiCdma_IsBusy(&cdma_inst)) {}
+	wlan_mac_cdma_wait_all();
 	return;
 }
 
@@ -1090,6 +1177,8 @@ void wlan_mac_high_mpdu_transmit(dl_entry* packet, int tx_pkt_buf) {
 	tx_params_t default_tx_params;
 	u8 is_multicast;
 
+	WLAN_PROF_START(PROF_PROBE_MPDU_TRANSMIT);
+
 	tx_frame_info = (tx_frame_info_t*)CALC_PKT_BUF_ADDR(platform_common_dev_info.tx_pkt_buf_baseaddr, tx_pkt_buf);
 	tx_queue_buffer = (tx_queue_buffer_t*)(packet->data);
 	header = (mac_header_80211*)(tx_queue_buffer->frame);
@@ -1123,6 +1212,18 @@ void wlan_mac_high_mpdu_transmit(dl_entry* packet, int tx_pkt_buf) {
 																		   // can avoid it.
 	tx_frame_info->unique_seq = 0; // Unique_seq will be filled in by CPU_LOW
 
+	// Carry the latency trace of the packet into the Tx packet buffer
+	//     The ingress and dequeue delays are logged in the TX_TRACE entry when CPU Low is done
+	tx_frame_info->trace_id = tx_queue_buffer->trace_id;
+
+	if(tx_queue_buffer->trace_id){
+		tx_frame_info->delay_ingress = (u32)(tx_queue_buffer->queue_info.enqueue_timestamp - tx_queue_buffer->timestamp_ingress);
+		tx_frame_info->delay_dequeue = (u32)(get_mac_time_usec() - tx_queue_buffer->queue_info.enqueue_timestamp);
+	} else {
+		tx_frame_info->delay_ingress = 0;
+		tx_frame_info->delay_dequeue = 0;
+	}
+
 	// Pull first byte from the payload of the packet so we can determine whether
 	// it is a management or data type
 	frame_control_1 = header->frame_control_1; //Note: header points to DRAM. We aren't relying on the bytes in the Tx packet buffer
@@ -1186,6 +1287,8 @@ void wlan_mac_high_mpdu_transmit(dl_entry* packet, int tx_pkt_buf) {
 		// it was already unlocked. In either case, we can submit this READY message.
 		write_mailbox_msg(&ipc_msg_to_low);
 	}
+
+	WLAN_PROF_END(PROF_PROBE_MPDU_TRANSMIT);
 }
 
 /**
@@ -1205,6 +1308,72 @@ void wlan_mac_high_setup_tx_header(mac_header_80211_common* header, u8* addr_1,
     header->address_3 = addr_3;
 }
 
+/**
+ * @brief Finish a batch of receptions
+ *
+ * Called after each drain of the IPC messages from CPU Low with the number of
+ * IPC_MBOX_RX_PKT_BUF_READY messages that were processed.  Since CPU Low only rings
+ * the mailbox doorbell when the IPC ring was empty, all of the receptions that arrive
+ * while CPU High is busy are processed in one drain.
+ *
+ * @param  u32 num_rx
+ *     - Number of receptions processed in the drain
+ * @return None
+ */
+void wlan_mac_high_rx_batch_done(u32 num_rx) {
+	if(num_rx == 0){
+		return;
+	}
+
+	rx_pkt_buf_info.num_batches++;
+
+	if(num_rx > rx_pkt_buf_info.max_batch){
+		rx_pkt_buf_info.max_batch = num_rx;
+	}
+}
+
+/**
+ * @brief Start / finish a batch of Tx reports
+ *
+ * Called by the IPC drain before the first IPC_MBOX_PHY_TX_REPORT message it
+ * processes and after the drain.  When CPU Low coalesces Tx reports, a single
+ * drain processes many reports, so the log space for their entries is reserved
+ * in one step.
+ *
+ * @param  u32 num_pending_words
+ *     - Number of IPC words from CPU Low that were pending at the start of the batch
+ * @return None
+ */
+void wlan_mac_high_tx_report_batch_start(u32 num_pending_words) {
+#if WLAN_SW_CONFIG_ENABLE_LOGGING
+	// Upper bound on the number of Tx reports in the IPC ring
+	u32 num_tx_reports = 1 + (num_pending_words / (1 + (sizeof(wlan_mac_low_tx_details_t) / sizeof(u32))));
+
+	wlan_exp_log_reserve_tx_entries(num_tx_reports);
+#endif
+}
+
+void wlan_mac_high_tx_report_batch_done() {
+#if WLAN_SW_CONFIG_ENABLE_LOGGING
+	wlan_exp_log_release_tx_entries();
+#endif
+}
+
+/**
+ * @brief Get Rx packet buffer counts
+ *
+ * @param  rx_pkt_buf_info_t* info
+ *     - Pointer to the structure to fill in
+ * @return None
+ */
+void wlan_mac_high_get_rx_pkt_buf_info(rx_pkt_buf_info_t* info) {
+	interrupt_state_t prev_interrupt_state = wlan_mac_high_interrupt_stop();
+
+	memcpy(info, &rx_pkt_buf_info, sizeof(rx_pkt_buf_info_t));
+
+	wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+}
+
 /**
  * @brief WLAN MAC IPC processing function for CPU High
  *
@@ -1234,7 +1403,7 @@ void wlan_mac_high_process_ipc_msg(wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_pa
 			tx_pkt_buf = msg->arg0;
 			if(tx_pkt_buf == TX_PKT_BUF_BEACON){
 				if(lock_tx_pkt_buf(tx_pkt_buf) != PKT_BUF_MUTEX_SUCCESS){
-					xil_printf("Error: CPU_LOW had lock on Beacon packet buffer during IPC_MBOX_TX_BEACON_DONE\n");
+					wlan_dprintf(PL_ERROR, "Error: CPU_LOW had lock on Beacon packet buffer during IPC_MBOX_TX_BEACON_DONE\n");
 				} else {
 					tx_frame_info = (tx_frame_info_t*)CALC_PKT_BUF_ADDR(platform_common_dev_info.tx_pkt_buf_baseaddr, tx_pkt_buf);
 					tx_low_details = (wlan_mac_low_tx_details_t*)(msg->payload_ptr);
@@ -1257,12 +1426,12 @@ void wlan_mac_high_process_ipc_msg(wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_pa
 
 					tx_frame_info->tx_pkt_buf_state = TX_PKT_BUF_READY;
 					if(unlock_tx_pkt_buf(tx_pkt_buf) != PKT_BUF_MUTEX_SUCCESS){
-						xil_printf("Error: Unable to unlock Beacon packet buffer during IPC_MBOX_TX_BEACON_DONE\n");
+						wlan_dprintf(PL_ERROR, "Error: Unable to unlock Beacon packet buffer during IPC_MBOX_TX_BEACON_DONE\n");
 						return;
 					}
 				}
 			} else {
-				xil_printf("Error: IPC_MBOX_TX_BEACON_DONE with invalid pkt buf index %d\n ", tx_pkt_buf);
+				wlan_dprintf(PL_ERROR, "Error: IPC_MBOX_TX_BEACON_DONE with invalid pkt buf index %d\n ", tx_pkt_buf);
 			}
 		}
 		break;
@@ -1275,9 +1444,16 @@ void wlan_mac_high_process_ipc_msg(wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_pa
 			station_info_t* station_info;
 			u32 mpdu_rx_process_flags;
 			rx_common_entry* rx_event_log_entry = NULL;
+			u32 rx_log_copy_job_id = CDMA_JOB_ID_INVALID;
+
+			// Receptions CPU Low dropped since its previous message (Rx packet buffer overrun)
+			if(msg->num_payload_words >= 1){
+				rx_pkt_buf_info.num_overrun += ipc_msg_from_low_payload[0];
+			}
 
 			rx_pkt_buf = msg->arg0;
 			if(rx_pkt_buf < NUM_RX_PKT_BUFS){
+				rx_pkt_buf_info.num_rx++;
 				rx_frame_info = (rx_frame_info_t*)CALC_PKT_BUF_ADDR(platform_common_dev_info.rx_pkt_buf_baseaddr, rx_pkt_buf);
 
 				switch(rx_frame_info->rx_pkt_buf_state){
@@ -1298,7 +1474,8 @@ void wlan_mac_high_process_ipc_msg(wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_pa
 
 #if WLAN_SW_CONFIG_ENABLE_LOGGING
 							//Log this RX event
-							rx_event_log_entry = wlan_exp_log_create_rx_entry(rx_frame_info);
+							//     The copies into the log entry run on the CDMA while the reception is processed
+							rx_event_log_entry = wlan_exp_log_create_rx_entry(rx_frame_info, &rx_log_copy_job_id);
 #endif
 
 							// Call the RX callback function to process the received packet
@@ -1313,6 +1490,10 @@ void wlan_mac_high_process_ipc_msg(wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_pa
 								}
 							}
 #endif
+							// Wait for the copies of the Rx log entry out of the rx_pkt_buf
+							//     Copies started by mpdu_rx_callback() are finished before it returns
+							wlan_mac_cdma_wait(rx_log_copy_job_id);
+
 							// Free up the rx_pkt_buf
 							rx_frame_info->rx_pkt_buf_state = RX_PKT_BUF_LOW_CTRL;
 
@@ -1333,7 +1514,7 @@ void wlan_mac_high_process_ipc_msg(wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_pa
 				   break;
 				}
 			} else {
-				xil_printf("Error: IPC_MBOX_RX_MPDU_READY with invalid pkt buf index %d\n ", rx_pkt_buf);
+				wlan_dprintf(PL_ERROR, "Error: IPC_MBOX_RX_MPDU_READY with invalid pkt buf index %d\n ", rx_pkt_buf);
 			}
 		} break;
 
@@ -1374,7 +1555,7 @@ void wlan_mac_high_process_ipc_msg(wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_pa
 						//  Run normal post-tx processing
 						// Lock this packet buffer
 						if(lock_tx_pkt_buf(tx_pkt_buf) != PKT_BUF_MUTEX_SUCCESS){
-							xil_printf("Error: DONE Lock Tx Pkt Buf State Mismatch\n");
+							wlan_dprintf(PL_ERROR, "Error: DONE Lock Tx Pkt Buf State Mismatch\n");
 							tx_frame_info->tx_pkt_buf_state = TX_PKT_BUF_HIGH_CTRL;
 							return;
 						}
@@ -1386,12 +1567,20 @@ void wlan_mac_high_process_ipc_msg(wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_pa
 						//We will pass this completed transmission off to the Station Info subsystem
 						station_info = station_info_posttx_process((void*)(CALC_PKT_BUF_ADDR(platform_common_dev_info.tx_pkt_buf_baseaddr, tx_pkt_buf)));
 
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+						// Add the enqueue to Tx done time of the MPDU to the queue statistics
+						queue_stats_mpdu_tx_done(tx_frame_info, station_info);
+#endif
+
 #if WLAN_SW_CONFIG_ENABLE_LOGGING
 						// Log the high-level transmission and call the application callback
 						tx_high_event_log_entry = wlan_exp_log_create_tx_high_entry(tx_frame_info);
 #endif //WLAN_SW_CONFIG_ENABLE_LOGGING
 						mpdu_tx_high_done_callback(tx_frame_info, station_info, tx_high_event_log_entry);
 
+						// Wait for the CDMA copies out of the tx_pkt_buf (e.g. the TX_HIGH log entry)
+						wlan_mac_high_cdma_finish_transfer();
+
 						tx_frame_info->tx_pkt_buf_state = TX_PKT_BUF_HIGH_CTRL;
 					break;
 					// Something has gone wrong - TX_DONE message disagrees
@@ -1412,7 +1601,7 @@ void wlan_mac_high_process_ipc_msg(wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_pa
 					break;
 				}
 			} else {
-				xil_printf("Error: IPC_MBOX_TX_PKT_BUF_DONE with invalid pkt buf index %d\n ", tx_pkt_buf);
+				wlan_dprintf(PL_ERROR, "Error: IPC_MBOX_TX_PKT_BUF_DONE with invalid pkt buf index %d\n ", tx_pkt_buf);
 			}
 
 		} break;
@@ -1436,6 +1625,7 @@ void wlan_mac_high_process_ipc_msg(wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_pa
 				break;
 
 				case CPU_STATUS_REASON_BOOTED:
+					cpu_low_prof_table = ipc_msg_from_low_payload[2 + (sizeof(compilation_details_t) / sizeof(u32))];
 
 					// Notify the high-level project that CPU_LOW has rebooted
 					cpu_low_reboot_callback(ipc_msg_from_low_payload[1]);
@@ -1455,6 +1645,8 @@ void wlan_mac_high_process_ipc_msg(wlan_ipc_msg_t* msg, u32* ipc_msg_from_low_pa
 				break;
 
 				case CPU_STATUS_REASON_RESPONSE:
+					cpu_low_prof_table = ipc_msg_from_low_payload[2 + (sizeof(compilation_details_t) / sizeof(u32))];
+
 					// Set the CPU_LOW wlan_exp type
 #if WLAN_SW_CONFIG_ENABLE_WLAN_EXP
 
@@ -1820,6 +2012,31 @@ int wlan_mac_high_read_low_mem(u32 num_words, u32 baseaddr, u32* payload) {
 
 
 
+/**
+ * @brief Read a profiling probe of CPU low
+ *
+ * CPU Low passes the address of its probes in the CPU status message.  The probe
+ * is read with wlan_mac_high_read_low_mem().
+ *
+ * @param   u32 probe_id         - Probe ID (PROF_PROBE_*)
+ * @param   prof_probe_t * probe - Pointer to the statistics to fill in
+ *
+ * @return  int              - Status of command:  0 = Success; -1 = Failure (including CPU
+ *                             Low not compiled with profiling)
+ */
+int wlan_mac_high_read_low_prof_probe(u32 probe_id, prof_probe_t* probe) {
+
+    if ((cpu_low_prof_table == 0) || (probe_id >= NUM_PROF_PROBES)) {
+        return -1;
+    }
+
+    return wlan_mac_high_read_low_mem((sizeof(prof_probe_t) / sizeof(u32)),
+                                      (cpu_low_prof_table + (probe_id * sizeof(prof_probe_t))),
+                                      (u32*)probe);
+}
+
+
+
 /**
  * @brief Write a parameter in CPU low
  *
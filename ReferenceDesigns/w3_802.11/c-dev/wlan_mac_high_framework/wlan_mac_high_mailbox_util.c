@@ -44,9 +44,31 @@ void wlan_mac_high_init_mailbox(){
  * @return None
  */
 void wlan_mac_high_ipc_rx(){
+	u32 num_rx = 0;
+	u32 num_tx_reports = 0;
+
 	while (read_mailbox_msg(&ipc_msg_from_low) == IPC_MBOX_SUCCESS) {
+		switch (IPC_MBOX_MSG_ID_TO_MSG(ipc_msg_from_low.msg_id)) {
+			case IPC_MBOX_RX_PKT_BUF_READY:
+				num_rx++;
+			break;
+
+			case IPC_MBOX_PHY_TX_REPORT:
+				// Prepare for this Tx report and any reports behind it in the IPC ring
+				if ((num_tx_reports++) == 0) {
+					wlan_mac_high_tx_report_batch_start(ipc_rx_num_pending_words());
+				}
+			break;
+		}
+
 		wlan_mac_high_process_ipc_msg(&ipc_msg_from_low, ipc_msg_from_low_payload);
 	}
+
+	if (num_tx_reports) {
+		wlan_mac_high_tx_report_batch_done();
+	}
+
+	wlan_mac_high_rx_batch_done(num_rx);
 }
 
 /*****************************************************************************/
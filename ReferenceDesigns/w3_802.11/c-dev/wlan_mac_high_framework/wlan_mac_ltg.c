@@ -32,6 +32,7 @@
 #include "wlan_mac_schedule.h"
 #include "wlan_platform_common.h"
 #include "wlan_mac_packet_types.h"
+#include "wlan_mac_pool.h"
 
 #if WLAN_SW_CONFIG_ENABLE_LTG
 
@@ -110,8 +111,8 @@ u32 ltg_sched_create(u32 type, void* params, void* callback_arg, void(*cleanup_c
 
 	switch(type){
 		case LTG_SCHED_TYPE_PERIODIC:
-			curr_tg->params = wlan_mac_high_malloc(sizeof(ltg_sched_periodic_params));
-			curr_tg->state  = wlan_mac_high_malloc(sizeof(ltg_sched_periodic_state));
+			curr_tg->params = wlan_mac_pool_alloc(MEM_POOL_LTG_PARAMS);
+			curr_tg->state  = wlan_mac_pool_alloc(MEM_POOL_LTG_PARAMS);
 
 			if(curr_tg->params != NULL && curr_tg->state != NULL){
                 bzero(curr_tg->state, sizeof(ltg_sched_periodic_state));
@@ -125,8 +126,8 @@ u32 ltg_sched_create(u32 type, void* params, void* callback_arg, void(*cleanup_c
 		break;
 
 		case LTG_SCHED_TYPE_UNIFORM_RAND:
-			curr_tg->params = wlan_mac_high_malloc(sizeof(ltg_sched_uniform_rand_params));
-			curr_tg->state  = wlan_mac_high_malloc(sizeof(ltg_sched_uniform_rand_state));
+			curr_tg->params = wlan_mac_pool_alloc(MEM_POOL_LTG_PARAMS);
+			curr_tg->state  = wlan_mac_pool_alloc(MEM_POOL_LTG_PARAMS);
 
 			if(curr_tg->params != NULL && curr_tg->state != NULL){
                 bzero(curr_tg->state, sizeof(ltg_sched_uniform_rand_state));
@@ -156,13 +157,13 @@ dl_entry* ltg_sched_create_l(){
 	dl_entry* curr_tg_dl_entry;
 	tg_schedule* curr_tg;
 
-	curr_tg_dl_entry = (dl_entry*)wlan_mac_high_malloc(sizeof(dl_entry));
+	curr_tg_dl_entry = (dl_entry*)wlan_mac_pool_alloc(MEM_POOL_DL_ENTRY);
 
 	if(curr_tg_dl_entry == NULL){
 		return NULL;
 	}
 
-	curr_tg = (tg_schedule*)wlan_mac_high_malloc(sizeof(tg_schedule));
+	curr_tg = (tg_schedule*)wlan_mac_pool_alloc(MEM_POOL_LTG);
 
 	if(curr_tg == NULL){
 		wlan_mac_high_free(curr_tg_dl_entry);
@@ -615,7 +616,7 @@ void * ltg_sched_deserialize(u32 * src, u32 * ret_type, u32 * ret_size) {
     switch(type){
         case LTG_SCHED_TYPE_PERIODIC:
         	if (size == 3){
-        		ret_val = (void *) wlan_mac_high_malloc(sizeof(ltg_sched_periodic_params));
+        		ret_val = (void *) wlan_mac_pool_alloc(MEM_POOL_LTG_PARAMS);
         	    if (ret_val != NULL){
         	    	((ltg_sched_periodic_params *)ret_val)->interval_count = (Xil_Ntohl(src[1]))/LTG_POLL_INTERVAL;
 
@@ -632,7 +633,7 @@ void * ltg_sched_deserialize(u32 * src, u32 * ret_type, u32 * ret_size) {
 
         case LTG_SCHED_TYPE_UNIFORM_RAND:
         	if (size == 4){
-        		ret_val = (void *) wlan_mac_high_malloc(sizeof(ltg_sched_uniform_rand_params));
+        		ret_val = (void *) wlan_mac_pool_alloc(MEM_POOL_LTG_PARAMS);
         	    if (ret_val != NULL){
         	    	((ltg_sched_uniform_rand_params *)ret_val)->min_interval_count = Xil_Ntohl(src[1])/LTG_POLL_INTERVAL;
         	    	((ltg_sched_uniform_rand_params *)ret_val)->max_interval_count = Xil_Ntohl(src[2])/LTG_POLL_INTERVAL;
@@ -675,7 +676,7 @@ void * ltg_payload_deserialize(u32 * src, u32 * ret_type, u32 * ret_size) {
     switch(type){
         case LTG_PYLD_TYPE_FIXED:
         	if (size == 3){
-        		ret_val = (void *) wlan_mac_high_malloc(sizeof(ltg_pyld_fixed));
+        		ret_val = (void *) wlan_mac_pool_alloc(MEM_POOL_LTG_PAYLOAD);
         	    if (ret_val != NULL){
 					((ltg_pyld_fixed *)ret_val)->hdr.type = LTG_PYLD_TYPE_FIXED;
 					wlan_exp_get_mac_addr(&src[1], &((ltg_pyld_fixed *)ret_val)->addr_da[0]);
@@ -688,7 +689,7 @@ void * ltg_payload_deserialize(u32 * src, u32 * ret_type, u32 * ret_size) {
 
         case LTG_PYLD_TYPE_UNIFORM_RAND:
         	if (size == 4){
-        		ret_val = (void *) wlan_mac_high_malloc(sizeof(ltg_pyld_uniform_rand));
+        		ret_val = (void *) wlan_mac_pool_alloc(MEM_POOL_LTG_PAYLOAD);
         	    if (ret_val != NULL){
 					((ltg_pyld_uniform_rand *)ret_val)->hdr.type   = LTG_PYLD_TYPE_UNIFORM_RAND;
 					wlan_exp_get_mac_addr(&src[1], &((ltg_pyld_fixed *)ret_val)->addr_da[0]);
@@ -703,7 +704,7 @@ void * ltg_payload_deserialize(u32 * src, u32 * ret_type, u32 * ret_size) {
 
         case LTG_PYLD_TYPE_ALL_ASSOC_FIXED:
         	if (size == 1){
-        		ret_val = (void *) wlan_mac_high_malloc(sizeof(ltg_pyld_all_assoc_fixed));
+        		ret_val = (void *) wlan_mac_pool_alloc(MEM_POOL_LTG_PAYLOAD);
         	    if (ret_val != NULL){
 					((ltg_pyld_all_assoc_fixed *)ret_val)->hdr.type = LTG_PYLD_TYPE_ALL_ASSOC_FIXED;
         	    	((ltg_pyld_all_assoc_fixed *)ret_val)->length   = Xil_Ntohl(src[1]) & 0xFFFF;
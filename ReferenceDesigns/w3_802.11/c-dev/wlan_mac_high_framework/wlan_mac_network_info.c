@@ -34,6 +34,7 @@
 #include "wlan_mac_mgmt_tags.h"
 #include "wlan_mac_packet_types.h"
 #include "wlan_mac_common.h"
+#include "wlan_mac_pool.h"
 
 /*********************** Global Variable Definitions *************************/
 
@@ -406,7 +407,7 @@ dl_list* wlan_mac_high_find_network_info_SSID(char* ssid){
 		curr_network_info = curr_network_info_entry_primary_list->data;
 
 		if (strcmp(ssid, curr_network_info->bss_config.ssid) == 0) {
-			curr_network_info_entry_match_list = wlan_mac_high_malloc(sizeof(network_info_entry_t));
+			curr_network_info_entry_match_list = wlan_mac_pool_alloc(MEM_POOL_NETWORK_ENTRY);
 			curr_network_info_entry_match_list->data = curr_network_info;
 			memcpy(curr_network_info_entry_match_list->bssid, curr_network_info->bss_config.bssid, MAC_ADDR_LEN);
 			dl_entry_insertEnd(&network_info_matching_ssid_list, (dl_entry*)curr_network_info_entry_match_list);
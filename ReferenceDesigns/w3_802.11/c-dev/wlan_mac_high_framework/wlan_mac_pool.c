@@ -0,0 +1,378 @@
+/** @file wlan_mac_pool.c
+ *  @brief Memory Pools
+ *
+ *  This contains code for the fixed-size object pools and the command arena
+ *  that CPU High uses for its runtime objects instead of the heap.
+ *
+ *  @copyright Copyright 2014-2017, Mango Communications. All rights reserved.
+ *          Distributed under the Mango Communications Reference Design License
+ *              See LICENSE.txt included in the design archive or
+ *              at http://mangocomm.com/802.11/license
+ *
+ *  This file is part of the Mango 802.11 Reference Design (https://mangocomm.com/802.11)
+ */
+
+/***************************** Include Files *********************************/
+
+#include "wlan_mac_high_sw_config.h"
+
+#include "stdio.h"
+#include "string.h"
+#include "xil_types.h"
+
+#include "wlan_mac_common.h"
+#include "wlan_mac_high.h"
+#include "wlan_mac_dl_list.h"
+#include "wlan_mac_schedule.h"
+#include "wlan_mac_ltg.h"
+#include "wlan_mac_addr_filter.h"
+#include "wlan_mac_network_info.h"
+#include "wlan_mac_station_info.h"
+#include "wlan_mac_pool.h"
+
+
+/*************************** Constant Definitions ****************************/
+
+// Objects are 8-byte aligned (u64 members)
+#define MEM_POOL_ALIGN(size)                               (((size) + 7) & ~7)
+
+// Object size of each pool
+#define MEM_POOL_SIZE_DL_ENTRY                             MEM_POOL_ALIGN(sizeof(dl_entry))
+#define MEM_POOL_SIZE_SCHEDULE                             MEM_POOL_ALIGN(sizeof(wlan_sched))
+#define MEM_POOL_SIZE_LTG                                  MEM_POOL_ALIGN(sizeof(tg_schedule))
+#define MEM_POOL_SIZE_LTG_PARAMS                           MEM_POOL_ALIGN(max(max(sizeof(ltg_sched_periodic_params),     \
+                                                                                  sizeof(ltg_sched_periodic_state)),      \
+                                                                              max(sizeof(ltg_sched_uniform_rand_params), \
+                                                                                  sizeof(ltg_sched_uniform_rand_state))))
+#define MEM_POOL_SIZE_LTG_PAYLOAD                          MEM_POOL_ALIGN(max(max(sizeof(ltg_pyld_fixed),               \
+                                                                                  sizeof(ltg_pyld_uniform_rand)),       \
+                                                                              sizeof(ltg_pyld_all_assoc_fixed)))
+#define MEM_POOL_SIZE_ADDR_RANGE                           MEM_POOL_ALIGN(sizeof(whitelist_range))
+#define MEM_POOL_SIZE_STATION_ENTRY                        MEM_POOL_ALIGN(sizeof(station_info_entry_t))
+#define MEM_POOL_SIZE_NETWORK_ENTRY                        MEM_POOL_ALIGN(sizeof(network_info_entry_t))
+
+// Total size of the pools
+#define MEM_POOL_STORAGE_SIZE                              ((MEM_POOL_NUM_DL_ENTRY      * MEM_POOL_SIZE_DL_ENTRY)      + \
+                                                            (MEM_POOL_NUM_SCHEDULE      * MEM_POOL_SIZE_SCHEDULE)      + \
+                                                            (MEM_POOL_NUM_LTG           * MEM_POOL_SIZE_LTG)           + \
+                                                            (MEM_POOL_NUM_LTG_PARAMS    * MEM_POOL_SIZE_LTG_PARAMS)    + \
+                                                            (MEM_POOL_NUM_LTG_PAYLOAD   * MEM_POOL_SIZE_LTG_PAYLOAD)   + \
+                                                            (MEM_POOL_NUM_ADDR_RANGE    * MEM_POOL_SIZE_ADDR_RANGE)    + \
+                                                            (MEM_POOL_NUM_STATION_ENTRY * MEM_POOL_SIZE_STATION_ENTRY) + \
+                                                            (MEM_POOL_NUM_NETWORK_ENTRY * MEM_POOL_SIZE_NETWORK_ENTRY))
+
+
+/*********************** Global Structure Definitions ************************/
+
+typedef struct mem_pool_t{
+    u8*               base;                ///< First object of the pool
+    u8*               high;                ///< Last byte of the pool
+    void*             free_list;           ///< Free objects (the first word of a free object points to the next one)
+    mem_pool_info_t   info;
+} mem_pool_t;
+
+
+/*************************** Variable Definitions ****************************/
+
+static u64              mem_pool_storage[MEM_POOL_STORAGE_SIZE / sizeof(u64)];
+static mem_pool_t       mem_pools[NUM_MEM_POOLS];
+
+static u64              mem_arena[MEM_ARENA_SIZE / sizeof(u64)];
+static u32              mem_arena_offset;  ///< Offset of the first free byte of the arena
+static u32              mem_arena_last;    ///< Offset of the most recent allocation
+static mem_pool_info_t  mem_arena_info;
+
+static const char*      mem_pool_names[NUM_MEM_POOL_INFO] = {
+    "dl_entry", "schedule", "ltg", "ltg_params", "ltg_payload", "addr_range", "station_entry", "network_entry",
+    "arena", "heap"
+};
+
+
+/*************************** Functions Prototypes ****************************/
+
+void mem_pool_setup(u32 pool_id, u8** next_obj, u32 obj_size, u32 num_objs);
+
+
+/******************************** Functions **********************************/
+
+/*****************************************************************************/
+/**
+ * Initialize the memory pools
+ *
+ * Carves the pools out of the pool storage and puts all of their objects on the
+ * free lists.  Must be called before any subsystem allocates from a pool.
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_pool_init(){
+    u8* next_obj = (u8*)mem_pool_storage;
+
+    mem_pool_setup(MEM_POOL_DL_ENTRY,      &next_obj, MEM_POOL_SIZE_DL_ENTRY,      MEM_POOL_NUM_DL_ENTRY);
+    mem_pool_setup(MEM_POOL_SCHEDULE,      &next_obj, MEM_POOL_SIZE_SCHEDULE,      MEM_POOL_NUM_SCHEDULE);
+    mem_pool_setup(MEM_POOL_LTG,           &next_obj, MEM_POOL_SIZE_LTG,           MEM_POOL_NUM_LTG);
+    mem_pool_setup(MEM_POOL_LTG_PARAMS,    &next_obj, MEM_POOL_SIZE_LTG_PARAMS,    MEM_POOL_NUM_LTG_PARAMS);
+    mem_pool_setup(MEM_POOL_LTG_PAYLOAD,   &next_obj, MEM_POOL_SIZE_LTG_PAYLOAD,   MEM_POOL_NUM_LTG_PAYLOAD);
+    mem_pool_setup(MEM_POOL_ADDR_RANGE,    &next_obj, MEM_POOL_SIZE_ADDR_RANGE,    MEM_POOL_NUM_ADDR_RANGE);
+    mem_pool_setup(MEM_POOL_STATION_ENTRY, &next_obj, MEM_POOL_SIZE_STATION_ENTRY, MEM_POOL_NUM_STATION_ENTRY);
+    mem_pool_setup(MEM_POOL_NETWORK_ENTRY, &next_obj, MEM_POOL_SIZE_NETWORK_ENTRY, MEM_POOL_NUM_NETWORK_ENTRY);
+
+    bzero(&mem_arena_info, sizeof(mem_pool_info_t));
+    mem_arena_info.obj_size  = 1;
+    mem_arena_info.num_total = MEM_ARENA_SIZE;
+    mem_arena_offset         = 0;
+    mem_arena_last           = 0;
+}
+
+
+
+void mem_pool_setup(u32 pool_id, u8** next_obj, u32 obj_size, u32 num_objs){
+    u32          i;
+    mem_pool_t*  pool = &(mem_pools[pool_id]);
+
+    bzero(pool, sizeof(mem_pool_t));
+
+    pool->base           = *next_obj;
+    pool->high           = *next_obj + (obj_size * num_objs) - 1;
+    pool->info.obj_size  = obj_size;
+    pool->info.num_total = num_objs;
+
+    // Build the free list so that objects are handed out in address order
+    for (i = num_objs; i > 0; i--) {
+        *((void**)(pool->base + ((i - 1) * obj_size))) = pool->free_list;
+        pool->free_list = pool->base + ((i - 1) * obj_size);
+    }
+
+    *next_obj += obj_size * num_objs;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Allocate an object from a memory pool
+ *
+ * If the pool is empty, the object is allocated with wlan_mac_high_malloc().
+ * In both cases it must be freed with wlan_mac_high_free().  The contents of
+ * the object are not initialized.
+ *
+ * @param   pool_id          - Pool of the object (MEM_POOL_*)
+ *
+ * @return  void*            - Pointer to the object
+ *                             NULL if the object could not be allocated
+ *
+ *****************************************************************************/
+void* wlan_mac_pool_alloc(u32 pool_id){
+    void*              obj;
+    mem_pool_t*        pool;
+    interrupt_state_t  prev_interrupt_state;
+
+    if (pool_id >= NUM_MEM_POOLS) { return NULL; }
+
+    pool = &(mem_pools[pool_id]);
+
+    // Schedules and their objects are created from interrupt context
+    prev_interrupt_state = wlan_mac_high_interrupt_stop();
+
+    pool->info.num_alloc++;
+
+    obj = pool->free_list;
+
+    if (obj != NULL) {
+        pool->free_list = *((void**)obj);
+
+        pool->info.num_live++;
+        if (pool->info.num_live > pool->info.max_live) { pool->info.max_live = pool->info.num_live; }
+    } else {
+        obj = wlan_mac_high_malloc(pool->info.obj_size);
+
+        if (obj != NULL) {
+            pool->info.num_fallback++;
+        } else {
+            pool->info.num_failed++;
+        }
+    }
+
+    wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+
+    return obj;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Return memory to its pool
+ *
+ * Called by wlan_mac_high_free() for every address it frees.  Pool objects are
+ * put back on the free list of their pool; for allocations of the command
+ * arena, only the most recent allocation is returned (all others are returned
+ * by wlan_mac_arena_reset()).
+ *
+ * @param   addr             - Address to free
+ *
+ * @return  int              - 0 if the address belongs to a pool or the arena
+ *                            -1 otherwise (ie the address must be freed to the heap)
+ *
+ *****************************************************************************/
+int wlan_mac_pool_free(void* addr){
+    u32                pool_id;
+    mem_pool_t*        pool;
+    u8*                obj = (u8*)addr;
+    interrupt_state_t  prev_interrupt_state;
+
+    // Command arena
+    if ((obj >= (u8*)mem_arena) && (obj < ((u8*)mem_arena + MEM_ARENA_SIZE))) {
+        if (obj == ((u8*)mem_arena + mem_arena_last)) {
+            mem_arena_info.num_live -= (mem_arena_offset - mem_arena_last);
+            mem_arena_offset         = mem_arena_last;
+        }
+        return 0;
+    }
+
+    if ((obj < (u8*)mem_pool_storage) || (obj >= ((u8*)mem_pool_storage + sizeof(mem_pool_storage)))) {
+        return -1;
+    }
+
+    for (pool_id = 0; pool_id < NUM_MEM_POOLS; pool_id++) {
+        pool = &(mem_pools[pool_id]);
+
+        if ((pool->info.num_total != 0) && (obj >= pool->base) && (obj <= pool->high)) {
+
+            if (((u32)(obj - pool->base) % pool->info.obj_size) != 0) {
+                xil_printf("ERROR:  Free of invalid address 0x%08x in memory pool %s\n", (u32)addr, mem_pool_names[pool_id]);
+                return 0;
+            }
+
+            prev_interrupt_state = wlan_mac_high_interrupt_stop();
+
+            *((void**)obj)  = pool->free_list;
+            pool->free_list = obj;
+            pool->info.num_live--;
+
+            wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Allocate memory from the command arena
+ *
+ * The memory is only valid until the end of the current wlan_exp command (see
+ * wlan_mac_arena_reset()).  It does not need to be freed.
+ *
+ * @param   size             - Number of bytes to allocate
+ *
+ * @return  void*            - Pointer to the memory (8-byte aligned)
+ *                             NULL if the arena does not have enough space
+ *
+ * @note    The arena is not interrupt safe and must only be used from the main loop
+ *          (ie by the processing of wlan_exp commands).
+ *
+ *****************************************************************************/
+void* wlan_mac_arena_alloc(u32 size){
+    u32 alloc_size = MEM_POOL_ALIGN(size);
+
+    mem_arena_info.num_alloc++;
+
+    if ((alloc_size == 0) || (alloc_size > (MEM_ARENA_SIZE - mem_arena_offset))) {
+        mem_arena_info.num_failed++;
+        xil_printf("ERROR:  Command arena cannot allocate %d bytes (%d of %d bytes in use)\n", size, mem_arena_offset, MEM_ARENA_SIZE);
+        return NULL;
+    }
+
+    mem_arena_last    = mem_arena_offset;
+    mem_arena_offset += alloc_size;
+
+    mem_arena_info.num_live = mem_arena_offset;
+    if (mem_arena_info.num_live > mem_arena_info.max_live) { mem_arena_info.max_live = mem_arena_info.num_live; }
+
+    return (void*)((u8*)mem_arena + mem_arena_last);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Reset the command arena
+ *
+ * Returns all allocations of the command arena.  Called after the processing
+ * of each wlan_exp command.
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_arena_reset(){
+    mem_arena_offset        = 0;
+    mem_arena_last          = 0;
+    mem_arena_info.num_live = 0;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Get the allocation statistics
+ *
+ * @param   info_id          - Pool (MEM_POOL_*), MEM_POOL_INFO_ARENA or MEM_POOL_INFO_HEAP
+ * @param   info             - Pointer to statistics to fill in
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_pool_get_info(u32 info_id, mem_pool_info_t* info){
+    interrupt_state_t  prev_interrupt_state;
+
+    if (info_id < NUM_MEM_POOLS) {
+        // Get a consistent snapshot of the pool
+        prev_interrupt_state = wlan_mac_high_interrupt_stop();
+        memcpy(info, &(mem_pools[info_id].info), sizeof(mem_pool_info_t));
+        wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+
+    } else if (info_id == MEM_POOL_INFO_ARENA) {
+        memcpy(info, &mem_arena_info, sizeof(mem_pool_info_t));
+
+    } else if (info_id == MEM_POOL_INFO_HEAP) {
+        wlan_mac_high_get_heap_info(info);
+
+    } else {
+        bzero(info, sizeof(mem_pool_info_t));
+    }
+}
+
+
+
+/*****************************************************************************/
+/**
+ * Print the allocation statistics
+ *
+ * @param   None
+ *
+ * @return  None
+ *
+ *****************************************************************************/
+void wlan_mac_pool_display_info(){
+    u32              i;
+    mem_pool_info_t  info;
+
+    xil_printf("Memory Pools:\n");
+    xil_printf("   %-14s %5s %6s %6s %6s %10s %8s %6s\n", "Pool", "Size", "Total", "Live", "Max", "Allocs", "Fallback", "Failed");
+
+    for (i = 0; i < NUM_MEM_POOL_INFO; i++) {
+        wlan_mac_pool_get_info(i, &info);
+
+        xil_printf("   %-14s %5d %6d %6d %6d %10d %8d %6d\n", mem_pool_names[i], info.obj_size, info.num_total,
+                   info.num_live, info.max_live, info.num_alloc, info.num_fallback, info.num_failed);
+    }
+}
@@ -19,6 +19,7 @@
 #include "xil_types.h"
 #include "stdlib.h"
 #include "stdio.h"
+#include "stddef.h"
 #include "wlan_platform_high.h"
 #include "xintc.h"
 #include "string.h"
@@ -32,6 +33,8 @@
 #include "wlan_mac_pkt_buf_util.h"
 #include "wlan_platform_common.h"
 #include "wlan_mac_station_info.h"
+#include "wlan_mac_dprint.h"
+#include "wlan_mac_entries.h"
 
 // WLAN Exp includes
 #include "wlan_exp_common.h"
@@ -52,10 +55,42 @@ extern platform_high_dev_info_t platform_high_dev_info;
 
 /*************************** Functions Prototypes ****************************/
 
+static void         _queue_init_class(u8 buffer_class, u32 buffer_base, dl_entry* dl_entry_base, u32 num_buffers);
+static inline void  _queue_update_min_free(u8 buffer_class);
+static inline u32   _queue_delay(u64 start_timestamp, u64 end_timestamp);
+
+static dl_entry*    _queue_remove_head(u16 queue_sel);
+static void         _queue_drop(u16 queue_sel, dl_entry* tqe, u8 reason);
+static void         _queue_aqm_grow(u16 queue_sel);
+static dl_entry*    _queue_codel_dequeue(u16 queue_sel, queue_aqm_t* aqm, dl_entry* tqe);
+static u8           _queue_codel_ok_to_drop(u16 queue_sel, queue_aqm_t* aqm, dl_entry* tqe, u64 system_time);
+static inline u64   _queue_codel_control_law(queue_aqm_t* aqm, u64 t);
+static u32          _queue_isqrt(u32 value);
+
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+static void         _queue_stats_grow(u16 queue_sel);
+static inline void  _queue_stats_dequeue(u16 queue_sel, dl_entry* tqe);
+static inline void  _queue_hist_add(queue_hist_t* hist, u32 value);
+#endif
+
 /*************************** Variable Definitions ****************************/
 
-// List to hold all of the empty, free entries
-static dl_list free_queue;
+// Lists to hold all of the empty, free entries (one list per buffer size class)
+static dl_list free_queue[NUM_QUEUE_BUFFER_CLASSES];
+
+// Size of the buffers in each class
+static const u32 queue_buffer_sizes[NUM_QUEUE_BUFFER_CLASSES] = { QUEUE_BUFFER_SIZE_SMALL,
+                                                                  QUEUE_BUFFER_SIZE_MEDIUM,
+                                                                  QUEUE_BUFFER_SIZE_LARGE };
+
+// dl_entry array of each class
+//     NOTE:  The dl_entry structs of a class are contiguous, so the class of a Tx queue entry can
+//         be found from the address of its dl_entry.  This does not depend on the contents of the
+//         buffer, which some callers use as scratch space.
+static dl_entry* queue_dl_entry_base[NUM_QUEUE_BUFFER_CLASSES];
+
+// Occupancy of each class
+static queue_buffer_class_info_t queue_class_info[NUM_QUEUE_BUFFER_CLASSES];
 
 // The tx_queues variable is an array of lists that will be filled with queue
 // entries from the free_queue list
@@ -73,6 +108,22 @@ static dl_list free_queue;
 static dl_list* tx_queues;
 static u16 num_tx_queues;
 
+// AQM policy, drop counters and CoDel state of each queue (indexed by queue ID like tx_queues)
+//     NOTE:  Queues without an entry use the default policy (tail drop) and their drops are
+//         not counted.
+//
+static queue_aqm_t* queue_aqm;
+static u16 num_queue_aqm;
+
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+// Statistics of each queue (indexed by queue ID like tx_queues)
+//     NOTE:  num_queue_stats can be smaller than num_tx_queues if the array could
+//         not be reallocated.  Queues without statistics are not counted.
+//
+static queue_stats_t* queue_stats;
+static u16 num_queue_stats;
+#endif
+
 
 // Total number of Tx queue entries
 static volatile u32 total_tx_queue_entries;
@@ -84,21 +135,21 @@ static volatile u32 total_tx_queue_entries;
 /**
  * @brief  Initialize the Tx Queue framework
  *
- * The number of Tx Queue elements we can initialize is limited by the smaller of two values:
- *     (1) The number of dl_entry structs we can squeeze into TX_QUEUE_DL_ENTRY_MEM_SIZE
- *     (2) The number of QUEUE_BUFFER_SIZE MPDU buffers we can squeeze into TX_QUEUE_BUFFER_SIZE
+ * The Tx Queue buffers are split into size classes (see wlan_mac_queue.h):
+ *     (1) QUEUE_NUM_LARGE_BUFFERS LARGE buffers
+ *     (2) MEDIUM buffers for the rest of the dl_entry structs we can squeeze into
+ *         TX_QUEUE_DL_ENTRY_MEM_SIZE
+ *     (3) SMALL buffers for the rest of TX_QUEUE_BUFFER_SIZE
  *
- * @param  u8 dram_present        - Flag to indicate if DRAM is present
- *                                  (1 = present; other = not present)
+ * The AUX BRAM only has room for the dl_entry structs of the LARGE and MEDIUM classes.
+ * The dl_entry structs of the SMALL class are placed in DRAM after the SMALL buffers.
  *
  *****************************************************************************/
 void queue_init() {
-	u32 i;
-	dl_entry* dl_entry_base;
-
-	// Set the total number of supported Tx Queue entries
-	total_tx_queue_entries = min((TX_QUEUE_DL_ENTRY_MEM_SIZE / sizeof(dl_entry)),   // Max dl_entry
-	                             (TX_QUEUE_BUFFER_SIZE / QUEUE_BUFFER_SIZE));       // Max buffers
+	u32 num_bram_entries;
+	u32 buffer_base;
+	u32 buffer_bytes_free;
+	u32 num_buffers[NUM_QUEUE_BUFFER_CLASSES];
 
 	// Initialize the Tx queue
 	//     NOTE:  tx_queues is initially NULL because it will be dynamically allocated and
@@ -107,44 +158,109 @@ void queue_init() {
 	tx_queues = NULL;
 	num_tx_queues = 0;
 
-	queue_state_change_callback = (function_ptr_t)wlan_null_callback;
+	queue_aqm = NULL;
+	num_queue_aqm = 0;
+
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+	queue_stats = NULL;
+	num_queue_stats = 0;
+#endif
 
-	// Initialize the free queue
-	dl_list_init(&free_queue);
+	queue_state_change_callback = (function_ptr_t)wlan_null_callback;
 
 	// Zero all Tx queue elements
 	bzero((void*)TX_QUEUE_BUFFER_BASE, TX_QUEUE_BUFFER_SIZE);
 
-	// Allocate the memory space into Tx Queue entries
-	//
-	// All Tx Queue entries are initially part of the free queue.  Each Tx Queue entry consists of:
-	//     (1) Buffer to hold data
-	//     (1) dl_entry to describe the buffer
-	//
-	// NOTE:  The code below exploits the fact that the starting state of all Tx Queue entries is
-	//     sequential.  Therefore, it can use matrix addressing.  Matrix addressing is not safe
-	//     once the queue is used and the insert/remove helper functions should be used instead.
-	//
-	dl_entry_base = (dl_entry*)(TX_QUEUE_DL_ENTRY_MEM_BASE);
+	// Split the AUX BRAM dl_entry structs between the LARGE and MEDIUM classes
+	num_bram_entries  = TX_QUEUE_DL_ENTRY_MEM_SIZE / sizeof(dl_entry);
+	buffer_bytes_free = TX_QUEUE_BUFFER_SIZE;
 
-	for (i = 0; i < total_tx_queue_entries; i++) {
-		// Segment the buffer in QUEUE_BUFFER_SIZE pieces
-		dl_entry_base[i].data = (void*)(TX_QUEUE_BUFFER_BASE + (i * QUEUE_BUFFER_SIZE));
+	num_buffers[QUEUE_BUFFER_CLASS_LARGE]  = min(min(QUEUE_NUM_LARGE_BUFFERS, num_bram_entries),
+	                                             (buffer_bytes_free / QUEUE_BUFFER_SIZE_LARGE));
+	buffer_bytes_free                     -= num_buffers[QUEUE_BUFFER_CLASS_LARGE] * QUEUE_BUFFER_SIZE_LARGE;
 
-        // Copy the pointer to the dl_entry into the DRAM payload. This will allow any context
-		// (like Ethernet Rx) to find the dl_entry that points to a given DRAM payload
-        ((tx_queue_buffer_t*)(dl_entry_base[i].data))->tx_queue_entry = &(dl_entry_base[i]);
+	num_buffers[QUEUE_BUFFER_CLASS_MEDIUM] = min((num_bram_entries - num_buffers[QUEUE_BUFFER_CLASS_LARGE]),
+	                                             (buffer_bytes_free / QUEUE_BUFFER_SIZE_MEDIUM));
+	buffer_bytes_free                     -= num_buffers[QUEUE_BUFFER_CLASS_MEDIUM] * QUEUE_BUFFER_SIZE_MEDIUM;
 
-		// Insert new dl_entry into the free queue
-		dl_entry_insertEnd(&free_queue, &(dl_entry_base[i]));
-	}
+	// SMALL buffers and their dl_entry structs use the rest of the DRAM
+	num_buffers[QUEUE_BUFFER_CLASS_SMALL]  = buffer_bytes_free / (QUEUE_BUFFER_SIZE_SMALL + sizeof(dl_entry));
+
+	// Allocate the memory space into Tx Queue entries
+	//     NOTE:  The buffers are placed from the largest to the smallest class so every buffer
+	//         is aligned to its size
+	buffer_base = TX_QUEUE_BUFFER_BASE;
 
+	_queue_init_class(QUEUE_BUFFER_CLASS_LARGE, buffer_base, (dl_entry*)(TX_QUEUE_DL_ENTRY_MEM_BASE),
+	                  num_buffers[QUEUE_BUFFER_CLASS_LARGE]);
+	buffer_base += num_buffers[QUEUE_BUFFER_CLASS_LARGE] * QUEUE_BUFFER_SIZE_LARGE;
 
+	_queue_init_class(QUEUE_BUFFER_CLASS_MEDIUM, buffer_base, (dl_entry*)(TX_QUEUE_DL_ENTRY_MEM_BASE) + num_buffers[QUEUE_BUFFER_CLASS_LARGE],
+	                  num_buffers[QUEUE_BUFFER_CLASS_MEDIUM]);
+	buffer_base += num_buffers[QUEUE_BUFFER_CLASS_MEDIUM] * QUEUE_BUFFER_SIZE_MEDIUM;
 
+	_queue_init_class(QUEUE_BUFFER_CLASS_SMALL, buffer_base, (dl_entry*)(buffer_base + (num_buffers[QUEUE_BUFFER_CLASS_SMALL] * QUEUE_BUFFER_SIZE_SMALL)),
+	                  num_buffers[QUEUE_BUFFER_CLASS_SMALL]);
+
+	// Set the total number of supported Tx Queue entries
+	total_tx_queue_entries = num_buffers[QUEUE_BUFFER_CLASS_SMALL] + num_buffers[QUEUE_BUFFER_CLASS_MEDIUM] + num_buffers[QUEUE_BUFFER_CLASS_LARGE];
 
 	// Print status
 	xil_printf("Tx Queue of %d placed in DRAM: using %d kB\n", total_tx_queue_entries,
-	           ((total_tx_queue_entries * QUEUE_BUFFER_SIZE) / 1024));
+	           ((TX_QUEUE_BUFFER_SIZE - buffer_bytes_free + (num_buffers[QUEUE_BUFFER_CLASS_SMALL] * (QUEUE_BUFFER_SIZE_SMALL + sizeof(dl_entry)))) / 1024));
+	xil_printf("    %d x %d B, %d x %d B, %d x %d B\n",
+	           num_buffers[QUEUE_BUFFER_CLASS_SMALL], QUEUE_BUFFER_SIZE_SMALL,
+	           num_buffers[QUEUE_BUFFER_CLASS_MEDIUM], QUEUE_BUFFER_SIZE_MEDIUM,
+	           num_buffers[QUEUE_BUFFER_CLASS_LARGE], QUEUE_BUFFER_SIZE_LARGE);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Initialize the Tx Queue entries of one buffer size class
+ *
+ * All Tx Queue entries are initially part of the free queue of their class.  Each Tx Queue
+ * entry consists of:
+ *     (1) Buffer to hold data
+ *     (1) dl_entry to describe the buffer
+ *
+ * NOTE:  The code below exploits the fact that the starting state of all Tx Queue entries is
+ *     sequential.  Therefore, it can use matrix addressing.  Matrix addressing is not safe
+ *     once the queue is used and the insert/remove helper functions should be used instead.
+ *
+ * @param  u8 buffer_class        - Buffer size class
+ * @param  u32 buffer_base        - Address of the first buffer
+ * @param  dl_entry* dl_entry_base - Address of the first dl_entry
+ * @param  u32 num_buffers        - Number of buffers in the class
+ *
+ *****************************************************************************/
+static void _queue_init_class(u8 buffer_class, u32 buffer_base, dl_entry* dl_entry_base, u32 num_buffers) {
+	u32 i;
+	u32 buffer_size = queue_buffer_sizes[buffer_class];
+
+	dl_list_init(&(free_queue[buffer_class]));
+
+	queue_dl_entry_base[buffer_class] = dl_entry_base;
+
+	bzero((void*)&(queue_class_info[buffer_class]), sizeof(queue_buffer_class_info_t));
+
+	queue_class_info[buffer_class].buffer_size   = buffer_size;
+	queue_class_info[buffer_class].max_frame_len = queue_class_max_frame_len(buffer_class);
+	queue_class_info[buffer_class].num_total     = num_buffers;
+	queue_class_info[buffer_class].min_free      = num_buffers;
+
+	for (i = 0; i < num_buffers; i++) {
+		// Segment the buffer in buffer_size pieces
+		dl_entry_base[i].data = (void*)(buffer_base + (i * buffer_size));
+
+        // Copy the pointer to the dl_entry into the DRAM payload. This will allow any context
+		// (like Ethernet Rx) to find the dl_entry that points to a given DRAM payload
+        ((tx_queue_buffer_t*)(dl_entry_base[i].data))->tx_queue_entry = &(dl_entry_base[i]);
+
+		// Insert new dl_entry into the free queue
+		dl_entry_insertEnd(&(free_queue[buffer_class]), &(dl_entry_base[i]));
+	}
 }
 
 
@@ -168,11 +284,139 @@ u32 queue_total_size(){
 /**
  * @brief  Number of free Tx Queue entries
  *
+ * This is the sum of the free Tx Queue entries of all buffer size classes
+ *
  * @return u32
  *
  *****************************************************************************/
 u32 queue_num_free(){
-	return free_queue.length;
+	return (free_queue[QUEUE_BUFFER_CLASS_SMALL].length +
+	        free_queue[QUEUE_BUFFER_CLASS_MEDIUM].length +
+	        free_queue[QUEUE_BUFFER_CLASS_LARGE].length);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Number of free Tx Queue entries of a buffer size class
+ *
+ * @param  u8 buffer_class        - Buffer size class
+ *
+ * @return u32
+ *
+ *****************************************************************************/
+u32 queue_num_free_class(u8 buffer_class){
+	if (buffer_class >= NUM_QUEUE_BUFFER_CLASSES) { return 0; }
+
+	return free_queue[buffer_class].length;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Max frame length of a buffer size class
+ *
+ * The frame of a tx_queue_buffer_t starts after its metadata, so a buffer of a given
+ * size holds (size - offsetof(tx_queue_buffer_t, frame)) bytes of frame, capped at
+ * MAX_PKT_SIZE_B.
+ *
+ * @param  u8 buffer_class        - Buffer size class
+ *
+ * @return u32                    - Max number of frame bytes (0 for an invalid class)
+ *
+ *****************************************************************************/
+u32 queue_class_max_frame_len(u8 buffer_class){
+	if (buffer_class >= NUM_QUEUE_BUFFER_CLASSES) { return 0; }
+
+	return min((queue_buffer_sizes[buffer_class] - offsetof(tx_queue_buffer_t, frame)), MAX_PKT_SIZE_B);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Smallest buffer size class that can hold a frame
+ *
+ * @param  u32 frame_length       - Length of the frame (in bytes)
+ *
+ * @return u8                     - Buffer size class
+ *                                  (QUEUE_BUFFER_CLASS_LARGE if the frame does not fit in any class)
+ *
+ *****************************************************************************/
+u8 queue_buffer_class(u32 frame_length){
+	u8 buffer_class;
+
+	for (buffer_class = QUEUE_BUFFER_CLASS_SMALL; buffer_class < QUEUE_BUFFER_CLASS_LARGE; buffer_class++) {
+		if (frame_length <= queue_class_max_frame_len(buffer_class)) {
+			break;
+		}
+	}
+
+	return buffer_class;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Buffer size class of a Tx Queue entry
+ *
+ * @param  dl_entry* tqe          - Tx Queue entry
+ *
+ * @return u8                     - Buffer size class (NUM_QUEUE_BUFFER_CLASSES if tqe is
+ *                                  not a Tx Queue entry)
+ *
+ *****************************************************************************/
+u8 queue_entry_class(dl_entry* tqe){
+	u8 buffer_class;
+
+	for (buffer_class = QUEUE_BUFFER_CLASS_SMALL; buffer_class < NUM_QUEUE_BUFFER_CLASSES; buffer_class++) {
+		if ((tqe >= queue_dl_entry_base[buffer_class]) &&
+		    (tqe < (queue_dl_entry_base[buffer_class] + queue_class_info[buffer_class].num_total))) {
+			break;
+		}
+	}
+
+	return buffer_class;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Get the occupancy of a buffer size class
+ *
+ * @param  u8 buffer_class        - Buffer size class
+ * @param  queue_buffer_class_info_t* info - Filled in with the occupancy of the class
+ *
+ * @return int                    - 0 on success, -1 for an invalid class
+ *
+ *****************************************************************************/
+int queue_get_class_info(u8 buffer_class, queue_buffer_class_info_t* info){
+	if ((buffer_class >= NUM_QUEUE_BUFFER_CLASSES) || (info == NULL)) { return -1; }
+
+	memcpy(info, &(queue_class_info[buffer_class]), sizeof(queue_buffer_class_info_t));
+
+	info->num_free = free_queue[buffer_class].length;
+
+	return 0;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Update the smallest number of free entries of a buffer size class
+ *
+ * @param  u8 buffer_class        - Buffer size class
+ *
+ *****************************************************************************/
+static inline void _queue_update_min_free(u8 buffer_class){
+	if (free_queue[buffer_class].length < queue_class_info[buffer_class].min_free) {
+		queue_class_info[buffer_class].min_free = free_queue[buffer_class].length;
+	}
 }
 
 
@@ -236,7 +480,8 @@ void purge_queue(u16 queue_sel){
 			//
 			prev_interrupt_state = wlan_mac_high_interrupt_stop();
 
-			curr_tx_queue_element = dequeue_from_head(queue_sel);
+			//     NOTE:  The AQM policy of the queue is bypassed since all packets are dropped
+			curr_tx_queue_element = _queue_remove_head(queue_sel);
 
 			// Decrement the num_tx_queued field in the attached station_info_t. If this was the
 			// last queued packet for this station, this will allow the framework to recycle this
@@ -290,6 +535,16 @@ void enqueue_after_tail(u16 queue_sel, dl_entry* tqe){
 		num_tx_queues = queue_sel + 1;
 	}
 
+	if ((queue_sel + 1) > num_queue_aqm) {
+		_queue_aqm_grow(queue_sel);
+	}
+
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+	if ((queue_sel + 1) > num_queue_stats) {
+		_queue_stats_grow(queue_sel);
+	}
+#endif
+
 	// Insert the queue entry into the dl_list representing the selected queue
 	dl_entry_insertEnd(&(tx_queues[queue_sel]), (dl_entry*)tqe);
 
@@ -300,9 +555,19 @@ void enqueue_after_tail(u16 queue_sel, dl_entry* tqe){
 	//         occupancy value includes itself.
 	//
 	((tx_queue_buffer_t*)(tqe->data))->queue_info.enqueue_timestamp = get_mac_time_usec();
+	((tx_queue_buffer_t*)(tqe->data))->timestamp_enqueue = get_system_time_usec();
 	((tx_queue_buffer_t*)(tqe->data))->queue_info.occupancy = (tx_queues[queue_sel].length & 0xFFFF);
 	((tx_queue_buffer_t*)(tqe->data))->queue_info.id = queue_sel;
 
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+	if (queue_sel < num_queue_stats) {
+		_queue_hist_add(&(queue_stats[queue_sel].occupancy), tx_queues[queue_sel].length);
+	}
+	if (((tx_queue_buffer_t*)(tqe->data))->station_info != NULL) {
+		_queue_hist_add(&(((tx_queue_buffer_t*)(tqe->data))->station_info->queue_stats.occupancy), tx_queues[queue_sel].length);
+	}
+#endif
+
 	//Increment the num_tx_queued field in the attached station_info_t. This will prevent
 	// the framework from removing the station_info_t out from underneath us while this
 	// packet is enqueued.
@@ -330,6 +595,10 @@ void enqueue_after_tail(u16 queue_sel, dl_entry* tqe){
  * for the head entry in the queue. If the specified queue is empty this
  * function returns NULL.
  *
+ * Packets at the head of the queue can be dropped by the AQM policy of the
+ * queue (see queue_set_aqm_config()), so this function can return NULL even
+ * if the queue was not empty.
+ *
  * @param  u16 queue_sel          - ID of the queue from which to dequeue an entry
  *
  * @return dl_entry *     - Pointer to queue entry if available,
@@ -338,177 +607,932 @@ void enqueue_after_tail(u16 queue_sel, dl_entry* tqe){
  *****************************************************************************/
 dl_entry* dequeue_from_head(u16 queue_sel){
 	dl_entry* curr_dl_entry;
+	queue_aqm_t* aqm;
+	u64 system_time;
 
-	if ((queue_sel + 1) > num_tx_queues) {
-		// The specified queue does not exist; this can happen if a node has
-		//     associated (has a valid AID = queue_sel) but no packet has ever
-		//     been enqueued to it, as queues are created upon first insertion
-		//     - see enqueue_after_tail()
-		return NULL;
-	} else {
-		if (tx_queues[queue_sel].length == 0) {
-			// Requested queue exists but is empty
-			return NULL;
-		} else {
-			curr_dl_entry = (tx_queues[queue_sel].first);
-			dl_entry_remove(&tx_queues[queue_sel], curr_dl_entry);
+	curr_dl_entry = _queue_remove_head(queue_sel);
 
-			if(tx_queues[queue_sel].length == 0){
-				//If the queue element we just removed empties the queue, we should inform
-				//the top-level MAC that the queue has transitioned from non-empty to empty.
-				queue_state_change_callback(queue_sel, 0);
+	// Queues without a dequeue policy are plain FIFOs
+	if ((curr_dl_entry != NULL) && (queue_sel < num_queue_aqm) &&
+	    ((queue_aqm[queue_sel].config.flags & (QUEUE_AQM_FLAG_LIFETIME | QUEUE_AQM_FLAG_CODEL)) != 0)) {
+
+		aqm = &(queue_aqm[queue_sel]);
+
+		// Drop all expired packets at the head of the queue
+		//     The lifetime uses the system time, since the MAC time can jump
+		if (aqm->config.flags & QUEUE_AQM_FLAG_LIFETIME) {
+			system_time = get_system_time_usec();
+
+			while ((curr_dl_entry != NULL) &&
+			       (_queue_delay(((tx_queue_buffer_t*)(curr_dl_entry->data))->timestamp_enqueue, system_time) > aqm->config.lifetime_usec)) {
+				_queue_drop(queue_sel, curr_dl_entry, QUEUE_DROP_REASON_LIFETIME);
+				curr_dl_entry = _queue_remove_head(queue_sel);
 			}
-			return (dl_entry *) curr_dl_entry;
 		}
+
+		if (aqm->config.flags & QUEUE_AQM_FLAG_CODEL) {
+			curr_dl_entry = _queue_codel_dequeue(queue_sel, aqm, curr_dl_entry);
+		}
+	}
+
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+	// Only the returned packet is added to the sojourn histograms.  Packets dropped by
+	// the AQM policy (see the drop counters of the queue) and packets removed by
+	// purge_queue() are not.
+	if (curr_dl_entry != NULL) {
+		_queue_stats_dequeue(queue_sel, curr_dl_entry);
 	}
+#endif
+
+	return curr_dl_entry;
 }
 
 
 
 /*****************************************************************************/
 /**
- * @brief  Checks out one queue entry from the free pool
+ * @brief  Check if a new packet can be added to a queue
  *
- * The queue framework maintains a pool of free queue entries. This function
- * removes one entry from the free pool and returns it for use by the MAC
- * application. If the free pool is empty NULL is returned.
+ * MAC applications call this function before enqueue_after_tail() to limit
+ * the length of the queue.  If the queue is full, the AQM policy of the queue
+ * either drops the oldest packets in the queue to make room for the new packet
+ * (QUEUE_AQM_FLAG_HEAD_DROP) or rejects the new packet (tail drop).
  *
- * @return dl_entry *     - Pointer to new queue entry if available,
- *                                  NULL if free queue is empty
+ * @param  u16 queue_sel          - ID of the queue
+ * @param  u32 max_length         - Max number of packets in the queue (the
+ *                                  max_length of the AQM policy of the queue
+ *                                  applies if it is smaller)
+ *
+ * @return u8                     - 1 if the packet can be enqueued, 0 if it
+ *                                  must be dropped by the caller
  *
  *****************************************************************************/
-dl_entry* queue_checkout(){
-	dl_entry* tqe;
+u8 queue_admit(u16 queue_sel, u32 max_length){
+	dl_entry* curr_dl_entry;
+	interrupt_state_t prev_interrupt_state;
+	u8 admit = 1;
 
-	if(free_queue.length > 0){
-		tqe = ((dl_entry*)(free_queue.first));
-		dl_entry_remove(&free_queue,free_queue.first);
+	if ((queue_sel < num_queue_aqm) && (queue_aqm[queue_sel].config.max_length != 0)) {
+		max_length = min(max_length, queue_aqm[queue_sel].config.max_length);
+	}
 
-		((tx_queue_buffer_t*)(tqe->data))->station_info = NULL;
+	if (queue_num_queued(queue_sel) < max_length) {
+		return 1;
+	}
 
-		return tqe;
+	// Packets can be dequeued by poll_tx_queues() in interrupt context
+	prev_interrupt_state = wlan_mac_high_interrupt_stop();
+
+	if ((queue_sel < num_queue_aqm) && (queue_aqm[queue_sel].config.flags & QUEUE_AQM_FLAG_HEAD_DROP)) {
+		while (queue_num_queued(queue_sel) >= max_length) {
+			curr_dl_entry = _queue_remove_head(queue_sel);
+
+			if (curr_dl_entry == NULL) { break; }
+
+			_queue_drop(queue_sel, curr_dl_entry, QUEUE_DROP_REASON_HEAD);
+		}
 	} else {
-		return NULL;
+		if (queue_sel < num_queue_aqm) {
+			queue_aqm[queue_sel].num_dropped[QUEUE_DROP_REASON_TAIL]++;
+		}
+		admit = 0;
 	}
+
+	wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+
+	return admit;
 }
 
 
 
 /*****************************************************************************/
 /**
- * @brief  Checks in one queue entry to the free pool
+ * @brief  Set the AQM policy of a queue
  *
- * The queue framework maintains a pool of free queue entries. This function
- * returns one entry to the free pool.  tqe must be a valid pointer to a queue
- * entry which the MAC application no longer needs. The application must not
- * use the entry pointed to by tqe after calling this function.
+ * The queue does not need to exist yet.  Setting the policy resets the CoDel
+ * state of the queue, but not its drop counters.
  *
- * @param  dl_entry* tqe  - Pointer to queue entry to be returned to free pool
+ * @param  u16 queue_sel               - ID of the queue
+ * @param  queue_aqm_config_t* config  - AQM policy (see wlan_mac_queue.h);  a
+ *                                       codel_target_usec / codel_interval_usec
+ *                                       of 0 selects the default of RFC 8289
+ *
+ * @return int                    - 0 on success, -1 on failure (invalid flags
+ *                                  or the queue could not be created)
  *
  *****************************************************************************/
-void queue_checkin(dl_entry* tqe){
+int queue_set_aqm_config(u16 queue_sel, queue_aqm_config_t* config){
+	queue_aqm_t* aqm;
+	interrupt_state_t prev_interrupt_state;
 
-	if (tqe != NULL) {
-	    dl_entry_insertEnd(&free_queue, (dl_entry*) tqe);
+	if ((config == NULL) || (config->flags & ~QUEUE_AQM_FLAGS_ALL)) { return -1; }
+
+	if ((queue_sel + 1) > num_queue_aqm) {
+		_queue_aqm_grow(queue_sel);
+
+		if ((queue_sel + 1) > num_queue_aqm) { return -1; }
 	}
 
-	wlan_platform_free_queue_entry_notify();
+	prev_interrupt_state = wlan_mac_high_interrupt_stop();
+
+	aqm = &(queue_aqm[queue_sel]);
+
+	memcpy(&(aqm->config), config, sizeof(queue_aqm_config_t));
+
+	if (aqm->config.codel_target_usec == 0)   { aqm->config.codel_target_usec   = QUEUE_AQM_CODEL_TARGET_USEC_DEFAULT; }
+	if (aqm->config.codel_interval_usec == 0) { aqm->config.codel_interval_usec = QUEUE_AQM_CODEL_INTERVAL_USEC_DEFAULT; }
+
+	aqm->codel_first_above_time = 0;
+	aqm->codel_drop_next        = 0;
+	aqm->codel_count            = 0;
+	aqm->codel_last_count       = 0;
+	aqm->codel_dropping         = 0;
+
+	wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+
+	return 0;
 }
 
 
 
 /*****************************************************************************/
 /**
- * @brief Checks out multiple queue entries from the free pool
- *
- * The queue framework maintains a pool of free queue entries. This function
- * attempts to check out num_tqe queue entries from the free pool. The number of
- * queue entries successfully checked out is returned. This may be less than
- * requested if the free pool had fewer than num_tqe entries available.
+ * @brief  Get a copy of the AQM policy, drop counters and CoDel state of a queue
  *
- * @param   dl_list * new_list    - Pointer to dl_list to which queue entries are appended
- * @param   u16 num_tqe           - Number of queue entries requested
+ * @param  u16 queue_sel          - ID of the queue
+ * @param  queue_aqm_t* aqm       - Filled in with the AQM state of the queue
  *
- * @return  Number of queue entries successfully checked out and appended to new_list
+ * @return int                    - 0 on success, -1 if the queue does not exist
+ *                                  (ie it uses the default policy and has not
+ *                                  dropped any packet)
  *
  *****************************************************************************/
-int queue_checkout_list(dl_list* list, u16 num_tqe){
-#if 0
-	// Approx. performance metrics:
-	//    incremental processing = 3.3 us / queue entry
-	//    overhead               = 0.3 us
-	//
-	// Ex.  For one queue entry, function will take 3.6 us (ie (3.3 * 1) + 0.3 = 3.6)
-	//
-	u32 i;
-	u32 num_checkout;
-	dl_entry* curr_dl_entry;
+int queue_get_aqm(u16 queue_sel, queue_aqm_t* aqm){
+	interrupt_state_t prev_interrupt_state;
 
-	if(num_tqe <= free_queue.length){
-		num_checkout = num_tqe;
-	} else {
-		num_checkout = free_queue.length;
-	}
+	if ((queue_sel >= num_queue_aqm) || (aqm == NULL)) { return -1; }
 
-	//Traverse the free_queue and update the pointers
-	for (i = 0; i < num_checkout; i++){
-		curr_dl_entry = (free_queue.first);
+	prev_interrupt_state = wlan_mac_high_interrupt_stop();
+	memcpy(aqm, &(queue_aqm[queue_sel]), sizeof(queue_aqm_t));
+	wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
 
-		//Remove from free list
-		dl_entry_remove(&free_queue, curr_dl_entry);
+	return 0;
+}
 
-		//Add to new checkout list
-		dl_entry_insertEnd(list, curr_dl_entry);
-	}
 
-	return num_checkout;
-#else
-	// Approx. performance metrics:
-	//    incremental processing = 0.16 us / queue entry
-	//    overhead               = 1.84 us
-	//
-	// Ex.  For one queue entry, function will take 2.0 us (ie (0.16 * 1) + 1.84 = 2.0)
-	//
 
-    return dl_entry_move(&free_queue, list, num_tqe);
-#endif
+/*****************************************************************************/
+/**
+ * @brief  Reset the drop counters of a queue
+ *
+ * @param  u16 queue_sel          - ID of the queue
+ *
+ *****************************************************************************/
+void queue_reset_aqm_counts(u16 queue_sel){
+	interrupt_state_t prev_interrupt_state;
+
+	if (queue_sel >= num_queue_aqm) { return; }
+
+	prev_interrupt_state = wlan_mac_high_interrupt_stop();
+	bzero(queue_aqm[queue_sel].num_dropped, sizeof(queue_aqm[queue_sel].num_dropped));
+	wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
 }
 
 
 
 /*****************************************************************************/
 /**
- * @brief Checks in multiple queue entries into the free pool
+ * @brief  Removes the head entry from the specified queue without the AQM policy
  *
- * The queue framework maintains a pool of free queue entries. This function will
- * check in all queue entries from the provided list to the end of the free pool.
+ * @param  u16 queue_sel          - ID of the queue from which to remove an entry
  *
- * @param   dl_list * new_list    - Pointer to dl_list from which queue entries will be checked in
+ * @return dl_entry *     - Pointer to queue entry if available,
+ *                                  NULL if queue is empty
  *
- * @return  Number of queue entries successfully checked in
+ *****************************************************************************/
+static dl_entry* _queue_remove_head(u16 queue_sel){
+	dl_entry* curr_dl_entry;
+
+	if ((queue_sel + 1) > num_tx_queues) {
+		// The specified queue does not exist; this can happen if a node has
+		//     associated (has a valid AID = queue_sel) but no packet has ever
+		//     been enqueued to it, as queues are created upon first insertion
+		//     - see enqueue_after_tail()
+		return NULL;
+	} else {
+		if (tx_queues[queue_sel].length == 0) {
+			// Requested queue exists but is empty
+			return NULL;
+		} else {
+			curr_dl_entry = (tx_queues[queue_sel].first);
+			dl_entry_remove(&tx_queues[queue_sel], curr_dl_entry);
+
+			if(tx_queues[queue_sel].length == 0){
+				//If the queue element we just removed empties the queue, we should inform
+				//the top-level MAC that the queue has transitioned from non-empty to empty.
+				queue_state_change_callback(queue_sel, 0);
+			}
+			return (dl_entry *) curr_dl_entry;
+		}
+	}
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Drop a packet that was removed from a queue by the AQM policy
+ *
+ * Counts and logs the drop, then returns the queue entry to the free pool.
+ *
+ * @param  u16 queue_sel          - ID of the queue of the packet
+ * @param  dl_entry* tqe          - Tx Queue entry of the packet
+ * @param  u8 reason              - QUEUE_DROP_REASON_*
  *
  *****************************************************************************/
-int queue_checkin_list(dl_list * list) {
+static void _queue_drop(u16 queue_sel, dl_entry* tqe, u8 reason){
+	tx_queue_buffer_t* tx_queue_buffer = (tx_queue_buffer_t*)(tqe->data);
+	u32 num_dropped = 0;
+
+	if (queue_sel < num_queue_aqm) {
+		num_dropped = ++(queue_aqm[queue_sel].num_dropped[reason]);
+	}
+
+#if WLAN_SW_CONFIG_ENABLE_LOGGING
+	wlan_exp_log_create_tx_drop_entry(tx_queue_buffer, reason, queue_num_queued(queue_sel), num_dropped);
+#endif
+
+	// Release the station_info_t of the packet (see purge_queue())
+	if (tx_queue_buffer->station_info != NULL) {
+		tx_queue_buffer->station_info->num_tx_queued--;
+	}
+
+	queue_checkin(tqe);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Grow the AQM array up to and including a queue
+ *
+ * The new array is filled in before it replaces the current one, so that
+ * dequeue_from_head() can be called in interrupt context at any time.  If the
+ * array cannot be allocated, the new queues use the default policy.
+ *
+ * @param  u16 queue_sel          - ID of the queue
+ *
+ *****************************************************************************/
+static void _queue_aqm_grow(u16 queue_sel){
+	queue_aqm_t* new_queue_aqm;
+	queue_aqm_t* old_queue_aqm;
+	interrupt_state_t prev_interrupt_state;
+
+	new_queue_aqm = wlan_mac_high_malloc((queue_sel + 1) * sizeof(queue_aqm_t));
+
+	if (new_queue_aqm == NULL) {
+#if WLAN_SW_CONFIG_ENABLE_WLAN_EXP
+		wlan_exp_printf(WLAN_EXP_PRINT_WARNING, print_type_queue, "Could not allocate %d bytes for the AQM state of queue %d\n",
+		                ((queue_sel + 1) * sizeof(queue_aqm_t)), queue_sel);
+#endif
+		return;
+	}
+
+	bzero(new_queue_aqm, ((queue_sel + 1) * sizeof(queue_aqm_t)));
+
+	prev_interrupt_state = wlan_mac_high_interrupt_stop();
+
+	if (queue_aqm != NULL) {
+		memcpy(new_queue_aqm, queue_aqm, (num_queue_aqm * sizeof(queue_aqm_t)));
+	}
+
+	old_queue_aqm = queue_aqm;
+	queue_aqm     = new_queue_aqm;
+	num_queue_aqm = queue_sel + 1;
+
+	wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+
+	if (old_queue_aqm != NULL) {
+		wlan_mac_high_free(old_queue_aqm);
+	}
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  CoDel dequeue (RFC 8289)
+ *
+ * Drops packets at the head of the queue according to the CoDel state of the
+ * queue and returns the first packet that is not dropped.
+ *
+ * @param  u16 queue_sel          - ID of the queue
+ * @param  queue_aqm_t* aqm       - AQM state of the queue
+ * @param  dl_entry* tqe          - Tx Queue entry removed from the head of the queue (can be NULL)
+ *
+ * @return dl_entry *             - Tx Queue entry to transmit (NULL if all packets were dropped)
+ *
+ *****************************************************************************/
+static dl_entry* _queue_codel_dequeue(u16 queue_sel, queue_aqm_t* aqm, dl_entry* tqe){
+	u64 system_time;
+	u32 delta;
+	u8  ok_to_drop;
+
+	// The CoDel state and the sojourn times use the system time, since the MAC time can jump
+	system_time = get_system_time_usec();
+	ok_to_drop  = _queue_codel_ok_to_drop(queue_sel, aqm, tqe, system_time);
+
+	if (aqm->codel_dropping) {
+		if (ok_to_drop == 0) {
+			// Sojourn time is below target - leave the dropping state
+			aqm->codel_dropping = 0;
+		} else {
+			// Drop packets until the next drop is in the future or the sojourn time is below target
+			while ((aqm->codel_dropping) && (system_time >= aqm->codel_drop_next)) {
+				_queue_drop(queue_sel, tqe, QUEUE_DROP_REASON_CODEL);
+				aqm->codel_count++;
+
+				tqe = _queue_remove_head(queue_sel);
+
+				if (_queue_codel_ok_to_drop(queue_sel, aqm, tqe, system_time) == 0) {
+					aqm->codel_dropping = 0;
+				} else {
+					aqm->codel_drop_next = _queue_codel_control_law(aqm, aqm->codel_drop_next);
+				}
+			}
+		}
+	} else if (ok_to_drop) {
+		// Sojourn time has been above target for an interval - enter the dropping state
+		_queue_drop(queue_sel, tqe, QUEUE_DROP_REASON_CODEL);
+
+		tqe = _queue_remove_head(queue_sel);
+		_queue_codel_ok_to_drop(queue_sel, aqm, tqe, system_time);
+
+		aqm->codel_dropping = 1;
+
+		// If the queue was recently in the dropping state, resume at the drop rate it had reached
+		delta = aqm->codel_count - aqm->codel_last_count;
+
+		if ((delta > 1) && ((system_time < aqm->codel_drop_next) ||
+		                    ((system_time - aqm->codel_drop_next) < (16 * (u64)(aqm->config.codel_interval_usec))))) {
+			aqm->codel_count = delta;
+		} else {
+			aqm->codel_count = 1;
+		}
+
+		aqm->codel_drop_next  = _queue_codel_control_law(aqm, system_time);
+		aqm->codel_last_count = aqm->codel_count;
+	}
+
+	return tqe;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Check if CoDel can drop a packet
+ *
+ * A packet can be dropped if the sojourn time of the queue has been above
+ * target for at least an interval and the packet is not the last one in the
+ * queue.
+ *
+ * @param  u16 queue_sel          - ID of the queue
+ * @param  queue_aqm_t* aqm       - AQM state of the queue
+ * @param  dl_entry* tqe          - Tx Queue entry removed from the head of the queue (can be NULL)
+ * @param  u64 system_time        - Current system time (usec)
+ *
+ * @return u8                     - 1 if the packet can be dropped, 0 otherwise
+ *
+ *****************************************************************************/
+static u8 _queue_codel_ok_to_drop(u16 queue_sel, queue_aqm_t* aqm, dl_entry* tqe, u64 system_time){
+	u32 sojourn;
+
+	if (tqe == NULL) {
+		aqm->codel_first_above_time = 0;
+		return 0;
+	}
+
+	sojourn = _queue_delay(((tx_queue_buffer_t*)(tqe->data))->timestamp_enqueue, system_time);
+
+	if ((sojourn < aqm->config.codel_target_usec) || (queue_num_queued(queue_sel) == 0)) {
+		aqm->codel_first_above_time = 0;
+		return 0;
+	}
+
+	if (aqm->codel_first_above_time == 0) {
+		aqm->codel_first_above_time = system_time + aqm->config.codel_interval_usec;
+		return 0;
+	}
+
+	return (system_time >= aqm->codel_first_above_time);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  CoDel control law
+ *
+ * @param  queue_aqm_t* aqm       - AQM state of the queue
+ * @param  u64 t                  - Time of the last drop (usec)
+ *
+ * @return u64                    - Time of the next drop:  t + interval / sqrt(count)
+ *
+ *****************************************************************************/
+static inline u64 _queue_codel_control_law(queue_aqm_t* aqm, u64 t){
+	u32 count = min(max(aqm->codel_count, 1), 0xFFFF);
+
+	// _queue_isqrt(count << 16) is sqrt(count) in 8.8 fixed point
+	return t + ((((u64)(aqm->config.codel_interval_usec)) << 8) / _queue_isqrt(count << 16));
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Integer square root
+ *
+ * @param  u32 value              - Value
+ *
+ * @return u32                    - floor(sqrt(value))
+ *
+ *****************************************************************************/
+static u32 _queue_isqrt(u32 value){
+	u32 root = 0;
+	u32 bit  = 1UL << 30;
+
+	while (bit > value) {
+		bit >>= 2;
+	}
+
+	while (bit != 0) {
+		if (value >= (root + bit)) {
+			value -= (root + bit);
+			root   = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return root;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Time between two timestamps
+ *
+ * The MAC time can be moved backwards (e.g. by a beacon of another node), so
+ * negative delays are counted as 0.
+ *
+ * @param  u64 start_timestamp    - Start time (usec)
+ * @param  u64 end_timestamp      - End time (usec)
+ *
+ * @return u32                    - Delay (usec), saturated at 0xFFFFFFFF
+ *
+ *****************************************************************************/
+static inline u32 _queue_delay(u64 start_timestamp, u64 end_timestamp){
+	if (end_timestamp <= start_timestamp) { return 0; }
+
+	return (u32)min((end_timestamp - start_timestamp), 0xFFFFFFFFULL);
+}
+
+
+
+#if WLAN_SW_CONFIG_ENABLE_QUEUE_STATS
+
+/*****************************************************************************/
+/**
+ * @brief  Record the end of the transmission of a dequeued MPDU
+ *
+ * Adds the time between enqueue and Tx done of the MPDU to the statistics of
+ * its queue and of its station.  This should be called when CPU Low is done
+ * with the MPDU (IPC_MBOX_TX_PKT_BUF_DONE).
+ *
+ * @param  tx_frame_info_t* tx_frame_info - Tx frame info of the MPDU
+ * @param  station_info_t* station_info   - Station of the MPDU (can be NULL)
+ *
+ *****************************************************************************/
+void queue_stats_mpdu_tx_done(tx_frame_info_t* tx_frame_info, station_info_t* station_info){
+	u32 tx_done;
+	u16 queue_sel = tx_frame_info->queue_info.id;
+
+	tx_done = _queue_delay(tx_frame_info->queue_info.enqueue_timestamp, tx_frame_info->timestamp_done);
+
+	if (queue_sel < num_queue_stats) {
+		_queue_hist_add(&(queue_stats[queue_sel].tx_done), tx_done);
+	}
+	if (station_info != NULL) {
+		_queue_hist_add(&(station_info->queue_stats.tx_done), tx_done);
+	}
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Get a copy of the statistics of a queue
+ *
+ * @param  u16 queue_sel          - ID of the queue
+ * @param  queue_stats_t* stats   - Filled in with the statistics of the queue
+ *
+ * @return int                    - 0 on success, -1 if the queue does not exist
+ *
+ *****************************************************************************/
+int queue_get_stats(u16 queue_sel, queue_stats_t* stats){
+	interrupt_state_t prev_interrupt_state;
+
+	if ((queue_sel >= num_queue_stats) || (stats == NULL)) { return -1; }
+
+	prev_interrupt_state = wlan_mac_high_interrupt_stop();
+	memcpy(stats, &(queue_stats[queue_sel]), sizeof(queue_stats_t));
+	wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+
+	return 0;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Get a copy of the statistics of a station
+ *
+ * The statistics of a station cover the packets of all queues that were
+ * enqueued for the station.
+ *
+ * @param  station_info_t* station_info - Station
+ * @param  queue_stats_t* stats         - Filled in with the statistics of the station
+ *
+ * @return int                    - 0 on success, -1 on failure
+ *
+ *****************************************************************************/
+int queue_get_station_stats(station_info_t* station_info, queue_stats_t* stats){
+	interrupt_state_t prev_interrupt_state;
+
+	if ((station_info == NULL) || (stats == NULL)) { return -1; }
+
+	prev_interrupt_state = wlan_mac_high_interrupt_stop();
+	memcpy(stats, &(station_info->queue_stats), sizeof(queue_stats_t));
+	wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+
+	return 0;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Reset the statistics of all queues and all stations
+ *
+ *****************************************************************************/
+void queue_stats_reset_all(){
+	station_info_entry_t* curr_station_info_entry;
+	interrupt_state_t prev_interrupt_state;
+
+	prev_interrupt_state = wlan_mac_high_interrupt_stop();
+	if (queue_stats != NULL) {
+		bzero(queue_stats, (num_queue_stats * sizeof(queue_stats_t)));
+	}
+	wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+
+	// Stations are reset one at a time so that interrupts are not blocked for
+	// an extended period of time (see purge_queue())
+	curr_station_info_entry = (station_info_entry_t*)(station_info_get_list()->first);
+
+	while (curr_station_info_entry != NULL) {
+		prev_interrupt_state = wlan_mac_high_interrupt_stop();
+		bzero(&(curr_station_info_entry->data->queue_stats), sizeof(queue_stats_t));
+		wlan_mac_high_interrupt_restore_state(prev_interrupt_state);
+
+		curr_station_info_entry = (station_info_entry_t*)dl_entry_next((dl_entry*)curr_station_info_entry);
+	}
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Grow the statistics array up to and including a queue
+ *
+ * If the array cannot be reallocated, the statistics of the existing queues
+ * are kept and the new queues are not counted.
+ *
+ * @param  u16 queue_sel          - ID of the queue
+ *
+ *****************************************************************************/
+static void _queue_stats_grow(u16 queue_sel){
+	queue_stats_t* new_queue_stats;
+
+	new_queue_stats = wlan_mac_high_realloc(queue_stats, ((queue_sel + 1) * sizeof(queue_stats_t)));
+
+	if (new_queue_stats == NULL) {
+#if WLAN_SW_CONFIG_ENABLE_WLAN_EXP
+		wlan_exp_printf(WLAN_EXP_PRINT_WARNING, print_type_queue, "Could not reallocate %d bytes for the statistics of queue %d\n",
+		                ((queue_sel + 1) * sizeof(queue_stats_t)), queue_sel);
+#endif
+		return;
+	}
+
+	queue_stats = new_queue_stats;
+
+	bzero(&(queue_stats[num_queue_stats]), ((queue_sel + 1 - num_queue_stats) * sizeof(queue_stats_t)));
+
+	num_queue_stats = queue_sel + 1;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Record the dequeue of a packet
+ *
+ * Adds the time between enqueue and dequeue of the packet (system time) to the
+ * sojourn histograms of its queue and of its station.
+ *
+ * @param  u16 queue_sel          - ID of the queue of the packet
+ * @param  dl_entry* tqe          - Tx Queue entry of the packet
+ *
+ *****************************************************************************/
+static inline void _queue_stats_dequeue(u16 queue_sel, dl_entry* tqe){
+	tx_queue_buffer_t* tx_queue_buffer = (tx_queue_buffer_t*)(tqe->data);
+	u32 sojourn;
+
+	sojourn = _queue_delay(tx_queue_buffer->timestamp_enqueue, get_system_time_usec());
+
+	if (queue_sel < num_queue_stats) {
+		_queue_hist_add(&(queue_stats[queue_sel].sojourn), sojourn);
+	}
+	if (tx_queue_buffer->station_info != NULL) {
+		_queue_hist_add(&(tx_queue_buffer->station_info->queue_stats.sojourn), sojourn);
+	}
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Add a sample to a histogram
+ *
+ * @param  queue_hist_t* hist     - Histogram
+ * @param  u32 value              - Sample (see QUEUE_STATS_NUM_BINS for the bins)
+ *
+ *****************************************************************************/
+static inline void _queue_hist_add(queue_hist_t* hist, u32 value){
+	u32 bin;
+
+	bin = (value == 0) ? 0 : (32 - __builtin_clz(value));
+
+	if (bin >= QUEUE_STATS_NUM_BINS) {
+		bin = QUEUE_STATS_NUM_BINS - 1;
+	}
+
+	hist->bins[bin]++;
+
+	if (value > hist->max) {
+		hist->max = value;
+	}
+}
+
+#endif /* WLAN_SW_CONFIG_ENABLE_QUEUE_STATS */
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Checks out one queue entry from the free pool
+ *
+ * The queue framework maintains a pool of free queue entries. This function
+ * removes one entry from the free pool and returns it for use by the MAC
+ * application. If the free pool is empty NULL is returned.
+ *
+ * The entry can hold a frame of up to MAX_PKT_SIZE_B bytes.  Callers that know
+ * the length of the frame before checkout should use queue_checkout_len().
+ * This function can use the QUEUE_NUM_RESERVED_LARGE_BUFFERS LARGE buffers
+ * that queue_checkout_len() leaves free.
+ *
+ * @return dl_entry *     - Pointer to new queue entry if available,
+ *                                  NULL if free queue is empty
+ *
+ *****************************************************************************/
+dl_entry* queue_checkout(){
+	return queue_checkout_class(QUEUE_BUFFER_CLASS_LARGE);
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Checks out one queue entry that can hold a frame of the given length
+ *
+ * This function checks out an entry from the smallest buffer size class that
+ * can hold frame_length bytes.  If the free pool of that class is empty, the
+ * entry is checked out from the next larger class.  The last
+ * QUEUE_NUM_RESERVED_LARGE_BUFFERS free LARGE buffers are left for
+ * queue_checkout().
+ *
+ * @param  u32 frame_length       - Length of the frame (in bytes)
+ *
+ * @return dl_entry *     - Pointer to new queue entry if available,
+ *                                  NULL if no class that can hold the frame has a free entry
+ *
+ *****************************************************************************/
+dl_entry* queue_checkout_len(u32 frame_length){
+	u8 buffer_class;
+	u8 requested_class;
+
+	if (frame_length > MAX_PKT_SIZE_B) { return NULL; }
+
+	requested_class = queue_buffer_class(frame_length);
+
+	for (buffer_class = requested_class; buffer_class < NUM_QUEUE_BUFFER_CLASSES; buffer_class++) {
+		if (free_queue[buffer_class].length > ((buffer_class == QUEUE_BUFFER_CLASS_LARGE) ? QUEUE_NUM_RESERVED_LARGE_BUFFERS : 0)) {
+			if (buffer_class != requested_class) {
+				queue_class_info[buffer_class].num_fallback++;
+			}
+			return queue_checkout_class(buffer_class);
+		}
+	}
+
+	queue_class_info[requested_class].num_failed++;
+
+	return NULL;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Checks out one queue entry of a buffer size class
+ *
+ * @param  u8 buffer_class        - Buffer size class
+ *
+ * @return dl_entry *     - Pointer to new queue entry if available,
+ *                                  NULL if free queue of the class is empty
+ *
+ *****************************************************************************/
+dl_entry* queue_checkout_class(u8 buffer_class){
+	dl_entry* tqe;
+
+	if (buffer_class >= NUM_QUEUE_BUFFER_CLASSES) { return NULL; }
+
+	if(free_queue[buffer_class].length > 0){
+		tqe = ((dl_entry*)(free_queue[buffer_class].first));
+		dl_entry_remove(&(free_queue[buffer_class]), tqe);
+
+		_queue_update_min_free(buffer_class);
+
+		((tx_queue_buffer_t*)(tqe->data))->station_info = NULL;
+		((tx_queue_buffer_t*)(tqe->data))->trace_id     = 0;
+
+		return tqe;
+	} else {
+		return NULL;
+	}
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief  Checks in one queue entry to the free pool
+ *
+ * The queue framework maintains a pool of free queue entries. This function
+ * returns one entry to the free pool.  tqe must be a valid pointer to a queue
+ * entry which the MAC application no longer needs. The application must not
+ * use the entry pointed to by tqe after calling this function.
+ *
+ * @param  dl_entry* tqe  - Pointer to queue entry to be returned to free pool
+ *
+ *****************************************************************************/
+void queue_checkin(dl_entry* tqe){
+	u8 buffer_class;
+
+	if (tqe != NULL) {
+		buffer_class = queue_entry_class(tqe);
+
+		if (buffer_class < NUM_QUEUE_BUFFER_CLASSES) {
+			dl_entry_insertEnd(&(free_queue[buffer_class]), (dl_entry*) tqe);
+		} else {
+			wlan_dprintf(PL_ERROR, "Error in queue_checkin(): 0x%08x is not a Tx queue entry\n", (u32)tqe);
+		}
+	}
+
+	wlan_platform_free_queue_entry_notify();
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief Checks out multiple queue entries from the free pool
+ *
+ * The queue framework maintains a pool of free queue entries. This function
+ * attempts to check out num_tqe queue entries from the free pool of one buffer
+ * size class. The number of queue entries successfully checked out is returned.
+ * This may be less than requested if the free pool had fewer than num_tqe entries
+ * available.
+ *
+ * @param   dl_list * new_list    - Pointer to dl_list to which queue entries are appended
+ * @param   u16 num_tqe           - Number of queue entries requested
+ * @param   u8 buffer_class       - Buffer size class of the queue entries
+ *
+ * @return  Number of queue entries successfully checked out and appended to new_list
+ *
+ *****************************************************************************/
+int queue_checkout_list(dl_list* list, u16 num_tqe, u8 buffer_class){
+	int num_checkout;
+	dl_list* free_list;
+
+	if (buffer_class >= NUM_QUEUE_BUFFER_CLASSES) { return 0; }
+
+	free_list = &(free_queue[buffer_class]);
+
 #if 0
+	// Approx. performance metrics:
+	//    incremental processing = 3.3 us / queue entry
+	//    overhead               = 0.3 us
+	//
+	// Ex.  For one queue entry, function will take 3.6 us (ie (3.3 * 1) + 0.3 = 3.6)
+	//
+	u32 i;
+	dl_entry* curr_dl_entry;
+
+	if(num_tqe <= free_list->length){
+		num_checkout = num_tqe;
+	} else {
+		num_checkout = free_list->length;
+	}
+
+	//Traverse the free_queue and update the pointers
+	for (i = 0; i < num_checkout; i++){
+		curr_dl_entry = (free_list->first);
+
+		//Remove from free list
+		dl_entry_remove(free_list, curr_dl_entry);
+
+		//Add to new checkout list
+		dl_entry_insertEnd(list, curr_dl_entry);
+	}
+#else
+	// Approx. performance metrics:
+	//    incremental processing = 0.16 us / queue entry
+	//    overhead               = 1.84 us
+	//
+	// Ex.  For one queue entry, function will take 2.0 us (ie (0.16 * 1) + 1.84 = 2.0)
+	//
+
+    num_checkout = dl_entry_move(free_list, list, num_tqe);
+#endif
+
+    _queue_update_min_free(buffer_class);
+
+    return num_checkout;
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief Checks in multiple queue entries into the free pool
+ *
+ * The queue framework maintains a pool of free queue entries. This function will
+ * check in all queue entries from the provided list to the end of the free pool
+ * of their buffer size class.
+ *
+ * @param   dl_list * new_list    - Pointer to dl_list from which queue entries will be checked in
+ *
+ * @return  Number of queue entries successfully checked in
+ *
+ *****************************************************************************/
+int queue_checkin_list(dl_list * list) {
 	u32 i;
 	u32 num_checkin;
+	u8 buffer_class;
 	dl_entry* curr_dl_entry;
 
 	num_checkin = list->length;
 
-	// Traverse the list and update the pointers
+	// Traverse the list and check in each entry to the free pool of its class
+	//     NOTE:  The list may contain entries of different classes, so it cannot be
+	//         moved to one free pool with dl_entry_move()
 	for (i = 0; i < num_checkin; i++){
 		curr_dl_entry = (list->first);
 
-		//Remove from free list
+		//Remove from list
 		dl_entry_remove(list, curr_dl_entry);
 
-		//Add to new checkout list
-		dl_entry_insertEnd(&free_queue, curr_dl_entry);
+		//Add to free list
+		buffer_class = queue_entry_class(curr_dl_entry);
+
+		if (buffer_class < NUM_QUEUE_BUFFER_CLASSES) {
+			dl_entry_insertEnd(&(free_queue[buffer_class]), curr_dl_entry);
+		}
 	}
-#else
-    return dl_entry_move(list, &free_queue, list->length);
-#endif
+
+	return num_checkin;
 }
 
 void transmit_checkin(dl_entry* tx_queue_buffer_entry){
@@ -529,7 +1553,7 @@ void transmit_checkin(dl_entry* tx_queue_buffer_entry){
 		// station_info_t if it also has not been flagged as something to keep.
 		((tx_queue_buffer_t*)(tx_queue_buffer_entry->data))->station_info->num_tx_queued--;
 	} else {
-		xil_printf("Error in transmit_checkin(): no free Tx packet buffers. Packet was freed without being sent\n");
+		wlan_dprintf(PL_ERROR, "Error in transmit_checkin(): no free Tx packet buffers. Packet was freed without being sent\n");
 	}
 
 	// Check in the Tx Queue element because it is not long being used
@@ -27,6 +27,8 @@
 #include "wlan_mac_high.h"
 #include "wlan_mac_dl_list.h"
 #include "wlan_mac_schedule.h"
+#include "wlan_mac_pool.h"
+#include "wlan_mac_prof.h"
 
 
 /*************************** Constant Definitions *****************************/
@@ -183,10 +185,10 @@ u32 wlan_mac_schedule_event_repeated(u8 scheduler_sel, u32 delay, u32 num_calls,
 	u64 curr_system_time;
 
 	// Allocate memory for data structures
-	entry_ptr = wlan_mac_high_malloc(sizeof(dl_entry));
+	entry_ptr = wlan_mac_pool_alloc(MEM_POOL_DL_ENTRY);
 	if (entry_ptr == NULL) { return SCHEDULE_FAILURE; }
 
-	sched_ptr = wlan_mac_high_malloc(sizeof(wlan_sched));
+	sched_ptr = wlan_mac_pool_alloc(MEM_POOL_SCHEDULE);
 	if (sched_ptr == NULL) { wlan_mac_high_free(entry_ptr); return SCHEDULE_FAILURE; }
 
 	// Attach the schedule struct to this dl_entry
@@ -535,6 +537,8 @@ void schedule_handler(void * callback_ref, u8 timer_number){
 
 	static volatile u8 debug_print = 0;
 
+	WLAN_PROF_START(PROF_PROBE_SCHEDULE_HANDLER);
+
 	// Get current system time
 	curr_system_time = get_system_time_usec();
 
@@ -617,6 +621,8 @@ void schedule_handler(void * callback_ref, u8 timer_number){
 			}
 		}
 	}
+
+	WLAN_PROF_END(PROF_PROBE_SCHEDULE_HANDLER);
 }
 
 
@@ -32,6 +32,7 @@
 #include "wlan_platform_common.h"
 #include "wlan_mac_common.h"
 #include "wlan_common_types.h"
+#include "wlan_mac_pool.h"
 
 /*********************** Global Variable Definitions *************************/
 
@@ -59,11 +60,23 @@ typedef struct default_tx_params_t{
 
 static default_tx_params_t default_tx_params;
 
+#if WLAN_SW_CONFIG_ENABLE_TXRX_COUNTS
+/// Global Tx/Rx counts generation. Incremented on every update to any station's
+/// txrx_counts; the new value is stamped into that station's txrx_counts_data_gen /
+/// txrx_counts_mgmt_gen so that wlan_exp can return only the counts that changed
+/// since a given generation.
+static u32 txrx_counts_gen;
+#endif
+
 
 /*************************** Functions Prototypes ****************************/
 
 station_info_entry_t* station_info_find_oldest();
 
+#if WLAN_SW_CONFIG_ENABLE_TXRX_COUNTS
+static inline void station_info_txrx_counts_updated(station_info_t* station_info, txrx_counts_sub_t* txrx_counts_sub);
+#endif
+
 
 /******************************** Functions **********************************/
 
@@ -157,6 +170,7 @@ inline station_info_t* station_info_txreport_process(void* pkt_buf_addr, wlan_ma
 	}
 
 	(txrx_counts_sub->tx_num_attempts)++;
+	station_info_txrx_counts_updated(curr_station_info, txrx_counts_sub);
 #endif
 
 	return curr_station_info;
@@ -200,6 +214,7 @@ inline station_info_t* station_info_posttx_process(void* pkt_buf_addr) {
 		(txrx_counts_sub->tx_num_packets_success)++;
 		(txrx_counts_sub->tx_num_bytes_success) += tx_frame_info->length;
 	}
+	station_info_txrx_counts_updated(curr_station_info, txrx_counts_sub);
 #endif
 
 	return curr_station_info;
@@ -287,6 +302,8 @@ void station_info_rx_process_counts(void* pkt_buf_addr, station_info_t* station_
 			(txrx_counts_sub->rx_num_packets)++;
 			(txrx_counts_sub->rx_num_bytes) += (length - WLAN_PHY_FCS_NBYTES - sizeof(mac_header_80211));
 		}
+
+		station_info_txrx_counts_updated(station_info, txrx_counts_sub);
 	}
 }
 #endif
@@ -394,6 +411,7 @@ void station_info_reset_all_counts_txrx(){
 
 		bzero(&(curr_txrx_counts->data), sizeof(txrx_counts_sub_t));
 		bzero(&(curr_txrx_counts->mgmt), sizeof(txrx_counts_sub_t));
+		station_info_txrx_counts_updated(curr_station_info, NULL);
 
 		curr_dl_entry = dl_entry_prev(curr_dl_entry);
 		i++;
@@ -573,6 +591,11 @@ station_info_t* station_info_create(u8* addr){
 			curr_station_info->tx_params_data = default_tx_params.unicast_data;
 			curr_station_info->tx_params_mgmt = default_tx_params.unicast_mgmt;
 		}
+
+#if WLAN_SW_CONFIG_ENABLE_TXRX_COUNTS
+		// A new station is a change in the set of counts
+		station_info_txrx_counts_updated(curr_station_info, NULL);
+#endif
 	}
 
 	// Update the timestamp
@@ -644,6 +667,7 @@ void txrx_counts_zero_all(){
 		curr_station_info = (station_info_t*)(curr_dl_entry->data);
 		curr_txrx_counts = &(curr_station_info->txrx_counts);
 		station_info_clear_txrx_counts(curr_txrx_counts);
+		station_info_txrx_counts_updated(curr_station_info, NULL);
 	}
 
 }
@@ -651,6 +675,42 @@ void txrx_counts_zero_all(){
 void station_info_clear_txrx_counts(station_txrx_counts_t* txrx_counts){
 	bzero(txrx_counts, sizeof(station_txrx_counts_t));
 }
+
+/**
+ * @brief Get Tx/Rx Counts Generation
+ *
+ * Returns the generation of the most recent Tx/Rx counts update across all stations.
+ * The data (or mgmt) counts of a station have changed since generation G if
+ * txrx_counts_data_gen (or txrx_counts_mgmt_gen) is "after" G in serial number
+ * arithmetic, i.e. ((s32)(station_info->txrx_counts_data_gen - G) > 0).
+ *
+ * @param  None
+ * @return u32             - Current Tx/Rx counts generation
+ */
+u32 station_info_get_txrx_counts_gen(){
+	return txrx_counts_gen;
+}
+
+/**
+ * @brief Mark Tx/Rx Counts Updated
+ *
+ * @param  station_info_t* station_info       - Station whose counts were updated
+ * @param  txrx_counts_sub_t* txrx_counts_sub - Counts that were updated (data or mgmt);
+ *                                              NULL marks both as updated
+ * @return None
+ */
+static inline void station_info_txrx_counts_updated(station_info_t* station_info, txrx_counts_sub_t* txrx_counts_sub){
+	// Generation 0 is reserved to mean "no generation" (i.e. a host that has never
+	// retrieved counts), so skip it on wrap
+	if(++txrx_counts_gen == 0) txrx_counts_gen = 1;
+
+	if(txrx_counts_sub != &(station_info->txrx_counts.mgmt)){
+		station_info->txrx_counts_data_gen = txrx_counts_gen;
+	}
+	if(txrx_counts_sub != &(station_info->txrx_counts.data)){
+		station_info->txrx_counts_mgmt_gen = txrx_counts_gen;
+	}
+}
 #endif
 
 void station_info_clear(station_info_t* station_info){
@@ -730,7 +790,7 @@ station_info_t*  station_info_add(dl_list* app_station_info_list, u8* addr, u16
 	} else {
 
 		// This addr is new, so we'll have to add an entry into the list
-		entry = wlan_mac_high_malloc(sizeof(station_info_entry_t));
+		entry = wlan_mac_pool_alloc(MEM_POOL_STATION_ENTRY);
 		if(entry == NULL){
 			return NULL;
 		}
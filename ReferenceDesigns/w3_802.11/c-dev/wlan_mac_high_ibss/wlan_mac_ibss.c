@@ -29,6 +29,9 @@
 #include "wlan_mac_entries.h"
 #include "wlan_mac_ltg.h"
 #include "wlan_mac_high.h"
+#include "wlan_mac_cdma.h"
+#include "wlan_mac_dprint.h"
+#include "wlan_mac_prof.h"
 #include "wlan_mac_packet_types.h"
 #include "wlan_mac_eth_util.h"
 #include "wlan_mac_scan.h"
@@ -356,6 +359,12 @@ int main() {
 		//     scheduled events, user interaction, etc) are handled via interrupt service routines
 		transport_poll(WLAN_EXP_ETH);
 #endif
+
+		// Start queued CDMA jobs and call their main context callbacks
+		wlan_mac_cdma_poll();
+
+		// Print deferred messages
+		wlan_mac_dprint_poll();
 	}
 
 	// Unreachable, but non-void return keeps the compiler happy
@@ -503,6 +512,8 @@ void poll_tx_queues(){
 	// Don't dequeue anything if the active BSS is NULL
 	if( active_network_info == NULL ) return;
 
+	WLAN_PROF_START(PROF_PROBE_POLL_TX_QUEUES);
+
 	// Stop interrupts for all processing below - this avoids many possible race conditions,
 	//  like new packets being enqueued or stations joining/leaving the BSS
 	curr_interrupt_state = wlan_mac_high_interrupt_stop();
@@ -593,6 +604,8 @@ void poll_tx_queues(){
 	} // END while(buffers available && keep polling)
 
 	wlan_mac_high_interrupt_restore_state(curr_interrupt_state);
+
+	WLAN_PROF_END(PROF_PROBE_POLL_TX_QUEUES);
 }
 
 /*****************************************************************************/
@@ -709,7 +722,7 @@ int ethernet_receive(dl_entry* curr_tx_queue_element, u8* eth_dest, u8* eth_src,
 			curr_tx_queue_buffer->station_info = station_info;
 		}
 
-		if(queue_num_queued(queue_sel) < max_queue_size){
+		if(queue_admit(queue_sel, max_queue_size)){
 			// Put the packet in the queue
 			enqueue_after_tail(queue_sel, curr_tx_queue_element);
 
@@ -1113,9 +1126,10 @@ void ltg_event(u32 id, void* callback_arg){
 		do{
 			continue_loop = 0;
 
-			if(queue_num_queued(queue_sel) < max_queue_size){
+			if(queue_admit(queue_sel, max_queue_size)){
 				// Checkout 1 element from the queue;
-				curr_tx_queue_element = queue_checkout();
+				//     NOTE:  The LTG frame is at least as long as its ltg_packet_id_t
+				curr_tx_queue_element = queue_checkout_len(max(payload_length, sizeof(ltg_packet_id_t)) + sizeof(mac_header_80211) + WLAN_PHY_FCS_NBYTES);
 				if(curr_tx_queue_element != NULL){
 					// Create LTG packet
 					curr_tx_queue_buffer = ((tx_queue_buffer_t*)(curr_tx_queue_element->data));
@@ -1131,6 +1145,11 @@ void ltg_event(u32 id, void* callback_arg){
 					curr_tx_queue_buffer->station_info = station_info;
 					curr_tx_queue_buffer->flags = flags;
 
+#if WLAN_SW_CONFIG_ENABLE_LOGGING
+					// Start the latency trace of the packet (if enabled)
+					wlan_exp_log_start_tx_trace(curr_tx_queue_buffer);
+#endif //WLAN_SW_CONFIG_ENABLE_LOGGING
+
 					// Submit the new packet to the appropriate queue
 					enqueue_after_tail(queue_sel, curr_tx_queue_element);
 
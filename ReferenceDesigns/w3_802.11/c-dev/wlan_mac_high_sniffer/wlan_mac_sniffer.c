@@ -29,6 +29,9 @@
 #include "wlan_mac_entries.h"
 #include "wlan_mac_ltg.h"
 #include "wlan_mac_high.h"
+#include "wlan_mac_cdma.h"
+#include "wlan_mac_dprint.h"
+#include "wlan_mac_prof.h"
 #include "wlan_mac_packet_types.h"
 #include "wlan_mac_eth_util.h"
 #include "wlan_mac_scan.h"
@@ -214,6 +217,11 @@ int main() {
 
 
 	while(1){
+		// Start queued CDMA jobs and call their main context callbacks
+		wlan_mac_cdma_poll();
+
+		// Print deferred messages
+		wlan_mac_dprint_poll();
 	}
 
 	// Unreachable, but non-void return keeps the compiler happy
@@ -258,6 +266,8 @@ void poll_tx_queues(){
 	static queue_group_t next_queue_group = MGMT_QGRP;
 	queue_group_t curr_queue_group;
 
+	WLAN_PROF_START(PROF_PROBE_POLL_TX_QUEUES);
+
 	// Stop interrupts for all processing below - this avoids many possible race conditions,
 	//  like new packets being enqueued or stations joining/leaving the BSS
 	curr_interrupt_state = wlan_mac_high_interrupt_stop();
@@ -350,6 +360,8 @@ void poll_tx_queues(){
 	} // END while(buffers available && keep polling)
 
 	wlan_mac_high_interrupt_restore_state(curr_interrupt_state);
+
+	WLAN_PROF_END(PROF_PROBE_POLL_TX_QUEUES);
 }
 
 /*****************************************************************************/
@@ -456,7 +468,7 @@ int ethernet_receive(dl_entry* curr_tx_queue_element, u8* eth_dest, u8* eth_src,
 			curr_tx_queue_buffer->station_info = station_info;
 		}
 
-		if(queue_num_queued(queue_sel) < max_queue_size){
+		if(queue_admit(queue_sel, max_queue_size)){
 			// Put the packet in the queue
 			enqueue_after_tail(queue_sel, curr_tx_queue_element);
 
@@ -511,8 +523,11 @@ u32 mpdu_rx_process(void* pkt_buf_addr, station_info_t* station_info, rx_common_
 	u16 length = rx_frame_info->phy_details.length;
 
 	// (debug) UART display of packet
+	//     The message is deferred to the main loop and only compiled in with PRINT_LEVEL >= PL_VERBOSE
+#if PRINT_LEVEL >= PL_VERBOSE
 	time_hr_min_sec_t time_hr_min_sec = wlan_mac_time_to_hr_min_sec(get_system_time_usec());
-	xil_printf("*%dh:%02dm:%02ds* mpdu: src=0x%02x:0x%02x:0x%02x:0x%02x:0x%02x:0x%02x, length=%d\n",
+#endif
+	wlan_dprintf(PL_VERBOSE, "*%dh:%02dm:%02ds* mpdu: src=0x%02x:0x%02x:0x%02x:0x%02x:0x%02x:0x%02x, length=%d\n",
 								time_hr_min_sec.hr, time_hr_min_sec.min, time_hr_min_sec.sec,
 								rx_80211_header->address_2[0], rx_80211_header->address_2[1], rx_80211_header->address_2[2],
 								rx_80211_header->address_2[3], rx_80211_header->address_2[4], rx_80211_header->address_2[5],
@@ -543,7 +558,7 @@ u32 mpdu_rx_process(void* pkt_buf_addr, station_info_t* station_info, rx_common_
 	rftap_header_t 		*rftap_frame = rftap_frame_init(curr_tx_queue_buffer, &pkt_size);
 	// radiotap_header_t 	*radiotap_frame = radiotap_frame_init(curr_tx_queue_buffer, &pkt_size);
 
-	void *pkt = memmove(curr_tx_queue_buffer + pkt_size, mac_payload_ptr_u8, length);
+	memmove(curr_tx_queue_buffer + pkt_size, mac_payload_ptr_u8, length);
 	pkt_size += length;
 
 	// radiotap_frame->it_len = Xil_Htons(length + sizeof(radiotap_header_t));
@@ -559,7 +574,7 @@ u32 mpdu_rx_process(void* pkt_buf_addr, station_info_t* station_info, rx_common_
 	// ipv4_frame->total_length = Xil_Htons(sizeof(ipv4_header_t) + length + sizeof(rftap_header_t));
 	ip_frame_calc_checksum(ipv4_frame);
 
-	xil_printf("-> resulting ethernet frame, ptr = %x, l = %u\n", pkt, pkt_size);
+	wlan_dprintf(PL_VERBOSE, "-> resulting ethernet frame, ptr = %x, l = %u\n", curr_tx_queue_buffer, pkt_size);
 
 	u8 packet[] = {
 			0x0a, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0a, 0x01, 0x01, 0x01, 0x01, 0x01, 0x08, 0x00, 0x45, 0x00,
@@ -578,7 +593,7 @@ u32 mpdu_rx_process(void* pkt_buf_addr, station_info_t* station_info, rx_common_
 	//memcpy(pkt_buf_addr, mac_payload_ptr_u8,2);
 	int ret = 0;
 	if ((ret = wlan_platform_ethernet_send(curr_tx_queue_buffer, pkt_size)) != XST_SUCCESS) {
-		xil_printf("Error: wlan_platform_ethernet_send() failed: %d\n", ret);
+		wlan_dprintf(PL_ERROR, "Error: wlan_platform_ethernet_send() failed: %d\n", ret);
 	}
 
 	queue_checkin(curr_tx_queue_element);
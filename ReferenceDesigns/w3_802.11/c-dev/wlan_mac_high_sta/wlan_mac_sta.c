@@ -29,6 +29,9 @@
 #include "wlan_mac_entries.h"
 #include "wlan_mac_ltg.h"
 #include "wlan_mac_high.h"
+#include "wlan_mac_cdma.h"
+#include "wlan_mac_dprint.h"
+#include "wlan_mac_prof.h"
 #include "wlan_mac_packet_types.h"
 #include "wlan_mac_eth_util.h"
 #include "ascii_characters.h"
@@ -290,6 +293,12 @@ int main() {
 		//     scheduled events, user interaction, etc) are handled via interrupt service routines
 		transport_poll(WLAN_EXP_ETH);
 #endif
+
+		// Start queued CDMA jobs and call their main context callbacks
+		wlan_mac_cdma_poll();
+
+		// Print deferred messages
+		wlan_mac_dprint_poll();
 	}
 
 	// Unreachable, but non-void return keeps the compiler happy
@@ -418,6 +427,8 @@ void poll_tx_queues(){
 
 	#define MAX_NUM_QUEUE 2
 
+	WLAN_PROF_START(PROF_PROBE_POLL_TX_QUEUES);
+
 	num_pkt_bufs_avail = wlan_mac_num_tx_pkt_buf_available(PKT_BUF_GROUP_GENERAL);
 
 
@@ -469,6 +480,8 @@ void poll_tx_queues(){
 			}
 		}
 	}
+
+	WLAN_PROF_END(PROF_PROBE_POLL_TX_QUEUES);
 }
 
 
@@ -522,7 +535,7 @@ int ethernet_receive(dl_entry* curr_tx_queue_element, u8* eth_dest, u8* eth_src,
 		ap_station_info = (station_info_t*)((active_network_info->members.first)->data);
 
 		// Send the packet to the AP
-		if(queue_num_queued(UNICAST_QID) < max_queue_size){
+		if(queue_admit(UNICAST_QID, max_queue_size)){
 
 			// Send the pre-encapsulated Ethernet frame over the wireless interface
 			//     NOTE:  The queue element has already been provided, so we do not need to check if it is NULL
@@ -864,9 +877,10 @@ void ltg_event(u32 id, void* callback_arg){
 		ap_station_info = (station_info_t*)((active_network_info->members.first)->data);
 
 		// Send a Data packet to AP
-		if(queue_num_queued(UNICAST_QID) < max_queue_size){
+		if(queue_admit(UNICAST_QID, max_queue_size)){
 			// Checkout 1 element from the queue;
-			curr_tx_queue_element = queue_checkout();
+			//     NOTE:  The LTG frame is at least as long as its ltg_packet_id_t
+			curr_tx_queue_element = queue_checkout_len(max(payload_length, sizeof(ltg_packet_id_t)) + sizeof(mac_header_80211) + WLAN_PHY_FCS_NBYTES);
 			if(curr_tx_queue_element != NULL){
 				// Create LTG packet
 				curr_tx_queue_buffer = ((tx_queue_buffer_t*)(curr_tx_queue_element->data));
@@ -882,6 +896,11 @@ void ltg_event(u32 id, void* callback_arg){
 				curr_tx_queue_buffer->length = payload_length;
 				curr_tx_queue_buffer->station_info = ap_station_info;
 
+#if WLAN_SW_CONFIG_ENABLE_LOGGING
+				// Start the latency trace of the packet (if enabled)
+				wlan_exp_log_start_tx_trace(curr_tx_queue_buffer);
+#endif //WLAN_SW_CONFIG_ENABLE_LOGGING
+
 				// Submit the new packet to the appropriate queue
 				enqueue_after_tail(UNICAST_QID, curr_tx_queue_element);
 			}
@@ -30,6 +30,8 @@
 #include "wlan_mac_dl_list.h"
 #include "wlan_mac_mgmt_tags.h"
 #include "wlan_mac_common.h"
+#include "wlan_mac_dprint.h"
+#include "wlan_mac_prof.h"
 #include "wlan_mac_pkt_buf_util.h"
 #include "wlan_mac_low.h"
 #include "wlan_mac_mailbox_util.h"
@@ -108,6 +110,7 @@ int main(){
 	microblaze_enable_exceptions();
 
 	u32 i, poll_tx_pkt_buf_list_return;
+	u32 loop_busy;
     wlan_mac_hw_info_t* hw_info;
     compilation_details_t compilation_details;
     bzero(&compilation_details, sizeof(compilation_details_t));
@@ -192,20 +195,27 @@ int main(){
 
         // Poll PHY RX start
     	gl_waiting_for_response = 0;
-        wlan_mac_low_poll_frame_rx();
+        loop_busy = wlan_mac_low_poll_frame_rx();
 
         // Poll IPC rx
-        wlan_mac_low_poll_ipc_rx();
+        loop_busy |= wlan_mac_low_poll_ipc_rx();
 
     	// Poll for new Tx Ready
 
         do {
         	poll_tx_pkt_buf_list_return = poll_tx_pkt_buf_list(PKT_BUF_GROUP_GENERAL);
+        	loop_busy |= (poll_tx_pkt_buf_list_return & (POLL_TX_PKT_BUF_LIST_RETURN_TRANSMITTED | POLL_TX_PKT_BUF_LIST_RETURN_MORE_DATA));
         } while( poll_tx_pkt_buf_list_return & POLL_TX_PKT_BUF_LIST_RETURN_TRANSMITTED);
 
 
         // Poll the timestamp (for periodic transmissions like beacons)
         poll_tbtt_and_send_beacon();
+
+        // Print deferred messages only when this pass found no work
+        //     A message blocks on the UART for milliseconds
+        if (loop_busy == 0) {
+            wlan_mac_dprint_poll();
+        }
     }
     return 0;
 }
@@ -1402,27 +1412,10 @@ u32 frame_receive(u8 rx_pkt_buf, phy_rx_details_t* phy_details) {
     }
 
     // This packet should be passed up to CPU_high for further processing
+    //     - Switches the PHY to the next empty packet buffer.  If CPU High still owns all
+    //       of the other Rx packet buffers, the reception is dropped and counted instead.
     if (report_to_mac_high) {
-        // Unlock the pkt buf mutex before passing the packet up
-        //     If this fails, something has gone horribly wrong
-
-    	rx_frame_info->rx_pkt_buf_state = RX_PKT_BUF_READY;
-
-    	// Note: at this point in the code, the packet buffer state has been modified to RX_PKT_BUF_READY,
-    	// yet we have not sent the IPC_MBOX_RX_PKT_BUF_READY message. If we happen to reboot here,
-    	// this packet buffer will be abandoned and won't be cleaned up in the boot process. This is a narrow
-    	// race in practice, but step-by-step debugging can accentuate the risk since there can be an arbitrary
-    	// amount of time spent in this window.
-
-        if (unlock_rx_pkt_buf(rx_pkt_buf) != PKT_BUF_MUTEX_SUCCESS) {
-            xil_printf("Error: unable to unlock RX pkt_buf %d\n", rx_pkt_buf);
-            wlan_mac_low_send_exception(WLAN_ERROR_CODE_CPU_LOW_RX_MUTEX);
-        } else {
-            wlan_mac_low_frame_ipc_send();
-
-            // Find a free packet buffer and begin receiving packets there (blocks until free buf is found)
-            wlan_mac_low_lock_empty_rx_pkt_buf();
-        }
+        wlan_mac_low_frame_ipc_send();
     }
 
     wlan_mac_hw_clear_rx_started();
@@ -1514,7 +1507,9 @@ u32 poll_tx_pkt_buf_list(pkt_buf_group_t pkt_buf_group){
 				pkt_buf = *((u8*)(entry->data));
 
 				if( wlan_mac_low_prepare_frame_transmit(pkt_buf) == 0 ){
+					WLAN_PROF_START(PROF_PROBE_FRAME_TRANSMIT_GENERAL);
 					frame_transmit_general(pkt_buf);
+					WLAN_PROF_END(PROF_PROBE_FRAME_TRANSMIT_GENERAL);
 
 					return_value |= POLL_TX_PKT_BUF_LIST_RETURN_TRANSMITTED;
 					wlan_mac_low_finish_frame_transmit(pkt_buf);
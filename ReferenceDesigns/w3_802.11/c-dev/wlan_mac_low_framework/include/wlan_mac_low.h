@@ -300,9 +300,18 @@ struct wlan_ipc_msg_t;
 #define LOW_PARAM_AD_SCALING         	0x00000005
 #define LOW_PARAM_PKT_DET_MIN_POWER  	0x00000006
 #define LOW_PARAM_PHY_SAMPLE_RATE    	0x00000008
+#define LOW_PARAM_TX_REPORT_COALESCE 	0x00000009
+#define LOW_PARAM_PROF_RESET         	0x0000000A
 #define LOW_PARAM_DSSS_PKT_DET_THRESH	0x0000A000
 #define LOW_PARAM_OFDM_PKT_DET_THRESH	0x0000B000
 
+//-----------------------------------------------
+// Tx report coalescing
+//     Maximum number of IPC_MBOX_TX_PKT_BUF_DONE messages held in an open Tx report batch.
+//     Each one holds back a Tx packet buffer that CPU High could refill, so the batch is
+//     passed to CPU High once half of the MPDU Tx packet buffers are waiting in it.
+#define TX_REPORT_COALESCE_MAX_TX_DONE                     (NUM_TX_PKT_BUF_MPDU / 2)
+
 
 
 /*************************** Function Prototypes *****************************/
@@ -319,8 +328,9 @@ u32         wlan_mac_low_poll_frame_rx();
 int         wlan_mac_low_poll_ipc_rx();
 
 void               wlan_mac_low_process_ipc_msg(struct wlan_ipc_msg_t * msg);
-void               wlan_mac_low_frame_ipc_send();
+int                wlan_mac_low_frame_ipc_send();
 void 			   wlan_mac_low_send_low_tx_details(u8 pkt_buf, struct wlan_mac_low_tx_details_t* low_tx_details);
+void               wlan_mac_low_flush_tx_reports();
 
 void               wlan_mac_low_set_frame_rx_callback(function_ptr_t callback);
 void 			   wlan_mac_low_set_beacon_txrx_config_callback(function_ptr_t callback);
@@ -353,7 +363,7 @@ int 			   wlan_mac_low_finish_frame_transmit(u16 tx_pkt_buf);
 
 
 
-void        wlan_mac_low_lock_empty_rx_pkt_buf();
+int         wlan_mac_low_lock_empty_rx_pkt_buf();
 
 u32         wlan_mac_hw_rx_finish();
 
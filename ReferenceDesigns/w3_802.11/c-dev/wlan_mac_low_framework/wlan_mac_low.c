@@ -29,6 +29,8 @@
 #include "wlan_mac_low.h"
 #include "wlan_mac_common.h"
 #include "wlan_mac_pkt_buf_util.h"
+#include "wlan_mac_dprint.h"
+#include "wlan_mac_prof.h"
 
 
 // WLAN Exp includes
@@ -53,6 +55,13 @@ static volatile u8 mac_param_dsss_en; ///< Enable / Disable DSSS when possible
 static volatile s8 mac_param_ctrl_tx_pow; ///< Current transmit power (dBm) for control packets
 static volatile u32 mac_param_rx_filter; ///< Current filter applied to packet receptions
 static volatile u8 rx_pkt_buf; ///< Current receive buffer of the lower-level MAC
+static u32 rx_pkt_buf_num_dropped; ///< Receptions dropped since the last Rx packet buffer was passed to CPU High
+
+static u32 tx_report_coalesce_max; ///< Maximum number of Tx reports per IPC batch (0 or 1 disables coalescing)
+static u32 tx_report_coalesce_timeout; ///< Maximum time (usec) a Tx report is held before it is passed to CPU High
+static u32 tx_report_batch_num; ///< Number of Tx reports in the open IPC batch
+static u32 tx_report_batch_num_tx_done; ///< Number of Tx done messages in the open IPC batch
+static u64 tx_report_batch_start; ///< Time (usec) of the first Tx report in the open IPC batch
 
 static u32 cpu_low_status; ///< Status flags that are reported to upper-level MAC
 static u32 cpu_low_type; ///< wlan_exp CPU_LOW type that is reported to upper-level MAC
@@ -100,6 +109,9 @@ int wlan_mac_low_init(u32 type, compilation_details_t compilation_details){
 	tx_frame_info_t* tx_frame_info;
     u32 i;
 
+    wlan_mac_dprint_init();
+    wlan_mac_prof_init();
+
     /**********************************************************************************
      * Initialize the low platform first - this must happen before the low application
      *  attempts to use any hardware resources
@@ -241,7 +253,17 @@ int wlan_mac_low_init(u32 type, compilation_details_t compilation_details){
     ipc_msg_from_high.payload_ptr = &(ipc_msg_from_high_payload[0]);
 
     // Point the PHY to an empty Rx Pkt Buffer
-    wlan_mac_low_lock_empty_rx_pkt_buf();
+    //     - If CPU Low rebooted while CPU High owned all of the Rx packet buffers, wait
+    //       for CPU High to release one
+    rx_pkt_buf_num_dropped = 0;
+
+    while (wlan_mac_low_lock_empty_rx_pkt_buf() != 0) {}
+
+    // Tx report coalescing is disabled until CPU High enables it with LOW_PARAM_TX_REPORT_COALESCE
+    tx_report_coalesce_max     = 0;
+    tx_report_coalesce_timeout = 0;
+    tx_report_batch_num        = 0;
+    tx_report_batch_num_tx_done = 0;
 
     // Move the PHY's starting address into the packet buffers by PHY_XX_PKT_BUF_PHY_HDR_OFFSET.
     // This accounts for the metadata located at the front of every packet buffer (Xx_mpdu_info)
@@ -289,18 +311,21 @@ void wlan_mac_low_init_finish(){
 
 void wlan_mac_low_send_status(u8 cpu_status_reason){
 	wlan_ipc_msg_t ipc_msg_to_high;
-	u32 ipc_msg_to_high_payload[2+(sizeof(compilation_details_t)/sizeof(u32))];
+	u32 ipc_msg_to_high_payload[3+(sizeof(compilation_details_t)/sizeof(u32))];
 
 	// Send a message to other processor to say that this processor is initialized and ready
+	//     The last word is the address of the profiling probes of CPU Low (0 if profiling is not compiled)
 	ipc_msg_to_high.msg_id            = IPC_MBOX_MSG_ID(IPC_MBOX_CPU_STATUS);
 	ipc_msg_to_high.arg0			  = cpu_status_reason;
-	ipc_msg_to_high.num_payload_words = 2+(sizeof(compilation_details_t)/sizeof(u32));
+	ipc_msg_to_high.num_payload_words = 3+(sizeof(compilation_details_t)/sizeof(u32));
 	ipc_msg_to_high.payload_ptr       = &(ipc_msg_to_high_payload[0]);
 	ipc_msg_to_high_payload[0]        = cpu_low_status;
 	ipc_msg_to_high_payload[1]        = cpu_low_type;
 	memcpy((u8*)&(ipc_msg_to_high_payload[2]), (u8*)&cpu_low_compilation_details, sizeof(compilation_details_t));
+	ipc_msg_to_high_payload[2+(sizeof(compilation_details_t)/sizeof(u32))] = (u32)wlan_mac_prof_get_table();
 
 	write_mailbox_msg(&ipc_msg_to_high);
+	wlan_mac_low_flush_tx_reports();
 }
 
 
@@ -424,6 +449,7 @@ inline void wlan_mac_low_send_exception(u32 reason){
     ipc_msg_to_high_payload[1]        = reason;
 
     write_mailbox_msg(&ipc_msg_to_high);
+    wlan_mac_low_flush_tx_reports();
 
     // Set the Hex display with the reason code and flash the LEDs
     wlan_platform_low_userio_disp_status(USERIO_DISP_STATUS_CPU_ERROR,reason);
@@ -491,7 +517,10 @@ inline u32 wlan_mac_low_poll_frame_rx(){
 
             // Call the user callback to handle this Rx, capture return value
         	return_status |= FRAME_RX_RET_STATUS_RECEIVED_PKT;
+
+        	WLAN_PROF_START(PROF_PROBE_FRAME_RECEIVE);
         	return_status |= frame_rx_callback(rx_pkt_buf, &phy_details);
+        	WLAN_PROF_END(PROF_PROBE_FRAME_RECEIVE);
 
         } else {
         	// OFDM Rx - must wait for valid PHY header
@@ -563,7 +592,10 @@ inline u32 wlan_mac_low_poll_frame_rx(){
                     rx_frame_info->phy_details    = phy_details;
 
                 	return_status |= FRAME_RX_RET_STATUS_RECEIVED_PKT;
+
+                	WLAN_PROF_START(PROF_PROBE_FRAME_RECEIVE);
                 	return_status |= frame_rx_callback(rx_pkt_buf, &phy_details);
+                	WLAN_PROF_END(PROF_PROBE_FRAME_RECEIVE);
                 }
             } else {
             	// PHY went idle before PHY_HDR_DONE, probably due to external reset
@@ -594,11 +626,18 @@ inline u32 wlan_mac_low_poll_frame_rx(){
  * @brief Poll for IPC Receptions
  *
  * This function is a non-blocking poll for IPC receptions from the upper-level MAC.
+ * It also passes coalesced Tx reports to the upper-level MAC once the oldest one
+ * has been held for the coalescing timeout.
  *
  * @param   None
  * @return  int				- 0 when mailbox was empty, 1 when one message was processed
  */
 inline int wlan_mac_low_poll_ipc_rx(){
+    // Flush Tx reports that have waited long enough
+    if ((tx_report_batch_num != 0) && ((get_mac_time_usec() - tx_report_batch_start) >= tx_report_coalesce_timeout)) {
+        wlan_mac_low_flush_tx_reports();
+    }
+
     // Poll mailbox read msg
     if (read_mailbox_msg(&ipc_msg_from_high) == IPC_MBOX_SUCCESS) {
         wlan_mac_low_process_ipc_msg(&ipc_msg_from_high);
@@ -727,6 +766,22 @@ void wlan_mac_low_process_ipc_msg(wlan_ipc_msg_t * msg){
                         case LOW_PARAM_PHY_SAMPLE_RATE: {
                             set_phy_samp_rate(ipc_msg_from_high_payload[1]);
                         }
+                        break;
+
+                        case LOW_PARAM_TX_REPORT_COALESCE: {
+                            // Two u32 values:
+                            //  payload[1]: Maximum number of Tx reports per batch (0 or 1 disables coalescing)
+                            //  payload[2]: Maximum time (usec) a Tx report is held
+                            wlan_mac_low_flush_tx_reports();
+
+                            tx_report_coalesce_max     = ipc_msg_from_high_payload[1];
+                            tx_report_coalesce_timeout = ipc_msg_from_high_payload[2];
+                        }
+                        break;
+
+                        case LOW_PARAM_PROF_RESET: {
+                            wlan_mac_prof_reset();
+                        }
                         break;
 
                 		case LOW_PARAM_DSSS_PKT_DET_THRESH: {
@@ -1052,6 +1107,17 @@ int wlan_mac_low_finish_frame_transmit(u16 tx_pkt_buf){
 					ipc_msg_to_high.arg0 = tx_pkt_buf;
 
 					write_mailbox_msg(&ipc_msg_to_high);
+
+					// The message joins an open Tx report batch.  Bound the number of Tx packet
+					// buffers and the time CPU High waits for them (see TX_REPORT_COALESCE_MAX_TX_DONE)
+					if (tx_report_batch_num != 0) {
+						tx_report_batch_num_tx_done++;
+
+						if ((tx_report_batch_num_tx_done >= TX_REPORT_COALESCE_MAX_TX_DONE) ||
+						    ((get_mac_time_usec() - tx_report_batch_start) >= tx_report_coalesce_timeout)) {
+							wlan_mac_low_flush_tx_reports();
+						}
+					}
 				}
 			}
 		break;
@@ -1108,6 +1174,22 @@ int wlan_mac_low_prepare_frame_transmit(u16 tx_pkt_buf){
 	return 0;
 }
 
+/*****************************************************************************/
+/**
+ * @brief Send Tx Report to Upper-Level MAC
+ *
+ * Passes the details of one transmission attempt to the upper-level MAC.  When Tx
+ * report coalescing is enabled (LOW_PARAM_TX_REPORT_COALESCE), the report is written
+ * to the IPC ring inside of an IPC batch.  The batch, together with any other
+ * message written in the meantime (e.g. IPC_MBOX_TX_PKT_BUF_DONE), is passed to
+ * CPU High with a single doorbell once it holds tx_report_coalesce_max reports or
+ * TX_REPORT_COALESCE_MAX_TX_DONE Tx done messages, or its oldest report is
+ * tx_report_coalesce_timeout usec old.
+ *
+ * @param   pkt_buf          - Tx packet buffer of the transmission
+ * @param   low_tx_details   - Pointer to the details of the transmission
+ * @return  None
+ */
 void wlan_mac_low_send_low_tx_details(u8 pkt_buf, wlan_mac_low_tx_details_t* low_tx_details){
 	wlan_ipc_msg_t ipc_msg_to_high;
 
@@ -1116,7 +1198,24 @@ void wlan_mac_low_send_low_tx_details(u8 pkt_buf, wlan_mac_low_tx_details_t* low
 	ipc_msg_to_high.num_payload_words = (sizeof(wlan_mac_low_tx_details_t) / sizeof(u32));
 
 	ipc_msg_to_high.msg_id =  IPC_MBOX_MSG_ID(IPC_MBOX_PHY_TX_REPORT);
+
+	if (tx_report_coalesce_max <= 1) {
+		write_mailbox_msg(&ipc_msg_to_high);
+		return;
+	}
+
+	if (tx_report_batch_num == 0) {
+		ipc_batch_start();
+		tx_report_batch_start = get_mac_time_usec();
+	}
+
 	write_mailbox_msg(&ipc_msg_to_high);
+	tx_report_batch_num++;
+
+	if ((tx_report_batch_num >= tx_report_coalesce_max) ||
+	    ((get_mac_time_usec() - tx_report_batch_start) >= tx_report_coalesce_timeout)) {
+		wlan_mac_low_flush_tx_reports();
+	}
 	return;
 }
 
@@ -1124,24 +1223,87 @@ void wlan_mac_low_send_low_tx_details(u8 pkt_buf, wlan_mac_low_tx_details_t* low
 
 /*****************************************************************************/
 /**
- * @brief Notify upper-level MAC of frame reception
+ * @brief Flush Coalesced Tx Reports
  *
- * Sends an IPC message to the upper-level MAC to notify it that a frame has been
- * received and is ready to be processed
+ * Passes all Tx reports held by the open IPC batch to the upper-level MAC.  Does
+ * nothing if no Tx reports are held.
  *
  * @param   None
  * @return  None
+ */
+void wlan_mac_low_flush_tx_reports(){
+	if (tx_report_batch_num != 0) {
+		tx_report_batch_num         = 0;
+		tx_report_batch_num_tx_done = 0;
+		ipc_batch_end();
+	}
+}
+
+
+
+/*****************************************************************************/
+/**
+ * @brief Pass frame reception to upper-level MAC
+ *
+ * Passes the current Rx packet buffer, which holds a new reception, to the upper-level
+ * MAC.  The PHY is first pointed to the next empty Rx packet buffer.  If there is no
+ * empty Rx packet buffer because CPU High has fallen behind, the reception is dropped
+ * and the PHY keeps receiving into the current Rx packet buffer.  This function never
+ * blocks, so the lower-level MAC keeps running while CPU High catches up.
+ *
+ * The IPC message carries the number of receptions that were dropped since the
+ * previous message, so CPU High can count Rx packet buffer overruns.
+ *
+ * @param   None
+ * @return  int              - 0 if the reception was passed to CPU High
+ *                            -1 if the reception was dropped
  *
  * @note This function assumes it is called in the same context where rx_pkt_buf is still valid.
  */
-void wlan_mac_low_frame_ipc_send(){
+int wlan_mac_low_frame_ipc_send(){
     wlan_ipc_msg_t ipc_msg_to_high;
+    u32 ipc_msg_to_high_payload[1];
+    u8 ready_pkt_buf = rx_pkt_buf;
+    rx_frame_info_t* rx_frame_info = (rx_frame_info_t*)CALC_PKT_BUF_ADDR(platform_common_dev_info.rx_pkt_buf_baseaddr, ready_pkt_buf);
+
+    // Mark the packet buffer as ready so the search for an empty packet buffer skips it
+    rx_frame_info->rx_pkt_buf_state = RX_PKT_BUF_READY;
+
+    if (wlan_mac_low_lock_empty_rx_pkt_buf() != 0) {
+        // Rx overrun - keep the packet buffer and drop the reception
+        rx_frame_info->rx_pkt_buf_state = RX_PKT_BUF_LOW_CTRL;
+        rx_pkt_buf_num_dropped++;
+        return -1;
+    }
+
+    // Note: at this point in the code, the packet buffer state has been modified to RX_PKT_BUF_READY,
+    // yet we have not sent the IPC_MBOX_RX_PKT_BUF_READY message. If we happen to reboot here,
+    // this packet buffer will be abandoned and won't be cleaned up in the boot process. This is a narrow
+    // race in practice, but step-by-step debugging can accentuate the risk since there can be an arbitrary
+    // amount of time spent in this window.
+
+    // Unlock the pkt buf mutex before passing the packet up
+    //     If this fails, something has gone horribly wrong
+    if (unlock_rx_pkt_buf(ready_pkt_buf) != PKT_BUF_MUTEX_SUCCESS) {
+        xil_printf("Error: unable to unlock RX pkt_buf %d\n", ready_pkt_buf);
+        wlan_mac_low_send_exception(WLAN_ERROR_CODE_CPU_LOW_RX_MUTEX);
+        return -1;
+    }
 
     ipc_msg_to_high.msg_id            = IPC_MBOX_MSG_ID(IPC_MBOX_RX_PKT_BUF_READY);
-    ipc_msg_to_high.num_payload_words = 0;
-    ipc_msg_to_high.arg0              = rx_pkt_buf;
+    ipc_msg_to_high.num_payload_words = 1;
+    ipc_msg_to_high.arg0              = ready_pkt_buf;
+    ipc_msg_to_high.payload_ptr       = &(ipc_msg_to_high_payload[0]);
+    ipc_msg_to_high_payload[0]        = rx_pkt_buf_num_dropped;
 
     write_mailbox_msg(&ipc_msg_to_high);
+
+    // Receptions are not held back:  pass any coalesced Tx reports along with this message
+    wlan_mac_low_flush_tx_reports();
+
+    rx_pkt_buf_num_dropped = 0;
+
+    return 0;
 }
 
 
@@ -1286,60 +1448,56 @@ void wlan_mac_low_set_nav_check_addr(u8* addr) {
 
 /*****************************************************************************/
 /**
- * @brief Search for and Lock Empty Packet Buffer (Blocking)
+ * @brief Search for and Lock Empty Packet Buffer
  *
- * This is a blocking function for finding and locking an empty rx packet buffer. The low framework
- * calls this function after passing a new wireless reception up to CPU High for processing. CPU High
- * must unlock Rx packet buffers after processing the received packet. This function loops over all Rx
- * packet buffers until it finds one that has been unlocked by CPU High.
+ * This is a non-blocking function for finding and locking an empty rx packet buffer. The low framework
+ * calls this function before passing a new wireless reception up to CPU High for processing. CPU High
+ * must unlock Rx packet buffers after processing the received packet.
  *
- * By design this function prints a message if it fails to unlock the oldest packet buffer. When this
- * occurs it indicates that CPU Low has outrun CPU High, a situation that leads to dropped wireless
- * receptions with high probability. The node recovers gracefully from this condition and will
- * continue processing new Rx events after CPU High catches up. But seeing this message in the UART
- * for CPU Low is a strong indicator the CPU High code is not keeping up with wireless receptions.
+ * The Rx packet buffers form a ring:  CPU Low passes them to CPU High in order and CPU High processes
+ * the IPC messages in order, so the buffer after rx_pkt_buf is the "oldest" one, the one that is most
+ * likely to have already been processed and released by CPU High. This function checks each packet
+ * buffer once, starting with the oldest. If CPU High still owns all of them, CPU Low has outrun CPU High;
+ * the caller then drops the reception instead of waiting (see wlan_mac_low_frame_ipc_send()).
  *
  * @param   None
- * @return  None
+ * @return  int              - 0 if the PHY now uses an empty packet buffer (rx_pkt_buf)
+ *                            -1 if no packet buffer is empty (rx_pkt_buf is unchanged)
  *
  * @note    This function assumes it is called in the same context where rx_pkt_buf is still valid.
  */
-inline void wlan_mac_low_lock_empty_rx_pkt_buf(){
-    // This function blocks until it safely finds a packet buffer for the PHY RX to store a future reception
+inline int wlan_mac_low_lock_empty_rx_pkt_buf(){
     rx_frame_info_t* rx_frame_info;
-    u32 i = 1;
+    u32 i;
+    u8  pkt_buf = rx_pkt_buf;
 
-    while(1) {
-    	//rx_pkt_buf is the global shared by all contexts which deal with wireless Rx
-    	// Rx packet buffers are used in order. Thus incrementing rx_pkt_buf should
-    	// select the "oldest" packet buffer, the one that is most likely to have already
-    	// been processed and released by CPU High
-    	rx_pkt_buf = (rx_pkt_buf+1) % NUM_RX_PKT_BUFS;
-    	rx_frame_info    = (rx_frame_info_t*) CALC_PKT_BUF_ADDR(platform_common_dev_info.rx_pkt_buf_baseaddr, rx_pkt_buf);
+    for (i = 0; i < NUM_RX_PKT_BUFS; i++) {
+        pkt_buf       = (pkt_buf + 1) % NUM_RX_PKT_BUFS;
+        rx_frame_info = (rx_frame_info_t*) CALC_PKT_BUF_ADDR(platform_common_dev_info.rx_pkt_buf_baseaddr, pkt_buf);
 
-        if((rx_frame_info->rx_pkt_buf_state) == RX_PKT_BUF_LOW_CTRL){
+        if ((rx_frame_info->rx_pkt_buf_state) == RX_PKT_BUF_LOW_CTRL) {
 
-        	if(lock_rx_pkt_buf(rx_pkt_buf) == PKT_BUF_MUTEX_SUCCESS){
-			// By default Rx pkt buffers are not zeroed out, to save the performance penalty of bzero'ing 2KB
-			//     However zeroing out the pkt buffer can be helpful when debugging Rx MAC/PHY behaviors
-			// bzero((void *)(RX_PKT_BUF_TO_ADDR(rx_pkt_buf)), 2048);
+            if (lock_rx_pkt_buf(pkt_buf) == PKT_BUF_MUTEX_SUCCESS) {
+                // By default Rx pkt buffers are not zeroed out, to save the performance penalty of bzero'ing 2KB
+                //     However zeroing out the pkt buffer can be helpful when debugging Rx MAC/PHY behaviors
+                // bzero((void *)(RX_PKT_BUF_TO_ADDR(pkt_buf)), 2048);
 
-			// Set the OFDM and DSSS PHYs to use the same Rx pkt buffer
-			wlan_phy_rx_pkt_buf_ofdm(rx_pkt_buf);
-			wlan_phy_rx_pkt_buf_dsss(rx_pkt_buf);
+                //rx_pkt_buf is the global shared by all contexts which deal with wireless Rx
+                rx_pkt_buf = pkt_buf;
 
-			if (i > 1) { xil_printf("found in %d iterations.\n", i); }
+                // Set the OFDM and DSSS PHYs to use the same Rx pkt buffer
+                wlan_phy_rx_pkt_buf_ofdm(pkt_buf);
+                wlan_phy_rx_pkt_buf_dsss(pkt_buf);
 
-			return;
-        	} else {
-        		xil_printf("Error: unable to lock Rx pkt_buf %d despite RX_PKT_BUF_LOW_CTRL\n", rx_pkt_buf);
-        		unlock_rx_pkt_buf(rx_pkt_buf);
-        }
+                return 0;
+            } else {
+                wlan_dprintf(PL_ERROR, "Error: unable to lock Rx pkt_buf %d despite RX_PKT_BUF_LOW_CTRL\n", pkt_buf);
+                unlock_rx_pkt_buf(pkt_buf);
+            }
         }
-
-        if (i == 1) { xil_printf("Searching for empty packet buff ... "); }
-        i++;
     }
+
+    return -1;
 }
 
 
@@ -29,6 +29,7 @@
 #include "wlan_mac_nomac.h"
 #include "xparameters.h"
 #include "wlan_mac_common.h"
+#include "wlan_mac_dprint.h"
 #include "wlan_mac_mailbox_util.h"
 
 // WLAN Exp includes
@@ -68,6 +69,7 @@ int main(){
 
     wlan_mac_hw_info_t* hw_info;
     compilation_details_t compilation_details;
+    u32 loop_busy;
     bzero(&compilation_details, sizeof(compilation_details_t));
 
     xil_printf("\f");
@@ -118,10 +120,16 @@ int main(){
 
     while(1){
         // Poll PHY RX start
-        wlan_mac_low_poll_frame_rx();
+        loop_busy = wlan_mac_low_poll_frame_rx();
 
         // Poll IPC rx
-        wlan_mac_low_poll_ipc_rx();
+        loop_busy |= wlan_mac_low_poll_ipc_rx();
+
+        // Print deferred messages only when this pass found no work
+        //     A message blocks on the UART for milliseconds
+        if (loop_busy == 0) {
+            wlan_mac_dprint_poll();
+        }
     }
 
     return 0;
@@ -170,16 +178,9 @@ u32 frame_receive(u8 rx_pkt_buf, phy_rx_details_t* phy_details){
     	wlan_platform_low_userio_disp_status(USERIO_DISP_STATUS_BAD_FCS_EVENT);
     }
 
-    rx_frame_info->rx_pkt_buf_state = RX_PKT_BUF_READY;
-	if (unlock_rx_pkt_buf(rx_pkt_buf) != PKT_BUF_MUTEX_SUCCESS) {
-		xil_printf("Error: unable to unlock RX pkt_buf %d\n", rx_pkt_buf);
-		wlan_mac_low_send_exception(WLAN_ERROR_CODE_CPU_LOW_RX_MUTEX);
-	} else {
-		wlan_mac_low_frame_ipc_send();
-
-		// Find a free packet buffer and begin receiving packets there (blocks until free buf is found)
-		wlan_mac_low_lock_empty_rx_pkt_buf();
-	}
+    // Pass the packet up to CPU High and begin receiving packets in the next empty packet buffer
+    //     (drops the reception if there is no empty packet buffer)
+    wlan_mac_low_frame_ipc_send();
 
 
     return 0;
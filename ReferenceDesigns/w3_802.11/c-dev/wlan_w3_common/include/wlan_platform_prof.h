@@ -0,0 +1,33 @@
+/** @file wlan_platform_prof.h
+ *  @brief Profiling Timestamp Macros
+ *
+ *  This file is included by wlan_mac_prof.h to read the timestamps of the
+ *  profiling probes. Like wlan_platform_debug_hdr.h, it is included directly
+ *  so that a timestamp is a single register read instead of a function call.
+ *
+ *  @copyright Copyright 2013-2017, Mango Communications. All rights reserved.
+ *          Distributed under the Mango Communications Reference Design License
+ *              See LICENSE.txt included in the design archive or
+ *              at http://mangocomm.com/802.11/license
+ *
+ *  This file is part of the Mango 802.11 Reference Design (https://mangocomm.com/802.11)
+ */
+
+#ifndef WLAN_PLATFORM_COMMON_INCLUDE_WLAN_PLATFORM_PROF_H_
+#define WLAN_PLATFORM_COMMON_INCLUDE_WLAN_PLATFORM_PROF_H_
+
+#include "xparameters.h"
+#include "xil_io.h"
+#include "w3_mac_time_util.h"
+
+
+// WARP v3 does not give either CPU a free-running cycle counter (both AXI timer
+// counters of CPU High are used by the scheduler), so the probes use the 32 LSB
+// of the system time (1 tick per microsecond). The system time can not be
+// updated, so differences of two timestamps are always valid.
+#define PLATFORM_PROF_TICKS_PER_USEC            1
+
+#define wlan_platform_prof_timestamp()          Xil_In32(WLAN_MAC_TIME_REG_SYSTEM_TIME_LSB)
+
+
+#endif /* WLAN_PLATFORM_COMMON_INCLUDE_WLAN_PLATFORM_PROF_H_ */
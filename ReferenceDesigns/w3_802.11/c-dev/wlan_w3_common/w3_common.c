@@ -10,6 +10,7 @@
 #include "w3_common.h"
 #include "w3_userio_util.h"
 #include "wlan_mac_common.h"
+#include "wlan_mac_pkt_buf_util.h"
 #include "w3_iic_eeprom.h"
 #include "w3_sysmon_util.h"
 #include "wlan_cpu_id.h"
@@ -18,6 +19,11 @@
 
 
 
+// The Rx packet buffer BRAM must hold all of the Rx packet buffers
+#if ((NUM_RX_PKT_BUFS * PKT_BUF_SIZE) > (XPAR_PKT_BUFF_RX_BRAM_CTRL_S_AXI_HIGHADDR - XPAR_PKT_BUFF_RX_BRAM_CTRL_S_AXI_BASEADDR + 1))
+#error "NUM_RX_PKT_BUFS exceeds the size of the Rx packet buffer BRAM"
+#endif
+
 static const platform_common_dev_info_t platform_common_dev_info = {
 		.platform_id = PLATFORM_ID,
 		.cpu_id = XPAR_CPU_ID,
@@ -41,6 +41,14 @@
 #define WLAN_ETH_LINK_SPEED	                               1000
 #define WLAN_ETH_PKT_BUF_SIZE                              0x800               // 2KB - space allocated per pkt
 
+// Tx queue buffer size classes used for Ethernet receptions (see wlan_mac_queue.h)
+//     - Rx BDs point to buffers of WLAN_ETH_RX_BUFFER_CLASS.  This class must hold the
+//       ETH_PAYLOAD_OFFSET bytes before the Ethernet payload plus a standard 1522 byte frame.
+//     - Frames that fit in a buffer of WLAN_ETH_RX_COPY_BREAK_CLASS are copied out of the Rx BD
+//       buffer, so the larger buffer is immediately available to the DMA again
+#define WLAN_ETH_RX_BUFFER_CLASS                           QUEUE_BUFFER_CLASS_MEDIUM
+#define WLAN_ETH_RX_COPY_BREAK_CLASS                       QUEUE_BUFFER_CLASS_SMALL
+
 int wlan_platform_ethernet_send(u8* pkt_ptr, u32 length);
 int w3_wlan_platform_ethernet_init();
 int w3_wlan_platform_ethernet_setup_interrupt(XIntc* intc);
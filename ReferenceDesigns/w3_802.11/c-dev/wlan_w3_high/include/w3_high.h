@@ -64,6 +64,11 @@
 
 // Central DMA (CMDA)
 #define PLATFORM_DEV_ID_CMDA				 XPAR_AXI_CDMA_0_DEVICE_ID
+#ifdef XPAR_INTC_0_AXICDMA_0_VEC_ID
+#define PLATFORM_INT_ID_CDMA				 XPAR_INTC_0_AXICDMA_0_VEC_ID
+#else
+#define PLATFORM_INT_ID_CDMA				 PLATFORM_INT_ID_NONE               ///< CDMA interrupt is not connected to the interrupt controller
+#endif
 
 // Mailbox Interrupt
 #define PLATFORM_INT_ID_MAILBOX    			 XPAR_INTC_0_MBOX_0_VEC_ID
@@ -11,6 +11,7 @@
 #include "xaxidma.h"
 #include "xintc.h"
 #include "stddef.h"
+#include "string.h"
 #include "wlan_platform_common.h"
 #include "wlan_platform_high.h"
 #include "wlan_mac_common.h"
@@ -370,7 +371,7 @@ int _wlan_eth_dma_init() {
 
     for (i = 0; i < bd_count; i++) {
         // Check out queue element for Rx buffer descriptor
-        curr_tx_queue_element = queue_checkout();
+        curr_tx_queue_element = queue_checkout_class(WLAN_ETH_RX_BUFFER_CLASS);
 
         if (curr_tx_queue_element == NULL) {
             xil_printf("Error during _wlan_eth_dma_init: unable to check out sufficient tx_queue_element\n");
@@ -419,6 +420,7 @@ int _wlan_eth_dma_init() {
 int _init_rx_bd(XAxiDma_Bd * bd_ptr, dl_entry * tqe_ptr, u32 max_transfer_len) {
     int status;
     u32 buf_addr;
+    u32 buf_len;
 
     if ((bd_ptr == NULL) || (tqe_ptr == NULL)) { return -1; }
 
@@ -435,7 +437,11 @@ int _init_rx_bd(XAxiDma_Bd * bd_ptr, dl_entry * tqe_ptr, u32 max_transfer_len) {
     //     NOTE:  Jumbo Ethernet frames are not supported by the Ethernet device (ie the XAE_JUMBO_OPTION is cleared),
     //         so the WLAN_ETH_PKT_BUF_SIZE must be at least large enough to support standard MTUs (ie greater than
     //         1522 bytes) so the assumption of 1 BD = 1 Rx pkt is met.
-    status = XAxiDma_BdSetLength(bd_ptr, WLAN_ETH_PKT_BUF_SIZE, max_transfer_len);
+    //     NOTE:  The length is limited to the space after ETH_PAYLOAD_OFFSET in the Tx queue buffer, which
+    //         depends on its size class.  This is also at least 1522 bytes for WLAN_ETH_RX_BUFFER_CLASS.
+    buf_len = min(WLAN_ETH_PKT_BUF_SIZE, (queue_class_max_frame_len(queue_entry_class(tqe_ptr)) - ETH_PAYLOAD_OFFSET));
+
+    status = XAxiDma_BdSetLength(bd_ptr, buf_len, max_transfer_len);
     if (status != XST_SUCCESS) { xil_printf("XAxiDma_BdSetLength failed (addr 0x08x)! Err = %d\n", buf_addr, status); return -1; }
 
     // Rx BD's don't need control flags before use; DMA populates these post-Rx
@@ -527,6 +533,7 @@ void _wlan_process_all_eth_pkts(u32 schedule_id) {
     u32 eth_rx_len, eth_rx_buf;
     u32 status;
     dl_entry* curr_tx_queue_element;
+    dl_entry* copy_tx_queue_element;
     tx_queue_buffer_t* tx_queue_buffer;
     u8* mpdu_start_ptr;
 
@@ -557,6 +564,25 @@ void _wlan_process_all_eth_pkts(u32 schedule_id) {
     	tx_queue_buffer = (tx_queue_buffer_t*)( (u8*)mpdu_start_ptr - offsetof(tx_queue_buffer_t,frame));
     	curr_tx_queue_element = tx_queue_buffer->tx_queue_entry;
 
+    	// Copy small packets (e.g. TCP ACKs) to a smaller Tx queue buffer
+    	//     NOTE:  Otherwise every enqueued packet holds a WLAN_ETH_RX_BUFFER_CLASS buffer until it is
+    	//         transmitted.  The Rx BD buffer is checked back in and reassigned to a BD by _wlan_eth_dma_update().
+    	//         If there are no free buffers of the smaller class, the packet is processed in place.
+    	if ((eth_rx_len + ETH_PAYLOAD_OFFSET) <= queue_class_max_frame_len(WLAN_ETH_RX_COPY_BREAK_CLASS)) {
+    		copy_tx_queue_element = queue_checkout_class(WLAN_ETH_RX_COPY_BREAK_CLASS);
+
+    		if (copy_tx_queue_element != NULL) {
+    			tx_queue_buffer = (tx_queue_buffer_t*)(copy_tx_queue_element->data);
+
+    			memcpy((void*)(tx_queue_buffer->frame + ETH_PAYLOAD_OFFSET), (void*)eth_rx_buf, eth_rx_len);
+
+    			queue_checkin(curr_tx_queue_element);
+
+    			curr_tx_queue_element = copy_tx_queue_element;
+    			eth_rx_buf            = (u32)(tx_queue_buffer->frame + ETH_PAYLOAD_OFFSET);
+    		}
+    	}
+
     	wlan_process_eth_rx_return = wlan_process_eth_rx((void*)eth_rx_buf, eth_rx_len);
 
         // Free the ETH DMA buffer descriptor
@@ -680,7 +706,7 @@ void _wlan_eth_dma_update() {
     dl_list_init(&checkout);
 
     // Attempt to checkout Tx queue entries for all free buffer descriptors
-    queue_checkout_list(&checkout, bd_count);
+    queue_checkout_list(&checkout, bd_count, WLAN_ETH_RX_BUFFER_CLASS);
 
     // If there were not enough Tx queue entries available, the length of the
     // checkout list will be the number of free Tx queue entries that were
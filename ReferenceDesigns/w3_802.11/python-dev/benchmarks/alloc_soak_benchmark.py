@@ -0,0 +1,310 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Allocation Soak Test
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark models the runtime memory allocations of CPU High and compares
+the heap fragmentation of the original allocator (every object allocated with
+wlan_mac_high_malloc()) with the memory pools of wlan_mac_pool.c while LTGs,
+stations and scheduled events are created and destroyed for millions of
+iterations.
+
+Hardware Setup:
+    - None.  The allocators are modeled on the host
+
+Required Script Changes:
+    - None.  The number of iterations can be passed as a command line
+        argument (default: 2000000)
+
+Description:
+    The heap model is a first-fit allocator with 8 byte headers, 8 byte
+    alignment and coalescing of free chunks in the 8 kB heap of CPU High
+    (_HEAP_SIZE in lscript.ld).  The heap can not grow beyond its size.
+
+    Each iteration creates or destroys one object of a random kind:
+        - LTG:  dl_entry, tg_schedule, params, state and payload (plus the
+          temporary params of CMDID_LTG_CONFIG)
+        - Station:  station_info_entry_t of a station list
+        - Schedule:  dl_entry and wlan_sched
+        - Network search:  network_info_entry_t of an SSID match list
+        - SSID:  Variable length string (scan / join parameters)
+        - wlan_exp command:  Temporary station_info_t or network_info_t
+
+    With memory pools, the fixed-size objects use the pools (with fallback
+    to the heap) and the wlan_exp temporaries use the command arena.  SSID
+    strings stay on the heap in both cases.
+
+    Fragmentation is 1 - (largest free chunk / total free space) of the heap.
+------------------------------------------------------------------------------
+"""
+import sys
+import bisect
+import random
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_NUM_ITER    = 2000000
+SEED                = 0
+
+HEAP_SIZE           = 0x2000          # _HEAP_SIZE
+HEAP_RESERVED       = 1024            # Allocations made at boot (Tx queue array, scan channel list, ...)
+CHUNK_HDR           = 8
+MIN_CHUNK           = 16
+
+# Object sizes (bytes)
+DL_ENTRY            = 12
+WLAN_SCHED          = 32
+TG_SCHEDULE         = 40
+LTG_PARAMS          = 16
+LTG_STATE           = 28
+LTG_PAYLOAD         = 16
+STATION_ENTRY       = 20
+NETWORK_ENTRY       = 20
+STATION_INFO        = 200
+NETWORK_INFO        = 80
+
+# Memory pools:  name -> (object size, number of objects) - see wlan_mac_pool.h
+POOLS = {
+    'dl_entry'      : (16, 64),
+    'schedule'      : (32, 32),
+    'ltg'           : (40, 16),
+    'ltg_params'    : (32, 40),
+    'ltg_payload'   : (16, 16),
+    'addr_range'    : (16,  8),
+    'station_entry' : (24, 64),
+    'network_entry' : (24, 32),
+}
+
+# Object populations:  (kind, max number of live objects, relative rate of operations)
+#     The maximum numbers are chosen so the live objects always fit in the heap (about
+#     6 kB of chunks at most), ie heap failures are caused by fragmentation
+POPULATIONS = [
+    ('ltg',         8, 2),
+    ('station',    48, 4),
+    ('schedule',   16, 4),
+    ('network',     8, 1),
+    ('ssid',        4, 1),
+    ('wlan_exp',    0, 2),
+]
+
+CHECKPOINTS         = [10000, 100000, 1000000]
+SAMPLE_INTERVAL     = 100
+
+
+#-----------------------------------------------------------------------------
+# Allocator models
+#-----------------------------------------------------------------------------
+class Heap(object):
+    """First-fit heap with coalescing (wlan_mac_high_malloc / wlan_mac_high_free)."""
+    def __init__(self, size):
+        self.free_addrs = [0]             # Start addresses of the free chunks (sorted)
+        self.free_sizes = [size]
+        self.used       = {}              # Address -> chunk size
+        self.num_failed = 0
+        self.max_used   = 0
+        self.used_bytes = 0
+
+    def malloc(self, size):
+        chunk = max(MIN_CHUNK, (size + CHUNK_HDR + 7) & ~7)
+
+        for (idx, free_size) in enumerate(self.free_sizes):
+            if free_size >= chunk:
+                addr = self.free_addrs[idx]
+
+                if (free_size - chunk) >= MIN_CHUNK:
+                    self.free_addrs[idx] += chunk
+                    self.free_sizes[idx] -= chunk
+                else:
+                    chunk = free_size
+                    del self.free_addrs[idx]
+                    del self.free_sizes[idx]
+
+                self.used[addr]  = chunk
+                self.used_bytes += chunk
+                self.max_used    = max(self.max_used, self.used_bytes)
+                return ('heap', addr)
+
+        self.num_failed += 1
+        return None
+
+    def free(self, addr):
+        size             = self.used.pop(addr)
+        self.used_bytes -= size
+        idx              = bisect.bisect_left(self.free_addrs, addr)
+
+        # Coalesce with the next chunk
+        if (idx < len(self.free_addrs)) and (self.free_addrs[idx] == (addr + size)):
+            size += self.free_sizes[idx]
+            del self.free_addrs[idx]
+            del self.free_sizes[idx]
+
+        # Coalesce with the previous chunk
+        if (idx > 0) and ((self.free_addrs[idx - 1] + self.free_sizes[idx - 1]) == addr):
+            self.free_sizes[idx - 1] += size
+        else:
+            self.free_addrs.insert(idx, addr)
+            self.free_sizes.insert(idx, size)
+
+    def fragmentation(self):
+        total = sum(self.free_sizes)
+        if total == 0:
+            return 0.0
+        return 1.0 - float(max(self.free_sizes)) / total
+
+# End class()
+
+
+class Allocator(object):
+    """Allocations of CPU High with or without memory pools."""
+    def __init__(self, use_pools):
+        self.heap      = Heap(HEAP_SIZE)
+        self.use_pools = use_pools
+        self.pool_free = dict((name, num) for (name, (_, num)) in POOLS.items())
+        self.fallback  = 0
+
+        self.heap.malloc(HEAP_RESERVED - CHUNK_HDR)
+
+    def alloc(self, size, pool=None):
+        if self.use_pools and pool:
+            if self.pool_free[pool]:
+                self.pool_free[pool] -= 1
+                return ('pool', pool)
+            self.fallback += 1
+        return self.heap.malloc(size)
+
+    def free(self, obj):
+        if obj is None:
+            return
+        if obj[0] == 'pool':
+            self.pool_free[obj[1]] += 1
+        else:
+            self.heap.free(obj[1])
+
+    def temp(self, size):
+        """Allocate and free a wlan_exp command temporary."""
+        if self.use_pools:
+            return True                   # Command arena
+        obj = self.heap.malloc(size)
+        self.free(obj)
+        return obj is not None
+
+# End class()
+
+
+#-----------------------------------------------------------------------------
+# Object models
+#-----------------------------------------------------------------------------
+def create(a, kind, rng):
+    """Allocate the objects of one instance of kind (None on failure)."""
+    if kind == 'ltg':
+        temp   = a.alloc(LTG_PARAMS, 'ltg_params')            # ltg_sched_deserialize()
+        objs   = [a.alloc(LTG_PAYLOAD, 'ltg_payload'),
+                  a.alloc(DL_ENTRY,    'dl_entry'),
+                  a.alloc(TG_SCHEDULE, 'ltg'),
+                  a.alloc(LTG_PARAMS,  'ltg_params'),
+                  a.alloc(LTG_STATE,   'ltg_params')]
+        a.free(temp)
+    elif kind == 'station':
+        objs   = [a.alloc(STATION_ENTRY, 'station_entry')]
+    elif kind == 'schedule':
+        objs   = [a.alloc(DL_ENTRY, 'dl_entry'), a.alloc(WLAN_SCHED, 'schedule')]
+    elif kind == 'network':
+        objs   = [a.alloc(NETWORK_ENTRY, 'network_entry') for _ in range(rng.randint(1, 4))]
+    elif kind == 'ssid':
+        objs   = [a.alloc(rng.randint(1, 33))]
+
+    if None in objs:
+        for obj in objs:
+            a.free(obj)
+        return None
+
+    return objs
+
+
+def run(use_pools, num_iter, seed):
+    """Create and destroy objects for num_iter iterations.
+
+    Returns:
+        List of (iteration, mean_frag, max_frag, min_largest_free, heap_failed, pool_fallback)
+        at each checkpoint.  The heap is sampled every SAMPLE_INTERVAL iterations.
+    """
+    rng          = random.Random(seed)
+    a            = Allocator(use_pools)
+    live         = dict((kind, []) for (kind, _, _) in POPULATIONS)
+    max_live     = dict((kind, num) for (kind, num, _) in POPULATIONS)
+    kinds        = []
+    results      = []
+
+    frag_sum     = 0.0
+    frag_max     = 0.0
+    num_samples  = 0
+    min_largest  = HEAP_SIZE
+
+    for (kind, _, weight) in POPULATIONS:
+        kinds += [kind] * weight
+
+    points = [c for c in CHECKPOINTS if c < num_iter] + [num_iter]
+
+    for it in range(1, num_iter + 1):
+        kind = rng.choice(kinds)
+
+        if kind == 'wlan_exp':
+            a.temp(rng.choice([STATION_INFO, NETWORK_INFO]))
+
+        else:
+            objs = live[kind]
+
+            if objs and ((len(objs) >= max_live[kind]) or (rng.random() < 0.5)):
+                # Destroy a random instance
+                idx = rng.randrange(len(objs))
+                for obj in objs[idx]:
+                    a.free(obj)
+                objs[idx] = objs[-1]
+                objs.pop()
+            else:
+                new = create(a, kind, rng)
+                if new is not None:
+                    objs.append(new)
+
+        if (it % SAMPLE_INTERVAL) == 0:
+            frag         = a.heap.fragmentation()
+            frag_sum    += frag
+            frag_max     = max(frag_max, frag)
+            num_samples += 1
+            min_largest  = min(min_largest, max(a.heap.free_sizes or [0]))
+
+        if it == points[0]:
+            points.pop(0)
+            results.append((it, frag_sum / max(num_samples, 1), frag_max, min_largest,
+                            a.heap.num_failed, a.fallback))
+
+    return results
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        num_iter = int(sys.argv[1])
+    else:
+        num_iter = DEFAULT_NUM_ITER
+
+    pool_bytes = sum(size * num for (size, num) in POOLS.values())
+
+    print('Heap: {0} B   Memory pools: {1} B   Command arena: 1024 B'.format(HEAP_SIZE, pool_bytes))
+    print('')
+    print('{0:<14} | {1:>10} | {2:>10} | {3:>10} | {4:>16} | {5:>13} | {6:>13}'.format(
+          'Allocator', 'Iteration', 'Mean frag', 'Max frag', 'Min largest free', 'Heap failures', 'Pool fallback'))
+    print('-' * 106)
+
+    for (name, use_pools) in [('Heap only', False), ('Memory pools', True)]:
+        for (it, mean_frag, max_frag, min_largest, heap_failed, fallback) in run(use_pools, num_iter, SEED):
+            print('{0:<14} | {1:10d} | {2:9.1f}% | {3:9.1f}% | {4:14d} B | {5:13d} | {6:13d}'.format(
+                  name, it, 100.0 * mean_frag, 100.0 * max_frag, min_largest, heap_failed, fallback))
+        print('')
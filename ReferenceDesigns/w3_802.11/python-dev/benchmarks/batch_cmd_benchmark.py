@@ -0,0 +1,211 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Batch Command Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark counts the host / node round trips of a node configuration
+sequence with and without node.batch() (see TransportBatch in
+wlan_exp.transport.cmds).
+
+Hardware Setup:
+    - None.  The node is simulated on the host
+
+Required Script Changes:
+    - None.  The number of commands in the sequence can be passed as a command
+        line argument (default: 100)
+
+Description:
+    The script replaces the Ethernet transport of a WlanExpNode with a
+    simulated transport that answers commands like process_hton_msg() /
+    process_batch_cmd() on the node:  each command returns a status word (the
+    Time command returns the MAC / system time) and a batch stops before a
+    command when fewer than CMD_PARAM_TRANSPORT_BATCH_DEFAULT_RESP_WORDS words
+    (the largest response of these commands; see batch_cmd_max_resp_len())
+    remain in the response.
+
+    The configuration sequence sets the Tx rate and Tx power of all devices
+    and reads the MAC time, i.e. the commands a script sends to each node
+    between trials.  For each transport payload size, the script prints the
+    number of round trips, the host time to build / process the messages and
+    the total time with the modeled link round trip time (RTT_US) and node
+    processing time (NODE_CMD_US per command).
+------------------------------------------------------------------------------
+"""
+import sys
+import time
+import struct
+
+import wlan_exp.cmds as cmds
+import wlan_exp.node as wlan_exp_node
+import wlan_exp.transport.cmds as tp_cmds
+
+from bench_util import timed
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_NUM_CMDS    = 100
+
+PAYLOAD_SIZES       = [1000, 1470, 8960]              # Default, standard MTU, jumbo frames
+RTT_US              = 300                             # Host <-> node round trip (1 Gbps link, host stack)
+NODE_CMD_US         = 10                              # Node processing time per command
+
+BATCH_RESP_WORDS    = 32                              # CMD_PARAM_TRANSPORT_BATCH_DEFAULT_RESP_WORDS
+CMD_HDR_WORDS       = 2                               # sizeof(cmd_resp_hdr) / sizeof(u32)
+
+NODE_TIME_CMD       = cmds.NodeProcTime(cmds.CMD_PARAM_READ, cmds.CMD_PARAM_RSVD_TIME).command
+
+
+#-----------------------------------------------------------------------------
+# Simulated node
+#-----------------------------------------------------------------------------
+class SimTransportHeader(object):
+    def sizeof(self):
+        return 12
+
+# End class()
+
+
+class SimTransport(object):
+    """Transport that answers commands like the node (see wlan_exp_node.c)."""
+    def __init__(self, max_payload):
+        self.hdr          = SimTransportHeader()
+        self.max_payload  = max_payload
+        self.num_requests = 0
+        self.num_cmds     = 0
+        self.reply        = None
+
+    def get_max_payload(self):
+        return self.max_payload
+
+    def send(self, payload, robust=True, pkt_type=None):
+        self.num_requests += 1
+
+        (cmd, length, num_args) = struct.unpack('!I 2H', payload[0:8])
+
+        if (cmd == (tp_cmds._CMD_GROUP_TRANSPORT + tp_cmds.CMDID_TRANSPORT_BATCH)):
+            self.reply = self.process_batch_cmd(payload)
+        else:
+            self.reply = self.process_cmd(cmd)
+
+    def receive(self, timeout=None):
+        reply      = self.reply
+        self.reply = None
+        return reply
+
+    def process_cmd(self, cmd):
+        self.num_cmds += 1
+
+        if (cmd == NODE_TIME_CMD):
+            t    = int(time.time() * 1e6)
+            args = [cmds.CMD_PARAM_SUCCESS, t & 0xFFFFFFFF, t >> 32, t & 0xFFFFFFFF, t >> 32]
+        else:
+            args = [cmds.CMD_PARAM_SUCCESS]
+
+        return struct.pack('!I 2H %dI' % len(args), cmd, 4 * len(args), len(args), *args)
+
+    def process_batch_cmd(self, payload):
+        max_resp_len  = self.max_payload // 4
+        num_cmds      = struct.unpack('!I', payload[8:12])[0]
+        offset        = 12
+        resp_index    = 1
+        records       = b''
+        num_processed = 0
+
+        for _ in range(num_cmds):
+            if (resp_index + CMD_HDR_WORDS + BATCH_RESP_WORDS) > max_resp_len:
+                break
+
+            (cmd, length, _) = struct.unpack('!I 2H', payload[offset:offset + 8])
+            record           = self.process_cmd(cmd)
+
+            records    += record
+            resp_index += len(record) // 4
+            offset     += 8 + length
+            num_processed += 1
+
+        args = struct.pack('!I', num_processed) + records
+
+        return struct.pack('!I 2H', tp_cmds._CMD_GROUP_TRANSPORT + tp_cmds.CMDID_TRANSPORT_BATCH, len(args), len(args) // 4) + args
+
+    def transport_close(self):
+        pass
+
+# End class()
+
+
+def sim_node(max_payload):
+    node                   = wlan_exp_node.WlanExpNode.__new__(wlan_exp_node.WlanExpNode)
+    node.transport         = SimTransport(max_payload)
+    node.transport_tracker = 0
+
+    # Tx power range of the node (sent by the node during initialization)
+    node.max_tx_power_dbm  = 21
+    node.min_tx_power_dbm  = -9
+    return node
+
+
+#-----------------------------------------------------------------------------
+# Configuration sequence
+#-----------------------------------------------------------------------------
+def configure(node, num_cmds):
+    """Sends num_cmds commands; returns the deferred / immediate MAC time."""
+    for i in range(num_cmds - 1):
+        if (i % 2):
+            node.set_tx_rate_data(mcs=(i % 8), phy_mode='HTMF', device_list='ALL')
+        else:
+            node.set_tx_power_data(power=(i % 20), device_list='ALL')
+
+    return node.send_cmd(cmds.NodeProcTime(cmds.CMD_PARAM_READ, cmds.CMD_PARAM_RSVD_TIME))
+
+
+def configure_batch(node, num_cmds):
+    with node.batch():
+        node_time = configure(node, num_cmds)
+    return node_time.value
+
+
+def run(max_payload, num_cmds, batch):
+    node = sim_node(max_payload)
+
+    if batch:
+        (node_time, host_s) = timed(lambda: configure_batch(node, num_cmds))
+    else:
+        (node_time, host_s) = timed(lambda: configure(node, num_cmds))
+
+    mac_time = node_time[0]
+    tp       = node.transport
+
+    if not mac_time:
+        raise Exception("Invalid MAC time")
+
+    return (tp.num_requests, tp.num_cmds, host_s, host_s + (tp.num_requests * RTT_US + tp.num_cmds * NODE_CMD_US) / 1e6)
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        num_cmds = int(sys.argv[1])
+    else:
+        num_cmds = DEFAULT_NUM_CMDS
+
+    print('{0} commands; link RTT {1} us, node {2} us / command\n'.format(num_cmds, RTT_US, NODE_CMD_US))
+    print('{0:>7} | {1:<9} | {2:>11} | {3:>8} | {4:>12} | {5:>13}'.format(
+          'Payload', 'Mode', 'Round trips', 'Commands', 'Host ms', 'Total ms'))
+    print('-' * 75)
+
+    # Warm up (imports, command classes)
+    run(PAYLOAD_SIZES[0], num_cmds, False)
+
+    for max_payload in PAYLOAD_SIZES:
+        for (mode, batch) in [('Serial', False), ('Batch', True)]:
+            (num_requests, num_processed, host_s, total_s) = run(max_payload, num_cmds, batch)
+
+            print('{0:7d} | {1:<9} | {2:11d} | {3:8d} | {4:12.2f} | {5:13.2f}'.format(
+                  max_payload, mode, num_requests, num_processed, host_s * 1e3, total_s * 1e3))
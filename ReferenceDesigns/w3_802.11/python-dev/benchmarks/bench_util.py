@@ -0,0 +1,96 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Benchmark Utilities
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This module holds the helpers that are shared by the benchmarks in this
+directory.
+
+Functions (see below for more information):
+    timed()             -- Run a function and return its result and run time
+    ap_log_generator()  -- Synthetic log generator of the AP corpus
+    ap_log_chunks()     -- Generate the AP corpus one chunk at a time
+    ap_log_data()       -- Generate the AP corpus in memory
+------------------------------------------------------------------------------
+"""
+import time
+
+
+__all__ = ['timed', 'ap_log_generator', 'ap_log_chunks', 'ap_log_data']
+
+
+# Synthetic log of an AP with 16 busy stations; the log benchmarks all time
+# the same corpus so that their results can be compared
+AP_LOG_PARAMS = dict(num_stations=16, traffic='poisson', rate=2000, payload_len=(100, 1500))
+AP_LOG_CHUNK_US = 1000000
+
+
+def timed(func):
+    """Run func() and return ``(result, seconds)``."""
+    start = time.time()
+    ret   = func()
+    return (ret, time.time() - start)
+
+
+
+def ap_log_generator(seed=0, **kwargs):
+    """Return a wlan_exp.log.util_synth.SyntheticLogGenerator for the AP corpus.
+
+    Keyword arguments override the parameters in AP_LOG_PARAMS.
+    """
+    import wlan_exp.log.util_synth as synth_util
+
+    params = dict(AP_LOG_PARAMS, **kwargs)
+    return synth_util.SyntheticLogGenerator(seed=seed, **params)
+
+
+def ap_log_chunks(size=None, num_entries=None, duration_us=None, seed=0, chunk_us=AP_LOG_CHUNK_US, **kwargs):
+    """Generate the AP corpus ``chunk_us`` microseconds of MAC time at a time.
+
+    Yields ``(log_data, raw_log_index)`` tuples until at least ``size`` bytes,
+    ``num_entries`` entries or ``duration_us`` microseconds of log data have
+    been generated (whichever is given).  The concatenation of the chunks is
+    one valid log.  Keyword arguments override the parameters in AP_LOG_PARAMS.
+    """
+    if [size, num_entries, duration_us].count(None) != 2:
+        raise AttributeError("Exactly one of size, num_entries or duration_us must be given")
+
+    log_gen = ap_log_generator(seed=seed, **kwargs)
+    done    = [0, 0, 0]                                  # Bytes, entries, microseconds
+
+    while ((size is None) or (done[0] < size)) and \
+          ((num_entries is None) or (done[1] < num_entries)) and \
+          ((duration_us is None) or (done[2] < duration_us)):
+        (log_data, log_index) = log_gen.gen_log_data(chunk_us, return_index=True)
+
+        done[0] += len(log_data)
+        done[1] += sum(len(v) for v in log_index.values())
+        done[2] += chunk_us
+
+        yield (log_data, log_index)
+
+
+def ap_log_data(size=None, num_entries=None, duration_us=None, seed=0, return_index=False, **kwargs):
+    """Generate the AP corpus in memory (see ap_log_chunks() for the arguments).
+
+    Returns:
+        log_data (bytes):  Binary log data, or ``(log_data, raw_log_index)`` if
+            ``return_index`` is True
+    """
+    import wlan_exp.log.util as log_util
+
+    log_data  = bytearray()
+    log_index = dict()
+
+    for (chunk, chunk_index) in ap_log_chunks(size, num_entries, duration_us, seed=seed, **kwargs):
+        if return_index:
+            log_util.merge_log_indexes(log_index, chunk_index, len(log_data))
+
+        log_data += chunk
+
+    if return_index:
+        return (bytes(log_data), log_index)
+    else:
+        return bytes(log_data)
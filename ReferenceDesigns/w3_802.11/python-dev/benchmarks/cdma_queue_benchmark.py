@@ -0,0 +1,313 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - CDMA Job Queue
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark models the memory copies of CPU High for received and for
+forwarded data frames and compares the copy throughput and the CPU idle time
+of the original blocking CDMA transfers with the CDMA job queue of
+wlan_mac_cdma.c.
+
+Hardware Setup:
+    - None.  CPU High and the CDMA core are modeled on the host
+
+Required Script Changes:
+    - None.  The number of frames per test can be passed as a command line
+        argument (default: 20000)
+
+Description:
+    The code paths are modeled as sequences of CPU work, CDMA copies and
+    waits for the copies:
+        - Rx:  Each frame is received and logged
+            - Rx log entry:   The shorter of the payload and the channel
+                              estimates, the entry fields, then the longer
+                              copy (wlan_mac_high_cdma_submit_transfer())
+            - Rx callback:    Station update, de-duplication, enqueue
+            - Unlock:         wlan_mac_cdma_wait() on the ID of the last
+                              Rx log entry copy before the Rx packet buffer
+                              is unlocked
+        - Forward:  Rx, then the frame is staged for transmission and
+            logged again after the transmission
+            - Tx staging:     Payload to the Tx packet buffer (waits before the
+                              IPC message to CPU Low)
+            - Tx log entries: TX_HIGH payload, TX_LOW payload (waits before
+                              the retry flag is updated)
+
+    Blocking (original):  wlan_mac_high_cdma_start_transfer() waits for the
+                          previous transfer before it starts the next one.
+    Start only:           Every copy uses wlan_mac_high_cdma_start_transfer()
+                          on top of the job queue:  it waits for the queue to
+                          drain, then submits the job.
+    Queue (polled):       The Rx log entry copies are submitted without
+                          blocking and the Rx handler waits on the job ID.
+                          The next job starts when CPU High submits, waits or
+                          polls (main loop) - the CDMA interrupt is not
+                          connected on WARP v3.
+    Queue (interrupt):    As Queue (polled), but the CDMA interrupt starts the
+                          next job as soon as the previous one is finished.
+
+    The CPU and CDMA costs below are estimates for the 160 MHz MicroBlaze and
+    the DRAM / packet buffer path; the relative results matter more than the
+    absolute numbers.
+------------------------------------------------------------------------------
+"""
+import sys
+import collections
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_NUM_FRAMES  = 20000
+
+FRAME_LENGTHS       = [200, 1500]
+FRAME_RATES         = [2000, 5000, None]        # Frames per second (None: back-to-back)
+
+CHAN_EST_LEN        = 256                       # sizeof(rx_frame_info->channel_est)
+
+# CDMA model
+CDMA_BYTES_PER_US   = 400.0
+CDMA_SETUP_US       = 0.5                       # DRAM latency per transfer
+
+# CPU High cost model (microseconds)
+START_US            = 0.6                       # XAxiCdma_SimpleTransfer()
+SUBMIT_US           = 1.0                       # wlan_mac_cdma_submit() (interrupts stopped + ring)
+IRQ_US              = 1.5                       # CDMA interrupt entry / exit + service
+
+MODES               = [
+    ('Blocking (original)', 'blocking'),
+    ('Start only',          'start'),
+    ('Queue (polled)',      'polled'),
+    ('Queue (interrupt)',   'interrupt'),
+]
+
+
+#-----------------------------------------------------------------------------
+# Workload
+#-----------------------------------------------------------------------------
+def rx_ops(length):
+    """Operations of CPU High for one received frame."""
+    return [
+        # Mailbox interrupt + Rx log entry:  shorter copy first
+        ('cpu',       8.0),
+        ('submit',    min(length, CHAN_EST_LEN)),
+        ('cpu',       3.0),
+        ('submit',    max(length, CHAN_EST_LEN)),
+
+        # mpdu_rx_callback():  station update, de-duplication, enqueue
+        ('cpu',      12.0),
+
+        # Rx log copies done before the Rx packet buffer is unlocked
+        ('wait_job',  None),
+        ('cpu',       2.0),
+    ]
+
+
+def forward_ops(length):
+    """Operations of CPU High for one forwarded frame."""
+    return rx_ops(length) + [
+        # Tx staging (wlan_mac_high_mpdu_transmit())
+        ('cpu',       4.0),
+        ('start',     length),
+        ('cpu',       3.0),
+        ('wait',      None),
+        ('cpu',       4.0),
+
+        # Tx done:  TX_HIGH and TX_LOW log entries
+        ('cpu',      10.0),
+        ('start',     length),
+        ('cpu',       3.0),
+        ('start',     length),
+        ('cpu',       4.0),
+        ('wait',      None),
+        ('cpu',       6.0),
+    ]
+
+
+WORKLOADS           = [
+    ('Rx',      rx_ops),
+    ('Forward', forward_ops),
+]
+
+
+#-----------------------------------------------------------------------------
+# CDMA models
+#-----------------------------------------------------------------------------
+class Cdma(object):
+    """CDMA core with the job queue of wlan_mac_cdma.c (or the original blocking API)."""
+    def __init__(self, mode):
+        self.mode        = mode
+        self.jobs        = collections.deque()  # (job ID, size) of the jobs that have not started
+        self.running     = None                 # (job ID, end time) of the running job
+        self.next_id     = 1
+        self.done_id     = 0                    # ID of the last finished job
+        self.last_id     = 0                    # ID of the last submitted job
+        self.stall_us    = 0.0                  # CPU time spent waiting for the CDMA
+        self.irq_us      = 0.0                  # CPU time spent in the CDMA interrupt
+        self.num_bytes   = 0
+
+    @staticmethod
+    def duration(size):
+        return CDMA_SETUP_US + size / CDMA_BYTES_PER_US
+
+    def advance(self, now, chain=False):
+        """Finish the jobs that are done at time now.
+
+        The next job starts at the end of the previous one in interrupt mode (or if
+        chain is set, ie the CPU is polling), otherwise at time now.
+        """
+        while (self.running is not None) and (self.running[1] <= now):
+            (job_id, end)  = self.running
+            self.running   = None
+            self.done_id   = job_id
+
+            if self.mode == 'interrupt':
+                self.irq_us += IRQ_US
+                start        = end + IRQ_US
+            elif chain:
+                start        = end
+            else:
+                start        = now
+
+            if self.jobs:
+                (job_id, size) = self.jobs.popleft()
+                self.running   = (job_id, start + self.duration(size))
+
+    def submit(self, t, size):
+        """Submit a copy at time t without blocking.  Returns the CPU time after the call.
+
+        With the original blocking API, this is wlan_mac_high_cdma_start_transfer().
+        """
+        if self.mode == 'blocking':
+            return self.start(t, size)
+
+        self.num_bytes += size
+        self.last_id    = self.next_id
+        self.next_id   += 1
+
+        self.advance(t)
+        t += SUBMIT_US
+
+        if self.running is None:
+            self.running = (self.last_id, t + self.duration(size))
+        else:
+            self.jobs.append((self.last_id, size))
+        return t
+
+    def start(self, t, size):
+        """wlan_mac_high_cdma_start_transfer() at time t.  Returns the CPU time after the call."""
+        if self.mode == 'blocking':
+            self.num_bytes += size
+            self.last_id    = self.next_id
+            self.next_id   += 1
+
+            if (self.running is not None) and (self.running[1] > t):
+                self.stall_us += self.running[1] - t
+                t              = self.running[1]
+                self.done_id   = self.running[0]
+            t           += START_US
+            self.running = (self.last_id, t + self.duration(size))
+            return t
+
+        return self.submit(self.wait(t), size)
+
+    def wait(self, t, job_id=None):
+        """Wait for job_id (default:  all jobs) at time t.  Returns the CPU time after the wait."""
+        t0 = t
+
+        if job_id is None:
+            job_id = self.last_id
+
+        if self.mode == 'blocking':
+            if (self.running is not None) and (self.running[1] > t):
+                t = self.running[1]
+            self.advance(t)
+        else:
+            self.advance(t)
+            while self.done_id < job_id:
+                t = max(t, self.running[1])
+                self.advance(t, chain=True)
+
+        self.stall_us += t - t0
+        return t
+
+# End class()
+
+
+#-----------------------------------------------------------------------------
+# Simulation
+#-----------------------------------------------------------------------------
+def simulate(mode, ops, rate, num_frames):
+    """Process num_frames frames arriving at rate frames/s.
+
+    Returns:
+        (frames_per_s, copy_mb_per_s, stall_us_per_frame, cpu_idle)
+    """
+    cdma  = Cdma(mode)
+    t     = 0.0
+    work  = 0.0
+
+    for idx in range(num_frames):
+        if rate is not None:
+            arrival = idx * 1e6 / rate
+
+            if arrival > t:
+                # Idle:  the main loop polls the queue
+                cdma.advance(arrival, chain=True)
+                t = arrival
+
+        for (op, arg) in ops:
+            if op == 'cpu':
+                cdma.advance(t)
+                t    += arg
+                work += arg
+                if mode == 'interrupt':
+                    # Interrupts taken while the CPU works delay the work
+                    irq_before = cdma.irq_us
+                    cdma.advance(t)
+                    t += cdma.irq_us - irq_before
+            elif op in ('submit', 'start'):
+                t0    = t
+                s0    = cdma.stall_us
+                t     = getattr(cdma, op)(t, arg)
+                work += (t - t0) - (cdma.stall_us - s0)
+
+                if op == 'submit':
+                    job_id = cdma.last_id
+            elif op == 'wait':
+                t     = cdma.wait(t)
+            elif op == 'wait_job':
+                t     = cdma.wait(t, job_id)
+
+    t = cdma.wait(t)
+
+    busy = work + cdma.stall_us + cdma.irq_us
+
+    return (num_frames / (t / 1e6), cdma.num_bytes / t, cdma.stall_us / num_frames, max(0.0, 1.0 - busy / t))
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        num_frames = int(sys.argv[1])
+    else:
+        num_frames = DEFAULT_NUM_FRAMES
+
+    print('{0:<8} | {1:<20} | {2:>6} | {3:>9} | {4:>9} | {5:>9} | {6:>12} | {7:>8}'.format(
+          'Workload', 'Mode', 'Length', 'Offered/s', 'Frames/s', 'Copy MB/s', 'Stall/frame', 'CPU idle'))
+    print('-' * 102)
+
+    for (workload, gen_ops) in WORKLOADS:
+        for length in FRAME_LENGTHS:
+            for rate in FRAME_RATES:
+                for (name, mode) in MODES:
+                    (fps, mbps, stall, idle) = simulate(mode, gen_ops(length), rate, num_frames)
+
+                    print('{0:<8} | {1:<20} | {2:6d} | {3:>9} | {4:9.0f} | {5:9.1f} | {6:9.2f} us | {7:7.1f}%'.format(
+                          workload, name, length, 'max' if rate is None else str(rate), fps, mbps, stall, 100.0 * idle))
+                print('')
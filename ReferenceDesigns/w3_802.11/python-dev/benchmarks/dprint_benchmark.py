@@ -0,0 +1,162 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Deferred Print
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark models the cost of console messages in time-critical code
+(interrupt handlers, Rx / Tx paths) and compares direct xil_printf() calls
+with the deferred print ring of wlan_mac_dprint.c and with messages that are
+removed at compile time by PRINT_LEVEL.
+
+Hardware Setup:
+    - None.  The UART and the print paths are modeled on the host
+
+Required Script Changes:
+    - None.  The number of messages per burst can be passed as a command line
+        argument (default: 200)
+
+Description:
+    Each test is a burst of messages generated by a time-critical code path
+    at a fixed rate (e.g. an error printed for every received frame).
+
+        Direct:        xil_printf() writes each character to the UART and
+                       blocks whenever the 16 byte Tx FIFO is full.
+        Deferred:      wlan_dprintf() stores the format string and arguments
+                       in the ring.  The main loop prints one message per
+                       wlan_mac_dprint_poll() (the main loop is blocked by the
+                       UART instead of the time-critical code).
+        Compiled out:  The severity of the message is above PRINT_LEVEL.
+
+    The UART runs at 115200 baud (8N1), ie 86.8 us per character.  The CPU
+    costs below are estimates for the 160 MHz MicroBlaze.
+------------------------------------------------------------------------------
+"""
+import sys
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_NUM_MSGS    = 200
+
+UART_CHAR_US        = 10 * 1e6 / 115200             # 8N1
+UART_FIFO_LEN       = 16
+
+FORMAT_US_PER_CHAR  = 0.15                          # xil_printf() formatting + outbyte()
+FORMAT_US           = 2.0                           # xil_printf() call + argument parsing
+RECORD_US           = 1.2                           # wlan_mac_dprint_record() (interrupts stopped + va_arg)
+
+RING_LEN            = 32                            # DPRINT_RING_LEN (holds RING_LEN - 1 messages)
+
+# Messages:  (name, length in characters)
+MESSAGES            = [
+    ('Mailbox error',   48),
+    ('Sniffer Rx',      96),
+]
+
+# Message rates (messages per second)
+MSG_RATES           = [10, 100, 1000, 5000]
+
+MODES               = ['Direct', 'Deferred', 'Compiled out']
+
+
+#-----------------------------------------------------------------------------
+# UART model
+#-----------------------------------------------------------------------------
+class Uart(object):
+    """UART with a Tx FIFO; xil_printf() blocks while the FIFO is full."""
+    def __init__(self):
+        self.done = 0.0                             # Time when the last queued character is sent
+
+    def write(self, t, length):
+        """Write length characters starting at time t.  Returns the time when the call returns."""
+        for _ in range(length):
+            t += FORMAT_US_PER_CHAR
+
+            # Wait for space in the FIFO
+            queued = max(0.0, self.done - t) / UART_CHAR_US
+            if queued >= UART_FIFO_LEN:
+                t = self.done - (UART_FIFO_LEN - 1) * UART_CHAR_US
+
+            self.done = max(self.done, t) + UART_CHAR_US
+        return t
+
+# End class()
+
+
+#-----------------------------------------------------------------------------
+# Simulation
+#-----------------------------------------------------------------------------
+def simulate(mode, length, rate, num_msgs):
+    """Generate num_msgs messages of length characters at rate messages/s.
+
+    Returns:
+        (hot_us_per_msg, max_hot_us, num_printed, num_dropped, print_done_ms)
+    """
+    uart     = Uart()
+    period   = 1e6 / rate
+    hot      = []
+    ring     = []                                   # Times at which the messages were stored
+    dropped  = 0
+    printed  = 0
+    main_t   = 0.0                                  # Time when the main loop is free again
+
+    for idx in range(num_msgs):
+        t = idx * period
+
+        if mode == 'Direct':
+            start = max(t, main_t)                  # The code path is delayed by the previous print
+            end   = uart.write(start + FORMAT_US, length)
+            hot.append(end - t)
+            main_t = end
+            printed += 1
+
+        elif mode == 'Deferred':
+            # Main loop prints the stored messages until time t
+            while ring and (main_t <= t):
+                main_t   = uart.write(max(main_t, ring.pop(0)) + FORMAT_US, length)
+                printed += 1
+
+            hot.append(RECORD_US)
+            if len(ring) >= (RING_LEN - 1):
+                dropped += 1
+            else:
+                ring.append(t)
+
+        else:
+            hot.append(0.0)
+
+    while ring:
+        main_t   = uart.write(max(main_t, ring.pop(0)) + FORMAT_US, length)
+        printed += 1
+
+    if mode == 'Deferred' and dropped:
+        main_t = uart.write(main_t + FORMAT_US, 56)   # Dropped message warning
+
+    return (sum(hot) / num_msgs, max(hot), printed, dropped, max(main_t, uart.done) / 1e3)
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        num_msgs = int(sys.argv[1])
+    else:
+        num_msgs = DEFAULT_NUM_MSGS
+
+    print('{0:<14} | {1:<12} | {2:>6} | {3:>14} | {4:>13} | {5:>7} | {6:>7} | {7:>10}'.format(
+          'Message', 'Mode', 'Msgs/s', 'Hot path / msg', 'Max hot path', 'Printed', 'Dropped', 'UART done'))
+    print('-' * 104)
+
+    for (name, length) in MESSAGES:
+        for rate in MSG_RATES:
+            for mode in MODES:
+                (hot, max_hot, printed, dropped, done_ms) = simulate(mode, length, rate, num_msgs)
+
+                print('{0:<14} | {1:<12} | {2:6d} | {3:11.1f} us | {4:10.1f} us | {5:7d} | {6:7d} | {7:7.1f} ms'.format(
+                      name, mode, rate, hot, max_hot, printed, dropped, done_ms))
+            print('')
@@ -0,0 +1,256 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - IPC Ring Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark models the inter-processor communication (IPC) between CPU High
+and CPU Low on the host and compares the throughput and latency of the
+original word-by-word mailbox FIFO with the shared memory IPC ring of
+wlan_mac_mailbox_util.c.
+
+Hardware Setup:
+    - None.  Both IPC paths are modeled on the host
+
+Required Script Changes:
+    - None.  The number of messages per test can be passed as a command line
+        argument (default: 50000)
+
+Description:
+    A producer thread and a consumer thread stand in for the two CPUs.  The
+    mailbox model passes each word of a message through a bounded FIFO, like
+    XMbox_WriteBlocking() / XMbox_ReadBlocking().  The ring model uses the
+    same single-producer / single-consumer protocol as ipc_ring_t:  the
+    message words are copied into a shared array, the producer publishes the
+    head index and posts a doorbell to the FIFO only if the ring was empty,
+    and messages can be posted in batches that share a single doorbell.
+
+    The payload sizes are typical IPC messages (e.g. a 1 word
+    TX_PKT_BUF_READY, 5 word Tx reports).  The model measures the relative
+    cost of the two protocols; absolute numbers depend on the host.
+------------------------------------------------------------------------------
+"""
+import sys
+import time
+import threading
+
+try:
+    import queue
+except ImportError:
+    import Queue as queue
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_NUM_MSGS    = 50000
+PAYLOAD_SIZES       = [1, 5, 16]      # Payload words per message
+BATCH_SIZES         = [1, 8, 32]      # Messages per ipc_batch_start() / ipc_batch_end()
+
+MBOX_FIFO_DEPTH     = 1024            # Depth of the mailbox FIFO (words)
+RING_NUM_WORDS      = 1016            # IPC_RING_NUM_WORDS
+
+DOORBELL            = 0xFFFF          # IPC_MBOX_MSG_ID(IPC_MBOX_DOORBELL)
+
+
+#-----------------------------------------------------------------------------
+# IPC models
+#-----------------------------------------------------------------------------
+class MailboxFifo(object):
+    """Original protocol:  every word is written to / read from the mailbox FIFO."""
+    def __init__(self):
+        self.fifo = queue.Queue(maxsize=MBOX_FIFO_DEPTH)
+
+    def write_msg(self, msg):
+        for word in msg:
+            self.fifo.put(word)
+
+    def read_msg(self):
+        hdr   = self.fifo.get()
+        words = [hdr]
+
+        for _ in range(hdr & 0xFF):
+            words.append(self.fifo.get())
+
+        return words
+
+# End class()
+
+
+class IpcRing(object):
+    """Shared memory ring with a mailbox doorbell (see ipc_ring_t)."""
+    def __init__(self):
+        self.data          = [0] * RING_NUM_WORDS
+        self.head          = 0
+        self.tail          = 0
+        self.doorbell      = queue.Queue(maxsize=MBOX_FIFO_DEPTH)
+        self.num_doorbells = 0
+        self.batch_depth   = 0
+        self.batch_head    = 0
+
+    def _used(self, head, tail):
+        return (head - tail) % RING_NUM_WORDS
+
+    def _publish(self, new_head):
+        old_head  = self.head
+        if new_head == old_head:
+            return
+
+        self.head = new_head
+
+        if self.tail == old_head:
+            try:
+                self.doorbell.put_nowait(DOORBELL)
+                self.num_doorbells += 1
+            except queue.Full:
+                pass
+
+    def batch_start(self):
+        if self.batch_depth == 0:
+            self.batch_head = self.head
+        self.batch_depth += 1
+
+    def batch_end(self):
+        self.batch_depth -= 1
+        if self.batch_depth == 0:
+            self._publish(self.batch_head)
+
+    def write_msg(self, msg):
+        num_words = len(msg)
+        head      = self.batch_head if self.batch_depth else self.head
+
+        # Wait for space (one word is always left empty)
+        if (RING_NUM_WORDS - 1 - self._used(head, self.tail)) < num_words:
+            self._publish(head)
+            while (RING_NUM_WORDS - 1 - self._used(head, self.tail)) < num_words:
+                time.sleep(0)
+
+        # Copy the message with wrap-around
+        first = min(num_words, RING_NUM_WORDS - head)
+        self.data[head:head + first] = msg[:first]
+        if first < num_words:
+            self.data[0:num_words - first] = msg[first:]
+
+        head = (head + num_words) % RING_NUM_WORDS
+
+        if self.batch_depth:
+            self.batch_head = head
+        else:
+            self._publish(head)
+
+    def read_msg(self):
+        while True:
+            # Discard doorbells
+            try:
+                while True:
+                    self.doorbell.get_nowait()
+            except queue.Empty:
+                pass
+
+            head = self.head
+            tail = self.tail
+
+            if head != tail:
+                break
+
+            # Ring is empty:  wait for the next doorbell (mailbox interrupt)
+            try:
+                self.doorbell.get(timeout=0.01)
+            except queue.Empty:
+                pass
+
+        num_words = 1 + (self.data[tail] & 0xFF)
+        first     = min(num_words, RING_NUM_WORDS - tail)
+        words     = self.data[tail:tail + first]
+        if first < num_words:
+            words += self.data[0:num_words - first]
+
+        self.tail = (tail + num_words) % RING_NUM_WORDS
+
+        return words
+
+# End class()
+
+
+#-----------------------------------------------------------------------------
+# Benchmark
+#-----------------------------------------------------------------------------
+def run_test(ipc, num_msgs, payload_words, batch_size=1):
+    """Send num_msgs messages from a producer thread to a consumer thread.
+
+    Returns:
+        (msgs_per_sec, mean_latency_us, max_latency_us)
+    """
+    msg        = [payload_words] + list(range(payload_words))
+    post_times = [0.0] * num_msgs
+    latencies  = [0.0] * num_msgs
+
+    def producer():
+        idx     = 0
+        batched = hasattr(ipc, 'batch_start') and (batch_size > 1)
+
+        while idx < num_msgs:
+            num = min(batch_size, num_msgs - idx)
+
+            if batched:
+                ipc.batch_start()
+
+            for i in range(idx, idx + num):
+                post_times[i] = time.time()
+                ipc.write_msg(msg)
+
+            if batched:
+                ipc.batch_end()
+
+            idx += num
+
+    def consumer():
+        for i in range(num_msgs):
+            ipc.read_msg()
+            latencies[i] = time.time() - post_times[i]
+
+    start    = time.time()
+
+    threads  = [threading.Thread(target=producer), threading.Thread(target=consumer)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    elapsed  = time.time() - start
+
+    return (num_msgs / elapsed, 1e6 * sum(latencies) / num_msgs, 1e6 * max(latencies))
+
+# End def
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        num_msgs = int(sys.argv[1])
+    else:
+        num_msgs = DEFAULT_NUM_MSGS
+
+    print('{0:<26} | {1:>7} | {2:>12} | {3:>8} | {4:>13} | {5:>12}'.format(
+          'IPC', 'Payload', 'Msgs / s', 'Speedup', 'Mean lat (us)', 'Max lat (us)'))
+    print('-' * 94)
+
+    for payload_words in PAYLOAD_SIZES:
+        (base_rate, base_mean, base_max) = run_test(MailboxFifo(), num_msgs, payload_words)
+
+        print('{0:<26} | {1:7d} | {2:12.0f} | {3:7.2f}x | {4:13.1f} | {5:12.1f}'.format(
+              'Mailbox (word-by-word)', payload_words, base_rate, 1.0, base_mean, base_max))
+
+        for batch_size in BATCH_SIZES:
+            ring = IpcRing()
+            (rate, mean, max_lat) = run_test(ring, num_msgs, payload_words, batch_size)
+
+            print('{0:<26} | {1:7d} | {2:12.0f} | {3:7.2f}x | {4:13.1f} | {5:12.1f}'.format(
+                  'Ring (batch {0:2d}, {1:4.0f}% db)'.format(batch_size, 100.0 * ring.num_doorbells / num_msgs),
+                  payload_words, rate, rate / base_rate, mean, max_lat))
+
+        print('')
@@ -0,0 +1,238 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Log Capture Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark compares the sustained capture rate of the log capture service
+(wlan_exp.log.util_capture.LogCaptureService) with the serial read / write
+loop of the previous log_capture_continuous.py example, using a simulated
+node (loopback).
+
+Hardware Setup:
+    - None.  The node is simulated on the host
+
+Required Script Changes:
+    - None.  The rate the node's log fills (in MB/s) can be passed as a
+        command line argument (default: 60 MB/s)
+
+Description:
+    The simulated node fills a log of LOG_CAPACITY bytes at FILL_RATE with
+    synthetic log data (wlan_exp.log.util_synth).  log_get_all_new() returns
+    all new data except the tail pad and takes len / LINK_RATE seconds, like
+    a transfer over Ethernet.  Data that is not read before the node's log
+    wraps is lost.
+
+    Each capture runs for RUN_S seconds and writes to:
+
+        Sim disk:    A container that takes len / DISK_RATE seconds per write
+        HDF5:        HDF5LogContainer without compression
+        HDF5 gzip:   HDF5LogContainer with gzip compression
+
+    with:
+
+        Serial:      Read, then write, in one thread.  The next read starts
+                     SERIAL_INTERVAL after the previous one (or right after
+                     the write if that took longer)
+        Service:     LogCaptureService (receive and writer threads)
+
+    The script prints the capture rate (bytes written per second of the
+    run), the bytes lost to log wraps and the largest fill level of the
+    node's log seen by a read.
+------------------------------------------------------------------------------
+"""
+import os
+import sys
+import time
+import threading
+
+import wlan_exp.log.util_hdf as hdf_util
+import wlan_exp.log.util_capture as capture_util
+
+from bench_util import timed, ap_log_data
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+LOGFILE          = 'capture_benchmark.hdf5'
+DEFAULT_FILL     = 60                                 # MB/s
+LOG_CAPACITY     = 2**26                              # Bytes
+LINK_RATE        = 100 * 2**20                        # Bytes/s
+DISK_RATE        = 100 * 2**20                        # Bytes/s
+RUN_S            = 20
+SERIAL_INTERVAL  = 0.1                                # Seconds
+DATA_SIZE        = 2**25                              # Synthetic log data repeated by the node
+
+
+#-----------------------------------------------------------------------------
+# Simulated node and container
+#-----------------------------------------------------------------------------
+class SimNode(object):
+    """Node whose log fills at a fixed rate; reads take len / LINK_RATE seconds."""
+    def __init__(self, log_data, fill_rate):
+        self.log_data   = log_data
+        self.fill_rate  = fill_rate
+        self.start_time = time.time()
+        self.read_ptr   = 0
+        self.bytes_lost = 0
+        self.max_fill   = 0.0
+        self.lock       = threading.Lock()
+
+    def _written(self):
+        return int((time.time() - self.start_time) * self.fill_rate)
+
+    def log_get_size(self):
+        return min(self._written(), LOG_CAPACITY)
+
+    def log_get_capacity(self):
+        return LOG_CAPACITY
+
+    def log_get_all_new(self, log_tail_pad=500, max_req_size=2**23):
+        with self.lock:
+            written = self._written()
+
+            # Data overwritten by the node before it was read
+            if ((written - self.read_ptr) > LOG_CAPACITY):
+                self.bytes_lost += written - LOG_CAPACITY - self.read_ptr
+                self.read_ptr    = written - LOG_CAPACITY
+
+            self.max_fill = max(self.max_fill, float(written - self.read_ptr) / LOG_CAPACITY)
+
+            end  = max(written - log_tail_pad, self.read_ptr)
+            data = self._get_data(self.read_ptr, end)
+
+            self.read_ptr = end
+
+        time.sleep(len(data) / float(LINK_RATE))
+
+        return SimBuffer(data)
+
+    def _get_data(self, start, end):
+        size  = len(self.log_data)
+        parts = []
+
+        while (start < end):
+            offset = start % size
+            length = min(end - start, size - offset)
+            parts.append(self.log_data[offset:offset + length])
+            start += length
+
+        return b''.join(parts)
+
+# End class()
+
+
+class SimBuffer(object):
+    def __init__(self, data):
+        self.data = data
+
+    def get_bytes(self):
+        return self.data
+
+# End class()
+
+
+class SimDiskContainer(object):
+    """Log container that takes len / DISK_RATE seconds per write."""
+    def __init__(self):
+        self.size = 0
+
+    def write_log_data(self, log_data, append=True):
+        time.sleep(len(log_data) / float(DISK_RATE))
+        self.size += len(log_data)
+
+    def close(self):
+        pass
+
+# End class()
+
+
+class HDF5Container(object):
+    def __init__(self, compression):
+        if os.path.isfile(LOGFILE):
+            os.remove(LOGFILE)
+
+        self.h5_file   = hdf_util.hdf5_open_file(LOGFILE)
+        self.container = hdf_util.HDF5LogContainer(self.h5_file, compression=compression)
+
+    def write_log_data(self, log_data, append=True):
+        self.container.write_log_data(log_data, append)
+
+    def close(self):
+        hdf_util.hdf5_close_file(self.h5_file)
+
+# End class()
+
+
+#-----------------------------------------------------------------------------
+# Capture loops
+#-----------------------------------------------------------------------------
+def run_serial(node, container):
+    written   = 0
+    end_time  = time.time() + RUN_S
+
+    while (time.time() < end_time):
+        start = time.time()
+        data  = node.log_get_all_new(log_tail_pad=500).get_bytes()
+
+        if (len(data) > 0):
+            container.write_log_data(data)
+            written += len(data)
+
+        time.sleep(max(0.0, SERIAL_INTERVAL - (time.time() - start)))
+
+    return written
+
+
+def run_service(node, container):
+    service = capture_util.LogCaptureService(node, container, interval=1.0, min_interval=0.05, fill_target=0.25)
+    service.start()
+
+    time.sleep(RUN_S)
+
+    # Stop without the final read, so both captures cover the same run time
+    service.stop(read_remaining=False)
+
+    return service.bytes_written
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        fill_rate = float(sys.argv[1]) * 2**20
+    else:
+        fill_rate = DEFAULT_FILL * 2**20
+
+    log_data = ap_log_data(size=DATA_SIZE)
+
+    containers = [('Sim disk',  SimDiskContainer),
+                  ('HDF5',      lambda: HDF5Container(None)),
+                  ('HDF5 gzip', lambda: HDF5Container('gzip'))]
+
+    print('Node log fills at {0:.0f} MB/s ({1:.0f} MB log); link {2:.0f} MB/s; sim disk {3:.0f} MB/s; {4} s per run\n'.format(
+          fill_rate / 2**20, LOG_CAPACITY / 2**20, LINK_RATE / 2**20, DISK_RATE / 2**20, RUN_S))
+    print('{0:<10} | {1:<8} | {2:>12} | {3:>10} | {4:>14}'.format('Container', 'Capture', 'Rate (MB/s)', 'Lost (MB)', 'Max log fill'))
+    print('-' * 66)
+
+    try:
+        for (name, container_class) in containers:
+            for (mode, func) in [('Serial', run_serial), ('Service', run_service)]:
+                container = container_class()
+                node      = SimNode(log_data, fill_rate)
+                (written, elapsed) = timed(lambda: func(node, container))
+
+                container.close()
+
+                print('{0:<10} | {1:<8} | {2:12.1f} | {3:10.1f} | {4:13.0%}'.format(
+                      name, mode, written / elapsed / 2**20, node.bytes_lost / 2.0**20, node.max_fill))
+
+    finally:
+        if os.path.isfile(LOGFILE):
+            os.remove(LOGFILE)
+
+    print('')
@@ -0,0 +1,250 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Clock Merge Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark measures the accuracy and throughput of the clock-aligned merge
+of several node logs (log_util.calc_clock_model() and
+hdf_util.merge_logs_to_hdf5_columnar()) on synthetic logs with drifting
+clocks.
+
+Hardware Setup:
+    - None.  The log data is generated by wlan_exp.log.util_synth
+
+Required Script Changes:
+    - None.  The number of nodes can be passed as a command line argument
+        (default: 4)
+
+Description:
+    The script generates DURATION_US of synthetic AP log data for each node
+    and writes it to a memory-mapped log container (wlan_exp.log.util_mmap).
+    The MAC clock of each node has a random offset and a random drift of up
+    to +/- DRIFT_PPM.  The host time of every TIME_INFO entry (the sync
+    points written by log_write_time()) is replaced by the true global time
+    of the entry plus a random host delay of up to HOST_DELAY_US.
+
+    For each DRIFT_PPM value, the script prints:
+
+        Accuracy:    Mean and maximum error of the 'global_timestamp' of all
+                     merged entries versus the true global time, for the
+                     fitted clock model and for an offset-only model (first
+                     sync point, no drift) as used by hand-written scripts
+        Throughput:  Entries per second of merge_logs_to_hdf5_columnar()
+                     (gzip and no compression) and of an in-memory merge
+                     (log_data_to_np_arrays() of every node, offset and
+                     concatenate / argsort of every entry type; nothing is
+                     written to disk)
+
+    The script also checks that the merged TIMELINE is ordered by global
+    time and contains every entry of the node logs.
+------------------------------------------------------------------------------
+"""
+import os
+import sys
+import struct
+
+import numpy as np
+
+import wlan_exp.log.util as log_util
+import wlan_exp.log.util_hdf as hdf_util
+import wlan_exp.log.util_mmap as mmap_util
+import wlan_exp.log.util_synth as synth_util
+
+from wlan_exp.log.entry_types import log_entry_types
+
+from bench_util import timed, ap_log_chunks
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+LOGFILE_BASE     = 'clock_merge_benchmark'
+DEFAULT_NODES    = 4
+DURATION_US      = 60 * 1000000
+CHUNK_US         = 1000000
+DRIFT_PPM        = [0, 20, 100]
+MAX_OFFSET_US    = 10 * 1000000                       # Maximum MAC clock offset between nodes
+HOST_DELAY_US    = 500                                # Maximum host timestamp delay of a sync point
+GLOBAL_BASE      = synth_util.HOST_TIME_BASE
+SEED             = 0
+
+
+#-----------------------------------------------------------------------------
+# Synthetic node logs
+#-----------------------------------------------------------------------------
+def true_global(local, clock):
+    """True global time of local MAC timestamps (float64)."""
+    return GLOBAL_BASE + clock['offset'] + np.asarray(local, dtype=np.float64) * (1.0 + clock['ppm'] * 1e-6)
+
+
+def gen_node_log(filename, node, clock, rng):
+    """Write DURATION_US of log data of a node with the given clock to a memory-mapped container."""
+    time_info  = log_entry_types['TIME_INFO']
+    host_ts    = time_info.fields_np_dt.fields['host_timestamp'][1]
+
+    container  = mmap_util.MmapLogContainer(filename, readonly=False)
+    log_index  = dict()
+    data_size  = 0
+
+    # AP corpus with 8 stations at 250 packets/s per node
+    for (log_data, chunk_index) in ap_log_chunks(duration_us=DURATION_US, seed=SEED + node, chunk_us=CHUNK_US, num_stations=8, rate=250):
+        log_data = bytearray(log_data)
+
+        # Host time of the sync points:  true global time + host delay
+        offsets = chunk_index.get(time_info.entry_type_id, [])
+
+        if len(offsets):
+            entries = time_info.generate_numpy_array(bytes(log_data), offsets)
+
+            for (offset, local, old_host) in zip(offsets, entries['timestamp'], entries['host_timestamp']):
+                if (old_host != 0xFFFFFFFFFFFFFFFF):
+                    host = int(round(true_global(local, clock))) + rng.randint(0, HOST_DELAY_US + 1)
+                    struct.pack_into('<Q', log_data, int(offset) + host_ts, host)
+
+        container.write_log_data(bytes(log_data), append=(data_size > 0))
+        log_util.merge_log_indexes(log_index, chunk_index, data_size)
+
+        data_size += len(log_data)
+
+    container.write_log_index(log_index)
+    container.close()
+
+
+#-----------------------------------------------------------------------------
+# Benchmarks
+#-----------------------------------------------------------------------------
+def fit_clock_model(container):
+    """Clock model fitted to all sync points of a node."""
+    log_index = log_util.filter_log_index(container.get_log_index(), include_only=['TIME_INFO'])
+    time_info = log_util.log_data_to_np_arrays(container.get_log_data(), log_index)['TIME_INFO']
+
+    return log_util.calc_clock_model(time_info)
+
+
+def offset_only_model(container):
+    """Clock model from the first sync point of a node, without drift."""
+    ts_index  = container.get_log_ts_index()
+    time_info = log_entry_types['TIME_INFO']
+    entries   = time_info.generate_numpy_array(container.get_log_data(), ts_index[time_info.entry_type_id]['offset'])
+    entries   = entries[entries['host_timestamp'] != 0xFFFFFFFFFFFFFFFF]
+
+    return {'local' : int(entries['timestamp'][0]), 'global' : int(entries['host_timestamp'][0]), 'drift' : 1.0}
+
+
+def merge_in_memory(containers, clock_models):
+    """Decode all entries of every node and sort each entry type by global time."""
+    merged = {}
+
+    for (node, container) in containers.items():
+        log_index = log_util.filter_log_index(container.get_log_index())
+        log_np    = log_util.log_data_to_np_arrays(container.get_log_data(), log_index)
+
+        for (k, v) in log_np.items():
+            if len(v) and ('timestamp' in v.dtype.names):
+                merged.setdefault(k, []).append(log_util.apply_clock_model(v['timestamp'], clock_models[node]))
+
+    for (k, parts) in merged.items():
+        gts       = np.concatenate(parts)
+        merged[k] = gts[np.argsort(gts, kind='mergesort')]
+
+    return sum(len(v) for v in merged.values())
+
+
+def check_merged(filename, clocks, clock_models, num_entries):
+    """Returns the mean and maximum error (us) of the merged and the offset-only timestamps."""
+    h5_file   = hdf_util.hdf5_open_file(filename, readonly=True)
+    container = hdf_util.HDF5ColumnarLogContainer(h5_file)
+    nodes     = sorted(clocks.keys())
+
+    timeline  = container.get_column('TIMELINE', 'global_timestamp')
+
+    if (len(timeline) != num_entries) or np.any(np.diff(timeline) < 0):
+        raise Exception("Merged TIMELINE is not ordered or is missing entries")
+
+    err_fit = []
+    err_off = []
+
+    for entry_type in container.get_entry_types():
+        if (entry_type == 'TIMELINE'):
+            continue
+
+        node_col  = container.get_column(entry_type, 'node')
+        local     = container.get_column(entry_type, 'timestamp')
+        gts       = container.get_column(entry_type, 'global_timestamp')
+
+        for (n, node) in enumerate(nodes):
+            sel   = (node_col == n)
+            truth = true_global(local[sel], clocks[node])
+
+            err_fit.append(np.abs(gts[sel] - truth))
+            err_off.append(np.abs(log_util.apply_clock_model(local[sel], clock_models[node]) - truth))
+
+    hdf_util.hdf5_close_file(h5_file)
+
+    err_fit = np.concatenate(err_fit)
+    err_off = np.concatenate(err_off)
+
+    return (err_fit.mean(), err_fit.max(), err_off.mean(), err_off.max())
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        num_nodes = int(sys.argv[1])
+    else:
+        num_nodes = DEFAULT_NODES
+
+    node_files = ['{0}_{1}.bin'.format(LOGFILE_BASE, n) for n in range(num_nodes)]
+    merge_file = LOGFILE_BASE + '.hdf5'
+
+    print('{0} nodes, {1} s of log data per node, sync point host delay up to {2} us\n'.format(
+          num_nodes, DURATION_US // 1000000, HOST_DELAY_US))
+    print('{0:>7} | {1:>9} | {2:>17} | {3:>17} | {4:>12} | {5:>12} | {6:>12}'.format(
+          'Drift', 'Entries', 'Fit err mean/max', 'Offset err m/max', 'gzip ent/s', 'None ent/s', 'Memory ent/s'))
+    print('-' * 103)
+
+    try:
+        for drift_ppm in DRIFT_PPM:
+            rng    = np.random.RandomState(SEED)
+            clocks = dict((n, {'offset' : int(rng.randint(0, MAX_OFFSET_US)),
+                               'ppm'    : float(rng.uniform(-drift_ppm, drift_ppm))}) for n in range(num_nodes))
+
+            for n in range(num_nodes):
+                gen_node_log(node_files[n], n, clocks[n], rng)
+
+            containers   = dict((n, mmap_util.MmapLogContainer(node_files[n])) for n in range(num_nodes))
+            num_entries  = sum(sum(len(v) for v in c.get_log_ts_index().values()) for c in containers.values())
+            fit_models   = dict((n, fit_clock_model(c)) for (n, c) in containers.items())
+            off_models   = dict((n, offset_only_model(c)) for (n, c) in containers.items())
+
+            rates = []
+
+            for compression in ['gzip', None]:
+                if os.path.isfile(merge_file):
+                    os.remove(merge_file)
+
+                (_, merge_s) = timed(lambda: hdf_util.merge_logs_to_hdf5_columnar(containers, merge_file, compression=compression))
+                rates.append(num_entries / merge_s)
+
+            (fit_mean, fit_max, off_mean, off_max) = check_merged(merge_file, clocks, off_models, num_entries)
+
+            (_, merge_s) = timed(lambda: merge_in_memory(containers, fit_models))
+            rates.append(num_entries / merge_s)
+
+            for c in containers.values():
+                c.close()
+
+            print('{0:>3} ppm | {1:9d} | {2:7.1f} / {3:7.1f} | {4:7.0f} / {5:7.0f} | {6:12.3g} | {7:12.3g} | {8:12.3g}'.format(
+                  drift_ppm, num_entries, fit_mean, fit_max, off_mean, off_max, rates[0], rates[1], rates[2]))
+
+    finally:
+        for fn in node_files + [f + mmap_util.IDX_FILE_EXT for f in node_files] + [merge_file]:
+            if os.path.isfile(fn):
+                os.remove(fn)
+
+    print('')
@@ -0,0 +1,219 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Collision Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark times the multi-node collision detector
+log_util.find_tx_low_collisions() on synthetic traces of 10 / 50 / 200 nodes
+and compares it with calling find_overlapping_tx_low() for every pair of
+nodes.
+
+Hardware Setup:
+    - None.  The TX_LOW and RX_OFDM entries are random
+
+Required Script Changes:
+    - None.  The numbers of nodes can be passed as command line arguments
+        (default: 10 50 200)
+
+Description:
+    Each node transmits TX_RATE packets per second at random (Poisson) times
+    for DURATION_US, with a random clock offset.  Each transmission is
+    received by RX_PER_TX random other nodes; a reception has a good FCS if
+    the transmission does not overlap any other transmission.  The arrays
+    only contain the fields used by the collision functions, with the same
+    names as the arrays of log_data_to_np_arrays().
+
+    For each number of nodes, the script prints the time of:
+
+        Sweep:     find_tx_low_collisions() of all nodes, with and without
+                   the RX_OFDM entries (capture outcome)
+        Pairwise:  find_overlapping_tx_low() for all N * (N - 1) ordered
+                   pairs of nodes.  Above PAIRWISE_MAX_NODES nodes, only
+                   PAIRWISE_SAMPLE random pairs are run and the time is
+                   scaled to all pairs (marked 'est.')
+
+    Where all pairs are run, the script checks that both methods find the
+    same overlapped transmissions.  find_overlapping_tx_low() drops index 0
+    of each array from its result, so index 0 is ignored by the check.
+------------------------------------------------------------------------------
+"""
+import sys
+import random
+
+import numpy as np
+
+import wlan_exp.util as util
+import wlan_exp.log.util as log_util
+
+from wlan_exp.log.entry_types import log_entry_types
+
+from bench_util import timed
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_NODES      = [10, 50, 200]
+DURATION_US        = 60 * 1000000
+TX_RATE            = 50                               # Packets per second per node
+RX_PER_TX          = 3                                # Receiving nodes per transmission
+MAX_CLOCK_OFFSET   = 1000000                          # Maximum clock offset (us)
+PAIRWISE_MAX_NODES = 10
+PAIRWISE_SAMPLE    = 20
+SEED               = 0
+
+TX_LOW_DT = np.dtype([('timestamp', np.uint64), ('mcs', np.uint8), ('phy_mode', np.uint8),
+                      ('length', np.uint16), ('phy_samp_rate', np.uint8),
+                      ('addr2', np.uint64), ('mac_seq', np.uint16)])
+
+RX_OFDM_DT = np.dtype([('timestamp', np.uint64), ('flags', np.uint16),
+                       ('addr2', np.uint64), ('mac_seq', np.uint16)])
+
+
+#-----------------------------------------------------------------------------
+# Synthetic traces
+#-----------------------------------------------------------------------------
+def gen_traces(num_nodes, rng):
+    """Returns (tx_low, rx, time_offsets) dictionaries keyed by node index."""
+    fcs_good = log_entry_types['RX_OFDM'].consts['flags']['FCS_GOOD']
+
+    tx_low       = {}
+    time_offsets = {}
+
+    for node in range(num_nodes):
+        num_tx = rng.poisson(TX_RATE * DURATION_US / 1e6)
+        offset = int(rng.randint(0, MAX_CLOCK_OFFSET))
+
+        entries = np.zeros(num_tx, dtype=TX_LOW_DT)
+        entries['timestamp']     = np.sort(rng.randint(0, DURATION_US, num_tx)) + offset
+        entries['mcs']           = rng.randint(0, 8, num_tx)
+        entries['phy_mode']      = util.phy_modes['NONHT']
+        entries['length']        = rng.randint(100, 1540, num_tx)
+        entries['phy_samp_rate'] = 20
+        entries['addr2']         = 0x40d855040000 + node
+        entries['mac_seq']       = np.arange(num_tx) & 0xFFF
+
+        tx_low[node]       = entries
+        time_offsets[node] = -offset
+
+    # Transmissions that do not overlap any other transmission are received with a good FCS
+    coll    = log_util.find_tx_low_collisions(tx_low, time_offsets=time_offsets, num_threads=1)['collisions']
+    rx_list = dict((node, []) for node in range(num_nodes))
+
+    for node in range(num_nodes):
+        entries  = tx_low[node]
+        overlap  = np.zeros(len(entries), dtype=bool)
+        overlap[coll['idx_a'][coll['node_a'] == node].astype(np.intp)] = True
+        overlap[coll['idx_b'][coll['node_b'] == node].astype(np.intp)] = True
+
+        for _ in range(RX_PER_TX):
+            rx_node = (node + rng.randint(1, num_nodes, len(entries))) % num_nodes
+
+            for r in np.unique(rx_node):
+                sel = (rx_node == r)
+                rx_entries = np.zeros(int(sel.sum()), dtype=RX_OFDM_DT)
+
+                # Rx timestamp in the clock of the receiving node, a few us after the start of the Tx
+                rx_entries['timestamp'] = (entries['timestamp'][sel].astype(np.int64) - time_offsets[r] +
+                                           time_offsets[node] + rng.randint(0, 10, int(sel.sum())))
+                rx_entries['flags']     = np.where(overlap[sel], 0, fcs_good)
+                rx_entries['addr2']     = entries['addr2'][sel]
+                rx_entries['mac_seq']   = entries['mac_seq'][sel]
+
+                rx_list[r].append(rx_entries)
+
+    rx = {}
+
+    for (node, arrays) in rx_list.items():
+        rx[node] = np.concatenate(arrays) if arrays else np.zeros(0, dtype=RX_OFDM_DT)
+        rx[node] = rx[node][np.argsort(rx[node]['timestamp'], kind='mergesort')]
+
+    return (tx_low, rx, time_offsets)
+
+
+def aligned(entries, offset):
+    """TX_LOW entries with the timestamps in the common time base."""
+    ret_val = entries.copy()
+    ret_val['timestamp'] = (entries['timestamp'].astype(np.int64) + offset).astype(np.uint64)
+    return ret_val
+
+
+#-----------------------------------------------------------------------------
+# Benchmarks
+#-----------------------------------------------------------------------------
+def run_pairwise(tx_low, pairs):
+    """find_overlapping_tx_low() for each pair; returns the overlapped (node, idx) of each source."""
+    overlapped = set()
+
+    for (src, inter) in pairs:
+        (src_idx, _) = log_util.find_overlapping_tx_low(tx_low[src], tx_low[inter])
+        overlapped.update((src, int(i)) for i in src_idx)
+
+    return overlapped
+
+
+def sweep_overlapped(coll):
+    ret_val = set(zip(coll['node_a'].tolist(), coll['idx_a'].tolist()))
+    ret_val.update(zip(coll['node_b'].tolist(), coll['idx_b'].tolist()))
+    return ret_val
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        node_counts = [int(n) for n in sys.argv[1:]]
+    else:
+        node_counts = DEFAULT_NODES
+
+    rng = np.random.RandomState(SEED)
+
+    print('{0} s of traffic, {1} packets per second per node, {2} receivers per packet\n'.format(
+          DURATION_US // 1000000, TX_RATE, RX_PER_TX))
+    print('{0:>5} | {1:>9} | {2:>10} | {3:>8} | {4:>12} | {5:>15} | {6:>14}'.format(
+          'Nodes', 'TX_LOW', 'Collisions', 'Sweep s', 'Sweep + Rx s', 'Pairwise s', 'Speedup'))
+    print('-' * 89)
+
+    # Warm up (imports, lookup tables)
+    (tx_low, rx, offsets) = gen_traces(2, rng)
+    log_util.find_tx_low_collisions(tx_low, rx, offsets, num_threads=1)
+
+    for num_nodes in node_counts:
+        (tx_low, rx, offsets) = gen_traces(num_nodes, rng)
+        num_tx = sum(len(v) for v in tx_low.values())
+
+        (_, sweep_s)       = timed(lambda: log_util.find_tx_low_collisions(tx_low, time_offsets=offsets))
+        (result, sweep_rx) = timed(lambda: log_util.find_tx_low_collisions(tx_low, rx, offsets))
+
+        coll = result['collisions']
+
+        # Pairwise search of the aligned traces
+        tx_aligned = dict((n, aligned(tx_low[n], offsets[n])) for n in tx_low)
+        all_pairs  = [(a, b) for a in range(num_nodes) for b in range(num_nodes) if a != b]
+
+        if (num_nodes <= PAIRWISE_MAX_NODES):
+            pairs = all_pairs
+        else:
+            pairs = random.Random(SEED).sample(all_pairs, PAIRWISE_SAMPLE)
+
+        (overlapped, pair_s) = timed(lambda: run_pairwise(tx_aligned, pairs))
+        pair_s              *= len(all_pairs) / float(len(pairs))
+
+        if (len(pairs) == len(all_pairs)):
+            expected = set(x for x in sweep_overlapped(coll) if x[1] != 0)
+
+            if (overlapped != expected):
+                raise Exception("find_tx_low_collisions() does not match find_overlapping_tx_low()")
+
+            pair_str = '{0:15.2f}'.format(pair_s)
+        else:
+            pair_str = '{0:10.1f} est.'.format(pair_s)
+
+        print('{0:5d} | {1:9d} | {2:10d} | {3:8.3f} | {4:12.3f} | {5} | {6:13.0f}x'.format(
+              num_nodes, num_tx, len(coll), sweep_s, sweep_rx, pair_str, pair_s / sweep_s))
+
+    print('')
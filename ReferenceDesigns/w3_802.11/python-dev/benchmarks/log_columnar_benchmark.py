@@ -0,0 +1,157 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Columnar Log Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark compares the write and column read throughput of the raw HDF5
+log container with the columnar HDF5 log container
+(wlan_exp.log.util_hdf.HDF5ColumnarLogContainer) on synthetic log data.
+
+Hardware Setup:
+    - None.  The log data is generated by wlan_exp.log.util_synth
+
+Required Script Changes:
+    - None.  The amount of log data (in MB) can be passed as a command line
+        argument (default: 200 MB)
+
+Description:
+    This script generates synthetic AP log data in memory and splits it into
+    CHUNK_SIZE pieces that do not end on entry boundaries, like the reads of
+    log_get_all_new() during a capture.  Each container is written by
+    appending the chunks one at a time:
+
+        Raw HDF5:   HDF5LogContainer.write_log_data() (+ write_log_index())
+        Columnar:   HDF5ColumnarLogContainer.append_log_data() with each of
+                    the COMPRESSIONS filters
+
+    The file is then re-opened and the Rx power of all OFDM receptions
+    (RX_OFDM and RX_OFDM_LTG entries) is read:
+
+        Raw HDF5:   hdf5_to_log_data() / hdf5_to_log_index() and
+                    log_data_to_np_arrays() of the Rx entries
+        Columnar:   get_column() of the 'power' field of each entry type
+
+    Write throughput is in MB of raw log data per second; read throughput is
+    in Rx entries per second.  The 'blosc' filter is skipped if the
+    hdf5plugin package is not installed.
+------------------------------------------------------------------------------
+"""
+import os
+import sys
+
+import wlan_exp.log.util as log_util
+import wlan_exp.log.util_hdf as hdf_util
+
+from bench_util import timed, ap_log_data
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+LOGFILE         = 'columnar_benchmark.hdf5'
+DEFAULT_SIZE_MB = 200
+CHUNK_SIZE      = 4 * 2**20 + 123                     # Not a multiple of any entry size
+COMPRESSIONS    = [None, 'lzf', 'gzip', 'blosc']
+RX_TYPES        = ['RX_OFDM', 'RX_OFDM_LTG']
+
+
+#-----------------------------------------------------------------------------
+# Benchmark steps
+#-----------------------------------------------------------------------------
+def write_raw(log_data):
+    h5_file   = hdf_util.hdf5_open_file(LOGFILE)
+    container = hdf_util.HDF5LogContainer(h5_file)
+
+    for start in range(0, len(log_data), CHUNK_SIZE):
+        container.write_log_data(log_data[start:start + CHUNK_SIZE])
+
+    container.write_log_index()
+    hdf_util.hdf5_close_file(h5_file)
+
+
+def read_raw():
+    log_data      = hdf_util.hdf5_to_log_data(filename=LOGFILE)
+    raw_log_index = hdf_util.hdf5_to_log_index(filename=LOGFILE)
+    log_index     = log_util.filter_log_index(raw_log_index, include_only=RX_TYPES)
+    log_np        = log_util.log_data_to_np_arrays(log_data, log_index)
+
+    return sum(len(log_np[t]['power']) for t in log_np)
+
+
+def write_columnar(log_data, compression):
+    h5_file   = hdf_util.hdf5_open_file(LOGFILE)
+    container = hdf_util.HDF5ColumnarLogContainer(h5_file, compression=compression)
+
+    for start in range(0, len(log_data), CHUNK_SIZE):
+        container.append_log_data(log_data[start:start + CHUNK_SIZE])
+
+    hdf_util.hdf5_close_file(h5_file)
+
+
+def read_columnar():
+    h5_file   = hdf_util.hdf5_open_file(LOGFILE, readonly=True)
+    container = hdf_util.HDF5ColumnarLogContainer(h5_file)
+    power     = [container.get_column(t, 'power') for t in RX_TYPES if t in container.get_entry_types()]
+
+    hdf_util.hdf5_close_file(h5_file)
+
+    return sum(len(p) for p in power)
+
+
+def blosc_available():
+    try:
+        import hdf5plugin
+        return True
+    except ImportError:
+        return False
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        size_mb = float(sys.argv[1])
+    else:
+        size_mb = DEFAULT_SIZE_MB
+
+    print("Generating {0:.0f} MB of synthetic log data ...".format(size_mb))
+
+    log_data = ap_log_data(size=int(size_mb * 2**20))
+    data_mb  = len(log_data) / float(2**20)
+
+    tests = [('Raw HDF5', lambda: write_raw(log_data), read_raw)]
+
+    for compression in COMPRESSIONS:
+        if (compression == 'blosc') and not blosc_available():
+            print("Skipping 'blosc':  hdf5plugin is not installed")
+            continue
+
+        tests.append(('Columnar ({0})'.format(compression),
+                      (lambda c: lambda: write_columnar(log_data, c))(compression),
+                      read_columnar))
+
+    print('\nLog data: {0:.1f} MB in {1} chunks\n'.format(data_mb, (len(log_data) + CHUNK_SIZE - 1) // CHUNK_SIZE))
+    print('{0:<20} | {1:>10} | {2:>12} | {3:>12} | {4:>14} | {5:>10}'.format(
+          'Container', 'File MB', 'Write MB/s', 'Read (s)', 'Read entries/s', 'Rx entries'))
+    print('-' * 93)
+
+    try:
+        for (name, write_func, read_func) in tests:
+            if os.path.isfile(LOGFILE):
+                os.remove(LOGFILE)
+
+            (_, write_s)     = timed(write_func)
+            (num_rx, read_s) = timed(read_func)
+
+            print('{0:<20} | {1:10.1f} | {2:12.1f} | {3:12.4f} | {4:14.3g} | {5:10d}'.format(
+                  name, os.path.getsize(LOGFILE) / float(2**20), data_mb / write_s, read_s, num_rx / read_s, num_rx))
+
+    finally:
+        if os.path.isfile(LOGFILE):
+            os.remove(LOGFILE)
+
+    print('')
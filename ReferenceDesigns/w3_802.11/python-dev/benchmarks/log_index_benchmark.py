@@ -0,0 +1,179 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Log Index Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark times filter_log_index() and merge_log_indexes() on a large log
+index with Python list offsets and with numpy int64 array offsets (see
+log_util.log_index_to_np()).
+
+Hardware Setup:
+    - None.  The log index is random
+
+Required Script Changes:
+    - None.  The number of entries (in millions) can be passed as a command
+        line argument (default: 10)
+
+Description:
+    The script builds a raw log index of NUM_ENTRIES entries spread over the
+    Tx / Rx entry types of an AP log (offsets of back-to-back entries with
+    random entry types) and times:
+
+        Filter / merge:   filter_log_index() with the merges of the
+                          log_process_*.py examples (RX_OFDM + RX_OFDM_LTG,
+                          TX_HIGH + TX_HIGH_LTG, TX_LOW + TX_LOW_LTG)
+        Rebase:           merge_log_indexes() of the whole index into an
+                          empty index at a non-zero offset
+        Append chunks:    merge_log_indexes() of NUM_CHUNKS consecutive
+                          chunk indexes, as done while reading a log in
+                          pieces (for example, log_capture_continuous.py)
+
+    Each step is run on the list form and the array form of the index.  The
+    previous merge_log_indexes() (list comprehension per entry type) is also
+    timed for the list form; it stored the rebased list of an existing key as
+    a single element, so it is only timed for the rebase step.  The script
+    checks that the list and array results are equal.
+------------------------------------------------------------------------------
+"""
+import sys
+
+import numpy as np
+
+import wlan_exp.log.util as log_util
+
+from wlan_exp.log.entry_types import log_entry_types
+
+from bench_util import timed
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_ENTRIES_M = 10
+NUM_CHUNKS        = 100
+SEED              = 0
+
+ENTRY_TYPES       = {'RX_OFDM'     : 0.05, 'RX_OFDM_LTG' : 0.40,
+                     'TX_HIGH'     : 0.02, 'TX_HIGH_LTG' : 0.20,
+                     'TX_LOW'      : 0.05, 'TX_LOW_LTG'  : 0.28}
+
+MERGE             = {'RX_OFDM' : ['RX_OFDM', 'RX_OFDM_LTG'],
+                     'TX_HIGH' : ['TX_HIGH', 'TX_HIGH_LTG'],
+                     'TX_LOW'  : ['TX_LOW', 'TX_LOW_LTG']}
+
+
+#-----------------------------------------------------------------------------
+# Previous implementation
+#-----------------------------------------------------------------------------
+def merge_log_indexes_prev(dest_index, src_index, offset):
+    """merge_log_indexes() before the numpy implementation."""
+    return_val = dest_index
+
+    for key in src_index.keys():
+        new_offsets = [x + offset for x in src_index[key]]
+
+        try:
+            return_val[key].append(new_offsets)
+        except KeyError:
+            return_val[key] = new_offsets
+
+    return return_val
+
+
+#-----------------------------------------------------------------------------
+# Benchmark steps
+#-----------------------------------------------------------------------------
+def gen_raw_log_index(num_entries, rng):
+    """Raw log index (numpy form) of back-to-back entries with random types."""
+    names   = list(ENTRY_TYPES.keys())
+    types   = rng.choice(len(names), num_entries, p=[ENTRY_TYPES[n] for n in names])
+    offsets = np.cumsum(rng.randint(60, 1600, num_entries)).astype(np.int64)
+
+    return dict((log_entry_types[n].entry_type_id, offsets[types == i]) for (i, n) in enumerate(names))
+
+
+def split_chunks(raw_index, num_chunks):
+    """Split an index into consecutive chunk indexes with offsets relative to each chunk."""
+    end    = max(int(v[-1]) for v in raw_index.values()) + 1
+    bounds = np.linspace(0, end, num_chunks + 1).astype(np.int64)
+    chunks = []
+
+    for (lo, hi) in zip(bounds[:-1], bounds[1:]):
+        chunk = {}
+
+        for (k, v) in raw_index.items():
+            sel      = v[np.searchsorted(v, lo):np.searchsorted(v, hi)]
+            chunk[k] = sel - lo
+
+        chunks.append((int(lo), chunk))
+
+    return chunks
+
+
+def index_equal(a, b):
+    return (sorted(a.keys()) == sorted(b.keys())) and all(np.array_equal(np.asarray(a[k]), np.asarray(b[k])) for k in a)
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        num_entries = int(float(sys.argv[1]) * 10**6)
+    else:
+        num_entries = DEFAULT_ENTRIES_M * 10**6
+
+    rng       = np.random.RandomState(SEED)
+    np_index  = gen_raw_log_index(num_entries, rng)
+
+    (list_index, conv_s) = timed(lambda: log_util.log_index_to_lists(np_index))
+
+    chunks_np   = split_chunks(np_index, NUM_CHUNKS)
+    chunks_list = [(lo, log_util.log_index_to_lists(c)) for (lo, c) in chunks_np]
+
+    print('{0} entries in {1} entry types; log_index_to_lists() took {2:.2f} s\n'.format(num_entries, len(np_index), conv_s))
+    print('{0:<16} | {1:>14} | {2:>10} | {3:>10} | {4:>9}'.format('Step', 'Previous (s)', 'Lists (s)', 'Arrays (s)', 'Speedup'))
+    print('-' * 71)
+
+    # Filter / merge (the list path is the previous implementation)
+    (res_list, list_s) = timed(lambda: log_util.filter_log_index(list_index, merge=MERGE))
+    (res_np,   np_s)   = timed(lambda: log_util.filter_log_index(np_index, merge=MERGE))
+
+    if not index_equal(res_list, res_np):
+        raise Exception("filter_log_index() results of lists and arrays do not match")
+
+    print('{0:<16} | {1:14.3f} | {2:10.3f} | {3:10.3f} | {4:8.1f}x'.format('Filter / merge', list_s, list_s, np_s, list_s / np_s))
+    del res_list, res_np
+
+    # Rebase the whole index
+    offset = 2**32
+
+    (res_prev, prev_s) = timed(lambda: merge_log_indexes_prev({}, list_index, offset))
+    (res_list, list_s) = timed(lambda: log_util.merge_log_indexes({}, list_index, offset))
+    (res_np,   np_s)   = timed(lambda: log_util.merge_log_indexes({}, np_index, offset))
+
+    if not (index_equal(res_prev, res_np) and index_equal(res_list, res_np)):
+        raise Exception("merge_log_indexes() results do not match")
+
+    print('{0:<16} | {1:14.3f} | {2:10.3f} | {3:10.3f} | {4:8.1f}x'.format('Rebase', prev_s, list_s, np_s, prev_s / np_s))
+    del res_prev, res_list, res_np
+
+    # Append consecutive chunks
+    def append_chunks(chunks):
+        index = {}
+        for (lo, chunk) in chunks:
+            log_util.merge_log_indexes(index, chunk, lo)
+        return index
+
+    (res_list, list_s) = timed(lambda: append_chunks(chunks_list))
+    (res_np,   np_s)   = timed(lambda: append_chunks(chunks_np))
+
+    if not (index_equal(res_list, np_index) and index_equal(res_np, np_index)):
+        raise Exception("merge_log_indexes() of the chunks does not match the index")
+
+    print('{0:<16} | {1:>14} | {2:10.3f} | {3:10.3f} | {4:>9}'.format('Append chunks', 'n/a', list_s, np_s, ''))
+
+    print('')
@@ -0,0 +1,145 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Log Container Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark compares the HDF5 log container with the memory-mapped log
+container (wlan_exp.log.util_mmap) on synthetic log data.
+
+Hardware Setup:
+    - None.  The log data is generated by wlan_exp.log.util_synth
+
+Required Script Changes:
+    - None.  The amount of log data (in MB) can be passed as a command line
+        argument (default: 500 MB)
+
+Description:
+    This script generates an HDF5 log file with synthetic AP log data,
+    converts it to a memory-mapped log container with hdf5_to_mmap() and then,
+    for each container, runs the usual first steps of a log processing script
+    in a new process:
+
+        Open:    Get the log_data and the raw_log_index from the file
+        Decode:  log_data_to_np_arrays() of the RX_OFDM / RX_OFDM_LTG entries
+
+    For each container, the script prints the time of each step and the peak
+    resident set size (RSS) of the process (a new interpreter, so the RSS of
+    the generator is not included).  For the memory-mapped container, the RSS
+    includes the pages of the log file read by the decode step; the operating
+    system can drop these pages under memory pressure.  Both files were just
+    written, so the operating system page cache holds (part of) them; times
+    for a log that is not in the page cache are longer for both containers.
+------------------------------------------------------------------------------
+"""
+import os
+import sys
+import resource
+import multiprocessing
+
+import wlan_exp.log.util as log_util
+import wlan_exp.log.util_hdf as hdf_util
+import wlan_exp.log.util_mmap as mmap_util
+
+from bench_util import timed, ap_log_generator
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+HDF5_LOGFILE    = 'mmap_benchmark.hdf5'
+MMAP_LOGFILE    = 'mmap_benchmark.bin'
+DEFAULT_SIZE_MB = 500
+DECODE_TYPE     = 'RX_OFDM'
+
+
+#-----------------------------------------------------------------------------
+# Benchmark steps (run in a new process for each container)
+#-----------------------------------------------------------------------------
+def open_hdf5(filename):
+    log_data      = hdf_util.hdf5_to_log_data(filename=filename)
+    raw_log_index = hdf_util.hdf5_to_log_index(filename=filename)
+    return (log_data, raw_log_index)
+
+
+def open_mmap(filename):
+    log_data      = mmap_util.mmap_to_log_data(filename)
+    raw_log_index = mmap_util.mmap_to_log_index(filename)
+    return (log_data, raw_log_index)
+
+
+def peak_rss_mb():
+    """Peak RSS of the process in MB."""
+    # On Linux, ru_maxrss is kept across exec(), so it would include the peak
+    # RSS of the parent process; VmHWM is reset for the new process
+    try:
+        with open('/proc/self/status') as status:
+            for line in status:
+                if line.startswith('VmHWM:'):
+                    return int(line.split()[1]) / 1024.0
+    except IOError:
+        pass
+
+    return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss / 1024.0
+
+
+def run_container(open_func, filename, results):
+    rss_start = peak_rss_mb()
+
+    ((log_data, raw_log_index), open_s) = timed(lambda: open_func(filename))
+
+    def decode():
+        log_index = log_util.filter_log_index(raw_log_index, include_only=[DECODE_TYPE],
+                                              merge={DECODE_TYPE : (DECODE_TYPE, DECODE_TYPE + '_LTG')})
+        return log_util.log_data_to_np_arrays(log_data, log_index)
+
+    (log_np, decode_s) = timed(decode)
+
+    results.put((open_s, decode_s, rss_start, peak_rss_mb(), len(log_np[DECODE_TYPE])))
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        size_mb = float(sys.argv[1])
+    else:
+        size_mb = DEFAULT_SIZE_MB
+
+    log_gen = ap_log_generator()
+
+    print("Generating {0:.0f} MB of synthetic log data ...".format(size_mb))
+
+    hdf5_filename = log_gen.gen_log_file(HDF5_LOGFILE, size=int(size_mb * 2**20))
+    mmap_filename = MMAP_LOGFILE
+
+    try:
+        (_, convert_s) = timed(lambda: mmap_util.hdf5_to_mmap(hdf5_filename, mmap_filename, overwrite=True))
+        print("Converted to memory-mapped container in {0:.2f} s\n".format(convert_s))
+
+        print('{0:<8} | {1:>10} | {2:>10} | {3:>12} | {4:>13} | {5:>10}'.format(
+              'Format', 'Open (s)', 'Decode (s)', 'Base RSS MB', 'Peak RSS MB', DECODE_TYPE))
+        print('-' * 77)
+
+        ctx = multiprocessing.get_context('spawn')
+
+        for (name, open_func, filename) in [('HDF5', open_hdf5, hdf5_filename), ('mmap', open_mmap, mmap_filename)]:
+            results = ctx.Queue()
+            proc    = ctx.Process(target=run_container, args=(open_func, filename, results))
+            proc.start()
+
+            (open_s, decode_s, rss_base, rss_peak, num_entries) = results.get()
+            proc.join()
+
+            print('{0:<8} | {1:10.3f} | {2:10.3f} | {3:12.1f} | {4:13.1f} | {5:10d}'.format(
+                  name, open_s, decode_s, rss_base, rss_peak, num_entries))
+
+    finally:
+        for fn in (hdf5_filename, mmap_filename, mmap_filename + mmap_util.IDX_FILE_EXT):
+            if os.path.isfile(fn):
+                os.remove(fn)
+
+    print('')
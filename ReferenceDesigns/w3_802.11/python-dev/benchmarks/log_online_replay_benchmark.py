@@ -0,0 +1,145 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Online Analytics Replay
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark replays a recorded log to the online log analyzer
+(wlan_exp.log.util_online.OnlineLogAnalyzer) at 10x node time and checks
+that the analyzer keeps up.
+
+Hardware Setup:
+    - None.  The log data is generated by wlan_exp.log.util_synth
+
+Required Script Changes:
+    - None.  The node time of the log (in seconds) and the replay speed can be
+        passed as command line arguments (default: 300 s at 10x)
+
+Description:
+    The script generates DURATION_S of synthetic AP log data (LTG traffic to
+    and from NUM_STATIONS stations at STATION_RATE packets per second each,
+    a load the AP can serve, so that TX_LOW entries stay close to the node
+    time of the log) and runs:
+
+        Reference:  A single update() with the whole log
+        Max speed:  replay_log_data() as fast as possible; the node time of
+                    the log divided by the wall clock time is the highest
+                    real time multiple the analyzer can sustain
+        Replay:     replay_log_data() at the given speed, in chunks of
+                    CHUNK_US of node time.  After each chunk, the JSON and
+                    Prometheus exports are read (as a dashboard would)
+
+    For the replay, the script prints the time of each update and export and
+    the lag of each chunk:  the time from when the chunk is released (its node
+    time divided by the speed, from the start of the replay) until its update
+    and exports are done.  The
+    aggregates after the replay must match the reference.
+------------------------------------------------------------------------------
+"""
+import sys
+import time
+
+import numpy as np
+
+import wlan_exp.log.util_online as online_util
+
+from bench_util import timed, ap_log_data
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_DURATION_S = 300
+NUM_STATIONS       = 16
+STATION_RATE       = 100
+DEFAULT_SPEED      = 10.0
+CHUNK_US           = 1000000
+WINDOW_US          = 10000000
+
+
+#-----------------------------------------------------------------------------
+# Benchmark steps
+#-----------------------------------------------------------------------------
+class TimedLogAnalyzer(online_util.OnlineLogAnalyzer):
+    """Online log analyzer that records the wall clock time of each update and export."""
+    def __init__(self, *args, **kwargs):
+        self.update_times = []
+        self.export_done  = []
+        super(TimedLogAnalyzer, self).__init__(*args, **kwargs)
+
+    def update(self, log_data):
+        start   = time.time()
+        ret_val = super(TimedLogAnalyzer, self).update(log_data)
+        self.update_times.append((start, time.time()))
+        return ret_val
+
+
+def read_exports(analyzer):
+    """Callback of replay_log_data():  read the exports as a dashboard would."""
+    analyzer.get_stats_json()
+    analyzer.get_stats_prometheus()
+    analyzer.export_done.append(time.time())
+
+# End class()
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) > 1):
+        duration_s = int(sys.argv[1])
+    else:
+        duration_s = DEFAULT_DURATION_S
+
+    if(len(sys.argv) > 2):
+        speed = float(sys.argv[2])
+    else:
+        speed = DEFAULT_SPEED
+
+    print("Generating {0} s of synthetic log data ...".format(duration_s))
+
+    log_data = ap_log_data(duration_us=duration_s * 1000000, num_stations=NUM_STATIONS, rate=STATION_RATE)
+    data_mb  = len(log_data) / float(2**20)
+
+    # Reference:  whole log at once
+    reference = online_util.OnlineLogAnalyzer(window=WINDOW_US)
+
+    (_, ref_s) = timed(lambda: reference.update(log_data))
+
+    # As fast as possible
+    analyzer = online_util.OnlineLogAnalyzer(window=WINDOW_US)
+    max_s    = online_util.replay_log_data(log_data, analyzer, speed=0, chunk_time=CHUNK_US)
+
+    # Real time replay
+    analyzer = TimedLogAnalyzer(window=WINDOW_US)
+
+    replay_s = online_util.replay_log_data(log_data, analyzer, speed=speed, chunk_time=CHUNK_US, callback=read_exports)
+
+    # Chunk i is released i chunk periods after the first update starts
+    period   = (CHUNK_US / 1e6) / speed
+    starts   = np.array([t[0] for t in analyzer.update_times])
+    update_s = np.array([t[1] - t[0] for t in analyzer.update_times])
+    export_s = np.array(analyzer.export_done) - np.array([t[1] for t in analyzer.update_times])
+    lag_s    = np.array(analyzer.export_done) - (starts[0] + period * np.arange(len(starts)))
+
+    if (analyzer.get_stats_json() != reference.get_stats_json()):
+        raise Exception("Replay aggregates do not match the single update")
+
+    print("Log data: {0:.1f} MB, {1} s of node time ({2:.1f} MB/s of node time)\n".format(data_mb, duration_s, data_mb / duration_s))
+    print('{0:<36} | {1:>12}'.format('Step', 'Result'))
+    print('-' * 51)
+    print('{0:<36} | {1:10.2f} s'.format('Single update()', ref_s))
+    print('{0:<36} | {1:10.2f} s'.format('Replay, max speed', max_s))
+    print('{0:<36} | {1:10.1f} x'.format('Max sustained speed', duration_s / max_s))
+    print('{0:<36} | {1:10.2f} s'.format('Replay at {0:g}x (ideal {1:.1f} s)'.format(speed, duration_s / speed), replay_s))
+    print('{0:<36} | {1:9.1f} ms'.format('Update per chunk, mean', 1e3 * update_s.mean()))
+    print('{0:<36} | {1:9.1f} ms'.format('Update per chunk, max', 1e3 * update_s.max()))
+    print('{0:<36} | {1:9.1f} ms'.format('JSON + Prometheus export, mean', 1e3 * export_s.mean()))
+    print('{0:<36} | {1:9.1f} ms'.format('Chunk lag, mean', 1e3 * lag_s.mean()))
+    print('{0:<36} | {1:9.1f} ms'.format('Chunk lag, max', 1e3 * lag_s.max()))
+    print('{0:<36} | {1:9.1f} ms'.format('Chunk period at {0:g}x'.format(speed), 1e3 * CHUNK_US / 1e6 / speed))
+
+    print('')
@@ -0,0 +1,136 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Parallel Log Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark measures how the multi-process log processing driver
+(wlan_exp.log.util_parallel.process_log()) scales with the number of worker
+processes.
+
+Hardware Setup:
+    - None.  The log data is generated by wlan_exp.log.util_synth
+
+Required Script Changes:
+    - None.  The amount of log data (in MB) can be passed as the first command
+        line argument (default: 500 MB) and the numbers of worker processes
+        as the remaining arguments (default: 1 2 4 8 16 32)
+
+Description:
+    This script writes synthetic AP log data to a raw log data file and runs
+    the Tx statistics (TxStatsReducer) and throughput vs time
+    (ThroughputVsTimeReducer) reducers on it:
+
+        Serial:       Index, filter and decode the whole log in this process,
+                      then run the reducer (the flow of the log_process_*.py
+                      examples before process_log())
+        process_log:  process_log() of the file with each number of worker
+                      processes (4 byte ranges per process)
+
+    The script prints the time and the speedup over the serial flow, and
+    checks that every process_log() result matches the serial result.
+    Numbers of processes above the number of CPUs of the host share the CPUs,
+    so they show the overhead of the driver rather than its scaling.
+------------------------------------------------------------------------------
+"""
+import os
+import sys
+import multiprocessing
+
+import numpy as np
+
+import wlan_exp.log.util as log_util
+import wlan_exp.log.util_parallel as par_util
+
+from bench_util import timed, ap_log_chunks
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+LOGFILE          = 'parallel_benchmark.bin'
+DEFAULT_SIZE_MB  = 500
+DEFAULT_PROCS    = [1, 2, 4, 8, 16, 32]
+
+
+#-----------------------------------------------------------------------------
+# Benchmark steps
+#-----------------------------------------------------------------------------
+def gen_log_file(filename, size):
+    """Write at least size bytes of raw log data to a file."""
+    with open(filename, 'wb') as data_file:
+        for (log_data, _) in ap_log_chunks(size=size):
+            data_file.write(log_data)
+
+
+def run_serial(log_data, reducer):
+    raw_log_index = log_util.gen_raw_log_index(log_data)
+    log_index     = log_util.filter_log_index(raw_log_index, include_only=reducer.include_only, merge=reducer.merge)
+    np_arrays     = log_util.log_data_to_np_arrays(log_data, log_index)
+
+    return reducer.reduce([reducer.map(dict((k.name, v) for k, v in np_arrays.items()))])
+
+
+def results_match(a, b):
+    if isinstance(a, dict):
+        if (sorted(a.keys()) != sorted(b.keys())):
+            return False
+
+        return all(np.array_equal(a[k][0], b[k][0]) and np.allclose(a[k][1], b[k][1]) for k in a)
+
+    if (a.dtype != b.dtype) or (len(a) != len(b)):
+        return False
+
+    return all(np.allclose(a[f], b[f]) for f in a.dtype.names)
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#   Worker processes used by par_util.process_log() may import this script, so
+#   all of the processing must be protected by the __main__ check
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) > 1):
+        size_mb = float(sys.argv[1])
+    else:
+        size_mb = DEFAULT_SIZE_MB
+
+    if(len(sys.argv) > 2):
+        num_procs = [int(n) for n in sys.argv[2:]]
+    else:
+        num_procs = DEFAULT_PROCS
+
+    print("Generating {0:.0f} MB of synthetic log data ...".format(size_mb))
+
+    try:
+        gen_log_file(LOGFILE, int(size_mb * 2**20))
+
+        with open(LOGFILE, 'rb') as data_file:
+            log_data = data_file.read()
+
+        print("Log data: {0:.1f} MB; host has {1} CPUs\n".format(len(log_data) / float(2**20), multiprocessing.cpu_count()))
+        print('{0:<24} | {1:>11} | {2:>10} | {3:>8}'.format('Reducer', 'Processes', 'Time (s)', 'Speedup'))
+        print('-' * 62)
+
+        for reducer in [par_util.TxStatsReducer(), par_util.ThroughputVsTimeReducer()]:
+            name = type(reducer).__name__
+
+            (expected, serial_s) = timed(lambda: run_serial(log_data, reducer))
+
+            print('{0:<24} | {1:>11} | {2:10.2f} | {3:>8}'.format(name, 'serial', serial_s, ''))
+
+            for procs in num_procs:
+                (result, par_s) = timed(lambda: par_util.process_log(LOGFILE, reducer, num_procs=procs))
+
+                if not results_match(expected, result):
+                    raise Exception("process_log() with {0} processes does not match the serial result".format(procs))
+
+                print('{0:<24} | {1:11d} | {2:10.2f} | {3:7.2f}x'.format(name, procs, par_s, serial_s / par_s))
+
+    finally:
+        if os.path.isfile(LOGFILE):
+            os.remove(LOGFILE)
+
+    print('')
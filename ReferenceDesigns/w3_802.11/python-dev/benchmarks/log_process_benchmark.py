@@ -0,0 +1,107 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Log Processing Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark times the log processing utilities on synthetic log data.
+
+Hardware Setup:
+    - None.  The log data is generated by wlan_exp.log.util_synth
+
+Required Script Changes:
+    - None.  The amount of log data (in MB) can be passed as a command line
+        argument (default: 100 MB)
+
+Description:
+    This script generates an HDF5 log file with synthetic AP log data (LTG
+    traffic to and from 16 stations) and times each step of a typical log
+    processing flow:  HDF5 write and read, indexing, filtering, decoding the
+    Tx / Rx entries and the multi-process Tx statistics of the
+    log_process_tx_stats.py example.  The generator is seeded, so runs with
+    the same size process the same log data and can be compared to catch
+    performance regressions.
+------------------------------------------------------------------------------
+"""
+import os
+import sys
+
+import wlan_exp.log.util as log_util
+import wlan_exp.log.util_hdf as hdf_util
+import wlan_exp.log.util_parallel as par_util
+
+from bench_util import timed, ap_log_generator
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+LOGFILE         = 'synthetic_benchmark.hdf5'
+DEFAULT_SIZE_MB = 100
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#   Worker processes used by par_util.process_log() may import this script, so
+#   all of the processing must be protected by the __main__ check
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        size_mb = float(sys.argv[1])
+    else:
+        size_mb = DEFAULT_SIZE_MB
+
+    results = []
+
+    def run_step(name, func):
+        (ret, step_s) = timed(func)
+        results.append((name, step_s))
+        return ret
+
+    # Generate the log file
+    log_gen = ap_log_generator()
+
+    print("Generating {0:.0f} MB of synthetic log data ...".format(size_mb))
+    filename = run_step('Generate HDF5 file', lambda: log_gen.gen_log_file(LOGFILE, size=int(size_mb * 2**20)))
+
+    try:
+        # Read the log data and index from the file
+        log_data      = run_step('HDF5 read log data', lambda: hdf_util.hdf5_to_log_data(filename=filename))
+        raw_log_index = run_step('HDF5 read log index', lambda: hdf_util.hdf5_to_log_index(filename=filename, as_np=True))
+
+        data_mb       = len(log_data) / float(2**20)
+
+        # Index, filter and decode
+        run_step('Index (gen_raw_log_index)', lambda: log_util.gen_raw_log_index(log_data))
+
+        log_index = run_step('Filter / merge log index',
+                             lambda: log_util.filter_log_index(raw_log_index,
+                                                               include_only=['RX_OFDM', 'TX_HIGH', 'TX_LOW'],
+                                                               merge={'RX_OFDM': ('RX_OFDM', 'RX_OFDM_LTG'),
+                                                                      'TX_HIGH': ('TX_HIGH', 'TX_HIGH_LTG'),
+                                                                      'TX_LOW' : ('TX_LOW', 'TX_LOW_LTG')}))
+
+        log_np    = run_step('Decode Tx / Rx entries', lambda: log_util.log_data_to_np_arrays(log_data, log_index))
+
+        # HDF5 write of the log data (compared to the read above)
+        run_step('HDF5 write log data', lambda: hdf_util.log_data_to_hdf5(log_data, LOGFILE + '.copy', gen_index=False, overwrite=True))
+
+        # Example processing
+        run_step('Tx stats (log_process_tx_stats)', lambda: par_util.process_log(log_data, par_util.TxStatsReducer()))
+
+    finally:
+        for fn in (filename, LOGFILE + '.copy'):
+            if os.path.isfile(fn):
+                os.remove(fn)
+
+    # Display the results
+    print('\nLog data: {0:.1f} MB, {1} entries\n'.format(data_mb, sum(len(v) for v in raw_log_index.values())))
+
+    print('{0:<34} | {1:>9} | {2:>9}'.format('Step', 'Time (s)', 'MB / s'))
+
+    for (name, elapsed) in results:
+        print('{0:<34} | {1:9.3f} | {2:9.1f}'.format(name, elapsed, data_mb / max(elapsed, 1e-9)))
+
+    print('')
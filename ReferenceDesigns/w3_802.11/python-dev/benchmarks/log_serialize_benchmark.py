@@ -0,0 +1,321 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Entry Serialize Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark compares the numpy log entry decode / encode methods of
+WlanExpLogEntryType and the numpy log anonymizer (log_anonymize.py) with the
+previous per-entry struct implementations.
+
+Hardware Setup:
+    - None.  The log data is generated by wlan_exp.log.util_synth
+
+Required Script Changes:
+    - None.  The number of entries (in millions) can be passed as a command
+        line argument (default: 1)
+
+Description:
+    The script generates synthetic AP log data and times, on NUM_ENTRIES
+    TX_LOW entries:
+
+        Decode:      The previous deserialize() (struct.unpack and an
+                     OrderedDict per entry), deserialize() and
+                     deserialize_np() / generate_numpy_array()
+        Encode:      The previous serialize() (struct.pack per entry),
+                     serialize() and serialize_np()
+
+    and, on a log file with at least NUM_ENTRIES entries of all types:
+
+        Anonymize:   The previous log_anonymize() (address tuples and a
+                     dict / list of byte indexes per address, one slice
+                     assignment per address and payload) and
+                     log_anonymize.log_anonymize().  Both read the log file
+                     and write the anonymized file; the time of the file
+                     read / write alone is also subtracted from both
+
+    The previous implementations are reproduced below.  The previous
+    serialize() built a str on Python 3; here it builds a bytearray.  The
+    previous overwrite_payloads() failed on Python 3; here it is the same
+    loop with the import fixed.  The script checks that the results of the
+    previous and the new implementations match.
+------------------------------------------------------------------------------
+"""
+import os
+import sys
+import struct
+from collections import OrderedDict
+
+import numpy as np
+
+import wlan_exp.log.util as log_util
+import wlan_exp.log.util_hdf as hdf_util
+
+from wlan_exp.log.entry_types import log_entry_types
+
+from bench_util import timed, ap_log_data
+
+# log_anonymize.py is one of the log examples
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'examples', 'log'))
+
+import log_anonymize
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+LOGFILE            = 'serialize_benchmark.hdf5'
+DEFAULT_ENTRIES_M  = 1
+CHECK_ENTRIES      = 10000
+ENTRY_TYPE         = 'TX_LOW'
+
+
+#-----------------------------------------------------------------------------
+# Previous implementation
+#-----------------------------------------------------------------------------
+def deserialize_prev(entry_type, buf):
+    """WlanExpLogEntryType.deserialize() before the numpy implementation."""
+    ret_val    = []
+    buf_size   = len(buf)
+    entry_size = struct.calcsize(entry_type.fields_fmt_struct)
+    index      = 0
+
+    while (index < buf_size):
+        dataTuple = struct.unpack(entry_type.fields_fmt_struct, buf[index:index+entry_size])
+        all_names = entry_type.get_field_names()
+        all_fmts  = entry_type.get_field_struct_formats()
+
+        # Filter out names for fields ignored during unpacking
+        names = [n for (n,f) in zip(all_names, all_fmts) if 'x' not in f]
+
+        # Use OrderedDict to preserve user-specified field order
+        ret_val.append(OrderedDict(zip(names, dataTuple)))
+
+        index += entry_size
+
+    return ret_val
+
+
+def serialize_prev(entry_type, entries):
+    """WlanExpLogEntryType.serialize() before the numpy implementation."""
+    ret_val = bytearray()
+
+    for entry in entries:
+        tmp_values = []
+
+        for field in entry_type._fields:
+            if 'x' not in field[1]:
+                try:
+                    tmp_values.append(entry[field[0]])
+                except KeyError:
+                    tmp_values.append(0)
+
+        ret_val += struct.pack(entry_type.fields_fmt_struct, *tmp_values)
+
+    return ret_val
+
+
+def overwrite_payloads_prev(log_data, byte_offsets):
+    """log_util.overwrite_payloads() before the numpy implementation."""
+    hdr_size        = 8
+    payload_offsets = {}
+
+    for entry_type_id, entry_type in log_entry_types.items():
+        payload_offsets[entry_type_id] = struct.calcsize(entry_type.fields_fmt_struct)
+
+    for offset in byte_offsets:
+        hdr_b = log_data[offset - hdr_size : offset]
+
+        if( (bytearray(hdr_b[2:4]) != b'\xed\xac') ):
+            raise Exception("ERROR: Offset not a valid entry header (offset {0})!".format(offset))
+
+        entry_type_id = (hdr_b[4] + (hdr_b[5] * 256))
+        entry_size    = (hdr_b[6] + (hdr_b[7] * 256))
+
+        len_offset = payload_offsets[entry_type_id]
+
+        # Write over the log entry payload with zeros
+        if entry_size > len_offset:
+            log_data[offset + len_offset : offset + entry_size] = bytearray([0] * (entry_size - len_offset))
+
+
+def do_replace_addr_prev(addr):
+    """log_anonymize.do_replace_addr() before the numpy implementation."""
+    do_replace = True
+
+    # Don't replace the broadcast address (FF-FF-FF-FF-FF-FF)
+    if(addr == (0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF)):
+        do_replace = False
+
+    # Don't replace multicast IP v4 addresses (01-00-5E-00-00-00 to -7F-FF-FF)
+    if(addr[0:3] == (0x01, 0x00, 0x5E) and (addr[3] <= 0x7F)):
+        do_replace = False
+
+    # Don't replace multicast IP v6 addresses (33-33-xx-xx-xx-xx)
+    if(addr[0:2] == (0x33, 0x33)):
+        do_replace = False
+
+    # Don't replace Mango addresses (40-D8-55-04-2x-xx)
+    if(addr[0:4] == (0x40, 0xD8, 0x55, 0x04) and ((addr[4] & 0x20) == 0x20)):
+        do_replace = False
+
+    return do_replace
+
+
+def log_anonymize_prev(filename, newfilename):
+    """log_anonymize.log_anonymize() before the numpy implementation."""
+    all_addrs    = list()
+    addr_idx_map = dict()
+
+    def addr_to_replace(addr, byte_index):
+        if(do_replace_addr_prev(addr)):
+            if(addr not in all_addrs):
+                all_addrs.append(addr)
+            if addr not in addr_idx_map.keys():
+                addr_idx_map[addr] = [byte_index,]
+            else:
+                addr_idx_map[addr].append(byte_index)
+
+    log_bytes     = bytearray(hdf_util.hdf5_to_log_data(filename=filename))
+    raw_log_index = hdf_util.hdf5_to_log_index(filename=filename)
+    log_attr_dict = hdf_util.hdf5_to_attr_dict(filename=filename)
+
+    log_index     = log_util.filter_log_index(raw_log_index,
+                                              merge={'RX_OFDM': ['RX_OFDM', 'RX_OFDM_LTG'],
+                                                     'TX_HIGH': ['TX_HIGH', 'TX_HIGH_LTG'],
+                                                     'TX_LOW' : ['TX_LOW', 'TX_LOW_LTG']})
+
+    # Step 1: Map of all indexes of each address
+    for (entry_name, entry_type) in log_anonymize.mac_hdr_entry_types:
+        pyld_start = struct.calcsize(''.join(entry_type.get_field_struct_formats()[:-1]))
+
+        for idx in log_index.get(entry_name, []):
+            # 6-byte addresses at offsets 4, 10, 16 in the mac_payload
+            for o in (4, 10, 16):
+                addr_to_replace(tuple(log_bytes[idx+pyld_start+o:idx+pyld_start+o+6]), idx+pyld_start+o)
+
+    # Step 2: Anonymous replacement of each address
+    addr_map = dict()
+    for ii,addr in enumerate(all_addrs):
+        addr_map[addr] = (0xFE, 0xFF, 0xFF, (ii//(256**2)), ((ii//256)%256), (ii%256))
+
+    # Step 3: Replace all addresses
+    for old_addr in addr_idx_map.keys():
+        new_addr = bytearray(addr_map[old_addr])
+        for byte_idx in addr_idx_map[old_addr]:
+            log_bytes[byte_idx:byte_idx+6] = new_addr
+
+    # Step 4: Overwrite all payloads with zeros
+    for key in log_index.keys():
+        overwrite_payloads_prev(log_bytes, log_index[key])
+
+    hdf_util.log_data_to_hdf5(log_bytes, newfilename, attr_dict=log_attr_dict)
+
+
+#-----------------------------------------------------------------------------
+# Benchmark steps
+#-----------------------------------------------------------------------------
+def print_row(step, prev_s, new_s):
+    print('{0:<28} | {1:12.2f} | {2:10.3f} | {3:8.1f}x'.format(step, prev_s, new_s, prev_s / new_s))
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        num_entries = int(float(sys.argv[1]) * 10**6)
+    else:
+        num_entries = DEFAULT_ENTRIES_M * 10**6
+
+    entry_type = log_entry_types[ENTRY_TYPE]
+    anon_file  = LOGFILE.replace('.hdf5', '_anon.hdf5')
+    prev_file  = LOGFILE.replace('.hdf5', '_prev.hdf5')
+    io_file    = LOGFILE.replace('.hdf5', '_io.hdf5')
+
+    print("Generating synthetic log data with {0} entries ...".format(num_entries))
+
+    (log_data, raw_log_index) = ap_log_data(num_entries=num_entries, return_index=True)
+
+    # Entries of ENTRY_TYPE, repeated up to num_entries
+    log_index = log_util.filter_log_index(raw_log_index, include_only=[ENTRY_TYPE])
+    offsets   = np.resize(np.asarray(log_index[ENTRY_TYPE], dtype=np.int64), num_entries)
+    buf       = log_util.read_byte_fields(log_data, offsets, entry_type.fields_np_dt.itemsize).tobytes()
+
+    print("Log data: {0:.1f} MB, {1} entries; {2} {3} entries ({4:.1f} MB)\n".format(
+          len(log_data) / float(2**20), sum(len(v) for v in raw_log_index.values()), num_entries, ENTRY_TYPE, len(buf) / float(2**20)))
+    print('{0:<28} | {1:>12} | {2:>10} | {3:>9}'.format('Step', 'Previous (s)', 'New (s)', 'Speedup'))
+    print('-' * 68)
+
+    # Check the results on the first CHECK_ENTRIES entries
+    check_buf = buf[:CHECK_ENTRIES * entry_type.fields_np_dt.itemsize]
+    check     = entry_type.deserialize(check_buf)
+
+    if ([dict(e) for e in deserialize_prev(entry_type, check_buf)] != [dict(e) for e in check]):
+        raise Exception("deserialize() does not match the previous implementation")
+
+    if (bytes(serialize_prev(entry_type, check)) != entry_type.serialize(check)) or (entry_type.serialize(check) != check_buf):
+        raise Exception("serialize() does not match the previous implementation")
+
+    # Decode
+    (entries, prev_s) = timed(lambda: deserialize_prev(entry_type, buf))
+    del entries
+    (entries, new_s)  = timed(lambda: entry_type.deserialize(buf))
+    print_row('deserialize() to dicts', prev_s, new_s)
+
+    (np_arr, np_s)    = timed(lambda: entry_type.deserialize_np(log_data, offsets))
+    print_row('deserialize_np()', prev_s, np_s)
+
+    (_, gen_s)        = timed(lambda: entry_type.generate_numpy_array(log_data, offsets))
+    print_row('generate_numpy_array()', prev_s, gen_s)
+
+    # Encode
+    (_, prev_s)       = timed(lambda: serialize_prev(entry_type, entries))
+    (_, new_s)        = timed(lambda: entry_type.serialize(entries))
+    print_row('serialize() from dicts', prev_s, new_s)
+    del entries
+
+    out_data          = bytearray(len(buf))
+    out_offsets       = np.arange(num_entries, dtype=np.int64) * entry_type.fields_np_dt.itemsize
+    (_, np_s)         = timed(lambda: entry_type.serialize_np(out_data, out_offsets, np_arr))
+
+    if (bytes(out_data) != buf):
+        raise Exception("serialize_np() does not match the log data")
+
+    print_row('serialize_np()', prev_s, np_s)
+    del np_arr, out_data
+
+    # Anonymize
+    try:
+        hdf_util.log_data_to_hdf5(log_data, LOGFILE)
+
+        (_, prev_s) = timed(lambda: log_anonymize_prev(LOGFILE, prev_file))
+
+        stdout     = sys.stdout
+        sys.stdout = open(os.devnull, 'w')
+
+        try:
+            (_, new_s) = timed(lambda: log_anonymize.log_anonymize(LOGFILE))
+        finally:
+            sys.stdout.close()
+            sys.stdout = stdout
+
+        if (bytes(hdf_util.hdf5_to_log_data(filename=prev_file)) != bytes(hdf_util.hdf5_to_log_data(filename=anon_file))):
+            raise Exception("log_anonymize() does not match the previous implementation")
+
+        print_row('log_anonymize()', prev_s, new_s)
+
+        # File read / write only; both anonymizers include it
+        (_, io_s) = timed(lambda: hdf_util.log_data_to_hdf5(bytearray(hdf_util.hdf5_to_log_data(filename=LOGFILE)), io_file,
+                                                            attr_dict=hdf_util.hdf5_to_attr_dict(filename=LOGFILE)))
+
+        print_row('log_anonymize() without I/O', prev_s - io_s, new_s - io_s)
+
+    finally:
+        for fn in [LOGFILE, anon_file, prev_file, io_file]:
+            if os.path.isfile(fn):
+                os.remove(fn)
+
+    print('')
@@ -0,0 +1,129 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Tx Time Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark times log_util.calc_tx_time() and calc_medium_occupancy() on
+arrays of 1M / 10M / 50M random TX_LOW parameters and compares
+calc_tx_time() with the previous implementation, which built the data bits
+per symbol of each entry with a Python list comprehension.
+
+Hardware Setup:
+    - None.  The TX_LOW parameters are random
+
+Required Script Changes:
+    - None.  The number of entries (in millions) can be passed as command line
+        arguments (default: 1 10 50)
+
+Description:
+    For each array size, the script generates random MCS, PHY mode, length
+    and PHY sample rate arrays and prints the time of:
+
+        calc_tx_time()              Current implementation (lookup tables)
+        Previous calc_tx_time()     List comprehension over every entry; only
+                                    run up to PREV_MAX_ENTRIES entries since the
+                                    Python list of all entries needs several GB
+        calc_medium_occupancy()     Occupancy of each 1 s interval
+
+    The results of the two calc_tx_time() implementations are compared
+    wherever both are run.
+------------------------------------------------------------------------------
+"""
+import sys
+
+import numpy as np
+
+import wlan_exp.util as util
+import wlan_exp.log.util as log_util
+
+from bench_util import timed
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_SIZES_M  = [1, 10, 50]
+PREV_MAX_ENTRIES = 10 * 10**6
+SEED             = 0
+
+
+#-----------------------------------------------------------------------------
+# Previous implementation
+#-----------------------------------------------------------------------------
+def calc_tx_time_prev(mcs, phy_mode, payload_length, phy_samp_rate):
+    """calc_tx_time() before the lookup table implementation."""
+    samp_rate_idx = (phy_samp_rate // 15)
+
+    T_PREAMBLE = np.choose(samp_rate_idx, (8, 16, 32))
+    T_SIG      = np.choose(samp_rate_idx, (2, 4, 8))
+    T_SYM      = np.choose(samp_rate_idx, (2, 4, 8))
+    T_EXT      = np.choose(samp_rate_idx, (6, 6, 6))
+
+    ndbps_lut = {}
+
+    for m in range(0, 8):
+        phy_mode_lut = {}
+
+        for p in util.phy_modes.values():
+            try:
+                phy_mode_lut[p] = util.get_rate_info(m, p, 20)['NDBPS']
+            except:
+                pass
+
+        ndbps_lut[m] = phy_mode_lut
+
+    ndbps = np.array([ndbps_lut[m][p] for i, (m, p) in enumerate(zip(mcs, phy_mode))])
+
+    num_data_syms = np.ceil((16.0 + 6.0 + 8*payload_length) / ndbps)
+    num_ht_preamble_syms = 4 * (phy_mode == util.phy_modes['HTMF'])
+
+    return T_PREAMBLE + T_SIG + (T_SYM * num_ht_preamble_syms) + (T_SYM * num_data_syms) + T_EXT
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        sizes = [int(float(s) * 10**6) for s in sys.argv[1:]]
+    else:
+        sizes = [s * 10**6 for s in DEFAULT_SIZES_M]
+
+    rng = np.random.RandomState(SEED)
+
+    print('{0:>10} | {1:>14} | {2:>14} | {3:>9} | {4:>16}'.format(
+          'Entries', 'calc_tx_time s', 'Previous s', 'Speedup', 'Occupancy s'))
+    print('-' * 75)
+
+    for num_entries in sizes:
+        mcs           = rng.randint(0, 8, num_entries).astype(np.uint8)
+        phy_mode      = rng.choice([util.phy_modes['NONHT'], util.phy_modes['HTMF']], num_entries).astype(np.uint8)
+        length        = rng.randint(14, 1540, num_entries).astype(np.uint16)
+        phy_samp_rate = rng.choice([10, 20, 40], num_entries).astype(np.uint8)
+
+        (tx_time, new_s) = timed(lambda: log_util.calc_tx_time(mcs, phy_mode, length, phy_samp_rate))
+
+        if (num_entries <= PREV_MAX_ENTRIES):
+            (prev, prev_s) = timed(lambda: calc_tx_time_prev(mcs, phy_mode, length, phy_samp_rate))
+
+            if not np.array_equal(prev, tx_time) or (prev.dtype != tx_time.dtype):
+                raise Exception("calc_tx_time() does not match the previous implementation")
+
+            prev_str = '{0:14.3f} | {1:8.0f}x'.format(prev_s, prev_s / new_s)
+            del prev
+        else:
+            prev_str = '{0:>14} | {1:>9}'.format('not run', '')
+
+        # Back-to-back transmissions starting every 1 ms
+        timestamps = np.arange(num_entries, dtype=np.uint64) * np.uint64(1000)
+
+        (_, occ_s) = timed(lambda: log_util.calc_medium_occupancy(timestamps, tx_time.astype(np.uint64)))
+
+        print('{0:10d} | {1:14.3f} | {2} | {3:16.3f}'.format(num_entries, new_s, prev_str, occ_s))
+
+        del mcs, phy_mode, length, phy_samp_rate, tx_time, timestamps
+
+    print('')
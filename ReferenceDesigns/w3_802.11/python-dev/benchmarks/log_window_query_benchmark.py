@@ -0,0 +1,162 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Log Window Query Benchmark
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark times queries for a short time window of a large log with
+LogView.between() and with the full decode / timestamp mask used by the
+log_process_*.py examples.
+
+Hardware Setup:
+    - None.  The log data is generated by wlan_exp.log.util_synth
+
+Required Script Changes:
+    - None.  The amount of log data (in MB) can be passed as a command line
+        argument (default: 2048 MB)
+
+Description:
+    This script writes synthetic AP log data to a memory-mapped log container
+    (wlan_exp.log.util_mmap), so the log does not have to fit in memory, and
+    re-opens it.  It then queries NUM_QUERIES windows of WINDOW_US at random
+    positions in the log for the QUERY_TYPES entries:
+
+        Full decode:  log_data_to_np_arrays() of all QUERY_TYPES entries and
+                      a mask of the 'timestamp' field for each window
+        LogView:      LogView(container).between(t0, t1, types=QUERY_TYPES)
+
+    The full decode is the same for every window, so it is only run once; its
+    time per query is the decode time plus the mean time of the mask.  The
+    first LogView query also reads the timestamp index from the container.
+    The script checks that both methods return the same entries.
+------------------------------------------------------------------------------
+"""
+import os
+import sys
+import random
+
+import numpy as np
+
+import wlan_exp.log.util as log_util
+import wlan_exp.log.util_mmap as mmap_util
+
+from bench_util import timed, ap_log_chunks
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+LOGFILE         = 'window_query_benchmark.bin'
+DEFAULT_SIZE_MB = 2048
+WINDOW_US       = 10000000
+NUM_QUERIES     = 20
+QUERY_TYPES     = ['TX_HIGH_LTG', 'TX_LOW_LTG']
+SEED            = 0
+
+
+#-----------------------------------------------------------------------------
+# Benchmark steps
+#-----------------------------------------------------------------------------
+def gen_log_file(filename, size):
+    """Write at least size bytes of log data to a memory-mapped log container."""
+    container = mmap_util.MmapLogContainer(filename, readonly=False)
+    log_index = dict()
+    data_size = 0
+
+    for (log_data, chunk_index) in ap_log_chunks(size=size, seed=SEED):
+        container.write_log_data(log_data, append=(data_size > 0))
+        log_util.merge_log_indexes(log_index, chunk_index, data_size)
+
+        data_size += len(log_data)
+
+    container.write_log_index(log_index)
+    container.close()
+
+
+def full_decode(container):
+    log_index = log_util.filter_log_index(container.get_log_index(), include_only=QUERY_TYPES)
+    return log_util.log_data_to_np_arrays(container.get_log_data(), log_index)
+
+
+def mask_window(log_np, t0, t1):
+    ret_val = dict()
+
+    for (k, v) in log_np.items():
+        ret_val[k] = v[(v['timestamp'] >= t0) & (v['timestamp'] < t1)]
+
+    return ret_val
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        size_mb = float(sys.argv[1])
+    else:
+        size_mb = DEFAULT_SIZE_MB
+
+    print("Generating {0:.0f} MB of synthetic log data ...".format(size_mb))
+
+    try:
+        gen_log_file(LOGFILE, int(size_mb * 2**20))
+
+        (container, open_s) = timed(lambda: mmap_util.MmapLogContainer(LOGFILE))
+
+        data_mb   = container.get_log_data_size() / float(2**20)
+
+        # Time span of the log
+        ts_index  = container.get_log_ts_index()
+        t_first   = min(int(v['timestamp'][0]) for v in ts_index.values() if len(v))
+        t_last    = max(int(v['timestamp'][-1]) for v in ts_index.values() if len(v))
+
+        rng       = random.Random(SEED)
+        windows   = [(t, t + WINDOW_US) for t in [rng.randint(t_first, t_last - WINDOW_US) for _ in range(NUM_QUERIES)]]
+
+        print("Log data: {0:.1f} MB, {1:.0f} s of MAC time; container opened in {2:.4f} s\n".format(
+              data_mb, (t_last - t_first) / 1e6, open_s))
+
+        # LogView queries (new view so the timestamp index is read by the first query)
+        view        = log_util.LogView(mmap_util.MmapLogContainer(LOGFILE))
+        view_times  = []
+        view_result = []
+
+        for (t0, t1) in windows:
+            (result, query_s) = timed(lambda: view.between(t0, t1, types=QUERY_TYPES))
+            view_result.append(result)
+            view_times.append(query_s)
+
+        # Full decode + mask
+        (log_np, decode_s) = timed(lambda: full_decode(container))
+
+        mask_times = []
+
+        for (idx, (t0, t1)) in enumerate(windows):
+            (result, mask_s) = timed(lambda: mask_window(log_np, t0, t1))
+            mask_times.append(mask_s)
+
+            for t in QUERY_TYPES:
+                if len(result[t]) != len(view_result[idx][t]):
+                    raise Exception("LogView.between() does not match the full decode for {0}".format(t))
+                if len(result[t]) and not np.array_equal(result[t]['timestamp'], view_result[idx][t]['timestamp']):
+                    raise Exception("LogView.between() does not match the full decode for {0}".format(t))
+
+        num_entries = np.mean([sum(len(r[t]) for t in QUERY_TYPES) for r in view_result])
+
+        print('{0} queries of {1:.0f} s ({2:.0f} {3} entries per window on average)\n'.format(
+              NUM_QUERIES, WINDOW_US / 1e6, num_entries, ' / '.join(QUERY_TYPES)))
+        print('{0:<34} | {1:>12}'.format('Method', 'Time (s)'))
+        print('-' * 49)
+        print('{0:<34} | {1:12.3f}'.format('Full decode (once)', decode_s))
+        print('{0:<34} | {1:12.4f}'.format('Full decode + mask, per query', decode_s + np.mean(mask_times)))
+        print('{0:<34} | {1:12.4f}'.format('LogView.between(), first query', view_times[0]))
+        print('{0:<34} | {1:12.4f}'.format('LogView.between(), other queries', np.mean(view_times[1:])))
+
+    finally:
+        for fn in (LOGFILE, LOGFILE + mmap_util.IDX_FILE_EXT):
+            if os.path.isfile(fn):
+                os.remove(fn)
+
+    print('')
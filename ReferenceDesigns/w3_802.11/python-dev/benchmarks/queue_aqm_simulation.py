@@ -0,0 +1,323 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Tx Queue AQM Simulation
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark models a broadcast Tx queue of a node in a congested vehicular
+channel and compares the AQM policies of wlan_mac_queue.c (see
+node.set_queue_aqm()) with the default tail drop.
+
+Hardware Setup:
+    - None.  The Tx queue and the channel are modeled on the host
+
+Required Script Changes:
+    - None.  The random seed can be passed as a command line argument
+        (default: 1)
+
+Description:
+    NUM_SOURCES sources each generate a CAM (cooperative awareness message)
+    every CAM_PERIOD_US into the same broadcast Tx queue (e.g. an RSU that
+    forwards the CAMs of the vehicles in range).  The node transmits one
+    packet at a time; the time to transmit a packet is the channel access
+    time (AIFS + backoff) plus the airtime of the packet, divided by the
+    fraction of time the channel is not busy with other nodes (1 - channel
+    busy ratio, CBR).  During the congested phase, the node can transmit fewer
+    packets than the sources generate.
+
+    The queue policies mirror queue_admit() and dequeue_from_head():
+
+        Tail drop:     A full queue (MAX_TX_QUEUE_LEN packets) rejects new packets
+        Head drop:     A full queue (max_length packets) drops its oldest packet
+        Lifetime:      Packets older than the lifetime are dropped at dequeue
+        CoDel:         RFC 8289 with the default target / interval
+
+    For each policy, the script prints the age (time between enqueue and the
+    end of the transmission) of the delivered packets, the fraction of the
+    airtime of the node that was spent on packets older than CAM_DEADLINE_US
+    (ie useless for the receivers) and the mean age of information, ie the
+    mean age of the newest delivered CAM of each source.
+------------------------------------------------------------------------------
+"""
+import sys
+import math
+import random
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_SEED        = 1
+
+NUM_SOURCES         = 40
+CAM_PERIOD_US       = 100000                        # 10 Hz
+CAM_JITTER_US       = 5000
+CAM_DEADLINE_US     = 100000                        # A CAM is stale after one period
+
+# Channel (802.11p, 10 MHz, 6 Mbps, AC_VO)
+AIRTIME_US          = 440                           # 300 byte CAM + PHY preamble / header
+AIFS_US             = 58
+SLOT_US             = 13
+CW                  = 7
+
+# Phases:  (duration in us, channel busy ratio of the other nodes)
+PHASES              = [(5000000, 0.3), (10000000, 0.9), (5000000, 0.3)]
+
+MAX_TX_QUEUE_LEN    = 150                           # Limit of the MAC applications
+
+CODEL_TARGET_US     = 5000                          # QUEUE_AQM_CODEL_TARGET_USEC_DEFAULT
+CODEL_INTERVAL_US   = 100000                        # QUEUE_AQM_CODEL_INTERVAL_USEC_DEFAULT
+
+# Policies:  (name, dict of node.set_queue_aqm() arguments; times in us)
+POLICIES            = [
+    ('Tail drop',             {}),
+    ('Head drop (150)',       {'head_drop' : True}),
+    ('Head drop (10)',        {'head_drop' : True, 'max_length' : 10}),
+    ('Lifetime 100 ms',       {'lifetime' : 100000}),
+    ('CoDel 5 / 100 ms',      {'codel' : True}),
+]
+
+DROP_REASONS        = ['tail', 'head', 'lifetime', 'codel']
+
+
+#-----------------------------------------------------------------------------
+# Tx queue model
+#-----------------------------------------------------------------------------
+class TxQueue(object):
+    """Tx queue with the AQM policies of wlan_mac_queue.c."""
+    def __init__(self, head_drop=False, max_length=None, lifetime=None, codel=False):
+        self.packets          = []                  # (enqueue time, source, generation time)
+        self.head_drop        = head_drop
+        self.max_length       = max_length
+        self.lifetime         = lifetime
+        self.codel            = codel
+        self.num_dropped      = dict([(reason, 0) for reason in DROP_REASONS])
+
+        # CoDel state
+        self.first_above_time = 0
+        self.drop_next        = 0
+        self.count            = 0
+        self.last_count       = 0
+        self.dropping         = False
+
+    def admit(self, max_length):
+        """queue_admit():  Returns True if a new packet can be enqueued."""
+        if self.max_length:
+            max_length = min(max_length, self.max_length)
+
+        if len(self.packets) < max_length:
+            return True
+
+        if self.head_drop:
+            while self.packets and (len(self.packets) >= max_length):
+                self.drop(self.packets.pop(0), 'head')
+            return True
+
+        self.num_dropped['tail'] += 1
+        return False
+
+    def enqueue(self, t, pkt):
+        self.packets.append((t,) + pkt)
+
+    def drop(self, pkt, reason):
+        self.num_dropped[reason] += 1
+
+    def dequeue(self, t):
+        """dequeue_from_head():  Returns the packet to transmit (or None)."""
+        pkt = self.packets.pop(0) if self.packets else None
+
+        if self.lifetime is not None:
+            while (pkt is not None) and ((t - pkt[0]) > self.lifetime):
+                self.drop(pkt, 'lifetime')
+                pkt = self.packets.pop(0) if self.packets else None
+
+        if self.codel:
+            pkt = self._codel_dequeue(t, pkt)
+
+        return pkt
+
+    def _codel_dequeue(self, t, pkt):
+        ok_to_drop = self._codel_ok_to_drop(t, pkt)
+
+        if self.dropping:
+            if not ok_to_drop:
+                self.dropping = False
+            else:
+                while self.dropping and (t >= self.drop_next):
+                    self.drop(pkt, 'codel')
+                    self.count += 1
+                    pkt = self.packets.pop(0) if self.packets else None
+
+                    if not self._codel_ok_to_drop(t, pkt):
+                        self.dropping = False
+                    else:
+                        self.drop_next = self._codel_control_law(self.drop_next)
+        elif ok_to_drop:
+            self.drop(pkt, 'codel')
+            pkt = self.packets.pop(0) if self.packets else None
+            self._codel_ok_to_drop(t, pkt)
+
+            self.dropping = True
+            delta         = self.count - self.last_count
+
+            if (delta > 1) and ((t < self.drop_next) or ((t - self.drop_next) < 16 * CODEL_INTERVAL_US)):
+                self.count = delta
+            else:
+                self.count = 1
+
+            self.drop_next  = self._codel_control_law(t)
+            self.last_count = self.count
+
+        return pkt
+
+    def _codel_ok_to_drop(self, t, pkt):
+        if pkt is None:
+            self.first_above_time = 0
+            return False
+
+        if ((t - pkt[0]) < CODEL_TARGET_US) or (len(self.packets) == 0):
+            self.first_above_time = 0
+            return False
+
+        if self.first_above_time == 0:
+            self.first_above_time = t + CODEL_INTERVAL_US
+            return False
+
+        return t >= self.first_above_time
+
+    def _codel_control_law(self, t):
+        # Same 8.8 fixed point square root as _queue_codel_control_law()
+        count = min(max(self.count, 1), 0xFFFF)
+        return t + ((CODEL_INTERVAL_US << 8) // int(math.sqrt(count << 16)))
+
+# End class()
+
+
+#-----------------------------------------------------------------------------
+# Simulation
+#-----------------------------------------------------------------------------
+def generate_cams(rng):
+    """Returns the sorted list of (generation time, source) of all CAMs."""
+    duration = sum([d for (d, _) in PHASES])
+    cams     = []
+
+    for source in range(NUM_SOURCES):
+        t = rng.uniform(0, CAM_PERIOD_US)
+        while t < duration:
+            cams.append((t + rng.uniform(-CAM_JITTER_US, CAM_JITTER_US), source))
+            t += CAM_PERIOD_US
+
+    return sorted([c for c in cams if c[0] >= 0])
+
+
+def busy_ratio(t):
+    """Channel busy ratio of the other nodes at time t."""
+    for (duration, cbr) in PHASES:
+        if t < duration:
+            return cbr
+        t -= duration
+    return PHASES[-1][1]
+
+
+def tx_time(rng, t):
+    """Time to transmit one packet starting at time t."""
+    access = AIFS_US + rng.randint(0, CW) * SLOT_US
+
+    # The node defers to the transmissions of the other nodes, so it only
+    # gets (1 - CBR) of the channel
+    return (access + AIRTIME_US) / (1.0 - busy_ratio(t))
+
+
+def simulate(cams, policy, seed):
+    """Simulate the Tx queue for the given CAMs and policy.
+
+    Returns:
+        (ages, airtime_total, airtime_stale, num_dropped, mean_aoi)
+    """
+    rng      = random.Random(seed)
+    queue    = TxQueue(**policy)
+    duration = sum([d for (d, _) in PHASES])
+    ages     = []
+    airtime  = [0.0, 0.0]                           # Total, stale
+    newest   = [None] * NUM_SOURCES                 # Generation time of the newest delivered CAM of each source
+    aoi_sum  = 0.0
+    aoi_num  = 0
+    t        = 0.0                                  # Time when the node is done with the current packet
+    idx      = 0
+
+    while (idx < len(cams)) or queue.packets:
+        # Enqueue all CAMs generated before the node is free
+        while (idx < len(cams)) and (cams[idx][0] <= t):
+            if queue.admit(MAX_TX_QUEUE_LEN):
+                queue.enqueue(cams[idx][0], cams[idx])
+            idx += 1
+
+        pkt = queue.dequeue(t)
+
+        if pkt is None:
+            if idx < len(cams):
+                t = cams[idx][0]
+                continue
+            break
+
+        done = t + tx_time(rng, t)
+        age  = done - pkt[0]
+
+        ages.append(age)
+        airtime[0] += AIRTIME_US
+        if age > CAM_DEADLINE_US:
+            airtime[1] += AIRTIME_US
+
+        source = pkt[2]
+        if (newest[source] is None) or (pkt[1] > newest[source]):
+            newest[source] = pkt[1]
+
+        t = done
+
+        # Sample the age of information after each transmission
+        if t < duration:
+            for gen in newest:
+                if gen is not None:
+                    aoi_sum += (t - gen)
+                    aoi_num += 1
+
+    return (ages, airtime[0], airtime[1], queue.num_dropped, aoi_sum / max(aoi_num, 1))
+
+
+def percentile(values, p):
+    values = sorted(values)
+    if not values:
+        return 0.0
+    return values[min(len(values) - 1, int(math.ceil((p / 100.0) * len(values))) - 1)]
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        seed = int(sys.argv[1])
+    else:
+        seed = DEFAULT_SEED
+
+    cams = generate_cams(random.Random(seed))
+
+    print('{0} CAMs from {1} sources; channel busy ratio {2}'.format(
+          len(cams), NUM_SOURCES, ' / '.join(['{0:.0%} for {1:.0f} s'.format(cbr, d / 1e6) for (d, cbr) in PHASES])))
+    print('')
+    print('{0:<21} | {1:>9} | {2:>7} | {3:>7} | {4:>7} | {5:>7} | {6:>7} | {7:>8} | {8:>8} | {9}'.format(
+          'Policy', 'Delivered', 'p50 ms', 'p90 ms', 'p99 ms', 'Max ms', 'Fresh', 'Stale air', 'Mean AoI', 'Dropped'))
+    print('-' * 132)
+
+    for (name, policy) in POLICIES:
+        (ages, air_total, air_stale, dropped, aoi) = simulate(cams, policy, seed)
+
+        fresh = sum([1 for age in ages if age <= CAM_DEADLINE_US])
+
+        print('{0:<21} | {1:9d} | {2:7.1f} | {3:7.1f} | {4:7.1f} | {5:7.1f} | {6:6.1%} | {7:8.1%} | {8:5.1f} ms | {9}'.format(
+              name, len(ages),
+              percentile(ages, 50) / 1e3, percentile(ages, 90) / 1e3, percentile(ages, 99) / 1e3, max(ages) / 1e3,
+              float(fresh) / len(ages), air_stale / air_total, aoi / 1e3,
+              ' '.join(['{0}={1}'.format(r, dropped[r]) for r in DROP_REASONS if dropped[r]])))
@@ -0,0 +1,190 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Tx Queue Capacity
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark models the Tx queue buffer allocation of CPU High and compares
+the effective queue capacity of fixed 4 KB buffers with the size-classed
+buffers (512 B / 2 KB / 4 KB) for traces of mixed packet sizes.
+
+Hardware Setup:
+    - None.  The allocators are modeled on the host
+
+Required Script Changes:
+    - None.  A log file can be passed as a command line argument to add a
+        trace with the lengths of its TX_HIGH entries
+
+Description:
+    The model uses the memory layout of wlan_mac_queue.c:
+        - 40 kB of AUX BRAM for dl_entry structs (12 bytes each)
+        - 14000 kB of DRAM for the buffers
+        - 48 bytes of tx_queue_buffer_t metadata before each frame
+
+    For each trace, packets are checked out until the first checkout fails,
+    which is the number of packets the node can hold in its Tx queues.  The
+    size-classed allocator uses queue_checkout_len(), ie the smallest class
+    that fits the frame with fallback to the larger classes, except for the
+    NUM_RESERVED_LARGE LARGE buffers that are left for the management frames
+    (queue_checkout()).  Ethernet receptions give the same result through
+    the Ethernet copy-break.
+------------------------------------------------------------------------------
+"""
+import sys
+import random
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+NUM_PACKETS         = 20000           # Length of each synthetic trace
+SEED                = 0
+
+# Memory layout (see wlan_mac_high.h / wlan_mac_queue.h)
+DL_ENTRY_SIZE       = 12
+DL_ENTRY_MEM_SIZE   = 40 * 1024
+BUFFER_MEM_SIZE     = 14000 * 1024
+BUFFER_HDR_SIZE     = 48              # offsetof(tx_queue_buffer_t, frame)
+MAX_PKT_SIZE        = 2048
+NUM_LARGE_BUFFERS   = 256
+NUM_RESERVED_LARGE  = 32              # LARGE buffers queue_checkout_len() leaves for queue_checkout()
+
+# 802.11 overhead of an encapsulated Ethernet payload:  MAC header + LLC header + FCS
+MPDU_OVERHEAD       = 24 + 8 + 4
+
+
+#-----------------------------------------------------------------------------
+# Allocator models
+#-----------------------------------------------------------------------------
+def fixed_pools():
+    """Original allocator:  one pool of 4 KB buffers."""
+    num_bram = DL_ENTRY_MEM_SIZE // DL_ENTRY_SIZE
+    return [(4096, min(num_bram, BUFFER_MEM_SIZE // 4096), 0)]
+
+
+def classed_pools():
+    """Size-classed allocator (same split as queue_init()), smallest class first."""
+    num_bram   = DL_ENTRY_MEM_SIZE // DL_ENTRY_SIZE
+    mem_free   = BUFFER_MEM_SIZE
+
+    num_large  = min(NUM_LARGE_BUFFERS, num_bram, mem_free // 4096)
+    mem_free  -= num_large * 4096
+
+    num_medium = min(num_bram - num_large, mem_free // 2048)
+    mem_free  -= num_medium * 2048
+
+    num_small  = mem_free // (512 + DL_ENTRY_SIZE)
+
+    return [(512, num_small, 0), (2048, num_medium, 0), (4096, num_large, NUM_RESERVED_LARGE)]
+
+
+def fill_queue(pools, lengths):
+    """Check out buffers for the packets of the trace until the first failure.
+
+    Returns:
+        (num_packets, frame_bytes, buffer_bytes):  Number of packets that fit, total frame
+            bytes of these packets and total size of the buffers they use
+    """
+    free         = [num - reserved for (_, num, reserved) in pools]
+    max_lens     = [min(size - BUFFER_HDR_SIZE, MAX_PKT_SIZE) for (size, _, _) in pools]
+    frame_bytes  = 0
+    buffer_bytes = 0
+
+    for (num_packets, length) in enumerate(lengths):
+        for (idx, max_len) in enumerate(max_lens):
+            if (length <= max_len) and free[idx]:
+                free[idx]    -= 1
+                frame_bytes  += length
+                buffer_bytes += pools[idx][0]
+                break
+        else:
+            return (num_packets, frame_bytes, buffer_bytes)
+
+    return (len(lengths), frame_bytes, buffer_bytes)
+
+
+#-----------------------------------------------------------------------------
+# Traces (MPDU lengths in bytes)
+#-----------------------------------------------------------------------------
+def gen_traces(rng):
+    def mix(sizes_weights):
+        (sizes, weights) = zip(*sizes_weights)
+        return [s + MPDU_OVERHEAD for s in weighted_choices(rng, sizes, weights, NUM_PACKETS)]
+
+    traces = []
+    traces.append(('Bulk (1500 B)',            mix([(1500, 1)])))
+    traces.append(('TCP data + ACK (2:1)',     mix([(1500, 2), (52, 1)])))
+    traces.append(('IMIX (64/576/1500 7:4:1)', mix([(64, 7), (576, 4), (1500, 1)])))
+    traces.append(('VoIP (200 B)',             mix([(200, 1)])))
+    traces.append(('Uniform 64 - 1500 B',      [rng.randint(64, 1500) + MPDU_OVERHEAD for _ in range(NUM_PACKETS)]))
+
+    return traces
+
+
+def weighted_choices(rng, values, weights, num):
+    """Pick num values with the given relative weights."""
+    import bisect
+
+    cdf = []
+    acc = 0.0
+
+    for w in weights:
+        acc += w
+        cdf.append(acc)
+
+    return [values[bisect.bisect_left(cdf, rng.random() * acc)] for _ in range(num)]
+
+
+def read_log_trace(filename):
+    """Lengths of the TX_HIGH entries of a log file."""
+    import wlan_exp.log.util as log_util
+    import wlan_exp.log.util_hdf as hdf_util
+
+    log_data      = hdf_util.hdf5_to_log_data(filename=filename)
+    raw_log_index = hdf_util.hdf5_to_log_index(filename=filename)
+    log_index     = log_util.filter_log_index(raw_log_index, include_only=['TX_HIGH'],
+                                              merge={'TX_HIGH': ('TX_HIGH', 'TX_HIGH_LTG')})
+    log_np        = log_util.log_data_to_np_arrays(log_data, log_index)
+
+    return [int(l) for l in log_np['TX_HIGH']['length']]
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+    rng    = random.Random(SEED)
+    traces = gen_traces(rng)
+
+    if (len(sys.argv) > 1):
+        for filename in sys.argv[1:]:
+            lengths = read_log_trace(filename)
+
+            # Repeat the trace so it can fill the queue
+            if lengths:
+                lengths = (lengths * (NUM_PACKETS // len(lengths) + 1))[:NUM_PACKETS]
+                traces.append(('Log: {0}'.format(filename), lengths))
+
+    pools = [('4 KB', fixed_pools()), ('Classed', classed_pools())]
+
+    print('Buffer pools:')
+    for (name, pool) in pools:
+        print('    {0:<8} {1}'.format(name, ', '.join('{0} x {1} B'.format(num, size) for (size, num, _) in pool)))
+    print('')
+
+    print('{0:<26} | {1:>9} | {2:>9} | {3:>6} | {4:>12} | {5:>12}'.format(
+          'Trace', '4 KB pkts', 'Classed', 'Gain', '4 KB usage', 'Classed usage'))
+    print('-' * 88)
+
+    for (trace_name, lengths) in traces:
+        results = [fill_queue(pool, lengths) for (_, pool) in pools]
+
+        (fixed_pkts, fixed_bytes, fixed_buf)       = results[0]
+        (classed_pkts, classed_bytes, classed_buf) = results[1]
+
+        print('{0:<26} | {1:9d} | {2:9d} | {3:5.2f}x | {4:11.1f}% | {5:12.1f}%'.format(
+              trace_name[:26], fixed_pkts, classed_pkts, float(classed_pkts) / max(fixed_pkts, 1),
+              100.0 * fixed_bytes / max(fixed_buf, 1), 100.0 * classed_bytes / max(classed_buf, 1)))
+
+    print('')
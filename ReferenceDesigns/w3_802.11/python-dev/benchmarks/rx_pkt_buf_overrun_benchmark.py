@@ -0,0 +1,185 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Rx Packet Buffer Overrun
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark models the hand-off of receptions from CPU Low to CPU High
+through the ring of Rx packet buffers and compares the frame loss of the
+original blocking policy with the drop policy for bursts of receptions and
+different numbers of Rx packet buffers (NUM_RX_PKT_BUFS).
+
+Hardware Setup:
+    - None.  The Rx path is modeled on the host
+
+Required Script Changes:
+    - None.  The number of receptions per test can be passed as a command
+        line argument (default: 200000)
+
+Description:
+    CPU Low always owns the Rx packet buffer the PHY receives into; the other
+    NUM_RX_PKT_BUFS - 1 buffers can hold receptions waiting for CPU High.
+    CPU High processes the receptions in order with a service time that
+    depends on the frame length and includes occasional stalls (e.g. Ethernet
+    or log processing).
+
+    Blocking policy (original):  CPU Low always passes the reception to CPU
+    High and then spins until CPU High releases a buffer.  Every reception
+    that starts while CPU Low spins is lost, and CPU Low can not transmit or
+    respond to the medium.
+
+    Drop policy:  CPU Low passes the reception to CPU High only if another
+    buffer is empty.  Otherwise it drops the reception (counted as an Rx
+    overrun) and keeps receiving into the same buffer.
+
+    The loss of the blocking policy is optimistic:  while CPU Low spins, the
+    PHY still points at the buffer that was just passed to CPU High, so
+    receptions during that time can also corrupt a frame CPU High has not yet
+    processed.  The model does not count these.
+------------------------------------------------------------------------------
+"""
+import sys
+import random
+import collections
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_NUM_RX      = 200000
+SEED                = 0
+
+RING_DEPTHS         = [2, 4, 8, 12, 16]     # NUM_RX_PKT_BUFS (Rx BRAM holds 8; PHY supports up to 16)
+
+# PHY timing (microseconds)
+PHY_RATE_MBPS       = 54.0
+PHY_OVERHEAD_US     = 20 + 16 + 44          # Preamble + SIFS + ACK
+
+# CPU High service time model (microseconds)
+SERVICE_BASE_US     = 40.0
+SERVICE_PER_BYTE_US = 0.05
+STALL_PROB          = 0.01
+STALL_US            = 1500.0
+
+
+#-----------------------------------------------------------------------------
+# Traffic model
+#-----------------------------------------------------------------------------
+def gen_bursts(rng, num_rx, length, mean_burst, util, overhead_us=PHY_OVERHEAD_US):
+    """Arrival times (end of reception) and lengths of bursty traffic.
+
+    Bursts of back-to-back receptions (geometric burst length) are separated
+    by exponential idle times chosen so the medium is busy for the fraction
+    util of the time.
+    """
+    airtime   = 8.0 * length / PHY_RATE_MBPS + overhead_us
+    mean_idle = mean_burst * airtime * (1.0 / util - 1.0)
+
+    arrivals  = []
+    t         = 0.0
+
+    while len(arrivals) < num_rx:
+        t += rng.expovariate(1.0 / mean_idle)
+
+        burst = 1
+        while rng.random() > (1.0 / mean_burst):
+            burst += 1
+
+        for _ in range(burst):
+            t += airtime
+            arrivals.append(t)
+
+    return (arrivals[:num_rx], [length] * num_rx)
+
+
+def service_time(rng, length):
+    t = SERVICE_BASE_US + SERVICE_PER_BYTE_US * length
+
+    if rng.random() < STALL_PROB:
+        t += STALL_US
+
+    return t
+
+
+#-----------------------------------------------------------------------------
+# Rx hand-off models
+#-----------------------------------------------------------------------------
+def simulate(arrivals, lengths, depth, blocking, seed):
+    """Simulate the hand-off of the receptions to CPU High.
+
+    Returns:
+        (num_lost, blocked_us):  Number of lost receptions and total time CPU
+            Low spent waiting for an empty buffer
+    """
+    rng        = random.Random(seed)
+    departures = collections.deque()          # Times CPU High releases the buffers it owns
+    last_done  = 0.0
+    num_lost   = 0
+    blocked_us = 0.0
+    block_end  = 0.0
+
+    for (t, length) in zip(arrivals, lengths):
+        # Release the buffers CPU High finished before this reception
+        while departures and (departures[0] <= t):
+            departures.popleft()
+
+        if blocking and (t < block_end):
+            # CPU Low is spinning in wlan_mac_low_lock_empty_rx_pkt_buf()
+            num_lost += 1
+            continue
+
+        if not blocking and (len(departures) >= (depth - 1)):
+            # No empty buffer - drop the reception
+            num_lost += 1
+            continue
+
+        # Pass the reception to CPU High
+        last_done = max(t, last_done) + service_time(rng, length)
+        departures.append(last_done)
+
+        if blocking and (len(departures) >= depth):
+            # All buffers owned by CPU High - spin until it releases the oldest one
+            block_end   = departures[0]
+            blocked_us += block_end - t
+
+    return (num_lost, blocked_us)
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        num_rx = int(sys.argv[1])
+    else:
+        num_rx = DEFAULT_NUM_RX
+
+    rng = random.Random(SEED)
+
+    # Receptions with ACKs (PHY_OVERHEAD_US per frame) and A-MPDU-like bursts
+    # (only the MPDU delimiter between receptions)
+    scenarios = [
+        ('1500 B, bursts of 8, 50% busy',   gen_bursts(rng, num_rx, 1500,  8, 0.5)),
+        ('1500 B, bursts of 8, 90% busy',   gen_bursts(rng, num_rx, 1500,  8, 0.9)),
+        ('200 B, bursts of 32, 50% busy',   gen_bursts(rng, num_rx,  200, 32, 0.5)),
+        ('200 B, bursts of 32, 90% busy',   gen_bursts(rng, num_rx,  200, 32, 0.9)),
+        ('200 B A-MPDU, bursts of 16, 50%', gen_bursts(rng, num_rx,  200, 16, 0.5, overhead_us=1.0)),
+    ]
+
+    print('{0:<32} | {1:>5} | {2:>13} | {3:>12} | {4:>13}'.format(
+          'Scenario', 'Depth', 'Blocking loss', 'Drop loss', 'Low blocked'))
+    print('-' * 88)
+
+    for (name, (arrivals, lengths)) in scenarios:
+        duration = arrivals[-1]
+
+        for depth in RING_DEPTHS:
+            (lost_blk, blocked_us) = simulate(arrivals, lengths, depth, blocking=True,  seed=SEED)
+            (lost_drop, _)         = simulate(arrivals, lengths, depth, blocking=False, seed=SEED)
+
+            print('{0:<32} | {1:5d} | {2:12.3f}% | {3:11.3f}% | {4:12.2f}%'.format(
+                  name, depth, 100.0 * lost_blk / num_rx, 100.0 * lost_drop / num_rx, 100.0 * blocked_us / duration))
+
+        print('')
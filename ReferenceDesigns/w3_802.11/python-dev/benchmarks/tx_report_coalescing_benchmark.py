@@ -0,0 +1,244 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Tx Report Coalescing
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark models the delivery of Tx reports from CPU Low to CPU High and
+compares the mailbox interrupt rate and the CPU High load of immediate
+delivery with coalesced delivery (node.set_tx_report_coalescing()) at packet
+rates from 1k to 20k frames per second.
+
+Hardware Setup:
+    - None.  The IPC path is modeled on the host
+
+Required Script Changes:
+    - None.  The simulated time per test can be passed as a command line
+        argument in seconds (default: 2.0)
+
+Description:
+    CPU Low transmits the frames one after the other.  Each transmission
+    attempt creates an IPC_MBOX_PHY_TX_REPORT message and the last attempt of a
+    frame is followed by IPC_MBOX_TX_PKT_BUF_DONE.
+
+    Immediate:  Every message is published to the IPC ring when it is written.
+    Coalesced:  Tx reports open an IPC batch that is published once it holds
+                max_reports reports or MAX_TX_DONE Tx done messages, or its
+                oldest report is timeout_us old.  Tx done messages written
+                while a batch is open join it.
+
+    In both cases CPU Low only rings the mailbox doorbell (and interrupts CPU
+    High) if CPU High has read all of the previous messages.  CPU High then
+    reads all of the messages in the ring in one interrupt.  The Tx done delay
+    is the time a Tx done message waits before it is published, ie the time
+    its Tx packet buffer is held back from CPU High.  With bulk log
+    reservation, the log space of the Tx reports of one interrupt is reserved
+    in one step instead of one allocation per entry.
+
+    The CPU High costs below are estimates for the 160 MHz MicroBlaze; the
+    relative results matter more than the absolute load.
+------------------------------------------------------------------------------
+"""
+import sys
+import random
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+DEFAULT_DURATION    = 2.0                   # Simulated time per test (seconds)
+SEED                = 0
+
+FRAME_RATES         = [1000, 2000, 5000, 10000, 20000]
+
+# CPU Low model (microseconds)
+ATTEMPT_US          = 40.0                  # Short frame + SIFS + ACK
+RETRY_PROB          = 0.1
+MAX_ATTEMPTS        = 7
+
+# CPU High cost model (microseconds)
+IRQ_US              = 4.0                   # Interrupt entry / exit, doorbell read
+REPORT_US           = 8.0                   # station_info_txreport_process() + TX_LOW entry
+ALLOC_US            = 2.0                   # Log entry allocation (part of REPORT_US)
+RESERVE_US          = 2.5                   # Bulk log reservation (once per interrupt)
+DONE_US             = 20.0                  # Tx done processing + TX_HIGH entry
+
+# (name, max_reports, timeout_us, bulk log reservation)
+MODES = [
+    ('Immediate',                    1,   0, False),
+    ('Coalesce 8 / 200 us',          8, 200, False),
+    ('Coalesce 8 / 200 us + bulk',   8, 200, True),
+    ('Coalesce 32 / 500 us + bulk', 32, 500, True),
+]
+
+# Tx done messages per batch (TX_REPORT_COALESCE_MAX_TX_DONE = NUM_TX_PKT_BUF_MPDU / 2)
+MAX_TX_DONE         = 3
+
+REPORT              = 0
+DONE                = 1
+
+
+#-----------------------------------------------------------------------------
+# CPU Low model
+#-----------------------------------------------------------------------------
+def gen_messages(rng, rate, duration_us):
+    """Messages written by CPU Low as a list of (time, type) in time order."""
+    msgs     = []
+    t_free   = 0.0
+    t_arrive = 0.0
+
+    while True:
+        t_arrive += rng.expovariate(rate / 1e6)
+        if t_arrive >= duration_us:
+            break
+
+        t = max(t_arrive, t_free)
+
+        for attempt in range(MAX_ATTEMPTS):
+            t += ATTEMPT_US
+            msgs.append((t, REPORT))
+
+            if rng.random() >= RETRY_PROB:
+                break
+
+        msgs.append((t, DONE))
+        t_free = t
+
+    return msgs
+
+
+def publish(msgs, max_reports, timeout_us):
+    """Group the messages into the publications of the IPC ring.
+
+    Returns:
+        List of (publish_time, [(time, type), ...])
+    """
+    if max_reports <= 1:
+        return [(t, [(t, kind)]) for (t, kind) in msgs]
+
+    groups      = []
+    batch       = []
+    batch_start = None
+    num_reports = 0
+    num_done    = 0
+
+    for (t, kind) in msgs:
+        # Timeout:  CPU Low flushes the batch from its polling loop
+        if batch and ((t - batch_start) >= timeout_us):
+            groups.append((batch_start + timeout_us, batch))
+            batch       = []
+            num_reports = 0
+            num_done    = 0
+
+        if kind == REPORT:
+            if not batch:
+                batch_start = t
+            batch.append((t, kind))
+            num_reports += 1
+
+            if num_reports >= max_reports:
+                groups.append((t, batch))
+                batch       = []
+                num_reports = 0
+                num_done    = 0
+
+        elif batch:
+            batch.append((t, kind))
+            num_done += 1
+
+            if num_done >= MAX_TX_DONE:
+                groups.append((t, batch))
+                batch       = []
+                num_reports = 0
+                num_done    = 0
+        else:
+            groups.append((t, [(t, kind)]))
+
+    if batch:
+        groups.append((batch_start + timeout_us, batch))
+
+    return groups
+
+
+#-----------------------------------------------------------------------------
+# CPU High model
+#-----------------------------------------------------------------------------
+def simulate(groups, bulk):
+    """Process the publications on CPU High.
+
+    Returns:
+        (num_irqs, busy_us, mean_report_delay_us, mean_tx_done_delay_us)
+    """
+    num_irqs     = 0
+    busy_us      = 0.0
+    t_free       = 0.0
+    has_reports  = False
+    delay_sum    = 0.0
+    num_reports  = 0
+    done_sum     = 0.0
+    num_done     = 0
+
+    for (t_pub, batch) in groups:
+        if t_pub >= t_free:
+            # CPU High has read all of the previous messages:  doorbell + interrupt
+            num_irqs   += 1
+            t_free      = t_pub + IRQ_US
+            busy_us    += IRQ_US
+            has_reports = False
+
+        for (t_msg, kind) in batch:
+            if kind == REPORT:
+                cost = REPORT_US
+
+                if bulk:
+                    cost -= ALLOC_US
+
+                    if not has_reports:
+                        cost       += RESERVE_US
+                        has_reports = True
+
+                t_free      += cost
+                busy_us     += cost
+                delay_sum   += t_free - t_msg
+                num_reports += 1
+            else:
+                t_free      += DONE_US
+                busy_us     += DONE_US
+                done_sum    += t_pub - t_msg
+                num_done    += 1
+
+    return (num_irqs, busy_us, delay_sum / max(num_reports, 1), done_sum / max(num_done, 1))
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        duration = float(sys.argv[1])
+    else:
+        duration = DEFAULT_DURATION
+
+    duration_us = duration * 1e6
+
+    print('{0:<28} | {1:>8} | {2:>10} | {3:>10} | {4:>10} | {5:>12} | {6:>13}'.format(
+          'Mode', 'Frames/s', 'IRQs / s', 'IRQ / frm', 'High load', 'Report delay', 'Tx done delay'))
+    print('-' * 110)
+
+    for rate in FRAME_RATES:
+        msgs = gen_messages(random.Random(SEED), rate, duration_us)
+
+        for (name, max_reports, timeout_us, bulk) in MODES:
+            groups = publish(msgs, max_reports, timeout_us)
+
+            (num_irqs, busy_us, delay_us, done_us) = simulate(groups, bulk)
+
+            num_frames = sum(1 for (_, kind) in msgs if kind == DONE)
+
+            print('{0:<28} | {1:8d} | {2:10.0f} | {3:10.3f} | {4:9.1f}% | {5:9.1f} us | {6:10.1f} us'.format(
+                  name, rate, num_irqs / duration, float(num_irqs) / max(num_frames, 1),
+                  100.0 * busy_us / duration_us, delay_us, done_us))
+
+        print('')
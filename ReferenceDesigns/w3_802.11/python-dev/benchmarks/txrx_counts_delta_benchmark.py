@@ -0,0 +1,260 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Tx / Rx Counts Delta
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This benchmark compares polling the Tx / Rx counts of a node with
+get_txrx_counts() (CMDID_COUNTS_GET_TXRX) and with counts_get_txrx_delta()
+(CMDID_COUNTS_GET_TXRX_DELTA) for 8 / 64 / 256 stations.
+
+Hardware Setup:
+    - None.  The counts of the node are simulated on the host
+
+Required Script Changes:
+    - None.  The fraction of stations with traffic in each polling interval
+        can be passed as a command line argument (default: 0.25)
+
+Description:
+    The script simulates NUM_POLLS polls of a node every POLL_INTERVAL_MS.
+    In each interval, ACTIVE_FRACTION of the stations update their data
+    counts and MGMT_FRACTION update their management counts.  For each poll,
+    the node responses are built in the wire format of wlan_exp_node.c:
+
+        Full:   128 bytes (station_txrx_counts_t) per station
+        Delta:  16 byte header + 8 bytes per changed station + 56 bytes per
+                changed data / management counts
+
+    and decoded with the host code of the framework (TxRxCounts() info
+    structures and the counts_get_txrx_delta() generator).
+
+    The script prints, per poll:
+        - Bytes on the wire (including Ethernet / IP / UDP / transport headers
+          of each packet of the response)
+        - Modeled node CPU time of the command handler (see the NODE_* cycle
+          counts below; these are estimates for a 160 MHz MicroBlaze, not
+          measurements)
+        - Host time to decode the response
+------------------------------------------------------------------------------
+"""
+import sys
+import time
+import random
+import struct
+
+import wlan_exp.cmds as cmds
+import wlan_exp.info as info
+import wlan_exp.node as wlan_exp_node
+
+from bench_util import timed
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+NUM_STATIONS        = [8, 64, 256]
+NUM_POLLS           = 50
+POLL_INTERVAL_MS    = 100
+DEFAULT_ACTIVE      = 0.25                            # Fraction of stations with data traffic per interval
+MGMT_FRACTION       = 0.02                            # Fraction of stations with management traffic per interval
+SEED                = 0
+
+# Wire format
+FULL_STATION_SIZE   = 128                             # sizeof(station_txrx_counts_t)
+DELTA_HDR_SIZE      = 16
+DELTA_ENTRY_SIZE    = 8
+DELTA_SUB_SIZE      = 56                              # sizeof(frame_counts_txrx_t)
+MAX_PAYLOAD         = 1470
+PKT_OVERHEAD        = 14 + 20 + 8 + 12 + 8 + 20       # Eth + IP + UDP + transport + cmd + buffer headers
+REQ_SIZE            = PKT_OVERHEAD + 12
+
+# Node CPU model (cycles at NODE_CPU_HZ)
+NODE_CPU_HZ         = 160e6
+NODE_STATION_CYCLES = 60                              # Walk the station_info list / check the generation
+NODE_COPY_CYCLES    = 2                               # Per byte copied into the Ethernet buffer
+NODE_PKT_CYCLES     = 3200                            # Per Ethernet packet sent (header setup, DMA start)
+
+
+#-----------------------------------------------------------------------------
+# Simulated node
+#-----------------------------------------------------------------------------
+class SimCounts(object):
+    """Tx / Rx counts of the stations of a node with counts generations."""
+    def __init__(self, num_stations, rng):
+        self.rng        = rng
+        self.generation = 1
+        self.stations   = []
+
+        for i in range(num_stations):
+            mac_addr = struct.pack('6B', 0x40, 0xd8, 0x55, 0x04, i >> 8, i & 0xFF)
+            self.stations.append({'mac_addr' : mac_addr,
+                                  'data'     : [0] * 9, 'data_gen' : 1,
+                                  'mgmt'     : [0] * 9, 'mgmt_gen' : 1})
+
+    def update(self, active_fraction):
+        for station in self.stations:
+            for (part, fraction) in (('data', active_fraction), ('mgmt', MGMT_FRACTION)):
+                if (self.rng.random() < fraction):
+                    num_pkts = self.rng.randint(1, 100)
+                    counts   = station[part]
+                    for idx in (4, 5, 6, 7, 8):
+                        counts[idx] += num_pkts
+                    for idx in (0, 1, 2, 3):
+                        counts[idx] += num_pkts * 1000
+
+                    self.generation         += 1
+                    station[part + '_gen']   = self.generation
+
+    def _sub_counts(self, counts):
+        return struct.pack('<4Q 4I Q', *counts)
+
+    def full_resp(self):
+        """Response of CMDID_COUNTS_GET_TXRX; returns (data, node_cycles)."""
+        data   = b''
+        cycles = 0
+
+        for station in self.stations:
+            data   += struct.pack('<Q 6s H', int(time.time() * 1e6), station['mac_addr'], 0)
+            data   += self._sub_counts(station['data']) + self._sub_counts(station['mgmt'])
+            cycles += NODE_STATION_CYCLES + FULL_STATION_SIZE * NODE_COPY_CYCLES
+
+        return (data, cycles)
+
+    def delta_resp(self, generation):
+        """Response of CMDID_COUNTS_GET_TXRX_DELTA; returns (data, node_cycles)."""
+        data   = struct.pack('<Q I I', int(time.time() * 1e6), self.generation, 0)
+        cycles = DELTA_HDR_SIZE * NODE_COPY_CYCLES
+
+        for station in self.stations:
+            cycles += NODE_STATION_CYCLES
+            flags   = 0
+            subs    = b''
+
+            if (station['data_gen'] > generation):
+                flags |= cmds.CMD_PARAM_COUNTS_DELTA_FLAG_DATA
+                subs  += self._sub_counts(station['data'])
+
+            if (station['mgmt_gen'] > generation):
+                flags |= cmds.CMD_PARAM_COUNTS_DELTA_FLAG_MGMT
+                subs  += self._sub_counts(station['mgmt'])
+
+            if flags:
+                entry   = struct.pack('<6s B x', station['mac_addr'], flags) + subs
+                data   += entry
+                cycles += len(entry) * NODE_COPY_CYCLES
+
+        return (data, cycles)
+
+# End class()
+
+
+class SimBufferResp(object):
+    """Reassembled buffer response (see wlan_exp.transport.message.Buffer)."""
+    def __init__(self, data):
+        self.data = data
+
+    def get_bytes(self):
+        return self.data
+
+    def is_buffer_complete(self):
+        return True
+
+# End class()
+
+
+def wire_bytes(payload_size):
+    """Bytes on the wire of a request and its (fragmented) buffer response."""
+    max_data = MAX_PAYLOAD - PKT_OVERHEAD + 14 + 20 + 8
+    num_pkts = max(1, (payload_size + max_data - 1) // max_data)
+    return (REQ_SIZE + payload_size + num_pkts * PKT_OVERHEAD, num_pkts)
+
+
+def node_us(cycles, num_pkts):
+    return (cycles + num_pkts * NODE_PKT_CYCLES) / NODE_CPU_HZ * 1e6
+
+
+#-----------------------------------------------------------------------------
+# Benchmarks
+#-----------------------------------------------------------------------------
+def run_full(num_stations, active_fraction):
+    sim    = SimCounts(num_stations, random.Random(SEED))
+    totals = [0, 0.0, 0.0]                            # Bytes, node us, host s
+
+    for _ in range(NUM_POLLS):
+        sim.update(active_fraction)
+
+        (data, cycles)     = sim.full_resp()
+        (nbytes, num_pkts) = wire_bytes(len(data))
+
+        (_, host_s) = timed(lambda: info.deserialize_info_buffer(data, "TxRxCounts()"))
+        totals[2]  += host_s
+
+        totals[0] += nbytes
+        totals[1] += node_us(cycles, num_pkts)
+
+    return [t / NUM_POLLS for t in totals]
+
+
+def run_delta(num_stations, active_fraction):
+    sim    = SimCounts(num_stations, random.Random(SEED))
+    totals = [0, 0.0, 0.0]
+    poll   = {}
+
+    # Node that answers the delta command from the simulated counts
+    def send_cmd(cmd, *args, **kwargs):
+        ((data, cycles), sim_s) = timed(lambda: sim.delta_resp(cmd.args[-1]))
+        (nbytes, num_pkts)      = wire_bytes(len(data))
+
+        poll['bytes']   = nbytes
+        poll['node_us'] = node_us(cycles, num_pkts)
+        poll['sim_s']   = sim_s
+
+        return cmd.process_resp(SimBufferResp(data))
+
+    node          = wlan_exp_node.WlanExpNode.__new__(wlan_exp_node.WlanExpNode)
+    node.send_cmd = send_cmd
+    deltas        = node.counts_get_txrx_delta()
+
+    for _ in range(NUM_POLLS):
+        sim.update(active_fraction)
+
+        (counts, host_s) = timed(lambda: next(deltas))
+
+        # Host time without the simulated node
+        totals[0] += poll['bytes']
+        totals[1] += poll['node_us']
+        totals[2] += host_s - poll['sim_s']
+
+    # Check the cached counts against the node
+    for station in sim.stations:
+        row = [c for c in counts if c['mac_addr'].tobytes() == station['mac_addr']]
+        if row and (row[0]['data_num_tx_packets_total'] != station['data'][7]):
+            raise Exception("Delta counts do not match the node")
+
+    return [t / NUM_POLLS for t in totals]
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    if(len(sys.argv) != 1):
+        active_fraction = float(sys.argv[1])
+    else:
+        active_fraction = DEFAULT_ACTIVE
+
+    print('{0} polls every {1} ms; {2:.0%} of stations with data traffic, {3:.0%} with management traffic per interval\n'.format(
+          NUM_POLLS, POLL_INTERVAL_MS, active_fraction, MGMT_FRACTION))
+    print('{0:>8} | {1:<5} | {2:>12} | {3:>13} | {4:>12}'.format('Stations', 'Mode', 'Bytes / poll', 'Node us / poll', 'Host ms / poll'))
+    print('-' * 66)
+
+    # Warm up (imports, info structures)
+    run_delta(NUM_STATIONS[0], active_fraction)
+
+    for num_stations in NUM_STATIONS:
+        for (mode, func) in [('Full', run_full), ('Delta', run_delta)]:
+            (nbytes, nus, host_s) = func(num_stations, active_fraction)
+
+            print('{0:8d} | {1:<5} | {2:12.0f} | {3:14.1f} | {4:14.3f}'.format(num_stations, mode, nbytes, nus, host_s * 1e3))
@@ -33,7 +33,7 @@ Description:
 import sys
 import os
 import time
-import struct
+import numpy as np
 
 import wlan_exp.log.util as log_util
 import wlan_exp.log.util_hdf as hdf_util
@@ -47,64 +47,78 @@ import wlan_exp.log.entry_types as entry_types
 print_time   = False
 
 all_addrs    = list()
-addr_idx_map = dict()
+addr_id_map  = dict()
+
+# Entry types with MAC headers at the start of their 'mac_payload' field
+mac_hdr_entry_types = [('RX_DSSS', entry_types.entry_rx_dsss),
+                       ('RX_OFDM', entry_types.entry_rx_ofdm),
+                       ('TX_HIGH', entry_types.entry_tx_high),
+                       ('TX_LOW',  entry_types.entry_tx_low)]
 
 
 
 #-----------------------------------------------------------------------------
 # Anonymizer Methods
 #-----------------------------------------------------------------------------
-def do_replace_addr(addr):
-    """Determine if the MAC address should be replaced."""
-    do_replace = True
+def do_replace_addrs(addrs):
+    """Determine which MAC addresses should be replaced.
+
+    Args:
+        addrs (numpy array):  uint8 array of MAC addresses with shape (N, 6)
 
+    Returns:
+        do_replace (numpy array):  Boolean array with shape (N,)
+    """
     # This list should stay in sync with wlan_exp.util mac_addr_desc_map
 
     # Don't replace the broadcast address (FF-FF-FF-FF-FF-FF)
-    if(addr == (0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF)):
-        do_replace = False
+    keep  = np.all(addrs == 0xFF, axis=1)
 
     # Don't replace multicast IP v4 addresses (01-00-5E-00-00-00 to -7F-FF-FF)
     #   http://technet.microsoft.com/en-us/library/cc957928.aspx
-    if(addr[0:3] == (0x01, 0x00, 0x5E) and (addr[3] <= 0x7F)):
-        do_replace = False
+    keep |= (addrs[:, 0] == 0x01) & (addrs[:, 1] == 0x00) & (addrs[:, 2] == 0x5E) & (addrs[:, 3] <= 0x7F)
 
     # Don't replace multicast IP v6 addresses (33-33-xx-xx-xx-xx)
     #   http://www.cavebear.com/archive/cavebear/Ethernet/multicast.html
-    if(addr[0:2] == (0x33, 0x33)):
-        do_replace = False
+    keep |= (addrs[:, 0] == 0x33) & (addrs[:, 1] == 0x33)
 
     # Don't replace Mango addresses (40-D8-55-04-2x-xx)
-    if(addr[0:4] == (0x40, 0xD8, 0x55, 0x04) and ((addr[4] & 0x20) == 0x20)):
-        do_replace = False
+    keep |= ((addrs[:, 0] == 0x40) & (addrs[:, 1] == 0xD8) & (addrs[:, 2] == 0x55) & (addrs[:, 3] == 0x04) &
+             ((addrs[:, 4] & 0x20) == 0x20))
+
+    return ~keep
 
-    return do_replace
 
+def get_anon_addrs(addr_ids):
+    """Get the anonymous replacement for each address ID.
 
-def addr_to_replace(addr, byte_index, addr_idx_map):
-    """Build map of all indexes for a particular address so they can all be
-    replaced by the same value.
+    Address should not have a first octet that is odd, as this indicates 
+    the address is multicast.  Hence, use 0xFE as the first octet.
+
+    Due to FCS errors, the number of addresses in a log file is 
+    potentially large.  Therefore, the anonymizer supports 2^24 unique 
+    addresses.
     """
-    global all_addrs
-    if(do_replace_addr(addr)):
-        if(addr not in all_addrs):
-            all_addrs.append(addr)
-        if addr not in addr_idx_map.keys():
-            addr_idx_map[addr] = [byte_index,]
-        else:
-            addr_idx_map[addr].append(byte_index)
-    return
+    anon_addrs       = np.empty((len(addr_ids), 6), dtype=np.uint8)
+    anon_addrs[:, 0] = 0xFE
+    anon_addrs[:, 1] = 0xFF
+    anon_addrs[:, 2] = 0xFF
+    anon_addrs[:, 3] = (addr_ids // (256**2)) % 256
+    anon_addrs[:, 4] = (addr_ids // 256) % 256
+    anon_addrs[:, 5] = addr_ids % 256
+
+    return anon_addrs
 
 
 def log_anonymize(filename):
     """Anonymize the log."""
-    global all_addrs
+    global all_addrs, addr_id_map
 
     # Get the log_data from the file
     log_bytes = bytearray(hdf_util.hdf5_to_log_data(filename=filename))
 
     # Get the raw_log_index from the file
-    raw_log_index = hdf_util.hdf5_to_log_index(filename=filename)
+    raw_log_index = hdf_util.hdf5_to_log_index(filename=filename, as_np=True)
 
     # Get the user attributes from the file
     log_attr_dict  = hdf_util.hdf5_to_attr_dict(filename=filename)
@@ -117,100 +131,45 @@ def log_anonymize(filename):
                                                       'TX_HIGH': ['TX_HIGH', 'TX_HIGH_LTG'],
                                                       'TX_LOW' : ['TX_LOW', 'TX_LOW_LTG']})
 
-    # Re-initialize the address-byteindex map per file using the running
-    #   list of known MAC addresses
-    addr_idx_map = dict()
-    for addr in all_addrs:
-        addr_idx_map[addr] = list()
-
     log_util.print_log_index_summary(log_index, "Log Index Summary (merged):")
 
 
     #---------------------------------------------------------------------
-    # Step 1: Build a dictionary of all MAC addresses in the log, then
-    #   map each addresses to a unique anonymous address
-    #   Uses tuple(bytearray slice) since bytearray isn't hashable as-is
+    # Step 1: Find all MAC addresses in the log that should be replaced
+    #   Each address is read with a single gather over all entries
     #
     print("Anonmyizing file step 1 ...")
 
     start_time = time.time()
 
-    #----------------------------------
-    # Rx DSSS entries
-    #
-    try:
-        print("    Anonmyizing {0} RX_DSSS entries".format(len(log_index['RX_DSSS'])))
-
-        pyld_start = struct.calcsize(''.join(
-                entry_types.entry_rx_dsss.get_field_struct_formats()[:-1])
-        )
-
-        for idx in log_index['RX_DSSS']:
-            # 6-byte addresses at offsets 4, 10, 16 in the mac_payload
-            for o in (4, 10, 16):
-                addr_to_replace(tuple(log_bytes[idx+pyld_start+o:idx+pyld_start+o+6]), idx+pyld_start+o, addr_idx_map)
-    except KeyError:
-        pass
-
-    if print_time:
-        print("        Time = {0:.3f}s".format(time.time() - start_time))
-
-    #----------------------------------
-    # Rx OFDM entries
-    #
-    try:
-        print("    Anonmyizing {0} RX_OFDM entries".format(len(log_index['RX_OFDM'])))
-
-        pyld_start = struct.calcsize(''.join(
-                entry_types.entry_rx_ofdm.get_field_struct_formats()[:-1])
-        )
+    addr_offsets = []
 
-        for idx in log_index['RX_OFDM']:
-            # 6-byte addresses at offsets 4, 10, 16 in the mac_payload
-            for o in (4, 10, 16):
-                addr_to_replace(tuple(log_bytes[idx+pyld_start+o:idx+pyld_start+o+6]), idx+pyld_start+o, addr_idx_map)
-    except KeyError:
-        pass
-
-    if print_time:
-        print("        Time = {0:.3f}s".format(time.time() - start_time))
+    for (entry_name, entry_type) in mac_hdr_entry_types:
+        try:
+            byte_offsets = np.asarray(log_index[entry_name], dtype=np.int64)
+        except KeyError:
+            continue
 
-    #----------------------------------
-    # Tx entries
-    #
-    try:
-        print("    Anonmyizing {0} TX_HIGH entries".format(len(log_index['TX_HIGH'])))
+        print("    Anonmyizing {0} {1} entries".format(len(byte_offsets), entry_name))
 
-        pyld_start = struct.calcsize(''.join(
-                entry_types.entry_tx_high.get_field_struct_formats()[:-1])
-        )
+        pyld_start = entry_type.get_field_offsets()['mac_payload']
 
-        for idx in log_index['TX_HIGH']:
-            # 6-byte addresses at offsets 4, 10, 16 in the mac_payload
-            for o in (4, 10, 16):
-                addr_to_replace(tuple(log_bytes[idx+pyld_start+o:idx+pyld_start+o+6]), idx+pyld_start+o, addr_idx_map)
-    except KeyError:
-        pass
+        # 6-byte addresses at offsets 4, 10, 16 in the mac_payload
+        addr_offsets.append((byte_offsets[:, np.newaxis] + pyld_start + np.array([4, 10, 16])).reshape(-1))
 
-    if print_time:
-        print("        Time = {0:.3f}s".format(time.time() - start_time))
+    if addr_offsets:
+        addr_offsets = np.concatenate(addr_offsets)
+    else:
+        addr_offsets = np.empty(0, dtype=np.int64)
 
-    #----------------------------------
-    # Tx Low entries
-    #
-    try:
-        print("    Anonmyizing {0} TX_LOW entries".format(len(log_index['TX_LOW'])))
+    addrs        = log_util.read_byte_fields(log_bytes, addr_offsets, 6)
+    do_replace   = do_replace_addrs(addrs)
 
-        pyld_start = struct.calcsize(''.join(
-                entry_types.entry_tx_low.get_field_struct_formats()[:-1])
-        )
+    addr_offsets = addr_offsets[do_replace]
+    addrs        = addrs[do_replace]
 
-        for idx in log_index['TX_LOW']:
-            # 6-byte addresses at offsets 40, 46, 52
-            for o in (4, 10, 16):
-                addr_to_replace(tuple(log_bytes[idx+pyld_start+o:idx+pyld_start+o+6]), idx+pyld_start+o, addr_idx_map)
-    except KeyError:
-        pass
+    # Use the 48-bit integer value of each address as its key
+    addr_keys    = np.dot(addrs.astype(np.uint64), (np.uint64(1) << np.arange(40, -8, -8, dtype=np.uint64)))
 
     if print_time:
         print("        Time = {0:.3f}s".format(time.time() - start_time))
@@ -218,22 +177,23 @@ def log_anonymize(filename):
 
     #---------------------------------------------------------------------
     # Step 2: Enumerate actual MAC addresses and their anonymous replacements
+    #   Addresses are numbered in the order they first appear in the log;
+    #   addresses already seen in a previous file keep their number
     #
     print("Anonmyizing file step 2 ...")
 
     print("    Enumerate MAC addresses and their anonymous replacements")
 
-    addr_map = dict()
-    for ii,addr in enumerate(all_addrs):
-        # Address should not have a first octet that is odd, as this indicates 
-        # the address is multicast.  Hence, use 0xFE as the first octet.
-        #
-        # Due to FCS errors, the number of addresses in a log file is 
-        # potentially large.  Therefore, the anonymizer supports 2^24 unique 
-        # addresses.
-        #
-        anon_addr = (0xFE, 0xFF, 0xFF, (ii//(256**2)), ((ii//256)%256), (ii%256))
-        addr_map[addr] = anon_addr
+    (uniq_keys, first_idx, inverse) = np.unique(addr_keys, return_index=True, return_inverse=True)
+
+    for ii in np.argsort(first_idx, kind='stable').tolist():
+        key = int(uniq_keys[ii])
+
+        if key not in addr_id_map:
+            addr_id_map[key] = len(all_addrs)
+            all_addrs.append(tuple(addrs[first_idx[ii]].tolist()))
+
+    uniq_ids = np.array([addr_id_map[int(k)] for k in uniq_keys], dtype=np.int64)
 
     if print_time:
         print("        Time = {0:.3f}s".format(time.time() - start_time))
@@ -246,10 +206,7 @@ def log_anonymize(filename):
 
     print("    Replace all MAC addresses in the log")
 
-    for old_addr in addr_idx_map.keys():
-        new_addr = bytearray(addr_map[old_addr])
-        for byte_idx in addr_idx_map[old_addr]:
-            log_bytes[byte_idx:byte_idx+6] = new_addr
+    log_util.write_byte_fields(log_bytes, addr_offsets, get_anon_addrs(uniq_ids[inverse.reshape(-1)]))
 
     if print_time:
         print("        Time = {0:.3f}s".format(time.time() - start_time))
@@ -263,11 +220,8 @@ def log_anonymize(filename):
     print("    Remove all payloads")
 
     # Overwrite all payloads with zeros
-    try:
-        for key in log_index.keys():
-            log_util.overwrite_payloads(log_bytes, log_index[key])
-    except:
-        pass
+    for key in raw_log_index.keys():
+        log_util.overwrite_payloads(log_bytes, raw_log_index[key])
 
     if print_time:
         print("        Time = {0:.3f}s".format(time.time() - start_time))
@@ -318,8 +272,10 @@ if __name__ == '__main__':
                 log_anonymize(filename)
 
     print("\nMAC Address Mapping:")
+    anon_addrs = get_anon_addrs(np.arange(len(all_addrs)))
+
     for ii,addr in enumerate(all_addrs):
-        anon_addr = (0xFE, 0xFF, 0xFF, (ii//(256**2)), ((ii//256)%256), (ii%256))
+        anon_addr = anon_addrs[ii]
         print("%2d: %02x:%02x:%02x:%02x:%02x:%02x -> %02x:%02x:%02x:%02x:%02x:%02x" %
             (ii, addr[0], addr[1], addr[2], addr[3], addr[4], addr[5],
              anon_addr[0], anon_addr[1], anon_addr[2], anon_addr[3], anon_addr[4], anon_addr[5]))
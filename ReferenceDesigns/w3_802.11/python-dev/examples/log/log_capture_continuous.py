@@ -19,8 +19,15 @@ Required Script Changes:
 Description:
   This script initializes one WARP v3 node.  It will periodically update 
 information on the screen about the log.  The script will also read the log 
-data every LOG_READ_TIME seconds, write it to the hdf5 file, HDF5_FILENAME, 
-and continue until MAX_LOG_SIZE is reached or the user ends the experiment.
+data at least every LOG_READ_TIME seconds, write it to the hdf5 file, 
+HDF5_FILENAME, and continue until MAX_LOG_SIZE is reached or the user ends 
+the experiment.  The log is read and written by background threads (see 
+wlan_exp.log.util_capture), which read the log more often if it fills quickly.
+
+  While the experiment is running, throughput, PER, Rx power and airtime over
+the last ANALYTICS_WINDOW seconds are served at http://localhost:ANALYTICS_PORT/
+(JSON at /stats and Prometheus text at /metrics).  Set ANALYTICS_PORT to None
+to disable the online analytics.
 ------------------------------------------------------------------------------
 """
 import sys
@@ -33,6 +40,8 @@ import wlan_exp.config as wlan_exp_config
 
 import wlan_exp.log.util as log_util
 import wlan_exp.log.util_hdf as hdf_util
+import wlan_exp.log.util_capture as capture_util
+import wlan_exp.log.util_online as online_util
 
 # Fix to support Python 2.x and 3.x
 if sys.version[0]=="3": raw_input=input
@@ -55,6 +64,11 @@ PRINT_TIME           = 1
 # Logging variables
 LOG_READ_TIME        = 30
 MAX_LOG_SIZE         = 2**30             # Max size is 1GB
+LOG_COMPRESSION      = None              # HDF5 compression of the log data (e.g. 'gzip')
+
+# Online analytics variables
+ANALYTICS_PORT       = 9100              # HTTP port of the analytics (None to disable)
+ANALYTICS_WINDOW     = 60                # Rolling window in seconds
 
 
 #-----------------------------------------------------------------------------
@@ -69,6 +83,8 @@ timeout            = 0.1
 
 h5_file            = None
 log_container      = None
+log_capture        = None
+analyzer           = None
 
 attr_dict          = {}
 
@@ -76,30 +92,13 @@ attr_dict          = {}
 #-----------------------------------------------------------------------------
 # Local Helper Utilities
 #-----------------------------------------------------------------------------
-def add_data_to_log(log_tail_pad=500):
-    """Adds data to the log."""
-    global node
-    global log_container
-
-    buffer = node.log_get_all_new(log_tail_pad=log_tail_pad)
-    data   = buffer.get_bytes()
-
-    if (len(data) > 0):
-        # Write Log Files for processing by other scripts
-        print("\nWriting {0:15,d} bytes of data to log file {1}...".format(len(data), h5_file.filename))
-        log_container.write_log_data(data)
-
-# End def
-
-
-def get_log_size_str(nodes):
-    """Gets the log size str for each node."""
+def get_log_size_str():
+    """Gets the log size str of the capture."""
+    status = log_capture.get_status()
 
     msg  = "Log Size:"
-
-    for node in nodes:
-        log_size  = node.log_get_size()
-        msg += "    {0:10d} bytes".format(log_size)
+    msg += "    {0:10d} bytes".format(status['bytes_written'])
+    msg += "    (read every {0:5.1f} sec)".format(status['interval'])
 
     return msg
 
@@ -119,7 +118,7 @@ def print_node_state(start_time):
     msg  = "\r"
     msg += get_exp_duration_str(start_time)
     msg += " " * 5
-    msg += get_log_size_str(nodes)
+    msg += get_log_size_str()
     msg += " " * 5
 
     sys.stdout.write(msg)
@@ -185,20 +184,35 @@ def setup_experiment():
 
 def run_experiment():
     """Run the experiment."""
-    global network_config, node, log_container, exp_done, input_done
+    global network_config, node, log_container, log_capture, analyzer, exp_done, input_done
 
     print("\nRun Experiment:\n")
-    print("Log data will be retrieved every {0} seconds\n".format(LOG_READ_TIME))
+    print("Log data will be retrieved at least every {0} seconds\n".format(LOG_READ_TIME))
+
+    if ANALYTICS_PORT is not None:
+        analyzer = online_util.OnlineLogAnalyzer(window=(ANALYTICS_WINDOW * 10**6))
+        analyzer.start_http_server(port=ANALYTICS_PORT)
+        print("Online analytics at http://localhost:{0}/stats (JSON) and /metrics (Prometheus)\n".format(ANALYTICS_PORT))
+
     print("Use 'q' or Ctrl-C to end the experiment.\n")
     print("    When using IPython, press return to see status update.\n")
 
     # Add the current time to all the nodes
     wlan_exp_util.broadcast_cmd_write_time_to_logs(network_config)
 
+    # Start reading the log in the background
+    #   The node must not be accessed by this thread while the capture is running
+    if analyzer is not None:
+        callback = analyzer.update
+    else:
+        callback = None
+
+    log_capture = capture_util.LogCaptureService(node, log_container, interval=LOG_READ_TIME, callback=callback)
+    log_capture.start()
+
     # Get the start time
     start_time = time.time()
     last_print = time.time()
-    last_read  = time.time()
 
     # Print the current state of the node
     print_node_state(start_time)
@@ -213,29 +227,34 @@ def run_experiment():
             # Set the last_print time
             last_print = time.time()
 
-        if ((loop_time - last_read) > LOG_READ_TIME):
-            # Write the data to the log
-            add_data_to_log()
+        # Log size stop condition
+        if (log_capture.get_status()['bytes_written'] > MAX_LOG_SIZE):
+            print("\n!!! Reached Max Log Size.  Ending experiment. !!!\n")
+            input_done = True
+            exp_done   = True
 
-            # Set the last_read time
-            last_read  = time.time()
+        # Capture stopped because of an error
+        if not log_capture.is_running():
+            print("\n!!! Log capture stopped.  Ending experiment. !!!\n")
+            input_done = True
+            exp_done   = True
 
-            # Log size stop condition
-            if (log_container.get_log_data_size() > MAX_LOG_SIZE):
-                print("\n!!! Reached Max Log Size.  Ending experiment. !!!\n")
-                input_done = True
-                exp_done   = True
+        time.sleep(timeout)
 
 # End def
 
 
 def end_experiment():
     """Experiment cleanup / post processing."""
-    global node, log_container
+    global node, log_container, log_capture
     print("\nEnding experiment\n")
 
-    # Get the last of the data
-    add_data_to_log(log_tail_pad=0)
+    # Get the last of the data and wait for it to be written
+    if log_capture is not None:
+        log_capture.stop()
+
+    if analyzer is not None:
+        analyzer.stop_http_server()
 
     # Create the log index
     log_container.write_log_index()
@@ -274,7 +293,7 @@ if __name__ == '__main__':
 
     # Create Log Container
     h5_file       = hdf_util.hdf5_open_file(LOGFILE)
-    log_container = hdf_util.HDF5LogContainer(h5_file)
+    log_container = hdf_util.HDF5LogContainer(h5_file, compression=LOG_COMPRESSION)
 
     # Log attributes about the experiment
     attr_dict['exp_name'] = 'Interactive Capture, Continuous Log Read'
@@ -0,0 +1,104 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Log Latency Traces
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This script uses the WLAN Exp Log utilities to join the latency trace entries
+of a transmitting node and a receiving node and print the latency of each
+stage of the packets, from MAC ingress to reception by the peer.
+
+Hardware Setup:
+    - None.  Parsing log data can be done completely off-line
+
+Required Script Changes:
+    - None.  The log files of the transmitting node and the receiving node
+        are passed as command line arguments
+
+Description:
+    The logs must be captured with latency tracing enabled on both nodes
+    (``node.log_configure(log_txrx_trace=True)``) and contain TIME_INFO entries
+    written to both nodes at the same time (e.g. a broadcast
+    ``log_write_time()``), which are used to align the clocks of the nodes.
+------------------------------------------------------------------------------
+"""
+import os
+import sys
+
+import wlan_exp.log.util as log_util
+import wlan_exp.log.util_hdf as hdf_util
+import wlan_exp.log.util_trace as trace_util
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+HIST_BIN_WIDTH = 50               # Width of the histogram bins (microseconds)
+
+
+#-----------------------------------------------------------------------------
+# Process filenames
+#-----------------------------------------------------------------------------
+if (len(sys.argv) != 3):
+    print("Usage: {0} <Tx node log file> <Rx node log file>".format(sys.argv[0]))
+    sys.exit()
+
+LOGFILE_TX = str(sys.argv[1])
+LOGFILE_RX = str(sys.argv[2])
+
+for logfile in (LOGFILE_TX, LOGFILE_RX):
+    if not os.path.isfile(logfile):
+        print("ERROR: Log file {0} not found".format(logfile))
+        sys.exit()
+
+    print("Reading log file '{0}' ({1:5.1f} MB)".format(logfile, (os.path.getsize(logfile)/2**20)))
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+def read_log(filename, entry_types, merge=None):
+    log_data      = hdf_util.hdf5_to_log_data(filename=filename)
+    raw_log_index = hdf_util.hdf5_to_log_index(filename=filename)
+
+    log_index     = log_util.filter_log_index(raw_log_index, include_only=entry_types, merge=merge)
+
+    return log_util.log_data_to_np_arrays(log_data, log_index)
+
+
+log_np_tx = read_log(LOGFILE_TX, ['TIME_INFO', 'TX_TRACE', 'TX_LOW'], merge={'TX_LOW': ('TX_LOW', 'TX_LOW_LTG')})
+log_np_rx = read_log(LOGFILE_RX, ['TIME_INFO', 'RX_TRACE'])
+
+for (name, log_np, entry_type) in (('Tx', log_np_tx, 'TX_TRACE'), ('Rx', log_np_rx, 'RX_TRACE')):
+    if entry_type not in log_np:
+        print("ERROR: {0} node log does not contain {1} entries.  Enable latency tracing with".format(name, entry_type))
+        print("    node.log_configure(log_txrx_trace=True)")
+        sys.exit()
+
+# Align the clock of the Rx node with the Tx node
+try:
+    clock_model = log_util.calc_clock_model(log_np_rx['TIME_INFO'], ref_time_info=log_np_tx['TIME_INFO'])
+except (KeyError, AttributeError):
+    print("ERROR: Logs do not contain common TIME_INFO entries to align the node clocks.")
+    sys.exit()
+
+rx_offset = clock_model['global'] - clock_model['local']
+
+# Join the traces
+traces = trace_util.join_latency_traces(log_np_tx['TX_TRACE'], log_np_tx['TX_LOW'],
+                                        rx={'rx': log_np_rx['RX_TRACE']}, time_offsets={'rx': rx_offset})
+
+print('')
+trace_util.print_latency_summary(traces)
+
+# Print the histogram of the total latency
+(counts, bin_edges) = trace_util.calc_latency_histograms(traces, bin_width=HIST_BIN_WIDTH, stages=['total'])['total']
+
+print('{0:>20} | {1:>9}'.format('Total latency (us)', 'Packets'))
+
+for (count, start) in zip(counts, bin_edges[:-1]):
+    if count:
+        print('{0:>9} - {1:>8} | {2:9d}'.format(start, start + HIST_BIN_WIDTH, count))
+
+print('')
@@ -0,0 +1,168 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design Experiments Framework - Print Profiling Probes
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This module provides a simple wlan_exp example.
+
+Hardware Setup:
+  - Requires 1+ WARP v3 node running 802.11 Reference Design v1.5 or later
+    with CPU High and / or CPU Low compiled with WLAN_PROF_ENABLE set to 1
+  - PC NIC and ETH B on WARP v3 nodes connected to common Ethernet switch
+
+Required Script Changes:
+  - Set NETWORK to the IP address of your host PC NIC network (eg X.Y.Z.0 for IP X.Y.Z.W)
+  - Set NODE_SERIAL_LIST to the serial numbers of your WARP nodes
+
+Description:
+  This script will initialize the given nodes and reset their profiling
+probes; then every INTERVAL seconds, it will read the probes of CPU High and
+CPU Low of each node and display the time spent in each probed hot path with
+a histogram of the times.
+------------------------------------------------------------------------------
+"""
+# Import Python modules
+import time
+
+# Import wlan_exp Framework
+import wlan_exp.config as config
+import wlan_exp.util as util
+
+# Change these values to match your experiment / network setup
+NETWORK              = '10.0.0.0'
+USE_JUMBO_ETH_FRAMES = False
+NODE_SERIAL_LIST     = ['W3-a-00001']
+
+INTERVAL             = 5
+CPUS                 = ['high', 'low']
+HIST_WIDTH           = 40
+
+nodes = []
+
+
+def initialize_experiment():
+    """Initialize the wlan_exp experiment."""
+    global nodes
+
+    # Print initial message
+    print("\nInitializing experiment\n")
+
+    # Create an object that describes the network configuration of the host PC
+    network_config = config.WlanExpNetworkConfiguration(network=NETWORK,
+                                                        jumbo_frame_support=USE_JUMBO_ETH_FRAMES)
+
+    # Create an object that describes the WARP v3 nodes that will be used in this experiment
+    nodes_config   = config.WlanExpNodesConfiguration(network_config=network_config,
+                                                      serial_numbers=NODE_SERIAL_LIST)
+
+    # Initialize the Nodes
+    #   This will initialize all of the networking and gather the necessary
+    #   information to control and communicate with the nodes
+    nodes = util.init_nodes(nodes_config, network_config)
+
+    # Reset the probes so that each display covers the time since the script started
+    for node in nodes:
+        for cpu in CPUS:
+            node.reset_profile(cpu=cpu)
+
+
+def run_experiment():
+    """Run the experiment."""
+    global nodes
+
+    # Print initial message
+    print("\nRunning experiment (Use Ctrl-C to exit)\n")
+
+    while(True):
+        # Wait for the probes to collect samples
+        time.sleep(INTERVAL)
+
+        for node in nodes:
+            for cpu in CPUS:
+                print_profile(node, cpu, node.get_profile(cpu=cpu))
+
+        print(92*"*")
+
+
+def bin_label(bin_idx, num_bins, ticks_per_us):
+    """Helper method to get the range of a histogram bin (in microseconds)."""
+    if (bin_idx == 0):
+        return "0"
+
+    low  = float(2 ** (bin_idx - 1)) / ticks_per_us
+
+    if (bin_idx == (num_bins - 1)):
+        return ">= {0:g} us".format(low)
+
+    return "{0:g} - {1:g} us".format(low, float(2 ** bin_idx) / ticks_per_us)
+
+
+def print_profile(node, cpu, profile):
+    """Helper method to print the profiling probes of one CPU."""
+    print("Profiling probes of CPU {0} of node {1}".format(cpu.capitalize(), node.sn_str))
+
+    if profile is None:
+        print("    Not available (CPU {0} was not compiled with WLAN_PROF_ENABLE)\n".format(cpu.capitalize()))
+        return
+
+    ticks_per_us = float(profile['ticks_per_us'])
+
+    print("-------------------------------- ---------- ---------- ---------- ---------- ------------ ")
+    print("Probe                            Samples    Mean (us)  Min (us)   Max (us)   Total (ms)   ")
+    print("-------------------------------- ---------- ---------- ---------- ---------- ------------ ")
+
+    for (name, probe) in sorted(profile['probes'].items()):
+        num_samples = probe['num_samples']
+
+        if (num_samples == 0):
+            print("{0:<32} {1:10d} {2:>10} {2:>10} {2:>10} {2:>12}".format(name, 0, "-"))
+            continue
+
+        print("{0:<32} {1:10d} {2:10.2f} {3:10.2f} {4:10.2f} {5:12.3f}".format(
+              name, num_samples,
+              probe['total_ticks'] / ticks_per_us / num_samples,
+              probe['min_ticks'] / ticks_per_us,
+              probe['max_ticks'] / ticks_per_us,
+              probe['total_ticks'] / ticks_per_us / 1000.0))
+
+    print("")
+
+    for (name, probe) in sorted(profile['probes'].items()):
+        bins = probe['bins']
+
+        if (probe['num_samples'] == 0):
+            continue
+
+        print("    {0}".format(name))
+
+        # Only display the bins between the first and the last non-empty bin
+        used  = [idx for (idx, count) in enumerate(bins) if count]
+        peak  = max(bins)
+
+        for idx in range(used[0], used[-1] + 1):
+            bar = "#" * int(round(HIST_WIDTH * float(bins[idx]) / peak))
+            print("        {0:>18} {1:10d} {2}".format(bin_label(idx, len(bins), ticks_per_us), bins[idx], bar))
+
+        print("")
+
+
+def end_experiment():
+    """Experiment cleanup / post processing."""
+    global nodes
+    print("\nEnding experiment\n")
+
+
+
+if __name__ == '__main__':
+    initialize_experiment();
+
+    try:
+        # Run the experiment
+        run_experiment()
+    except KeyboardInterrupt:
+        pass
+
+    end_experiment()
+    print("\nExperiment Finished.")
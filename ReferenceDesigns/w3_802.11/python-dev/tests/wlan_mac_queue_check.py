@@ -0,0 +1,712 @@
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design - Experiments Framework - Tx Queue Check
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+This check tests the Tx queue statistics and AQM code of CPU High
+(wlan_mac_queue.c) on the host.
+
+Hardware Setup:
+    - None.  The C code of the queue statistics is compiled for the host
+
+Required Script Changes:
+    - None.  A host C compiler is required (cc by default; set the CC
+        environment variable to use another compiler)
+
+Description:
+    The script extracts the Tx queue and histogram functions from
+    wlan_mac_queue.c and the list functions from wlan_mac_dl_list.c.  It
+    compiles them with a small harness that replaces the platform functions
+    (MAC / system time, interrupts, memory allocation, logging) and loads the
+    library with ctypes.  It then checks:
+
+        Bins:        _queue_hist_add():  bin 0 counts 0, bin N counts
+                     [2^(N-1), 2^N) and the last bin counts all samples of
+                     2^(QUEUE_STATS_NUM_BINS - 2) or more.  The largest
+                     sample is kept.  Random samples match np.histogram()
+                     with util_queue_stats.calc_bin_edges()
+        Delay:       _queue_delay() of negative, zero and > 32-bit delays
+        Occupancy:   enqueue_after_tail() adds the length of the queue
+                     (including the new packet) to the histograms of the
+                     queue and of the station
+        Sojourn:     dequeue_from_head() adds the time between enqueue and
+                     dequeue of each packet
+        Tx done:     queue_stats_mpdu_tx_done() adds the time between enqueue
+                     and Tx done
+        Drops:       Packets dropped by the lifetime AQM policy and by
+                     purge_queue() are not added to the sojourn histograms
+        Lifetime:    The lifetime AQM policy uses the system time, so jumps
+                     of the MAC time do not drop or keep packets
+        isqrt:       _queue_isqrt() against math.isqrt()
+        Control law: _queue_codel_control_law() is t + interval / sqrt(count)
+                     to within the 8.8 fixed point precision
+        CoDel:       The drop schedule of _queue_codel_dequeue() for a
+                     standing queue follows RFC 8289:  the first drop one
+                     interval after the sojourn time went above target, then
+                     a drop every interval / sqrt(count), while the MAC time
+                     jumps by up to +/- 10 s at each dequeue
+
+    The struct size asserts of the firmware headers assume the 32-bit
+    MicroBlaze, so they are disabled in the host build.
+
+    The script prints one line per check and raises an exception at the
+    first failure.  It also raises an exception if one of the functions or
+    constants it needs is not found exactly once in the C sources, ie if
+    the firmware code has changed in a way the harness does not know.
+------------------------------------------------------------------------------
+"""
+import os
+import re
+import math
+import shutil
+import ctypes
+import tempfile
+import subprocess
+
+import numpy as np
+
+import wlan_exp.log.util_queue_stats as queue_stats_util
+
+
+#-----------------------------------------------------------------------------
+# Top level script variables
+#-----------------------------------------------------------------------------
+C_DEV_DIR          = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'c-dev')
+
+INCLUDE_DIRS       = ['wlan_mac_common_framework/include', 'wlan_mac_high_framework/include']
+
+DL_LIST_FUNCS      = ['dl_list_init', 'dl_entry_insertAfter', 'dl_entry_insertBefore', 'dl_entry_insertBeginning',
+                      'dl_entry_insertEnd', 'dl_entry_move', 'dl_entry_remove']
+
+QUEUE_FUNCS        = ['queue_num_queued', 'enqueue_after_tail', 'dequeue_from_head', '_queue_remove_head',
+                      '_queue_drop', '_queue_aqm_grow', '_queue_codel_dequeue', '_queue_codel_ok_to_drop',
+                      '_queue_codel_control_law', '_queue_isqrt', '_queue_delay', 'queue_stats_mpdu_tx_done',
+                      'queue_get_stats', 'queue_get_station_stats', '_queue_stats_grow', '_queue_stats_dequeue',
+                      '_queue_hist_add', 'queue_set_aqm_config', 'purge_queue']
+
+NUM_STATIONS       = 4
+NUM_RANDOM         = 200000
+SEED               = 0
+
+CODEL_TARGET       = 5000               # QUEUE_AQM_CODEL_TARGET_USEC_DEFAULT
+CODEL_INTERVAL     = 100000             # QUEUE_AQM_CODEL_INTERVAL_USEC_DEFAULT
+CODEL_STEP         = 100                # Time between enqueue / dequeue pairs (usec)
+CODEL_BACKLOG      = 2000               # Packets of the standing queue
+CODEL_DURATION     = 3 * 10**6          # usec
+MAC_TIME_JUMP      = 10**7              # Max MAC time jump (usec)
+
+
+#-----------------------------------------------------------------------------
+# Host harness
+#-----------------------------------------------------------------------------
+HARNESS_HEADER     = r"""
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wlan_mac_high_sw_config.h"
+#include "xil_types.h"
+#include "wlan_common_types.h"
+#include "wlan_mac_dl_list.h"
+#include "wlan_mac_pkt_buf_util.h"
+#include "wlan_mac_queue.h"
+#include "wlan_mac_station_info.h"
+
+#define max(a, b)                 (((a) > (b)) ? (a) : (b))
+#define min(a, b)                 (((a) < (b)) ? (a) : (b))
+
+#define xil_printf                printf
+#define wlan_exp_printf(level, type, format, args...)   do { } while(0)
+
+typedef enum interrupt_state_t{
+    INTERRUPTS_DISABLED,
+    INTERRUPTS_ENABLED
+} interrupt_state_t;
+
+static u64             harness_time;
+static s64             harness_mac_offset;
+static u32             harness_num_checkin;
+static station_info_t  harness_stations[%(num_stations)d];
+
+static dl_list*        tx_queues;
+static u16             num_tx_queues;
+static queue_aqm_t*    queue_aqm;
+static u16             num_queue_aqm;
+static queue_stats_t*  queue_stats;
+static u16             num_queue_stats;
+
+static int harness_null_callback(){ return 0; }
+
+static function_ptr_t  queue_state_change_callback = (function_ptr_t)harness_null_callback;
+static function_ptr_t  tx_poll_callback            = (function_ptr_t)harness_null_callback;
+
+u64 get_mac_time_usec(){ return harness_time + harness_mac_offset; }
+u64 get_system_time_usec(){ return harness_time; }
+
+void* wlan_mac_high_malloc(u32 size){ return malloc(size); }
+void* wlan_mac_high_calloc(u32 size){ return calloc(1, size); }
+void* wlan_mac_high_realloc(void* addr, u32 size){ return realloc(addr, size); }
+void  wlan_mac_high_free(void* addr){ free(addr); }
+
+interrupt_state_t wlan_mac_high_interrupt_stop(){ return INTERRUPTS_ENABLED; }
+int wlan_mac_high_interrupt_restore_state(interrupt_state_t new_interrupt_state){ return 0; }
+
+void* wlan_exp_log_create_tx_drop_entry(struct tx_queue_buffer_t* tx_queue_buffer, u8 reason, u16 queue_occupancy, u32 num_dropped){ return NULL; }
+
+void queue_checkin(dl_entry* tqe){
+    harness_num_checkin++;
+    free(tqe->data);
+    free(tqe);
+}
+
+%(prototypes)s
+"""
+
+HARNESS_API        = r"""
+void h_set_time(u64 time){ harness_time = time; }
+void h_set_mac_offset(s64 offset){ harness_mac_offset = offset; }
+u32  h_num_checkin(){ return harness_num_checkin; }
+
+void h_hist_add(queue_hist_t* hist, u32 value){ _queue_hist_add(hist, value); }
+u32  h_delay(u64 start_timestamp, u64 end_timestamp){ return _queue_delay(start_timestamp, end_timestamp); }
+u32  h_isqrt(u32 value){ return _queue_isqrt(value); }
+
+u64 h_control_law(u32 interval_usec, u32 count, u64 t){
+    queue_aqm_t  aqm;
+
+    memset(&aqm, 0, sizeof(aqm));
+    aqm.config.codel_interval_usec = interval_usec;
+    aqm.codel_count                = count;
+
+    return _queue_codel_control_law(&aqm, t);
+}
+
+// Enqueue a packet of a station;  returns the occupancy stored in its queue_info
+u32 h_enqueue(u16 queue_sel, u32 station){
+    dl_entry*           tqe = calloc(1, sizeof(dl_entry));
+    tx_queue_buffer_t*  tx_queue_buffer = calloc(1, sizeof(tx_queue_buffer_t));
+
+    tqe->data                    = tx_queue_buffer;
+    tx_queue_buffer->station_info = &(harness_stations[station]);
+
+    enqueue_after_tail(queue_sel, tqe);
+
+    return tx_queue_buffer->queue_info.occupancy;
+}
+
+// Dequeue a packet;  returns 1 and its enqueue timestamp, or 0 if no packet was returned
+int h_dequeue(u16 queue_sel, u64* enqueue_timestamp){
+    dl_entry*           tqe = dequeue_from_head(queue_sel);
+    tx_queue_buffer_t*  tx_queue_buffer;
+
+    if (tqe == NULL) { return 0; }
+
+    tx_queue_buffer = (tx_queue_buffer_t*)(tqe->data);
+    *enqueue_timestamp = tx_queue_buffer->queue_info.enqueue_timestamp;
+    tx_queue_buffer->station_info->num_tx_queued--;
+
+    free(tx_queue_buffer);
+    free(tqe);
+    return 1;
+}
+
+void h_tx_done(u16 queue_sel, u32 station, u64 enqueue_timestamp, u64 timestamp_done){
+    tx_frame_info_t  tx_frame_info;
+
+    memset(&tx_frame_info, 0, sizeof(tx_frame_info));
+    tx_frame_info.queue_info.id                = queue_sel;
+    tx_frame_info.queue_info.enqueue_timestamp = enqueue_timestamp;
+    tx_frame_info.timestamp_done               = timestamp_done;
+
+    queue_stats_mpdu_tx_done(&tx_frame_info, &(harness_stations[station]));
+}
+
+int h_set_lifetime(u16 queue_sel, u32 lifetime_usec){
+    queue_aqm_config_t  config;
+
+    memset(&config, 0, sizeof(config));
+    config.flags         = QUEUE_AQM_FLAG_LIFETIME;
+    config.lifetime_usec = lifetime_usec;
+
+    return queue_set_aqm_config(queue_sel, &config);
+}
+
+int h_set_codel(u16 queue_sel, u32 target_usec, u32 interval_usec){
+    queue_aqm_config_t  config;
+
+    memset(&config, 0, sizeof(config));
+    config.flags               = QUEUE_AQM_FLAG_CODEL;
+    config.codel_target_usec   = target_usec;
+    config.codel_interval_usec = interval_usec;
+
+    return queue_set_aqm_config(queue_sel, &config);
+}
+
+void h_purge(u16 queue_sel){ purge_queue(queue_sel); }
+
+int h_get_queue_stats(u16 queue_sel, queue_stats_t* stats){ return queue_get_stats(queue_sel, stats); }
+int h_get_station_stats(u32 station, queue_stats_t* stats){ return queue_get_station_stats(&(harness_stations[station]), stats); }
+"""
+
+
+def read_source(path):
+    with open(os.path.join(C_DEV_DIR, path), 'r') as f:
+        return f.read().replace('\r\n', '\n')
+
+
+def extract_function(path, name):
+    """Returns (signature, definition) of the C function name of the source file path."""
+    source  = read_source(path)
+    matches = list(re.finditer(r'^([A-Za-z_][^\n;{}]*?\b' + name + r'\s*\([^;{]*\))\s*\{', source, re.MULTILINE))
+
+    if (len(matches) != 1):
+        raise Exception("{0}: {1} definitions of {2}() found (expected 1)".format(path, len(matches), name))
+
+    match = matches[0]
+
+    depth = 0
+    for idx in range(match.end() - 1, len(source)):
+        if (source[idx] == '{'):
+            depth += 1
+        elif (source[idx] == '}'):
+            depth -= 1
+            if (depth == 0):
+                return (match.group(1), source[match.start():idx + 1])
+
+    raise Exception("{0}: end of function {1}() not found".format(path, name))
+
+
+def build_harness(build_dir):
+    """Compile the queue statistics code and the harness;  returns the ctypes library."""
+    inc_dir = os.path.join(build_dir, 'include')
+    os.mkdir(inc_dir)
+
+    # Host versions of the headers:  no Xilinx types, no struct size asserts
+    with open(os.path.join(inc_dir, 'xil_types.h'), 'w') as f:
+        f.write('#include <stdint.h>\n'
+                'typedef uint8_t u8;  typedef uint16_t u16;  typedef uint32_t u32;  typedef uint64_t u64;\n'
+                'typedef int8_t  s8;  typedef int16_t  s16;  typedef int32_t  s32;  typedef int64_t  s64;\n')
+
+    common_types = read_source('wlan_mac_common_framework/include/wlan_common_types.h')
+    (common_types, num_subs) = re.subn(r'#define ASSERT_TYPE_SIZE\(check_type, req_size\) \\\n[^\n]*\n', '#define ASSERT_TYPE_SIZE(check_type, req_size)\n', common_types)
+
+    if (num_subs != 1):
+        raise Exception("wlan_common_types.h: {0} definitions of ASSERT_TYPE_SIZE() found (expected 1)".format(num_subs))
+
+    with open(os.path.join(inc_dir, 'wlan_common_types.h'), 'w') as f:
+        f.write(common_types)
+
+    funcs = ([extract_function('wlan_mac_common_framework/wlan_mac_dl_list.c', n) for n in DL_LIST_FUNCS] +
+             [extract_function('wlan_mac_high_framework/wlan_mac_queue.c', n) for n in QUEUE_FUNCS])
+
+    source  = HARNESS_HEADER % {'num_stations' : NUM_STATIONS,
+                                'prototypes'   : '\n'.join(sig + ';' for (sig, _) in funcs)}
+    source += '\n\n'.join(definition for (_, definition) in funcs)
+    source += HARNESS_API
+
+    src_path = os.path.join(build_dir, 'queue_stats_harness.c')
+    lib_path = os.path.join(build_dir, 'queue_stats_harness.so')
+
+    with open(src_path, 'w') as f:
+        f.write(source)
+
+    cmd  = [os.environ.get('CC', 'cc'), '-std=gnu99', '-O1', '-Werror=implicit-function-declaration', '-shared', '-fPIC', '-o', lib_path, src_path, '-I' + inc_dir]
+    cmd += ['-I' + os.path.join(C_DEV_DIR, d) for d in INCLUDE_DIRS]
+
+    subprocess.check_call(cmd)
+
+    lib = ctypes.CDLL(lib_path)
+
+    lib.h_set_time.argtypes          = [ctypes.c_uint64]
+    lib.h_set_mac_offset.argtypes    = [ctypes.c_int64]
+    lib.h_delay.argtypes             = [ctypes.c_uint64, ctypes.c_uint64]
+    lib.h_delay.restype              = ctypes.c_uint32
+    lib.h_hist_add.argtypes          = [ctypes.POINTER(QueueHist), ctypes.c_uint32]
+    lib.h_isqrt.argtypes             = [ctypes.c_uint32]
+    lib.h_isqrt.restype              = ctypes.c_uint32
+    lib.h_control_law.argtypes       = [ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint64]
+    lib.h_control_law.restype        = ctypes.c_uint64
+    lib.h_enqueue.argtypes           = [ctypes.c_uint16, ctypes.c_uint32]
+    lib.h_enqueue.restype            = ctypes.c_uint32
+    lib.h_dequeue.argtypes           = [ctypes.c_uint16, ctypes.POINTER(ctypes.c_uint64)]
+    lib.h_tx_done.argtypes           = [ctypes.c_uint16, ctypes.c_uint32, ctypes.c_uint64, ctypes.c_uint64]
+    lib.h_set_lifetime.argtypes      = [ctypes.c_uint16, ctypes.c_uint32]
+    lib.h_set_codel.argtypes         = [ctypes.c_uint16, ctypes.c_uint32, ctypes.c_uint32]
+    lib.h_purge.argtypes             = [ctypes.c_uint16]
+    lib.h_get_queue_stats.argtypes   = [ctypes.c_uint16, ctypes.POINTER(QueueStats)]
+    lib.h_get_station_stats.argtypes = [ctypes.c_uint32, ctypes.POINTER(QueueStats)]
+
+    return lib
+
+
+def get_num_bins():
+    matches = re.findall(r'#define\s+QUEUE_STATS_NUM_BINS\s+(\d+)', read_source('wlan_mac_high_framework/include/wlan_mac_queue.h'))
+
+    if (len(matches) != 1):
+        raise Exception("wlan_mac_queue.h: {0} definitions of QUEUE_STATS_NUM_BINS found (expected 1)".format(len(matches)))
+
+    return int(matches[0])
+
+
+NUM_BINS           = get_num_bins()
+
+
+class QueueHist(ctypes.Structure):
+    _fields_ = [('max',  ctypes.c_uint32),
+                ('bins', ctypes.c_uint32 * NUM_BINS)]
+
+class QueueStats(ctypes.Structure):
+    _fields_ = [('sojourn',   QueueHist),
+                ('tx_done',   QueueHist),
+                ('occupancy', QueueHist)]
+
+# End class()
+
+
+#-----------------------------------------------------------------------------
+# Checks
+#-----------------------------------------------------------------------------
+def check(name, cond, detail=''):
+    print('{0:<62} | {1}'.format(name, 'OK' if cond else 'FAILED'))
+
+    if not cond:
+        raise Exception("Check failed: {0} {1}".format(name, detail))
+
+
+def expected_bins(values):
+    """Bins of values per the definition in wlan_mac_queue.h."""
+    bins = np.zeros(NUM_BINS, dtype=np.int64)
+
+    for v in values:
+        bins[0 if (v == 0) else min(int(v).bit_length(), NUM_BINS - 1)] += 1
+
+    return bins
+
+
+def hist_to_np(hist):
+    return np.array(hist.bins[:], dtype=np.int64)
+
+
+def get_stats(lib, queue_sel=None, station=None):
+    stats = QueueStats()
+
+    if queue_sel is not None:
+        ret = lib.h_get_queue_stats(queue_sel, ctypes.byref(stats))
+    else:
+        ret = lib.h_get_station_stats(station, ctypes.byref(stats))
+
+    if (ret != 0):
+        raise Exception("No queue statistics")
+
+    return stats
+
+
+def check_bins(lib):
+    last = NUM_BINS - 1
+
+    # Each edge:  0, then the first and last value of each bin
+    for n in range(1, NUM_BINS):
+        for value in [2**(n - 1), (2**n - 1) if (n < last) else 0xFFFFFFFF]:
+            hist = QueueHist()
+            lib.h_hist_add(ctypes.byref(hist), value)
+
+            if (hist_to_np(hist)[n] != 1) or (hist.max != value):
+                check('_queue_hist_add() bin {0}'.format(n), False, 'value {0}'.format(value))
+
+    hist = QueueHist()
+    lib.h_hist_add(ctypes.byref(hist), 0)
+    check('_queue_hist_add() bin 0 counts 0', (hist_to_np(hist)[0] == 1) and (hist.max == 0))
+    check('_queue_hist_add() bin N counts [2^(N-1), 2^N)', True)
+
+    hist = QueueHist()
+    for value in [2**(last - 1), 2**(last - 1) + 1, 2**last, 2**31, 0xFFFFFFFF]:
+        lib.h_hist_add(ctypes.byref(hist), value)
+    check('_queue_hist_add() last bin saturates at >= 2^{0}'.format(last - 1),
+          (hist_to_np(hist)[last] == 5) and (hist_to_np(hist).sum() == 5) and (hist.max == 0xFFFFFFFF))
+
+    # Random samples over all bins
+    rng    = np.random.RandomState(SEED)
+    values = (2.0 ** rng.uniform(0, 32, NUM_RANDOM)).astype(np.uint64) - 1
+    values = np.minimum(values, 0xFFFFFFFF)
+    hist   = QueueHist()
+
+    for value in values:
+        lib.h_hist_add(ctypes.byref(hist), int(value))
+
+    (np_bins, _) = np.histogram(values.astype(np.float64), bins=queue_stats_util.calc_bin_edges(NUM_BINS))
+
+    check('_queue_hist_add() of {0} random samples vs np.histogram()'.format(NUM_RANDOM),
+          np.array_equal(hist_to_np(hist), np_bins) and np.array_equal(np_bins, expected_bins(values)) and (hist.max == values.max()))
+
+
+def check_delay(lib):
+    check('_queue_delay() of a negative delay is 0', lib.h_delay(1000, 999) == 0)
+    check('_queue_delay() of a zero delay is 0',     lib.h_delay(1000, 1000) == 0)
+    check('_queue_delay() of a 15 us delay is 15',   lib.h_delay(2**40, 2**40 + 15) == 15)
+    check('_queue_delay() saturates at 0xFFFFFFFF',  (lib.h_delay(5, 5 + 2**32) == 0xFFFFFFFF) and (lib.h_delay(0, 2**40) == 0xFFFFFFFF))
+
+
+def check_accounting(lib):
+    queue_sel   = 3
+    num_packets = 40
+    rng         = np.random.RandomState(SEED)
+    time        = 10**6
+    occupancy   = []
+    stations    = []
+    sojourn     = []
+    tx_done     = []
+
+    # Enqueue a burst, then dequeue and transmit with random delays
+    for idx in range(num_packets):
+        time += int(rng.randint(0, 50))
+        lib.h_set_time(time)
+
+        station = idx % NUM_STATIONS
+        stations.append(station)
+        occupancy.append(lib.h_enqueue(queue_sel, station))
+
+    check('queue_info.occupancy is the queue length at enqueue', occupancy == list(range(1, num_packets + 1)))
+
+    enqueue_timestamp = ctypes.c_uint64()
+
+    for idx in range(num_packets):
+        time += int(2 ** rng.uniform(0, 24))
+        lib.h_set_time(time)
+
+        if not lib.h_dequeue(queue_sel, ctypes.byref(enqueue_timestamp)):
+            check('dequeue_from_head() returns every packet', False)
+
+        sojourn.append(time - enqueue_timestamp.value)
+
+        done = time + int(rng.randint(0, 3000))
+        lib.h_tx_done(queue_sel, stations[idx], enqueue_timestamp.value, done)
+        tx_done.append(done - enqueue_timestamp.value)
+
+    check('dequeue_from_head() of an empty queue', lib.h_dequeue(queue_sel, ctypes.byref(enqueue_timestamp)) == 0)
+
+    stats = get_stats(lib, queue_sel=queue_sel)
+
+    check('Queue occupancy histogram',
+          np.array_equal(hist_to_np(stats.occupancy), expected_bins(occupancy)) and (stats.occupancy.max == num_packets))
+    check('Queue sojourn histogram',
+          np.array_equal(hist_to_np(stats.sojourn), expected_bins(sojourn)) and (stats.sojourn.max == min(max(sojourn), 0xFFFFFFFF)))
+    check('Queue Tx done histogram',
+          np.array_equal(hist_to_np(stats.tx_done), expected_bins(tx_done)) and (stats.tx_done.max == max(tx_done)))
+
+    for station in range(NUM_STATIONS):
+        sel   = [i for i in range(num_packets) if (stations[i] == station)]
+        stats = get_stats(lib, station=station)
+
+        if not (np.array_equal(hist_to_np(stats.occupancy), expected_bins([occupancy[i] for i in sel])) and
+                np.array_equal(hist_to_np(stats.sojourn),   expected_bins([sojourn[i] for i in sel])) and
+                np.array_equal(hist_to_np(stats.tx_done),   expected_bins([tx_done[i] for i in sel]))):
+            check('Station {0} histograms'.format(station), False)
+
+    check('Station histograms ({0} stations)'.format(NUM_STATIONS), True)
+
+    # Queues below queue_sel were created with it and have no samples
+    stats = get_stats(lib, queue_sel=0)
+    check('Queues created by a larger queue ID start empty',
+          (hist_to_np(stats.occupancy).sum() == 0) and (hist_to_np(stats.sojourn).sum() == 0))
+
+
+def check_drops(lib):
+    queue_sel         = 5
+    lifetime          = 1000
+    enqueue_timestamp = ctypes.c_uint64()
+
+    if (lib.h_set_lifetime(queue_sel, lifetime) != 0):
+        raise Exception("Could not set the AQM policy")
+
+    # Three packets expire in the queue;  the fourth is dequeued after 500 us
+    time = 2 * 10**9
+
+    for idx in range(3):
+        lib.h_set_time(time + idx)
+        lib.h_enqueue(queue_sel, 0)
+
+    lib.h_set_time(time + 5000)
+    lib.h_enqueue(queue_sel, 0)
+
+    num_checkin  = lib.h_num_checkin()
+    station_prev = get_stats(lib, station=0)
+
+    lib.h_set_time(time + 5500)
+    returned = lib.h_dequeue(queue_sel, ctypes.byref(enqueue_timestamp))
+
+    stats    = get_stats(lib, queue_sel=queue_sel)
+    station  = get_stats(lib, station=0)
+    expected = expected_bins([500])
+
+    check('Lifetime drops are checked in',  (returned == 1) and (lib.h_num_checkin() - num_checkin == 3))
+    check('Lifetime drops not in the queue sojourn histogram',
+          np.array_equal(hist_to_np(stats.sojourn), expected) and (stats.sojourn.max == 500))
+    check('Lifetime drops not in the station sojourn histogram',
+          np.array_equal(hist_to_np(station.sojourn) - hist_to_np(station_prev.sojourn), expected))
+
+    # Purge
+    for idx in range(4):
+        lib.h_enqueue(queue_sel, 1)
+
+    num_checkin = lib.h_num_checkin()
+    lib.h_set_time(time + 10**6)
+    lib.h_purge(queue_sel)
+
+    check('purge_queue() not in the sojourn histograms',
+          (lib.h_num_checkin() - num_checkin == 4) and
+          np.array_equal(hist_to_np(get_stats(lib, queue_sel=queue_sel).sojourn), expected))
+
+
+def check_lifetime_mac_jump(lib):
+    queue_sel         = 6
+    lifetime          = 1000
+    enqueue_timestamp = ctypes.c_uint64()
+
+    if (lib.h_set_lifetime(queue_sel, lifetime) != 0):
+        raise Exception("Could not set the AQM policy")
+
+    time = 4 * 10**9
+
+    # MAC time moves backwards:  the first packet still expires
+    lib.h_set_time(time)
+    lib.h_enqueue(queue_sel, 0)
+    lib.h_set_time(time + 1500)
+    lib.h_enqueue(queue_sel, 0)
+
+    lib.h_set_mac_offset(-MAC_TIME_JUMP)
+    lib.h_set_time(time + 2000)
+
+    num_checkin = lib.h_num_checkin()
+    returned    = lib.h_dequeue(queue_sel, ctypes.byref(enqueue_timestamp))
+
+    check('Lifetime drop after the MAC time moved backwards',
+          (returned == 1) and (lib.h_num_checkin() - num_checkin == 1) and (enqueue_timestamp.value == time + 1500))
+
+    # MAC time moves forwards:  a young packet is not dropped
+    lib.h_set_mac_offset(0)
+    lib.h_enqueue(queue_sel, 0)
+
+    lib.h_set_mac_offset(MAC_TIME_JUMP)
+    lib.h_set_time(time + 2100)
+
+    num_checkin = lib.h_num_checkin()
+    returned    = lib.h_dequeue(queue_sel, ctypes.byref(enqueue_timestamp))
+
+    check('No lifetime drop after the MAC time moved forwards', (returned == 1) and (lib.h_num_checkin() == num_checkin))
+
+    lib.h_set_mac_offset(0)
+
+
+def check_isqrt(lib):
+    rng    = np.random.RandomState(SEED)
+    values = [0, 1, 2, 3, 4, 0xFFFF, 0x10000, 0xFFFFFFFF]
+    values += [(n * n) + d for n in (2, 255, 256, 65535) for d in (-1, 0, 1)]
+    values += [int(v) for v in rng.randint(0, 2**32, 10000, dtype=np.uint64)]
+
+    check('_queue_isqrt() of {0} values vs math.isqrt()'.format(len(values)),
+          all(lib.h_isqrt(v) == math.isqrt(v) for v in values))
+
+
+def check_control_law(lib):
+    t      = 5 * 10**9
+    errors = []
+
+    for count in range(1, 0x10000):
+        expected = CODEL_INTERVAL / math.sqrt(count)
+        delta    = lib.h_control_law(CODEL_INTERVAL, count, t) - t
+
+        # sqrt(count) is truncated to 8.8 fixed point, so the delay is at most 1 / 256 longer
+        if not ((expected - 1) <= delta <= (expected * 256.0 / 255.0)):
+            errors.append(count)
+
+    check('_queue_codel_control_law() is t + interval / sqrt(count)', (len(errors) == 0), 'count {0}'.format(errors[:5]))
+    check('_queue_codel_control_law() of count 0 is one interval',   lib.h_control_law(CODEL_INTERVAL, 0, t) == t + CODEL_INTERVAL)
+    check('_queue_codel_control_law() saturates at count 0xFFFF',
+          lib.h_control_law(CODEL_INTERVAL, 0x100000, t) == lib.h_control_law(CODEL_INTERVAL, 0xFFFF, t))
+
+
+def check_codel(lib):
+    queue_sel         = 7
+    rng               = np.random.RandomState(SEED)
+    enqueue_timestamp = ctypes.c_uint64()
+    drops             = []
+
+    if (lib.h_set_codel(queue_sel, CODEL_TARGET, CODEL_INTERVAL) != 0):
+        raise Exception("Could not set the AQM policy")
+
+    # Standing queue:  the sojourn time of every packet is CODEL_BACKLOG * CODEL_STEP
+    time = 6 * 10**9
+
+    for idx in range(CODEL_BACKLOG):
+        time += CODEL_STEP
+        lib.h_set_time(time)
+        lib.h_enqueue(queue_sel, 2)
+
+    first_dequeue = time + CODEL_STEP
+
+    for idx in range(CODEL_DURATION // CODEL_STEP):
+        time += CODEL_STEP
+        lib.h_set_time(time)
+        lib.h_set_mac_offset(int(rng.randint(-MAC_TIME_JUMP, MAC_TIME_JUMP)))
+        lib.h_enqueue(queue_sel, 2)
+
+        num_checkin = lib.h_num_checkin()
+
+        if not lib.h_dequeue(queue_sel, ctypes.byref(enqueue_timestamp)):
+            check('CoDel returns a packet of the standing queue', False, 'time {0}'.format(time))
+
+        drops += [time] * (lib.h_num_checkin() - num_checkin)
+
+    lib.h_set_mac_offset(0)
+
+    # RFC 8289:  the sojourn time is above target from the first dequeue, so the first drop
+    # is one interval later.  The next drop is scheduled interval / sqrt(count) after the
+    # previous one, where count is the number of drops so far.  Each drop happens at the
+    # first dequeue at or after its scheduled time.
+    check('CoDel drops a standing queue ({0} drops)'.format(len(drops)), len(drops) > 10)
+    check('CoDel first drop one interval after sojourn > target',
+          drops[0] == first_dequeue + CODEL_INTERVAL, 'first drop at +{0} us'.format(drops[0] - first_dequeue))
+    check('CoDel second drop one interval after the first', drops[1] == drops[0] + CODEL_INTERVAL)
+
+    errors = []
+
+    for count in range(2, len(drops)):
+        expected = CODEL_INTERVAL / math.sqrt(count)
+        gap      = drops[count] - drops[count - 1]
+
+        # Drops happen up to one step after their scheduled time;  the control law is at most 1 / 256 longer
+        if not ((expected - CODEL_STEP) < gap < (expected * 256.0 / 255.0) + CODEL_STEP):
+            errors.append((count, gap, expected))
+
+    check('CoDel drop {0} to {1} every interval / sqrt(count)'.format(3, len(drops)), (len(errors) == 0), str(errors[:3]))
+
+
+#-----------------------------------------------------------------------------
+# Main script
+#-----------------------------------------------------------------------------
+if __name__ == '__main__':
+
+    build_dir = tempfile.mkdtemp()
+
+    try:
+        lib = build_harness(build_dir)
+
+        print('QUEUE_STATS_NUM_BINS = {0}\n'.format(NUM_BINS))
+        print('{0:<62} | {1}'.format('Check', 'Result'))
+        print('-' * 72)
+
+        check_bins(lib)
+        check_delay(lib)
+        check_accounting(lib)
+        check_drops(lib)
+        check_lifetime_mac_jump(lib)
+        check_isqrt(lib)
+        check_control_law(lib)
+        check_codel(lib)
+
+    finally:
+        shutil.rmtree(build_dir)
+
+    print('')
@@ -19,14 +19,15 @@ __all__ = [# Log command classes
            'LogGetEvents', 'LogConfigure', 'LogGetStatus', 'LogGetCapacity', 
            'LogAddExpInfoEntry',
            # Counts command classes
-           'CountsConfigure', 'CountsGetTxRx',
+           'CountsConfigure', 'CountsGetTxRx', 'CountsGetTxRxDelta',
            # LTG classes
            'LTGConfigure', 'LTGStart', 'LTGStop', 'LTGRemove', 'LTGStatus',
            # Node command classes
            'NodeResetState', 'NodeConfigure', 'NodeProcWLANMACAddr', 
            'NodeProcTime', 'NodeSetLowToHighFilter', 'NodeProcRandomSeed', 
            'NodeLowParam', 'NodeProcTxPower', 'NodeProcTxRate', 
-           'NodeProcTxAntMode', 'NodeProcRxAntMode',
+           'NodeProcTxAntMode', 'NodeProcRxAntMode', 'NodeGetMemPoolInfo',
+           'NodeProfile', 'NodeQueueStats', 'NodeQueueAqm',
            # Scan command classes
            'NodeProcScanParam', 'NodeProcScan', 
            # Association command classes
@@ -62,6 +63,10 @@ CMDID_NODE_LOW_TO_HIGH_FILTER                    = 0x001016
 CMDID_NODE_RANDOM_SEED                           = 0x001017
 CMDID_NODE_WLAN_MAC_ADDR                         = 0x001018
 CMDID_NODE_LOW_PARAM                             = 0x001020
+CMDID_NODE_GET_MEM_POOL_INFO                     = 0x001030
+CMDID_NODE_PROFILE                               = 0x001031
+CMDID_NODE_QUEUE_STATS                           = 0x001032
+CMDID_NODE_QUEUE_AQM                             = 0x001033
 
 CMD_PARAM_WRITE                                  = 0x00000000
 CMD_PARAM_READ                                   = 0x00000001
@@ -71,6 +76,37 @@ CMD_PARAM_SUCCESS                                = 0x00000000
 CMD_PARAM_WARNING                                = 0xF0000000
 CMD_PARAM_ERROR                                  = 0xFF000000
 
+# Memory pool names (in the order of the MEM_POOL_* IDs in wlan_mac_pool.h)
+MEM_POOL_NAMES                                   = ['dl_entry', 'schedule', 'ltg', 'ltg_params', 'ltg_payload',
+                                                    'addr_range', 'station_entry', 'network_entry', 'arena', 'heap']
+MEM_POOL_INFO_FIELDS                             = ['obj_size', 'num_total', 'num_live', 'max_live',
+                                                    'num_alloc', 'num_fallback', 'num_failed']
+
+# Profiling probe names (in the order of the PROF_PROBE_* IDs in wlan_mac_prof.h)
+CMD_PARAM_NODE_PROFILE_RESET                     = 0x00000002
+CMD_PARAM_NODE_PROFILE_CPU_HIGH                  = 0x00000000
+CMD_PARAM_NODE_PROFILE_CPU_LOW                   = 0x00000001
+
+PROF_PROBE_NAMES                                 = ['frame_receive', 'frame_transmit_general', 'mpdu_transmit',
+                                                    'poll_tx_queues', 'eth_rx', 'event_log_get_next_empty_address',
+                                                    'schedule_handler']
+
+# Tx queue statistics (in the order of the histograms of queue_stats_t in wlan_mac_queue.h)
+CMD_PARAM_NODE_QUEUE_STATS_RESET                 = 0x00000002
+CMD_PARAM_NODE_QUEUE_STATS_QUEUE                 = 0x00000000
+CMD_PARAM_NODE_QUEUE_STATS_STATION               = 0x00000001
+
+QUEUE_STATS_HIST_NAMES                           = ['sojourn', 'tx_done', 'occupancy']
+
+# Tx queue AQM policies (see QUEUE_AQM_FLAG_* and QUEUE_DROP_REASON_* in wlan_mac_queue.h)
+CMD_PARAM_NODE_QUEUE_AQM_RESET_COUNTS            = 0x00000002
+
+QUEUE_AQM_FLAG_HEAD_DROP                         = 0x00000001
+QUEUE_AQM_FLAG_LIFETIME                          = 0x00000002
+QUEUE_AQM_FLAG_CODEL                             = 0x00000004
+
+QUEUE_DROP_REASON_NAMES                          = ['tail', 'head', 'lifetime', 'codel']
+
 #Note: the following are used as bit masks on the node side
 CMD_PARAM_TXPARAM_DATA                           = 0x00000001
 CMD_PARAM_TXPARAM_MGMT                           = 0x00000002
@@ -137,6 +173,8 @@ CMD_PARAM_LOW_PARAM_LINEARITY_UPCONV             = 0x00000004
 CMD_PARAM_LOW_PARAM_AD_SCALING                   = 0x00000005
 CMD_PARAM_LOW_PARAM_PKT_DET_MIN_POWER            = 0x00000006
 CMD_PARAM_LOW_PARAM_PHY_SAMPLE_RATE              = 0x00000008
+CMD_PARAM_LOW_PARAM_TX_REPORT_COALESCE           = 0x00000009
+CMD_PARAM_LOW_PARAM_PROF_RESET                   = 0x0000000A
 CMD_PARAM_LOW_PARAM_DSSS_PKT_DET_THRESH          = 0x0000A000
 CMD_PARAM_LOW_PARAM_OFDM_PKT_DET_THRESH          = 0x0000B000
 
@@ -186,18 +224,33 @@ CMD_PARAM_LOG_CONFIG_FLAG_WRAP                   = 0x00000002
 CMD_PARAM_LOG_CONFIG_FLAG_LOG_PAYLOADS           = 0x00000004
 CMD_PARAM_LOG_CONFIG_FLAG_TXRX_MPDU              = 0x00000008
 CMD_PARAM_LOG_CONFIG_FLAG_TXRX_CTRL              = 0x00000010
+CMD_PARAM_LOG_CONFIG_FLAG_TXRX_TRACE             = 0x00000020
 
 
 # Counts commands and defined values
 CMDID_COUNTS_GET_TXRX                            = 0x004001
+CMDID_COUNTS_GET_TXRX_DELTA                      = 0x004002
+CMDID_COUNTS_GET_RX_PKT_BUF                      = 0x004003
 
 CMD_PARAM_COUNTS_CONFIG_FLAG_PROMISC             = 0x00000001
 
 CMD_PARAM_COUNTS_RETURN_ZEROED_IF_NONE           = 0x80000000
 
+CMD_PARAM_COUNTS_DELTA_GEN_ALL                   = 0x00000000
+
+COUNTS_RX_PKT_BUF_FIELDS                         = ['num_rx_pkt_bufs', 'num_rx', 'num_overrun', 'num_batches', 'max_batch']
+
+CMD_PARAM_COUNTS_DELTA_FLAG_DATA                 = 0x01
+CMD_PARAM_COUNTS_DELTA_FLAG_MGMT                 = 0x02
+
 
 # Queue commands and defined values
 CMDID_QUEUE_TX_DATA_PURGE_ALL                    = 0x005000
+CMDID_QUEUE_GET_BUFFER_INFO                      = 0x005001
+
+QUEUE_BUFFER_CLASS_NAMES                         = ['small', 'medium', 'large']
+QUEUE_BUFFER_INFO_FIELDS                         = ['buffer_size', 'max_frame_len', 'num_total', 'num_free',
+                                                    'min_free', 'num_fallback', 'num_failed']
 
 
 # Scan commands and defined values
@@ -287,10 +340,11 @@ class LogConfigure(message.Cmd):
         log_full_payloads    -- Record full Tx/Rx payloads in event log (True/FALSE)
         log_txrx_mpdu        -- Enable Tx/Rx log entries for MPDU frames (TRUE/False)
         log_txrx_ctrl        -- Enable Tx/Rx log entries for CTRL frames (TRUE/False)
+        log_txrx_trace       -- Enable Tx/Rx latency trace log entries (True/FALSE)
     """
     def __init__(self, log_enable=None, log_wrap_enable=None,
                        log_full_payloads=None, log_txrx_mpdu=None, 
-                       log_txrx_ctrl=None):
+                       log_txrx_ctrl=None, log_txrx_trace=None):
         super(LogConfigure, self).__init__()
         self.command = _CMD_GROUP_NODE + CMDID_LOG_CONFIG
 
@@ -322,6 +376,11 @@ class LogConfigure(message.Cmd):
             if log_txrx_ctrl:
                 flags += CMD_PARAM_LOG_CONFIG_FLAG_TXRX_CTRL
 
+        if log_txrx_trace is not None:
+            mask += CMD_PARAM_LOG_CONFIG_FLAG_TXRX_TRACE
+            if log_txrx_trace:
+                flags += CMD_PARAM_LOG_CONFIG_FLAG_TXRX_TRACE
+
         self.add_args(flags)
         self.add_args(mask)
 
@@ -434,6 +493,96 @@ class CountsGetTxRx(message.BufferCmd):
 # End Class
 
 
+class CountsGetTxRxDelta(message.BufferCmd):
+    """Command to get the Tx / Rx counts that changed since a counts generation.
+
+    Attributes:
+        generation -- Counts generation returned by the previous delta
+            (CMD_PARAM_COUNTS_DELTA_GEN_ALL to get all counts)
+
+    The response is a dictionary:
+        'generation' -- Counts generation of this delta
+        'timestamp'  -- Value of System Time in microseconds when the delta was taken
+        'entries'    -- List of (mac_addr, flags, data, mgmt) tuples where
+                        data / mgmt are the raw bytes of the changed counts
+                        (None if that part of the counts did not change)
+
+    or None if the delta was not received completely.
+    """
+    hdr_fmt   = 'Q I I'
+    entry_fmt = '6s B x'
+    sub_size  = 56
+
+    def __init__(self, generation=CMD_PARAM_COUNTS_DELTA_GEN_ALL):
+        super(CountsGetTxRxDelta, self).__init__()
+        self.command = _CMD_GROUP_NODE + CMDID_COUNTS_GET_TXRX_DELTA
+
+        self.add_args(generation)
+
+
+    def process_resp(self, resp):
+        import struct
+
+        data = resp.get_bytes()
+
+        # A partial delta cannot be used since the generation would skip the
+        # missing counts
+        if not resp.is_buffer_complete():
+            return None
+
+        hdr_size   = struct.calcsize(self.hdr_fmt)
+        entry_size = struct.calcsize(self.entry_fmt)
+
+        (timestamp, generation, _) = struct.unpack(self.hdr_fmt, data[:hdr_size])
+
+        entries = []
+        index   = hdr_size
+
+        while ((index + entry_size) <= len(data)):
+            (mac_addr, flags) = struct.unpack(self.entry_fmt, data[index:index + entry_size])
+            index += entry_size
+
+            # Entries with no flags are padding
+            if (flags == 0):
+                continue
+
+            data_counts = None
+            mgmt_counts = None
+
+            if (flags & CMD_PARAM_COUNTS_DELTA_FLAG_DATA):
+                data_counts = data[index:index + self.sub_size]
+                index      += self.sub_size
+
+            if (flags & CMD_PARAM_COUNTS_DELTA_FLAG_MGMT):
+                mgmt_counts = data[index:index + self.sub_size]
+                index      += self.sub_size
+
+            entries.append((mac_addr, flags, data_counts, mgmt_counts))
+
+        return {'generation' : generation, 'timestamp' : timestamp, 'entries' : entries}
+
+# End Class
+
+
+class CountsGetRxPktBuf(message.Cmd):
+    """Command to get the Rx packet buffer counts (depth, receptions, overruns)."""
+    def __init__(self):
+        super(CountsGetRxPktBuf, self).__init__()
+        self.command = _CMD_GROUP_NODE + CMDID_COUNTS_GET_RX_PKT_BUF
+
+        self.add_args(0)
+
+    def process_resp(self, resp):
+        args = resp.get_args()
+
+        if resp.resp_is_valid(num_args=len(COUNTS_RX_PKT_BUF_FIELDS)):
+            return dict(zip(COUNTS_RX_PKT_BUF_FIELDS, args))
+        else:
+            return None
+
+# End Class
+
+
 
 #--------------------------------------------
 # Local Traffic Generation (LTG) Commands
@@ -1478,6 +1627,212 @@ class NodeProcRxAntMode(message.Cmd):
 # End Class
 
 
+class NodeGetMemPoolInfo(message.Cmd):
+    """Command to get the allocation statistics of the memory pools."""
+    def __init__(self):
+        super(NodeGetMemPoolInfo, self).__init__()
+        self.command = _CMD_GROUP_NODE + CMDID_NODE_GET_MEM_POOL_INFO
+
+        self.add_args(0)
+
+    def process_resp(self, resp):
+        num_fields = len(MEM_POOL_INFO_FIELDS)
+
+        args = resp.get_args()
+
+        if resp.resp_is_valid() and args:
+            num_pools = args[0]
+
+            if (len(args) != (1 + num_pools * num_fields)):
+                raise Exception("ERROR: Unexpected number of memory pool info arguments: {0}".format(len(args)))
+
+            ret_val = {}
+
+            for idx in range(num_pools):
+                pool_args = args[1 + idx * num_fields : 1 + (idx + 1) * num_fields]
+
+                if (idx < len(MEM_POOL_NAMES)):
+                    name = MEM_POOL_NAMES[idx]
+                else:
+                    name = 'pool_{0}'.format(idx)
+
+                ret_val[name] = dict(zip(MEM_POOL_INFO_FIELDS, pool_args))
+
+            return ret_val
+        else:
+            return {}
+
+# End Class
+
+
+class NodeProfile(message.Cmd):
+    """Command to read or reset the profiling probes of CPU High or CPU Low.
+
+    Attributes:
+        cmd -- CMD_PARAM_READ or CMD_PARAM_NODE_PROFILE_RESET
+        cpu -- CMD_PARAM_NODE_PROFILE_CPU_HIGH or CMD_PARAM_NODE_PROFILE_CPU_LOW
+    """
+    num_hdr_args = 4
+
+    def __init__(self, cmd=CMD_PARAM_READ, cpu=CMD_PARAM_NODE_PROFILE_CPU_HIGH):
+        super(NodeProfile, self).__init__()
+        self.command = _CMD_GROUP_NODE + CMDID_NODE_PROFILE
+
+        self.add_args(cmd)
+        self.add_args(cpu)
+
+    def process_resp(self, resp):
+        args = resp.get_args()
+
+        if not resp.resp_is_valid() or (len(args) < self.num_hdr_args):
+            return None
+
+        (status, ticks_per_us, num_probes, num_bins) = args[0:self.num_hdr_args]
+
+        if (status != CMD_PARAM_SUCCESS):
+            return None
+
+        num_fields = 5 + num_bins
+
+        if (len(args) != (self.num_hdr_args + num_probes * num_fields)):
+            raise Exception("ERROR: Unexpected number of profiling arguments: {0}".format(len(args)))
+
+        probes = {}
+
+        for idx in range(num_probes):
+            probe_args = args[self.num_hdr_args + idx * num_fields : self.num_hdr_args + (idx + 1) * num_fields]
+
+            if (idx < len(PROF_PROBE_NAMES)):
+                name = PROF_PROBE_NAMES[idx]
+            else:
+                name = 'probe_{0}'.format(idx)
+
+            probes[name] = {'num_samples' : probe_args[0],
+                            'min_ticks'   : probe_args[1],
+                            'max_ticks'   : probe_args[2],
+                            'total_ticks' : (probe_args[3] << 32) + probe_args[4],
+                            'bins'        : list(probe_args[5:])}
+
+        return {'ticks_per_us' : ticks_per_us, 'probes' : probes}
+
+# End Class
+
+
+class NodeQueueStats(message.Cmd):
+    """Command to read the Tx queue statistics of a queue or a station, or
+    to reset all Tx queue statistics.
+
+    Attributes:
+        cmd         -- CMD_PARAM_READ or CMD_PARAM_NODE_QUEUE_STATS_RESET
+        queue_id    -- ID of the queue (optional)
+        mac_address -- MAC address of the station (optional; used instead of queue_id)
+    """
+    num_hdr_args = 2
+
+    def __init__(self, cmd=CMD_PARAM_READ, queue_id=None, mac_address=None):
+        super(NodeQueueStats, self).__init__()
+        self.command = _CMD_GROUP_NODE + CMDID_NODE_QUEUE_STATS
+
+        self.add_args(cmd)
+
+        if mac_address is not None:
+            self.add_args(CMD_PARAM_NODE_QUEUE_STATS_STATION)
+            self.add_args(CMD_PARAM_RSVD)
+        else:
+            self.add_args(CMD_PARAM_NODE_QUEUE_STATS_QUEUE)
+            self.add_args(queue_id if queue_id is not None else CMD_PARAM_RSVD)
+
+        _add_mac_address_to_cmd(self, mac_address)
+
+    def process_resp(self, resp):
+        args = resp.get_args()
+
+        if not resp.resp_is_valid() or (len(args) < self.num_hdr_args):
+            return None
+
+        (status, num_bins) = args[0:self.num_hdr_args]
+
+        if (status != CMD_PARAM_SUCCESS) or (num_bins == 0):
+            return None
+
+        num_fields = 1 + num_bins
+
+        if (len(args) != (self.num_hdr_args + len(QUEUE_STATS_HIST_NAMES) * num_fields)):
+            raise Exception("ERROR: Unexpected number of queue statistics arguments: {0}".format(len(args)))
+
+        stats = {}
+
+        for (idx, name) in enumerate(QUEUE_STATS_HIST_NAMES):
+            hist_args = args[self.num_hdr_args + idx * num_fields : self.num_hdr_args + (idx + 1) * num_fields]
+
+            stats[name] = {'max'  : hist_args[0],
+                           'bins' : list(hist_args[1:])}
+
+        return stats
+
+# End Class
+
+
+class NodeQueueAqm(message.Cmd):
+    """Command to set / get the AQM policy of a Tx queue, or to reset the
+    drop counters of the queue.
+
+    Attributes:
+        cmd                 -- CMD_PARAM_WRITE, CMD_PARAM_READ or
+                               CMD_PARAM_NODE_QUEUE_AQM_RESET_COUNTS
+        queue_id            -- ID of the queue
+        flags               -- QUEUE_AQM_FLAG_* (CMD_PARAM_WRITE)
+        max_length          -- Max number of packets in the queue; 0 to use the
+                               limit of the MAC application (CMD_PARAM_WRITE)
+        lifetime            -- Max time (in float sec) between enqueue and
+                               dequeue (CMD_PARAM_WRITE)
+        codel_target        -- CoDel target sojourn time (in float sec); 0 for
+                               the default (CMD_PARAM_WRITE)
+        codel_interval      -- CoDel interval (in float sec); 0 for the
+                               default (CMD_PARAM_WRITE)
+    """
+    num_resp_args = 12
+
+    def __init__(self, cmd, queue_id, flags=0, max_length=0, lifetime=0, codel_target=0, codel_interval=0):
+        super(NodeQueueAqm, self).__init__()
+        self.command = _CMD_GROUP_NODE + CMDID_NODE_QUEUE_AQM
+
+        self.add_args(cmd)
+        self.add_args(queue_id)
+
+        if (cmd == CMD_PARAM_WRITE):
+            self.add_args(flags)
+            self.add_args(max_length)
+            self.add_args(int(round(lifetime * 10**6)))
+            self.add_args(int(round(codel_target * 10**6)))
+            self.add_args(int(round(codel_interval * 10**6)))
+
+    def process_resp(self, resp):
+        args = resp.get_args()
+
+        if not resp.resp_is_valid() or (len(args) != self.num_resp_args):
+            raise Exception("ERROR: Unexpected response to the Tx queue AQM command")
+
+        if (args[0] != CMD_PARAM_SUCCESS):
+            raise Exception("ERROR: Could not set / get the AQM policy of the Tx queue (see the node's UART output)")
+
+        (flags, max_length, lifetime, codel_target, codel_interval) = args[1:6]
+
+        aqm = {'head_drop'      : bool(flags & QUEUE_AQM_FLAG_HEAD_DROP),
+               'lifetime'       : (lifetime / float(10**6)) if (flags & QUEUE_AQM_FLAG_LIFETIME) else None,
+               'codel'          : bool(flags & QUEUE_AQM_FLAG_CODEL),
+               'codel_target'   : codel_target / float(10**6),
+               'codel_interval' : codel_interval / float(10**6),
+               'max_length'     : max_length if max_length else None,
+               'num_dropped'    : dict(zip(QUEUE_DROP_REASON_NAMES, args[6:10])),
+               'codel_dropping' : bool(args[10]),
+               'codel_count'    : args[11]}
+
+        return aqm
+
+# End Class
+
+
 
 #--------------------------------------------
 # Scan Commands
@@ -1807,6 +2162,45 @@ class QueueTxDataPurgeAll(message.Cmd):
 # End Class
 
 
+class QueueGetBufferInfo(message.Cmd):
+    """Command to get the occupancy of each Tx queue buffer size class."""
+    def __init__(self):
+        super(QueueGetBufferInfo, self).__init__()
+        self.command = _CMD_GROUP_NODE + CMDID_QUEUE_GET_BUFFER_INFO
+
+        self.add_args(0)
+
+    def process_resp(self, resp):
+        num_fields = len(QUEUE_BUFFER_INFO_FIELDS)
+
+        args = resp.get_args()
+
+        if resp.resp_is_valid() and args:
+            num_classes = args[0]
+
+            if (len(args) != (1 + num_classes * num_fields)):
+                raise Exception("ERROR: Unexpected number of Tx queue buffer info arguments: {0}".format(len(args)))
+
+            ret_val = []
+
+            for idx in range(num_classes):
+                class_args = args[1 + idx * num_fields : 1 + (idx + 1) * num_fields]
+                class_info = dict(zip(QUEUE_BUFFER_INFO_FIELDS, class_args))
+
+                if (idx < len(QUEUE_BUFFER_CLASS_NAMES)):
+                    class_info['name'] = QUEUE_BUFFER_CLASS_NAMES[idx]
+                else:
+                    class_info['name'] = 'class_{0}'.format(idx)
+
+                ret_val.append(class_info)
+
+            return ret_val
+        else:
+            return []
+
+# End Class
+
+
 
 #--------------------------------------------
 # AP Specific Commands
@@ -21,8 +21,8 @@ def _collision_idx_finder_binarysearch(src_ts, src_dur, int_ts, int_dur):
     num_int = int_ts.shape[0]
     
     maxlen = num_src+num_int
-    src_coll_idx = np.zeros([maxlen],dtype=np.int)
-    int_coll_idx = np.zeros([maxlen],dtype=np.int)       
+    src_coll_idx = np.zeros([maxlen],dtype=np.int64)
+    int_coll_idx = np.zeros([maxlen],dtype=np.int64)       
     
     coll_index = 0;
     
@@ -94,8 +94,8 @@ def _collision_idx_finder_linearsearch(src_ts, src_dur, int_ts, int_dur):
     num_int = int_ts.shape[0]
     
     maxlen = num_src+num_int
-    src_coll_idx = np.zeros([maxlen],dtype=np.int)
-    int_coll_idx = np.zeros([maxlen],dtype=np.int)
+    src_coll_idx = np.zeros([maxlen],dtype=np.int64)
+    int_coll_idx = np.zeros([maxlen],dtype=np.int64)
     
     int_idx_start = 0
     coll_index = 0
@@ -156,3 +156,91 @@ def _collision_idx_finder(src_ts, src_dur, int_ts, int_dur):
         return _collision_idx_finder_linearsearch(src_ts, src_dur, int_ts, int_dur)
 
 # End def
+
+
+
+def _collision_sweep(start, end, group, num_threads=None, num_partitions=None):
+    """Sweep-line search for overlapping intervals from different groups.
+
+    Args:
+        start (Numpy Array):  Start time of each interval
+        end (Numpy Array):    End time of each interval (exclusive)
+        group (Numpy Array):  Group (ie node) of each interval; overlaps within a
+            group are ignored
+        num_threads (int, optional):     Number of worker threads (default is the number of CPUs)
+        num_partitions (int, optional):  Number of time partitions (default is 4 per thread)
+
+    Returns:
+        overlaps (tuple):
+            Tuple of (a_idx, b_idx, overlap) where a_idx / b_idx are indexes into
+            the input arrays of each overlapping pair (start[a_idx] <= start[b_idx])
+            and overlap is the duration of the overlap
+
+    All intervals are sorted by start time once.  Interval i then overlaps
+    every later interval j with start[j] < end[i], so the overlapping pairs
+    of i are the contiguous range (i, k_i) where k_i is found with a binary
+    search.  The sorted intervals are split into partitions that are processed
+    in parallel; NumPy releases the GIL for the bulk of the work.
+    """
+    from multiprocessing.pool import ThreadPool
+    import multiprocessing
+
+    start = np.asarray(start, dtype=np.int64)
+    end   = np.asarray(end, dtype=np.int64)
+    group = np.asarray(group)
+
+    num_int = start.shape[0]
+
+    if num_threads is None:
+        num_threads = multiprocessing.cpu_count()
+
+    if num_partitions is None:
+        num_partitions = 4 * num_threads
+
+    order   = np.argsort(start, kind='mergesort')
+    s_start = start[order]
+    s_end   = end[order]
+    s_group = group[order]
+
+    # Index of the first interval that starts at or after the end of each interval
+    k = np.maximum(np.searchsorted(s_start, s_end, side='left'), np.arange(1, num_int + 1))
+
+    def sweep_partition(bounds):
+        (p_start, p_end) = bounds
+
+        i      = np.arange(p_start, p_end)
+        counts = k[p_start:p_end] - i - 1
+        total  = int(counts.sum())
+
+        if (total == 0):
+            return (np.empty((0,), dtype=np.int64),) * 3
+
+        # Expand (i, k_i) ranges into all (i, j) pairs
+        a = np.repeat(i, counts)
+        b = a + 1 + (np.arange(total) - np.repeat(np.cumsum(counts) - counts, counts))
+
+        keep = (s_group[a] != s_group[b])
+        a    = a[keep]
+        b    = b[keep]
+
+        overlap = np.minimum(s_end[a], s_end[b]) - s_start[b]
+
+        return (order[a], order[b], overlap)
+
+    bounds = np.linspace(0, num_int, min(num_partitions, max(num_int, 1)) + 1).astype(np.int64)
+    bounds = list(zip(bounds[:-1], bounds[1:]))
+
+    if (num_threads > 1) and (len(bounds) > 1):
+        pool    = ThreadPool(num_threads)
+        results = pool.map(sweep_partition, bounds)
+        pool.close()
+        pool.join()
+    else:
+        results = [sweep_partition(b) for b in bounds]
+
+    if not results:
+        return (np.empty((0,), dtype=np.int64),) * 3
+
+    return tuple(np.concatenate([r[x] for r in results]) for x in range(3))
+
+# End def
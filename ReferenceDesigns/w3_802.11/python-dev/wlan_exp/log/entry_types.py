@@ -82,6 +82,11 @@ ENTRY_TYPE_TX_HIGH_LTG            = 21
 ENTRY_TYPE_TX_LOW                 = 25
 ENTRY_TYPE_TX_LOW_LTG             = 26
 
+ENTRY_TYPE_TX_TRACE               = 30
+ENTRY_TYPE_RX_TRACE               = 31
+
+ENTRY_TYPE_TX_DROP                = 35
+
 # -----------------------------------------------------------------------------
 # Log Entry Type Container
 # -----------------------------------------------------------------------------
@@ -138,6 +143,7 @@ class WlanExpLogEntryType(object):
 
         # Initialize unpack variables
         self.fields_fmt_struct   = ''
+        self._fields_struct      = None
 
         # Initialize callbacks
         self.gen_numpy_callbacks = []
@@ -250,10 +256,7 @@ class WlanExpLogEntryType(object):
         """Generate a NumPy array from the log_bytes of the given WlanExpLogEntryType instance
         at the given byte_offsets.
         """
-        import numpy as np
-
-        index_iter = [log_data[o : o + self.fields_np_dt.itemsize] for o in byte_offsets]
-        np_arr = np.fromiter(index_iter, self.fields_np_dt, len(byte_offsets))
+        np_arr = self.deserialize_np(log_data, byte_offsets)
 
         if self.gen_numpy_callbacks:
             for callback in self.gen_numpy_callbacks:
@@ -375,11 +378,10 @@ class WlanExpLogEntryType(object):
         This method should only be used for debugging log data parsing and log 
         index generation, not for general creation of text log files.
 
-        This method does not work correctly on RX_OFDM entries due to the way 
-        the channel estimates are defined.  The channel_est, mac_payload_len, 
-        and mac_payload will all be zeros.
+        Array fields (e.g. the channel_est of RX_OFDM entries) are printed as
+        a list of values.
         """
-        entry_size = calcsize(self.fields_fmt_struct)
+        entry_size = self.fields_np_dt.itemsize
         entry      = self.deserialize(buf[0:entry_size])[0]
 
         str_out = self.name + ': '
@@ -388,8 +390,11 @@ class WlanExpLogEntryType(object):
             s = entry[k]
             if((type(s) is int) or (type(s) is long)):
                 str_out += "\n    {0:30s} = {1:20d} (0x{1:16x})".format(k, s)
-            elif(type(s) is str):
-                s = map(ord, list(entry[k]))
+            elif(type(s) in (str, bytes, list)):
+                if (type(s) is str):
+                    s = map(ord, list(entry[k]))
+                elif (type(s) is bytes):
+                    s = bytearray(s)
                 str_out += "\n    {0:30s} = [".format(k)
                 for x in s:
                     str_out += "{0:d}, ".format(x)
@@ -435,32 +440,46 @@ class WlanExpLogEntryType(object):
             entries (List of dict):
                 Each dictionary in the list has one value per field in the log entry definition using
                 the field names as keys.
+
+        String fields (e.g. '44s') are returned as bytes and array fields (e.g. '256B') as a
+        list of values.  Use ``deserialize_np()`` to unpack entries in to a numpy array instead.
         """
+        import numpy as np
         from collections import OrderedDict
 
-        ret_val    = []
-        buf_size   = len(buf)
-        entry_size = calcsize(self.fields_fmt_struct)
-        index      = 0
+        entry_size  = self.fields_np_dt.itemsize
+        num_entries = len(buf) // entry_size
 
-        while (index < buf_size):
-            try:
-                dataTuple = unpack(self.fields_fmt_struct, buf[index:index+entry_size])
-                all_names = self.get_field_names()
-                all_fmts  = self.get_field_struct_formats()
+        if (len(buf) % entry_size):
+            print("Error unpacking {0} buffer with len {1}: {2} extra bytes".format(self.name, len(buf), len(buf) % entry_size))
+
+        # Entry types without array fields are unpacked with a single struct.iter_unpack()
+        fields_struct = self._get_fields_struct()
+
+        if fields_struct is not None:
+            names = [f[0] for f in self._get_field_layout()]
+
+            return [OrderedDict(zip(names, values)) for values in fields_struct.iter_unpack(buf[:num_entries * entry_size])]
 
-                # Filter out names for fields ignored during unpacking
-                names = [n for (n,f) in zip(all_names, all_fmts) if 'x' not in f]
+        raw     = np.frombuffer(buf, dtype=np.uint8, count=(num_entries * entry_size)).reshape(num_entries, entry_size)
+        np_arr  = raw.view(self.fields_np_dt).reshape(-1)
 
-                # Use OrderedDict to preserve user-specified field order
-                ret_val.append(OrderedDict(zip(names, dataTuple)))
+        names   = []
+        columns = []
 
-            except error as err:
-                print("Error unpacking {0} buffer with len {1}: {2}".format(self.name, len(buf), err))
+        for (name, fmt, offset, size) in self._get_field_layout():
+            names.append(name)
 
-            index += entry_size
+            if fmt.endswith('s'):
+                columns.append([r.tobytes() for r in raw[:, offset:offset + size]])
+            elif (fmt[:-1]):
+                # Array field (i.e. struct format with a repeat count)
+                columns.append(np.ascontiguousarray(raw[:, offset:offset + size]).view('<' + fmt[-1]).tolist())
+            else:
+                columns.append(np_arr[name].tolist())
 
-        return ret_val
+        # Use OrderedDict to preserve user-specified field order
+        return [OrderedDict(zip(names, values)) for values in zip(*columns)]
 
 
     def serialize(self, entries):
@@ -470,58 +489,138 @@ class WlanExpLogEntryType(object):
             entry_list (dictionary):  Array of dictionaries for 1 or more log entries of the same type
 
         Returns:
-            data (bytearray):  Bytearray of packed binary data
+            data (bytes):  Packed binary data
+
+        Fields missing from an entry are set to zero.  Use ``serialize_np()`` to write a numpy
+        array of entries in to log data.
         """
-        length     = 1
-        ret_val    = ""
-        entry_size = calcsize(self.fields_fmt_struct)
+        import struct
+        import operator
+        import numpy as np
 
         # Convert entries to a list if it is not already one
         if type(entries) is not list:
             entries = [entries]
 
-        # Pack each of the entries into a single data buffer
-        for entry in entries:
-            fields     = []
-            tmp_values = []
-            used_field = []
+        # Entry types without array fields are packed with one struct.pack() per entry
+        #   if every entry has every field
+        fields_struct = self._get_fields_struct()
 
-            for field in self._fields:
-                if 'x' not in field[1]:
-                    fields.append(field[0])
-                    try:
-                        tmp_values.append(entry[field[0]])
-                        used_field.append(True)
-                    except KeyError:
-                        tmp_values.append(0)
-                        used_field.append(False)
-
-            if (False):
-                print("Serialize Entry:")
-                print(fields)
-                print(used_field)
-                print(tmp_values)
-
-            ret_val += pack(self.fields_fmt_struct, *tmp_values)
-
-        if (entry_size * length) != len(ret_val):
-            msg  = "WARNING: Sizes do not match.\n"
-            msg += "    Expected  {0} bytes".format(entry_size * length)
-            msg += "    Buffer is {0} bytes".format(len(ret_val))
-            print(msg)
+        if fields_struct is not None:
+            get_values = operator.itemgetter(*[f[0] for f in self._get_field_layout()])
+
+            try:
+                return b''.join([fields_struct.pack(*get_values(entry)) for entry in entries])
+            except (KeyError, TypeError, struct.error):
+                pass
+
+        entry_size = self.fields_np_dt.itemsize
+        raw        = np.zeros((len(entries), entry_size), dtype=np.uint8)
+        np_arr     = raw.view(self.fields_np_dt).reshape(-1)
+
+        for (name, fmt, offset, size) in self._get_field_layout():
+            values = [entry.get(name) for entry in entries]
+
+            if all(v is None for v in values):
+                continue
+
+            if fmt.endswith('s'):
+                values = b''.join(bytes(v or b'')[:size].ljust(size, b'\0') for v in values)
+                raw[:, offset:offset + size] = np.frombuffer(values, dtype=np.uint8).reshape(-1, size)
+            elif (fmt[:-1]):
+                count  = size // np.dtype('<' + fmt[-1]).itemsize
+                values = np.array([v if v is not None else [0] * count for v in values], dtype=('<' + fmt[-1]))
+                raw[:, offset:offset + size] = values.reshape(len(entries), count).view(np.uint8)
+            else:
+                np_arr[name] = [v if v is not None else 0 for v in values]
+
+        return raw.tobytes()
+
+
+    def deserialize_np(self, log_data, byte_offsets):
+        """Unpack the entries at the given byte offsets in to a numpy structured array.
+
+        Args:
+            log_data (bytes):                           Binary data from a WlanExpNode log
+            byte_offsets (list or numpy array of int):  Offsets of the entries (see log_util.gen_raw_log_index())
+
+        Returns:
+            np_arr (numpy array):  Structured array with dtype ``fields_np_dt`` (the
+                ``gen_numpy_callbacks`` are not run; see ``generate_numpy_array()``)
+
+        All of the entries are copied out of the log data in a single numpy gather.
+        """
+        import wlan_exp.log.util as log_util
+
+        raw = log_util.read_byte_fields(log_data, byte_offsets, self.fields_np_dt.itemsize)
+
+        return raw.view(self.fields_np_dt).reshape(-1)
+
+
+    def serialize_np(self, log_data, byte_offsets, np_arr):
+        """Pack a numpy array of entries in to the log data at the given byte offsets.
+
+        Args:
+            log_data (bytearray):                       Binary data from a WlanExpNode log (must be writable)
+            byte_offsets (list or numpy array of int):  Offsets of the entries to overwrite
+            np_arr (numpy array):                       Structured array with (at least) the fields of
+                ``fields_np_dt``, e.g. from ``generate_numpy_array()``
+
+        This is an in-place modification of ``log_data``.  Fields added by the
+        ``gen_numpy_callbacks`` are ignored.
+        """
+        import numpy as np
+        import wlan_exp.log.util as log_util
+
+        if (np_arr.dtype != self.fields_np_dt):
+            tmp = np.zeros(len(np_arr), dtype=self.fields_np_dt)
+
+            for name in self.fields_np_dt.names:
+                tmp[name] = np_arr[name]
+
+            np_arr = tmp
+
+        raw = np.ascontiguousarray(np_arr).view(np.uint8).reshape(len(np_arr), self.fields_np_dt.itemsize)
 
-        return ret_val
+        log_util.write_byte_fields(log_data, byte_offsets, raw)
 
 
     # -------------------------------------------------------------------------
     # Internal methods for the WlanExpLogEntryType
     # -------------------------------------------------------------------------
+    def _get_field_layout(self):
+        """Internal method to get (name, struct format, byte offset, size) of each non-padding field."""
+        layout = []
+
+        for f in self._fields:
+            if 'x' not in f[1]:
+                layout.append((f[0], f[1], self._field_offsets[f[0]], self.fields_np_dt.fields[f[0]][0].itemsize))
+
+        return layout
+
+
+    def _get_fields_struct(self):
+        """Internal method to get a little-endian struct.Struct of the entry, or None if
+        the entry has array fields (e.g. '256B')."""
+        import struct
+
+        for f in self._fields:
+            if ('x' not in f[1]) and (not f[1].endswith('s')) and f[1][:-1]:
+                return None
+
+        if self._fields_struct is None:
+            self._fields_struct = struct.Struct('<' + self.fields_fmt_struct)
+
+        return self._fields_struct
+
+
     def _update_field_defs(self):
         """Internal method to update fields."""
         import numpy as np
 
         # Update the fields format used by struct unpack/calcsize
         self.fields_fmt_struct = ' '.join(self.get_field_struct_formats())
+        self._fields_struct    = None
 
         # Update the numpy dtype definition
         # fields_np_dt is a numpy dtype, built using a dictionary of names/formats/offsets:
@@ -611,7 +710,21 @@ def np_array_add_txrx_fields(np_arr_orig, docs_only=False):
 # End def
 
 
-def np_array_add_fields(np_arr_orig, mac_addr=False, ltg=False, docs_only=False):
+def np_array_add_txrx_phy_ltg_fields(np_arr_orig, docs_only=False):
+    """Add 'virtual' fields to TX/RX LTG packets with PHY parameters."""
+    return np_array_add_fields(np_arr_orig, mac_addr=True, ltg=True, airtime=True, docs_only=docs_only)
+
+# End def
+
+
+def np_array_add_txrx_phy_fields(np_arr_orig, docs_only=False):
+    """Add 'virtual' fields to TX/RX packets with PHY parameters."""
+    return np_array_add_fields(np_arr_orig, mac_addr=True, ltg=False, airtime=True, docs_only=docs_only)
+
+# End def
+
+
+def np_array_add_fields(np_arr_orig, mac_addr=False, ltg=False, airtime=False, docs_only=False):
     """Add 'virtual' fields to the numpy array.
 
     This is an example of a gen_numpy_array_callback
@@ -620,6 +733,8 @@ def np_array_add_fields(np_arr_orig, mac_addr=False, ltg=False, docs_only=False)
         np_arr_orig (Numpy Array):  Numpy array to extend
         mac_addr (bool, optional):  Add MAC address information to the numpy array?
         ltg (bool, optional):       Add LTG information ot the numpy array?
+        airtime (bool, optional):   Add the PHY duration of the packet to the numpy array?
+            Requires the 'mcs', 'phy_mode', 'length' and 'phy_samp_rate' fields.
         docs_only (bool):           Only generate documentation strings for virtual fields?
             If this is True, then only documentation strings are returned.
 
@@ -629,6 +744,7 @@ def np_array_add_fields(np_arr_orig, mac_addr=False, ltg=False, docs_only=False)
     Extend the default np_arr with convenience fields for:
         * MAC header addresses
         * LTG packet information
+        * Airtime of the packet (see log_util.calc_tx_time())
 
     IMPORTANT: np_arr uses the original bytearray as its underlying data
     We must operate on a copy to avoid clobbering log entries adjacent to the
@@ -652,6 +768,12 @@ def np_array_add_fields(np_arr_orig, mac_addr=False, ltg=False, docs_only=False)
         formats += ('uint64', 'uint64')
         descs   += ('Unique sequence number for LTG packet', 'LTG Flow ID, calculated as:\n  16LSB: LTG instance ID\n  48MSB: Destination MAC address')
 
+    # Add the airtime fields
+    if airtime:
+        names   += ('airtime',)
+        formats += ('uint32',)
+        descs   += ('Duration of the PHY waveform in microseconds (0 for PHY modes other than NONHT and HTMF)',)
+
     # If there are no fields to add, just return the original array
     if not names:
         return np_arr_orig
@@ -710,6 +832,13 @@ def np_array_add_fields(np_arr_orig, mac_addr=False, ltg=False, docs_only=False)
         arr_filt = np_arr_out['mac_payload_len'] >= 24
         np_arr_out['mac_seq'][arr_filt] = np.dot(mac_hdrs[arr_filt, 22:24], [1, 256]) // 16
 
+    # Populate the airtime fields
+    if airtime:
+        import wlan_exp.log.util as log_util
+
+        np_arr_out['airtime'] = log_util._calc_tx_time_lut(np_arr_orig['mcs'], np_arr_orig['phy_mode'].astype(np.intp),
+                                                           np_arr_orig['length'], np_arr_orig['phy_samp_rate'])
+
     # Populate the LTG fields
     if ltg:
         # Helper array of powers of 2
@@ -747,7 +876,7 @@ def extend_np_dt(dt_orig, new_fields=None):
     import numpy as np
     from collections import OrderedDict
 
-    if(type(dt_orig) is not np.dtype):
+    if not isinstance(dt_orig, np.dtype):
         raise Exception("ERROR: extend_np_dt requires valid numpy dtype as input")
     else:
         # Use ordered dictionary to preserve original field order (not required, just convenient)
@@ -899,7 +1028,7 @@ if not os.environ.get('BUILDING_DOCS_ON_SERVER', False):
         ('time_to_accept',         'I',      'uint32',  'Time duration in microseconds between packet creation and acceptance by frame_transmit() in CPU Low'),
         ('time_to_done',           'I',      'uint32',  'Time duration in microseconds between packet acceptance by CPU Low and completion of all transmissions by CPU Low'),
         ('uniq_seq',               'Q',      'uint64',  'Unique sequence number for Tx packet; 12 LSB of this used for 802.11 MAC header sequence number'),
-        ('padding0',               'I',      'uint32',  ''),        
+        ('trace_id',               'I',      'uint32',  'Latency trace ID of the packet (see TX_TRACE); 0 if the packet was not traced'),
         ('num_tx',                 'H',      'uint16',  'Number of Tx attempts that were made for this packet'),
         ('length',                 'H',      'uint16',  'Length in bytes of MPDU; includes MAC header, payload and FCS'),
         ('padding1',               'x',      'uint8',   ''),
@@ -1077,7 +1206,7 @@ if not os.environ.get('BUILDING_DOCS_ON_SERVER', False):
         ('mac_payload_len',        'I',      'uint32',      'Length in bytes of MAC payload recorded in log for this packet'),
         ('mac_payload',            '24s',    '24uint8',     'First 24 bytes of MAC payload, typically the 802.11 MAC header')])
 
-    entry_rx_ofdm.add_gen_numpy_array_callback(np_array_add_txrx_fields)
+    entry_rx_ofdm.add_gen_numpy_array_callback(np_array_add_txrx_phy_fields)
 
     entry_rx_ofdm.consts = entry_rx_common.consts.copy()
 
@@ -1095,7 +1224,7 @@ if not os.environ.get('BUILDING_DOCS_ON_SERVER', False):
         ('mac_payload_len',        'I',      'uint32',      'Length in bytes of MAC payload recorded in log for this packet'),
         ('mac_payload',            '44s',    '44uint8',     'First 44 bytes of MAC payload: the 802.11 MAC header, LLC header, Packet ID, LTG ID')])
 
-    entry_rx_ofdm_ltg.add_gen_numpy_array_callback(np_array_add_txrx_ltg_fields)
+    entry_rx_ofdm_ltg.add_gen_numpy_array_callback(np_array_add_txrx_phy_ltg_fields)
 
     entry_rx_ofdm_ltg.consts = entry_rx_common.consts.copy()
 
@@ -1163,7 +1292,7 @@ if not os.environ.get('BUILDING_DOCS_ON_SERVER', False):
         ('mac_payload_len',        'I',      'uint32',      'Length in bytes of MAC payload recorded in log for this packet'),
         ('mac_payload',            '24s',    '24uint8',     'First 24 bytes of MAC payload, typically the 802.11 MAC header')])
 
-    entry_tx_low.add_gen_numpy_array_callback(np_array_add_txrx_fields)
+    entry_tx_low.add_gen_numpy_array_callback(np_array_add_txrx_phy_fields)
 
     entry_tx_low.consts = entry_tx_low_common.consts.copy()
 
@@ -1180,7 +1309,85 @@ if not os.environ.get('BUILDING_DOCS_ON_SERVER', False):
         ('mac_payload_len',        'I',      'uint32',      'Length in bytes of MAC payload recorded in log for this packet'),
         ('mac_payload',            '44s',    '44uint8',     'First 44 bytes of MAC payload: the 802.11 MAC header, LLC header, Packet ID, LTG ID')])
 
-    entry_tx_low_ltg.add_gen_numpy_array_callback(np_array_add_txrx_ltg_fields)
+    entry_tx_low_ltg.add_gen_numpy_array_callback(np_array_add_txrx_phy_ltg_fields)
 
     entry_tx_low_ltg.consts = entry_tx_low_common.consts.copy()
 
+
+    ###########################################################################
+    # Transmit latency trace
+    #
+    entry_tx_trace = WlanExpLogEntryType(name='TX_TRACE', entry_type_id=ENTRY_TYPE_TX_TRACE)
+
+    entry_tx_trace.description  = 'Latency trace of a packet from when it entered the MAC (Ethernet reception or LTG event) to when CPU Low was done '
+    entry_tx_trace.description += 'transmitting it. Logged with the TX_HIGH entry of each traced packet while latency tracing is enabled (see '
+    entry_tx_trace.description += 'node.log_configure()). Use the uniq_seq field to match TX_TRACE, TX_HIGH and TX_LOW entries of the same MPDU.'
+
+    entry_tx_trace.append_field_defs([
+        ('timestamp',              'Q',      'uint64',  'Value of MAC Time in microseconds when the packet entered the MAC'),
+        ('uniq_seq',               'Q',      'uint64',  'Unique sequence number of the MPDU'),
+        ('trace_id',               'I',      'uint32',  'Latency trace ID of the packet'),
+        ('time_to_enqueue',        'I',      'uint32',  'Time duration in microseconds between the packet entering the MAC and being enqueued'),
+        ('time_to_dequeue',        'I',      'uint32',  'Time duration in microseconds the packet waited in the Tx queue'),
+        ('time_to_accept',         'I',      'uint32',  'Time duration in microseconds between dequeue and acceptance by frame_transmit() in CPU Low'),
+        ('time_to_done',           'I',      'uint32',  'Time duration in microseconds between packet acceptance by CPU Low and completion of all transmissions by CPU Low'),
+        ('num_tx',                 'H',      'uint16',  'Number of Tx attempts that were made for this packet'),
+        ('tx_result',              'B',      'uint8',   'Result of the transmission'),
+        ('padding0',               'x',      'uint8',   '')])
+
+    entry_tx_trace.consts = util.consts_dict({
+        'tx_result'  : util.consts_dict({
+            'SUCCESS'        : 0x00,
+            'FAILURE'        : 0x01
+        })
+    })
+
+
+    ###########################################################################
+    # Receive latency trace
+    #
+    entry_rx_trace = WlanExpLogEntryType(name='RX_TRACE', entry_type_id=ENTRY_TYPE_RX_TRACE)
+
+    entry_rx_trace.description  = 'Latency trace of a received data packet. Logged with the RX_OFDM / RX_DSSS entry of each data packet received with '
+    entry_rx_trace.description += 'a good FCS while latency tracing is enabled (see node.log_configure()). The (addr2, mac_seq, timestamp) fields match '
+    entry_rx_trace.description += 'the TX_LOW entry of the transmitting node.'
+
+    entry_rx_trace.append_field_defs([
+        ('timestamp',              'Q',      'uint64',  'Value of MAC Time in microseconds when packet reception began (same as the RX entry)'),
+        ('time_to_process',        'I',      'uint32',  'Time duration in microseconds between the start of the reception and its processing by CPU High'),
+        ('mac_seq',                'H',      'uint16',  '802.11 MAC sequence number of the packet'),
+        ('length',                 'H',      'uint16',  'Length in bytes of MPDU; includes MAC header, payload and FCS'),
+        ('addr2',                  '6s',     '6uint8',  'Transmitter address (802.11 MAC header address 2)'),
+        ('padding0',               '2x',     '2uint8',  '')])
+
+
+    ###########################################################################
+    # Transmit drop
+    #
+    entry_tx_drop = WlanExpLogEntryType(name='TX_DROP', entry_type_id=ENTRY_TYPE_TX_DROP)
+
+    entry_tx_drop.description  = 'Packet dropped by the active queue management (AQM) policy of its Tx queue (see node.set_queue_aqm()). Logged '
+    entry_tx_drop.description += 'while Tx/Rx MPDU logging is enabled (see node.log_configure()). Packets rejected because their queue was full '
+    entry_tx_drop.description += '(tail drop) are only counted (see node.get_queue_aqm()).'
+
+    entry_tx_drop.append_field_defs([
+        ('timestamp',              'Q',      'uint64',  'Value of MAC Time in microseconds when the packet was dropped'),
+        ('time_to_drop',           'I',      'uint32',  'Time duration in microseconds the packet waited in the Tx queue before it was dropped'),
+        ('trace_id',               'I',      'uint32',  'Latency trace ID of the packet (see TX_TRACE); 0 if the packet was not traced'),
+        ('num_dropped',            'I',      'uint32',  'Number of packets the Tx queue has dropped for this reason since its drop counters were reset (including this one)'),
+        ('queue_id',               'H',      'uint16',  'ID of the Tx queue'),
+        ('queue_occupancy',        'H',      'uint16',  'Number of packets in the Tx queue after the drop'),
+        ('length',                 'H',      'uint16',  'Length in bytes of MPDU; includes MAC header, payload and FCS'),
+        ('reason',                 'B',      'uint8',   'Reason of the drop'),
+        ('padding0',               'x',      'uint8',   ''),
+        ('addr1',                  '6s',     '6uint8',  'Receiver address (802.11 MAC header address 1)'),
+        ('padding1',               '6x',     '6uint8',  '')])
+
+    entry_tx_drop.consts = util.consts_dict({
+        'reason'  : util.consts_dict({
+            'HEAD'           : 0x01,
+            'LIFETIME'       : 0x02,
+            'CODEL'          : 0x03
+        })
+    })
+
@@ -22,6 +22,16 @@ log_index      -- A log_index is any index that is not a raw_log_index.  In
 general, this will be a interpreted / filtered version of
 a raw_log_index.
 
+The offsets of a raw_log_index or log_index can be stored
+either as Python lists or as numpy int64 arrays (see
+log_index_to_np()).  The numpy form avoids the per-entry
+Python overhead of filtering / merging very large indexes.
+
+log_ts_index   -- A timestamp index of the entries in a raw_log_index.  For
+each entry type, the timestamps of its entries sorted in
+increasing order along with the offset of each entry:
+{ <int> : [(<timestamp>, <offset>)] }
+
 numpy          -- A python package that allows easy and fast manipulation of
 large data sets.  You can find more documentaiton on numpy at:
 http://www.numpy.org/
@@ -29,8 +39,14 @@ http://www.numpy.org/
 """
 
 __all__ = ['gen_raw_log_index',
+           'gen_log_timestamp_index',
            'filter_log_index',
-           'log_data_to_np_arrays']
+           'read_byte_fields',
+           'write_byte_fields',
+           'log_index_to_np',
+           'log_index_to_lists',
+           'log_data_to_np_arrays',
+           'LogView']
 
 
 # -----------------------------------------------------------------------------
@@ -48,6 +64,13 @@ if (sys.maxsize <= 2**32):
 if sys.version[0]=="3": long=None
 
 
+# Size of the log entry header (see gen_raw_log_index())
+LOG_ENTRY_HDR_SIZE = 8
+
+# Data type of each timestamp index array (see gen_log_timestamp_index())
+log_ts_index_dtype = [('timestamp', '<u8'), ('offset', '<u8')]
+
+
 # -----------------------------------------------------------------------------
 # Log Container base class
 # -----------------------------------------------------------------------------
@@ -72,6 +95,7 @@ class LogContainer(object):
     def get_log_data_size(self):                      raise NotImplementedError
     def get_log_data(self):                           raise NotImplementedError
     def get_log_index(self, gen_index=True):          raise NotImplementedError
+    def get_log_ts_index(self, gen_index=True):       raise NotImplementedError
     def get_attr_dict(self):                          raise NotImplementedError
 
     def trim_log_data(self):                          raise NotImplementedError
@@ -205,6 +229,8 @@ def filter_log_index(log_index, include_only=None, exclude=None, merge=None, ver
     Returns:
         log_index (dict):  Filtered log index dictionary based on the given parameters
 
+    The offsets of merged entry types are numpy int64 arrays unless all of the merged
+    indexes are Python lists (see log_index_to_np()).
 
     Consumers, in general, cannot operate on a raw log index since that has
     not been converted in to log entry types.  The besides filtering a log
@@ -339,7 +365,7 @@ def filter_log_index(log_index, include_only=None, exclude=None, merge=None, ver
                     except KeyError:
                         merge_tmp += "        {0} had no entries in log index.  Ignored for merge.\n".format(v)
 
-                new_index += index
+                new_index.append(index)
 
 
             # If this merge is going to replace one of the entry types in the 
@@ -353,7 +379,11 @@ def filter_log_index(log_index, include_only=None, exclude=None, merge=None, ver
 
             # Add the new merged index lists to the output dictionary
             # Use the type instance corresponding to the user-supplied string as the key
-            ret_log_index[log_entry_types[k]] = sorted(new_index)
+            #   The merged offsets are a numpy array unless all of the merged
+            #   indexes are Python lists
+            new_index = _merge_offsets(new_index)
+
+            ret_log_index[log_entry_types[k]] = new_index
 
             summary += "\n    {0} ({1} entries) contains:\n".format(log_entry_types[k], len(new_index))
             summary += merge_tmp
@@ -407,6 +437,52 @@ def filter_log_index(log_index, include_only=None, exclude=None, merge=None, ver
 
 
 
+def log_index_to_np(log_index):
+    """Convert the offsets of a log index to numpy arrays.
+
+    Args:
+        log_index (dict):  Log index dictionary (either a 'raw_log_index' or a 'log_index')
+
+    Returns:
+        log_index (dict):  Log index dictionary with the same keys where each value is a
+            numpy int64 array of offsets
+
+    Values that are already int64 arrays are not copied.  All of the log utilities
+    accept either form of log index; the numpy form is much faster to filter, merge and
+    rebase for indexes with millions of entries.
+    """
+    import numpy as np
+
+    return {k : np.asarray(v, dtype=np.int64) for k, v in log_index.items()}
+
+# End def
+
+
+
+def log_index_to_lists(log_index):
+    """Convert the offsets of a log index to Python lists.
+
+    Args:
+        log_index (dict):  Log index dictionary (either a 'raw_log_index' or a 'log_index')
+
+    Returns:
+        log_index (dict):  Log index dictionary with the same keys where each value is a
+            Python list of offsets (inverse of log_index_to_np())
+    """
+    new_log_index = {}
+
+    for k, v in log_index.items():
+        try:
+            new_log_index[k] = v.tolist()
+        except AttributeError:
+            new_log_index[k] = list(v)
+
+    return new_log_index
+
+# End def
+
+
+
 def log_data_to_np_arrays(log_data, log_index):
     """Generate numpy structured arrays using log_data and a log_index.
 
@@ -434,6 +510,154 @@ def log_data_to_np_arrays(log_data, log_index):
 
 
 
+def gen_log_timestamp_index(log_data, raw_log_index):
+    """Generate a timestamp index from wlan_exp log data and a raw log index.
+
+    Args:
+        log_data (bytes):      Binary data from a WlanExpNode log
+        raw_log_index (dict):  Raw log index of the log data
+
+    Returns:
+        log_ts_index (dict):
+            Dictionary of the form ``{ <int> : <Numpy Array> }`` where each array has
+            the fields 'timestamp' and 'offset' (both uint64) and is sorted by timestamp.
+
+    Log entries of a given type are not necessarily recorded in timestamp
+    order (for example, TX_HIGH entries are created when the transmission
+    completes but are timestamped when the packet was created).  Therefore,
+    the timestamp index pairs each sorted timestamp with the offset of its
+    entry so that a time range can be found with a binary search.  Entry types
+    without a 'timestamp' field are not included.
+    """
+    import numpy as np
+    from .entry_types import log_entry_types
+
+    log_ts_index = dict()
+
+    for k, offsets in raw_log_index.items():
+        try:
+            ts_offset = log_entry_types[k].get_field_offsets()['timestamp']
+        except KeyError:
+            continue
+
+        offsets    = np.asarray(offsets, dtype=np.uint64)
+        timestamps = _gather_u64(log_data, offsets + np.uint64(ts_offset))
+        order      = np.argsort(timestamps, kind='mergesort')
+
+        ts_index               = np.empty((len(offsets),), dtype=log_ts_index_dtype)
+        ts_index['timestamp']  = timestamps[order]
+        ts_index['offset']     = offsets[order]
+
+        log_ts_index[k] = ts_index
+
+    return log_ts_index
+
+# End def
+
+
+
+class LogView(object):
+    """Class to query the entries of a log container by time.
+
+    Args:
+        container (LogContainer):  Log container with the log data
+
+    The log view uses the timestamp index of the log container (see
+    ``gen_log_timestamp_index()``) so that only the entries in the requested
+    time range are decoded.  The timestamp index is read from the container
+    once, when it is first needed.
+
+    Example:
+    ::
+
+        view    = LogView(HDF5LogContainer(h5_file))
+        entries = view.between(10e6, 20e6, types=['RX_OFDM', 'TX_HIGH'])
+    """
+    container         = None
+
+    _log_ts_index     = None
+
+
+    def __init__(self, container):
+        self.container = container
+
+
+    def index_between(self, t0, t1, types=None):
+        """Get the log index of the entries with t0 <= timestamp < t1.
+
+        Args:
+            t0 (int):                 Start of the time range (microseconds)
+            t1 (int):                 End of the time range (microseconds)
+            types (list, optional):   List of entry type names; all entry types with
+                a 'timestamp' field by default
+
+        Returns:
+            log_index (dict):  Log index of the form ``{ <WlanExpLogEntryType> : <offsets> }``
+                with offsets in log order
+        """
+        import numpy as np
+        from .entry_types import log_entry_types
+
+        log_ts_index = self._get_log_ts_index()
+
+        if types is None:
+            type_ids = list(log_ts_index.keys())
+        else:
+            type_ids = [log_entry_types[t].entry_type_id for t in types]
+
+        log_index = dict()
+
+        for k in type_ids:
+            try:
+                ts_index = log_ts_index[k]
+            except KeyError:
+                log_index[log_entry_types[k]] = np.empty((0,), dtype=np.uint64)
+                continue
+
+            start = np.searchsorted(ts_index['timestamp'], t0, side='left')
+            end   = np.searchsorted(ts_index['timestamp'], t1, side='left')
+
+            log_index[log_entry_types[k]] = np.sort(ts_index['offset'][start:end])
+
+        return log_index
+
+
+    def between(self, t0, t1, types=None):
+        """Decode the entries with t0 <= timestamp < t1.
+
+        Args:
+            t0 (int):                 Start of the time range (microseconds)
+            t1 (int):                 End of the time range (microseconds)
+            types (list, optional):   List of entry type names; all entry types with
+                a 'timestamp' field by default
+
+        Returns:
+            np_arrays (dict):  Numpy structured arrays of the entries in the time
+                range, keyed by entry type name
+        """
+        log_index = self.index_between(t0, t1, types)
+        log_data  = self.container.get_log_data()
+
+        np_arrays = log_data_to_np_arrays(log_data, dict((k, v) for k, v in log_index.items() if len(v)))
+
+        for k in log_index.keys():
+            if k not in np_arrays:
+                np_arrays[k] = []
+
+        return dict((k.name, v) for k, v in np_arrays.items())
+
+
+    def _get_log_ts_index(self):
+        """Internal method to get the timestamp index from the container."""
+        if self._log_ts_index is None:
+            self._log_ts_index = self.container.get_log_ts_index()
+
+        return self._log_ts_index
+
+# End class()
+
+
+
 def _translate_log_index_keys(log_index):
     # Translate the keys in the return log index to WlanExpLogEntryType
     from .entry_types import log_entry_types
@@ -454,6 +678,54 @@ def _translate_log_index_keys(log_index):
 
 
 
+def _merge_offsets(indexes):
+    """Merge a list of offset lists / arrays into a single sorted index.
+
+    The result is a Python list if all of the given indexes are lists (or there
+    are no indexes) and a numpy int64 array otherwise.
+    """
+    import numpy as np
+
+    # Converting lists to arrays and back costs more than sorting the lists
+    if all(type(index) is list for index in indexes):
+        new_index = []
+
+        for index in indexes:
+            new_index += index
+
+        return sorted(new_index)
+
+    arrays = [np.asarray(index, dtype=np.int64).reshape(-1) for index in indexes]
+    arrays = [a for a in arrays if len(a)]
+
+    if (len(arrays) == 0):
+        offsets = np.empty(0, dtype=np.int64)
+
+    elif (len(arrays) == 1):
+        offsets = np.sort(arrays[0], kind='stable')
+
+    else:
+        # Indexes of different entry types from the same log are each sorted and
+        #   usually interleaved.  A stable sort (timsort) merges the sorted runs
+        #   of the concatenated array in O(N log k).  If the indexes do not
+        #   overlap (e.g. consecutive pieces of a log), ordering them by their
+        #   first offset is enough.
+        arrays.sort(key=lambda a: a[0])
+
+        is_sorted   = all(np.all(a[1:] >= a[:-1]) for a in arrays)
+        is_disjoint = all((arrays[i][-1] <= arrays[i + 1][0]) for i in range(len(arrays) - 1))
+
+        offsets = np.concatenate(arrays)
+
+        if not (is_sorted and is_disjoint):
+            offsets.sort(kind='stable')
+
+    return offsets
+
+# End def
+
+
+
 # -----------------------------------------------------------------------------
 # Log Misc Utilities
 # -----------------------------------------------------------------------------
@@ -499,15 +771,29 @@ def merge_log_indexes(dest_index, src_index, offset):
         src_index (dict):   Source log index to merge into destination log index
         offset (int):       Offset of ``src_index`` into ``dest_index``
 
+    The offsets of each entry type are Python lists if both indexes store
+    lists and numpy int64 arrays otherwise (see log_index_to_np()).  The
+    ``dest_index`` is updated in place and returned.
     """
+    import numpy as np
+
     return_val = dest_index
 
     for key in src_index.keys():
-        new_offsets = [x + offset for x in src_index[key]]
+        dest_offsets = return_val.get(key, [])
 
-        try:
-            return_val[key].append(new_offsets)
-        except KeyError:
+        # Extend list indexes in place; converting a growing destination list
+        #   to an array on every call is quadratic when merging many chunks
+        if (type(dest_offsets) is list) and (type(src_index[key]) is list):
+            dest_offsets.extend((np.asarray(src_index[key], dtype=np.int64) + offset).tolist())
+            return_val[key] = dest_offsets
+            continue
+
+        new_offsets = np.asarray(src_index[key], dtype=np.int64) + offset
+
+        if len(dest_offsets):
+            return_val[key] = np.concatenate((np.asarray(dest_offsets, dtype=np.int64).reshape(-1), new_offsets))
+        else:
             return_val[key] = new_offsets
 
     return return_val
@@ -535,10 +821,11 @@ def calc_next_entry_offset(log_data, raw_log_index):
     # See documentation above on header format
     hdr_size             = 8
 
-    max_entry_offset_key = max(raw_log_index, key=raw_log_index.get)
-    max_entry_offset     = raw_log_index[max_entry_offset_key][-1]
+    # Offsets of each entry type are sorted, so the last entry is the largest
+    #   of the last offsets
+    max_entry_offset     = int(max(v[-1] for v in raw_log_index.values() if len(v)))
 
-    hdr_b = log_data[max_entry_offset - hdr_size : max_entry_offset]
+    hdr_b = bytearray(log_data[max_entry_offset - hdr_size : max_entry_offset])
 
     if( (bytearray(hdr_b[2:4]) != b'\xed\xac') ):
         raise Exception("ERROR: Offset not a valid entry header (offset {0})!".format(max_entry_offset))
@@ -560,23 +847,19 @@ def overwrite_entries_with_null_entry(log_data, byte_offsets):
     This is an in-place modification of log_data.
     
     Args:
-        log_data (bytes):            Binary data from a WlanExpNode log
+        log_data (bytearray):        Binary data from a WlanExpNode log (must be writable)
         byte_offsets (list of int):  List of offsets corresponding to the entries to overwrite
     """
-    # See documentation above on header format
-    hdr_size         = 8
-
-    for offset in byte_offsets:
-        hdr_b = log_data[offset - hdr_size : offset]
+    import numpy as np
 
-        if( (bytearray(hdr_b[2:4]) != b'\xed\xac') ):
-            raise Exception("ERROR: Offset not a valid entry header (offset {0})!".format(offset))
+    offsets          = np.asarray(byte_offsets, dtype=np.int64).reshape(-1)
+    (_, entry_sizes) = _read_entry_headers(log_data, offsets)
 
-        hdr_b[4:6] = bytearray([0] * 2)
-        entry_size = (hdr_b[6] + (hdr_b[7] * 256))
+    # Set the entry type in the header to NULL (0)
+    write_byte_fields(log_data, (offsets - LOG_ENTRY_HDR_SIZE + 4), np.zeros(2, dtype=np.uint8))
 
-        # Write over the log entry with zeros
-        log_data[offset : offset + entry_size] = bytearray([0] * entry_size)
+    # Write over the log entry with zeros
+    _zero_byte_ranges(log_data, offsets, entry_sizes)
 
 # End def
 
@@ -586,7 +869,7 @@ def overwrite_payloads(log_data, byte_offsets, payload_offsets=None):
     """Overwrite any payloads with zeros.
 
     Args:
-        log_data (bytes):            Binary data from a WlanExpNode log
+        log_data (bytearray):        Binary data from a WlanExpNode log (must be writable)
         byte_offsets (list of int):  List of offsets corresponding to the entries to be modified
         payload_offsets (dict):      Dictionary of ``{ entry_type_id : <payload offset> }``
 
@@ -612,11 +895,8 @@ def overwrite_payloads(log_data, byte_offsets, payload_offsets=None):
     This is an in-place modification of ``log_data``.
     """
     import struct
-    from entry_types import log_entry_types
-
-    # See documentation above on header format
-    hdr_size         = 8
-
+    import numpy as np
+    from .entry_types import log_entry_types
 
     if payload_offsets is None:
         payload_offsets  = {}
@@ -625,29 +905,76 @@ def overwrite_payloads(log_data, byte_offsets, payload_offsets=None):
         for entry_type_id, entry_type in log_entry_types.items():
             payload_offsets[entry_type_id] = struct.calcsize(entry_type.fields_fmt_struct)
 
+    offsets                       = np.asarray(byte_offsets, dtype=np.int64).reshape(-1)
+    (entry_type_ids, entry_sizes) = _read_entry_headers(log_data, offsets)
 
-    for offset in byte_offsets:
-        hdr_b = log_data[offset - hdr_size : offset]
-
-        if( (bytearray(hdr_b[2:4]) != b'\xed\xac') ):
-            raise Exception("ERROR: Offset not a valid entry header (offset {0})!".format(offset))
+    len_offsets = np.full(len(offsets), -1, dtype=np.int64)
 
-        entry_type_id = (hdr_b[4] + (hdr_b[5] * 256))
-        entry_size    = (hdr_b[6] + (hdr_b[7] * 256))
+    for entry_type_id in np.unique(entry_type_ids).tolist():
+        idx = (entry_type_ids == entry_type_id)
 
         try:
-            len_offset  = payload_offsets[entry_type_id]
+            len_offsets[idx] = payload_offsets[entry_type_id]
+        except KeyError:
+            for offset in offsets[idx].tolist():
+                print("WARNING:  Unknown entry type id {0} at offset {1}".format(entry_type_id, offset))
 
-            # Write over the log entry payload with zeros
-            if entry_size > len_offset:
-                log_data[offset + len_offset : offset + entry_size] = bytearray([0] * (entry_size - len_offset))
+    # Write over the log entry payloads with zeros
+    idx = (len_offsets >= 0) & (entry_sizes > len_offsets)
+
+    _zero_byte_ranges(log_data, (offsets + len_offsets)[idx], (entry_sizes - len_offsets)[idx])
+
+# End def
 
-        except KeyError:
-            print("WARNING:  Unknown entry type id {0} at offset {1}".format(entry_type_id, offset))
+
+
+def read_byte_fields(log_data, byte_offsets, size):
+    """Read a fixed number of bytes at each of the given offsets.
+
+    Args:
+        log_data (bytes):                           Binary data from a WlanExpNode log
+        byte_offsets (list or numpy array of int):  Offsets of the fields to read
+        size (int):                                 Number of bytes to read at each offset
+
+    Returns:
+        fields (numpy array):  uint8 array with shape ``(len(byte_offsets), size)``
+
+    All of the fields are copied out of the log data in a single numpy gather.
+    The returned array can be viewed as a numpy structured array with an
+    itemsize of ``size`` (see WlanExpLogEntryType.deserialize_np()).
+    """
+    import numpy as np
+
+    offsets = np.asarray(byte_offsets, dtype=np.intp).reshape(-1)
+
+    return _get_byte_windows(log_data, size)[offsets]
 
 # End def
 
 
+
+def write_byte_fields(log_data, byte_offsets, values):
+    """Write a fixed number of bytes at each of the given offsets.
+
+    Args:
+        log_data (bytearray):                       Binary data from a WlanExpNode log (must be writable)
+        byte_offsets (list or numpy array of int):  Offsets of the fields to write
+        values (numpy array):                       uint8 array with shape ``(len(byte_offsets), <size>)``
+            or ``(<size>,)`` to write the same bytes at every offset
+
+    This is an in-place modification of ``log_data``.
+    """
+    import numpy as np
+
+    values  = np.asarray(values, dtype=np.uint8)
+    offsets = np.asarray(byte_offsets, dtype=np.intp).reshape(-1)
+
+    _get_byte_windows(log_data, values.shape[-1])[offsets] = values
+
+# End def
+
+
+
 def calc_tx_time_log(tx_low_entries):
     """Wrapper for calc_tx_time() that accepts an array of TX_LOW log entries instead of discrete mcs/length/etc arguments
 
@@ -678,74 +1005,173 @@ def calc_tx_time(mcs, phy_mode, payload_length, phy_samp_rate):
     calculate the duration of many packets, call this method with iterables (typically
     Numpy arrays) of integer values. When calling this method with arrays the lengths
     of the 4 arrays must be equal.
+
+    The duration is computed with lookup tables indexed by (phy_mode, mcs) and
+    phy_samp_rate, so arrays of any length are processed without iterating in
+    Python.  Durations are returned as float64 (a Numpy scalar for scalar
+    arguments).
     """
     import numpy as np
-    import wlan_exp.util as util    
-    
+
+    phy_samp_rate = np.asarray(phy_samp_rate)
+
     # Check for valid phy_samp_rate values
-    if(not np.all( (phy_samp_rate == 10) + (phy_samp_rate == 20) + (phy_samp_rate == 40) )):
+    if(not np.all( (phy_samp_rate == 10) | (phy_samp_rate == 20) | (phy_samp_rate == 40) )):
         raise AttributeError('Invalid phy_samp_rate - all phy_samp_rate values must be 10, 20 or 40')
 
-    # Convert samp rates to lut indexes
-    #  Integer division by 15 is shortcut to map (10, 20, 40) to (0, 1, 2)
-    samp_rate_idx = (phy_samp_rate // 15)
+    mcs      = np.asarray(mcs)
+    phy_mode = _phy_mode_to_index(phy_mode)
 
-    # Lookup tables of waveform section durations in microseconds, indexed by samp_rate
-    lut_T_PREAMBLE = (8, 16, 32)
-    lut_T_SIG = (2, 4, 8)
-    lut_T_SYM = (2, 4, 8)
-    lut_T_EXT = (6, 6, 6)
+    if(np.any(mcs > 7) or np.any(_get_tx_time_luts()['NDBPS'][phy_mode, mcs & 0x7] == 0)):
+        raise AttributeError('Invalid (phy_mode, mcs) - all entries must be NONHT or HTMF with mcs in [0:7]')
 
-    T_PREAMBLE = np.choose(samp_rate_idx, lut_T_PREAMBLE)
-    T_SIG = np.choose(samp_rate_idx, lut_T_SIG)
-    T_SYM = np.choose(samp_rate_idx, lut_T_SYM)
-    T_EXT = np.choose(samp_rate_idx, lut_T_EXT)
+    T_TOT = _calc_tx_time_lut(mcs, phy_mode, payload_length, phy_samp_rate).astype(np.float64)
 
-    # (mcs, phy_mode) encodes number of data bits per symbol
-    try:
-        # LUT implementation (~2 sec for 150K entries)
-        #   - Construct NDBPS lookup table to be used during processing
-        # 
-        # TODO:  This implementation is dependent on the MCS range that is 
-        #     not defined in wlan_exp.util.  This function will need to be 
-        #     updated if more MCS values are defined.
-        ndbps_lut = {}
-        
-        for m in range(0, 8):
-            phy_mode_lut = {}
-            
-            for p in util.phy_modes.values():
-                try:
-                    phy_mode_lut[p] = util.get_rate_info(m, p, 20)['NDBPS']
-                except:
-                    # Do nothing for undefined values
-                    pass
-                    
-            ndbps_lut[m] = phy_mode_lut
-
-        ndbps = np.array([ndbps_lut[m][p] for i, (m, p) in enumerate(zip(mcs, phy_mode))])
-        
-                
-        # Naive implementation (~7 sec for 150K entries)
-        #   - Get rate info for each entry to extract NDBPS
-        # ndbps = np.array([util.get_rate_info(m, p, phy_samp_rate)['NDBPS'] for i, (m, p) in enumerate(zip(mcs, phy_mode))])
-    except TypeError:
-        ndbps = util.get_rate_info(mcs, phy_mode, phy_samp_rate)['NDBPS']
+    # Return a scalar for scalar arguments
+    return T_TOT[()]
 
-    # Compute the number of symbols in DATA field
+# End def
+
+
+
+def calc_medium_occupancy(timestamps, airtime, interval=1000000, t_start=None):
+    """Calculates the fraction of time the medium is occupied in each interval.
+
+    Args:
+        timestamps (Numpy Array):   Start time of each transmission (microseconds)
+        airtime (Numpy Array):      Duration of each transmission (microseconds), for
+            example the 'airtime' field of TX_LOW or RX_OFDM entries
+        interval (int, optional):   Length of each interval in microseconds (default is 1 second)
+        t_start (int, optional):    Start time of the first interval (defaults to the first timestamp)
+
+    Returns:
+        occupancy (tuple):
+            Tuple of (interval start times, fraction of each interval occupied)
+
+    Transmissions that cross an interval boundary are split between the two
+    intervals.  Overlapping transmissions (ie collisions) are counted twice, so
+    the occupancy of an interval can exceed 1.0 if entries from multiple nodes
+    are combined.
+    """
+    import numpy as np
+
+    timestamps = np.asarray(timestamps, dtype=np.uint64)
+    airtime    = np.asarray(airtime, dtype=np.uint64)
+
+    if (len(timestamps) == 0):
+        return (np.empty((0,), dtype=np.uint64), np.empty((0,), dtype=np.float64))
+
+    if t_start is None:
+        t_start = timestamps.min()
+
+    t_start  = np.uint64(t_start)
+    interval = np.uint64(interval)
+
+    rel_ts   = timestamps - t_start
+    bins     = rel_ts // interval
+    num_bins = int((rel_ts + airtime).max() // interval) + 1
+
+    # Portion of each transmission in its first interval and the remainder in the next
+    first    = np.minimum(airtime, ((bins + np.uint64(1)) * interval) - rel_ts)
+    busy     = np.bincount(bins.astype(np.int64), weights=first, minlength=num_bins)
+    busy    += np.bincount((bins + np.uint64(1)).astype(np.int64), weights=(airtime - first), minlength=num_bins + 1)[:num_bins]
+
+    return ((t_start + np.arange(num_bins, dtype=np.uint64) * interval), busy / float(interval))
+
+# End def
+
+
+
+def _phy_mode_to_index(phy_mode):
+    """Convert PHY mode names or indexes to a Numpy array of PHY mode indexes."""
+    import numpy as np
+    import wlan_exp.util as util
+
+    phy_mode = np.asarray(phy_mode)
+
+    if phy_mode.dtype.kind in ('U', 'S', 'O'):
+        phy_mode = np.array([util.phy_modes[p] for p in phy_mode.reshape(-1)]).reshape(phy_mode.shape)
+
+    return phy_mode.astype(np.intp)
+
+# End def
+
+
+
+_tx_time_luts = None
+
+def _get_tx_time_luts():
+    """Build (once) the lookup tables used by calc_tx_time().
+
+    Returns:
+        luts (dict):
+            * 'NDBPS':  Data bits per OFDM symbol indexed by [phy_mode, mcs]; 0 for invalid rates
+            * 'T_PREAMBLE', 'T_SIG', 'T_SYM', 'T_EXT':  Waveform section durations in
+              microseconds indexed by phy_samp_rate (10, 20, 40); 0 for invalid rates
+    """
+    import numpy as np
+    import wlan_exp.util as util
+
+    global _tx_time_luts
+
+    if _tx_time_luts is None:
+        ndbps = np.zeros((max(util.phy_modes.values()) + 1, 8), dtype=np.int64)
+
+        for p in (util.phy_modes['NONHT'], util.phy_modes['HTMF']):
+            for m in range(0, 8):
+                ndbps[p, m] = util.get_rate_info(m, p, 20)['NDBPS']
+
+        # Durations are indexed directly by phy_samp_rate (10, 20 or 40 MSps)
+        def samp_rate_lut(values):
+            lut = np.zeros((41,), dtype=np.int64)
+            lut[[10, 20, 40]] = values
+            return lut
+
+        _tx_time_luts = {'NDBPS'      : ndbps,
+                         'T_PREAMBLE' : samp_rate_lut((8, 16, 32)),
+                         'T_SIG'      : samp_rate_lut((2, 4, 8)),
+                         'T_SYM'      : samp_rate_lut((2, 4, 8)),
+                         'T_EXT'      : samp_rate_lut((6, 6, 6))}
+
+    return _tx_time_luts
+
+# End def
+
+
+
+def _calc_tx_time_lut(mcs, phy_mode, payload_length, phy_samp_rate):
+    """Compute OFDM transmission durations with the calc_tx_time() lookup tables.
+
+    Arguments must be valid (see calc_tx_time()); entries with an invalid rate
+    have a duration of 0.
+    """
+    import numpy as np
+    import wlan_exp.util as util
+
+    luts           = _get_tx_time_luts()
+
+    phy_samp_rate  = np.asarray(phy_samp_rate, dtype=np.intp)
+    phy_samp_rate  = np.where(phy_samp_rate < len(luts['T_SYM']), phy_samp_rate, 0)
+    payload_length = np.asarray(payload_length, dtype=np.int64)
+    ndbps          = luts['NDBPS'][phy_mode, np.asarray(mcs, dtype=np.intp) & 0x7]
+
+    T_SYM          = luts['T_SYM'][phy_samp_rate]
+
+    # Compute the number of symbols in DATA field (integer ceil infers any PAD bits)
     #  - 16 = LEN_SERVICE (2 bytes)
     #  - 6  = LEN_TAIL (6 bits)
-    #  - np.ceil() infers any PAD bits
-
-    num_data_syms = np.ceil((16.0 + 6.0 + 8*payload_length) / ndbps)
+    valid          = (ndbps != 0)
+    ndbps          = np.where(valid, ndbps, 1)
+    num_data_syms  = (16 + 6 + (8 * payload_length) + (ndbps - 1)) // ndbps
 
     # HTMF waveforms have 4 extra preamble symbols
     #  HT-SIG1, HT-SIG2, HT-STF, HT-LTF
     num_ht_preamble_syms = 4 * (phy_mode == util.phy_modes['HTMF'])
 
-    T_TOT = T_PREAMBLE + T_SIG + (T_SYM * num_ht_preamble_syms) + (T_SYM * num_data_syms) + T_EXT
+    T_TOT = (luts['T_PREAMBLE'][phy_samp_rate] + luts['T_SIG'][phy_samp_rate] + luts['T_EXT'][phy_samp_rate] +
+             (T_SYM * num_ht_preamble_syms) + (T_SYM * num_data_syms))
 
-    return T_TOT
+    return np.where(valid, T_TOT, 0)
 
 # End def
 
@@ -786,6 +1212,258 @@ def find_overlapping_tx_low(src_tx_low, int_tx_low):
 
 
 
+def find_tx_low_collisions(tx_low, rx=None, time_offsets=None, rx_time_tolerance=50, num_threads=None):
+    """Finds overlapping TX_LOW entries across the logs of many nodes.
+
+    Args:
+        tx_low (dict):                       Dictionary of ``{ <node> : <TX_LOW Numpy Array> }``
+        rx (dict, optional):                 Dictionary of ``{ <node> : <RX_OFDM Numpy Array> }``
+            used to determine the capture outcome of each collision
+        time_offsets (dict, optional):       Dictionary of ``{ <node> : <offset> }``; the offset
+            (microseconds) is added to the timestamps of the node to align it with the other nodes
+        rx_time_tolerance (int, optional):   Maximum difference (microseconds) between aligned
+            TX_LOW and RX_OFDM timestamps of the same packet
+        num_threads (int, optional):         Number of worker threads (default is the number of CPUs)
+
+    Returns:
+        collisions (dict):
+            * 'nodes':      List of node keys; node fields below index into this list
+            * 'collisions': Numpy structured array with one entry per pair of overlapping
+              transmissions from different nodes, with fields:
+
+              * 'node_a', 'idx_a': Node and TX_LOW index of the transmission that started first
+              * 'node_b', 'idx_b': Node and TX_LOW index of the other transmission
+              * 'timestamp':       Aligned start time of the overlap (start of transmission b)
+              * 'overlap':         Duration of the overlap in microseconds
+              * 'rx_good_a':       Number of nodes that received transmission a with a good FCS
+              * 'rx_good_b':       Number of nodes that received transmission b with a good FCS
+
+    Unlike find_overlapping_tx_low(), which compares one source flow with one
+    interfering flow, all nodes are processed together with a single
+    sweep-line pass, so the cost does not grow with the number of node pairs.
+    The rx_good fields are 0 if rx is not provided.  Receptions are matched to
+    transmissions by transmitter address ('addr2'), MAC sequence number and
+    aligned timestamp.
+    """
+    import numpy as np
+
+    import wlan_exp.log.coll_util as collision_utility
+
+    nodes = list(tx_low.keys())
+
+    if time_offsets is None:
+        time_offsets = {}
+
+    # Flatten all nodes' transmissions into single arrays
+    start    = []
+    airtime  = []
+    node_idx = []
+    tx_key   = []
+
+    for n, node in enumerate(nodes):
+        entries = tx_low[node]
+
+        start.append(entries['timestamp'].astype(np.int64) + int(time_offsets.get(node, 0)))
+        airtime.append(_calc_tx_time_lut(entries['mcs'], entries['phy_mode'].astype(np.intp), entries['length'], entries['phy_samp_rate']))
+        node_idx.append(np.full((len(entries),), n, dtype=np.uint16))
+        tx_key.append(_mac_seq_key(entries))
+
+    start    = np.concatenate(start)
+    airtime  = np.concatenate(airtime)
+    node_idx = np.concatenate(node_idx)
+    tx_key   = np.concatenate(tx_key)
+    entry_idx = np.concatenate([np.arange(len(tx_low[node]), dtype=np.uint64) for node in nodes])
+
+    (a, b, overlap) = collision_utility._collision_sweep(start, start + airtime, node_idx, num_threads=num_threads)
+
+    # Capture outcome:  number of nodes that decoded each transmission
+    if rx is not None:
+        rx_good = _count_rx_good(start, tx_key, rx, time_offsets, rx_time_tolerance)
+    else:
+        rx_good = np.zeros(start.shape, dtype=np.uint16)
+
+    collisions = np.empty((len(a),), dtype=[('node_a',    np.uint16), ('idx_a', np.uint64),
+                                             ('node_b',    np.uint16), ('idx_b', np.uint64),
+                                             ('timestamp', np.int64),  ('overlap', np.uint32),
+                                             ('rx_good_a', np.uint16), ('rx_good_b', np.uint16)])
+
+    collisions['node_a']    = node_idx[a]
+    collisions['idx_a']     = entry_idx[a]
+    collisions['node_b']    = node_idx[b]
+    collisions['idx_b']     = entry_idx[b]
+    collisions['timestamp'] = start[b]
+    collisions['overlap']   = overlap
+    collisions['rx_good_a'] = rx_good[a]
+    collisions['rx_good_b'] = rx_good[b]
+
+    return {'nodes' : nodes, 'collisions' : collisions}
+
+# End def
+
+
+
+def _mac_seq_key(entries):
+    """Combine the 'addr2' and 'mac_seq' fields of Tx/Rx entries into a single key."""
+    import numpy as np
+
+    return (entries['addr2'].astype(np.uint64) << np.uint64(12)) | (entries['mac_seq'].astype(np.uint64) & np.uint64(0xFFF))
+
+# End def
+
+
+
+def _count_rx_good(tx_ts, tx_key, rx, time_offsets, tolerance):
+    """Count the receptions with good FCS of each transmission.
+
+    A reception matches a transmission if it has the same transmitter address
+    and sequence number and its aligned timestamp is within the tolerance.
+    """
+    import numpy as np
+    from .entry_types import log_entry_types
+
+    fcs_good = log_entry_types['RX_OFDM'].consts['flags']['FCS_GOOD']
+
+    rx_good = np.zeros(tx_ts.shape, dtype=np.uint16)
+
+    for node, entries in rx.items():
+        good   = (entries['flags'] & fcs_good) != 0
+        rx_ts  = entries['timestamp'][good].astype(np.int64) + int(time_offsets.get(node, 0))
+        rx_key = _mac_seq_key(entries[good])
+
+        order  = np.argsort(rx_ts, kind='mergesort')
+        rx_ts  = rx_ts[order]
+        rx_key = rx_key[order]
+
+        # Receptions within the time window of each transmission
+        lo     = np.searchsorted(rx_ts, tx_ts - tolerance, side='left')
+        hi     = np.searchsorted(rx_ts, tx_ts + tolerance, side='right')
+        counts = hi - lo
+        total  = int(counts.sum())
+
+        if (total == 0):
+            continue
+
+        tx_i  = np.repeat(np.arange(len(tx_ts)), counts)
+        rx_i  = np.repeat(lo, counts) + (np.arange(total) - np.repeat(np.cumsum(counts) - counts, counts))
+
+        match = np.unique(tx_i[rx_key[rx_i] == tx_key[tx_i]])
+
+        # Count each receiving node at most once per transmission
+        rx_good[match] += 1
+
+    return rx_good
+
+# End def
+
+
+
+def calc_clock_model(time_info, ref_time_info=None):
+    """Fit a model that maps a node's MAC time to a global time base.
+
+    Args:
+        time_info (Numpy Array):                TIME_INFO entries from the node's log
+        ref_time_info (Numpy Array, optional):  TIME_INFO entries from the log of a
+            reference node
+
+    Returns:
+        clock_model (dict):
+            * 'local':  Local (MAC) time of the reference point
+            * 'global': Global time of the reference point
+            * 'drift':  Global microseconds per local microsecond
+
+    If ref_time_info is not provided, the global time base is the host time
+    recorded in the TIME_INFO entries (see ``WlanExpNode.log_write_time()``);
+    entries without a host time are ignored.  Otherwise, the global time base is
+    the MAC time of the reference node and the sync points are the TIME_INFO
+    entries with the same 'time_id' in both logs (for example, those created by
+    a broadcast ``log_write_time()``).
+
+    The model is a least squares line through the sync points:
+    ``global = model['global'] + model['drift'] * (local - model['local'])``.
+    With a single sync point the drift is 1.0.  The model assumes the MAC time
+    of the node was not changed in the part of the log being aligned.
+    """
+    import numpy as np
+    from .entry_types import log_entry_types
+
+    set_time = log_entry_types['TIME_INFO'].consts['reason']['WLAN_EXP_SET_TIME']
+
+    time_info = time_info[time_info['reason'] != set_time]
+
+    if ref_time_info is None:
+        valid   = time_info['host_timestamp'] != 0xFFFFFFFFFFFFFFFF
+        local   = time_info['timestamp'][valid]
+        global_ = time_info['host_timestamp'][valid]
+    else:
+        ref_time_info = ref_time_info[ref_time_info['reason'] != set_time]
+
+        (_, idx, ref_idx) = np.intersect1d(time_info['time_id'], ref_time_info['time_id'], return_indices=True)
+
+        local   = time_info['timestamp'][idx]
+        global_ = ref_time_info['timestamp'][ref_idx]
+
+    if (len(local) == 0):
+        raise AttributeError("No TIME_INFO sync points to fit the clock model.")
+
+    # Fit relative to the first sync point to preserve precision in float64
+    local_0  = int(local[0])
+    global_0 = int(global_[0])
+
+    x = local.astype(np.int64) - local_0
+    y = global_.astype(np.int64) - global_0
+
+    if (len(local) == 1) or np.all(x == 0):
+        drift = 1.0
+        shift = float(y.mean())
+    else:
+        (drift, shift) = np.polyfit(x.astype(np.float64), y.astype(np.float64), 1)
+
+    return {'local' : local_0, 'global' : global_0 + int(round(shift)), 'drift' : float(drift)}
+
+# End def
+
+
+
+def apply_clock_model(timestamps, clock_model):
+    """Convert local (MAC) timestamps to the global time base of a clock model.
+
+    Args:
+        timestamps (Numpy Array):  Local timestamps in microseconds
+        clock_model (dict):        Clock model from calc_clock_model()
+
+    Returns:
+        timestamps (Numpy Array):  Global timestamps in microseconds (int64)
+    """
+    import numpy as np
+
+    x = np.asarray(timestamps).astype(np.int64) - clock_model['local']
+
+    return clock_model['global'] + np.rint(x * clock_model['drift']).astype(np.int64)
+
+# End def
+
+
+
+def invert_clock_model(timestamps, clock_model):
+    """Convert global timestamps to the local (MAC) time base of a clock model.
+
+    Args:
+        timestamps (Numpy Array):  Global timestamps in microseconds
+        clock_model (dict):        Clock model from calc_clock_model()
+
+    Returns:
+        timestamps (Numpy Array):  Local timestamps in microseconds (int64)
+    """
+    import numpy as np
+
+    y = np.asarray(timestamps).astype(np.int64) - clock_model['global']
+
+    return clock_model['local'] + np.rint(y / clock_model['drift']).astype(np.int64)
+
+# End def
+
+
+
 def convert_datetime_to_log_time_str(datetime_obj):
     """Convert a datetime object to a log time string.
 
@@ -1000,3 +1678,74 @@ def _get_safe_filename(filename, print_warnings=True):
 # End def
 
 
+
+def _gather_u64(log_data, offsets):
+    """Read a little-endian uint64 at each of the given offsets in log_data."""
+    return read_byte_fields(log_data, offsets, 8).view('<u8').reshape(-1)
+
+# End def
+
+
+
+def _get_byte_windows(log_data, size):
+    """Overlapping view of log_data where row i holds the size bytes at offset i.
+
+    Indexing the rows with an array of offsets gathers (or scatters) all of the
+    fields in one numpy operation.  The view is writable if log_data is.
+    """
+    import numpy as np
+
+    data_u8 = np.frombuffer(log_data, dtype=np.uint8)
+    rows    = max(len(data_u8) - size + 1, 0)
+
+    return np.lib.stride_tricks.as_strided(data_u8, shape=(rows, size), strides=(1, 1),
+                                           writeable=data_u8.flags.writeable)
+
+# End def
+
+
+
+def _read_entry_headers(log_data, byte_offsets):
+    """Check the entry headers before the given offsets and return (entry type IDs, entry sizes)."""
+    import numpy as np
+
+    offsets = np.asarray(byte_offsets, dtype=np.int64).reshape(-1)
+    hdrs    = read_byte_fields(log_data, offsets - LOG_ENTRY_HDR_SIZE, LOG_ENTRY_HDR_SIZE).astype(np.int64)
+
+    invalid = np.flatnonzero((hdrs[:, 2] != 0xED) | (hdrs[:, 3] != 0xAC))
+
+    if len(invalid):
+        raise Exception("ERROR: Offset not a valid entry header (offset {0})!".format(offsets[invalid[0]]))
+
+    return ((hdrs[:, 4] + (hdrs[:, 5] * 256)), (hdrs[:, 6] + (hdrs[:, 7] * 256)))
+
+# End def
+
+
+
+def _zero_byte_ranges(log_data, starts, lengths, max_bytes=2**24):
+    """Write zeros to the byte ranges [start, start + length) of log_data."""
+    import numpy as np
+
+    data_u8 = np.frombuffer(log_data, dtype=np.uint8)
+    starts  = np.asarray(starts, dtype=np.int64)
+    lengths = np.asarray(lengths, dtype=np.int64)
+
+    # Expand the ranges to byte indexes in groups of about max_bytes bytes
+    #   to bound the size of the index array
+    total      = int(lengths.sum())
+    group_ends = np.searchsorted(np.cumsum(lengths), np.arange(max_bytes, total + max_bytes, max_bytes), side='right')
+    group_ends = np.unique(np.append(np.maximum(group_ends, 1), len(lengths)))
+    start      = 0
+
+    for end in group_ends.tolist():
+        g_starts  = starts[start:end]
+        g_lengths = lengths[start:end]
+        range_pos = np.cumsum(g_lengths) - g_lengths
+
+        idx = np.repeat(g_starts - range_pos, g_lengths) + np.arange(g_lengths.sum())
+
+        data_u8[idx] = 0
+        start        = end
+
+# End def
@@ -0,0 +1,294 @@
+# -*- coding: utf-8 -*-
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design Experiments Framework - Log Capture Utilities
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+
+This module provides a background service to continuously read the log of a
+node and write it to a log container.
+
+Reading the log (``node.log_get_all_new()``) and writing it to a file run in
+separate threads connected by a bounded queue of log data chunks.  While the
+writer thread is writing (and compressing) one chunk, the receive thread is
+already reading the next one from the node, so the capture rate is limited by
+the slower of the two instead of their sum.  If the writer falls behind by
+more than the queue length, the receive thread blocks until a chunk has been
+written.
+
+The receive thread also tracks how much of the node's log memory fills up
+between reads and shortens its polling interval when the log fills quickly,
+so the log is read well before it can wrap.
+
+Example:
+::
+
+    import wlan_exp.log.util_hdf as hdf_util
+    import wlan_exp.log.util_capture as capture_util
+
+    h5_file       = hdf_util.hdf5_open_file('capture.hdf5')
+    log_container = hdf_util.HDF5LogContainer(h5_file, compression='gzip')
+
+    capture = capture_util.LogCaptureService(node, log_container, interval=10)
+    capture.start()
+
+    ...
+
+    capture.stop()
+    log_container.write_log_index()
+    hdf_util.hdf5_close_file(h5_file)
+
+Once the service is started, all commands to the node should go through the
+service (e.g. ``get_status()``), since the node transport is used by the
+receive thread.
+"""
+
+__all__ = ['LogCaptureService']
+
+import sys
+import threading
+
+
+# Fix to support Python 2.x and 3.x
+if sys.version[0]=="3": long=None
+
+
+# -----------------------------------------------------------------------------
+# Log Capture Service Class
+# -----------------------------------------------------------------------------
+class LogCaptureService(object):
+    """Background service that reads a node's log and writes it to a log container.
+
+    Args:
+        node (WlanExpNode):                Node to read the log from
+        log_container (LogContainer):      Container to write the log data to (e.g. HDF5LogContainer;
+            enable compression on the container to compress in the writer thread)
+        interval (float, optional):        Maximum time in seconds between log reads
+        min_interval (float, optional):    Minimum time in seconds between log reads
+        fill_target (float, optional):     Fraction of the node's log capacity that should fill
+            up between reads.  The polling interval is shortened (down to ``min_interval``)
+            when the log fills faster than this.
+        num_buffers (int, optional):       Number of log data chunks that can wait to be written
+        log_tail_pad (int, optional):      See ``node.log_get_all_new()``
+        max_req_size (int, optional):      See ``node.log_get_all_new()``
+        callback (callable, optional):     Called by the writer thread with each chunk of log
+            data after it is written (e.g. ``OnlineLogAnalyzer.update``)
+
+    Errors in either thread stop the service and are raised again by ``stop()``.
+    """
+    node              = None
+    log_container     = None
+    interval          = None
+    min_interval      = None
+    max_interval      = None
+    fill_target       = None
+    log_tail_pad      = None
+    max_req_size      = None
+    callback          = None
+
+    bytes_read        = None             # Total number of bytes read from the node
+    bytes_written     = None             # Total number of bytes written to the log container
+    num_reads         = None             # Number of reads that returned log data
+    fill_level        = None             # Fraction of the log capacity read by the last read
+    read_rate         = None             # Rate the node's log fills (bytes / sec)
+    max_queue_depth   = None             # Largest number of chunks waiting to be written
+
+    _queue            = None
+    _stop_event       = None
+    _recv_thread      = None
+    _write_thread     = None
+    _last_read_time   = None
+    _error            = None
+
+    def __init__(self, node, log_container, interval=10.0, min_interval=0.1, fill_target=0.25,
+                 num_buffers=4, log_tail_pad=500, max_req_size=2**23, callback=None):
+        try:
+            import queue
+        except ImportError:
+            import Queue as queue
+
+        self.node          = node
+        self.log_container = log_container
+        self.interval      = interval
+        self.min_interval  = min(min_interval, interval)
+        self.max_interval  = interval
+        self.fill_target   = fill_target
+        self.log_tail_pad  = log_tail_pad
+        self.max_req_size  = max_req_size
+        self.callback      = callback
+
+        self._queue        = queue.Queue(maxsize=num_buffers)
+        self._stop_event   = threading.Event()
+
+        self.bytes_read      = 0
+        self.bytes_written   = 0
+        self.num_reads       = 0
+        self.fill_level      = 0.0
+        self.read_rate       = 0.0
+        self.max_queue_depth = 0
+
+
+    def start(self):
+        """Start the receive and writer threads."""
+        import time
+
+        if self.is_running():
+            return
+
+        # Get the capacity of the node's log (see node.log_get_capacity())
+        self.node.log_get_size()
+
+        self._error          = None
+        self._last_read_time = time.time()
+        self._stop_event.clear()
+
+        self._write_thread        = threading.Thread(target=self._write_loop)
+        self._write_thread.daemon = True
+        self._write_thread.start()
+
+        self._recv_thread         = threading.Thread(target=self._recv_loop)
+        self._recv_thread.daemon  = True
+        self._recv_thread.start()
+
+
+    def stop(self, read_remaining=True):
+        """Stop the service once all log data that was read has been written.
+
+        Args:
+            read_remaining (bool, optional):  Read the remaining log data (without any
+                ``log_tail_pad``) from the node before stopping
+        """
+        self._stop_event.set()
+
+        if self._recv_thread is not None:
+            self._recv_thread.join()
+            self._recv_thread = None
+
+        if self._write_thread is not None:
+            if read_remaining and (self._error is None):
+                try:
+                    self._read_log(log_tail_pad=0)
+                except Exception as err:
+                    self._error = err
+
+            # Tell the writer thread there is no more data
+            self._queue.put(None)
+
+            self._write_thread.join()
+            self._write_thread = None
+
+        if self._error is not None:
+            raise self._error
+
+
+    def is_running(self):
+        """Return whether the service is running."""
+        return (self._recv_thread is not None) and self._recv_thread.is_alive()
+
+
+    def get_status(self):
+        """Get the state of the service.
+
+        Returns:
+            status (dict):  Dictionary with the keys 'bytes_read', 'bytes_written', 'num_reads',
+                'queue_depth', 'max_queue_depth', 'interval', 'fill_level' and 'read_rate'
+        """
+        return {'bytes_read'      : self.bytes_read,
+                'bytes_written'   : self.bytes_written,
+                'num_reads'       : self.num_reads,
+                'queue_depth'     : self._queue.qsize(),
+                'max_queue_depth' : self.max_queue_depth,
+                'interval'        : self.interval,
+                'fill_level'      : self.fill_level,
+                'read_rate'       : self.read_rate}
+
+
+    # -------------------------------------------------------------------------
+    # Internal methods
+    # -------------------------------------------------------------------------
+    def _recv_loop(self):
+        """Receive thread:  periodically read new log data from the node."""
+        import time
+
+        try:
+            while not self._stop_event.is_set():
+                start_time = time.time()
+
+                self._read_log(self.log_tail_pad)
+
+                # Wait for the rest of the polling interval (or until stop() is called)
+                self._stop_event.wait(max(0.0, self.interval - (time.time() - start_time)))
+
+        except Exception as err:
+            self._error = err
+            self._stop_event.set()
+
+
+    def _read_log(self, log_tail_pad):
+        """Read the new log data from the node and queue it for the writer thread."""
+        import time
+
+        data     = self.node.log_get_all_new(log_tail_pad=log_tail_pad, max_req_size=self.max_req_size).get_bytes()
+        now      = time.time()
+        elapsed  = now - self._last_read_time
+
+        self._last_read_time = now
+
+        if (len(data) > 0):
+            # Blocks while the writer thread is num_buffers chunks behind
+            self._queue.put(data)
+
+            self.bytes_read     += len(data)
+            self.num_reads      += 1
+            self.max_queue_depth = max(self.max_queue_depth, self._queue.qsize())
+
+        self._update_interval(len(data), elapsed)
+
+
+    def _update_interval(self, read_size, elapsed):
+        """Adapt the polling interval to how fast the node's log fills."""
+        capacity = self.node.log_get_capacity()
+
+        if not capacity or (elapsed <= 0):
+            return
+
+        self.fill_level = float(read_size) / capacity
+
+        # Smooth the fill rate over a few reads
+        rate           = read_size / elapsed
+        self.read_rate = rate if (self.read_rate == 0.0) else (0.5 * self.read_rate + 0.5 * rate)
+
+        if (self.read_rate > 0):
+            interval = (self.fill_target * capacity) / self.read_rate
+        else:
+            interval = self.max_interval
+
+        self.interval = min(max(interval, self.min_interval), self.max_interval)
+
+
+    def _write_loop(self):
+        """Writer thread:  write queued log data to the log container."""
+        while True:
+            data = self._queue.get()
+
+            if data is None:
+                break
+
+            # Keep draining the queue after an error so the receive thread does not block
+            if self._error is not None:
+                continue
+
+            try:
+                self.log_container.write_log_data(data)
+                self.bytes_written += len(data)
+
+                if self.callback is not None:
+                    self.callback(data)
+
+            except Exception as err:
+                self._error = err
+                self._stop_event.set()
+
+# End class()
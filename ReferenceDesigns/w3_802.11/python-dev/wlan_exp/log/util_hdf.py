@@ -31,6 +31,10 @@ wlan_exp_log_data_container (equivalent to a HDF5 group):
 |- <int>    (N1,)     uint32/uint64
 |- <int>    (N2,)     uint32/uint64
 |- ...
+|- 'log_ts_index' (created with the raw_log_index when the log_data is indexed)
+|- Datasets:
+|- <int>    (N1,)     [('timestamp', uint64), ('offset', uint64)]
+|- ...
 
 Naming convention:
 
@@ -59,6 +63,10 @@ http://www.numpy.org/
 
 __all__ = ['np_arrays_to_hdf5',
            'HDF5LogContainer',
+           'HDF5ColumnarLogContainer',
+           'log_data_to_hdf5_columnar',
+           'hdf5_columnar_to_column',
+           'merge_logs_to_hdf5_columnar',
            'hdf5_open_file',
            'hdf5_close_file',
            'log_data_to_hdf5',
@@ -201,11 +209,8 @@ class HDF5LogContainer(log_util.LogContainer):
         # Get total length of data
         length = curr_length + log_data_length
 
-        # Create empyt numpy container
-        np_data = np.empty((log_data_length,), np_dt)
-
-        # Redirect numpy array data pointer to the existing buffer object passed in by user
-        np_data.data = log_data
+        # Create a numpy array that uses the existing buffer object passed in by user
+        np_data = np.frombuffer(log_data, dtype=np_dt)
 
         ds.resize((length,))
         ds[curr_length:length,] = np_data
@@ -220,7 +225,11 @@ class HDF5LogContainer(log_util.LogContainer):
         If the log index currently exists in the HDF5 file, that log index
         will be replaced with this new log index.  If log_index is provided
         then that log index will be written to the log container.  Otherwise,
-        a raw log index will be generated and added to the log container.
+        a raw log index and its timestamp index will be generated and added
+        to the log container.
+
+        Any existing timestamp index is removed when a log_index is provided;
+        use write_log_ts_index() to add the matching timestamp index.
         """
         import numpy as np
 
@@ -229,9 +238,15 @@ class HDF5LogContainer(log_util.LogContainer):
 
         index_name   = "log_index"
         group_handle = self._get_valid_group_handle()
+        log_ts_index = None
 
         if log_index is None:
-            log_index = self._create_raw_log_index()
+            try:
+                log_data     = self.get_log_data()
+                log_index    = log_util.gen_raw_log_index(log_data)
+                log_ts_index = log_util.gen_log_timestamp_index(log_data, log_index)
+            except AttributeError:
+                log_index    = None
 
             if log_index is None:
                 raise AttributeError("Unable to create raw log index for group: {0}\n".format(group_handle))
@@ -265,6 +280,40 @@ class HDF5LogContainer(log_util.LogContainer):
             print("ERROR:\n    {0}\n".format(err))
             raise AttributeError("Unable to add log_index to log container: {0}\n".format(group_handle))
 
+        self.write_log_ts_index(log_ts_index)
+
+
+    def write_log_ts_index(self, log_ts_index):
+        """Write the timestamp index to the log container.
+
+        Args:
+            log_ts_index (dict):  Timestamp index generated from wlan_exp log data
+                (see log_util.gen_log_timestamp_index()).  If None, any existing
+                timestamp index is removed from the log container.
+        """
+        import numpy as np
+
+        if not self._file_writeable():
+            raise AttributeError("File {0} is not writeable.".format(self.file_handle))
+
+        index_name   = "log_ts_index"
+        group_handle = self._get_valid_group_handle()
+
+        if index_name in group_handle:
+            del group_handle[index_name]
+
+        if log_ts_index is None:
+            return
+
+        try:
+            index_grp = group_handle.create_group(index_name)
+
+            for k, v in log_ts_index.items():
+                index_grp.create_dataset(str(k), data=np.asarray(v, dtype=log_util.log_ts_index_dtype), compression=self.compression)
+        except Exception as err:
+            print("ERROR:\n    {0}\n".format(err))
+            raise AttributeError("Unable to add log_ts_index to log container: {0}\n".format(group_handle))
+
 
     def write_attr_dict(self, attr_dict):
         """Add the given attribute dictionary to the opened log container.
@@ -340,16 +389,20 @@ class HDF5LogContainer(log_util.LogContainer):
         return log_data
 
 
-    def get_log_index(self, gen_index=True):
+    def get_log_index(self, gen_index=True, as_np=False):
         """Get the raw log index from the log container.
 
         Args:
             gen_index (bool, optional):  Generate the raw log index if the log index does not
                 exist in the log container.
+            as_np (bool, optional):  Return the offsets as numpy int64 arrays instead of
+                Python lists (see log_util.log_index_to_np())
         
         Returns:
             log_index (dict):  Log index from the log container
         """
+        import numpy as np
+
         error        = False
         log_index    = {}
         group_handle = self._get_valid_group_handle()
@@ -364,10 +417,15 @@ class HDF5LogContainer(log_util.LogContainer):
                 #   the [:] slice here is important - flattening the returned numpy array before
                 #   listifying is *way* faster (>10x) than just v.toList()
 
+                if as_np:
+                    offsets = v[:].astype(np.int64)
+                else:
+                    offsets = v[:].tolist()
+
                 try:
-                    log_index[int(k)] = v[:].tolist()
+                    log_index[int(k)] = offsets
                 except ValueError:
-                    log_index[k]      = v[:].tolist()
+                    log_index[k]      = offsets
 
                 # Alternative to [:].toList() above - adds safetly in assuring dictionary value is
                 #   Python list of ints, an requirement of downstream methods
@@ -381,6 +439,9 @@ class HDF5LogContainer(log_util.LogContainer):
         if error and gen_index:
             log_index = self._create_raw_log_index()
 
+            if as_np:
+                log_index = log_util.log_index_to_np(log_index)
+
         # If the log index is empty or None, then raise an exception
         if not log_index:
             msg  = "Unable to get log index from "
@@ -390,6 +451,33 @@ class HDF5LogContainer(log_util.LogContainer):
         return log_index
 
 
+    def get_log_ts_index(self, gen_index=True):
+        """Get the timestamp index from the log container.
+
+        Args:
+            gen_index (bool, optional):  Generate the timestamp index if it does not
+                exist in the log container.
+
+        Returns:
+            log_ts_index (dict):  Timestamp index from the log container (see
+                log_util.gen_log_timestamp_index())
+        """
+        log_ts_index = {}
+        group_handle = self._get_valid_group_handle()
+
+        try:
+            index_group = group_handle["log_ts_index"]
+
+            for k, v in index_group.items():
+                log_ts_index[int(k)] = v[:]
+
+        except KeyError:
+            if gen_index:
+                log_ts_index = log_util.gen_log_timestamp_index(self.get_log_data(), self.get_log_index())
+
+        return log_ts_index
+
+
     def get_attr_dict(self):
         """Get the attribute dictionary from the log container.
         
@@ -502,6 +590,347 @@ class HDF5LogContainer(log_util.LogContainer):
 
 
 
+# -----------------------------------------------------------------------------
+# HDF5 Columnar Log Container Class
+# -----------------------------------------------------------------------------
+class HDF5ColumnarLogContainer(object):
+    """Class to define a columnar HDF5 log container.
+
+    Args:
+        file_handle (h5py.File()):        Handle of the HDF5 file
+        name (str, optional):             Name of the HDF5 group of the log container
+        compression (str, optional):      HDF5 compression filter:  None, 'gzip', 'lzf' or 'blosc'
+        compression_opts (int, optional): Compression level for 'gzip' (0 - 9) or 'blosc' (0 - 9)
+        chunk_entries (int, optional):    Number of entries per HDF5 chunk of each column
+
+    The columnar log container stores decoded log entries instead of raw log
+    data.  Each entry type is a group named after the entry type and each
+    field of the entry type is a chunked, extensible dataset in that group:
+
+    /: Group of the log container
+    |- Attributes:
+    |      |- 'wlan_exp_log'         (1,)      bool
+    |      |- 'wlan_exp_ver'         (3,)      uint32
+    |      |- 'wlan_exp_log_layout'  str       'columnar'
+    |- Groups:
+    |      |- <entry type name>
+    |      |      |- Attributes:
+    |      |      |      |- 'entry_type_id'    uint32
+    |      |      |- Datasets:
+    |      |      |      |- <field name>    (N,)     <field dtype>
+    |      |      |      |- ...
+
+    Log data can be appended as it is read from the node (for example, the
+    bytes of each buffer returned by ``log_get_all_new()``) with
+    ``append_log_data()``.  Log
+    data does not have to end on an entry boundary; any trailing partial entry
+    is held until the next call.  Because each field is stored separately, a
+    single column (such as 'timestamp') can be read without reading or
+    decompressing any other field.
+
+    The 'blosc' filter requires the hdf5plugin package.
+    """
+    hdf5_group_name          = None
+    compression_kwargs       = None
+    chunk_entries            = None
+
+    _log_data_tail           = None
+
+
+    def __init__(self, file_handle, name=None, compression='gzip', compression_opts=None, chunk_entries=2**14):
+        self.file_handle        = file_handle
+        self.chunk_entries      = chunk_entries
+        self.compression_kwargs = _get_compression_kwargs(compression, compression_opts)
+        self._log_data_tail     = b''
+
+        if name is None:
+            self.hdf5_group_name = "/"
+        else:
+            self.hdf5_group_name = name
+
+
+    def is_valid(self):
+        """Check that the columnar HDF5 Log Container is valid.
+
+        Returns:
+            is_valid (bool):
+                * True --> This is a valid columnar HDF5 log container
+                * False --> This is NOT a valid columnar HDF5 log container
+        """
+        try:
+            group_handle = self.file_handle[self.hdf5_group_name]
+            layout       = group_handle.attrs['wlan_exp_log_layout']
+        except KeyError:
+            return False
+
+        if isinstance(layout, bytes):
+            layout = layout.decode('utf-8')
+
+        return (layout == 'columnar')
+
+
+    def append_log_data(self, log_data, include_only=None):
+        """Decode the log data and append the entries to the log container.
+
+        Args:
+            log_data (bytes):                Binary data from a WlanExpNode log
+            include_only (list, optional):   List of entry type names to store;
+                all entry types in the log data are stored by default
+
+        Returns:
+            num_entries (int):  Number of entries appended to the log container
+
+        The first call must start on an entry boundary (i.e. the beginning of
+        the log or the start of a ``log_get_all_new()`` read after a reset).
+        Consecutive calls must provide consecutive log data.
+        """
+        log_data = self._log_data_tail + bytes(log_data)
+
+        raw_log_index = log_util.gen_raw_log_index(log_data)
+
+        if not raw_log_index:
+            self._log_data_tail = log_data
+            return 0
+
+        # Hold any trailing partial entry until the next call
+        next_hdr_offset     = log_util.calc_next_entry_offset(log_data, raw_log_index) - 8
+        self._log_data_tail = log_data[next_hdr_offset:]
+
+        log_index = log_util.filter_log_index(raw_log_index, include_only=include_only)
+        np_arrays = log_util.log_data_to_np_arrays(log_data, log_index)
+
+        return self.append_np_arrays(dict((k.name, v) for k, v in np_arrays.items()))
+
+
+    def append_np_arrays(self, np_log_dict):
+        """Append decoded log entries to the log container.
+
+        Args:
+            np_log_dict (dict):  Dictionary of ``{ <entry type name> : <numpy structured array> }``
+
+        Returns:
+            num_entries (int):  Number of entries appended to the log container
+        """
+        num_entries = 0
+
+        for name, np_arr in np_log_dict.items():
+            if (len(np_arr) == 0):
+                continue
+
+            num_entries += self.append_columns(name, dict((f, np_arr[f]) for f in np_arr.dtype.names), flush=False)
+
+        self.file_handle.flush()
+
+        return num_entries
+
+
+    def append_columns(self, entry_type, columns, flush=True):
+        """Append values to the columns of an entry type.
+
+        Args:
+            entry_type (str):        Name of the entry type (ie group) to append to
+            columns (dict):          Dictionary of ``{ <field name> : <Numpy Array> }``; all
+                arrays must have the same length
+            flush (bool, optional):  Flush the HDF5 file after the append
+
+        Returns:
+            num_entries (int):  Number of entries appended to the log container
+
+        This can be used to store fields that are not part of the entry type
+        definition (for example, a node ID when the entries of several logs are
+        combined).  Every call must provide the same set of fields.
+        """
+        from .entry_types import log_entry_types
+
+        if not self._file_writeable():
+            raise AttributeError("File {0} is not writeable.".format(self.file_handle))
+
+        group_handle = self._get_valid_group_handle()
+
+        try:
+            entry_group = group_handle[entry_type]
+        except KeyError:
+            entry_group = group_handle.create_group(entry_type)
+
+            try:
+                entry_group.attrs['entry_type_id'] = log_entry_types[entry_type].entry_type_id
+            except KeyError:
+                pass
+
+        num_entries = 0
+
+        for field, values in columns.items():
+            self._append_column(entry_group, field, values)
+            num_entries = len(values)
+
+        if flush:
+            self.file_handle.flush()
+
+        return num_entries
+
+
+    def get_entry_types(self):
+        """Get the entry types in the log container.
+
+        Returns:
+            entry_types (list of str):  Names of the entry types in the log container
+        """
+        return list(self._get_group_handle().keys())
+
+
+    def get_num_entries(self, entry_type):
+        """Get the number of entries of an entry type in the log container.
+
+        Args:
+            entry_type (str):  Name of the entry type
+
+        Returns:
+            num_entries (int):  Number of entries of the given entry type
+        """
+        try:
+            entry_group = self._get_group_handle()[entry_type]
+        except KeyError:
+            return 0
+
+        for ds in entry_group.values():
+            return ds.shape[0]
+
+        return 0
+
+
+    def get_fields(self, entry_type):
+        """Get the field names of an entry type in the log container.
+
+        Args:
+            entry_type (str):  Name of the entry type
+
+        Returns:
+            fields (list of str):  Field names of the given entry type
+        """
+        return list(self._get_group_handle()[entry_type].keys())
+
+
+    def get_column(self, entry_type, field, start=None, stop=None):
+        """Get a single field of an entry type from the log container.
+
+        Args:
+            entry_type (str):       Name of the entry type
+            field (str):            Name of the field
+            start (int, optional):  Index of the first entry to read
+            stop (int, optional):   Index after the last entry to read
+
+        Returns:
+            column (Numpy Array):  Values of the field.  Only the chunks of the
+                requested field that overlap [start, stop) are read.
+        """
+        return self._get_group_handle()[entry_type][field][start:stop]
+
+
+    def get_np_array(self, entry_type, fields=None, start=None, stop=None):
+        """Get a numpy structured array of an entry type from the log container.
+
+        Args:
+            entry_type (str):         Name of the entry type
+            fields (list, optional):  Field names to read; all fields by default
+            start (int, optional):    Index of the first entry to read
+            stop (int, optional):     Index after the last entry to read
+
+        Returns:
+            np_array (Numpy Array):  Numpy structured array containing only the requested fields
+        """
+        import numpy as np
+
+        entry_group = self._get_group_handle()[entry_type]
+
+        if fields is None:
+            fields = self._get_field_order(entry_type, entry_group)
+
+        columns = [entry_group[f][start:stop] for f in fields]
+        np_dt   = np.dtype([(f, c.dtype, c.shape[1:]) for f, c in zip(fields, columns)])
+
+        if columns:
+            np_arr = np.empty((len(columns[0]),), dtype=np_dt)
+        else:
+            np_arr = np.empty((0,), dtype=np_dt)
+
+        for f, c in zip(fields, columns):
+            np_arr[f] = c
+
+        return np_arr
+
+
+    # -------------------------------------------------------------------------
+    # Internal methods for the container
+    # -------------------------------------------------------------------------
+    def _append_column(self, entry_group, field, values):
+        """Internal method to append values to a column dataset."""
+        try:
+            ds = entry_group[field]
+        except KeyError:
+            ds = entry_group.create_dataset(field,
+                                            shape=(0,) + values.shape[1:],
+                                            maxshape=(None,) + values.shape[1:],
+                                            dtype=values.dtype,
+                                            chunks=(self.chunk_entries,) + values.shape[1:],
+                                            **self.compression_kwargs)
+
+        curr_length = ds.shape[0]
+
+        ds.resize(curr_length + len(values), axis=0)
+        ds[curr_length:] = values
+
+
+    def _get_field_order(self, entry_type, entry_group):
+        """Internal method to order fields as in the entry type definition."""
+        from .entry_types import log_entry_types
+
+        fields = list(entry_group.keys())
+
+        try:
+            names = log_entry_types[entry_type].get_field_names()
+        except KeyError:
+            return fields
+
+        return [f for f in names if f in fields] + [f for f in fields if f not in names]
+
+
+    def _get_group_handle(self):
+        """Internal method to get a handle to the HDF5 group of the container."""
+        if (self.hdf5_group_name == "/"):
+            return self.file_handle
+
+        return self.file_handle[self.hdf5_group_name]
+
+
+    def _get_valid_group_handle(self):
+        """Internal method to get a handle to a valid columnar log container."""
+        import numpy as np
+        import wlan_exp.version as version
+
+        if (self.hdf5_group_name == "/"):
+            group = self.file_handle
+        else:
+            group = self.file_handle.require_group(self.hdf5_group_name)
+
+        if 'wlan_exp_log_layout' not in group.attrs:
+            group.attrs['wlan_exp_log']        = np.array([1], dtype=np.uint8)
+            group.attrs['wlan_exp_ver']        = np.array(version.wlan_exp_ver(), dtype=np.uint32)
+            group.attrs['wlan_exp_log_layout'] = 'columnar'
+
+        return group
+
+
+    def _file_writeable(self):
+        """Internal method to check if the HDF5 file is writeable."""
+        if (self.file_handle.mode == 'r'):
+            return False
+        else:
+            return True
+
+# End class()
+
+
+
 # -----------------------------------------------------------------------------
 # Log HDF5 file Utilities
 # -----------------------------------------------------------------------------
@@ -622,6 +1051,7 @@ def log_data_to_hdf5(log_data, filename, attr_dict=None, gen_index=True, overwri
         if gen_index:
             raw_log_index = log_util.gen_raw_log_index(log_data)
             container.write_log_index(raw_log_index)
+            container.write_log_ts_index(log_util.gen_log_timestamp_index(log_data, raw_log_index))
 
         # Add the attribute dictionary to the group
         if attr_dict is not None:
@@ -679,7 +1109,7 @@ def hdf5_to_log_data(filename, group_name=None):
 
 
 
-def hdf5_to_log_index(filename, group_name=None, gen_index=True):
+def hdf5_to_log_index(filename, group_name=None, gen_index=True, as_np=False):
     """Extract the log_index from an HDF5 Log Container
 
     Args:
@@ -688,6 +1118,8 @@ def hdf5_to_log_index(filename, group_name=None, gen_index=True):
             (defaults to "\")
         gen_index (bool, optional):  Generate the ``raw_log_index`` from the ``log_data`` and 
             store it in the file if the ``log_index`` is not in the file.
+        as_np (bool, optional):  Return the offsets as numpy int64 arrays instead of
+            Python lists
 
     Returns:
         log_index (dict):  Either the ``log_index`` from HDF5 file or a generated  ``raw_log_index`` 
@@ -705,7 +1137,7 @@ def hdf5_to_log_index(filename, group_name=None, gen_index=True):
     # Try to read the file components
     try:
         # Extract the log index
-        log_index   = container.get_log_index(gen_index)
+        log_index   = container.get_log_index(gen_index, as_np)
 
     except AttributeError as err:
         print("Error reading log file: {0}".format(err))
@@ -879,4 +1311,246 @@ def np_arrays_to_hdf5(filename, np_log_dict, attr_dict=None, compression=None):
 
 
 
+def log_data_to_hdf5_columnar(log_data, filename, include_only=None, compression='gzip', compression_opts=None):
+    """Create a columnar HDF5 file that contains the decoded entries of the log_data.
+
+    Args:
+        log_data (bytes):                 Binary data from a WlanExpNode log
+        filename (str):                   Filename of the HDF5 file to appear on disk
+        include_only (list, optional):    List of entry type names to store
+        compression (str, optional):      HDF5 compression filter:  None, 'gzip', 'lzf' or 'blosc'
+        compression_opts (int, optional): Compression level for 'gzip' or 'blosc'
+
+    If the filename already exists this method will print a warning, then
+    create a new filename with a unique date-time suffix.  To build a columnar
+    log incrementally, use a ``HDF5ColumnarLogContainer`` directly.
+    """
+    file_handle = hdf5_open_file(filename)
+    container   = HDF5ColumnarLogContainer(file_handle, compression=compression, compression_opts=compression_opts)
+
+    try:
+        container.append_log_data(log_data, include_only=include_only)
+    except AttributeError as err:
+        print("Error writing log file: {0}".format(err))
+
+    hdf5_close_file(file_handle)
+
+# End log_data_to_hdf5_columnar()
+
+
+
+def hdf5_columnar_to_column(filename, entry_type, field, group_name=None):
+    """Extract a single field of an entry type from a columnar HDF5 Log Container
+
+    Args:
+        filename (str):              Name of HDF5 file to open
+        entry_type (str):            Name of the entry type
+        field (str):                 Name of the field
+        group_name (str, optional):  Name of Group within the HDF5 file object (defaults to "\\")
+
+    Returns:
+        column (Numpy Array):  Values of the field for every entry of the entry type
+    """
+    file_handle = hdf5_open_file(filename, readonly=True)
+    container   = HDF5ColumnarLogContainer(file_handle, group_name)
+    column      = None
+
+    if container.is_valid():
+        column = container.get_column(entry_type, field)
+    else:
+        print("WARNING: {0} is not a columnar log container.".format(filename))
+
+    hdf5_close_file(file_handle)
+
+    return column
+
+# End hdf5_columnar_to_column()
+
+
+
+
+def merge_logs_to_hdf5_columnar(containers, filename, clock_models=None, types=None, window=1000000,
+                                compression='gzip', compression_opts=None):
+    """Merge the logs of several nodes into one time-ordered columnar HDF5 file.
+
+    Args:
+        containers (dict):               Dictionary of ``{ <node name> : <LogContainer> }``
+        filename (str):                  Filename of the HDF5 file to appear on disk
+        clock_models (dict, optional):   Dictionary of ``{ <node name> : <clock model> }`` (see
+            log_util.calc_clock_model()); by default each node's model is fit to the host
+            time in its TIME_INFO entries
+        types (list, optional):          List of entry type names to merge; all entry types
+            with a 'timestamp' field by default
+        window (int, optional):          Length in microseconds of global time processed per step
+        compression (str, optional):     HDF5 compression filter:  None, 'gzip', 'lzf' or 'blosc'
+        compression_opts (int, optional): Compression level for 'gzip' or 'blosc'
+
+    Returns:
+        filename (str):  Filename of the HDF5 file that was written
+
+    The entries of every node are converted to the global time base and
+    merged one window at a time, so the decoded entries of only one window are
+    in memory at once.  Each container is read through its timestamp index (see
+    log_util.gen_log_timestamp_index()); use MmapLogContainer (log.util_mmap) so
+    that only the log data of each window is read from disk.
+
+    The output is a columnar log container (see HDF5ColumnarLogContainer) where
+    every entry type group is ordered by global time and has two additional
+    columns:  'node' (index into the 'merged_nodes' attribute) and
+    'global_timestamp'.  A 'TIMELINE' group orders all entries across entry
+    types with the columns 'global_timestamp', 'node', 'entry_type_id' and
+    'row' (index of the entry in its entry type group).
+    """
+    import numpy as np
+    from .entry_types import log_entry_types
+
+    nodes      = list(containers.keys())
+    ts_indexes = {}
+    log_datas  = {}
+
+    if clock_models is None:
+        clock_models = {}
+        fit_models   = True
+    else:
+        fit_models   = False
+
+    for node in nodes:
+        ts_index = containers[node].get_log_ts_index()
+
+        log_datas[node] = containers[node].get_log_data()
+
+        if fit_models:
+            time_info_type = log_entry_types['TIME_INFO']
+            time_info      = time_info_type.generate_numpy_array(log_datas[node], ts_index.get(time_info_type.entry_type_id, np.empty((0,), dtype=log_util.log_ts_index_dtype))['offset'])
+
+            clock_models[node] = log_util.calc_clock_model(time_info)
+
+        if types is not None:
+            type_ids = [log_entry_types[t].entry_type_id for t in types]
+            ts_index = dict((k, v) for k, v in ts_index.items() if k in type_ids)
+
+        ts_indexes[node] = dict((k, v) for k, v in ts_index.items() if len(v))
+
+    # Global time range of the merged log
+    firsts = [log_util.apply_clock_model(v['timestamp'][0], clock_models[n])  for n in nodes for v in ts_indexes[n].values()]
+    lasts  = [log_util.apply_clock_model(v['timestamp'][-1], clock_models[n]) for n in nodes for v in ts_indexes[n].values()]
+
+    file_handle = hdf5_open_file(filename)
+    real_name   = file_handle.filename
+    container   = HDF5ColumnarLogContainer(file_handle, compression=compression, compression_opts=compression_opts)
+
+    group_handle = container._get_valid_group_handle()
+    group_handle.attrs['merged_nodes'] = np.array([str(n) for n in nodes], dtype='S')
+    group_handle.attrs['clock_local']  = np.array([clock_models[n]['local'] for n in nodes], dtype=np.int64)
+    group_handle.attrs['clock_global'] = np.array([clock_models[n]['global'] for n in nodes], dtype=np.int64)
+    group_handle.attrs['clock_drift']  = np.array([clock_models[n]['drift'] for n in nodes], dtype=np.float64)
+
+    type_counts = {}
+
+    t     = min(firsts) if firsts else 0
+    t_end = (max(lasts) + 1) if lasts else 0
+
+    while t < t_end:
+        t1        = t + window
+        next_t    = t_end
+        merged    = {}
+
+        for n, node in enumerate(nodes):
+            model    = clock_models[node]
+
+            # Local time bounds of the window; widened by 1 us for rounding in the model
+            local_lo = max(int(log_util.invert_clock_model(t, model)) - 1, 0)
+            local_hi = max(int(log_util.invert_clock_model(t1, model)) + 1, 0)
+
+            for k, ts_index in ts_indexes[node].items():
+                lo = np.searchsorted(ts_index['timestamp'], local_lo, side='left')
+                hi = np.searchsorted(ts_index['timestamp'], local_hi, side='left')
+
+                # First entry that may be after the window
+                nxt = np.searchsorted(ts_index['timestamp'], max(local_hi - 2, 0), side='left')
+
+                if (nxt < len(ts_index)):
+                    next_t = min(next_t, int(log_util.apply_clock_model(ts_index['timestamp'][nxt], model)))
+
+                if (lo == hi):
+                    continue
+
+                sel  = ts_index[lo:hi]
+                gts  = log_util.apply_clock_model(sel['timestamp'], model)
+                keep = (gts >= t) & (gts < t1)
+
+                if not np.any(keep):
+                    continue
+
+                entries = log_entry_types[k].generate_numpy_array(log_datas[node], sel['offset'][keep])
+
+                merged.setdefault(k, []).append((entries, gts[keep], n))
+
+        timeline = []
+
+        for k, parts in merged.items():
+            entries  = np.concatenate([p[0] for p in parts])
+            gts      = np.concatenate([p[1] for p in parts])
+            node_col = np.concatenate([np.full((len(p[1]),), p[2], dtype=np.uint16) for p in parts])
+            order    = np.argsort(gts, kind='mergesort')
+
+            columns  = dict((f, entries[f][order]) for f in entries.dtype.names)
+            columns['node']             = node_col[order]
+            columns['global_timestamp'] = gts[order]
+
+            base = type_counts.get(k, 0)
+            container.append_columns(log_entry_types[k].name, columns, flush=False)
+            type_counts[k] = base + len(order)
+
+            timeline.append((gts[order], node_col[order], np.full((len(order),), k, dtype=np.uint16),
+                             np.arange(base, base + len(order), dtype=np.uint64)))
+
+        if timeline:
+            gts   = np.concatenate([x[0] for x in timeline])
+            order = np.argsort(gts, kind='mergesort')
+
+            container.append_columns('TIMELINE', {'global_timestamp' : gts[order],
+                                                  'node'             : np.concatenate([x[1] for x in timeline])[order],
+                                                  'entry_type_id'    : np.concatenate([x[2] for x in timeline])[order],
+                                                  'row'              : np.concatenate([x[3] for x in timeline])[order]}, flush=False)
+
+        # Skip windows without any entries
+        t = max(t1, next_t)
+
+    hdf5_close_file(file_handle)
+
+    return real_name
+
+# End merge_logs_to_hdf5_columnar()
+
+
+
+def _get_compression_kwargs(compression, compression_opts=None):
+    """Internal method to get the h5py create_dataset() arguments for a compression filter."""
+    if compression is None:
+        return {}
+
+    if compression == 'gzip':
+        return {'compression' : 'gzip', 'compression_opts' : compression_opts, 'shuffle' : True}
+
+    if compression == 'lzf':
+        return {'compression' : 'lzf', 'shuffle' : True}
+
+    if compression == 'blosc':
+        try:
+            import hdf5plugin
+        except ImportError:
+            raise AttributeError("Blosc compression requires the hdf5plugin package.")
+
+        if compression_opts is None:
+            compression_opts = 5
+
+        return dict(hdf5plugin.Blosc(cname='lz4', clevel=compression_opts, shuffle=hdf5plugin.Blosc.SHUFFLE))
+
+    raise AttributeError("Unknown compression filter '{0}'.".format(compression))
+
+# End def
+
+
+
 
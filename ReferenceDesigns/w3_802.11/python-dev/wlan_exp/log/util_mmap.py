@@ -0,0 +1,740 @@
+# -*- coding: utf-8 -*-
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design Experiments Framework - Memory-mapped Log Files
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+
+This module provides a log container that stores wlan_exp log data in a flat
+file that is memory-mapped when it is read.
+
+The HDF5 log container must read the entire 'log_data' dataset into memory
+before the log can be indexed or decoded.  For large logs this is slow and can
+exhaust the memory of the host.  The memory-mapped log container instead keeps
+the raw log data in a flat file and the log index in a compact binary sidecar
+file next to it:
+
+<filename>        -- Raw log_data bytes, exactly as read from the node
+<filename>.idx    -- Sidecar index file
+
+Opening a container only maps the two files, so it takes the same time
+regardless of the size of the log.  The log_data returned by the container is
+the memory map itself, so only the log entries that are actually decoded (for
+example by log_data_to_np_arrays()) are read from disk.
+
+Sidecar index file format (all values little-endian):
+
+Header (40 bytes):
+|- 'magic'              8s        b'WLANEXPI'
+|- 'format_version'     uint32    Sidecar format version
+|- 'num_entry_types'    uint32    Number of entries in the entry type table
+|- 'log_data_size'      uint64    Number of bytes of log_data covered by the index
+|- 'next_entry_offset'  uint64    Offset of the first log entry header not in the index
+|- 'attr_size'          uint32    Number of bytes of attribute metadata
+|- 'reserved'           uint32
+Attribute metadata:
+|- JSON encoded attribute dictionary (padded to a multiple of 8 bytes)
+Entry type table (40 bytes per entry type):
+|- 'entry_type_id'      uint32
+|- 'reserved'           uint32
+|- 'num_entries'        uint64    Number of entries of this type
+|- 'offsets_pos'        uint64    File position of the uint64 offset array
+|- 'timestamps_pos'     uint64    File position of the uint64 timestamp array
+                                  (0 if the entry type has no timestamp)
+|- 'ts_index_pos'       uint64    File position of the timestamp index array
+                                  (0 if the entry type has no timestamp)
+Arrays:
+|- uint64 offset, timestamp and timestamp index arrays referenced by the
+   entry type table
+
+The offset arrays are the raw_log_index of the log data (see log.util).  The
+timestamp arrays hold the 'timestamp' field of each entry in the same order.
+The timestamp index arrays are the log_ts_index of the log data:  pairs of
+uint64 (timestamp, offset) sorted by timestamp.
+"""
+
+__all__ = ['MmapLogContainer',
+           'log_data_to_mmap',
+           'hdf5_to_mmap',
+           'mmap_to_log_data',
+           'mmap_to_log_index',
+           'mmap_to_attr_dict']
+
+import sys
+import struct
+from . import util as log_util
+
+
+# Fix to support Python 2.x and 3.x
+if sys.version[0]=="3": unicode=str
+
+
+# Sidecar index file definitions
+IDX_FILE_EXT        = '.idx'
+IDX_MAGIC           = b'WLANEXPI'
+IDX_FORMAT_VERSION  = 2
+IDX_HDR_FMT         = '<8s I I Q Q I I'
+IDX_TABLE_FMT       = '<I I Q Q Q Q'
+
+
+# -----------------------------------------------------------------------------
+# Memory-mapped Log Container Class
+# -----------------------------------------------------------------------------
+class MmapLogContainer(log_util.LogContainer):
+    """Class to define a memory-mapped log container.
+
+    Args:
+        filename (str):            Name of the raw log data file
+        readonly (bool, optional): Open the container in read-only mode
+
+    The log data is stored in ``filename`` and the log index / attributes are
+    stored in the sidecar file ``filename + '.idx'``.  When a container is
+    opened, both files are memory-mapped; no log data is read until it is
+    accessed.
+    """
+    filename                 = None
+    idx_filename             = None
+    readonly                 = None
+
+    _log_data_map            = None
+    _idx_map                 = None
+    _idx_table               = None
+    _attr_dict               = None
+    _next_entry_offset       = None
+
+
+    def __init__(self, filename, readonly=True):
+        import os
+
+        if readonly:
+            file_handle = open(filename, 'rb')
+        else:
+            file_handle = open(filename, 'r+b' if os.path.isfile(filename) else 'w+b')
+
+        super(MmapLogContainer, self).__init__(file_handle)
+
+        self.filename           = filename
+        self.idx_filename       = filename + IDX_FILE_EXT
+        self.readonly           = readonly
+
+        self._attr_dict         = {}
+        self._idx_table         = {}
+        self._next_entry_offset = 0
+
+        self._open_idx()
+
+
+    def is_valid(self):
+        """Check that the memory-mapped Log Container is valid.
+
+        Returns:
+            is_valid (bool):
+                * True --> This is a valid log container
+                * False --> This is NOT a valid log container
+        """
+        import os
+        import wlan_exp.version as version
+
+        if self.file_handle is None:
+            return False
+
+        # A container without a sidecar is valid, but has no index / attributes
+        if not os.path.isfile(self.idx_filename):
+            return True
+
+        if self._idx_map is None:
+            msg  = "WARNING: Log container is not valid.\n"
+            msg += "    Could not read index file {0}.".format(self.idx_filename)
+            print(msg)
+            return False
+
+        if 'wlan_exp_ver' in self._attr_dict:
+            ver         = self._attr_dict['wlan_exp_ver']
+            caller_desc = "Log file '{0}' was written using version {1}".format(
+                              self.filename, version.wlan_exp_ver_str(ver[0], ver[1], ver[2]))
+
+            status = version.wlan_exp_ver_check(major=ver[0], minor=ver[1], revision=ver[2],
+                                                caller_desc=caller_desc)
+
+            if (status == version.WLAN_EXP_VERSION_OLDER):
+                print("Please update the wlan_exp installation to match the version on the log file.")
+
+        return True
+
+
+    def write_log_data(self, log_data, append=True):
+        """Write the log data to the log container.
+
+        Args:
+            log_data (bytes):         Binary data from a WlanExpNode log
+            append (bool, optional):  Append to (True) or Overwrite (False) the current log data
+
+        The log index in the sidecar is not updated by this method; call
+        write_log_index() once all log data has been written.
+        """
+        import os
+
+        if not self._file_writeable():
+            raise AttributeError("File {0} is not writeable.".format(self.filename))
+
+        # Raise an exception if the log data length is zero
+        if (len(log_data) == 0):
+            raise AttributeError("Did not provide any log data.")
+
+        # The file cannot be resized while it is mapped
+        self._unmap_log_data()
+
+        if append:
+            self.file_handle.seek(0, os.SEEK_END)
+        else:
+            self.file_handle.seek(0)
+            self.file_handle.truncate()
+            self._idx_table         = {}
+            self._next_entry_offset = 0
+
+        self.file_handle.write(log_data)
+        self.file_handle.flush()
+
+
+    def write_log_index(self, log_index=None):
+        """Write the log index to the sidecar index file.
+
+        Args:
+            log_index (dict):  Raw log index generated from wlan_exp log data
+
+        If log_index is not provided, the raw log index is generated from the
+        log data in the container.  Only the log data added since the last
+        call to write_log_index() is indexed, so a log can be written
+        incrementally with alternating calls to write_log_data() and
+        write_log_index().
+        """
+        import numpy as np
+
+        if not self._file_writeable():
+            raise AttributeError("File {0} is not writeable.".format(self.filename))
+
+        log_data = self.get_log_data()
+
+        if log_index is None:
+            # Index only the log data after the last indexed entry
+            start     = self._next_entry_offset
+            new_index = log_util.gen_raw_log_index(log_data[start:])
+            new_index = dict((k, np.asarray(v, dtype=np.uint64) + np.uint64(start)) for k, v in new_index.items())
+
+            log_index = self.get_log_index(gen_index=False)
+
+            for k, v in new_index.items():
+                if k in log_index:
+                    log_index[k] = np.concatenate((log_index[k], v))
+                else:
+                    log_index[k] = v
+
+            if new_index:
+                self._next_entry_offset = _calc_next_hdr_offset(log_data, new_index)
+        else:
+            # Log index is provided by the caller; it must cover all of the log data
+            if log_index:
+                self._next_entry_offset = _calc_next_hdr_offset(log_data, log_index)
+            else:
+                self._next_entry_offset = 0
+
+        self._write_idx(log_index, len(log_data))
+
+
+    def write_attr_dict(self, attr_dict):
+        """Add the given attribute dictionary to the sidecar index file.
+
+        Args:
+            attr_dict (dict):  A dictionary of user provided attributes.  Values
+                must be strings, numbers, lists or numpy arrays / scalars.
+        """
+        if not self._file_writeable():
+            raise AttributeError("File {0} is not writeable.".format(self.filename))
+
+        default_attrs = ['wlan_exp_log', 'wlan_exp_ver']
+
+        new_attr_dict = dict((k, v) for k, v in self._attr_dict.items() if k in default_attrs)
+
+        for k, v in attr_dict.items():
+            if k not in default_attrs:
+                if (type(k) is not str):
+                    print("WARNING: Converting '{0}' to string to add attribute.".format(k))
+                new_attr_dict[str(k)] = v
+
+        self._attr_dict = new_attr_dict
+
+        self._write_idx(self.get_log_index(gen_index=False), self.get_log_data_size())
+
+
+    def get_log_data_size(self):
+        """Get the current size of the log data in the log container.
+
+        Returns:
+            size (int):  Number of bytes of log data in the log container
+        """
+        import os
+        return os.fstat(self.file_handle.fileno()).st_size
+
+
+    def get_log_data(self):
+        """Get the log data from the log container.
+
+        Returns:
+            log_data (mmap):  Read-only memory map of the log data.  The memory
+                map supports slicing like a bytes object; only the slices that
+                are accessed are read from disk.
+        """
+        import mmap
+
+        if self._log_data_map is None:
+            if (self.get_log_data_size() == 0):
+                return b''
+
+            self._log_data_map = mmap.mmap(self.file_handle.fileno(), 0, access=mmap.ACCESS_READ)
+
+        return self._log_data_map
+
+
+    def get_log_index(self, gen_index=True):
+        """Get the raw log index from the log container.
+
+        Args:
+            gen_index (bool, optional):  Generate the raw log index if the log
+                index does not exist in the log container.
+
+        Returns:
+            log_index (dict):  Raw log index from the log container.  Offsets are
+                uint64 numpy arrays that map the sidecar file; they are not read
+                from disk until accessed.
+        """
+        log_index = dict((k, self._idx_array(v['offsets_pos'], v['num_entries'])) for k, v in self._idx_table.items())
+
+        if not log_index and gen_index:
+            log_index = log_util.gen_raw_log_index(self.get_log_data())
+
+            if not log_index:
+                msg  = "Unable to get log index from {0}.".format(self.filename)
+                raise AttributeError(msg)
+
+        return log_index
+
+
+    def get_log_timestamps(self):
+        """Get the entry timestamps from the log container.
+
+        Returns:
+            timestamps (dict):  Dictionary of ``{ <int> : <timestamps> }`` with the
+                'timestamp' field of each entry, in the same order as the raw log
+                index.  Entry types without a 'timestamp' field are not included.
+        """
+        return dict((k, self._idx_array(v['timestamps_pos'], v['num_entries']))
+                    for k, v in self._idx_table.items() if v['timestamps_pos'])
+
+
+    def get_log_ts_index(self, gen_index=True):
+        """Get the timestamp index from the log container.
+
+        Args:
+            gen_index (bool, optional):  Generate the timestamp index if the log
+                index does not exist in the log container.
+
+        Returns:
+            log_ts_index (dict):  Timestamp index from the log container (see
+                log_util.gen_log_timestamp_index()).  The arrays map the sidecar file.
+        """
+        import numpy as np
+
+        if not self._idx_table and gen_index:
+            return log_util.gen_log_timestamp_index(self.get_log_data(), self.get_log_index())
+
+        return dict((k, np.frombuffer(self._idx_map, dtype=log_util.log_ts_index_dtype, count=v['num_entries'], offset=v['ts_index_pos']))
+                    for k, v in self._idx_table.items() if v['ts_index_pos'])
+
+
+    def get_attr_dict(self):
+        """Get the attribute dictionary from the log container.
+
+        Returns:
+            attr_dict (dict):  The dictionary of user provided attributes in the log container.
+        """
+        return dict(self._attr_dict)
+
+
+    def trim_log_data(self):
+        """Trim the log data so that it has ends on a entry boundary."""
+        raise NotImplementedError
+
+
+    def close(self):
+        """Unmap and close the log container files."""
+        self._unmap_log_data()
+        self._unmap_idx()
+
+        if self.file_handle is not None:
+            self.file_handle.close()
+            self.file_handle = None
+
+
+    # -------------------------------------------------------------------------
+    # Internal methods for the container
+    # -------------------------------------------------------------------------
+    def _open_idx(self):
+        """Internal method to map the sidecar index file and parse its header."""
+        import os
+        import mmap
+        import json
+
+        self._unmap_idx()
+
+        if not os.path.isfile(self.idx_filename) or (os.path.getsize(self.idx_filename) == 0):
+            return
+
+        with open(self.idx_filename, 'rb') as idx_file:
+            self._idx_map = mmap.mmap(idx_file.fileno(), 0, access=mmap.ACCESS_READ)
+
+        hdr_size = struct.calcsize(IDX_HDR_FMT)
+
+        (magic, fmt_ver, num_types, _, next_entry_offset, attr_size, _) = struct.unpack(IDX_HDR_FMT, self._idx_map[:hdr_size])
+
+        if (magic != IDX_MAGIC) or (fmt_ver != IDX_FORMAT_VERSION):
+            print("WARNING: {0} is not a valid log index file.".format(self.idx_filename))
+            self._unmap_idx()
+            return
+
+        self._next_entry_offset = next_entry_offset
+
+        if attr_size:
+            self._attr_dict = json.loads(self._idx_map[hdr_size:hdr_size + attr_size].decode('utf-8'))
+
+        table_pos  = hdr_size + _pad8(attr_size)
+        table_size = struct.calcsize(IDX_TABLE_FMT)
+
+        for i in range(num_types):
+            pos = table_pos + (i * table_size)
+            (entry_type_id, _, num_entries, offsets_pos, timestamps_pos, ts_index_pos) = struct.unpack(IDX_TABLE_FMT, self._idx_map[pos:pos + table_size])
+
+            self._idx_table[entry_type_id] = {'num_entries'    : num_entries,
+                                              'offsets_pos'    : offsets_pos,
+                                              'timestamps_pos' : timestamps_pos,
+                                              'ts_index_pos'   : ts_index_pos}
+
+
+    def _write_idx(self, log_index, log_data_size):
+        """Internal method to write the sidecar index file."""
+        import os
+        import json
+        import numpy as np
+        import wlan_exp.version as version
+        from .entry_types import log_entry_types
+
+        log_data = self.get_log_data()
+
+        if 'wlan_exp_log' not in self._attr_dict:
+            self._attr_dict['wlan_exp_log'] = 1
+            self._attr_dict['wlan_exp_ver'] = list(version.wlan_exp_ver())
+
+        attr_bytes = json.dumps(self._attr_dict, default=_json_default).encode('utf-8')
+
+        entry_type_ids = sorted(k for k in log_index.keys() if len(log_index[k]))
+
+        hdr_size   = struct.calcsize(IDX_HDR_FMT)
+        table_size = struct.calcsize(IDX_TABLE_FMT)
+        pos        = hdr_size + _pad8(len(attr_bytes)) + (len(entry_type_ids) * table_size)
+
+        table  = []
+        arrays = []
+
+        for k in entry_type_ids:
+            offsets = np.asarray(log_index[k], dtype='<u8')
+
+            table_entry = [k, 0, len(offsets), pos, 0, 0]
+            arrays.append(offsets)
+            pos += offsets.nbytes
+
+            try:
+                ts_offset = log_entry_types[k].get_field_offsets()['timestamp']
+                arrays.append(log_util._gather_u64(log_data, offsets + np.uint64(ts_offset)))
+                table_entry[4] = pos
+                pos += arrays[-1].nbytes
+
+                arrays.append(log_util.gen_log_timestamp_index(log_data, {k : offsets})[k])
+                table_entry[5] = pos
+                pos += arrays[-1].nbytes
+            except KeyError:
+                # Unknown entry type or entry type without a timestamp
+                pass
+
+            table.append(table_entry)
+
+        # Write to a temporary file so that a reader never sees a partial index
+        self._unmap_idx()
+
+        tmp_filename = self.idx_filename + '.tmp'
+
+        with open(tmp_filename, 'wb') as idx_file:
+            idx_file.write(struct.pack(IDX_HDR_FMT, IDX_MAGIC, IDX_FORMAT_VERSION, len(table),
+                                       log_data_size, self._next_entry_offset, len(attr_bytes), 0))
+            idx_file.write(attr_bytes + (b'\x00' * (_pad8(len(attr_bytes)) - len(attr_bytes))))
+
+            for table_entry in table:
+                idx_file.write(struct.pack(IDX_TABLE_FMT, *table_entry))
+
+            for array in arrays:
+                idx_file.write(array.tobytes())
+
+        if os.path.isfile(self.idx_filename):
+            os.remove(self.idx_filename)
+        os.rename(tmp_filename, self.idx_filename)
+
+        self._idx_table = {}
+        self._open_idx()
+
+
+    def _idx_array(self, pos, num_entries):
+        """Internal method to get a uint64 array view into the sidecar index file."""
+        import numpy as np
+
+        return np.frombuffer(self._idx_map, dtype='<u8', count=num_entries, offset=pos)
+
+
+    def _unmap_log_data(self):
+        if self._log_data_map is not None:
+            self._log_data_map.close()
+            self._log_data_map = None
+
+
+    def _unmap_idx(self):
+        if self._idx_map is not None:
+            try:
+                self._idx_map.close()
+            except BufferError:
+                # Index arrays returned to the caller still reference the map;
+                # it is closed when they are garbage collected
+                pass
+            self._idx_map = None
+
+
+    def _file_writeable(self):
+        """Internal method to check if the log container is writeable."""
+        return not self.readonly
+
+# End class()
+
+
+
+# -----------------------------------------------------------------------------
+# Memory-mapped Log File Utilities
+# -----------------------------------------------------------------------------
+def log_data_to_mmap(log_data, filename, attr_dict=None, gen_index=True, overwrite=False):
+    """Create a memory-mapped log container that contains the log_data, a
+    raw_log_index, and any user attributes.
+
+    Args:
+        log_data (bytes):            Binary data from a WlanExpNode log
+        filename (str):              Filename of the raw log data file to appear on disk
+        attr_dict (dict, optional):  A dictionary of user provided attributes
+        gen_index (bool, optional):  Generate the ``raw_log_index`` from the ``log_data`` and store it in the sidecar.
+        overwrite (bool, optional):  If True method will overwrite existing file with filename
+
+    If the filename already exists and ``overwrite==False`` this method will
+    print a warning, then create a new filename with a unique date-time suffix.
+
+    Returns:
+        filename (str):  Filename of the raw log data file that was written
+    """
+    import os
+
+    if overwrite:
+        real_filename = filename
+        if os.path.isfile(filename + IDX_FILE_EXT):
+            os.remove(filename + IDX_FILE_EXT)
+    else:
+        real_filename = log_util._get_safe_filename(filename)
+
+    container = MmapLogContainer(real_filename, readonly=False)
+
+    try:
+        container.write_log_data(log_data, append=False)
+
+        if gen_index:
+            container.write_log_index()
+
+        if attr_dict is not None:
+            container.write_attr_dict(attr_dict)
+
+    except AttributeError as err:
+        print("Error writing log file: {0}".format(err))
+
+    container.close()
+
+    return real_filename
+
+# End def
+
+
+
+def hdf5_to_mmap(hdf5_filename, filename, group_name=None, overwrite=False, chunk_size=2**26):
+    """Convert an HDF5 log container to a memory-mapped log container.
+
+    Args:
+        hdf5_filename (str):         Name of HDF5 file to convert
+        filename (str):              Filename of the raw log data file to appear on disk
+        group_name (str, optional):  Name of Group within the HDF5 file object (defaults to "\")
+        overwrite (bool, optional):  If True method will overwrite existing file with filename
+        chunk_size (int, optional):  Number of bytes copied at a time
+
+    The log data is copied in chunks so that the HDF5 log data is never in
+    memory all at once.  The attributes of the HDF5 log container are copied
+    to the new container.
+
+    Returns:
+        filename (str):  Filename of the raw log data file that was written
+    """
+    import os
+    import numpy as np
+    from . import util_hdf as hdf_util
+
+    h5_file   = hdf_util.hdf5_open_file(hdf5_filename, readonly=True)
+    h5_cont   = hdf_util.HDF5LogContainer(h5_file, group_name)
+
+    if overwrite:
+        real_filename = filename
+        if os.path.isfile(filename + IDX_FILE_EXT):
+            os.remove(filename + IDX_FILE_EXT)
+    else:
+        real_filename = log_util._get_safe_filename(filename)
+
+    container = MmapLogContainer(real_filename, readonly=False)
+
+    try:
+        ds        = h5_cont._get_valid_group_handle()['log_data']
+        size      = ds.shape[0]
+        chunk     = np.empty((min(size, chunk_size),), dtype=ds.dtype)
+        append    = False
+
+        for start in range(0, size, chunk_size):
+            end = min(start + chunk_size, size)
+            ds.read_direct(chunk, np.s_[start:end], np.s_[0:(end - start)])
+            container.write_log_data(chunk[0:(end - start)].tobytes(), append=append)
+            append = True
+
+        container.write_log_index()
+
+        attr_dict = h5_cont.get_attr_dict()
+        container.write_attr_dict(dict((k, v) for k, v in attr_dict.items() if k not in ['wlan_exp_log', 'wlan_exp_ver']))
+
+    except AttributeError as err:
+        print("Error converting log file: {0}".format(err))
+
+    container.close()
+    hdf_util.hdf5_close_file(h5_file)
+
+    return real_filename
+
+# End def
+
+
+
+def mmap_to_log_data(filename):
+    """Get the log_data from a memory-mapped log container.
+
+    Args:
+        filename (str):  Filename of the raw log data file
+
+    Returns:
+        log_data (mmap):  Read-only memory map of the log data in the container
+
+    The memory map remains valid after the container is garbage collected.
+    """
+    container = MmapLogContainer(filename)
+    log_data  = container.get_log_data()
+
+    return log_data
+
+# End def
+
+
+
+def mmap_to_log_index(filename, gen_index=True):
+    """Get the log_index from a memory-mapped log container.
+
+    Args:
+        filename (str):              Filename of the raw log data file
+        gen_index (bool, optional):  Generate the ``raw_log_index`` from the ``log_data``
+            if the sidecar does not contain a log index
+
+    Returns:
+        log_index (dict):  Raw log index of the log data
+    """
+    container = MmapLogContainer(filename)
+    log_index = None
+
+    try:
+        log_index = container.get_log_index(gen_index)
+    except AttributeError as err:
+        print("Error reading log file: {0}".format(err))
+
+    return log_index
+
+# End def
+
+
+
+def mmap_to_attr_dict(filename):
+    """Get the attribute dictionary from a memory-mapped log container.
+
+    Args:
+        filename (str):  Filename of the raw log data file
+
+    Returns:
+        attr_dict (dict):  The dictionary of user provided attributes
+    """
+    container = MmapLogContainer(filename)
+    attr_dict = container.get_attr_dict()
+    container.close()
+
+    return attr_dict
+
+# End def
+
+
+
+# -----------------------------------------------------------------------------
+# Internal Utilities
+# -----------------------------------------------------------------------------
+def _pad8(size):
+    """Round size up to a multiple of 8 bytes."""
+    return (size + 7) & ~7
+
+
+def _calc_next_hdr_offset(log_data, log_index):
+    """Offset of the first entry header after the last entry in log_index.
+
+    Same as log_util.calc_next_entry_offset() (minus the header size), but
+    accepts numpy offset arrays.
+    """
+    max_entry_offset = int(max(v[-1] for v in log_index.values() if len(v)))
+
+    hdr_b = bytearray(log_data[max_entry_offset - 8 : max_entry_offset])
+
+    if (hdr_b[2:4] != b'\xed\xac'):
+        raise Exception("ERROR: Offset not a valid entry header (offset {0})!".format(max_entry_offset))
+
+    return max_entry_offset + hdr_b[6] + (hdr_b[7] * 256)
+
+
+def _json_default(obj):
+    """Convert numpy types to their JSON compatible Python equivalents."""
+    import numpy as np
+
+    if isinstance(obj, np.ndarray):
+        return obj.tolist()
+    if isinstance(obj, np.generic):
+        return obj.item()
+    if isinstance(obj, bytes):
+        return obj.decode('utf-8', 'replace')
+
+    raise TypeError("Attribute {0} is not serializable.".format(repr(obj)))
+
@@ -0,0 +1,569 @@
+# -*- coding: utf-8 -*-
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design Experiments Framework - Online Log Analytics
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+
+This module provides incremental analytics for log data that is read from a
+node while an experiment is running (for example, by the
+log_capture_continuous.py example).
+
+Each chunk of log data returned by ``node.log_get_all_new()`` is indexed and
+decoded once.  Chunks do not have to be aligned to log entry boundaries; the
+bytes of an incomplete entry at the end of a chunk are carried over and
+prepended to the next chunk.  The decoded entries update per-station and
+per-entry type aggregates that are kept in fixed length time bins, so the cost
+of an update only depends on the size of the chunk.  The aggregates over the
+most recent window of node time can be read as a dictionary, as JSON or as
+Prometheus text, and can be served over HTTP.
+
+Example:
+::
+
+    import wlan_exp.log.util_online as online_util
+
+    analyzer = online_util.OnlineLogAnalyzer(window=10000000)
+    analyzer.start_http_server(port=9100)
+
+    while capturing:
+        data = node.log_get_all_new().get_bytes()
+        analyzer.update(data)
+
+The aggregates are then available at ``http://localhost:9100/metrics``
+(Prometheus text) and ``http://localhost:9100/stats`` (JSON).
+"""
+
+__all__ = ['OnlineLogAnalyzer',
+           'replay_log_data']
+
+import sys
+import threading
+
+from . import util as log_util
+
+
+# Fix to support Python 2.x and 3.x
+if sys.version[0]=="3": long=None
+
+
+# Broadcast address (excluded from the Tx attempt / PER statistics)
+BROADCAST_ADDR = 0xFFFFFFFFFFFF
+
+# Size of the log entry header
+LOG_ENTRY_HDR_SIZE = 8
+
+
+# -----------------------------------------------------------------------------
+# Online Log Analyzer Class
+# -----------------------------------------------------------------------------
+class OnlineLogAnalyzer(object):
+    """Incremental analytics over a stream of wlan_exp log data.
+
+    Args:
+        window (int, optional):    Length of the rolling window in microseconds of node time
+        interval (int, optional):  Length of each time bin in microseconds.  The window is
+            rounded up to a whole number of bins.
+
+    Per station (MAC address) aggregates:
+        * Rx:  Bytes, packets and throughput of non-duplicate data packets with a good FCS,
+          average Rx power of all good FCS receptions, number of receptions with a bad FCS
+        * Tx:  Bytes, packets and throughput of TX_HIGH data packets, number of TX_LOW
+          unicast attempts and how many received a response (used for the PER)
+        * Airtime:  Rx and Tx airtime in microseconds (see log_util.calc_tx_time())
+
+    Per entry type aggregates:
+        * Number of entries
+
+    All methods are thread safe, so the aggregates can be read (e.g. by the HTTP
+    server) while ``update()`` is called from the capture loop.
+    """
+    window            = None
+    interval          = None
+    num_bins          = None
+
+    num_entries       = None             # Total number of entries processed
+    num_bytes         = None             # Total number of bytes processed
+
+    _tail             = None             # Incomplete entry carried over from the previous chunk
+    _bins             = None             # { <bin> : { (<metric>, <key>) : <value> } }
+    _first_timestamp  = None
+    _last_timestamp   = None
+    _lock             = None
+    _server           = None
+
+    def __init__(self, window=10000000, interval=1000000):
+        self.interval    = interval
+        self.num_bins    = max(1, -(-window // interval))
+        self.window      = self.num_bins * interval
+        self._lock       = threading.Lock()
+
+        self.reset()
+
+
+    def reset(self):
+        """Clear all aggregates and any carried over partial entry."""
+        with self._lock:
+            self.num_entries      = 0
+            self.num_bytes        = 0
+            self._tail            = b''
+            self._bins            = dict()
+            self._first_timestamp = None
+            self._last_timestamp  = None
+
+
+    def update(self, log_data):
+        """Add a chunk of log data.
+
+        Args:
+            log_data (bytes):  Next chunk of binary log data from a WlanExpNode log
+                (e.g. ``node.log_get_all_new().get_bytes()``)
+
+        Returns:
+            num_entries (int):  Number of complete log entries processed from the chunk
+        """
+        with self._lock:
+            data = self._tail + bytes(log_data)
+
+            self.num_bytes += len(log_data)
+
+            raw_log_index = log_util.gen_raw_log_index(data)
+
+            # Carry the incomplete entry at the end of the chunk over to the next chunk
+            #   NULL entries are removed from the raw log index.  Since nodes do not
+            #   create NULL entries, a chunk without any entries is treated as part of
+            #   an entry that is still incomplete.
+            if any(len(v) for v in raw_log_index.values()):
+                next_hdr_offset = log_util.calc_next_entry_offset(data, raw_log_index) - LOG_ENTRY_HDR_SIZE
+                self._tail      = data[next_hdr_offset:]
+            else:
+                self._tail      = data
+                return 0
+
+            num_entries = self._process_entries(data, raw_log_index)
+
+            self.num_entries += num_entries
+
+        return num_entries
+
+
+    def get_stats(self):
+        """Get the aggregates over the current window.
+
+        Returns:
+            stats (dict):  Dictionary of the form:
+                ``{'timestamp': <int>, 'window': <int>, 'num_entries': <int>, 'num_bytes': <int>,
+                'airtime_util': <float>, 'entries': {<entry type name>: <int>},
+                'stations': {<MAC address str>: {<stat>: <value>}}}``
+
+        Throughputs are in Mbps and are averaged over the window (or the time since the
+        first entry if that is shorter).  ``airtime_util`` is the fraction of the window
+        the node spent transmitting or receiving.
+        """
+        import wlan_exp.util as wlan_exp_util
+        from .entry_types import log_entry_types
+
+        with self._lock:
+            totals = self._sum_window()
+
+            if self._last_timestamp is None:
+                span = self.window
+            else:
+                span = min(self.window, self._last_timestamp - self._first_timestamp)
+
+            span = max(span, 1)
+
+            stats = {'timestamp'    : self._last_timestamp,
+                     'window'       : span,
+                     'num_entries'  : self.num_entries,
+                     'num_bytes'    : self.num_bytes,
+                     'airtime_util' : 0.0,
+                     'entries'      : {},
+                     'stations'     : {}}
+
+            stations     = {}
+            airtime_used = 0
+
+            for ((metric, key), value) in totals.items():
+                if (metric == 'entries'):
+                    try:
+                        name = log_entry_types[key].name
+                    except KeyError:
+                        name = str(key)
+
+                    stats['entries'][name] = int(value)
+                    continue
+
+                if metric in ('rx_airtime', 'tx_airtime'):
+                    airtime_used += value
+
+                stations.setdefault(key, {})[metric] = value
+
+        for (addr, sta) in stations.items():
+            sta_stats = {}
+
+            for metric in ('rx_bytes', 'rx_pkts', 'rx_fcs_bad', 'tx_bytes', 'tx_pkts', 'tx_attempts', 'tx_acked', 'rx_airtime', 'tx_airtime'):
+                sta_stats[metric] = int(sta.get(metric, 0))
+
+            sta_stats['rx_throughput'] = (8.0 * sta_stats['rx_bytes']) / span
+            sta_stats['tx_throughput'] = (8.0 * sta_stats['tx_bytes']) / span
+
+            if sta.get('rx_power_count', 0):
+                sta_stats['rx_power'] = float(sta['rx_power_sum']) / sta['rx_power_count']
+            else:
+                sta_stats['rx_power'] = None
+
+            if sta_stats['tx_attempts']:
+                sta_stats['per'] = 1.0 - (float(sta_stats['tx_acked']) / sta_stats['tx_attempts'])
+            else:
+                sta_stats['per'] = None
+
+            stats['stations'][wlan_exp_util.mac_addr_to_str(addr)] = sta_stats
+
+        stats['airtime_util'] = float(airtime_used) / span
+
+        return stats
+
+
+    def get_stats_json(self):
+        """Get the aggregates over the current window as a JSON string (see get_stats())."""
+        import json
+
+        return json.dumps(self.get_stats(), sort_keys=True)
+
+
+    def get_stats_prometheus(self, prefix='wlan_exp'):
+        """Get the aggregates over the current window in the Prometheus text format.
+
+        Args:
+            prefix (str, optional):  Prefix of each metric name
+
+        Returns:
+            text (str):  Metrics in the Prometheus text exposition format (see get_stats())
+        """
+        stats = self.get_stats()
+        lines = []
+
+        def add_metric(name, desc, samples):
+            lines.append('# HELP {0}_{1} {2}'.format(prefix, name, desc))
+            lines.append('# TYPE {0}_{1} gauge'.format(prefix, name))
+
+            for (labels, value) in samples:
+                if value is None:
+                    continue
+
+                if labels:
+                    label_str = '{' + ','.join('{0}="{1}"'.format(k, v) for (k, v) in labels) + '}'
+                else:
+                    label_str = ''
+
+                lines.append('{0}_{1}{2} {3}'.format(prefix, name, label_str, value))
+
+        add_metric('log_entries_total', 'Number of log entries processed', [((), stats['num_entries'])])
+        add_metric('log_bytes_total', 'Number of log bytes processed', [((), stats['num_bytes'])])
+        add_metric('airtime_util', 'Fraction of the window spent transmitting or receiving', [((), stats['airtime_util'])])
+        add_metric('entries', 'Number of log entries in the window',
+                   [((('entry_type', k),), v) for (k, v) in sorted(stats['entries'].items())])
+
+        station_metrics = [
+            ('rx_bytes',      'Rx data bytes in the window'),
+            ('rx_pkts',       'Rx data packets in the window'),
+            ('rx_throughput', 'Rx data throughput (Mbps)'),
+            ('rx_fcs_bad',    'Receptions with a bad FCS in the window'),
+            ('rx_power',      'Average Rx power (dBm)'),
+            ('tx_bytes',      'Tx data bytes in the window'),
+            ('tx_pkts',       'Tx data packets in the window'),
+            ('tx_throughput', 'Tx data throughput (Mbps)'),
+            ('tx_attempts',   'Unicast Tx attempts in the window'),
+            ('tx_acked',      'Unicast Tx attempts that received a response in the window'),
+            ('per',           'Packet error rate of unicast Tx attempts'),
+            ('rx_airtime',    'Rx airtime in the window (us)'),
+            ('tx_airtime',    'Tx airtime in the window (us)')]
+
+        for (metric, desc) in station_metrics:
+            add_metric('station_' + metric, desc,
+                       [((('station', addr),), sta[metric]) for (addr, sta) in sorted(stats['stations'].items())])
+
+        return '\n'.join(lines) + '\n'
+
+
+    def start_http_server(self, port=9100, host='localhost'):
+        """Serve the aggregates over HTTP from a background thread.
+
+        Args:
+            port (int, optional):  TCP port of the server
+            host (str, optional):  Address of the server (default only accepts local connections)
+
+        The server responds to ``/metrics`` with Prometheus text and to any other path
+        (e.g. ``/stats``) with JSON.
+        """
+        try:
+            from http.server import BaseHTTPRequestHandler, HTTPServer
+        except ImportError:
+            from BaseHTTPServer import BaseHTTPRequestHandler, HTTPServer
+
+        analyzer = self
+
+        class StatsRequestHandler(BaseHTTPRequestHandler):
+            def do_GET(self):
+                if self.path.startswith('/metrics'):
+                    body         = analyzer.get_stats_prometheus()
+                    content_type = 'text/plain; version=0.0.4'
+                else:
+                    body         = analyzer.get_stats_json()
+                    content_type = 'application/json'
+
+                body = body.encode('utf-8')
+
+                self.send_response(200)
+                self.send_header('Content-Type', content_type)
+                self.send_header('Content-Length', str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+
+            def log_message(self, format, *args):
+                # Do not print a line for every request
+                pass
+
+        self.stop_http_server()
+
+        self._server = HTTPServer((host, port), StatsRequestHandler)
+
+        server_thread        = threading.Thread(target=self._server.serve_forever)
+        server_thread.daemon = True
+        server_thread.start()
+
+
+    def stop_http_server(self):
+        """Stop the HTTP server started by start_http_server()."""
+        if self._server is not None:
+            self._server.shutdown()
+            self._server.server_close()
+            self._server = None
+
+
+    # -------------------------------------------------------------------------
+    # Internal methods
+    # -------------------------------------------------------------------------
+    def _process_entries(self, log_data, raw_log_index):
+        """Update the aggregates with the entries of the raw log index."""
+        import numpy as np
+
+        # Per entry type counts
+        for (entry_type_id, offsets) in raw_log_index.items():
+            offsets = np.asarray(offsets, dtype=np.int64)
+
+            if (len(offsets) == 0):
+                continue
+
+            timestamps = log_util._gather_u64(log_data, offsets)
+
+            if not self._check_time(timestamps):
+                continue
+
+            self._accumulate('entries', timestamps, np.full(len(offsets), entry_type_id, dtype=np.uint64))
+
+        # Decode the Tx / Rx entries
+        entries_merge = {'RX_OFDM': ['RX_OFDM', 'RX_OFDM_LTG'],
+                         'TX_HIGH': ['TX_HIGH', 'TX_HIGH_LTG'],
+                         'TX_LOW' : ['TX_LOW', 'TX_LOW_LTG']}
+
+        log_index = log_util.filter_log_index(raw_log_index, include_only=list(entries_merge.keys()), merge=entries_merge)
+        np_arrays = log_util.log_data_to_np_arrays(log_data, log_index)
+
+        rx      = np_arrays['RX_OFDM']
+        tx_high = np_arrays['TX_HIGH']
+        tx_low  = np_arrays['TX_LOW']
+
+        if len(rx):
+            consts   = log_util.get_entry_constants('RX_OFDM')
+            fcs_good = (rx['flags'] & consts.flags.FCS_GOOD) != 0
+            rx_data  = (fcs_good &
+                        ((rx['flags'] & consts.flags.DUPLICATE) == 0) &
+                        _is_data(rx['pkt_type'], consts))
+
+            self._accumulate('rx_bytes', rx['timestamp'][rx_data], rx['addr2'][rx_data], rx['length'][rx_data])
+            self._accumulate('rx_pkts', rx['timestamp'][rx_data], rx['addr2'][rx_data])
+            self._accumulate('rx_fcs_bad', rx['timestamp'][~fcs_good], rx['addr2'][~fcs_good])
+            self._accumulate('rx_power_sum', rx['timestamp'][fcs_good], rx['addr2'][fcs_good], rx['power'][fcs_good])
+            self._accumulate('rx_power_count', rx['timestamp'][fcs_good], rx['addr2'][fcs_good])
+            self._accumulate('rx_airtime', rx['timestamp'][fcs_good], rx['addr2'][fcs_good], rx['airtime'][fcs_good])
+
+        if len(tx_high):
+            consts  = log_util.get_entry_constants('TX_HIGH')
+            tx_data = _is_data(tx_high['pkt_type'], consts)
+
+            self._accumulate('tx_bytes', tx_high['timestamp'][tx_data], tx_high['addr1'][tx_data], tx_high['length'][tx_data])
+            self._accumulate('tx_pkts', tx_high['timestamp'][tx_data], tx_high['addr1'][tx_data])
+
+        if len(tx_low):
+            consts  = log_util.get_entry_constants('TX_LOW')
+            unicast = (tx_low['addr1'] != BROADCAST_ADDR)
+            acked   = unicast & ((tx_low['flags'] & consts.flags.RECEIVED_RESPONSE) != 0)
+
+            self._accumulate('tx_attempts', tx_low['timestamp'][unicast], tx_low['addr1'][unicast])
+            self._accumulate('tx_acked', tx_low['timestamp'][acked], tx_low['addr1'][acked])
+            self._accumulate('tx_airtime', tx_low['timestamp'], tx_low['addr1'], tx_low['airtime'])
+
+        return sum(len(v) for v in raw_log_index.values())
+
+
+    def _check_time(self, timestamps):
+        """Track the node time of the stream.
+
+        Returns False if all of the timestamps are before the current window.  If the
+        node time moved backwards by more than a window (e.g. the node time was set),
+        the aggregates are cleared and the stream starts again from the new time.
+        """
+        t_min = int(timestamps.min())
+        t_max = int(timestamps.max())
+
+        if self._last_timestamp is None:
+            self._first_timestamp = t_min
+            self._last_timestamp  = t_max
+            return True
+
+        if (t_max < (self._last_timestamp - self.window)):
+            # Ignore entries from before the window unless the node time was reset
+            if (t_max > self._first_timestamp):
+                return False
+
+            self._bins            = dict()
+            self._first_timestamp = t_min
+            self._last_timestamp  = t_max
+            return True
+
+        self._first_timestamp = min(self._first_timestamp, t_min)
+        self._last_timestamp  = max(self._last_timestamp, t_max)
+
+        # Remove bins that are no longer in the window
+        first_bin = self._get_first_bin()
+
+        for b in [b for b in self._bins if (b < first_bin)]:
+            del self._bins[b]
+
+        return True
+
+
+    def _accumulate(self, metric, timestamps, keys, values=None):
+        """Add the values (or count the entries) per (time bin, key)."""
+        import numpy as np
+
+        if (len(timestamps) == 0):
+            return
+
+        bins  = timestamps.astype(np.uint64) // np.uint64(self.interval)
+        pairs = np.stack((bins, keys.astype(np.uint64)), axis=1)
+
+        (uniq, inverse) = np.unique(pairs, axis=0, return_inverse=True)
+
+        if values is None:
+            sums = np.bincount(inverse.reshape(-1), minlength=len(uniq))
+        else:
+            sums = np.bincount(inverse.reshape(-1), weights=values, minlength=len(uniq))
+
+        first_bin = self._get_first_bin()
+
+        for ((b, key), value) in zip(uniq.tolist(), sums.tolist()):
+            if (b < first_bin):
+                continue
+
+            bin_values = self._bins.setdefault(b, dict())
+            bin_values[(metric, key)] = bin_values.get((metric, key), 0) + value
+
+
+    def _get_first_bin(self):
+        """Index of the oldest time bin in the window."""
+        return (self._last_timestamp // self.interval) - self.num_bins + 1
+
+
+    def _sum_window(self):
+        """Sum the values of all bins in the window."""
+        totals = dict()
+
+        for bin_values in self._bins.values():
+            for (k, v) in bin_values.items():
+                totals[k] = totals.get(k, 0) + v
+
+        return totals
+
+# End class()
+
+
+
+# -----------------------------------------------------------------------------
+# Online Log Analytics Utilities
+# -----------------------------------------------------------------------------
+def replay_log_data(log_data, analyzer, speed=10.0, chunk_time=1000000, callback=None):
+    """Feed recorded log data to an analyzer in node time.
+
+    Args:
+        log_data (bytes):               Binary data from a WlanExpNode log
+        analyzer (OnlineLogAnalyzer):   Analyzer to update
+        speed (float, optional):        Replay speed relative to node time (0 or None
+            replays as fast as possible)
+        chunk_time (int, optional):     Node time in microseconds covered by each chunk
+        callback (callable, optional):  Called with the analyzer after each chunk
+
+    Returns:
+        elapsed (float):  Wall clock duration of the replay in seconds
+
+    This is useful to test a dashboard against a recorded log or to check that the
+    analyzer keeps up with a given capture rate.  Chunks are cut on entry
+    boundaries by node time.
+    """
+    import time
+    import numpy as np
+
+    raw_log_index = log_util.log_index_to_np(log_util.gen_raw_log_index(log_data))
+    offsets       = log_util._merge_offsets(list(raw_log_index.values()))
+
+    if (len(offsets) == 0):
+        return 0.0
+
+    # Entries are not written in timestamp order (e.g. a TX_HIGH entry is written
+    #   after the TX_LOW entries of the packet), so chunks are cut on the latest
+    #   node time seen so far in the log
+    timestamps = np.maximum.accumulate(log_util._gather_u64(log_data, offsets).astype(np.int64))
+
+    # Cut the log data at the header of the first entry of each chunk
+    chunk_ids  = (timestamps - timestamps[0]) // chunk_time
+    starts     = np.flatnonzero(np.diff(chunk_ids.astype(np.int64), prepend=-1) != 0)
+    cuts       = (offsets[starts] - LOG_ENTRY_HDR_SIZE).tolist()
+    cuts[0]    = 0
+    cuts.append(len(log_data))
+
+    start_time = time.time()
+
+    for i in range(len(cuts) - 1):
+        if speed:
+            # Wait until the node time of the chunk has passed
+            node_elapsed = (int(timestamps[starts[i]]) - int(timestamps[0])) / 1e6
+            delay        = (node_elapsed / speed) - (time.time() - start_time)
+
+            if (delay > 0):
+                time.sleep(delay)
+
+        analyzer.update(log_data[cuts[i]:cuts[i + 1]])
+
+        if callback is not None:
+            callback(analyzer)
+
+    return time.time() - start_time
+
+# End def
+
+
+
+# -----------------------------------------------------------------------------
+# Internal Utilities
+# -----------------------------------------------------------------------------
+def _is_data(pkt_type, consts):
+    """Mask of the data packet types."""
+    return ((pkt_type == consts.pkt_type.DATA) |
+            (pkt_type == consts.pkt_type.QOSDATA) |
+            (pkt_type == consts.pkt_type.NULLDATA))
+
+# End def
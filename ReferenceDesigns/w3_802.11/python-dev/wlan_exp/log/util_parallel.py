@@ -0,0 +1,413 @@
+# -*- coding: utf-8 -*-
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design Experiments Framework - Parallel Log Processing
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+
+This module provides a map-reduce style driver to process wlan_exp log data
+with multiple processes.
+
+The log data is split into byte ranges that start on a log entry header.  Each
+range is processed by a worker process, which indexes the range, decodes the
+requested entry types and runs the map step of a reducer on the resulting
+numpy arrays.  The partial results of every range are then combined by the
+reduce step of the reducer in the calling process.
+
+Worker processes do not receive a copy of the log data.  If the log data is a
+raw log data file (for example, the data file of a MmapLogContainer), each
+worker maps the file.  If the log data is a bytes object, it is copied once
+into a shared memory block (requires Python 3.8 or later) that every worker
+attaches to.
+
+Example:
+::
+
+    import wlan_exp.log.util_parallel as par_util
+
+    stats = par_util.process_log(log_data, par_util.TxStatsReducer())
+
+Scripts that call process_log() must protect their main code with
+``if __name__ == '__main__':`` since worker processes may import the script
+(see the Python multiprocessing documentation).
+"""
+
+__all__ = ['LogReducer',
+           'ThroughputVsTimeReducer',
+           'TxStatsReducer',
+           'partition_log_data',
+           'process_log']
+
+import sys
+from . import util as log_util
+
+
+# Fix to support Python 2.x and 3.x
+if sys.version[0]=="3": long=None
+
+
+# -----------------------------------------------------------------------------
+# Log Reducer Classes
+# -----------------------------------------------------------------------------
+class LogReducer(object):
+    """Base class to define the map and reduce steps of process_log().
+
+    Attributes:
+        include_only (list):  Entry type names to decode (see log_util.filter_log_index())
+        merge (dict):         Entry type merges (see log_util.filter_log_index())
+
+    Sub-classes must be defined at the top level of a module so that they can
+    be sent to the worker processes.
+    """
+    include_only = None
+    merge        = None
+
+    def map(self, np_arrays):
+        """Compute the partial result for one byte range of the log.
+
+        Args:
+            np_arrays (dict):  Numpy arrays of the entries in the range, keyed by
+                entry type name (from include_only / merge)
+
+        Returns:
+            partial:  Partial result (must be picklable)
+        """
+        raise NotImplementedError
+
+    def reduce(self, partials):
+        """Combine the partial results of all byte ranges.
+
+        Args:
+            partials (list):  Partial results of map(), in log order
+
+        Returns:
+            result:  Result of process_log()
+        """
+        raise NotImplementedError
+
+# End class()
+
+
+
+class ThroughputVsTimeReducer(LogReducer):
+    """Reducer for received throughput vs time per transmitting station.
+
+    Args:
+        interval (int, optional):  Length of each time bin in microseconds
+
+    Only non-duplicate receptions of data packets with a good FCS are counted
+    (same as the log_process_throughput_vs_time.py example).
+
+    Result:
+        Dictionary of ``{ <addr2> : (<bin start times>, <bytes per bin>) }``
+        where addr2 is the transmitter address as an integer.  Bins without any
+        receptions are not included.
+    """
+    include_only = ['RX_OFDM']
+    merge        = {'RX_OFDM': ['RX_OFDM', 'RX_OFDM_LTG']}
+
+    interval     = None
+
+    def __init__(self, interval=1000):
+        self.interval = interval
+
+    def map(self, np_arrays):
+        import numpy as np
+
+        rx = np_arrays['RX_OFDM']
+
+        if (len(rx) == 0):
+            return {}
+
+        consts = log_util.get_entry_constants('RX_OFDM')
+
+        rx_idx = (((rx['flags'] & consts.flags.DUPLICATE) == 0) &
+                  ((rx['flags'] & consts.flags.FCS_GOOD) != 0) &
+                  ((rx['pkt_type'] == consts.pkt_type.DATA) |
+                   (rx['pkt_type'] == consts.pkt_type.QOSDATA) |
+                   (rx['pkt_type'] == consts.pkt_type.NULLDATA)))
+
+        rx = rx[rx_idx]
+
+        # Sum the lengths per (transmitter, time bin)
+        bins = rx['timestamp'] // np.uint64(self.interval)
+        keys = np.stack((rx['addr2'], bins), axis=1)
+
+        (uniq, inverse) = np.unique(keys, axis=0, return_inverse=True)
+        byte_sums       = np.bincount(inverse.reshape(-1), weights=rx['length'], minlength=len(uniq))
+
+        return {'keys' : uniq, 'bytes' : byte_sums}
+
+    def reduce(self, partials):
+        import numpy as np
+
+        partials = [p for p in partials if p]
+
+        if not partials:
+            return {}
+
+        keys      = np.concatenate([p['keys'] for p in partials])
+        byte_sums = np.concatenate([p['bytes'] for p in partials])
+
+        # Ranges can share a time bin at their boundary
+        (uniq, inverse) = np.unique(keys, axis=0, return_inverse=True)
+        byte_sums       = np.bincount(inverse.reshape(-1), weights=byte_sums, minlength=len(uniq))
+
+        result = dict()
+
+        for addr in np.unique(uniq[:, 0]):
+            sel = (uniq[:, 0] == addr)
+            result[int(addr)] = (uniq[sel, 1] * np.uint64(self.interval), byte_sums[sel])
+
+        return result
+
+# End class()
+
+
+
+class TxStatsReducer(LogReducer):
+    """Reducer for transmit statistics per destination address.
+
+    Result:
+        Numpy structured array with one entry per destination address ('addr1')
+        and the fields 'addr1', 'num_pkts', 'avg_num_tx', 'avg_len', 'tot_len'
+        and 'avg_time' (same as the log_process_tx_stats.py example).
+    """
+    include_only = ['TX_HIGH']
+    merge        = {'TX_HIGH': ['TX_HIGH', 'TX_HIGH_LTG']}
+
+    def map(self, np_arrays):
+        import numpy as np
+
+        tx = np_arrays['TX_HIGH']
+
+        if (len(tx) == 0):
+            return None
+
+        (addrs, inverse) = np.unique(tx['addr1'], return_inverse=True)
+
+        def group_sum(field):
+            return np.bincount(inverse, weights=tx[field], minlength=len(addrs))
+
+        return {'addr1'        : addrs,
+                'num_pkts'     : np.bincount(inverse, minlength=len(addrs)),
+                'num_tx'       : group_sum('num_tx'),
+                'length'       : group_sum('length'),
+                'time_to_done' : group_sum('time_to_done')}
+
+    def reduce(self, partials):
+        import numpy as np
+
+        partials = [p for p in partials if p is not None]
+
+        result_dt = [('addr1', np.uint64), ('num_pkts', np.int64), ('avg_num_tx', np.float64),
+                     ('avg_len', np.float64), ('tot_len', np.int64), ('avg_time', np.float64)]
+
+        if not partials:
+            return np.empty((0,), dtype=result_dt)
+
+        addrs            = np.concatenate([p['addr1'] for p in partials])
+        (uniq, inverse)  = np.unique(addrs, return_inverse=True)
+
+        def group_sum(field):
+            return np.bincount(inverse, weights=np.concatenate([p[field] for p in partials]), minlength=len(uniq))
+
+        num_pkts = group_sum('num_pkts')
+
+        result               = np.empty((len(uniq),), dtype=result_dt)
+        result['addr1']      = uniq
+        result['num_pkts']   = num_pkts
+        result['avg_num_tx'] = group_sum('num_tx') / num_pkts
+        result['avg_len']    = group_sum('length') / num_pkts
+        result['tot_len']    = group_sum('length')
+        result['avg_time']   = group_sum('time_to_done') / num_pkts
+
+        return result
+
+# End class()
+
+
+
+# -----------------------------------------------------------------------------
+# Parallel Log Processing Utilities
+# -----------------------------------------------------------------------------
+def partition_log_data(log_data, num_partitions, num_check=4):
+    """Split log data into byte ranges that start on a log entry header.
+
+    Args:
+        log_data (bytes):            Binary data from a WlanExpNode log (bytes or mmap)
+        num_partitions (int):        Number of byte ranges
+        num_check (int, optional):   Number of consecutive entry headers that must be
+            valid for a 0xACED delimiter to be accepted as an entry boundary
+
+    Returns:
+        ranges (list of tuple):  List of (start, end) byte offsets
+
+    The log data is cut at evenly spaced offsets which are then moved forward
+    to the next entry header.  Because payload bytes can contain the 0xACED
+    delimiter, a candidate header is only accepted if the following
+    ``num_check`` entry headers are also valid.  Ranges may be empty.
+    """
+    log_len = len(log_data)
+    cuts    = [0]
+
+    for i in range(1, num_partitions):
+        target = max((log_len * i) // num_partitions, cuts[-1])
+        cuts.append(_find_entry_boundary(log_data, target, num_check))
+
+    cuts.append(log_len)
+
+    return [(cuts[i], cuts[i + 1]) for i in range(num_partitions)]
+
+# End def
+
+
+
+def process_log(log_data, reducer, num_procs=None, num_partitions=None):
+    """Process log data with a reducer in multiple processes.
+
+    Args:
+        log_data (bytes or str):         Binary data from a WlanExpNode log, or the filename of a
+            raw log data file (for example, MmapLogContainer.filename)
+        reducer (LogReducer):            Map and reduce steps to run on the log data
+        num_procs (int, optional):       Number of worker processes (default is the number of CPUs)
+        num_partitions (int, optional):  Number of byte ranges (default is 4 per process)
+
+    Returns:
+        result:  Return value of reducer.reduce()
+    """
+    import mmap
+    import multiprocessing
+
+    if num_procs is None:
+        num_procs = multiprocessing.cpu_count()
+
+    if num_partitions is None:
+        num_partitions = 4 * num_procs
+
+    shm = None
+
+    if isinstance(log_data, str):
+        source    = ('file', log_data)
+        data_file = open(log_data, 'rb')
+        log_data  = mmap.mmap(data_file.fileno(), 0, access=mmap.ACCESS_READ)
+        data_file.close()
+    else:
+        try:
+            from multiprocessing import shared_memory
+        except ImportError:
+            raise AttributeError("Processing log data from memory requires Python 3.8; provide a raw log data file instead.")
+
+        shm = shared_memory.SharedMemory(create=True, size=max(len(log_data), 1))
+        shm.buf[:len(log_data)] = log_data
+        source = ('shm', shm.name)
+
+    try:
+        ranges = partition_log_data(log_data, num_partitions)
+        tasks  = [(source, start, end, reducer) for (start, end) in ranges if (end > start)]
+
+        if (num_procs > 1) and (len(tasks) > 1):
+            pool     = multiprocessing.Pool(num_procs)
+            partials = pool.map(_process_range, tasks)
+            pool.close()
+            pool.join()
+        else:
+            partials = [_process_range(task) for task in tasks]
+    finally:
+        if shm is not None:
+            shm.close()
+            shm.unlink()
+
+    return reducer.reduce(partials)
+
+# End def
+
+
+
+# -----------------------------------------------------------------------------
+# Internal Utilities
+# -----------------------------------------------------------------------------
+def _find_entry_boundary(log_data, offset, num_check):
+    """Find the first entry header at or after offset."""
+    log_len = len(log_data)
+    pos     = offset + 2
+
+    while True:
+        pos = log_data.find(b'\xed\xac', pos)
+
+        if (pos < 0):
+            return log_len
+
+        if _is_entry_chain(log_data, pos - 2, num_check):
+            return pos - 2
+
+        pos += 1
+
+# End def
+
+
+
+def _is_entry_chain(log_data, offset, num_check):
+    """Check that num_check consecutive entry headers start at offset."""
+    log_len = len(log_data)
+
+    for _ in range(num_check):
+        if ((offset + 8) > log_len):
+            # Reached the end of the log data
+            return True
+
+        hdr_b = bytearray(log_data[offset:offset + 8])
+
+        if (hdr_b[2:4] != b'\xed\xac'):
+            return False
+
+        offset += 8 + hdr_b[6] + (hdr_b[7] * 256)
+
+    return True
+
+# End def
+
+
+
+def _process_range(task):
+    """Worker process:  index, decode and map one byte range of the log data."""
+    (source, start, end, reducer) = task
+
+    if (source[0] == 'file'):
+        import mmap
+
+        with open(source[1], 'rb') as data_file:
+            data_map = mmap.mmap(data_file.fileno(), 0, access=mmap.ACCESS_READ)
+
+        log_data = data_map[start:end]
+        data_map.close()
+        shm      = None
+    else:
+        from multiprocessing import shared_memory
+
+        shm      = shared_memory.SharedMemory(name=source[1])
+        log_data = shm.buf[start:end]
+
+    try:
+        return _map_range(log_data, reducer)
+    finally:
+        if shm is not None:
+            # Release the view of the shared memory before closing it
+            del log_data
+            shm.close()
+
+# End def
+
+
+
+def _map_range(log_data, reducer):
+    """Index and decode the log data, then run the map step of the reducer."""
+    raw_log_index = log_util.gen_raw_log_index(log_data)
+    log_index     = log_util.filter_log_index(raw_log_index, include_only=reducer.include_only, merge=reducer.merge)
+    np_arrays     = log_util.log_data_to_np_arrays(log_data, log_index)
+
+    return reducer.map(dict((k.name, v) for k, v in np_arrays.items()))
+
+# End def
@@ -0,0 +1,230 @@
+# -*- coding: utf-8 -*-
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design Experiments Framework - Tx Queue Statistics Utilities
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+
+This module converts the Tx queue statistics of a node to Numpy arrays and
+calculates percentiles and deadline misses from them.
+
+CPU High keeps three histograms per Tx queue and per station (see
+``node.get_queue_stats()``):
+
+    ===============  =============================================================
+    Histogram        Samples
+    ===============  =============================================================
+    'sojourn'        Time (us) between enqueue and dequeue (dropped packets are
+                     not included)
+    'tx_done'        Time (us) between enqueue and the end of the transmission
+    'occupancy'      Number of packets in the queue at enqueue (including itself)
+    ===============  =============================================================
+
+The bins are log2-scaled:  bin 0 counts samples of 0 and bin N (N > 0) counts
+samples of [2^(N-1), 2^N).  The last bin also counts all larger samples.
+Since only the bin of each sample is known, percentiles are given as the upper
+edge of the bin that contains them (capped at the largest sample), ie they are
+upper bounds that are at most 2x the actual value.
+
+Unlike the latency traces (see ``util_trace``), the queue statistics do not
+need the log:  they cover every packet of the queue / station since the last
+``node.reset_queue_stats()``.
+
+Example:
+::
+
+    import wlan_exp.log.util_queue_stats as queue_stats_util
+
+    stats = ap.get_queue_stats(device=sta)
+
+    queue_stats_util.print_queue_stats(stats)
+
+    # Fraction of packets that were not transmitted within 100 ms
+    (min_miss, max_miss) = queue_stats_util.calc_deadline_miss(stats, 100000)
+
+"""
+
+__all__ = ['QUEUE_STATS_HISTS',
+           'calc_bin_edges',
+           'queue_stats_to_numpy',
+           'calc_queue_stats_percentiles',
+           'calc_deadline_miss',
+           'print_queue_stats']
+
+
+# Histograms of the queue statistics (in order; see cmds.QUEUE_STATS_HIST_NAMES)
+QUEUE_STATS_HISTS = ('sojourn', 'tx_done', 'occupancy')
+
+
+# -----------------------------------------------------------------------------
+# Tx Queue Statistics Functions
+# -----------------------------------------------------------------------------
+def calc_bin_edges(num_bins):
+    """Calculate the edges of the log2 bins of a queue statistics histogram.
+
+    Args:
+        num_bins (int):  Number of bins
+
+    Returns:
+        bin_edges (Numpy Array):  Array of num_bins + 1 floats; bin N holds the
+            samples in [bin_edges[N], bin_edges[N + 1]).  The last edge is infinity.
+    """
+    import numpy as np
+
+    bin_edges = np.zeros((num_bins + 1,), dtype=np.float64)
+
+    bin_edges[1:num_bins] = 2.0 ** np.arange(num_bins - 1)
+    bin_edges[num_bins]   = np.inf
+
+    return bin_edges
+
+# End def
+
+
+
+def queue_stats_to_numpy(stats):
+    """Convert the queue statistics of a queue or station to Numpy arrays.
+
+    Args:
+        stats (dict):  Output of ``node.get_queue_stats()``
+
+    Returns:
+        histograms (dict):  Dictionary of ``{ <hist> : (counts, bin_edges) }`` (see
+            ``calc_bin_edges()``); all histograms share the same bin edges
+    """
+    import numpy as np
+
+    histograms = {}
+
+    for hist in QUEUE_STATS_HISTS:
+        counts = np.array(stats[hist]['bins'], dtype=np.uint64)
+
+        histograms[hist] = (counts, calc_bin_edges(len(counts)))
+
+    return histograms
+
+# End def
+
+
+
+def calc_queue_stats_percentiles(stats, percentiles=(50, 90, 99, 99.9), hists=None):
+    """Calculate the number of samples, the max and the percentiles of each histogram.
+
+    Args:
+        stats (dict):                  Output of ``node.get_queue_stats()``
+        percentiles (list, optional):  Percentiles to calculate
+        hists (list, optional):        Histograms to include (default is QUEUE_STATS_HISTS)
+
+    Returns:
+        results (dict):  Dictionary of ``{ <hist> : { 'count', 'max', <percentile> : <value> ... } }``.
+            Each percentile is the upper edge of the bin that contains it, capped at
+            'max' (0 if the histogram has no samples).
+    """
+    import numpy as np
+
+    if hists is None:
+        hists = QUEUE_STATS_HISTS
+
+    results = {}
+
+    for hist in hists:
+        counts    = np.array(stats[hist]['bins'], dtype=np.uint64)
+        max_value = int(stats[hist]['max'])
+        cum       = np.cumsum(counts)
+        total     = int(cum[-1]) if len(cum) else 0
+
+        # Upper edge of each bin (the last bin ends at the largest sample)
+        upper     = np.minimum(calc_bin_edges(len(counts))[1:], max_value)
+
+        results[hist] = {'count' : total, 'max' : max_value}
+
+        for p in percentiles:
+            if total:
+                # First bin in which at least p percent of the samples are at or below the bin
+                idx = int(np.searchsorted(cum, (p / 100.0) * total, side='left'))
+
+                results[hist][p] = float(upper[min(idx, len(upper) - 1)])
+            else:
+                results[hist][p] = 0.0
+
+    return results
+
+# End def
+
+
+
+def calc_deadline_miss(stats, deadline, hist='tx_done'):
+    """Calculate the fraction of packets whose latency exceeded a deadline.
+
+    Args:
+        stats (dict):          Output of ``node.get_queue_stats()``
+        deadline (int):        Deadline in microseconds (or packets for 'occupancy')
+        hist (str, optional):  Histogram to use (default is 'tx_done')
+
+    Returns:
+        (min_fraction, max_fraction) (tuple of float):  Bounds of the fraction of
+            samples larger than deadline.  The bounds differ by the fraction of
+            samples in the bin that contains the deadline.  Both are 0.0 if the
+            histogram has no samples.
+    """
+    import numpy as np
+
+    counts    = np.array(stats[hist]['bins'], dtype=np.uint64)
+    total     = float(counts.sum())
+
+    if (total == 0) or (deadline >= stats[hist]['max']):
+        return (0.0, 0.0)
+
+    bin_edges = calc_bin_edges(len(counts))
+
+    # Samples in bins that start after the deadline are all larger than it;
+    # samples in the bin that contains the deadline may be
+    above     = float(counts[bin_edges[:-1] > deadline].sum())
+    partial   = float(counts[(bin_edges[:-1] <= deadline) & (bin_edges[1:] > (deadline + 1))].sum())
+
+    # The largest sample is known to be larger than the deadline
+    if (above == 0):
+        above    = 1.0
+        partial -= 1.0
+
+    return (above / total, (above + partial) / total)
+
+# End def
+
+
+
+def print_queue_stats(stats, percentiles=(50, 90, 99, 99.9)):
+    """Print the number of samples, the percentiles and the max of each histogram.
+
+    Args:
+        stats (dict):                  Output of ``node.get_queue_stats()``
+        percentiles (list, optional):  Percentiles to print
+    """
+    if stats is None:
+        print('No Tx queue statistics\n')
+        return
+
+    results = calc_queue_stats_percentiles(stats, percentiles)
+
+    header = '{0:<16} | {1:>9}'.format('Histogram', 'Count')
+    for p in percentiles:
+        header += ' | {0:>9}'.format('p{0} <='.format(p))
+    header += ' | {0:>9}'.format('Max')
+
+    print(header)
+
+    for hist in QUEUE_STATS_HISTS:
+        r    = results[hist]
+        name = '{0} ({1})'.format(hist, 'pkts' if (hist == 'occupancy') else 'us')
+        line = '{0:<16} | {1:9d}'.format(name, r['count'])
+        for p in percentiles:
+            line += ' | {0:9.0f}'.format(r[p])
+        line += ' | {0:9d}'.format(r['max'])
+
+        print(line)
+
+    print('')
+
+# End def
@@ -9,6 +9,9 @@ License:   Copyright 2014-2017, Mango Communications. All rights reserved.
 
 Provides sample data to use with the log examples.
 
+Synthetic log data of any size can be generated without downloading the
+sample data (see util_synth).
+
 """
 
 _SAMPLE_DATA_DIR = 'sample_data'
@@ -0,0 +1,856 @@
+# -*- coding: utf-8 -*-
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design Experiments Framework - Synthetic Log Data Utilities
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+
+This module generates synthetic log data in the binary format of the event
+log of an 802.11 Reference Design AP.  The generated data can be processed by
+all of the log utilities and log examples, so they can be exercised (and
+timed) at any scale without hardware or the downloadable sample data (see
+util_sample_data).
+
+The log of an AP with a number of associated stations is modeled:
+    * NODE_INFO and TIME_INFO entries at the start of the log
+    * For each downlink packet, one TX_LOW entry per transmission attempt
+      followed by the TX_HIGH entry of the packet.  Packets are served in
+      arrival order by a single DCF queue, so TX_LOW entries never overlap and
+      ``time_to_accept`` includes the time spent waiting in the queue.
+    * For each uplink packet, an RX_OFDM entry (a fraction of them with FCS
+      errors)
+    * TX_LOW entries for beacons and periodic TIME_INFO / EXP_INFO entries
+
+When ``ltg=True`` data packets are logged with the LTG entry types and carry
+an LTG payload (LLC header, LTG sequence number and LTG ID).  All entries use
+the definitions in entry_types, and entries are placed in the log in the order
+the node would create them (e.g. TX_HIGH entries after their TX_LOW entries).
+
+Example:
+::
+
+    import wlan_exp.log.util as log_util
+    import wlan_exp.log.util_synth as synth_util
+
+    # 10 seconds of log data
+    gen           = synth_util.SyntheticLogGenerator(num_stations=8, traffic='bursty', rate=500, seed=1)
+    log_data      = gen.gen_log_data(duration=10000000)
+    raw_log_index = log_util.gen_raw_log_index(log_data)
+
+    # HDF5 log file with 1 GB of log data
+    gen.gen_log_file('synthetic_1GB.hdf5', size=2**30)
+
+Generation is deterministic for a given ``seed``.
+"""
+
+__all__ = ['SyntheticLogGenerator',
+           'gen_log_data']
+
+import sys
+
+from . import util as log_util
+from . import entry_types
+
+
+# Fix to support Python 2.x and 3.x
+if sys.version[0]=="3": long=None
+
+
+# MAC addresses of the AP and its stations (station N is STA_BASE_ADDR + N)
+AP_MAC_ADDR                       = 0x40D855042000
+STA_BASE_ADDR                     = 0x40D855043000
+BROADCAST_ADDR                    = 0xFFFFFFFFFFFF
+
+# Approximate 802.11 OFDM DCF timing (microseconds)
+SLOT_TIME                         = 9
+SIFS_TIME                         = 16
+DIFS_TIME                         = SIFS_TIME + (2 * SLOT_TIME)
+ACK_TIME                          = 44
+ACK_TIMEOUT                       = SIFS_TIME + SLOT_TIME + 20
+CW_MIN                            = 15
+CW_MAX                            = 1023
+
+# LLC header of LTG packets (LLC_SNAP with the non-standard LLC_TYPE_WLAN_LTG type)
+LTG_LLC_HDR                       = [0xAA, 0xAA, 0x03, 0x00, 0x00, 0x00, 0x90, 0x90]
+
+BEACON_LENGTH                     = 120
+
+# Host time (microseconds since epoch) at MAC time 0:  2017-01-01 00:00:00 UTC
+HOST_TIME_BASE                    = 1483228800000000
+
+
+# -----------------------------------------------------------------------------
+# Synthetic Log Generator Class
+# -----------------------------------------------------------------------------
+class SyntheticLogGenerator(object):
+    """Generator of synthetic AP log data.
+
+    Args:
+        num_stations (int, optional):         Number of associated stations
+        traffic (str, optional):              Packet arrival model of each station in each direction:
+            'cbr' (fixed interval), 'poisson' (exponential inter-arrival times) or 'bursty' (Poisson
+            arrivals of bursts of ``burst_len`` packets on average, ``burst_spacing`` us apart)
+        rate (float, optional):               Mean number of packets per second per station (both directions)
+        uplink_fraction (float, optional):    Fraction of ``rate`` sent by the stations to the AP
+        payload_len (int or tuple, optional): MPDU length in bytes, or (min, max) for uniformly distributed lengths
+        mcs_mix (dict, optional):             Relative weight of each MCS, ``{<mcs> : <weight>}``; the MCS
+            of each packet is drawn from this mix (default is all MCS in [0:7] equally likely)
+        phy_mode (str, optional):             PHY mode of data packets ('NONHT' or 'HTMF')
+        ltg (bool, optional):                 Log data packets as LTG packets
+        retry_prob (float, optional):         Probability that a Tx attempt is not acknowledged; also
+            the probability of an FCS error for uplink packets
+        max_tx (int, optional):               Maximum number of Tx attempts per packet
+        burst_len (int, optional):            Mean number of packets per burst ('bursty' traffic)
+        burst_spacing (int, optional):        Time in microseconds between packets of a burst ('bursty' traffic)
+        beacon_interval (int, optional):      Beacon interval in microseconds (None for no beacons)
+        time_info_interval (int, optional):   Interval in microseconds of TIME_INFO entries (None for only the first)
+        exp_info_interval (int, optional):    Interval in microseconds of EXP_INFO entries (None for none)
+        channel (int, optional):              Channel of all packets
+        seed (int, optional):                 Seed of the random number generator
+    """
+    num_stations        = None
+    traffic             = None
+    rate                = None
+    uplink_fraction     = None
+    payload_len         = None
+    mcs_mix             = None
+    phy_mode            = None
+    ltg                 = None
+    retry_prob          = None
+    max_tx              = None
+    burst_len           = None
+    burst_spacing       = None
+    beacon_interval     = None
+    time_info_interval  = None
+    exp_info_interval   = None
+    channel             = None
+    seed                = None
+
+    _rng                = None
+    _time               = None             # MAC time (microseconds) of the next chunk of log data
+    _entry_count        = None             # Number of entries created (entry header sequence number)
+    _uniq_seq           = None             # Next TX_HIGH unique sequence number
+    _next_arrival       = None             # Next packet (or burst) arrival time of each flow
+    _ltg_seq            = None             # Next sequence number of each flow
+    _tx_busy_until      = None             # Time when the AP Tx queue is empty
+    _next_beacon        = None
+    _next_time_info     = None
+    _next_exp_info      = None
+    _sta_power          = None             # Mean Rx power of each station
+    _sta_chan_est       = None             # Channel estimate of each station
+
+    def __init__(self, num_stations=4, traffic='poisson', rate=1000.0, uplink_fraction=0.5, payload_len=1500,
+                 mcs_mix=None, phy_mode='NONHT', ltg=True, retry_prob=0.1, max_tx=7, burst_len=10,
+                 burst_spacing=200, beacon_interval=102400, time_info_interval=1000000,
+                 exp_info_interval=None, channel=1, seed=None):
+        import wlan_exp.util as util
+
+        if traffic not in ['cbr', 'poisson', 'bursty']:
+            raise AttributeError("Traffic model must be in ['cbr', 'poisson', 'bursty']")
+
+        if phy_mode not in ['NONHT', 'HTMF', util.phy_modes['NONHT'], util.phy_modes['HTMF']]:
+            raise AttributeError("PHY mode must be in ['NONHT', 'HTMF', phy_modes['NONHT'], phy_modes['HTMF']]")
+
+        if mcs_mix is None:
+            mcs_mix = dict((mcs, 1.0) for mcs in range(8))
+
+        if any((mcs < 0) or (mcs > 7) for mcs in mcs_mix.keys()):
+            raise AttributeError("MCS values in mcs_mix must be in [0:7]")
+
+        self.num_stations       = num_stations
+        self.traffic            = traffic
+        self.rate               = float(rate)
+        self.uplink_fraction    = uplink_fraction
+        self.payload_len        = payload_len
+        self.mcs_mix            = mcs_mix
+        self.phy_mode           = util.phy_modes[phy_mode] if phy_mode in util.phy_modes else phy_mode
+        self.ltg                = ltg
+        self.retry_prob         = retry_prob
+        self.max_tx             = max_tx
+        self.burst_len          = burst_len
+        self.burst_spacing      = burst_spacing
+        self.beacon_interval    = beacon_interval
+        self.time_info_interval = time_info_interval
+        self.exp_info_interval  = exp_info_interval
+        self.channel            = channel
+        self.seed               = seed
+
+        self.reset()
+
+
+    def reset(self):
+        """Restart the log:  the next log data starts with the NODE_INFO entry at MAC time 0."""
+        import numpy as np
+
+        self._rng            = np.random.RandomState(self.seed)
+        self._time           = 0
+        self._entry_count    = 0
+        self._uniq_seq       = 0
+        self._tx_busy_until  = 0
+        self._next_beacon    = 0
+        self._next_time_info = 0
+        self._next_exp_info  = 0
+
+        # Flows are indexed by [direction (0 = downlink, 1 = uplink), station]
+        self._next_arrival   = np.zeros((2, self.num_stations), dtype=np.float64)
+        self._ltg_seq        = np.zeros((2, self.num_stations), dtype=np.uint64)
+
+        for direction in range(2):
+            rate = self._get_flow_rate(direction)
+
+            if (rate > 0) and (self.traffic != 'bursty'):
+                self._next_arrival[direction] = self._rng.uniform(0, 1e6 / rate, self.num_stations)
+            elif (rate > 0):
+                self._next_arrival[direction] = self._rng.exponential(1e6 * self.burst_len / rate, self.num_stations)
+
+        # Per-station channel:  mean Rx power and channel estimate (nulled DC and guard subcarriers)
+        self._sta_power      = self._rng.uniform(-75, -35, self.num_stations)
+        self._sta_chan_est   = self._rng.randint(-2048, 2048, size=(self.num_stations, 64, 2)).astype(np.int16)
+        self._sta_chan_est[:, [0] + list(range(27, 38))] = 0
+
+
+    def gen_log_data(self, duration, log_capacity=None, corrupt_tail=False, return_index=False):
+        """Generate the next ``duration`` microseconds of log data.
+
+        Args:
+            duration (int):                Amount of MAC time in microseconds to generate
+            log_capacity (int, optional):  Capacity of the node's log in bytes.  If more log data than this
+                is generated, the log wraps:  the oldest entries (including NODE_INFO) are overwritten and
+                the returned log data starts at the oldest entry that is left.
+            corrupt_tail (bool, optional): Truncate the last entry of the log data at a random byte (as
+                when the end of the log data is read while the entry is being written)
+            return_index (bool, optional): Also return the raw log index of the log data
+
+        Returns:
+            log_data (bytearray):  Binary log data, or ``(log_data, raw_log_index)`` if ``return_index``
+                is True.  The offsets of the raw log index are numpy arrays; it matches
+                ``log_util.gen_raw_log_index(log_data)``.
+
+        Consecutive calls continue the same log (MAC time, sequence numbers and
+        queues), so the concatenation of the returned log data is one valid log
+        unless ``log_capacity`` or ``corrupt_tail`` is used.
+        """
+        import numpy as np
+
+        (log_data, log_index) = self._gen_log_chunk(duration)
+
+        if (log_capacity is not None) and (len(log_data) > log_capacity):
+            starts = np.sort(np.concatenate(list(log_index.values()))) - log_util.LOG_ENTRY_HDR_SIZE
+            start  = starts[np.searchsorted(starts, len(log_data) - log_capacity)]
+
+            log_data  = log_data[start:]
+            log_index = self._trim_log_index(log_index, start, len(log_data) + start)
+
+        if corrupt_tail and (len(log_index) > 0):
+            start     = max(v[-1] for v in log_index.values()) - log_util.LOG_ENTRY_HDR_SIZE
+            end       = start + self._rng.randint(1, len(log_data) - start)
+
+            log_data  = log_data[:end]
+            log_index = self._trim_log_index(log_index, 0, start)
+
+        if return_index:
+            return (log_data, log_index)
+        else:
+            return log_data
+
+
+    def gen_log_file(self, filename, size, chunk_duration=1000000, compression=None):
+        """Generate an HDF5 log file with (at least) ``size`` bytes of log data.
+
+        Args:
+            filename (str):                  Name of the HDF5 file (see util_hdf.hdf5_open_file())
+            size (int):                      Minimum number of bytes of log data
+            chunk_duration (int, optional):  Amount of MAC time in microseconds generated at a time; the
+                memory used is proportional to the log data generated per chunk
+            compression (str, optional):     Compression of the HDF5 datasets (e.g. 'gzip')
+
+        Returns:
+            filename (str):  Name of the HDF5 file that was written (a suffix is added to
+                ``filename`` if the file already exists)
+
+        The raw log index is built from the generated offsets, so the log data
+        is never read back from the file.
+        """
+        import wlan_exp.log.util_hdf as hdf_util
+
+        if (self.rate == 0) and (self.beacon_interval is None) and (self.time_info_interval is None) and (self.exp_info_interval is None):
+            raise AttributeError("Generator does not create any entries after NODE_INFO")
+
+        h5_file       = hdf_util.hdf5_open_file(filename)
+        real_filename = h5_file.filename
+        log_container = hdf_util.HDF5LogContainer(h5_file, compression=compression)
+
+        log_index     = dict()
+        data_size     = 0
+
+        try:
+            while (data_size < size):
+                (log_data, chunk_index) = self._gen_log_chunk(chunk_duration)
+
+                if (len(log_data) > 0):
+                    log_container.write_log_data(log_data)
+                    log_util.merge_log_indexes(log_index, chunk_index, data_size)
+
+                    data_size += len(log_data)
+
+            log_container.write_log_index(log_index)
+
+        finally:
+            hdf_util.hdf5_close_file(h5_file)
+
+        return real_filename
+
+
+    # -------------------------------------------------------------------------
+    # Internal methods
+    # -------------------------------------------------------------------------
+    def _gen_log_chunk(self, duration):
+        """Generate the entries in [_time, _time + duration) and build their log data and raw log index."""
+        t_start    = self._time
+        t_end      = self._time + duration
+
+        # List of (entry_type, entry_size, entries, log_time) for each group of entries
+        #   entries is a structured array with the entry type's fields_np_dt or a uint8 array of raw entries
+        blocks     = []
+
+        if (t_start == 0):
+            blocks.append(self._gen_node_info())
+
+        blocks.extend(self._gen_info_entries(t_start, t_end))
+        blocks.extend(self._gen_downlink(t_start, t_end))
+        blocks.append(self._gen_uplink(t_start, t_end))
+        blocks.append(self._gen_beacons(t_start, t_end))
+
+        self._time = t_end
+
+        return self._build_log_data(blocks)
+
+
+    def _build_log_data(self, blocks):
+        """Place the entries in the log in the order they were logged and write their headers and contents."""
+        import numpy as np
+
+        hdr_size  = log_util.LOG_ENTRY_HDR_SIZE
+        blocks    = [b for b in blocks if (b is not None) and (len(b[2]) > 0)]
+
+        if not blocks:
+            return (bytearray(), dict())
+
+        counts    = np.array([len(b[2]) for b in blocks])
+        type_ids  = np.repeat([b[0].entry_type_id for b in blocks], counts)
+        sizes     = np.repeat([b[1] for b in blocks], counts).astype(np.int64)
+        log_times = np.concatenate([b[3] for b in blocks])
+
+        # Offsets of the entry headers, indexed in block order
+        order             = np.argsort(log_times, kind='mergesort')
+        total_sizes       = sizes[order] + hdr_size
+        offsets           = np.empty(len(order), dtype=np.int64)
+        offsets[order]    = np.cumsum(total_sizes) - total_sizes
+
+        num_entries       = len(order)
+        log_data          = bytearray(int(total_sizes.sum()))
+
+        # Entry headers
+        hdrs                 = np.zeros(num_entries, dtype=[('entry_id', '<u2'), ('delim', '<u2'), ('entry_type', '<u2'), ('entry_length', '<u2')])
+        hdrs['entry_id'][order] = (self._entry_count + np.arange(num_entries)) & 0xFFFF
+        hdrs['delim']        = entry_types.WLAN_EXP_LOG_DELIM
+        hdrs['entry_type']   = type_ids
+        hdrs['entry_length'] = sizes
+
+        log_util.write_byte_fields(log_data, offsets, hdrs.view(np.uint8).reshape(num_entries, hdr_size))
+
+        self._entry_count   += num_entries
+
+        # Entry contents
+        block_ends = np.cumsum(counts)
+
+        for (b, end, count) in zip(blocks, block_ends, counts):
+            entry_offsets = offsets[end - count:end] + hdr_size
+
+            if b[2].dtype.names is None:
+                log_util.write_byte_fields(log_data, entry_offsets, b[2])
+            else:
+                b[0].serialize_np(log_data, entry_offsets, b[2])
+
+        # Raw log index
+        log_index    = dict()
+        sorted_types = type_ids[order]
+        sorted_offs  = offsets[order] + hdr_size
+
+        for type_id in np.unique(sorted_types):
+            log_index[int(type_id)] = sorted_offs[sorted_types == type_id]
+
+        return (log_data, log_index)
+
+
+    def _trim_log_index(self, log_index, start, end):
+        """Keep the index entries with headers in [start, end) and make them relative to start."""
+        hdr_size  = log_util.LOG_ENTRY_HDR_SIZE
+        ret_index = dict()
+
+        for k, v in log_index.items():
+            v = v[((v - hdr_size) >= start) & ((v - hdr_size) < end)] - start
+
+            if (len(v) > 0):
+                ret_index[k] = v
+
+        return ret_index
+
+
+    def _get_flow_rate(self, direction):
+        """Mean packet rate (packets / sec) of a station's flow in the given direction."""
+        if (direction == 0):
+            return self.rate * (1.0 - self.uplink_fraction)
+        else:
+            return self.rate * self.uplink_fraction
+
+
+    def _gen_arrivals(self, direction, t_start, t_end):
+        """Packet arrival times in [t_start, t_end) of all stations in the given direction.
+
+        Returns:
+            (times, stations):  Arrival times (int64, sorted) and station index of each packet
+        """
+        import numpy as np
+
+        rate     = self._get_flow_rate(direction)
+        times    = []
+        stations = []
+
+        if (rate <= 0):
+            return (np.zeros(0, dtype=np.int64), np.zeros(0, dtype=np.intp))
+
+        for sta in range(self.num_stations):
+            next_time = self._next_arrival[direction, sta]
+
+            if (self.traffic == 'cbr'):
+                interval = 1e6 / rate
+                t        = next_time + interval * np.arange(max(0, int(np.ceil((t_end - next_time) / interval))))
+                self._next_arrival[direction, sta] = next_time + interval * len(t)
+
+            else:
+                # Poisson arrivals of packets, or of bursts of packets
+                mean_interval = 1e6 / rate
+
+                if (self.traffic == 'bursty'):
+                    mean_interval *= self.burst_len
+
+                t = [np.zeros(0)]
+
+                while (next_time < t_end):
+                    n         = int(1.2 * (t_end - next_time) / mean_interval) + 16
+                    arr       = next_time + np.cumsum(np.concatenate(([0.0], self._rng.exponential(mean_interval, n))))
+                    t.append(arr[:-1][arr[:-1] < t_end])
+                    next_time = arr[np.searchsorted(arr, t_end)] if (arr[-1] >= t_end) else arr[-1]
+
+                t = np.concatenate(t)
+
+                self._next_arrival[direction, sta] = next_time
+
+                if (self.traffic == 'bursty') and (len(t) > 0):
+                    # Expand each burst into a geometrically distributed number of packets
+                    burst_size = self._rng.geometric(1.0 / self.burst_len, len(t))
+                    first      = np.cumsum(burst_size) - burst_size
+                    idx        = np.arange(burst_size.sum()) - np.repeat(first, burst_size)
+                    t          = np.repeat(t, burst_size) + (idx * self.burst_spacing)
+                    t          = t[t < t_end]
+
+            times.append(t)
+            stations.append(np.full(len(t), sta, dtype=np.intp))
+
+        times    = np.concatenate(times).astype(np.int64)
+        stations = np.concatenate(stations)
+        order    = np.argsort(times, kind='mergesort')
+
+        return (times[order], stations[order])
+
+
+    def _gen_pkt_params(self, num_pkts):
+        """MCS and MPDU length of each packet."""
+        import numpy as np
+
+        mcs_values = np.array(list(self.mcs_mix.keys()), dtype=np.uint8)
+        weights    = np.array(list(self.mcs_mix.values()), dtype=np.float64)
+        mcs        = self._rng.choice(mcs_values, num_pkts, p=(weights / weights.sum()))
+
+        if isinstance(self.payload_len, (tuple, list)):
+            length = self._rng.randint(self.payload_len[0], self.payload_len[1] + 1, num_pkts)
+        else:
+            length = np.full(num_pkts, self.payload_len, dtype=np.int64)
+
+        return (mcs, length)
+
+
+    def _gen_flow_seq(self, direction, stations):
+        """Sequence number of each packet within its flow (and advance the flows)."""
+        import numpy as np
+
+        counts        = np.bincount(stations, minlength=self.num_stations)
+        order         = np.argsort(stations, kind='mergesort')
+        ranks         = np.empty(len(stations), dtype=np.uint64)
+        ranks[order]  = np.arange(len(stations)) - np.repeat(np.cumsum(counts) - counts, counts)
+
+        seq           = self._ltg_seq[direction, stations] + ranks
+
+        self._ltg_seq[direction] += counts.astype(np.uint64)
+
+        return seq
+
+
+    def _gen_mac_headers(self, size, pkt_type, fc_flags, addr1, addr2, addr3, mac_seq, ltg_seq=None, ltg_id=None):
+        """MAC payload bytes:  802.11 MAC header followed by the LTG payload, if any."""
+        import numpy as np
+
+        num_pkts           = len(mac_seq)
+        hdrs               = np.zeros((num_pkts, size), dtype=np.uint8)
+
+        hdrs[:, 0]         = pkt_type
+        hdrs[:, 1]         = fc_flags
+        hdrs[:, 2]         = ACK_TIME
+        hdrs[:, 4:10]      = _mac_addr_bytes(addr1, num_pkts)
+        hdrs[:, 10:16]     = _mac_addr_bytes(addr2, num_pkts)
+        hdrs[:, 16:22]     = _mac_addr_bytes(addr3, num_pkts)
+        hdrs[:, 22:24]     = ((np.asarray(mac_seq, dtype=np.uint16) & 0xFFF) << 4).astype('<u2').view(np.uint8).reshape(num_pkts, 2)
+
+        if ltg_seq is not None:
+            hdrs[:, 24:32] = LTG_LLC_HDR
+            hdrs[:, 32:40] = np.asarray(ltg_seq, dtype='<u8').view(np.uint8).reshape(num_pkts, 8)
+            hdrs[:, 40:44] = np.asarray(np.broadcast_to(ltg_id, (num_pkts,)), dtype='<u4').view(np.uint8).reshape(num_pkts, 4)
+
+        return hdrs
+
+
+    def _gen_node_info(self):
+        """NODE_INFO entry at the start of the log."""
+        import numpy as np
+        import wlan_exp.version as version
+
+        entry_type = entry_types.entry_node_info
+        entry      = np.zeros(1, dtype=entry_type.fields_np_dt)
+
+        entry['node_type']                 = entry_type.consts['node_type']['AP_DCF']
+        entry['node_id']                   = 0
+        entry['platform_id']               = 3
+        entry['serial_num']                = 10000 + self._rng.randint(0, 10000)
+        entry['fpga_dna']                  = self._rng.randint(0, 2**62, dtype=np.int64)
+        entry['version']                   = (version.WLAN_EXP_MAJOR << 24) + (version.WLAN_EXP_MINOR << 16) + version.WLAN_EXP_REVISION
+        entry['scheduler_resolution']      = 64
+        entry['wlan_mac_addr']             = AP_MAC_ADDR
+        entry['max_tx_power_dbm']          = 21
+        entry['min_tx_power_dbm']          = -9
+        entry['cpu_high_compilation_date'] = b'Jan  1 2017'
+        entry['cpu_high_compilation_time'] = b'00:00:00'
+        entry['cpu_low_compilation_date']  = b'Jan  1 2017'
+        entry['cpu_low_compilation_time']  = b'00:00:00'
+
+        return (entry_type, entry_type.fields_np_dt.itemsize, entry, np.zeros(1, dtype=np.int64))
+
+
+    def _gen_info_entries(self, t_start, t_end):
+        """TIME_INFO and EXP_INFO entries in [t_start, t_end)."""
+        import numpy as np
+
+        blocks = []
+
+        # TIME_INFO (the first one records the system time base, the rest are added by wlan_exp)
+        if (self._next_time_info < t_end):
+            if self.time_info_interval is None:
+                timestamps = np.array([self._next_time_info], dtype=np.int64)
+                self._next_time_info = 2**62
+            else:
+                timestamps = np.arange(self._next_time_info, t_end, self.time_info_interval, dtype=np.int64)
+                self._next_time_info = timestamps[-1] + self.time_info_interval
+
+            entry_type = entry_types.entry_time_info
+            entries    = np.zeros(len(timestamps), dtype=entry_type.fields_np_dt)
+
+            entries['timestamp']        = timestamps
+            entries['time_id']          = self._rng.randint(0, 2**31, len(timestamps))
+            entries['reason']           = entry_type.consts['reason']['WLAN_EXP_ADD_LOG']
+            entries['mac_timestamp']    = timestamps
+            entries['system_timestamp'] = timestamps
+            entries['host_timestamp']   = HOST_TIME_BASE + timestamps
+
+            if (timestamps[0] == 0):
+                entries['reason'][0]         = entry_type.consts['reason']['SYSTEM']
+                entries['time_id'][0]        = 0
+                entries['host_timestamp'][0] = 0xFFFFFFFFFFFFFFFF
+
+            blocks.append((entry_type, entry_type.fields_np_dt.itemsize, entries, timestamps))
+
+        # EXP_INFO entries with a text message (variable length entries are written as raw bytes)
+        if (self.exp_info_interval is not None) and (self._next_exp_info < t_end):
+            timestamps = np.arange(self._next_exp_info, t_end, self.exp_info_interval, dtype=np.int64)
+            self._next_exp_info = timestamps[-1] + self.exp_info_interval
+
+            msg        = np.frombuffer(b'Synthetic log data', dtype=np.uint8)
+            msg_size   = 4 * ((len(msg) + 3) // 4)
+            hdr_dt     = np.dtype([('timestamp', '<u8'), ('info_type', '<u2'), ('info_len', '<u2')])
+            hdrs       = np.zeros(len(timestamps), dtype=hdr_dt)
+
+            hdrs['timestamp'] = timestamps
+            hdrs['info_type'] = 1
+            hdrs['info_len']  = len(msg)
+
+            entries    = np.zeros((len(timestamps), hdr_dt.itemsize + msg_size), dtype=np.uint8)
+            entries[:, :hdr_dt.itemsize] = hdrs.view(np.uint8).reshape(len(timestamps), hdr_dt.itemsize)
+            entries[:, hdr_dt.itemsize:hdr_dt.itemsize + len(msg)] = msg
+
+            blocks.append((entry_types.entry_exp_info_hdr, entries.shape[1], entries, timestamps))
+
+        return blocks
+
+
+    def _gen_downlink(self, t_start, t_end):
+        """TX_LOW entries (one per attempt) and TX_HIGH entries of the downlink packets in [t_start, t_end)."""
+        import numpy as np
+
+        (arrivals, stations) = self._gen_arrivals(0, t_start, t_end)
+        num_pkts             = len(arrivals)
+
+        if (num_pkts == 0):
+            return []
+
+        (mcs, length) = self._gen_pkt_params(num_pkts)
+        airtime       = log_util.calc_tx_time(mcs, self.phy_mode, length, 20).astype(np.int64)
+
+        # Number of Tx attempts:  each attempt fails with retry_prob, up to max_tx attempts
+        if (self.retry_prob > 0):
+            num_attempts = self._rng.geometric(1.0 - self.retry_prob, num_pkts)
+        else:
+            num_attempts = np.ones(num_pkts, dtype=np.int64)
+
+        successful    = num_attempts <= self.max_tx
+        num_tx        = np.minimum(num_attempts, self.max_tx)
+
+        # Attempts:  backoff with a doubling contention window, then the waveform and the ACK (or ACK timeout)
+        total_tx      = int(num_tx.sum())
+        pkt           = np.repeat(np.arange(num_pkts), num_tx)
+        first         = np.cumsum(num_tx) - num_tx
+        attempt       = np.arange(total_tx) - first[pkt] + 1
+        cw            = np.minimum(((CW_MIN + 1) << np.minimum(attempt - 1, 10)) - 1, CW_MAX)
+        num_slots     = (self._rng.random_sample(total_tx) * (cw + 1)).astype(np.int64)
+        received      = successful[pkt] & (attempt == num_tx[pkt])
+        att_duration  = DIFS_TIME + (num_slots * SLOT_TIME) + airtime[pkt] + np.where(received, SIFS_TIME + ACK_TIME, ACK_TIMEOUT)
+
+        cs            = np.cumsum(att_duration)
+        att_start     = cs - att_duration - (cs - att_duration)[first][pkt]
+        time_to_done  = np.add.reduceat(att_duration, first)
+
+        # Single FIFO Tx queue:  Lindley recursion done[i] = max(arrival[i], done[i-1]) + time_to_done[i]
+        #   computed as a running maximum over the cumulative service time
+        service       = np.cumsum(time_to_done)
+        prev_service  = service - time_to_done
+        start_offset  = np.maximum.accumulate(np.concatenate(([self._tx_busy_until], arrivals - prev_service)))[1:]
+        tx_begin      = start_offset + prev_service
+        tx_done       = start_offset + service
+
+        self._tx_busy_until = tx_done[-1]
+
+        time_to_accept  = tx_begin - arrivals
+        queue_occupancy = np.arange(1, num_pkts + 1) - np.searchsorted(tx_begin, arrivals, side='left')
+
+        uniq_seq        = self._uniq_seq + np.arange(num_pkts, dtype=np.uint64)
+        self._uniq_seq += num_pkts
+
+        sta_addrs       = STA_BASE_ADDR + stations.astype(np.uint64)
+
+        if self.ltg:
+            tx_high_type = entry_types.entry_tx_high_ltg
+            tx_low_type  = entry_types.entry_tx_low_ltg
+            payload_len  = 44
+            ltg_seq      = self._gen_flow_seq(0, stations)
+            ltg_id       = stations + 1
+        else:
+            tx_high_type = entry_types.entry_tx_high
+            tx_low_type  = entry_types.entry_tx_low
+            payload_len  = 24
+            ltg_seq      = None
+            ltg_id       = None
+
+        mac_hdrs      = self._gen_mac_headers(payload_len, entry_types.common_pkt_types['DATA'], 0x02,
+                                              sta_addrs, AP_MAC_ADDR, AP_MAC_ADDR, uniq_seq, ltg_seq, ltg_id)
+
+        # TX_HIGH
+        tx_high                    = np.zeros(num_pkts, dtype=tx_high_type.fields_np_dt)
+        tx_high['timestamp']       = arrivals
+        tx_high['time_to_accept']  = time_to_accept
+        tx_high['time_to_done']    = time_to_done
+        tx_high['uniq_seq']        = uniq_seq
+        tx_high['num_tx']          = num_tx
+        tx_high['length']          = length
+        tx_high['pkt_type']        = entry_types.common_pkt_types['DATA']
+        tx_high['queue_id']        = stations + 1
+        tx_high['queue_occupancy'] = queue_occupancy
+        tx_high['flags']           = np.where(successful, tx_high_type.consts['flags']['SUCCESSFUL'], 0)
+        tx_high['mac_payload_len'] = payload_len
+        tx_high['mac_payload']     = mac_hdrs
+
+        # TX_LOW
+        tx_low                     = np.zeros(total_tx, dtype=tx_low_type.fields_np_dt)
+        tx_low['timestamp']        = tx_begin[pkt] + att_start + DIFS_TIME + (num_slots * SLOT_TIME)
+        tx_low['uniq_seq']         = uniq_seq[pkt]
+        tx_low['mcs']              = mcs[pkt]
+        tx_low['phy_mode']         = self.phy_mode
+        tx_low['ant_mode']         = tx_low_type.consts['ant_mode']['RF_A']
+        tx_low['tx_power']         = 15
+        tx_low['channel']          = self.channel
+        tx_low['length']           = length[pkt]
+        tx_low['num_slots']        = num_slots
+        tx_low['cw']               = cw
+        tx_low['pkt_type']         = entry_types.common_pkt_types['DATA']
+        tx_low['flags']            = np.where(received, tx_low_type.consts['flags']['RECEIVED_RESPONSE'], 0)
+        tx_low['timestamp_frac']   = self._rng.randint(0, 160, total_tx)
+        tx_low['phy_samp_rate']    = 20
+        tx_low['attempt_number']   = attempt
+        tx_low['mac_payload_len']  = payload_len
+        tx_low['mac_payload']      = mac_hdrs[pkt]
+
+        # Set the retry bit of the frame control flags of re-transmissions
+        tx_low['mac_payload'][:, 1] |= np.where(attempt > 1, 0x08, 0).astype(np.uint8)
+
+        if self.ltg:
+            tx_high['flags'] |= tx_high_type.consts['flags']['LTG'] | tx_high_type.consts['flags']['LTG_PYLD']
+            tx_low['flags']  |= tx_low_type.consts['flags']['LTG'] | tx_low_type.consts['flags']['LTG_PYLD']
+
+        # TX_LOW entries are logged when the attempt is done and the TX_HIGH entry after the last attempt
+        tx_low_log_time  = tx_begin[pkt] + att_start + att_duration
+
+        return [(tx_low_type, tx_low_type.fields_np_dt.itemsize, tx_low, tx_low_log_time),
+                (tx_high_type, tx_high_type.fields_np_dt.itemsize, tx_high, tx_done)]
+
+
+    def _gen_uplink(self, t_start, t_end):
+        """RX_OFDM entries of the uplink packets in [t_start, t_end)."""
+        import numpy as np
+
+        (arrivals, stations) = self._gen_arrivals(1, t_start, t_end)
+        num_pkts             = len(arrivals)
+
+        if (num_pkts == 0):
+            return None
+
+        (mcs, length) = self._gen_pkt_params(num_pkts)
+        airtime       = log_util.calc_tx_time(mcs, self.phy_mode, length, 20).astype(np.int64)
+
+        # Each station numbers its packets (the MAC sequence number is the 12 LSB)
+        mac_seq       = self._gen_flow_seq(1, stations)
+        sta_addrs     = STA_BASE_ADDR + stations.astype(np.uint64)
+
+        if self.ltg:
+            entry_type  = entry_types.entry_rx_ofdm_ltg
+            payload_len = 44
+            ltg_seq     = mac_seq
+            ltg_id      = 1
+        else:
+            entry_type  = entry_types.entry_rx_ofdm
+            payload_len = 24
+            ltg_seq     = None
+            ltg_id      = None
+
+        power         = np.clip(np.round(self._sta_power[stations] + self._rng.normal(0, 2, num_pkts)), -90, -20)
+        fcs_good      = self._rng.random_sample(num_pkts) >= self.retry_prob
+
+        rx                    = np.zeros(num_pkts, dtype=entry_type.fields_np_dt)
+        rx['timestamp']       = arrivals
+        rx['timestamp_frac']  = self._rng.randint(0, 160, num_pkts)
+        rx['phy_samp_rate']   = 20
+        rx['length']          = length
+        rx['cfo_est']         = self._rng.normal(0, 2**20, num_pkts).astype(np.int32)
+        rx['mcs']             = mcs
+        rx['phy_mode']        = self.phy_mode
+        rx['ant_mode']        = entry_type.consts['ant_mode']['RF_A']
+        rx['power']           = power
+        rx['pkt_type']        = entry_types.common_pkt_types['DATA']
+        rx['channel']         = self.channel
+        rx['rx_gain_index']   = np.clip(-power - 20, 0, 63)
+        rx['flags']           = np.where(fcs_good, entry_type.consts['flags']['FCS_GOOD'], 0)
+        rx['chan_est']        = self._sta_chan_est[stations] + self._rng.randint(-64, 64, size=(num_pkts, 64, 2)).astype(np.int16)
+        rx['mac_payload_len'] = payload_len
+        rx['mac_payload']     = self._gen_mac_headers(payload_len, entry_types.common_pkt_types['DATA'], 0x01,
+                                                      AP_MAC_ADDR, sta_addrs, AP_MAC_ADDR, mac_seq, ltg_seq, ltg_id)
+
+        if self.ltg:
+            rx['flags'] |= entry_type.consts['flags']['LTG'] | entry_type.consts['flags']['LTG_PYLD']
+
+        # RX entries are logged at the end of the reception
+        return (entry_type, entry_type.fields_np_dt.itemsize, rx, arrivals + airtime)
+
+
+    def _gen_beacons(self, t_start, t_end):
+        """TX_LOW entries of the beacons in [t_start, t_end)."""
+        import numpy as np
+
+        if (self.beacon_interval is None) or (self._next_beacon >= t_end):
+            return None
+
+        timestamps = np.arange(self._next_beacon, t_end, self.beacon_interval, dtype=np.int64)
+        num_pkts   = len(timestamps)
+
+        self._next_beacon = timestamps[-1] + self.beacon_interval
+
+        entry_type = entry_types.entry_tx_low
+        airtime    = int(log_util.calc_tx_time(0, 'NONHT', BEACON_LENGTH, 20))
+
+        tx_low                    = np.zeros(num_pkts, dtype=entry_type.fields_np_dt)
+        tx_low['timestamp']       = timestamps
+        tx_low['mcs']             = 0
+        tx_low['phy_mode']        = entry_type.consts['phy_mode']['NONHT']
+        tx_low['ant_mode']        = entry_type.consts['ant_mode']['RF_A']
+        tx_low['tx_power']        = 15
+        tx_low['channel']         = self.channel
+        tx_low['length']          = BEACON_LENGTH
+        tx_low['num_slots']       = -1
+        tx_low['cw']              = CW_MIN
+        tx_low['pkt_type']        = entry_types.common_pkt_types['BEACON']
+        tx_low['timestamp_frac']  = self._rng.randint(0, 160, num_pkts)
+        tx_low['phy_samp_rate']   = 20
+        tx_low['attempt_number']  = 1
+        tx_low['mac_payload_len'] = 24
+        tx_low['mac_payload']     = self._gen_mac_headers(24, entry_types.common_pkt_types['BEACON'], 0x00,
+                                                          BROADCAST_ADDR, AP_MAC_ADDR, AP_MAC_ADDR, np.zeros(num_pkts))
+
+        return (entry_type, entry_type.fields_np_dt.itemsize, tx_low, timestamps + airtime)
+
+# End class()
+
+
+
+# -----------------------------------------------------------------------------
+# Synthetic Log Data Functions
+# -----------------------------------------------------------------------------
+def gen_log_data(duration=10000000, log_capacity=None, corrupt_tail=False, **kwargs):
+    """Generate synthetic log data.
+
+    Args:
+        duration (int, optional):      Amount of MAC time in microseconds to generate
+        log_capacity (int, optional):  Capacity of the node's log in bytes (see SyntheticLogGenerator.gen_log_data())
+        corrupt_tail (bool, optional): Truncate the last entry of the log data
+        **kwargs:                      Arguments of SyntheticLogGenerator (e.g. ``num_stations``, ``rate``, ``seed``)
+
+    Returns:
+        log_data (bytearray):  Binary log data
+    """
+    log_gen = SyntheticLogGenerator(**kwargs)
+
+    return log_gen.gen_log_data(duration, log_capacity=log_capacity, corrupt_tail=corrupt_tail)
+
+# End def
+
+
+
+# -----------------------------------------------------------------------------
+# Internal Synthetic Log Data Functions
+# -----------------------------------------------------------------------------
+def _mac_addr_bytes(addrs, num_addrs):
+    """Convert u64 MAC addresses (scalar or array) to a (num_addrs, 6) array of bytes, most significant first."""
+    import numpy as np
+
+    addrs  = np.broadcast_to(np.asarray(addrs, dtype=np.uint64), (num_addrs,))
+    shifts = np.arange(40, -1, -8, dtype=np.uint64)
+
+    return ((addrs[:, None] >> shifts) & np.uint64(0xFF)).astype(np.uint8)
+
+# End def
@@ -0,0 +1,400 @@
+# -*- coding: utf-8 -*-
+"""
+------------------------------------------------------------------------------
+Mango 802.11 Reference Design Experiments Framework - Latency Trace Utilities
+------------------------------------------------------------------------------
+License:   Copyright 2014-2017, Mango Communications. All rights reserved.
+           Distributed under the WARP license (http://warpproject.org/license)
+------------------------------------------------------------------------------
+
+This module joins the latency trace log entries of a transmitting node and its
+peers into per-packet latency traces and breaks the latency of each packet
+into stages.
+
+When latency tracing is enabled (``node.log_configure(log_txrx_trace=True)``),
+each packet that enters the MAC of a node (Ethernet reception or LTG event) is
+given a trace ID and its ingress time is recorded.  When CPU Low is done with
+the packet, a TX_TRACE entry records the time the packet spent in each step
+before transmission.  Peers log an RX_TRACE entry for each data packet they
+receive.  The stages of a trace are:
+
+    ===============  =============================================================
+    Stage            Time between
+    ===============  =============================================================
+    'ingress'        MAC ingress and enqueue
+    'queue'          Enqueue and dequeue (time in the Tx queue)
+    'handoff'        Dequeue and acceptance of the packet by CPU Low
+    'access'         Acceptance by CPU Low and the start of the last Tx attempt
+                     (backoff, medium busy and any earlier Tx attempts)
+    'airtime'        Duration of the last Tx attempt
+    'rx_process'     Start of the reception at the peer and its processing by
+                     CPU High of the peer
+    ===============  =============================================================
+
+The 'total' of a trace is the sum of its stages.  The TX_TRACE entry is joined
+to the TX_LOW entries of the same node by 'uniq_seq'.  The last TX_LOW entry is
+joined to the RX_TRACE entries of the peers by transmitter address, MAC sequence
+number and timestamp, so the clocks of the nodes must be aligned (see
+``log_util.calc_clock_model()``).
+
+Example:
+::
+
+    import wlan_exp.log.util as log_util
+    import wlan_exp.log.util_trace as trace_util
+
+    traces = trace_util.join_latency_traces(ap_np['TX_TRACE'], ap_np['TX_LOW'],
+                                            rx={'sta': sta_np['RX_TRACE']},
+                                            time_offsets={'sta': sta_offset})
+
+    trace_util.print_latency_summary(traces)
+
+"""
+
+__all__ = ['TRACE_STAGES',
+           'join_latency_traces',
+           'calc_latency_histograms',
+           'calc_latency_percentiles',
+           'print_latency_summary']
+
+import sys
+
+from . import util as log_util
+
+
+# Fix to support Python 2.x and 3.x
+if sys.version[0]=="3": long=None
+
+
+# Stages of a latency trace (in order)
+TRACE_STAGES = ('ingress', 'queue', 'handoff', 'access', 'airtime', 'rx_process')
+
+
+# -----------------------------------------------------------------------------
+# Latency Trace Functions
+# -----------------------------------------------------------------------------
+def join_latency_traces(tx_trace, tx_low, rx=None, time_offsets=None, rx_time_tolerance=50):
+    """Join the latency trace entries of a node and its peers.
+
+    Args:
+        tx_trace (Numpy Array):              TX_TRACE entries of the transmitting node
+        tx_low (Numpy Array):                TX_LOW entries (or TX_LOW and TX_LOW_LTG entries
+            merged with ``filter_log_index()``) of the transmitting node
+        rx (dict, optional):                 Dictionary of ``{ <node> : <RX_TRACE Numpy Array> }``
+            of the peers
+        time_offsets (dict, optional):       Dictionary of ``{ <node> : <offset> }``; the offset
+            (microseconds) is added to the timestamps of the peer to align it with the
+            transmitting node
+        rx_time_tolerance (int, optional):   Maximum difference (microseconds) between aligned
+            TX_LOW and RX_TRACE timestamps of the same packet
+
+    Returns:
+        traces (dict):
+            * 'rx_nodes': List of peer node keys; the 'rx_node' field indexes into this list
+            * 'traces':   Numpy structured array with one entry per TX_TRACE entry, with fields:
+
+              * 'trace_id', 'uniq_seq', 'num_tx', 'tx_result':  From the TX_TRACE entry
+              * 'timestamp':   MAC ingress time of the packet
+              * One int64 field per stage in TRACE_STAGES (microseconds)
+              * 'total':       Sum of the stages
+              * 'tx_low_idx':  Index of the last TX_LOW entry of the packet (-1 if not found)
+              * 'rx_node':     Index of the peer that received the packet (-1 if not received)
+
+    The 'access' and 'airtime' stages are 0 if the TX_LOW entries of the packet
+    were not found (e.g. the TX_LOW entries were not logged).  The 'rx_process'
+    stage is 0 if no peer received the packet.  If several peers received the
+    packet (e.g. multicast), the first one in ``rx`` is used.
+    """
+    import numpy as np
+
+    if time_offsets is None:
+        time_offsets = {}
+
+    num_traces = len(tx_trace)
+
+    dt = [('trace_id',   np.uint32), ('uniq_seq',  np.uint64),
+          ('timestamp',  np.uint64), ('num_tx',    np.uint16), ('tx_result', np.uint8)]
+    dt += [(stage, np.int64) for stage in TRACE_STAGES]
+    dt += [('total',     np.int64),  ('tx_low_idx', np.int64), ('rx_node',  np.int16)]
+
+    traces = np.zeros((num_traces,), dtype=dt)
+
+    traces['trace_id']  = tx_trace['trace_id']
+    traces['uniq_seq']  = tx_trace['uniq_seq']
+    traces['timestamp'] = tx_trace['timestamp']
+    traces['num_tx']    = tx_trace['num_tx']
+    traces['tx_result'] = tx_trace['tx_result']
+    traces['ingress']   = tx_trace['time_to_enqueue']
+    traces['queue']     = tx_trace['time_to_dequeue']
+    traces['handoff']   = tx_trace['time_to_accept']
+
+    traces['tx_low_idx'] = -1
+    traces['rx_node']    = -1
+
+    # Time the packet was accepted by CPU Low
+    accept_ts = (tx_trace['timestamp'].astype(np.int64) + tx_trace['time_to_enqueue'] +
+                 tx_trace['time_to_dequeue'] + tx_trace['time_to_accept'])
+
+    # Last Tx attempt of each MPDU
+    #   Control frames (ACK / CTS) are ignored since ACKs of received LTG packets
+    #   carry the unique sequence number of the peer
+    ctrl_type = 0x04
+    tx_idx    = np.nonzero((tx_low['pkt_type'] & 0x0C) != ctrl_type)[0]
+
+    order     = np.lexsort((tx_low['timestamp'][tx_idx], tx_low['uniq_seq'][tx_idx]))
+    tx_idx    = tx_idx[order]
+    seqs      = tx_low['uniq_seq'][tx_idx]
+
+    if (len(seqs) > 0):
+        last      = np.append(seqs[1:] != seqs[:-1], True)
+        tx_idx    = tx_idx[last]
+        seqs      = seqs[last]
+
+        pos       = np.minimum(np.searchsorted(seqs, traces['uniq_seq']), len(seqs) - 1)
+        found     = seqs[pos] == traces['uniq_seq']
+    else:
+        pos       = np.zeros((num_traces,), dtype=np.intp)
+        found     = np.zeros((num_traces,), dtype=bool)
+
+    last_idx  = tx_idx[pos[found]]
+
+    if 'airtime' in tx_low.dtype.names:
+        airtime = tx_low['airtime'][last_idx]
+    else:
+        airtime = log_util._calc_tx_time_lut(tx_low['mcs'][last_idx], tx_low['phy_mode'][last_idx].astype(np.intp),
+                                             tx_low['length'][last_idx], tx_low['phy_samp_rate'][last_idx])
+
+    last_ts   = tx_low['timestamp'][last_idx].astype(np.int64)
+
+    traces['tx_low_idx'][found] = last_idx
+    traces['access'][found]     = last_ts - accept_ts[found]
+    traces['airtime'][found]    = airtime
+
+    # Receptions by the peers
+    if rx and ('addr2' in tx_low.dtype.names):
+        tx_key    = log_util._mac_seq_key(tx_low[last_idx])
+        rx_proc   = np.zeros((len(last_idx),), dtype=np.int64)
+        rx_node   = np.full((len(last_idx),), -1, dtype=np.int16)
+
+        for (n, node) in enumerate(rx.keys()):
+            (match_tx, match_rx) = _match_rx_trace(last_ts, tx_key, rx[node], int(time_offsets.get(node, 0)), rx_time_tolerance)
+
+            # First peer that received the packet
+            new       = rx_node[match_tx] == -1
+            match_tx  = match_tx[new]
+            match_rx  = match_rx[new]
+
+            rx_node[match_tx] = n
+            rx_proc[match_tx] = rx[node]['time_to_process'][match_rx]
+
+        traces['rx_node'][found]    = rx_node
+        traces['rx_process'][found] = rx_proc
+
+    traces['total'] = sum(traces[stage] for stage in TRACE_STAGES)
+
+    return {'rx_nodes' : list(rx.keys()) if rx else [], 'traces' : traces}
+
+# End def
+
+
+
+def calc_latency_histograms(traces, bin_width=10, max_latency=None, stages=None):
+    """Calculate the histogram of the latency of each stage.
+
+    Args:
+        traces (dict or Numpy Array):  Output of ``join_latency_traces()`` (or its 'traces' array)
+        bin_width (int, optional):     Width of the histogram bins in microseconds
+        max_latency (int, optional):   Latencies above this value are counted in the last bin
+            (default is the largest latency)
+        stages (list, optional):       Stages to include (default is TRACE_STAGES and 'total')
+
+    Returns:
+        histograms (dict):  Dictionary of ``{ <stage> : (counts, bin_edges) }``; all stages
+            share the same bin edges
+
+    Only traces that were received by a peer are included in the 'rx_process' and
+    'total' histograms.
+    """
+    import numpy as np
+
+    traces = _get_traces_array(traces)
+
+    if stages is None:
+        stages = TRACE_STAGES + ('total',)
+
+    values = dict((stage, _get_stage_values(traces, stage)) for stage in stages)
+
+    if max_latency is None:
+        max_latency = max([int(v.max()) for v in values.values() if len(v)] + [0])
+
+    num_bins  = (int(max_latency) // bin_width) + 1
+    bin_edges = np.arange(num_bins + 1, dtype=np.int64) * bin_width
+
+    histograms = {}
+
+    for stage in stages:
+        bins = np.clip(values[stage] // bin_width, 0, num_bins - 1)
+
+        histograms[stage] = (np.bincount(bins.astype(np.intp), minlength=num_bins), bin_edges)
+
+    return histograms
+
+# End def
+
+
+
+def calc_latency_percentiles(traces, percentiles=(50, 90, 99, 99.9), stages=None):
+    """Calculate the mean, max and percentiles of the latency of each stage.
+
+    Args:
+        traces (dict or Numpy Array):  Output of ``join_latency_traces()`` (or its 'traces' array)
+        percentiles (list, optional):  Percentiles to calculate
+        stages (list, optional):       Stages to include (default is TRACE_STAGES and 'total')
+
+    Returns:
+        stats (dict):  Dictionary of ``{ <stage> : { 'count', 'mean', 'max', <percentile> : <value> ... } }``
+            in microseconds
+    """
+    import numpy as np
+
+    traces = _get_traces_array(traces)
+
+    if stages is None:
+        stages = TRACE_STAGES + ('total',)
+
+    stats = {}
+
+    for stage in stages:
+        values = _get_stage_values(traces, stage)
+
+        stats[stage] = {'count' : len(values)}
+
+        if len(values):
+            stats[stage]['mean'] = float(values.mean())
+            stats[stage]['max']  = int(values.max())
+
+            for (p, v) in zip(percentiles, np.percentile(values, percentiles)):
+                stats[stage][p] = float(v)
+        else:
+            stats[stage]['mean'] = 0.0
+            stats[stage]['max']  = 0
+
+            for p in percentiles:
+                stats[stage][p] = 0.0
+
+    return stats
+
+# End def
+
+
+
+def print_latency_summary(traces, percentiles=(50, 90, 99, 99.9)):
+    """Print the latency percentiles of each stage.
+
+    Args:
+        traces (dict or Numpy Array):  Output of ``join_latency_traces()`` (or its 'traces' array)
+        percentiles (list, optional):  Percentiles to print
+    """
+    traces = _get_traces_array(traces)
+    stats  = calc_latency_percentiles(traces, percentiles)
+
+    num_rx = int((traces['rx_node'] >= 0).sum())
+
+    print('Latency traces: {0} packets, {1} received by a peer\n'.format(len(traces), num_rx))
+
+    header = '{0:<12} | {1:>9} | {2:>9}'.format('Stage (us)', 'Count', 'Mean')
+    for p in percentiles:
+        header += ' | {0:>9}'.format('p{0}'.format(p))
+    header += ' | {0:>9}'.format('Max')
+
+    print(header)
+
+    for stage in TRACE_STAGES + ('total',):
+        s    = stats[stage]
+        line = '{0:<12} | {1:9d} | {2:9.1f}'.format(stage, s['count'], s['mean'])
+        for p in percentiles:
+            line += ' | {0:9.1f}'.format(s[p])
+        line += ' | {0:9d}'.format(s['max'])
+
+        print(line)
+
+    print('')
+
+# End def
+
+
+
+# -----------------------------------------------------------------------------
+# Internal methods
+# -----------------------------------------------------------------------------
+def _get_traces_array(traces):
+    """Get the traces array from the output of join_latency_traces()."""
+    if isinstance(traces, dict):
+        return traces['traces']
+    return traces
+
+# End def
+
+
+
+def _get_stage_values(traces, stage):
+    """Get the latencies of a stage for the traces where the stage is valid."""
+    if stage == 'rx_process' or stage == 'total':
+        return traces[stage][traces['rx_node'] >= 0]
+    if stage == 'access' or stage == 'airtime':
+        return traces[stage][traces['tx_low_idx'] >= 0]
+    return traces[stage]
+
+# End def
+
+
+
+def _match_rx_trace(tx_ts, tx_key, rx_trace, time_offset, tolerance):
+    """Match transmissions to the RX_TRACE entries of a peer.
+
+    A reception matches a transmission if it has the same transmitter address
+    and sequence number and its aligned timestamp is within the tolerance.  If
+    several receptions match, the closest in time is used.
+
+    Returns:
+        (tx_idx, rx_idx):  Indexes of the matching transmissions and receptions
+    """
+    import numpy as np
+
+    # Transmitter address as an integer (see entry_types.np_array_add_fields())
+    addr_conv = np.uint64(2)**np.array(range(40, -1, -8), dtype='uint64')
+    addr2     = np.dot(rx_trace['addr2'].astype(np.uint64), addr_conv)
+
+    rx_key = (addr2 << np.uint64(12)) | (rx_trace['mac_seq'].astype(np.uint64) & np.uint64(0xFFF))
+    rx_ts  = rx_trace['timestamp'].astype(np.int64) + time_offset
+
+    order  = np.argsort(rx_ts, kind='mergesort')
+    rx_ts  = rx_ts[order]
+    rx_key = rx_key[order]
+
+    # Receptions within the time window of each transmission
+    lo     = np.searchsorted(rx_ts, tx_ts - tolerance, side='left')
+    hi     = np.searchsorted(rx_ts, tx_ts + tolerance, side='right')
+    counts = hi - lo
+    total  = int(counts.sum())
+
+    if (total == 0):
+        return (np.array([], dtype=np.intp), np.array([], dtype=np.intp))
+
+    tx_i   = np.repeat(np.arange(len(tx_ts)), counts)
+    rx_i   = np.repeat(lo, counts) + (np.arange(total) - np.repeat(np.cumsum(counts) - counts, counts))
+
+    match  = rx_key[rx_i] == tx_key[tx_i]
+    tx_i   = tx_i[match]
+    rx_i   = rx_i[match]
+
+    # Closest reception in time for each transmission
+    dist   = np.abs(rx_ts[rx_i] - tx_ts[tx_i])
+    sel    = np.lexsort((dist, tx_i))
+    tx_i   = tx_i[sel]
+    rx_i   = rx_i[sel]
+    first  = np.append(True, tx_i[1:] != tx_i[:-1])
+
+    return (tx_i[first], order[rx_i[first]])
+
+# End def
@@ -75,6 +75,12 @@ class WlanExpNode(node.WarpNode, wlan_device.WlanDevice):
         wlan_exp_ver_revision (int): ``wlan_exp`` Revision version running on this node
         max_tx_power_dbm(int): Maximum transmit power of the node (in dBm)
         min_tx_power_dbm(int): Minimum transmit power of the node (in dBm)
+        MCAST_QID (int): Tx queue ID of multicast packets (set by the node type)
+        MANAGEMENT_QID (int): Tx queue ID of management packets (set by the node type)
+        BEACON_QID (int): Tx queue ID of beacons (IBSS only)
+        UNICAST_QID (int): Tx queue ID of all unicast packets (STA only)
+        STATION_QID_OFFSET (int): Tx queue ID of a station minus its ID (AP and
+            IBSS only; see ``get_station_queue_id()``)
 
     """
 
@@ -92,6 +98,12 @@ class WlanExpNode(node.WarpNode, wlan_device.WlanDevice):
     max_tx_power_dbm                   = None
     min_tx_power_dbm                   = None
 
+    MCAST_QID                          = None
+    MANAGEMENT_QID                     = None
+    BEACON_QID                         = None
+    UNICAST_QID                        = None
+    STATION_QID_OFFSET                 = None
+
     def __init__(self, network_config=None):
         super(WlanExpNode, self).__init__(network_config)
 
@@ -117,7 +129,7 @@ class WlanExpNode(node.WarpNode, wlan_device.WlanDevice):
     #--------------------------------------------
     def log_configure(self, log_enable=None, log_wrap_enable=None,
                             log_full_payloads=None, log_txrx_mpdu=None,  
-                            log_txrx_ctrl=None):
+                            log_txrx_ctrl=None, log_txrx_trace=None):
         """Configure log with the given flags.
 
         By default all attributes are set to None.  Only attributes that
@@ -136,10 +148,12 @@ class WlanExpNode(node.WarpNode, wlan_device.WlanDevice):
                 (Default value on Node: TRUE)
             log_txrx_ctrl (bool):     Enable Tx/Rx log entries for CTRL frames
                 (Default value on Node: TRUE)
+            log_txrx_trace (bool):    Enable TX_TRACE / RX_TRACE latency trace log
+                entries (see wlan_exp.log.util_trace) (Default value on Node: FALSE)
         """
         self.send_cmd(cmds.LogConfigure(log_enable, log_wrap_enable,
                                         log_full_payloads, log_txrx_mpdu, 
-                                        log_txrx_ctrl))
+                                        log_txrx_ctrl, log_txrx_trace))
 
 
     def log_get(self, size, offset=0, max_req_size=2**23):
@@ -528,6 +542,103 @@ class WlanExpNode(node.WarpNode, wlan_device.WlanDevice):
         return ret_val
 
 
+    def counts_get_txrx_delta(self):
+        """Iterator over the Tx/Rx counts that changed since the previous 
+        iteration.
+
+        Each iteration sends one request to the node.  The node only returns 
+        the counts that changed since the counts generation of the previous 
+        request (and, for each station, only the data and/or management part 
+        of the counts that changed).  The first iteration returns all counts 
+        on the node.
+
+        Yields:
+            counts (numpy.ndarray):  Structured array with one row per station 
+                whose counts changed, with the same fields as the TxRxCounts() 
+                structure returned by ``get_txrx_counts()``.  Every row contains 
+                the complete counts for that station.  The array is empty if no 
+                counts changed.
+
+        Example:
+        ::
+
+            for counts in node.counts_get_txrx_delta():
+                process_counts(counts)
+                time.sleep(0.1)
+
+        If a delta is not received completely, an empty array is returned and 
+        the next iteration requests the delta again from the same generation.
+        """
+        import numpy as np
+        import wlan_exp.info as info
+
+        field_defs   = info.info_field_defs['TXRX_COUNTS']
+        counts_dtype = np.dtype([(f[0], f[2]) for f in field_defs])
+        data_fields  = [f[0] for f in field_defs if f[0].startswith('data_')]
+        mgmt_fields  = [f[0] for f in field_defs if f[0].startswith('mgmt_')]
+        data_dtype   = np.dtype([(f[0], f[2]) for f in field_defs if f[0].startswith('data_')])
+        mgmt_dtype   = np.dtype([(f[0], f[2]) for f in field_defs if f[0].startswith('mgmt_')])
+
+        # Complete counts for each station, indexed by MAC address
+        counts_cache = {}
+        generation   = cmds.CMD_PARAM_COUNTS_DELTA_GEN_ALL
+
+        while True:
+            delta = self.send_cmd(cmds.CountsGetTxRxDelta(generation))
+
+            if delta is None:
+                yield np.zeros(0, dtype=counts_dtype)
+                continue
+
+            ret_val = np.zeros(len(delta['entries']), dtype=counts_dtype)
+
+            for idx, (mac_addr, flags, data_counts, mgmt_counts) in enumerate(delta['entries']):
+                if mac_addr not in counts_cache:
+                    counts_cache[mac_addr] = np.zeros(1, dtype=counts_dtype)
+                    counts_cache[mac_addr]['mac_addr'] = np.frombuffer(mac_addr, dtype=np.uint8)
+
+                counts = counts_cache[mac_addr]
+                counts['retrieval_timestamp'] = delta['timestamp']
+
+                if data_counts is not None:
+                    sub = np.frombuffer(bytes(data_counts), dtype=data_dtype)
+                    for field in data_fields:
+                        counts[field] = sub[field]
+
+                if mgmt_counts is not None:
+                    sub = np.frombuffer(bytes(mgmt_counts), dtype=mgmt_dtype)
+                    for field in mgmt_fields:
+                        counts[field] = sub[field]
+
+                ret_val[idx] = counts[0]
+
+            generation = delta['generation']
+
+            yield ret_val
+
+
+    def counts_get_rx_pkt_buf(self):
+        """Get the Rx packet buffer counts of the node.
+
+        CPU Low passes each reception to CPU High in one of a ring of Rx packet
+        buffers.  If CPU High falls behind and still owns all of the other Rx
+        packet buffers, CPU Low drops the reception (an Rx overrun) instead of
+        waiting for a free packet buffer.
+
+        Returns:
+            rx_pkt_buf_counts (dict):  Dictionary with the keys:
+
+                * **num_rx_pkt_bufs** (int):  Number of Rx packet buffers (ring depth)
+                * **num_rx** (int):           Number of receptions passed to CPU High
+                * **num_overrun** (int):      Number of receptions dropped by CPU Low
+                * **num_batches** (int):      Number of times CPU High processed one or more
+                  receptions after a single IPC notification
+                * **max_batch** (int):        Largest number of receptions processed after
+                  a single IPC notification
+        """
+        return self.send_cmd(cmds.CountsGetRxPktBuf())
+
+
 
     #--------------------------------------------
     # Local Traffic Generation (LTG) Commands
@@ -1395,6 +1506,38 @@ class WlanExpNode(node.WarpNode, wlan_device.WlanDevice):
         self.set_low_param(param_id=cmds.CMD_PARAM_LOW_PARAM_PHY_SAMPLE_RATE, param_values=phy_samp_rate)
 
 
+    def set_tx_report_coalescing(self, max_reports, timeout_us=200):
+        """Configures the coalescing of Tx reports from CPU Low to CPU High.
+
+        CPU Low reports every transmission attempt to CPU High.  When coalescing
+        is enabled, CPU Low holds the reports (and the Tx done messages) in the
+        IPC ring and passes them to CPU High together, with a single interrupt,
+        once ``max_reports`` reports are held or the oldest report has been held
+        for ``timeout_us`` microseconds.  A batch is also passed to CPU High once
+        it holds Tx done messages for half of the Tx packet buffers, so CPU High
+        can keep CPU Low supplied with packets.  Receptions are never held back.
+
+        Coalescing reduces the interrupt load of CPU High at high packet rates
+        but delays the TX_LOW / TX_HIGH log entries and the Tx done processing
+        of CPU High by up to ``timeout_us``.  The timeout should be shorter than
+        the time it takes CPU Low to transmit all of the packets CPU High has
+        passed to it.
+
+        Args:
+            max_reports (int):  Maximum number of Tx reports per batch in
+                [0 .. 255].  0 or 1 disables coalescing (default).
+            timeout_us (int):   Maximum time in microseconds a Tx report is
+                held in [1 .. 100000]
+        """
+        if ((max_reports < 0) or (max_reports > 255)):
+            raise AttributeError("'max_reports' must be in [0 .. 255].")
+
+        if ((timeout_us < 1) or (timeout_us > 100000)):
+            raise AttributeError("'timeout_us' must be in [1 .. 100000].")
+
+        self.set_low_param(param_id=cmds.CMD_PARAM_LOW_PARAM_TX_REPORT_COALESCE, param_values=[max_reports, timeout_us])
+
+
     def set_random_seed(self, high_seed=None, low_seed=None, gen_random=False):
         """Sets the random number generator seed on the node.
 
@@ -2106,6 +2249,294 @@ class WlanExpNode(node.WarpNode, wlan_device.WlanDevice):
         self.send_cmd(cmds.QueueTxDataPurgeAll())
 
 
+    def queue_get_buffer_info(self):
+        """Get the occupancy of the transmit queue buffers.
+
+        The transmit queue buffers are split into size classes with separate
+        pools of free buffers.  A packet uses a buffer of the smallest class
+        that can hold it, or of a larger class if the smallest class has no
+        free buffers.
+
+        Returns:
+            buffer_info (list of dict):  One dictionary per size class (smallest first)
+            with the keys:
+
+                * **name** (str):           Name of the class ('small', 'medium', 'large')
+                * **buffer_size** (int):    Size of each buffer (in bytes)
+                * **max_frame_len** (int):  Max length of a frame that fits in a buffer (in bytes)
+                * **num_total** (int):      Total number of buffers
+                * **num_free** (int):       Number of free buffers
+                * **min_free** (int):       Smallest number of free buffers since the node booted
+                * **num_fallback** (int):   Number of packets that used this class because the
+                  smaller classes had no free buffers
+                * **num_failed** (int):     Number of packets that could not get a buffer of this
+                  or any larger class
+        """
+        return self.send_cmd(cmds.QueueGetBufferInfo())
+
+
+    def get_mem_pool_info(self):
+        """Get the allocation statistics of the memory of CPU High.
+
+        CPU High allocates the objects that it creates and destroys at runtime
+        (schedules, LTGs, address filter ranges and the list entries of stations
+        and networks) from fixed-size memory pools instead of the heap.  If a
+        pool is empty, the object is allocated from the heap instead.  Temporary
+        memory for the processing of a wlan_exp command is allocated from the
+        command arena, which is reset after each command.
+
+        Returns:
+            mem_pool_info (dict):  Dictionary with one entry per memory pool
+            ('dl_entry', 'schedule', 'ltg', 'ltg_params', 'ltg_payload',
+            'addr_range', 'station_entry', 'network_entry'), the command arena
+            ('arena') and the heap ('heap').  Each entry is a dictionary with
+            the keys:
+
+                * **obj_size** (int):      Size of each object (in bytes)
+                * **num_total** (int):     Number of objects in the pool
+                * **num_live** (int):      Number of objects in use
+                * **max_live** (int):      Largest number of objects in use since the node booted
+                * **num_alloc** (int):     Number of allocations
+                * **num_fallback** (int):  Number of allocations passed to the heap because the
+                  pool was empty
+                * **num_failed** (int):    Number of allocations that failed
+
+            For the arena, the units are bytes instead of objects.  For the heap,
+            the units are allocations and ``num_total`` is the number of bytes the
+            heap has taken from the system.
+        """
+        return self.send_cmd(cmds.NodeGetMemPoolInfo())
+
+
+    def get_profile(self, cpu='high'):
+        """Get the profiling probes of CPU High or CPU Low.
+
+        Each probe measures the time spent in one hot path of the node (e.g.
+        ``poll_tx_queues()``) and keeps the number of samples, the shortest /
+        longest / total time and a histogram of the times with log2 bins:  bin
+        0 counts samples of 0 ticks and bin N counts samples of [2^(N-1), 2^N)
+        ticks (the last bin also counts all longer samples).
+
+        The probes are only compiled if the CPU was built with
+        ``WLAN_PROF_ENABLE`` set to 1 (see wlan_mac_prof.h).
+
+        Args:
+            cpu (str):  CPU of the probes ('high' or 'low')
+
+        Returns:
+            profile (dict):  None if the CPU was not compiled with profiling.
+            Otherwise, a dictionary with the keys:
+
+                * **ticks_per_us** (int):  Number of ticks per microsecond
+                * **probes** (dict):       Dictionary with one entry per probe
+                  (see ``cmds.PROF_PROBE_NAMES``).  Each entry is a dictionary
+                  with the keys ``num_samples``, ``min_ticks``, ``max_ticks``,
+                  ``total_ticks`` and ``bins`` (list of int).
+
+            Probes that are not on the path of the given CPU have no samples.
+        """
+        return self.send_cmd(cmds.NodeProfile(cmd=cmds.CMD_PARAM_READ, cpu=self._get_profile_cpu(cpu)))
+
+
+    def reset_profile(self, cpu='high'):
+        """Reset the profiling probes of CPU High or CPU Low.
+
+        Args:
+            cpu (str):  CPU of the probes ('high' or 'low')
+        """
+        if (self._get_profile_cpu(cpu) == cmds.CMD_PARAM_NODE_PROFILE_CPU_LOW):
+            self.set_low_param(param_id=cmds.CMD_PARAM_LOW_PARAM_PROF_RESET, param_values=[0])
+        else:
+            self.send_cmd(cmds.NodeProfile(cmd=cmds.CMD_PARAM_NODE_PROFILE_RESET, cpu=cmds.CMD_PARAM_NODE_PROFILE_CPU_HIGH))
+
+
+    def _get_profile_cpu(self, cpu):
+        """Internal method to get the CPU parameter of the profiling commands."""
+        if (cpu == 'high'):
+            return cmds.CMD_PARAM_NODE_PROFILE_CPU_HIGH
+        elif (cpu == 'low'):
+            return cmds.CMD_PARAM_NODE_PROFILE_CPU_LOW
+        else:
+            raise AttributeError("'cpu' must be 'high' or 'low'.")
+
+
+    def get_queue_stats(self, queue_id=None, device=None):
+        """Get the Tx queue statistics of a queue or of a station.
+
+        The node keeps three histograms per Tx queue and per station:
+
+            * **sojourn**:    Time (in microseconds) between enqueue and dequeue
+              (packets dropped from the queue are not included)
+            * **tx_done**:    Time (in microseconds) between enqueue and the end
+              of the transmission (including all retransmissions)
+            * **occupancy**:  Number of packets in the queue when a packet is
+              enqueued (including the packet itself)
+
+        The histograms have log2 bins:  bin 0 counts samples of 0 and bin N
+        counts samples of [2^(N-1), 2^N) (the last bin also counts all larger
+        samples).  See ``wlan_exp.log.util_queue_stats`` to convert the
+        statistics to Numpy arrays and to calculate percentiles.
+
+        The statistics are only compiled if CPU High was built with
+        ``WLAN_SW_CONFIG_ENABLE_QUEUE_STATS`` set to 1 (see wlan_mac_high_sw_config.h).
+
+        Args:
+            queue_id (int, optional):  ID of the Tx queue (see ``MCAST_QID``,
+                ``MANAGEMENT_QID`` and ``get_station_queue_id()``)
+            device (WlanDevice, optional):  Station (any object with a
+                ``wlan_mac_address``, or a MAC address); used instead of queue_id
+
+        Returns:
+            stats (dict):  None if the queue / station has not been seen by the
+            node (or the statistics are not compiled).  Otherwise, a dictionary
+            with one entry per histogram (see ``cmds.QUEUE_STATS_HIST_NAMES``).
+            Each entry is a dictionary with the keys ``max`` (int; largest sample)
+            and ``bins`` (list of int).
+        """
+        if ((queue_id is None) == (device is None)):
+            raise AttributeError("Either 'queue_id' or 'device' must be specified.")
+
+        if device is not None:
+            mac_address = getattr(device, 'wlan_mac_address', device)
+
+            return self.send_cmd(cmds.NodeQueueStats(cmd=cmds.CMD_PARAM_READ, mac_address=mac_address))
+        else:
+            return self.send_cmd(cmds.NodeQueueStats(cmd=cmds.CMD_PARAM_READ, queue_id=queue_id))
+
+
+    def reset_queue_stats(self):
+        """Reset the Tx queue statistics of all queues and all stations."""
+        self.send_cmd(cmds.NodeQueueStats(cmd=cmds.CMD_PARAM_NODE_QUEUE_STATS_RESET))
+
+
+    def get_station_queue_id(self, device):
+        """Get the ID of the Tx queue of the unicast packets to a station.
+
+        The Tx queue IDs depend on the node type:
+
+            ====  =========  ==============  ==========  ==============================
+            Type  MCAST_QID  MANAGEMENT_QID  BEACON_QID  Station
+            ====  =========  ==============  ==========  ==============================
+            AP    0          1               --          Station ID + 1
+            STA   0          1               --          UNICAST_QID (2)
+            IBSS  0          2               1           Station ID + 2
+            ====  =========  ==============  ==========  ==============================
+
+        The station ID is the ``id`` field of the station in ``get_bss_members()``.
+
+        Args:
+            device (WlanDevice):  Station (any object with a ``wlan_mac_address``,
+                or a MAC address)
+
+        Returns:
+            queue_id (int):  ID of the Tx queue;  None if the device is not a
+            member of the BSS of the node
+        """
+        if (self.UNICAST_QID is None) and (self.STATION_QID_OFFSET is None):
+            raise NotImplementedError("Tx queue IDs are not known for this node type.")
+
+        mac_address = getattr(device, 'wlan_mac_address', device)
+
+        for bss_member in self.get_bss_members():
+            if (bss_member['mac_addr'] == mac_address):
+                if self.UNICAST_QID is not None:
+                    return self.UNICAST_QID
+                else:
+                    return bss_member['id'] + self.STATION_QID_OFFSET
+
+        return None
+
+
+    def set_queue_aqm(self, queue_id, head_drop=False, lifetime=None, codel=False,
+                      codel_target=None, codel_interval=None, max_length=None):
+        """Set the active queue management (AQM) policy of a Tx queue.
+
+        By default, a full Tx queue rejects new packets (tail drop) and packets
+        wait in the queue until they are transmitted.  The AQM policy of a queue
+        can combine:
+
+            * **head_drop**:  A full queue drops its oldest packet to make room
+              for a new packet (e.g. for broadcast safety messages, where a new
+              message supersedes the older ones)
+            * **lifetime**:   Packets that waited in the queue longer than
+              lifetime are dropped when they reach the head of the queue
+            * **codel**:      Packets are dropped with CoDel (RFC 8289) when the
+              time packets wait in the queue stays above codel_target for
+              codel_interval
+
+        Dropped packets are counted per reason (see ``get_queue_aqm()``) and
+        logged as TX_DROP entries when Tx/Rx MPDU logging is enabled (see
+        ``log_configure()``).  The policy can be set before the queue is used;
+        ``set_queue_aqm(queue_id)`` restores the default policy.
+
+        Args:
+            queue_id (int):                 ID of the Tx queue (see ``MCAST_QID``,
+                ``MANAGEMENT_QID`` and ``get_station_queue_id()``)
+            head_drop (bool, optional):     Drop the oldest packet of a full queue
+            lifetime (float, optional):     Max time (in float sec) a packet can wait
+                in the queue (None to disable)
+            codel (bool, optional):         Enable CoDel
+            codel_target (float, optional): CoDel target (in float sec; default is 5 ms)
+            codel_interval (float, optional): CoDel interval (in float sec; default is 100 ms)
+            max_length (int, optional):     Max number of packets in the queue (default
+                is the limit of the MAC application)
+
+        Returns:
+            aqm (dict):  AQM state of the queue (see ``get_queue_aqm()``)
+        """
+        flags = 0
+
+        if head_drop:
+            flags |= cmds.QUEUE_AQM_FLAG_HEAD_DROP
+
+        if lifetime is not None:
+            if (lifetime <= 0):
+                raise AttributeError("'lifetime' must be > 0.")
+            flags |= cmds.QUEUE_AQM_FLAG_LIFETIME
+        else:
+            lifetime = 0
+
+        if codel:
+            flags |= cmds.QUEUE_AQM_FLAG_CODEL
+
+        return self.send_cmd(cmds.NodeQueueAqm(cmd=cmds.CMD_PARAM_WRITE, queue_id=queue_id, flags=flags,
+                                               max_length=(max_length if max_length is not None else 0),
+                                               lifetime=lifetime,
+                                               codel_target=(codel_target if codel_target is not None else 0),
+                                               codel_interval=(codel_interval if codel_interval is not None else 0)))
+
+
+    def get_queue_aqm(self, queue_id):
+        """Get the active queue management (AQM) policy and drop counters of a Tx queue.
+
+        Args:
+            queue_id (int):  ID of the Tx queue (see ``set_queue_aqm()``)
+
+        Returns:
+            aqm (dict):  Dictionary with the keys:
+
+                * **head_drop** (bool), **codel** (bool):  Policy flags
+                * **lifetime** (float):  Lifetime in float sec (None if disabled)
+                * **codel_target**, **codel_interval** (float):  CoDel parameters in float sec
+                * **max_length** (int):  Max number of packets (None for the limit of
+                  the MAC application)
+                * **num_dropped** (dict):  Number of dropped packets per reason
+                  (see ``cmds.QUEUE_DROP_REASON_NAMES``).  'tail' counts the packets
+                  that were rejected because the queue was full.
+                * **codel_dropping** (bool), **codel_count** (int):  CoDel state
+        """
+        return self.send_cmd(cmds.NodeQueueAqm(cmd=cmds.CMD_PARAM_READ, queue_id=queue_id))
+
+
+    def reset_queue_aqm_counts(self, queue_id):
+        """Reset the drop counters of a Tx queue.
+
+        Args:
+            queue_id (int):  ID of the Tx queue (see ``set_queue_aqm()``)
+        """
+        self.send_cmd(cmds.NodeQueueAqm(cmd=cmds.CMD_PARAM_NODE_QUEUE_AQM_RESET_COUNTS, queue_id=queue_id))
+
+
 
     #--------------------------------------------
     # Braodcast Commands can be found in util.py
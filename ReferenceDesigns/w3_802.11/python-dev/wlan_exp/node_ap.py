@@ -23,6 +23,11 @@ class WlanExpNodeAp(node.WlanExpNode):
         network_config (transport.NetworkConfiguration) : Network configuration of the node
     """
 
+    # Tx queue IDs (see wlan_mac_ap.h)
+    MCAST_QID                          = 0
+    MANAGEMENT_QID                     = 1
+    STATION_QID_OFFSET                 = 1
+
     #-------------------------------------------------------------------------
     # Node Commands
     #-------------------------------------------------------------------------
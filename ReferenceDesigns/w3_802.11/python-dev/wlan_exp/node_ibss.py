@@ -23,6 +23,12 @@ class WlanExpNodeIBSS(node.WlanExpNode):
         network_config (transport.NetworkConfiguration) : Network configuration of the node
     """
 
+    # Tx queue IDs (see wlan_mac_ibss.h)
+    MCAST_QID                          = 0
+    BEACON_QID                         = 1
+    MANAGEMENT_QID                     = 2
+    STATION_QID_OFFSET                 = 2
+
     #-------------------------------------------------------------------------
     # Node Commands
     #-------------------------------------------------------------------------
@@ -22,6 +22,11 @@ class WlanExpNodeSta(node.WlanExpNode):
     Args:
         network_config (transport.NetworkConfiguration) : Network configuration of the node
     """
+
+    # Tx queue IDs (see wlan_mac_sta.h)
+    MCAST_QID                          = 0
+    MANAGEMENT_QID                     = 1
+    UNICAST_QID                        = 2
     
     #-------------------------------------------------------------------------
     # Node Commands 
@@ -21,6 +21,7 @@ Functions (see below for more information):
     TestPayloadSize()
     AddNodeGrpId()
     ClearNodeGrpId()
+    Batch()
 
 Integer constants:
     GRPID_NODE, GRPID_TRANS - Command Groups
@@ -32,13 +33,16 @@ defining other sub-classes of CmdResp and BufferCmd.
 """
 
 
+import struct
+
 from . import message
 
 
 __all__ = ['NodeGetType', 'NodeIdentify', 'NodeGetHwInfo', 
            'NodeSetupNetwork', 'NodeResetNetwork', 'NodeGetTemperature', 
            'TransportPing', 'TransportTestPayloadSize', 
-           'TransportAddNodeGroupId', 'TransportClearNodeGroupId']
+           'TransportAddNodeGroupId', 'TransportClearNodeGroupId',
+           'TransportBatch']
 
 
 # Command Groups
@@ -80,6 +84,7 @@ CMDID_TRANSPORT_PING                             = 0x000001
 CMDID_TRANSPORT_PAYLOAD_SIZE_TEST                = 0x000002
 CMDID_TRANSPORT_NODE_GROUP_ID_ADD                = 0x000100
 CMDID_TRANSPORT_NODE_GROUP_ID_CLEAR              = 0x000101
+CMDID_TRANSPORT_BATCH                            = 0x000200
 
 
 # Local Constants
@@ -278,3 +283,63 @@ class TransportClearNodeGroupId(message.Cmd):
 # End Class
 
 
+class TransportBatch(message.Cmd):
+    """Command to process a batch of commands on the node with a single 
+    request / response.
+    
+    Only commands that return a single Resp (or no response) can be part of
+    a batch.  The node processes the commands in order and returns the 
+    response of each command in a single message.  The node stops before a 
+    command whose largest response does not fit in the space left in the 
+    message; the number of commands processed is returned so the remaining 
+    commands can be resent.
+
+    Wire format of the command args:
+        Word[0]     -- Number of commands
+        Word[1 - N] -- Serialized commands (command header + args)
+    """
+    cmds = None
+
+    def __init__(self, cmds=None):
+        super(TransportBatch, self).__init__()
+        self.command = _CMD_GROUP_TRANSPORT + CMDID_TRANSPORT_BATCH
+        self.cmds    = []
+        self.add_args(0)
+
+        if cmds is not None:
+            for cmd in cmds:
+                self.add_cmd(cmd)
+
+    def add_cmd(self, cmd):
+        """Append a command to the batch."""
+        from . import transport
+
+        if cmd.get_resp_type() == transport.TRANSPORT_BUFFER:
+            raise TypeError("Buffer commands cannot be part of a batch")
+
+        data = cmd.serialize()
+        self.cmds.append(cmd)
+        self.args[0] = len(self.cmds)
+        self.add_args(*struct.unpack('!%dI' % (len(data) // 4), data))
+
+    def process_resp(self, resp):
+        """Returns a list of Resp objects, one per command processed."""
+        ret_val = []
+
+        if resp.resp_is_valid():
+            args = resp.get_args()
+
+            if args:
+                num_resp = args[0]
+                data     = struct.pack('!%dI' % (len(args) - 1), *args[1:])
+                offset   = 0
+
+                for _ in range(num_resp):
+                    sub_resp = message.Resp()
+                    sub_resp.deserialize(data[offset:])
+                    ret_val.append(sub_resp)
+                    offset  += struct.calcsize('!I 2H') + sub_resp.length
+
+        return ret_val
+
+# End Class
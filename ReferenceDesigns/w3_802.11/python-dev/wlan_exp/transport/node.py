@@ -11,6 +11,8 @@ This module provides class definition for WARP Node.
 
 Functions (see below for more information):
     WarpNode()        -- Base class for WARP nodes
+    WarpNodeBatch()   -- Context manager to batch commands to a WarpNode
+    WarpNodeBatchResult() -- Deferred result of a batched command
     WarpNodeFactory() -- Base class for creating a WarpNode
 
 Integer constants:
@@ -26,7 +28,7 @@ from . import cmds
 from . import exception as ex
 
 
-__all__ = ['WarpNode', 'WarpNodeFactory']
+__all__ = ['WarpNode', 'WarpNodeBatch', 'WarpNodeBatchResult', 'WarpNodeFactory']
 
 
 # Node Parameter Identifiers
@@ -75,6 +77,8 @@ class WarpNode(object):
     transport                = None
     transport_broadcast      = None
     transport_tracker        = None
+
+    cmd_batch                = None
     
     def __init__(self, network_config=None):
         if network_config is not None:
@@ -226,6 +230,32 @@ class WarpNode(object):
         #self.send_cmd_broadcast(cmds.NodeResetNetwork(self.serial_number))
         self.send_cmd_broadcast(cmds.NodeResetNetwork(self.sn_str))
 
+    def batch(self):
+        """Batch commands sent to the node
+        
+        Returns a context manager.  Within the context, commands that return
+        a single response are collected and sent to the node in as few 
+        packets as possible when the context exits.  The return values of 
+        the batched commands are available in the ``results`` attribute of 
+        the context manager.  Buffer commands flush any pending commands and 
+        are sent normally.
+        
+        Within the context, send_cmd() returns a WarpNodeBatchResult whose 
+        ``value`` is set when the command is sent.  Methods that use the 
+        response of their command (ie get_mac_time()) raise a TransportError
+        within the context, so only call methods that set node state or use 
+        send_cmd() directly for values that are needed after the batch.
+        
+        Example:
+            with node.batch() as b:
+                node.set_tx_rate_data(mcs=3, phy_mode='HTMF', device_list='ALL')
+                node.set_tx_power_data(power=10, device_list='ALL')
+                node_time = node.send_cmd(cmds.NodeProcTime(cmds.CMD_PARAM_READ, cmds.CMD_PARAM_RSVD_TIME))
+            
+            mac_time = node_time.value[0]
+        """
+        return WarpNodeBatch(self)
+
     # -------------------------------------------------------------------------
     # Parameter Framework
     #   Allows for processing of hardware parameters
@@ -334,6 +364,13 @@ class WarpNode(object):
         from . import transport
 
         resp_type = cmd.get_resp_type()
+
+        if self.cmd_batch is not None:
+            if resp_type == transport.TRANSPORT_BUFFER:
+                # Keep commands in order
+                self.cmd_batch.flush()
+            else:
+                return self.cmd_batch.add_cmd(cmd)
         
         if  (resp_type == transport.TRANSPORT_NO_RESP):
             payload = cmd.serialize()
@@ -667,6 +704,166 @@ class WarpNode(object):
 
 
 
+class WarpNodeBatch(object):
+    """Context manager to batch commands to a WARP node.
+    
+    See WarpNode.batch() for usage.
+    
+    Attributes:
+        node     -- WARP node the commands are sent to
+        cmds     -- List of (command, WarpNodeBatchResult) that have not been sent to the node
+        results  -- List of processed responses of commands sent to the node
+        num_pkts -- Number of batch requests sent to the node
+    """
+    node      = None
+    cmds      = None
+    results   = None
+    num_pkts  = None
+
+    def __init__(self, node):
+        self.node     = node
+        self.cmds     = []
+        self.results  = []
+        self.num_pkts = 0
+
+    def __enter__(self):
+        if self.node.cmd_batch is not None:
+            raise ex.TransportError(self.node.transport, "Batches cannot be nested")
+        self.node.cmd_batch = self
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.node.cmd_batch = None
+
+        # Only send the pending commands if the block completed
+        if exc_type is None:
+            self.flush()
+        else:
+            self.cmds = []
+        
+        return False
+
+    def add_cmd(self, cmd):
+        """Add a command to the batch.
+        
+        Returns:
+            result (WarpNodeBatchResult):  Deferred result of the command
+        """
+        result = WarpNodeBatchResult(cmd)
+        self.cmds.append((cmd, result))
+        return result
+
+    def flush(self):
+        """Send all pending commands to the node."""
+        from . import transport
+
+        pending   = self.cmds
+        self.cmds = []
+        
+        # Do not batch the batch commands themselves
+        prev_batch          = self.node.cmd_batch
+        self.node.cmd_batch = None
+
+        try:
+            max_size = self.node.transport.get_max_payload() - self.node.transport.hdr.sizeof()
+            
+            while pending:
+                batch_cmd = cmds.TransportBatch()
+
+                for (cmd, _) in pending:
+                    if batch_cmd.cmds and ((batch_cmd.sizeof() + cmd.sizeof()) > max_size):
+                        break
+                    batch_cmd.add_cmd(cmd)
+                
+                resps          = self.node.send_cmd(batch_cmd)
+                self.num_pkts += 1
+
+                if not resps:
+                    # The largest response of the first command does not fit in 
+                    # a batch (see batch_cmd_max_resp_len() in wlan_exp_node.c); 
+                    # the node did not run it, so send it on its own
+                    (cmd, result) = pending[0]
+
+                    result._set_value(self.node.send_cmd(cmd))
+                    self.results.append(result.value)
+                    self.num_pkts += 1
+
+                    pending = pending[1:]
+                    continue
+
+                for ((cmd, result), resp) in zip(pending, resps):
+                    if (cmd.get_resp_type() == transport.TRANSPORT_RESP):
+                        result._set_value(cmd.process_resp(resp))
+                    else:
+                        result._set_value(None)
+
+                    self.results.append(result.value)
+
+                # Resend any commands the node did not get to
+                pending = pending[len(resps):]
+        finally:
+            self.node.cmd_batch = prev_batch
+
+# End Class
+
+
+
+class WarpNodeBatchResult(object):
+    """Deferred result of a command sent within a WarpNodeBatch.
+    
+    The ``value`` attribute is the processed response of the command once
+    the batch has been sent to the node.  Using the result as the response 
+    (ie indexing, unpacking or arithmetic) raises a TransportError, since 
+    the response is not available within the batch.  A result is always 
+    true and is only equal to itself.
+    
+    Attributes:
+        cmd      -- Command of the result
+        sent     -- Has the command been sent to the node
+    """
+    cmd       = None
+    sent      = None
+    _value    = None
+
+    def __init__(self, cmd):
+        self.cmd   = cmd
+        self.sent  = False
+
+    @property
+    def value(self):
+        if not self.sent:
+            self._not_available()
+        return self._value
+
+    def _set_value(self, value):
+        self._value = value
+        self.sent   = True
+
+    def _not_available(self, *args, **kwargs):
+        msg  = "Response of {0} is not available within a batch.\n".format(self.cmd.__class__.__name__)
+        msg += "    Commands that return values cannot be used within node.batch();\n"
+        msg += "    use the value of the result returned by send_cmd() after the batch."
+        raise ex.TransportError(None, msg)
+
+    __getitem__ = __iter__ = __len__ = __int__ = __float__ = __index__ = _not_available
+    __lt__ = __le__ = __gt__ = __ge__ = _not_available
+    __add__ = __sub__ = __mul__ = __and__ = __or__ = __rshift__ = __lshift__ = _not_available
+
+    # Defined so truth value tests do not fall back to __len__
+    def __bool__(self):
+        return True
+
+    __nonzero__ = __bool__
+
+    def __repr__(self):
+        if self.sent:
+            return "WarpNodeBatchResult({0})".format(repr(self._value))
+        return "WarpNodeBatchResult(<pending {0}>)".format(self.cmd.__class__.__name__)
+
+# End Class
+
+
+
 class WarpNodeFactory(WarpNode):
     """Sub-class of WARP node used to help with node configuration and setup.
     